@@ -0,0 +1,236 @@
+/*
+ * Misura il tempo di salvataggio e di avvio: l'archivio di utenti e veicoli viene
+ * generato e salvato nella cartella corrente, poi caricato e inserito nelle tabelle,
+ * come in `main`, con un solo thread e con un thread per processore (o con il
+ * numero indicato).
+ *
+ * Uso: ./bench_caricamento [numero_utenti] [numero_veicoli] [numero_thread]
+ * Output (una riga per operazione, separata da ';'):
+ *    operazione;utenti;veicoli;thread;ms
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "modelli/intervallo.h"
+#include "modelli/prenotazione.h"
+#include "modelli/utente.h"
+#include "modelli/veicolo.h"
+#include "strutture_dati/prenotazioni.h"
+#include "strutture_dati/tabella_utenti.h"
+#include "strutture_dati/tabella_veicoli.h"
+#include "utils/gestore_file.h"
+#include "utils/parallelo.h"
+
+#define UTENTI_PREDEFINITI 1000000
+#define VEICOLI_PREDEFINITI 100000
+#define PRENOTAZIONI_PER_ELEMENTO 4
+#define ORA 3600
+#define INIZIO_CALENDARIO 1767225600 // 01/01/2026 00:00 UTC
+#define FILE_UTENTI "bench_utenti.bin"
+#define FILE_DATI_UTENTI "bench_dati_utenti.bin"
+#define FILE_VEICOLI "bench_veicoli.bin"
+#define FILE_PRENOTAZIONI_VEICOLI "bench_prenotazioni_veicoli.bin"
+#define GENERAZIONE_ARCHIVIO 1
+
+// Tabelle caricate da `carica_tabella_blocco`
+struct tabelle {
+    TabellaUtenti utenti;
+    TabellaVeicoli veicoli;
+};
+
+/*
+ * Funzione: adesso_ns
+ * -------------------
+ * Restituisce il tempo corrente di un orologio monotono in nanosecondi.
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit
+ */
+static unsigned long long adesso_ns(void);
+
+/*
+ * Funzione: scrivi_targa
+ * ----------------------
+ * Scrive in `targa` la targa, nel formato AA000AA, del veicolo `i`.
+ */
+static void scrivi_targa(char *targa, unsigned int i);
+
+/*
+ * Funzione: genera_archivio
+ * -------------------------
+ * Crea `num_utenti` utenti (un admin ogni dieci) e `num_veicoli` veicoli, con
+ * PRENOTAZIONI_PER_ELEMENTO prenotazioni per veicolo e per cliente, li salva e
+ * stampa il tempo del salvataggio.
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 in caso di errore
+ */
+static int genera_archivio(unsigned int num_utenti, unsigned int num_veicoli);
+
+/*
+ * Funzione: carica_tabella_blocco
+ * -------------------------------
+ * Carica le tabelle di indice [inizio, fine), come `carica_tabelle` di `gestore_file`:
+ * 0 è la tabella degli utenti, 1 quella dei veicoli.
+ */
+static void carica_tabella_blocco(void *contesto, unsigned int inizio, unsigned int fine);
+
+/*
+ * Funzione: misura_avvio
+ * ----------------------
+ * Carica le due tabelle in parallelo con `num_thread` thread e stampa i tempi.
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 in caso di errore
+ */
+static int misura_avvio(unsigned int num_utenti, unsigned int num_veicoli, unsigned int num_thread);
+
+int main(int argc, char **argv){
+    unsigned int num_utenti = UTENTI_PREDEFINITI;
+    unsigned int num_veicoli = VEICOLI_PREDEFINITI;
+    unsigned int num_thread = ottieni_numero_thread();
+    if(argc > 1) num_utenti = (unsigned int)strtoul(argv[1], NULL, 10);
+    if(argc > 2) num_veicoli = (unsigned int)strtoul(argv[2], NULL, 10);
+    if(argc > 3) num_thread = (unsigned int)strtoul(argv[3], NULL, 10);
+    if(num_utenti == 0 || num_veicoli == 0 || num_thread == 0){
+        printf("./bench_caricamento [numero_utenti] [numero_veicoli] [numero_thread]\n");
+        return -1;
+    }
+
+    printf("operazione;utenti;veicoli;thread;ms\n");
+    if(genera_archivio(num_utenti, num_veicoli) < 0) return -1;
+
+    int esito = misura_avvio(num_utenti, num_veicoli, 1);
+    if(esito == 0 && num_thread > 1) esito = misura_avvio(num_utenti, num_veicoli, num_thread);
+
+    remove(FILE_UTENTI);
+    remove(FILE_DATI_UTENTI);
+    remove(FILE_VEICOLI);
+    remove(FILE_PRENOTAZIONI_VEICOLI);
+    return esito;
+}
+
+static unsigned long long adesso_ns(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned long long)t.tv_sec * 1000000000ULL + (unsigned long long)t.tv_nsec;
+}
+
+static void scrivi_targa(char *targa, unsigned int i){
+    snprintf(targa, NUM_CARATTERI_TARGA, "%c%c%03u%c%c",
+             'A' + (i / 1000) % 26, 'A' + (i / 26000) % 26, i % 1000,
+             'A' + (i / 676000) % 26, 'A' + (i / 17576000) % 26);
+}
+
+static int genera_archivio(unsigned int num_utenti, unsigned int num_veicoli){
+    Utente *utenti = calloc(num_utenti, sizeof(Utente));
+    Veicolo *veicoli = calloc(num_veicoli, sizeof(Veicolo));
+    int esito = -1;
+    unsigned int i, k;
+    if(utenti == NULL || veicoli == NULL) goto fine;
+
+    uint8_t password[DIMENSIONE_PASSWORD];
+    char email[64], targa[NUM_CARATTERI_TARGA];
+    memset(password, 0, sizeof(password));
+
+    for(i = 0; i < num_veicoli; i++){
+        scrivi_targa(targa, i);
+        Prenotazioni prenotazioni = crea_prenotazioni();
+        veicoli[i] = crea_veicolo("Utilitaria", targa, "Modello", "Posizione", 1.0, prenotazioni);
+        if(veicoli[i] == NULL){
+            distruggi_prenotazioni(prenotazioni);
+            goto fine;
+        }
+        for(k = 0; k < PRENOTAZIONI_PER_ELEMENTO; k++){
+            time_t t = INIZIO_CALENDARIO + (time_t)k * 2 * ORA;
+            Intervallo intervallo = crea_intervallo(t, t + ORA);
+            snprintf(email, sizeof(email), "utente%u@carsharing.it", (i * PRENOTAZIONI_PER_ELEMENTO + k) % num_utenti);
+            Prenotazione p = crea_prenotazione(email, targa, intervallo, 10.0);
+            distruggi_intervallo(intervallo);
+            if(p == NULL || aggiungi_prenotazione(prenotazioni, p) != OK){
+                distruggi_prenotazione(p);
+                goto fine;
+            }
+        }
+    }
+
+    for(i = 0; i < num_utenti; i++){
+        snprintf(email, sizeof(email), "utente%u@carsharing.it", i);
+        utenti[i] = crea_utente(email, password, "Nome", "Cognome", i % 10 ? CLIENTE : ADMIN);
+        if(utenti[i] == NULL) goto fine;
+        if(i % 10 == 0) continue;
+
+        for(k = 0; k < PRENOTAZIONI_PER_ELEMENTO; k++){
+            time_t t = INIZIO_CALENDARIO + (time_t)k * 2 * ORA;
+            Intervallo intervallo = crea_intervallo(t, t + ORA);
+            scrivi_targa(targa, (i + k) % num_veicoli);
+            Prenotazione p = crea_prenotazione(email, targa, intervallo, 10.0);
+            distruggi_intervallo(intervallo);
+            Byte aggiunta = aggiungi_a_storico_utente(utenti[i], p);
+            distruggi_prenotazione(p);
+            if(!aggiunta) goto fine;
+        }
+    }
+
+    unsigned long long inizio = adesso_ns();
+    if(salva_vettore_utenti(FILE_UTENTI, FILE_DATI_UTENTI, utenti, num_utenti, GENERAZIONE_ARCHIVIO) &&
+       salva_vettore_veicoli(FILE_VEICOLI, FILE_PRENOTAZIONI_VEICOLI, veicoli, num_veicoli, GENERAZIONE_ARCHIVIO))
+        esito = 0;
+    if(esito == 0)
+        printf("salvataggio;%u;%u;1;%.1f\n", num_utenti, num_veicoli, (adesso_ns() - inizio) / 1e6);
+
+fine:
+    for(i = 0; utenti != NULL && i < num_utenti; i++) distruggi_utente(utenti[i]);
+    for(i = 0; veicoli != NULL && i < num_veicoli; i++) distruggi_veicolo(veicoli[i]);
+    free(utenti);
+    free(veicoli);
+    return esito;
+}
+
+static void carica_tabella_blocco(void *contesto, unsigned int inizio, unsigned int fine){
+    struct tabelle *tabelle = contesto;
+    unsigned int i, n = 0;
+
+    for(i = inizio; i < fine; i++){
+        if(i == 0){
+            Utente *utenti = carica_vettore_utenti(FILE_UTENTI, FILE_DATI_UTENTI, &n);
+            if(utenti == NULL) continue;
+            tabelle->utenti = crea_tabella_utenti(n * 2);
+            if(tabelle->utenti != NULL) carica_utenti(tabelle->utenti, utenti, n);
+            free(utenti);
+        }
+        else{
+            Veicolo *veicoli = carica_vettore_veicoli(FILE_VEICOLI, FILE_PRENOTAZIONI_VEICOLI, &n);
+            if(veicoli == NULL) continue;
+            tabelle->veicoli = crea_tabella_veicoli(n * 2);
+            if(tabelle->veicoli != NULL) carica_veicoli(tabelle->veicoli, veicoli, n);
+            free(veicoli);
+        }
+    }
+}
+
+static int misura_avvio(unsigned int num_utenti, unsigned int num_veicoli, unsigned int num_thread){
+    imposta_numero_thread(num_thread);
+
+    struct tabelle tabelle = { NULL, NULL };
+    unsigned long long inizio = adesso_ns();
+    esegui_a_blocchi(1, 1, carica_tabella_blocco, &tabelle);
+    unsigned long long durata_utenti = adesso_ns() - inizio;
+    distruggi_tabella_utenti(tabelle.utenti);
+
+    tabelle.utenti = NULL;
+    inizio = adesso_ns();
+    esegui_a_blocchi(2, 1, carica_tabella_blocco, &tabelle);
+    unsigned long long durata_avvio = adesso_ns() - inizio;
+    int esito = tabelle.utenti != NULL && tabelle.veicoli != NULL ? 0 : -1;
+    distruggi_tabella_utenti(tabelle.utenti);
+    distruggi_tabella_veicoli(tabelle.veicoli);
+
+    printf("carica_utenti;%u;%u;%u;%.1f\n", num_utenti, num_veicoli, num_thread, durata_utenti / 1e6);
+    printf("avvio;%u;%u;%u;%.1f\n", num_utenti, num_veicoli, num_thread, durata_avvio / 1e6);
+    return esito;
+}
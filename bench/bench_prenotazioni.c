@@ -0,0 +1,200 @@
+/*
+ * Misura il throughput delle interrogazioni sull'albero delle prenotazioni.
+ * L'albero viene riempito inserendo in ordine casuale prenotazioni di un'ora
+ * separate da un'ora libera, così da ottenere un albero profondo con nodi
+ * sparsi in memoria; poi vengono eseguite interrogazioni casuali di mezz'ora
+ * (circa tre quarti si sovrappongono a una prenotazione).
+ *
+ * Uso: ./bench_prenotazioni [numero_prenotazioni] [numero_interrogazioni]
+ * Output (una riga per operazione, separata da ';'):
+ *    operazione;elementi;interrogazioni;ns_per_interrogazione;interrogazioni_al_secondo
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "modelli/intervallo.h"
+#include "modelli/prenotazione.h"
+#include "strutture_dati/prenotazioni.h"
+
+#define PRENOTAZIONI_PREDEFINITE 1000000
+#define INTERROGAZIONI_PREDEFINITE 2000000
+#define ORA 3600
+#define INIZIO_CALENDARIO 1767225600 // 01/01/2026 00:00 UTC
+
+/*
+ * Funzione: adesso_ns
+ * -------------------
+ * Restituisce il tempo corrente di un orologio monotono in nanosecondi.
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit
+ */
+static unsigned long long adesso_ns(void);
+
+/*
+ * Funzione: casuale
+ * -----------------
+ * Generatore pseudo-casuale xorshift64, deterministico e indipendente dalla libc.
+ *
+ * Parametri:
+ *    stato: lo stato del generatore
+ *
+ * Pre-condizioni:
+ *    stato: non deve essere NULL né puntare a 0
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit
+ *
+ * Side-effect:
+ *    aggiorna lo stato del generatore
+ */
+static unsigned long long casuale(unsigned long long *stato);
+
+/*
+ * Funzione: riempi_albero
+ * -----------------------
+ * Inserisce `n` prenotazioni non sovrapposte in ordine casuale.
+ *
+ * Parametri:
+ *    albero: l'albero da riempire
+ *    n: numero di prenotazioni da inserire
+ *    stato: lo stato del generatore pseudo-casuale
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 in caso di errore
+ */
+static int riempi_albero(Prenotazioni albero, unsigned int n, unsigned long long *stato);
+
+/*
+ * Funzione: conta_prenotazione
+ * ----------------------------
+ * Visitatore che incrementa il contatore passato come contesto.
+ */
+static void conta_prenotazione(const Prenotazione p, void *contesto);
+
+/*
+ * Funzione: stampa_risultato
+ * --------------------------
+ * Stampa una riga di risultato nel formato descritto in testa al file.
+ */
+static void stampa_risultato(const char *operazione, unsigned int n, unsigned int q, unsigned long long durata_ns);
+
+int main(int argc, char **argv){
+    unsigned int n = PRENOTAZIONI_PREDEFINITE;
+    unsigned int q = INTERROGAZIONI_PREDEFINITE;
+    if(argc > 1) n = (unsigned int)strtoul(argv[1], NULL, 10);
+    if(argc > 2) q = (unsigned int)strtoul(argv[2], NULL, 10);
+    if(n == 0 || q == 0){
+        printf("./bench_prenotazioni [numero_prenotazioni] [numero_interrogazioni]\n");
+        return -1;
+    }
+
+    unsigned long long stato = 0x9E3779B97F4A7C15ULL;
+    Prenotazioni albero = crea_prenotazioni();
+    if(albero == NULL) return -1;
+
+    unsigned long long inizio = adesso_ns();
+    if(riempi_albero(albero, n, &stato) < 0){
+        distruggi_prenotazioni(albero);
+        return -1;
+    }
+    unsigned long long durata = adesso_ns() - inizio;
+
+    printf("operazione;elementi;interrogazioni;ns_per_interrogazione;interrogazioni_al_secondo\n");
+    stampa_risultato("aggiungi_prenotazione", n, n, durata);
+
+    // Gli intervalli da interrogare sono creati prima di misurare
+    Intervallo *interrogazioni = malloc(sizeof(Intervallo) * q);
+    if(interrogazioni == NULL){
+        distruggi_prenotazioni(albero);
+        return -1;
+    }
+    unsigned int i;
+    for(i = 0; i < q; i++){
+        time_t t = INIZIO_CALENDARIO + (time_t)(casuale(&stato) % ((unsigned long long)n * 2 * ORA));
+        interrogazioni[i] = crea_intervallo(t, t + ORA / 2);
+    }
+
+    unsigned int occupati = 0;
+    inizio = adesso_ns();
+    for(i = 0; i < q; i++){
+        if(controlla_prenotazione(albero, interrogazioni[i]) != OK) occupati++;
+    }
+    durata = adesso_ns() - inizio;
+    stampa_risultato("controlla_prenotazione", n, q, durata);
+
+    unsigned long long visitate = 0;
+    inizio = adesso_ns();
+    for(i = 0; i < q; i++){
+        visita_prenotazioni_in_intervallo(albero, inizio_intervallo(interrogazioni[i]),
+                                          fine_intervallo(interrogazioni[i]) + 4 * ORA,
+                                          conta_prenotazione, &visitate);
+    }
+    durata = adesso_ns() - inizio;
+    stampa_risultato("visita_prenotazioni_in_intervallo", n, q, durata);
+
+    // Evita che il compilatore consideri inutili i cicli misurati
+    fprintf(stderr, "occupati: %u, visitate: %llu\n", occupati, visitate);
+
+    for(i = 0; i < q; i++) distruggi_intervallo(interrogazioni[i]);
+    free(interrogazioni);
+    distruggi_prenotazioni(albero);
+    return 0;
+}
+
+static unsigned long long adesso_ns(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned long long)t.tv_sec * 1000000000ULL + (unsigned long long)t.tv_nsec;
+}
+
+static unsigned long long casuale(unsigned long long *stato){
+    unsigned long long x = *stato;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *stato = x;
+    return x;
+}
+
+static int riempi_albero(Prenotazioni albero, unsigned int n, unsigned long long *stato){
+    unsigned int *ordine = malloc(sizeof(unsigned int) * n);
+    if(ordine == NULL) return -1;
+
+    unsigned int i;
+    for(i = 0; i < n; i++) ordine[i] = i;
+    for(i = n - 1; i > 0; i--){
+        unsigned int j = (unsigned int)(casuale(stato) % (i + 1));
+        unsigned int temp = ordine[i];
+        ordine[i] = ordine[j];
+        ordine[j] = temp;
+    }
+
+    for(i = 0; i < n; i++){
+        time_t t = INIZIO_CALENDARIO + (time_t)ordine[i] * 2 * ORA;
+        Intervallo iv = crea_intervallo(t, t + ORA);
+        Prenotazione p = crea_prenotazione("cliente@carsharing.it", "AB123CD", iv, 10.0);
+        distruggi_intervallo(iv);
+        if(p == NULL || aggiungi_prenotazione(albero, p) != OK){
+            distruggi_prenotazione(p);
+            free(ordine);
+            return -1;
+        }
+    }
+
+    free(ordine);
+    return 0;
+}
+
+static void conta_prenotazione(const Prenotazione p, void *contesto){
+    (void)p;
+    (*(unsigned long long *)contesto)++;
+}
+
+static void stampa_risultato(const char *operazione, unsigned int n, unsigned int q, unsigned long long durata_ns){
+    double ns = (double)durata_ns / q;
+    printf("%s;%u;%u;%.1f;%.0f\n", operazione, n, q, ns, ns > 0 ? 1e9 / ns : 0.0);
+}
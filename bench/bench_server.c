@@ -0,0 +1,331 @@
+/*
+ * Misura il server di car_sharing (`--server`) con molti client contemporanei.
+ * Apre `connessioni` connessioni al socket e su ognuna, dopo l'accesso come uno dei
+ * clienti generati da genera_carico, invia `comandi_per_connessione` comandi:
+ * l'80% `prenota` di un veicolo a caso per un'ora a caso, il 15% `disponibilita`
+ * per un'ora a caso e il 5% `storico`. Le date cadono nei 60 giorni a partire da
+ * domani, perché il server rifiuta le prenotazioni nel passato; `utenti` e `veicoli`
+ * devono essere quelli usati per generare l'archivio caricato dal server.
+ *
+ * Tutti i comandi di una connessione vengono inviati di seguito, poi il client chiude
+ * il suo lato della connessione e legge gli esiti fino alla chiusura del server.
+ * Un esito è una riga che inizia con "OK;" o "ERRORE;" (una prenotazione
+ * sovrapposta è un esito di errore atteso).
+ *
+ * Uso: ./bench_server percorso_socket [connessioni] [comandi_per_connessione] [utenti] [veicoli] [seme]
+ * Output (separato da ';'):
+ *    connessioni;comandi;esiti;esiti_errore;secondi;comandi_al_secondo
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "modelli/byte.h"
+
+#define CONNESSIONI_PREDEFINITE 1000
+#define COMANDI_PREDEFINITI 100
+#define UTENTI_PREDEFINITI 100000
+#define VEICOLI_PREDEFINITI 10000
+#define SEME_PREDEFINITO 0x9E3779B97F4A7C15ULL
+#define GIORNI_CALENDARIO 60
+#define GRANDEZZA_COMANDO 160
+#define GRANDEZZA_LETTURA 65536
+#define NUM_CARATTERI_TARGA 8
+
+static const char *nomi[] = { "mario", "anna", "luca", "giulia", "marco", "sara", "paolo", "chiara" };
+static const char *cognomi[] = { "rossi", "verdi", "bianchi", "esposito", "romano", "colombo", "ricci", "greco" };
+#define NUM_NOMI (sizeof(nomi) / sizeof(nomi[0]))
+#define NUM_COGNOMI (sizeof(cognomi) / sizeof(cognomi[0]))
+
+// Stato di una connessione al server
+struct cliente {
+    int fd;
+    char *richiesta;            // Tutti i comandi della connessione
+    size_t dimensione;
+    size_t inviati;
+    Byte terminato;             // Il server ha chiuso la connessione
+    char inizio_riga[8];        // Primi caratteri della riga in lettura
+    unsigned int lunghezza_inizio;
+};
+
+/*
+ * Funzione: adesso_ns
+ * -------------------
+ * Restituisce il tempo corrente di un orologio monotono in nanosecondi.
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit
+ */
+static unsigned long long adesso_ns(void);
+
+/*
+ * Funzione: casuale
+ * -----------------
+ * Generatore pseudo-casuale xorshift64, come in genera_carico.
+ *
+ * Parametri:
+ *    stato: lo stato del generatore
+ *
+ * Pre-condizioni:
+ *    stato: non deve essere NULL né puntare a 0
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit
+ *
+ * Side-effect:
+ *    aggiorna lo stato del generatore
+ */
+static unsigned long long casuale(unsigned long long *stato);
+
+/*
+ * Funzione: prepara_richiesta
+ * ---------------------------
+ * Scrive in `cliente->richiesta` l'accesso del cliente `utente` seguito da `num_comandi` comandi,
+ * con date nei GIORNI_CALENDARIO giorni da `primo_giorno`.
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 se manca la memoria
+ */
+static int prepara_richiesta(struct cliente *cliente, unsigned int utente, unsigned int num_comandi,
+                             unsigned int num_veicoli, const struct tm *primo_giorno, unsigned long long *stato);
+
+/*
+ * Funzione: collega
+ * -----------------
+ * Apre una connessione non bloccante al socket `percorso`; restituisce -1 in caso di errore.
+ */
+static int collega(const char *percorso);
+
+/*
+ * Funzione: conta_esiti
+ * ---------------------
+ * Conta le righe di esito in `dati`, tenendo conto delle righe spezzate tra due letture.
+ */
+static void conta_esiti(struct cliente *cliente, const char *dati, size_t dimensione,
+                        unsigned long long *esiti, unsigned long long *esiti_errore);
+
+int main(int argc, char **argv){
+    unsigned int num_connessioni = CONNESSIONI_PREDEFINITE;
+    unsigned int num_comandi = COMANDI_PREDEFINITI;
+    unsigned int num_utenti = UTENTI_PREDEFINITI;
+    unsigned int num_veicoli = VEICOLI_PREDEFINITI;
+    unsigned long long stato = SEME_PREDEFINITO;
+    if(argc > 2) num_connessioni = (unsigned int)strtoul(argv[2], NULL, 10);
+    if(argc > 3) num_comandi = (unsigned int)strtoul(argv[3], NULL, 10);
+    if(argc > 4) num_utenti = (unsigned int)strtoul(argv[4], NULL, 10);
+    if(argc > 5) num_veicoli = (unsigned int)strtoul(argv[5], NULL, 10);
+    if(argc > 6) stato = strtoull(argv[6], NULL, 0);
+    if(argc < 2 || num_connessioni == 0 || num_utenti == 0 || num_veicoli == 0 || stato == 0){
+        printf("./bench_server percorso_socket [connessioni] [comandi_per_connessione] [utenti] [veicoli] [seme]\n");
+        return -1;
+    }
+
+    // Ogni connessione usa un descrittore: il limite predefinito è spesso 1024
+    struct rlimit limite;
+    if(getrlimit(RLIMIT_NOFILE, &limite) == 0 && limite.rlim_cur < limite.rlim_max){
+        limite.rlim_cur = limite.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limite);
+    }
+
+    struct cliente *clienti = calloc(num_connessioni, sizeof(struct cliente));
+    struct pollfd *attese = calloc(num_connessioni, sizeof(struct pollfd));
+    unsigned int *indici = calloc(num_connessioni, sizeof(unsigned int));
+    char *lettura = malloc(GRANDEZZA_LETTURA);
+    int esito = -1;
+    unsigned int i;
+    if(clienti == NULL || attese == NULL || indici == NULL || lettura == NULL){
+        printf("Memoria insufficiente\n");
+        goto fine;
+    }
+    // Le prenotazioni partono da domani alle 00:00
+    time_t ora = time(NULL);
+    struct tm primo_giorno = *localtime(&ora);
+    primo_giorno.tm_mday++;
+    primo_giorno.tm_hour = primo_giorno.tm_min = primo_giorno.tm_sec = 0;
+    primo_giorno.tm_isdst = -1;
+    for(i = 0; i < num_connessioni; i++){
+        clienti[i].fd = -1;
+        if(prepara_richiesta(&clienti[i], i % num_utenti, num_comandi, num_veicoli, &primo_giorno, &stato) < 0){
+            printf("Memoria insufficiente\n");
+            goto fine;
+        }
+    }
+
+    unsigned long long esiti = 0, esiti_errore = 0;
+    unsigned long long inizio = adesso_ns();
+    for(i = 0; i < num_connessioni; i++){
+        clienti[i].fd = collega(argv[1]);
+        if(clienti[i].fd < 0){
+            printf("Connessione %u a %s fallita: %s\n", i, argv[1], strerror(errno));
+            goto fine;
+        }
+    }
+
+    unsigned int attivi = num_connessioni;
+    while(attivi > 0){
+        unsigned int num_attese = 0;
+        for(i = 0; i < num_connessioni; i++){
+            if(clienti[i].terminato) continue;
+            attese[num_attese].fd = clienti[i].fd;
+            attese[num_attese].events = POLLIN | (clienti[i].inviati < clienti[i].dimensione ? POLLOUT : 0);
+            attese[num_attese].revents = 0;
+            indici[num_attese++] = i;
+        }
+        if(poll(attese, num_attese, -1) < 0){
+            if(errno == EINTR) continue;
+            perror("poll");
+            goto fine;
+        }
+
+        for(unsigned int k = 0; k < num_attese; k++){
+            struct cliente *c = &clienti[indici[k]];
+            if(attese[k].revents & POLLOUT){
+                ssize_t inviati = send(c->fd, c->richiesta + c->inviati, c->dimensione - c->inviati, MSG_NOSIGNAL);
+                if(inviati > 0) c->inviati += (size_t)inviati;
+                if(c->inviati == c->dimensione) shutdown(c->fd, SHUT_WR);
+            }
+            if(attese[k].revents & (POLLIN | POLLHUP | POLLERR)){
+                ssize_t letti = read(c->fd, lettura, GRANDEZZA_LETTURA);
+                if(letti > 0) conta_esiti(c, lettura, (size_t)letti, &esiti, &esiti_errore);
+                else if(letti == 0 || (errno != EAGAIN && errno != EINTR)){
+                    c->terminato = 1;
+                    attivi--;
+                }
+            }
+        }
+    }
+    double secondi = (adesso_ns() - inizio) / 1e9;
+
+    unsigned long long comandi = (unsigned long long)num_connessioni * (num_comandi + 1);
+    printf("connessioni;comandi;esiti;esiti_errore;secondi;comandi_al_secondo\n");
+    printf("%u;%llu;%llu;%llu;%.3f;%.0f\n", num_connessioni, comandi, esiti, esiti_errore, secondi,
+           secondi > 0 ? comandi / secondi : 0.0);
+    esito = esiti == comandi ? 0 : -1;
+
+fine:
+    for(i = 0; clienti != NULL && i < num_connessioni; i++){
+        if(clienti[i].fd >= 0) close(clienti[i].fd);
+        free(clienti[i].richiesta);
+    }
+    free(clienti);
+    free(attese);
+    free(indici);
+    free(lettura);
+    return esito;
+}
+
+static unsigned long long adesso_ns(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned long long)t.tv_sec * 1000000000ULL + (unsigned long long)t.tv_nsec;
+}
+
+static unsigned long long casuale(unsigned long long *stato){
+    unsigned long long x = *stato;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *stato = x;
+    return x;
+}
+
+/*
+ * Funzione: scrivi_ora
+ * --------------------
+ * Scrive in `inizio` e `fine` un'ora a caso dei GIORNI_CALENDARIO giorni da `primo_giorno`.
+ */
+static void scrivi_ora(char *inizio, char *fine, size_t dimensione, const struct tm *primo_giorno, unsigned long long *stato){
+    struct tm giorno = *primo_giorno;
+    giorno.tm_mday += (int)(casuale(stato) % GIORNI_CALENDARIO);
+    giorno.tm_hour = (int)(casuale(stato) % 23);
+    giorno.tm_isdst = -1;
+    mktime(&giorno);
+    strftime(inizio, dimensione, "%d/%m/%Y %H:%M", &giorno);
+    giorno.tm_hour++;
+    strftime(fine, dimensione, "%d/%m/%Y %H:%M", &giorno);
+}
+
+static int prepara_richiesta(struct cliente *cliente, unsigned int utente, unsigned int num_comandi,
+                             unsigned int num_veicoli, const struct tm *primo_giorno, unsigned long long *stato){
+    char inizio[20], fine[20];
+    size_t capacita = (size_t)(num_comandi + 1) * GRANDEZZA_COMANDO;
+
+    cliente->richiesta = malloc(capacita);
+    if(cliente->richiesta == NULL) return -1;
+    cliente->dimensione = (size_t)snprintf(cliente->richiesta, capacita, "accedi;%s.%s%u@email.com;Passw0rd!%u\n",
+                                           nomi[utente % NUM_NOMI], cognomi[(utente / NUM_NOMI) % NUM_COGNOMI], utente, utente);
+
+    for(unsigned int i = 0; i < num_comandi; i++){
+        char *comando = cliente->richiesta + cliente->dimensione;
+        size_t spazio = capacita - cliente->dimensione;
+        unsigned int tipo = (unsigned int)(casuale(stato) % 100);
+
+        scrivi_ora(inizio, fine, sizeof(inizio), primo_giorno, stato);
+        if(tipo < 80){
+            unsigned int v = (unsigned int)(casuale(stato) % num_veicoli);
+            // Stessa targa di genera_carico per il veicolo `v`
+            char targa[NUM_CARATTERI_TARGA];
+            snprintf(targa, sizeof(targa), "%c%c%03u%c%c",
+                     'A' + (v / 1000) % 26, 'A' + (v / 26000) % 26, v % 1000,
+                     'A' + (v / 676000) % 26, 'A' + (v / 17576000) % 26);
+            cliente->dimensione += (size_t)snprintf(comando, spazio, "prenota;%s;%s;%s\n", targa, inizio, fine);
+        } else if(tipo < 95){
+            cliente->dimensione += (size_t)snprintf(comando, spazio, "disponibilita;%s;%s\n", inizio, fine);
+        } else {
+            cliente->dimensione += (size_t)snprintf(comando, spazio, "storico\n");
+        }
+    }
+    return 0;
+}
+
+static int collega(const char *percorso){
+    struct sockaddr_un indirizzo;
+    if(strlen(percorso) >= sizeof(indirizzo.sun_path)){
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    memset(&indirizzo, 0, sizeof(indirizzo));
+    indirizzo.sun_family = AF_UNIX;
+    strcpy(indirizzo.sun_path, percorso);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0) return -1;
+    // La connessione è bloccante: con la coda del server piena attende invece di fallire
+    if(connect(fd, (struct sockaddr *)&indirizzo, sizeof(indirizzo)) != 0 || fcntl(fd, F_SETFL, O_NONBLOCK) != 0){
+        int errore = errno;
+        close(fd);
+        errno = errore;
+        return -1;
+    }
+    return fd;
+}
+
+static void conta_esiti(struct cliente *cliente, const char *dati, size_t dimensione,
+                        unsigned long long *esiti, unsigned long long *esiti_errore){
+    for(size_t i = 0; i < dimensione; i++){
+        if(dati[i] == '\n'){
+            cliente->lunghezza_inizio = 0;
+            continue;
+        }
+        // Basta l'inizio della riga: le righe dei dati iniziano con una targa o un numero
+        if(cliente->lunghezza_inizio >= 7) continue;
+        cliente->inizio_riga[cliente->lunghezza_inizio++] = dati[i];
+        if(cliente->lunghezza_inizio == 3 && memcmp(cliente->inizio_riga, "OK;", 3) == 0){
+            (*esiti)++;
+            cliente->lunghezza_inizio = 7;
+        } else if(cliente->lunghezza_inizio == 7 && memcmp(cliente->inizio_riga, "ERRORE;", 7) == 0){
+            (*esiti)++;
+            (*esiti_errore)++;
+        }
+    }
+}
@@ -0,0 +1,503 @@
+/*
+ * Suite di benchmark delle strutture dati principali, pensata per seguire le
+ * regressioni nel tempo. Crea una flotta di veicoli, ciascuno con le proprie
+ * prenotazioni (di un'ora, separate da un'ora libera) inserite in ordine casuale,
+ * e misura la latenza di ogni singola chiamata a:
+ *    aggiungi_prenotazione, controlla_prenotazione, ottieni_intervallo_disponibile,
+ *    cancella_prenotazione, inserisci_in_tabella, cerca_in_tabella
+ * e il tempo di salvataggio e caricamento dell'istantanea della flotta.
+ *
+ * Le interrogazioni scelgono il veicolo secondo la distribuzione delle chiavi:
+ * `uniforme`, oppure `zipf` (legge di Zipf con esponente 1, il veicolo di indice k
+ * viene scelto con probabilità proporzionale a 1/(k+1)), che simula una flotta in
+ * cui pochi veicoli ricevono la maggior parte delle richieste.
+ *
+ * Il throughput è il numero di operazioni diviso la somma delle loro latenze, quindi
+ * non comprende la preparazione degli argomenti. Per le istantanee un'operazione è
+ * il salvataggio o il caricamento dell'intera flotta, ripetuto RIPETIZIONI_ISTANTANEA volte;
+ * il caricamento comprende la costruzione delle prenotazioni di tutti i veicoli.
+ *
+ * Uso: ./bench_strutture_dati [numero_veicoli] [prenotazioni_per_veicolo] [uniforme|zipf]
+ *                             [numero_interrogazioni] [seme]
+ * Output (una riga per operazione, separata da ';'):
+ *    operazione;veicoli;prenotazioni_per_veicolo;distribuzione;operazioni;operazioni_al_secondo;p50_ns;p99_ns
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "modelli/intervallo.h"
+#include "modelli/prenotazione.h"
+#include "modelli/veicolo.h"
+#include "strutture_dati/prenotazioni.h"
+#include "strutture_dati/tabella_hash.h"
+#include "utils/gestore_file.h"
+
+#define VEICOLI_PREDEFINITI 10000
+#define PRENOTAZIONI_PER_VEICOLO_PREDEFINITE 100
+#define INTERROGAZIONI_PREDEFINITE 1000000
+#define SEME_PREDEFINITO 0x9E3779B97F4A7C15ULL
+#define RIPETIZIONI_ISTANTANEA 5
+#define ORA 3600
+#define INIZIO_CALENDARIO 1767225600 // 01/01/2026 00:00 UTC
+#define FILE_VEICOLI "bench_strutture_veicoli.bin"
+#define FILE_PRENOTAZIONI_VEICOLI "bench_strutture_prenotazioni.bin"
+
+// Parametri della misura, ripetuti in ogni riga di output
+struct parametri {
+    unsigned int veicoli;
+    unsigned int per_veicolo;
+    unsigned int interrogazioni;
+    const char *distribuzione;
+};
+
+// Distribuzione degli indici dei veicoli: `cumulata` è NULL per quella uniforme
+struct distribuzione {
+    unsigned int n;
+    double *cumulata;
+};
+
+/*
+ * Funzione: adesso_ns
+ * -------------------
+ * Restituisce il tempo corrente di un orologio monotono in nanosecondi.
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit
+ */
+static unsigned long long adesso_ns(void);
+
+/*
+ * Funzione: casuale
+ * -----------------
+ * Generatore pseudo-casuale xorshift64, deterministico e indipendente dalla libc.
+ *
+ * Parametri:
+ *    stato: lo stato del generatore
+ *
+ * Pre-condizioni:
+ *    stato: non deve essere NULL né puntare a 0
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit
+ *
+ * Side-effect:
+ *    aggiorna lo stato del generatore
+ */
+static unsigned long long casuale(unsigned long long *stato);
+
+/*
+ * Funzione: crea_distribuzione
+ * ----------------------------
+ * Prepara la distribuzione `nome` ("uniforme" oppure "zipf") su `n` indici.
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 se il nome non è valido o l'allocazione fallisce
+ */
+static int crea_distribuzione(struct distribuzione *d, const char *nome, unsigned int n);
+
+/*
+ * Funzione: estrai
+ * ----------------
+ * Estrae un indice in [0, d->n) secondo la distribuzione `d`.
+ */
+static unsigned int estrai(const struct distribuzione *d, unsigned long long *stato);
+
+/*
+ * Funzione: scrivi_targa
+ * ----------------------
+ * Scrive in `targa` la targa, nel formato AA000AA, del veicolo `i`.
+ */
+static void scrivi_targa(char *targa, unsigned int i);
+
+/*
+ * Funzione: intervallo_casuale
+ * ----------------------------
+ * Crea un intervallo di `durata` secondi che inizia in un istante casuale del
+ * calendario occupato dalle prenotazioni di un veicolo.
+ */
+static Intervallo intervallo_casuale(const struct parametri *par, time_t durata, unsigned long long *stato);
+
+/*
+ * Funzione: stampa_risultato
+ * --------------------------
+ * Ordina le latenze misurate e stampa una riga nel formato descritto in testa al file.
+ *
+ * Parametri:
+ *    operazione: nome dell'operazione misurata
+ *    par: parametri della misura
+ *    latenze: vettore delle latenze in nanosecondi
+ *    n: numero di latenze
+ *
+ * Pre-condizioni:
+ *    latenze: non deve essere NULL
+ *    n: deve essere maggiore di 0
+ *
+ * Side-effect:
+ *    ordina il vettore `latenze` e stampa una riga su stdout
+ */
+static void stampa_risultato(const char *operazione, const struct parametri *par, unsigned long long *latenze, unsigned int n);
+
+/*
+ * Funzione: crea_flotta
+ * ---------------------
+ * Crea i veicoli e vi inserisce le prenotazioni in ordine casuale, misurando ogni
+ * chiamata ad `aggiungi_prenotazione`.
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 in caso di errore
+ */
+static int crea_flotta(const struct parametri *par, Veicolo *veicoli, unsigned long long *latenze, unsigned long long *stato);
+
+/*
+ * Funzione: misura_interrogazioni
+ * -------------------------------
+ * Misura `controlla_prenotazione` e `ottieni_intervallo_disponibile` su veicoli
+ * scelti secondo la distribuzione.
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 in caso di errore
+ */
+static int misura_interrogazioni(const struct parametri *par, const struct distribuzione *d, Veicolo *veicoli,
+                                 unsigned long long *latenze, unsigned long long *stato);
+
+/*
+ * Funzione: misura_istantanea
+ * ---------------------------
+ * Salva la flotta RIPETIZIONI_ISTANTANEA volte, la distrugge e la ricarica altrettante
+ * volte; l'ultima flotta caricata sostituisce quella di partenza in `veicoli`.
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 in caso di errore
+ *
+ * Side-effect:
+ *    crea e rimuove i file dell'istantanea nella cartella corrente
+ */
+static int misura_istantanea(const struct parametri *par, Veicolo *veicoli, unsigned long long *latenze);
+
+/*
+ * Funzione: misura_cancellazioni
+ * ------------------------------
+ * Misura `cancella_prenotazione` su veicoli scelti secondo la distribuzione e
+ * prenotazioni scelte a caso: con la distribuzione zipf una parte delle chiamate
+ * trova la prenotazione già cancellata.
+ */
+static void misura_cancellazioni(const struct parametri *par, const struct distribuzione *d, Veicolo *veicoli,
+                                 unsigned long long *latenze, unsigned long long *stato);
+
+/*
+ * Funzione: misura_tabella_hash
+ * -----------------------------
+ * Inserisce le targhe della flotta in una TabellaHash e le cerca secondo la distribuzione.
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 in caso di errore
+ */
+static int misura_tabella_hash(const struct parametri *par, const struct distribuzione *d, Veicolo *veicoli,
+                               unsigned long long *latenze, unsigned long long *stato);
+
+int main(int argc, char **argv){
+    struct parametri par = { VEICOLI_PREDEFINITI, PRENOTAZIONI_PER_VEICOLO_PREDEFINITE, INTERROGAZIONI_PREDEFINITE, "uniforme" };
+    unsigned long long stato = SEME_PREDEFINITO;
+    if(argc > 1) par.veicoli = (unsigned int)strtoul(argv[1], NULL, 10);
+    if(argc > 2) par.per_veicolo = (unsigned int)strtoul(argv[2], NULL, 10);
+    if(argc > 3) par.distribuzione = argv[3];
+    if(argc > 4) par.interrogazioni = (unsigned int)strtoul(argv[4], NULL, 10);
+    if(argc > 5) stato = strtoull(argv[5], NULL, 0);
+
+    struct distribuzione d = { 0, NULL };
+    unsigned long long totale = (unsigned long long)par.veicoli * par.per_veicolo;
+    if(par.veicoli == 0 || par.per_veicolo == 0 || par.interrogazioni == 0 || stato == 0 ||
+       totale > 0xFFFFFFFFULL || crea_distribuzione(&d, par.distribuzione, par.veicoli) < 0){
+        printf("./bench_strutture_dati [numero_veicoli] [prenotazioni_per_veicolo] [uniforme|zipf] [numero_interrogazioni] [seme]\n");
+        return -1;
+    }
+
+    unsigned int max_latenze = totale > par.interrogazioni ? (unsigned int)totale : par.interrogazioni;
+    unsigned long long *latenze = malloc(sizeof(unsigned long long) * max_latenze);
+    Veicolo *veicoli = calloc(par.veicoli, sizeof(Veicolo));
+    int esito = -1;
+    if(latenze == NULL || veicoli == NULL) goto fine;
+
+    printf("operazione;veicoli;prenotazioni_per_veicolo;distribuzione;operazioni;operazioni_al_secondo;p50_ns;p99_ns\n");
+
+    if(crea_flotta(&par, veicoli, latenze, &stato) < 0) goto fine;
+    stampa_risultato("aggiungi_prenotazione", &par, latenze, (unsigned int)totale);
+
+    if(misura_interrogazioni(&par, &d, veicoli, latenze, &stato) < 0) goto fine;
+    if(misura_istantanea(&par, veicoli, latenze) < 0) goto fine;
+    if(misura_tabella_hash(&par, &d, veicoli, latenze, &stato) < 0) goto fine;
+    misura_cancellazioni(&par, &d, veicoli, latenze, &stato);
+    esito = 0;
+
+fine:
+    for(unsigned int i = 0; veicoli != NULL && i < par.veicoli; i++) distruggi_veicolo(veicoli[i]);
+    free(veicoli);
+    free(latenze);
+    free(d.cumulata);
+    return esito;
+}
+
+static unsigned long long adesso_ns(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned long long)t.tv_sec * 1000000000ULL + (unsigned long long)t.tv_nsec;
+}
+
+static unsigned long long casuale(unsigned long long *stato){
+    unsigned long long x = *stato;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *stato = x;
+    return x;
+}
+
+static int crea_distribuzione(struct distribuzione *d, const char *nome, unsigned int n){
+    d->n = n;
+    d->cumulata = NULL;
+    if(strcmp(nome, "uniforme") == 0) return 0;
+    if(strcmp(nome, "zipf") != 0 || n == 0) return -1;
+
+    d->cumulata = malloc(sizeof(double) * n);
+    if(d->cumulata == NULL) return -1;
+
+    double somma = 0;
+    for(unsigned int k = 0; k < n; k++){
+        somma += 1.0 / (k + 1);
+        d->cumulata[k] = somma;
+    }
+    for(unsigned int k = 0; k < n; k++) d->cumulata[k] /= somma;
+    return 0;
+}
+
+static unsigned int estrai(const struct distribuzione *d, unsigned long long *stato){
+    if(d->cumulata == NULL) return (unsigned int)(casuale(stato) % d->n);
+
+    // Primo indice con probabilità cumulata maggiore di u, per bisezione
+    double u = (double)(casuale(stato) >> 11) / 9007199254740992.0;
+    unsigned int basso = 0, alto = d->n - 1;
+    while(basso < alto){
+        unsigned int medio = basso + (alto - basso) / 2;
+        if(d->cumulata[medio] > u) alto = medio;
+        else basso = medio + 1;
+    }
+    return basso;
+}
+
+static void scrivi_targa(char *targa, unsigned int i){
+    snprintf(targa, NUM_CARATTERI_TARGA, "%c%c%03u%c%c",
+             'A' + (i / 1000) % 26, 'A' + (i / 26000) % 26, i % 1000,
+             'A' + (i / 676000) % 26, 'A' + (i / 17576000) % 26);
+}
+
+static Intervallo intervallo_casuale(const struct parametri *par, time_t durata, unsigned long long *stato){
+    time_t t = INIZIO_CALENDARIO + (time_t)(casuale(stato) % ((unsigned long long)par->per_veicolo * 2 * ORA));
+    return crea_intervallo(t, t + durata);
+}
+
+static int compara_latenze(const void *a, const void *b){
+    unsigned long long x = *(const unsigned long long *)a;
+    unsigned long long y = *(const unsigned long long *)b;
+    return (x > y) - (x < y);
+}
+
+static void stampa_risultato(const char *operazione, const struct parametri *par, unsigned long long *latenze, unsigned int n){
+    unsigned long long totale = 0;
+    for(unsigned int i = 0; i < n; i++) totale += latenze[i];
+
+    qsort(latenze, n, sizeof(unsigned long long), compara_latenze);
+
+    printf("%s;%u;%u;%s;%u;%.0f;%llu;%llu\n", operazione, par->veicoli, par->per_veicolo, par->distribuzione, n,
+           totale > 0 ? n * 1e9 / totale : 0.0, latenze[n / 2], latenze[(unsigned int)((unsigned long long)n * 99 / 100)]);
+}
+
+static int crea_flotta(const struct parametri *par, Veicolo *veicoli, unsigned long long *latenze, unsigned long long *stato){
+    char targa[NUM_CARATTERI_TARGA];
+    unsigned int i, totale = par->veicoli * par->per_veicolo;
+
+    for(i = 0; i < par->veicoli; i++){
+        scrivi_targa(targa, i);
+        Prenotazioni prenotazioni = crea_prenotazioni();
+        veicoli[i] = crea_veicolo("Utilitaria", targa, "Modello", "Posizione", 1.0, prenotazioni);
+        if(veicoli[i] == NULL){
+            distruggi_prenotazioni(prenotazioni);
+            return -1;
+        }
+    }
+
+    // Ordine casuale delle coppie (veicolo, posizione nel calendario)
+    unsigned int *ordine = malloc(sizeof(unsigned int) * totale);
+    if(ordine == NULL) return -1;
+    for(i = 0; i < totale; i++) ordine[i] = i;
+    for(i = totale - 1; i > 0; i--){
+        unsigned int j = (unsigned int)(casuale(stato) % (i + 1));
+        unsigned int temp = ordine[i];
+        ordine[i] = ordine[j];
+        ordine[j] = temp;
+    }
+
+    for(i = 0; i < totale; i++){
+        Veicolo v = veicoli[ordine[i] / par->per_veicolo];
+        time_t t = INIZIO_CALENDARIO + (time_t)(ordine[i] % par->per_veicolo) * 2 * ORA;
+        Intervallo iv = crea_intervallo(t, t + ORA);
+        Prenotazione p = crea_prenotazione("cliente@carsharing.it", ottieni_targa(v), iv, 10.0);
+        distruggi_intervallo(iv);
+        if(p == NULL) break;
+
+        Prenotazioni prenotazioni = ottieni_prenotazioni(v);
+        unsigned long long inizio = adesso_ns();
+        Byte esito = aggiungi_prenotazione(prenotazioni, p);
+        latenze[i] = adesso_ns() - inizio;
+
+        if(esito != OK){
+            distruggi_prenotazione(p);
+            break;
+        }
+    }
+
+    free(ordine);
+    return i == totale ? 0 : -1;
+}
+
+static int misura_interrogazioni(const struct parametri *par, const struct distribuzione *d, Veicolo *veicoli,
+                                 unsigned long long *latenze, unsigned long long *stato){
+    unsigned int i, occupati = 0, disponibili = 0;
+
+    for(i = 0; i < par->interrogazioni; i++){
+        Prenotazioni prenotazioni = ottieni_prenotazioni(veicoli[estrai(d, stato)]);
+        Intervallo iv = intervallo_casuale(par, ORA / 2, stato);
+        if(iv == NULL) return -1;
+
+        unsigned long long inizio = adesso_ns();
+        Byte esito = controlla_prenotazione(prenotazioni, iv);
+        latenze[i] = adesso_ns() - inizio;
+
+        if(esito != OK) occupati++;
+        distruggi_intervallo(iv);
+    }
+    stampa_risultato("controlla_prenotazione", par, latenze, par->interrogazioni);
+
+    for(i = 0; i < par->interrogazioni; i++){
+        Prenotazioni prenotazioni = ottieni_prenotazioni(veicoli[estrai(d, stato)]);
+        Intervallo iv = intervallo_casuale(par, 4 * ORA, stato);
+        if(iv == NULL) return -1;
+
+        unsigned long long inizio = adesso_ns();
+        Intervallo libero = ottieni_intervallo_disponibile(prenotazioni, iv);
+        latenze[i] = adesso_ns() - inizio;
+
+        if(libero != NULL) disponibili++;
+        distruggi_intervallo(libero);
+        distruggi_intervallo(iv);
+    }
+    stampa_risultato("ottieni_intervallo_disponibile", par, latenze, par->interrogazioni);
+
+    // Evita che il compilatore consideri inutili i cicli misurati
+    fprintf(stderr, "occupati: %u, disponibili: %u\n", occupati, disponibili);
+    return 0;
+}
+
+static int misura_istantanea(const struct parametri *par, Veicolo *veicoli, unsigned long long *latenze){
+    unsigned int r, i, n = 0;
+    int esito = 0;
+
+    for(r = 0; r < RIPETIZIONI_ISTANTANEA; r++){
+        unsigned long long inizio = adesso_ns();
+        Byte salvato = salva_vettore_veicoli(FILE_VEICOLI, FILE_PRENOTAZIONI_VEICOLI, veicoli, par->veicoli, r + 1);
+        latenze[r] = adesso_ns() - inizio;
+        if(!salvato){
+            esito = -1;
+            goto fine;
+        }
+    }
+    stampa_risultato("salva_istantanea", par, latenze, RIPETIZIONI_ISTANTANEA);
+
+    // Con la flotta originale viva le prenotazioni caricate la condividerebbero per identificativo
+    for(i = 0; i < par->veicoli; i++){
+        distruggi_veicolo(veicoli[i]);
+        veicoli[i] = NULL;
+    }
+
+    for(r = 0; r < RIPETIZIONI_ISTANTANEA && esito == 0; r++){
+        unsigned long long inizio = adesso_ns();
+        Veicolo *caricati = carica_vettore_veicoli(FILE_VEICOLI, FILE_PRENOTAZIONI_VEICOLI, &n);
+        for(i = 0; caricati != NULL && i < n; i++) ottieni_prenotazioni(caricati[i]);
+        latenze[r] = adesso_ns() - inizio;
+
+        if(caricati == NULL || n != par->veicoli) esito = -1;
+        for(i = 0; caricati != NULL && i < n; i++){
+            if(esito == 0 && r == RIPETIZIONI_ISTANTANEA - 1) veicoli[i] = caricati[i];
+            else distruggi_veicolo(caricati[i]);
+        }
+        free(caricati);
+    }
+    if(esito == 0) stampa_risultato("carica_istantanea", par, latenze, RIPETIZIONI_ISTANTANEA);
+
+fine:
+    remove(FILE_VEICOLI);
+    remove(FILE_PRENOTAZIONI_VEICOLI);
+    return esito;
+}
+
+static void misura_cancellazioni(const struct parametri *par, const struct distribuzione *d, Veicolo *veicoli,
+                                 unsigned long long *latenze, unsigned long long *stato){
+    unsigned int i, cancellate = 0;
+    unsigned int n = par->interrogazioni < par->veicoli * par->per_veicolo ? par->interrogazioni : par->veicoli * par->per_veicolo;
+
+    for(i = 0; i < n; i++){
+        Prenotazioni prenotazioni = ottieni_prenotazioni(veicoli[estrai(d, stato)]);
+        time_t t = INIZIO_CALENDARIO + (time_t)(casuale(stato) % par->per_veicolo) * 2 * ORA;
+        Intervallo iv = crea_intervallo(t, t + ORA);
+
+        unsigned long long inizio = adesso_ns();
+        Byte esito = cancella_prenotazione(prenotazioni, iv);
+        latenze[i] = adesso_ns() - inizio;
+
+        cancellate += esito;
+        distruggi_intervallo(iv);
+    }
+    stampa_risultato("cancella_prenotazione", par, latenze, n);
+    fprintf(stderr, "cancellate: %u\n", cancellate);
+}
+
+static void non_distruggere(void *valore){
+    (void)valore;
+}
+
+static int misura_tabella_hash(const struct parametri *par, const struct distribuzione *d, Veicolo *veicoli,
+                               unsigned long long *latenze, unsigned long long *stato){
+    TabellaHash tabella = nuova_tabella_hash(par->veicoli);
+    if(tabella == NULL) return -1;
+
+    unsigned int i, trovati = 0;
+    for(i = 0; i < par->veicoli; i++){
+        const char *targa = ottieni_targa(veicoli[i]);
+        unsigned long long inizio = adesso_ns();
+        Byte esito = inserisci_in_tabella(tabella, targa, veicoli[i]);
+        latenze[i] = adesso_ns() - inizio;
+
+        if(!esito){
+            distruggi_tabella(tabella, non_distruggere);
+            return -1;
+        }
+    }
+    stampa_risultato("inserisci_in_tabella", par, latenze, par->veicoli);
+
+    for(i = 0; i < par->interrogazioni; i++){
+        const char *targa = ottieni_targa(veicoli[estrai(d, stato)]);
+        unsigned long long inizio = adesso_ns();
+        const void *valore = cerca_in_tabella(tabella, targa);
+        latenze[i] = adesso_ns() - inizio;
+
+        trovati += valore != NULL;
+    }
+    stampa_risultato("cerca_in_tabella", par, latenze, par->interrogazioni);
+    fprintf(stderr, "trovati: %u\n", trovati);
+
+    distruggi_tabella(tabella, non_distruggere);
+    return 0;
+}
@@ -0,0 +1,201 @@
+/*
+ * Misura la latenza dei singoli inserimenti in TabellaUtenti e TabellaVeicoli
+ * partendo da una tabella piccola, così da attraversare molti ridimensionamenti.
+ * Il valore da osservare è la latenza massima: con il rehash sincrono cresce
+ * linearmente con il numero di elementi, con quello incrementale resta limitata.
+ *
+ * Uso: ./bench_tabella_hash [numero_elementi]
+ * Output (una riga per operazione, separata da ';'):
+ *    operazione;elementi;media_ns;p50_ns;p99_ns;max_ns
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "modelli/utente.h"
+#include "modelli/veicolo.h"
+#include "strutture_dati/tabella_utenti.h"
+#include "strutture_dati/tabella_veicoli.h"
+#include "utils/md5.h"
+
+#define ELEMENTI_PREDEFINITI 1000000
+#define GRANDEZZA_INIZIALE 20
+
+/*
+ * Funzione: adesso_ns
+ * -------------------
+ * Restituisce il tempo corrente di un orologio monotono in nanosecondi.
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit
+ */
+static unsigned long long adesso_ns(void);
+
+/*
+ * Funzione: stampa_latenze
+ * ------------------------
+ * Ordina le latenze misurate e stampa media, mediana, 99-esimo percentile e massimo.
+ *
+ * Parametri:
+ *    operazione: nome dell'operazione misurata
+ *    latenze: vettore delle latenze in nanosecondi
+ *    n: numero di latenze
+ *
+ * Pre-condizioni:
+ *    latenze: non deve essere NULL
+ *    n: deve essere maggiore di 0
+ *
+ * Side-effect:
+ *    ordina il vettore `latenze` e stampa una riga su stdout
+ */
+static void stampa_latenze(const char *operazione, unsigned long long *latenze, unsigned int n);
+
+/*
+ * Funzione: misura_utenti
+ * -----------------------
+ * Inserisce `n` utenti in una TabellaUtenti piccola misurando ogni chiamata
+ * ad `aggiungi_utente_in_tabella`.
+ *
+ * Parametri:
+ *    n: numero di utenti da inserire
+ *    latenze: vettore di almeno `n` elementi in cui salvare le latenze
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 in caso di errore
+ */
+static int misura_utenti(unsigned int n, unsigned long long *latenze);
+
+/*
+ * Funzione: misura_veicoli
+ * ------------------------
+ * Inserisce `n` veicoli in una TabellaVeicoli piccola misurando ogni chiamata
+ * ad `aggiungi_veicolo_in_tabella`.
+ *
+ * Parametri:
+ *    n: numero di veicoli da inserire
+ *    latenze: vettore di almeno `n` elementi in cui salvare le latenze
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 in caso di errore
+ */
+static int misura_veicoli(unsigned int n, unsigned long long *latenze);
+
+int main(int argc, char **argv){
+    unsigned int n = ELEMENTI_PREDEFINITI;
+    if(argc > 1) n = (unsigned int)strtoul(argv[1], NULL, 10);
+    if(n == 0){
+        printf("./bench_tabella_hash [numero_elementi]\n");
+        return -1;
+    }
+
+    unsigned long long *latenze = malloc(sizeof(unsigned long long) * n);
+    if(latenze == NULL) return -1;
+
+    printf("operazione;elementi;media_ns;p50_ns;p99_ns;max_ns\n");
+
+    if(misura_utenti(n, latenze) < 0){
+        free(latenze);
+        return -1;
+    }
+    stampa_latenze("aggiungi_utente_in_tabella", latenze, n);
+
+    if(misura_veicoli(n, latenze) < 0){
+        free(latenze);
+        return -1;
+    }
+    stampa_latenze("aggiungi_veicolo_in_tabella", latenze, n);
+
+    free(latenze);
+    return 0;
+}
+
+static unsigned long long adesso_ns(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned long long)t.tv_sec * 1000000000ULL + (unsigned long long)t.tv_nsec;
+}
+
+static int compara_latenze(const void *a, const void *b){
+    unsigned long long x = *(const unsigned long long *)a;
+    unsigned long long y = *(const unsigned long long *)b;
+    return (x > y) - (x < y);
+}
+
+static void stampa_latenze(const char *operazione, unsigned long long *latenze, unsigned int n){
+    unsigned long long totale = 0;
+    unsigned int i;
+    for(i = 0; i < n; i++) totale += latenze[i];
+
+    qsort(latenze, n, sizeof(unsigned long long), compara_latenze);
+
+    printf("%s;%u;%llu;%llu;%llu;%llu\n", operazione, n, totale / n,
+           latenze[n / 2], latenze[(unsigned int)((unsigned long long)n * 99 / 100)], latenze[n - 1]);
+}
+
+static int misura_utenti(unsigned int n, unsigned long long *latenze){
+    TabellaUtenti tabella = crea_tabella_utenti(GRANDEZZA_INIZIALE);
+    if(tabella == NULL) return -1;
+
+    uint8_t password[DIMENSIONE_PASSWORD];
+    char email[64];
+    unsigned int i;
+
+    memset(password, 0, sizeof(password));
+    for(i = 0; i < n; i++){
+        snprintf(email, sizeof(email), "utente%u@carsharing.it", i);
+        Utente u = crea_utente(email, password, "Nome", "Cognome", CLIENTE);
+        if(u == NULL){
+            distruggi_tabella_utenti(tabella);
+            return -1;
+        }
+
+        unsigned long long inizio = adesso_ns();
+        Byte esito = aggiungi_utente_in_tabella(tabella, u);
+        latenze[i] = adesso_ns() - inizio;
+
+        if(!esito){
+            distruggi_utente(u);
+            distruggi_tabella_utenti(tabella);
+            return -1;
+        }
+    }
+
+    distruggi_tabella_utenti(tabella);
+    return 0;
+}
+
+static int misura_veicoli(unsigned int n, unsigned long long *latenze){
+    TabellaVeicoli tabella = crea_tabella_veicoli(GRANDEZZA_INIZIALE);
+    if(tabella == NULL) return -1;
+
+    char targa[NUM_CARATTERI_TARGA];
+    unsigned int i;
+
+    for(i = 0; i < n; i++){
+        // Targhe nel formato AA000AA, distinte per ogni i < 26^4 * 1000
+        snprintf(targa, sizeof(targa), "%c%c%03u%c%c",
+                 'A' + (i / 1000) % 26, 'A' + (i / 26000) % 26, i % 1000,
+                 'A' + (i / 676000) % 26, 'A' + (i / 17576000) % 26);
+        Veicolo v = crea_veicolo("Utilitaria", targa, "Modello", "Posizione", 1.0, NULL);
+        if(v == NULL){
+            distruggi_tabella_veicoli(tabella);
+            return -1;
+        }
+
+        unsigned long long inizio = adesso_ns();
+        Byte esito = aggiungi_veicolo_in_tabella(tabella, v);
+        latenze[i] = adesso_ns() - inizio;
+
+        if(!esito){
+            distruggi_veicolo(v);
+            distruggi_tabella_veicoli(tabella);
+            return -1;
+        }
+    }
+
+    distruggi_tabella_veicoli(tabella);
+    return 0;
+}
@@ -0,0 +1,461 @@
+/*
+ * Genera un insieme di dati sintetico e deterministico (a parità di seme, di fuso
+ * orario e di data di inizio) per misurare il programma su grandi volumi:
+ * `num_utenti` clienti, `num_veicoli` veicoli dei tipi di test/veicoli.txt e
+ * `num_prenotazioni` prenotazioni non sovrapposte.
+ *
+ * Gli orari delle prenotazioni seguono un andamento giornaliero e settimanale
+ * coerente con le fasce di `determina_fascia_oraria`: nei giorni feriali la domanda
+ * è bassa di notte (22:00-06:00), cresce nella fascia mattutina (06:00-08:00) e ha
+ * i picchi negli orari di punta, mentre nel fine settimana si sposta sulle ore
+ * centrali e le prenotazioni durano di più. Il calendario parte dalla data indicata
+ * (gg/mm/aaaa), altrimenti da oggi, e, se non indicato, è lungo abbastanza da occupare
+ * circa il 40% del tempo di ogni veicolo. Una prenotazione che si sovrappone a una già
+ * generata o che inizia nel passato, e che il programma quindi rifiuterebbe, viene
+ * riestratta.
+ *
+ * Nella cartella di destinazione vengono scritti:
+ *    utenti.txt        Nome;Cognome;email;password (come test/utenti.txt)
+ *    veicoli.txt       targa;modello;posizione;tariffa;tipo (come test/veicoli.txt)
+ *    prenotazioni.txt  email;targa;gg/mm/aaaa hh:mm;gg/mm/aaaa hh:mm (come test/TC1/input.txt)
+ *    archivio/         l'istantanea (utenti.bin, dati_utenti.bin, veicoli.bin,
+ *                      prenotazioni_veicoli.bin), caricata da car_sharing avviato
+ *                      nella cartella di destinazione
+ * Il costo delle prenotazioni è quello di `calcola_costo`, senza sconti.
+ *
+ * Uso: ./genera_carico cartella [numero_utenti] [numero_veicoli] [numero_prenotazioni] [seme] [giorni] [inizio]
+ * Output (separato da ';'):
+ *    utenti;veicoli;prenotazioni;generate;giorni;ms
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "modelli/intervallo.h"
+#include "modelli/prenotazione.h"
+#include "modelli/utente.h"
+#include "modelli/veicolo.h"
+#include "strutture_dati/prenotazioni.h"
+#include "utils/gestore_file.h"
+#include "utils/md5.h"
+#include "utils/utils.h"
+
+#define UTENTI_PREDEFINITI 100000
+#define VEICOLI_PREDEFINITI 10000
+#define PRENOTAZIONI_PREDEFINITE 1000000
+#define SEME_PREDEFINITO 0x9E3779B97F4A7C15ULL
+#define TENTATIVI_PRENOTAZIONE 8
+#define OCCUPAZIONE_OBIETTIVO 0.4
+#define MEZZ_ORA 1800
+#define MASSIMO_PERCORSO_FILE 1024
+#define DIMENSIONE_DATA 20
+#define GENERAZIONE_ARCHIVIO 1     // Generazione comune ai quattro file dell'archivio generato
+
+// Giorni in cui vengono estratte le prenotazioni
+struct calendario {
+    struct tm primo_giorno;    // mezzanotte locale del primo giorno
+    unsigned int settimane;
+    time_t adesso;             // le prenotazioni che iniziano prima vengono riestratte
+};
+
+// Veicolo di test/veicoli.txt usato come modello
+struct modello_veicolo {
+    const char *modello;
+    const char *posizione;
+    double tariffa;
+    const char *tipo;
+};
+
+static const struct modello_veicolo modelli[] = {
+    { "Fiat Panda", "Milano Centrale", 0.015, "Utilitaria" },
+    { "Tesla Model 3", "Roma Termini", 0.012, "Elettrico" },
+    { "Ford Transit", "Bologna Centro", 0.016, "Furgone" },
+    { "Renault Clio", "Napoli Stazione", 0.023, "Utilitaria" },
+    { "BMW X5", "Firenze SMN", 0.026, "SUV" },
+    { "Volkswagen ID.4", "Torino Porta Susa", 0.025, "Elettrico" },
+};
+#define NUM_MODELLI (sizeof(modelli) / sizeof(modelli[0]))
+
+static const char *nomi[] = { "Mario", "Anna", "Luca", "Giulia", "Marco", "Sara", "Paolo", "Chiara" };
+static const char *cognomi[] = { "Rossi", "Verdi", "Bianchi", "Esposito", "Romano", "Colombo", "Ricci", "Greco" };
+#define NUM_NOMI (sizeof(nomi) / sizeof(nomi[0]))
+#define NUM_COGNOMI (sizeof(cognomi) / sizeof(cognomi[0]))
+
+// Peso di ogni ora di inizio: feriali con picchi alle 8, 13 e 18, fine settimana sulle ore centrali
+static const unsigned int peso_ora_feriale[24] = { 1, 1, 1, 1, 1, 2, 6, 10, 14, 10, 7, 7, 9, 8, 7, 7, 10, 14, 13, 9, 6, 4, 3, 2 };
+static const unsigned int peso_ora_festivo[24] = { 2, 1, 1, 1, 1, 1, 1, 2, 4, 8, 12, 13, 12, 11, 11, 11, 11, 10, 9, 8, 7, 5, 4, 3 };
+
+// Peso di ogni giorno della settimana, da lunedì a domenica
+static const unsigned int peso_giorno[7] = { 10, 10, 10, 10, 12, 14, 11 };
+
+/*
+ * Funzione: adesso_ns
+ * -------------------
+ * Restituisce il tempo corrente di un orologio monotono in nanosecondi.
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit
+ */
+static unsigned long long adesso_ns(void);
+
+/*
+ * Funzione: casuale
+ * -----------------
+ * Generatore pseudo-casuale xorshift64, deterministico e indipendente dalla libc.
+ *
+ * Parametri:
+ *    stato: lo stato del generatore
+ *
+ * Pre-condizioni:
+ *    stato: non deve essere NULL né puntare a 0
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit
+ *
+ * Side-effect:
+ *    aggiorna lo stato del generatore
+ */
+static unsigned long long casuale(unsigned long long *stato);
+
+/*
+ * Funzione: estrai_pesato
+ * -----------------------
+ * Estrae un indice in [0, n) con probabilità proporzionale a `pesi[indice]`.
+ */
+static unsigned int estrai_pesato(const unsigned int *pesi, unsigned int n, unsigned long long *stato);
+
+/*
+ * Funzione: scrivi_targa
+ * ----------------------
+ * Scrive in `targa` la targa, nel formato AA000AA, del veicolo `i`.
+ */
+static void scrivi_targa(char *targa, unsigned int i);
+
+/*
+ * Funzione: scrivi_email
+ * ----------------------
+ * Scrive in `email` l'indirizzo dell'utente `i`.
+ */
+static void scrivi_email(char *email, size_t dimensione, unsigned int i);
+
+/*
+ * Funzione: apri_in_cartella
+ * --------------------------
+ * Compone in `percorso` il file `nome` della cartella e, se `modalita` non è NULL,
+ * lo apre.
+ *
+ * Ritorna:
+ *    il file aperto, oppure NULL se `modalita` è NULL o l'apertura fallisce
+ */
+static FILE *apri_in_cartella(char *percorso, const char *cartella, const char *nome, const char *modalita);
+
+/*
+ * Funzione: imposta_calendario
+ * ----------------------------
+ * Fa partire il calendario dalla data `data` (gg/mm/aaaa), oppure da oggi se `data` è NULL.
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 se la data non è valida
+ */
+static int imposta_calendario(struct calendario *calendario, const char *data, unsigned int giorni);
+
+/*
+ * Funzione: genera_utenti
+ * -----------------------
+ * Crea i clienti e li scrive in utenti.txt.
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 in caso di errore
+ */
+static int genera_utenti(Utente *utenti, unsigned int num_utenti, FILE *file);
+
+/*
+ * Funzione: genera_veicoli
+ * ------------------------
+ * Crea i veicoli, a rotazione sui modelli di test/veicoli.txt, e li scrive in veicoli.txt.
+ *
+ * Ritorna:
+ *    0 in caso di successo, -1 in caso di errore
+ */
+static int genera_veicoli(Veicolo *veicoli, unsigned int num_veicoli, FILE *file);
+
+/*
+ * Funzione: genera_intervallo
+ * ---------------------------
+ * Estrae un intervallo del calendario secondo l'andamento giornaliero e settimanale.
+ *
+ * Implementazione:
+ *    Estrae la settimana in modo uniforme, poi il giorno della settimana e l'ora di
+ *    inizio secondo i pesi, con inizio all'ora o alla mezz'ora. Le settimane partono
+ *    dal primo giorno del calendario, qualunque giorno sia. L'istante è calcolato
+ *    con mktime nell'ora locale, la stessa usata da `determina_fascia_oraria`.
+ *    La durata va da mezz'ora a tre ore e mezza nei giorni feriali e da un'ora a sei
+ *    ore nel fine settimana.
+ *
+ * Ritorna:
+ *    un nuovo intervallo oppure NULL in caso di errore
+ */
+static Intervallo genera_intervallo(const struct calendario *calendario, unsigned long long *stato);
+
+/*
+ * Funzione: genera_prenotazioni
+ * -----------------------------
+ * Genera `num_prenotazioni` prenotazioni, le aggiunge ai veicoli e agli storici dei
+ * clienti e le scrive in prenotazioni.txt.
+ *
+ * Ritorna:
+ *    il numero di prenotazioni generate, oppure -1 in caso di errore
+ */
+static long genera_prenotazioni(Utente *utenti, unsigned int num_utenti, Veicolo *veicoli, unsigned int num_veicoli,
+                                unsigned int num_prenotazioni, const struct calendario *calendario, unsigned long long *stato,
+                                FILE *file);
+
+int main(int argc, char **argv){
+    unsigned int num_utenti = UTENTI_PREDEFINITI;
+    unsigned int num_veicoli = VEICOLI_PREDEFINITI;
+    unsigned int num_prenotazioni = PRENOTAZIONI_PREDEFINITE;
+    unsigned long long stato = SEME_PREDEFINITO;
+    unsigned int giorni = 0;
+    if(argc > 2) num_utenti = (unsigned int)strtoul(argv[2], NULL, 10);
+    if(argc > 3) num_veicoli = (unsigned int)strtoul(argv[3], NULL, 10);
+    if(argc > 4) num_prenotazioni = (unsigned int)strtoul(argv[4], NULL, 10);
+    if(argc > 5) stato = strtoull(argv[5], NULL, 0);
+    if(argc > 6) giorni = (unsigned int)strtoul(argv[6], NULL, 10);
+    if(argc < 2 || num_utenti == 0 || num_veicoli == 0 || stato == 0){
+        printf("./genera_carico cartella [numero_utenti] [numero_veicoli] [numero_prenotazioni] [seme] [giorni] [inizio]\n");
+        return -1;
+    }
+
+    // Durata media di una prenotazione: due ore nei feriali, tre ore e mezza nel fine settimana
+    if(giorni == 0)
+        giorni = (unsigned int)((double)num_prenotazioni / num_veicoli * 2.5 / (24 * OCCUPAZIONE_OBIETTIVO)) + 1;
+    struct calendario calendario;
+    if(imposta_calendario(&calendario, argc > 7 ? argv[7] : NULL, giorni) < 0){
+        printf("Data di inizio non valida (formato: gg/mm/aaaa)\n");
+        return -1;
+    }
+
+    const char *cartella = argv[1];
+    char percorso[MASSIMO_PERCORSO_FILE], secondo_percorso[MASSIMO_PERCORSO_FILE];
+    mkdir(cartella, 0755);
+    apri_in_cartella(percorso, cartella, "archivio", NULL);
+    mkdir(percorso, 0755);
+
+    FILE *file_utenti = apri_in_cartella(percorso, cartella, "utenti.txt", "w");
+    FILE *file_veicoli = apri_in_cartella(percorso, cartella, "veicoli.txt", "w");
+    FILE *file_prenotazioni = apri_in_cartella(percorso, cartella, "prenotazioni.txt", "w");
+    Utente *utenti = calloc(num_utenti, sizeof(Utente));
+    Veicolo *veicoli = calloc(num_veicoli, sizeof(Veicolo));
+    int esito = -1;
+    unsigned int i;
+    if(file_utenti == NULL || file_veicoli == NULL || file_prenotazioni == NULL || utenti == NULL || veicoli == NULL){
+        printf("Impossibile creare i file nella cartella %s\n", cartella);
+        goto fine;
+    }
+
+    unsigned long long inizio = adesso_ns();
+    if(genera_utenti(utenti, num_utenti, file_utenti) < 0) goto fine;
+    if(genera_veicoli(veicoli, num_veicoli, file_veicoli) < 0) goto fine;
+    long generate = genera_prenotazioni(utenti, num_utenti, veicoli, num_veicoli, num_prenotazioni,
+                                        &calendario, &stato, file_prenotazioni);
+    if(generate < 0) goto fine;
+
+    apri_in_cartella(percorso, cartella, "archivio/utenti.bin", NULL);
+    apri_in_cartella(secondo_percorso, cartella, "archivio/dati_utenti.bin", NULL);
+    if(!salva_vettore_utenti(percorso, secondo_percorso, utenti, num_utenti, GENERAZIONE_ARCHIVIO)) goto fine;
+    apri_in_cartella(percorso, cartella, "archivio/veicoli.bin", NULL);
+    apri_in_cartella(secondo_percorso, cartella, "archivio/prenotazioni_veicoli.bin", NULL);
+    if(!salva_vettore_veicoli(percorso, secondo_percorso, veicoli, num_veicoli, GENERAZIONE_ARCHIVIO)) goto fine;
+
+    printf("utenti;veicoli;prenotazioni;generate;giorni;ms\n");
+    printf("%u;%u;%u;%ld;%u;%.1f\n", num_utenti, num_veicoli, num_prenotazioni, generate, calendario.settimane * 7,
+           (adesso_ns() - inizio) / 1e6);
+    esito = 0;
+
+fine:
+    if(file_utenti != NULL) fclose(file_utenti);
+    if(file_veicoli != NULL) fclose(file_veicoli);
+    if(file_prenotazioni != NULL) fclose(file_prenotazioni);
+    for(i = 0; utenti != NULL && i < num_utenti; i++) distruggi_utente(utenti[i]);
+    for(i = 0; veicoli != NULL && i < num_veicoli; i++) distruggi_veicolo(veicoli[i]);
+    free(utenti);
+    free(veicoli);
+    return esito;
+}
+
+static unsigned long long adesso_ns(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned long long)t.tv_sec * 1000000000ULL + (unsigned long long)t.tv_nsec;
+}
+
+static unsigned long long casuale(unsigned long long *stato){
+    unsigned long long x = *stato;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *stato = x;
+    return x;
+}
+
+static unsigned int estrai_pesato(const unsigned int *pesi, unsigned int n, unsigned long long *stato){
+    unsigned int totale = 0, i;
+    for(i = 0; i < n; i++) totale += pesi[i];
+
+    unsigned int r = (unsigned int)(casuale(stato) % totale);
+    for(i = 0; r >= pesi[i]; i++) r -= pesi[i];
+    return i;
+}
+
+static void scrivi_targa(char *targa, unsigned int i){
+    snprintf(targa, NUM_CARATTERI_TARGA, "%c%c%03u%c%c",
+             'A' + (i / 1000) % 26, 'A' + (i / 26000) % 26, i % 1000,
+             'A' + (i / 676000) % 26, 'A' + (i / 17576000) % 26);
+}
+
+static void scrivi_email(char *email, size_t dimensione, unsigned int i){
+    snprintf(email, dimensione, "%s.%s%u@email.com", nomi[i % NUM_NOMI], cognomi[(i / NUM_NOMI) % NUM_COGNOMI], i);
+    for(char *c = email; *c != '\0'; c++)
+        if(*c >= 'A' && *c <= 'Z') *c += 'a' - 'A';
+}
+
+static FILE *apri_in_cartella(char *percorso, const char *cartella, const char *nome, const char *modalita){
+    snprintf(percorso, MASSIMO_PERCORSO_FILE, "%s/%s", cartella, nome);
+    return modalita != NULL ? fopen(percorso, modalita) : NULL;
+}
+
+static int imposta_calendario(struct calendario *calendario, const char *data, unsigned int giorni){
+    calendario->adesso = time(NULL);
+    calendario->settimane = (giorni + 6) / 7;
+
+    struct tm *oggi = localtime(&calendario->adesso);
+    if(oggi == NULL) return -1;
+    struct tm primo = *oggi;
+    if(data != NULL){
+        int giorno, mese, anno;
+        char resto;
+        if(sscanf(data, "%d/%d/%d%c", &giorno, &mese, &anno, &resto) != 3) return -1;
+        primo.tm_mday = giorno;
+        primo.tm_mon = mese - 1;
+        primo.tm_year = anno - 1900;
+    }
+    primo.tm_hour = primo.tm_min = primo.tm_sec = 0;
+    primo.tm_isdst = -1;
+
+    // mktime normalizza le date fuori intervallo (es. 31/02): qui vengono rifiutate
+    struct tm normalizzata = primo;
+    if(mktime(&normalizzata) == (time_t)-1 || normalizzata.tm_mday != primo.tm_mday ||
+       normalizzata.tm_mon != primo.tm_mon || normalizzata.tm_year != primo.tm_year) return -1;
+    calendario->primo_giorno = normalizzata;
+    return 0;
+}
+
+static int genera_utenti(Utente *utenti, unsigned int num_utenti, FILE *file){
+    uint8_t password_hash[DIMENSIONE_PASSWORD];
+    char email[64], password[32];
+
+    for(unsigned int i = 0; i < num_utenti; i++){
+        const char *nome = nomi[i % NUM_NOMI];
+        const char *cognome = cognomi[(i / NUM_NOMI) % NUM_COGNOMI];
+        scrivi_email(email, sizeof(email), i);
+        snprintf(password, sizeof(password), "Passw0rd!%u", i);
+
+        md5(password, strlen(password), password_hash);
+        utenti[i] = crea_utente(email, password_hash, nome, cognome, CLIENTE);
+        if(utenti[i] == NULL) return -1;
+        fprintf(file, "%s;%s;%s;%s\n", nome, cognome, email, password);
+    }
+    return 0;
+}
+
+static int genera_veicoli(Veicolo *veicoli, unsigned int num_veicoli, FILE *file){
+    char targa[NUM_CARATTERI_TARGA];
+
+    for(unsigned int i = 0; i < num_veicoli; i++){
+        const struct modello_veicolo *m = &modelli[i % NUM_MODELLI];
+        scrivi_targa(targa, i);
+
+        Prenotazioni prenotazioni = crea_prenotazioni();
+        veicoli[i] = crea_veicolo(m->tipo, targa, m->modello, m->posizione, m->tariffa, prenotazioni);
+        if(veicoli[i] == NULL){
+            distruggi_prenotazioni(prenotazioni);
+            return -1;
+        }
+        fprintf(file, "%s;%s;%s;%.3f;%s\n", targa, m->modello, m->posizione, m->tariffa, m->tipo);
+    }
+    return 0;
+}
+
+static Intervallo genera_intervallo(const struct calendario *calendario, unsigned long long *stato){
+    unsigned int settimana = (unsigned int)(casuale(stato) % calendario->settimane);
+    unsigned int giorno = estrai_pesato(peso_giorno, 7, stato);
+    Byte festivo = giorno >= 5;
+    unsigned int ora = estrai_pesato(festivo ? peso_ora_festivo : peso_ora_feriale, 24, stato);
+
+    // Giorni dal primo del calendario al giorno estratto (tm_wday conta da domenica);
+    // mktime normalizza giorni e minuti oltre il mese
+    unsigned int primo = (unsigned int)(calendario->primo_giorno.tm_wday + 6) % 7;
+    struct tm data = calendario->primo_giorno;
+    data.tm_mday += (int)(settimana * 7 + (giorno + 7 - primo) % 7);
+    data.tm_hour = (int)ora;
+    data.tm_min = casuale(stato) % 2 ? 30 : 0;
+    data.tm_isdst = -1;
+    time_t inizio = mktime(&data);
+    if(inizio == (time_t)-1) return NULL;
+
+    unsigned int mezz_ore = festivo ? 2 + (unsigned int)(casuale(stato) % 6) + (unsigned int)(casuale(stato) % 6)
+                                    : 1 + (unsigned int)(casuale(stato) % 4) + (unsigned int)(casuale(stato) % 4);
+    return crea_intervallo(inizio, inizio + (time_t)mezz_ore * MEZZ_ORA);
+}
+
+static long genera_prenotazioni(Utente *utenti, unsigned int num_utenti, Veicolo *veicoli, unsigned int num_veicoli,
+                                unsigned int num_prenotazioni, const struct calendario *calendario, unsigned long long *stato,
+                                FILE *file){
+    char data_inizio[DIMENSIONE_DATA], data_fine[DIMENSIONE_DATA];
+    long generate = 0;
+
+    for(unsigned int k = 0; k < num_prenotazioni; k++){
+        Utente u = utenti[casuale(stato) % num_utenti];
+        Veicolo v = veicoli[casuale(stato) % num_veicoli];
+
+        for(unsigned int tentativo = 0; tentativo < TENTATIVI_PRENOTAZIONE; tentativo++){
+            Intervallo intervallo = genera_intervallo(calendario, stato);
+            if(intervallo == NULL) return -1;
+            if(inizio_intervallo(intervallo) < calendario->adesso){
+                distruggi_intervallo(intervallo);
+                continue;
+            }
+
+            Prenotazione p = crea_prenotazione(ottieni_email(u), ottieni_targa(v), intervallo,
+                                               calcola_costo(ottieni_tariffa(v), intervallo));
+            if(p == NULL){
+                distruggi_intervallo(intervallo);
+                return -1;
+            }
+
+            // L'albero del veicolo prende il riferimento creato qui, lo storico ne condivide uno
+            if(aggiungi_prenotazione_veicolo(v, p) != OK){
+                distruggi_prenotazione(p);
+                distruggi_intervallo(intervallo);
+                continue;
+            }
+            if(!aggiungi_a_storico_utente(u, p)){
+                distruggi_intervallo(intervallo);
+                return -1;
+            }
+
+            time_t inizio = inizio_intervallo(intervallo), fine = fine_intervallo(intervallo);
+            strftime(data_inizio, sizeof(data_inizio), "%d/%m/%Y %H:%M", localtime(&inizio));
+            strftime(data_fine, sizeof(data_fine), "%d/%m/%Y %H:%M", localtime(&fine));
+            fprintf(file, "%s;%s;%s;%s\n", ottieni_email(u), ottieni_targa(v), data_inizio, data_fine);
+            distruggi_intervallo(intervallo);
+            generate++;
+            break;
+        }
+    }
+    return generate;
+}
@@ -7,9 +7,10 @@
 typedef struct prenotazione *Prenotazione;
 typedef struct veicolo *Veicolo;
 typedef struct tabella_hash *TabellaUtenti;
-typedef struct tabella_hash *TabellaVeicoli;
+typedef struct tabella_veicoli *TabellaVeicoli;
 typedef struct intervallo *Intervallo;
 typedef struct utente* Utente;
+typedef struct giornale *Giornale;
 
 /*
  * Funzione: stampa_errore
@@ -222,6 +223,7 @@ Utente interfaccia_accesso(TabellaUtenti tabella_utenti);
  * Parametri:
  *    tabella_utenti: struttura contenente la lista di utenti registrati
  *    permesso: livello di permesso da assegnare al nuovo utente
+ *    giornale: giornale su cui registrare il nuovo utente (può essere NULL)
  *
  * Pre-condizione:
  *    tabella_utenti deve essere inizializzata e non nullo
@@ -235,9 +237,9 @@ Utente interfaccia_accesso(TabellaUtenti tabella_utenti);
  *    un valore di tipo Byte(0, 1 o -1)
  *
  * Side-effect:
- *    Aggiunta di un nuovo utente alla tabella utenti
+ *    Aggiunta di un nuovo utente alla tabella utenti e al giornale
  */
-Byte interfaccia_registrazione(TabellaUtenti tabella_utenti, Byte permesso);
+Byte interfaccia_registrazione(TabellaUtenti tabella_utenti, Byte permesso, Giornale giornale);
 
 /*
  * Funzione: menu_registrazione
@@ -247,6 +249,7 @@ Byte interfaccia_registrazione(TabellaUtenti tabella_utenti, Byte permesso);
  *
  * Parametri:
  *    tabella_utenti: tabella contenente gli utenti registrati
+ *    giornale: giornale su cui registrare il nuovo utente (può essere NULL)
  *
  * Pre-condizione:
  *    tabella_utenti deve essere inizializzata e non NULL
@@ -258,7 +261,7 @@ Byte interfaccia_registrazione(TabellaUtenti tabella_utenti, Byte permesso);
  *    L'utente è stato registrato (se operazione riuscita) e informato del risultato
  *    Output su console, attesa input utente, possibile modifica tabella utenti
  */
-void menu_registrazione(TabellaUtenti tabella_utenti);
+void menu_registrazione(TabellaUtenti tabella_utenti, Giornale giornale);
 
 /*
  * Funzione: menu_accesso
@@ -447,6 +450,7 @@ Byte visualizza_storico(const char *email_utente, TabellaUtenti tabella_utenti,
  *    email_utente: stringa costante contenente l'email dell'utente
  *    tabella_utenti: puntatore a tabella degli utenti
  *    tabella_veicoli: puntatore a tabella dei veicoli
+ *    giornale: giornale su cui registrare le cancellazioni (può essere NULL)
  *
  * Pre-condizioni:
  *    email_utente: non deve essere NULL
@@ -461,8 +465,9 @@ Byte visualizza_storico(const char *email_utente, TabellaUtenti tabella_utenti,
  *
  * Side-effect:
  *    Modifica lo storico prenotazioni se l'utente cancella una prenotazione
+ *    e registra la cancellazione nel giornale
  *    Stampa a video l'interfaccia utente
  */
-Byte gestisci_le_mie_prenotazioni(const char *email_utente, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli);
+Byte gestisci_le_mie_prenotazioni(const char *email_utente, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale);
 
 #endif //INTERFACCIA_H
@@ -4,8 +4,9 @@
 #include "modelli/byte.h"
 
 typedef struct veicolo *Veicolo;
-typedef struct tabella_hash *TabellaVeicoli;
+typedef struct tabella_veicoli *TabellaVeicoli;
 typedef struct tabella_hash *TabellaUtenti;
+typedef struct giornale *Giornale;
 
 /*
  * Autore: Marco Visone
@@ -99,6 +100,7 @@ Veicolo interfaccia_aggiungi_veicolo(TabellaVeicoli tabella_veicoli);
  *
  * Parametri:
  *    - tabella_veicoli: la tabella veicoli
+ *    - giornale: giornale su cui registrare la rimozione (può essere NULL)
  *
  * Pre-condizioni:
  *    tabella_veicoli: non deve essere NULL
@@ -113,8 +115,9 @@ Veicolo interfaccia_aggiungi_veicolo(TabellaVeicoli tabella_veicoli);
  * Side-effects:
  *    - Input/output su console
  *    - Allocazione e deallocazione dinamica della memoria
- *    - Il veicolo selezionato, se presente e confermato, viene rimosso dalla tabella.
+ *    - Il veicolo selezionato, se presente e confermato, viene rimosso dalla tabella
+ *    e la rimozione viene registrata nel giornale.
  */
-Byte interfaccia_rimuovi_veicolo(TabellaVeicoli tabella_veicoli);
+Byte interfaccia_rimuovi_veicolo(TabellaVeicoli tabella_veicoli, Giornale giornale);
 
 #endif //INTERFACCIA_AMMINISTRATORE_H
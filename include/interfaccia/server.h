@@ -0,0 +1,52 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "modelli/byte.h"
+#include "strutture_dati/tabella_utenti.h"
+#include "strutture_dati/tabella_veicoli.h"
+#include "utils/giornale.h"
+
+/*
+ * Server su socket di dominio Unix: i client si collegano al percorso dato e inviano
+ * righe del protocollo descritto in comandi.h, ricevendo gli stessi esiti della modalità
+ * batch. Tutti i client lavorano sulle stesse tabelle caricate; ogni connessione ha la
+ * propria sessione (`accedi`/`esci`). Disponibile solo su Linux (epoll).
+ */
+
+// Chiamata dopo ogni comando, ad esempio per compattare l'archivio
+typedef void (*ManutenzioneServer)(Giornale giornale, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli);
+
+/*
+ * Funzione: esegui_server
+ * -----------------------
+ *
+ * Accetta connessioni sul socket `percorso` ed esegue i comandi dei client finché
+ * il processo non riceve SIGINT o SIGTERM
+ *
+ * Parametri:
+ *    percorso: percorso del socket da creare
+ *    tabella_utenti: tabella hash degli utenti
+ *    tabella_veicoli: tabella hash dei veicoli
+ *    giornale: giornale su cui registrare le modifiche (può essere NULL)
+ *    manutenzione: funzione chiamata dopo ogni comando (può essere NULL)
+ *
+ * Pre-condizioni:
+ *    percorso: non deve essere NULL
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce 1 se il server è stato fermato da un segnale, 0 se non è stato
+ *    possibile avviarlo
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    crea e rimuove il file del socket, modifica le tabelle e il giornale,
+ *    scrive su stderr il riepilogo delle connessioni e dei comandi
+ */
+Byte esegui_server(const char *percorso, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale,
+                   ManutenzioneServer manutenzione);
+
+#endif // SERVER_H
@@ -57,7 +57,8 @@ void distruggi_data(Data data);
 /*
  * Funzione: ottieni_storico_lista
  * -------------------------------
- * Restituisce una copia dello storico delle prenotazioni associato a un utente.
+ * Restituisce una lista con le prenotazioni dello storico associato a un utente.
+ * Le prenotazioni non vengono copiate: la lista ne tiene riferimenti condivisi.
  *
  * Parametri:
  *    data: struttura `Data` contenente lo storico.
@@ -66,20 +67,46 @@ void distruggi_data(Data data);
  *    data: non deve essere NULL
  *
  * Post-condizioni:
- *    restituisce una copia della lista delle prenotazioni originale, oppure NULL in caso di errore
+ *    restituisce una lista con le prenotazioni dello storico, nello stesso ordine, oppure
+ *    NULL se lo storico è vuoto o in caso di errore
  *
  * Ritorna:
  *    puntatore ad una lista o NULL
  *
  * Side-effect:
- *    - Alloca memoria per la copia della lista.
+ *    - Alloca memoria per i nodi della lista, da liberare con `distruggi_lista_prenotazione`
+ *    (che rilascia anche i riferimenti alle prenotazioni).
  */
 ListaPre ottieni_storico_lista(Data data);
 
+/*
+ * Funzione: visita_storico_lista
+ * ------------------------------
+ * Chiama `visita` su ogni prenotazione dello storico, nell'ordine della lista,
+ * senza copiarle.
+ *
+ * Parametri:
+ *    data: struttura `Data` contenente lo storico.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    data: può essere NULL (nessuna operazione)
+ *    visita: non deve essere NULL
+ *    `visita` non deve modificare lo storico.
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    Nessuna allocazione di memoria; gli effetti sono quelli di `visita`.
+ */
+void visita_storico_lista(Data data, void (*visita)(const Prenotazione p, void *contesto), void *contesto);
+
 /*
  * Funzione: aggiungi_a_storico_lista
  * ----------------------------------
- * Aggiunge una prenotazione allo storico dell'utente.
+ * Aggiunge una prenotazione allo storico dell'utente, condividendola senza copiarla.
  *
  * Parametri:
  *    data: puntatore alla struttura `Data`.
@@ -87,24 +114,27 @@ ListaPre ottieni_storico_lista(Data data);
  *
  * Pre-condizioni:
  *    data: non deve essere NULL
- *    prenotazione: non deve essere NULL
+ *    prenotazione: non deve essere NULL e non deve appartenere già a uno storico
  *
  * Post-condizioni:
  *    - 1 se l'inserimento è avvenuto con successo.
- *    - 0 in caso di errore (puntatori NULL o fallimento nell'aggiunta alla lista).
+ *    - 0 in caso di errore (puntatori NULL o prenotazione già in uno storico).
+ *    Il chiamante mantiene il proprio riferimento alla prenotazione.
  *
  * Ritorna:
  *    un valore di tipo Byte(0 o 1)
  *
  * Side-effect:
- *    modifica la lista `storico`
+ *    modifica la lista `storico` e i collegamenti della prenotazione
  */
 Byte aggiungi_a_storico_lista(Data data, Prenotazione prenotazione);
 
 /*
  * Funzione: rimuovi_da_storico_lista
  * ----------------------------------
- * Rimuove una prenotazione dallo storico dell'utente.
+ * Rimuove una prenotazione dallo storico dell'utente. Una prenotazione dello storico
+ * (ad esempio ottenuta da `ottieni_storico_lista`) viene staccata in tempo costante;
+ * una prenotazione creata altrove viene cercata per intervallo.
  *
  * Parametri:
  *    data: struttura `Data` da cui rimuovere.
@@ -112,7 +142,7 @@ Byte aggiungi_a_storico_lista(Data data, Prenotazione prenotazione);
  *
  * Pre-condizioni:
  *    data: non deve essere NULL
- *    prenotazione: non deve essere NULL
+ *    prenotazione: non deve essere NULL e non deve appartenere allo storico di un altro utente
  *
  * Post-condizioni:
  *    restituisce 1 se la prenotazione è stata rimossa, altrimenti 0
@@ -121,7 +151,7 @@ Byte aggiungi_a_storico_lista(Data data, Prenotazione prenotazione);
  *    un valore di tipo Byte(0 o 1)
  *
  * Side-effect:
- *    modifica la lista
+ *    modifica la lista; la prenotazione viene liberata se nessun'altra vista la usa
  */
 Byte rimuovi_da_storico_lista(Data data, Prenotazione prenotazione);
 
@@ -147,44 +177,4 @@ Byte rimuovi_da_storico_lista(Data data, Prenotazione prenotazione);
  */
 unsigned int ottieni_numero_prenotazioni(Data data);
 
-/*
- * Funzione: imposta_numero_prenotazioni
- * -------------------------------------
- * Imposta manualmente il numero di prenotazioni in una struttura `Data`.
- *
- * Parametri:
- *    data: struttura `Data` da modificare.
- *    numero_prenotazioni: valore da impostare.
- *
- * Pre-condizioni:
- *    data: non deve essere NULL
- *
- * Post-condizioni:
- *    non restituisce niente
- *
- * Side-effect:
- *    Il campo `numero_prenotazioni` viene aggiornato.
- */
-void imposta_numero_prenotazioni(Data data, int numero_prenotazioni);
-
-/*
- * Funzione: imposta_storico_lista
- * -------------------------------
- * Imposta direttamente la lista dello storico in una struttura `Data`.
- *
- * Parametri:
- *    data: struttura `Data` da modificare.
- *    lista_prenotazione: lista da assegnare al campo `storico`.
- *
- * Pre-condizioni:
- *    data: non deve essere NULL
- *
- * Post-condizioni:
- *    non restituisce niente
- *
- * Side-effect:
- *    Il campo `storico` della struttura viene aggiornato.
- */
-void imposta_storico_lista(Data data, ListaPre lista_prenotazione);
-
 #endif // DATA_H
@@ -8,6 +8,7 @@
 
 #include <time.h>
 #include "modelli/byte.h"
+#include "strutture_dati/pool.h"
 
 typedef struct intervallo* Intervallo;
 
@@ -33,7 +34,7 @@ typedef struct intervallo* Intervallo;
  *    un nuovo intervallo o NULL
  *
  * Side-effect:
- *    Alloca memoria per la struttura intervallo
+ *    Preleva memoria per la struttura intervallo da un pool condiviso
  */
 Intervallo crea_intervallo(time_t inizio, time_t fine);
 
@@ -52,7 +53,7 @@ Intervallo crea_intervallo(time_t inizio, time_t fine);
  *    non restituisce niente
  *
  * Side-effect:
- *    Dealloca memoria se i non è NULL
+ *    Restituisce l'intervallo al pool condiviso se i non è NULL
  */
 void distruggi_intervallo(Intervallo i);
 
@@ -135,7 +136,7 @@ Byte intervalli_si_sovrappongono(Intervallo interno, Intervallo esterno);
  *    un nuovo intervallo o NULL
  *
  * Side-effect:
- *    Alloca memoria per la struttura intervallo
+ *    Preleva memoria per la struttura intervallo da un pool condiviso
  */
 Intervallo converti_data_in_intervallo(const char *inizio, const char *fine);
 
@@ -209,4 +210,23 @@ Byte compara_intervalli(Intervallo a, Intervallo b);
  */
 char *intervallo_in_stringa(Intervallo i);
 
+/*
+ * Funzione: ottieni_statistiche_pool_intervallo
+ * ---------------------------------------------
+ * Restituisce i contatori del pool condiviso da cui vengono prelevati gli intervalli.
+ *
+ * Parametri:
+ *    Nessuno
+ *
+ * Pre-condizioni:
+ *    Nessuna
+ *
+ * Post-condizioni:
+ *    restituisce le statistiche del pool degli intervalli
+ *
+ * Ritorna:
+ *    una struttura StatistichePool
+ */
+StatistichePool ottieni_statistiche_pool_intervallo(void);
+
 #endif // INTERVALLO_H
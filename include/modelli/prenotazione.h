@@ -6,6 +6,10 @@
 #ifndef PRENOTAZIONE_H
 #define PRENOTAZIONE_H
 
+#include <stdint.h>
+#include "modelli/byte.h"
+#include "strutture_dati/pool.h"
+
 /*
  * tipo opaco per la gestione di un intervallo temporale.
  */
@@ -41,14 +45,44 @@ typedef struct prenotazione *Prenotazione;
  *    un puntatore a prenotazione o NULL
  *
  * Side-effect:
- *    - Alloca memoria dinamica per la struttura 'Prenotazione' e per le stringhe 'cliente' e 'targa'.
+ *    - Preleva la struttura 'Prenotazione' da un pool condiviso; i clienti più lunghi
+ *    del buffer interno vengono copiati in memoria dinamica.
+ *    - Assegna alla prenotazione un nuovo identificativo e la registra nell'indice
+ *    globale usato da `cerca_prenotazione_per_id`.
  */
 Prenotazione crea_prenotazione(const char *cliente, const char *targa, Intervallo i, double costo);
 
+/*
+ * Funzione: crea_prenotazione_con_id
+ * ----------------------------------
+ * Crea una prenotazione con un identificativo già noto, come quello letto da un archivio
+ * o dal giornale. Se una prenotazione con lo stesso identificativo e gli stessi dati è
+ * ancora viva ne restituisce un nuovo riferimento; se l'identificativo è usato da una
+ * prenotazione con dati diversi, ne assegna uno nuovo.
+ *
+ * Parametri:
+ *    id: l'identificativo, 0 per assegnarne uno nuovo.
+ *    cliente, targa, i, costo: come in `crea_prenotazione`.
+ *
+ * Pre-condizioni:
+ *    come in `crea_prenotazione`
+ *
+ * Post-condizioni:
+ *    restituisce la prenotazione con identificativo `id` (o con uno nuovo, se `id` è
+ *    già usato da una prenotazione diversa), o NULL in caso di errore di allocazione
+ *
+ * Ritorna:
+ *    un puntatore a prenotazione o NULL
+ *
+ * Side-effect:
+ *    come `crea_prenotazione`; gli identificativi assegnati in seguito saranno maggiori di `id`
+ */
+Prenotazione crea_prenotazione_con_id(uint64_t id, const char *cliente, const char *targa, Intervallo i, double costo);
+
 /*
  * Funzione: distruggi_prenotazione
  * -------------------------------
- * Libera la memoria allocata per una data prenotazione.
+ * Rilascia un riferimento alla prenotazione e, se era l'ultimo, libera la memoria.
  *
  * Parametri:
  *    p: puntatore alla prenotazione da distruggere.
@@ -60,8 +94,8 @@ Prenotazione crea_prenotazione(const char *cliente, const char *targa, Intervall
  *    non restituisce niente
  *
  * Side-effect:
- *    - La memoria associata alla prenotazione 'p' (inclusi i campi interni 'cliente', 'targa' e 'intervallo')
- *    viene deallocata.
+ *    - Al rilascio dell'ultimo riferimento, la memoria associata alla prenotazione 'p'
+ *    (inclusi i campi interni 'cliente', 'targa' e 'intervallo') viene deallocata.
  *    - Se 'p' è NULL, la funzione non ha alcun effetto.
  */
 void distruggi_prenotazione(Prenotazione p);
@@ -177,8 +211,8 @@ double ottieni_costo_prenotazione(Prenotazione p);
  * Side-effect:
  *    - Il nome del cliente nella prenotazione 'p' viene aggiornato con la nuova stringa 'cliente'.
  *    - Se 'p' è NULL, la funzione non ha alcun effetto.
- *    - Dealloca la memoria precedentemente allocata per il vecchio nome del cliente.
- *    - Alloca nuova memoria dinamica per duplicare la stringa 'cliente'.
+ *    - Dealloca l'eventuale copia dinamica del vecchio nome del cliente.
+ *    - Alloca memoria dinamica solo se la stringa 'cliente' non entra nel buffer interno.
  *    - Modifica la memoria interna della struttura 'Prenotazione'.
  */
 void imposta_cliente_prenotazione(Prenotazione p, const char *cliente);
@@ -202,8 +236,7 @@ void imposta_cliente_prenotazione(Prenotazione p, const char *cliente);
  * Side-effect:
  *    - La targa del veicolo nella prenotazione 'p' viene aggiornata con la nuova stringa 'targa'.
  *    - Se 'p' è NULL, la funzione non ha alcun effetto.
- *    - Dealloca la memoria precedentemente allocata per la vecchia targa del veicolo.
- *    - Alloca nuova memoria dinamica per duplicare la stringa 'targa'.
+ *    - La targa viene copiata nel campo a dimensione fissa della prenotazione.
  *    - Modifica la memoria interna della struttura 'Prenotazione'.
  */
 void imposta_veicolo_prenotazione(Prenotazione p, const char *targa);
@@ -275,9 +308,228 @@ void imposta_costo_prenotazione(Prenotazione p, double costo);
  *
  * Side-effect:
  *    - Alloca nuova memoria dinamica per la prenotazione duplicata e per le sue stringhe e l'intervallo.
+ *    - La copia riceve un nuovo identificativo.
  */
 Prenotazione duplica_prenotazione(Prenotazione p);
 
+/*
+ * Funzione: condividi_prenotazione
+ * --------------------------------
+ * Restituisce un nuovo riferimento alla stessa prenotazione, senza copiarla.
+ * L'albero del veicolo e lo storico del cliente condividono così un'unica prenotazione.
+ *
+ * Parametri:
+ *    p: la prenotazione da condividere.
+ *
+ * Pre-condizioni:
+ *    p: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce `p`; il nuovo riferimento va rilasciato con `distruggi_prenotazione`
+ *
+ * Ritorna:
+ *    un puntatore a prenotazione o NULL se 'p' è NULL
+ *
+ * Side-effect:
+ *    incrementa il contatore dei riferimenti di 'p'
+ */
+Prenotazione condividi_prenotazione(Prenotazione p);
+
+/*
+ * Funzione: ottieni_precedente_storico
+ * ------------------------------------
+ * Restituisce la prenotazione che precede 'p' nello storico del cliente.
+ *
+ * Parametri:
+ *    p: la prenotazione.
+ *
+ * Pre-condizioni:
+ *    p: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce la precedente, NULL se 'p' è in testa, fuori da uno storico o NULL
+ *
+ * Ritorna:
+ *    un puntatore a prenotazione o NULL
+ *
+ * Side-effect:
+ *    nessuno
+ */
+Prenotazione ottieni_precedente_storico(const Prenotazione p);
+
+/*
+ * Funzione: ottieni_successiva_storico
+ * ------------------------------------
+ * Restituisce la prenotazione che segue 'p' nello storico del cliente.
+ *
+ * Parametri:
+ *    p: la prenotazione.
+ *
+ * Pre-condizioni:
+ *    p: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce la successiva, NULL se 'p' è in coda, fuori da uno storico o NULL
+ *
+ * Ritorna:
+ *    un puntatore a prenotazione o NULL
+ *
+ * Side-effect:
+ *    nessuno
+ */
+Prenotazione ottieni_successiva_storico(const Prenotazione p);
+
+/*
+ * Funzione: imposta_vicine_storico
+ * --------------------------------
+ * Collega 'p' alle prenotazioni che la precedono e la seguono nello storico del cliente.
+ * Usata dal modulo `data`, che mantiene lo storico come lista doppia.
+ *
+ * Parametri:
+ *    p: la prenotazione da collegare.
+ *    precedente: la prenotazione precedente, NULL se 'p' è in testa.
+ *    successiva: la prenotazione successiva, NULL se 'p' è in coda.
+ *
+ * Pre-condizioni:
+ *    p: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    modifica i collegamenti di 'p'
+ */
+void imposta_vicine_storico(Prenotazione p, Prenotazione precedente, Prenotazione successiva);
+
+/*
+ * Funzione: scollega_da_storico
+ * -----------------------------
+ * Azzera i collegamenti di 'p' e la segna come non appartenente ad alcuno storico.
+ * Usata dal modulo `data` quando stacca una prenotazione.
+ *
+ * Parametri:
+ *    p: la prenotazione da scollegare.
+ *
+ * Pre-condizioni:
+ *    p: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    modifica i collegamenti di 'p'
+ */
+void scollega_da_storico(Prenotazione p);
+
+/*
+ * Funzione: appartiene_a_storico
+ * ------------------------------
+ * Indica se 'p' è collegata allo storico di un cliente.
+ *
+ * Parametri:
+ *    p: la prenotazione.
+ *
+ * Pre-condizioni:
+ *    p: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se 'p' appartiene a uno storico, 0 altrimenti o se 'p' è NULL
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(0 o 1)
+ *
+ * Side-effect:
+ *    nessuno
+ */
+Byte appartiene_a_storico(const Prenotazione p);
+
+/*
+ * Funzione: ottieni_id_prenotazione
+ * ---------------------------------
+ * Restituisce l'identificativo a 64 bit assegnato alla prenotazione alla creazione.
+ *
+ * Parametri:
+ *    p: la prenotazione.
+ *
+ * Pre-condizioni:
+ *    p: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce l'identificativo, 0 se 'p' è NULL
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit, maggiore di 0 per ogni prenotazione
+ *
+ * Side-effect:
+ *    nessuno
+ */
+uint64_t ottieni_id_prenotazione(const Prenotazione p);
+
+/*
+ * Funzione: cerca_prenotazione_per_id
+ * -----------------------------------
+ * Cerca tra le prenotazioni vive quella con l'identificativo dato, in tempo costante
+ * medio. Le prenotazioni di un archivio non ancora costruite (caricamento pigro) non
+ * vengono trovate.
+ *
+ * Parametri:
+ *    id: l'identificativo cercato.
+ *
+ * Pre-condizioni:
+ *    nessuna
+ *
+ * Post-condizioni:
+ *    restituisce la prenotazione, NULL se nessuna prenotazione viva ha quell'identificativo
+ *
+ * Ritorna:
+ *    un puntatore a prenotazione o NULL. Il riferimento non viene incrementato.
+ *
+ * Side-effect:
+ *    nessuno
+ */
+Prenotazione cerca_prenotazione_per_id(uint64_t id);
+
+/*
+ * Funzione: riserva_id_prenotazioni
+ * ---------------------------------
+ * Garantisce che i prossimi identificativi assegnati siano maggiori di `id`.
+ *
+ * Parametri:
+ *    id: l'identificativo più alto già usato, ad esempio quello salvato in un archivio.
+ *
+ * Pre-condizioni:
+ *    nessuna
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    modifica il contatore globale degli identificativi
+ */
+void riserva_id_prenotazioni(uint64_t id);
+
+/*
+ * Funzione: ottieni_ultimo_id_prenotazione
+ * ----------------------------------------
+ * Restituisce l'identificativo più alto assegnato o riservato finora.
+ *
+ * Parametri:
+ *    Nessuno
+ *
+ * Pre-condizioni:
+ *    Nessuna
+ *
+ * Post-condizioni:
+ *    restituisce l'ultimo identificativo, 0 se non ne è stato assegnato nessuno
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit
+ *
+ * Side-effect:
+ *    nessuno
+ */
+uint64_t ottieni_ultimo_id_prenotazione(void);
+
 /*
  * Funzione: prenotazione_in_stringa
  * --------------------------------
@@ -302,4 +554,24 @@ Prenotazione duplica_prenotazione(Prenotazione p);
  */
 char* prenotazione_in_stringa(Prenotazione p);
 
+/*
+ * Funzione: ottieni_statistiche_pool_prenotazione
+ * -----------------------------------------------
+ * Restituisce i contatori del pool condiviso da cui vengono prelevate le prenotazioni,
+ * utile per misurare quante chiamate all'allocatore vengono effettivamente eseguite.
+ *
+ * Parametri:
+ *    Nessuno
+ *
+ * Pre-condizioni:
+ *    Nessuna
+ *
+ * Post-condizioni:
+ *    restituisce le statistiche del pool delle prenotazioni
+ *
+ * Ritorna:
+ *    una struttura StatistichePool
+ */
+StatistichePool ottieni_statistiche_pool_prenotazione(void);
+
 #endif // PRENOTAZIONE_H
@@ -20,6 +20,23 @@
 
 typedef struct utente *Utente;
 
+/*
+ * Definizione: SorgenteStorico
+ * ----------------------------
+ * Origine condivisa da cui più clienti costruiscono il proprio storico al primo
+ * accesso, invece che al caricamento.
+ *
+ *    carica: costruisce lo storico dai record [prima, prima + num) della sorgente
+ *    rilascia: libera la sorgente quando nessun utente vi fa più riferimento
+ *    riferimenti: numero di utenti il cui storico non è ancora stato costruito
+ */
+typedef struct sorgente_storico SorgenteStorico;
+struct sorgente_storico {
+    Data (*carica)(SorgenteStorico *sorgente, unsigned int prima, unsigned int num);
+    void (*rilascia)(SorgenteStorico *sorgente);
+    unsigned int riferimenti;
+};
+
 /*
  * Funzione: crea_utente
  * ---------------------
@@ -49,6 +66,55 @@ typedef struct utente *Utente;
  */
 Utente crea_utente(const char *email, const uint8_t *password, const char *nome, const char *cognome, Byte permesso);
 
+/*
+ * Funzione: crea_cliente_differito
+ * --------------------------------
+ * Crea un nuovo cliente il cui storico verrà costruito dalla sorgente al primo accesso.
+ *
+ * Parametri:
+ *    email, password, nome, cognome: come in `crea_utente`
+ *    sorgente: la sorgente da cui costruire lo storico
+ *    prima: indice del primo record della sorgente che appartiene al cliente
+ *    num: numero di record che appartengono al cliente
+ *
+ * Pre-condizioni:
+ *    come in `crea_utente`
+ *    sorgente: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce un nuovo utente con permesso CLIENTE, in caso di errore restituisce NULL.
+ *    `ottieni_numero_prenotazioni_utente` restituisce `num` senza costruire lo storico
+ *
+ * Ritorna:
+ *    un puntatore a utente o NULL
+ *
+ * Side-effect:
+ *    alloca memoria dinamica per l'utente e incrementa i riferimenti della sorgente
+ */
+Utente crea_cliente_differito(const char *email, const uint8_t *password, const char *nome, const char *cognome,
+                              SorgenteStorico *sorgente, unsigned int prima, unsigned int num);
+
+/*
+ * Funzione: ottieni_storico_differito
+ * -----------------------------------
+ * Indica se lo storico dell'utente non è ancora stato costruito e, in quel caso,
+ * da quali record della sorgente verrà costruito.
+ *
+ * Parametri:
+ *    utente: puntatore all'oggetto `Utente`.
+ *    sorgente, prima, num: puntatori in cui salvare sorgente e record
+ *
+ * Pre-condizioni:
+ *    utente, sorgente, prima, num: non devono essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 e imposta i parametri se lo storico è ancora nella sorgente, 0 altrimenti
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(0 o 1)
+ */
+Byte ottieni_storico_differito(const Utente utente, SorgenteStorico **sorgente, unsigned int *prima, unsigned int *num);
+
 /*
  * Funzione: distruggi_utente
  * --------------------------
@@ -313,16 +379,41 @@ Byte ottieni_permesso(Utente utente);
  *
  * Post-condizioni:
  *    restituisce la lista delle prenotazioni, oppure NULL se `utente` è NULL.
+ *    Al primo accesso lo storico viene costruito dalla sorgente.
  *
  * Ritorna:
  *    una lista o NULL
  */
 ListaPre ottieni_storico_utente(Utente utente);
 
+/*
+ * Funzione: visita_storico_utente
+ * -------------------------------
+ * Chiama `visita` su ogni prenotazione dello storico di un utente, senza copiarle.
+ *
+ * Parametri:
+ *    utente: puntatore all'oggetto `Utente`.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    utente: può essere NULL (nessuna operazione)
+ *    visita: non deve essere NULL
+ *    `visita` non deve modificare lo storico.
+ *
+ * Post-condizioni:
+ *    non restituisce niente. Al primo accesso lo storico viene costruito dalla sorgente.
+ *
+ * Side-effect:
+ *    gli effetti sono quelli di `visita`
+ */
+void visita_storico_utente(Utente utente, void (*visita)(const Prenotazione p, void *contesto), void *contesto);
+
 /*
  * Funzione: aggiungi_a_storico_utente
  * -----------------------------------
- * Aggiunge una prenotazione allo storico di un utente.
+ * Aggiunge una prenotazione allo storico di un utente. Lo storico ne tiene un
+ * riferimento condiviso (non una copia): il chiamante mantiene il proprio.
  *
  * Parametri:
  *    utente: puntatore all'oggetto `Utente`.
@@ -346,8 +437,8 @@ Byte aggiungi_a_storico_utente(Utente utente, Prenotazione prenotazione);
 /*
  * Funzione: rimuovi_da_storico_utente
  * -----------------------------------
- * Rimuove una prenotazione dallo storico di un utente.
- * Se lo storico risulta vuoto dopo la rimozione, imposta lo storico a NULL.
+ * Rimuove una prenotazione dallo storico di un utente, in tempo costante se
+ * `prenotazione` proviene dal suo storico.
  *
 * Parametri:
  *    utente: puntatore all'oggetto `Utente`.
@@ -380,7 +471,8 @@ Byte rimuovi_da_storico_utente(Utente utente, Prenotazione prenotazione);
  *    u: non deve essere NULL
  *
  * Post-condizioni:
- *    restituisce il numero di prenotazioni oppure 0 se c'è un errore
+ *    restituisce il numero di prenotazioni oppure 0 se c'è un errore; non
+ *    costruisce lo storico se non è ancora stato costruito
  *
  * Ritorna:
  *    un numero intero positivo
@@ -5,6 +5,7 @@
 
 #ifndef VEICOLO_H
 #define VEICOLO_H
+#include <time.h>
 #include "modelli/byte.h"
 
 #define NUM_CARATTERI_TARGA 7 + 2
@@ -18,6 +19,46 @@ typedef struct prenotazione *Prenotazione;
 typedef struct albero *Prenotazioni;
 typedef struct veicolo *Veicolo;
 
+/*
+ * Definizione: VisitatoreIntervalli
+ * ---------------------------------
+ * Funzione chiamata da `visita_intervalli_veicolo` per ogni prenotazione visitata.
+ *
+ *    inizio, fine: gli estremi della prenotazione
+ *    contesto: il puntatore passato alla funzione di visita
+ */
+typedef void (*VisitatoreIntervalli)(time_t inizio, time_t fine, void *contesto);
+
+/*
+ * Definizione: OsservatoreVeicolo
+ * -------------------------------
+ * Funzione avvisata dopo ogni prenotazione aggiunta o rimossa dal veicolo, con la
+ * stessa firma di `OsservatorePrenotazioni` (strutture_dati/prenotazioni.h).
+ */
+typedef void (*OsservatoreVeicolo)(time_t inizio, time_t fine, Byte aggiunta, void *contesto);
+
+/*
+ * Definizione: SorgentePrenotazioni
+ * ---------------------------------
+ * Origine condivisa da cui più veicoli costruiscono le proprie prenotazioni al
+ * primo accesso, invece che al caricamento.
+ *
+ *    carica: costruisce le prenotazioni dei record [prima, prima + num) della sorgente
+ *    visita: passa al visitatore, in ordine di inizio, gli estremi delle prenotazioni
+ *    dei record [prima, prima + num) che si sovrappongono a [da, a), senza costruirle;
+ *    restituisce 0 se i record non sono validi
+ *    rilascia: libera la sorgente quando nessun veicolo vi fa più riferimento
+ *    riferimenti: numero di veicoli le cui prenotazioni non sono ancora state costruite
+ */
+typedef struct sorgente_prenotazioni SorgentePrenotazioni;
+struct sorgente_prenotazioni {
+    Prenotazioni (*carica)(SorgentePrenotazioni *sorgente, unsigned int prima, unsigned int num);
+    Byte (*visita)(SorgentePrenotazioni *sorgente, unsigned int prima, unsigned int num, time_t da, time_t a,
+                   VisitatoreIntervalli visitatore, void *contesto);
+    void (*rilascia)(SorgentePrenotazioni *sorgente);
+    unsigned int riferimenti;
+};
+
 /*
  * Funzione: crea_veicolo
  * ----------------------
@@ -50,6 +91,102 @@ typedef struct veicolo *Veicolo;
  */
 Veicolo crea_veicolo(const char *tipo, const char *targa, const char *modello, const char *posizione, double tariffa, Prenotazioni prenotazioni);
 
+/*
+ * Funzione: crea_veicolo_differito
+ * --------------------------------
+ * Crea un nuovo veicolo le cui prenotazioni verranno costruite dalla sorgente
+ * al primo accesso
+ *
+ * Parametri:
+ *    tipo, targa, modello, posizione, tariffa: come in `crea_veicolo`
+ *    sorgente: la sorgente da cui costruire le prenotazioni
+ *    prima: indice del primo record della sorgente che appartiene al veicolo
+ *    num: numero di record che appartengono al veicolo
+ *
+ * Pre-condizioni:
+ *    come in `crea_veicolo`
+ *    sorgente: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce un nuovo oggetto Veicolo se l'allocazione è andata a buon fine,
+ *    altrimenti restituisce NULL
+ *
+ * Ritorna:
+ *    Un oggetto di tipo Veicolo oppure NULL
+ *
+ * Side-effect:
+ *    alloca memoria dinamicamente per il veicolo e incrementa i riferimenti della sorgente
+ */
+Veicolo crea_veicolo_differito(const char *tipo, const char *targa, const char *modello, const char *posizione, double tariffa,
+                               SorgentePrenotazioni *sorgente, unsigned int prima, unsigned int num);
+
+/*
+ * Funzione: ottieni_prenotazioni_differite
+ * ----------------------------------------
+ * Indica se le prenotazioni del veicolo non sono ancora state costruite e, in
+ * quel caso, da quali record della sorgente verranno costruite
+ *
+ * Parametri:
+ *    v: puntatore ad un veicolo
+ *    sorgente, prima, num: puntatori in cui salvare sorgente e record
+ *
+ * Pre-condizioni:
+ *    v, sorgente, prima, num: non devono essere NULL
+ *
+ * Post-condizione:
+ *    restituisce 1 e imposta i parametri se le prenotazioni sono ancora nella
+ *    sorgente, 0 altrimenti
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ */
+Byte ottieni_prenotazioni_differite(const Veicolo v, SorgentePrenotazioni **sorgente, unsigned int *prima, unsigned int *num);
+
+/*
+ * Funzione: visita_intervalli_veicolo
+ * -----------------------------------
+ * Visita gli estremi delle prenotazioni del veicolo che si sovrappongono a [da, a),
+ * senza costruire le prenotazioni se sono ancora nella sorgente
+ *
+ * Parametri:
+ *    v: puntatore ad un veicolo
+ *    da, a: estremi dell'intervallo da visitare
+ *    visitatore: funzione chiamata per ogni prenotazione
+ *    contesto: puntatore passato al visitatore
+ *
+ * Pre-condizioni:
+ *    v, visitatore: non devono essere NULL
+ *
+ * Post-condizione:
+ *    restituisce 1 se la visita è stata completata, 0 se la sorgente non è valida
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ */
+Byte visita_intervalli_veicolo(const Veicolo v, time_t da, time_t a, VisitatoreIntervalli visitatore, void *contesto);
+
+/*
+ * Funzione: imposta_osservatore_veicolo
+ * -------------------------------------
+ * Registra la funzione da avvisare dopo ogni inserimento o cancellazione di una
+ * prenotazione del veicolo, anche se le prenotazioni non sono ancora state costruite
+ *
+ * Parametri:
+ *    v: puntatore ad un veicolo
+ *    osserva: la funzione da chiamare, NULL per rimuovere l'osservatore
+ *    contesto: puntatore passato a `osserva`
+ *
+ * Pre-condizioni:
+ *    v: non deve essere NULL
+ *
+ * Post-condizione:
+ *    non restituisce niente; un eventuale osservatore precedente viene sostituito
+ *
+ * Side-effect:
+ *    l'osservatore viene passato alle prenotazioni del veicolo quando vengono costruite
+ */
+void imposta_osservatore_veicolo(Veicolo v, OsservatoreVeicolo osserva, void *contesto);
+
 /*
  * Funzione: distruggi_veicolo
  * ---------------------------
@@ -250,7 +387,8 @@ void imposta_tariffa(const Veicolo v, double tariffa);
  *    v: non deve essere NULL
  *
  * Post-condizione:
- *    restituisce le prenotazioni del veicolo
+ *    restituisce le prenotazioni del veicolo, costruendole dalla sorgente al
+ *    primo accesso; NULL se la costruzione fallisce
  *
  * Ritorna:
  *    un albero AVL
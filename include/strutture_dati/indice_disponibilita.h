@@ -0,0 +1,183 @@
+#ifndef INDICE_DISPONIBILITA_H
+#define INDICE_DISPONIBILITA_H
+
+#include "modelli/byte.h"
+
+/*
+ * Tipo opaco per l'indice di disponibilità della flotta.
+ * Il tempo è diviso in fasce di durata fissa; per ogni fascia che contiene
+ * almeno una prenotazione l'indice conserva l'insieme dei veicoli occupati
+ * come vettore di bit, un bit per veicolo. Chiedere quali veicoli sono liberi
+ * in un intervallo costa quindi qualche OR tra vettori di bit, invece di una
+ * ricerca nell'albero delle prenotazioni di ogni veicolo.
+ * Sono indicizzati solo i prossimi giorni, a partire dalla mezzanotte UTC di oggi:
+ * per gli intervalli che escono da questo orizzonte la risposta viene chiesta
+ * alle prenotazioni dei veicoli.
+ */
+typedef struct indice_disponibilita *IndiceDisponibilita;
+typedef struct intervallo *Intervallo;
+typedef struct veicolo *Veicolo;
+
+/*
+ * Funzione: crea_indice_disponibilita
+ * -----------------------------------
+ * Crea un indice vuoto e non valido: va riempito con `ricostruisci_indice_disponibilita`.
+ *
+ * Parametri:
+ *    Nessuno
+ *
+ * Pre-condizioni:
+ *    Nessuna
+ *
+ * Post-condizioni:
+ *    restituisce un nuovo indice, oppure NULL in caso di errore di allocazione
+ *
+ * Ritorna:
+ *    un oggetto IndiceDisponibilita o NULL
+ *
+ * Side-effect:
+ *    alloca memoria dinamicamente; va liberata con `distruggi_indice_disponibilita`
+ */
+IndiceDisponibilita crea_indice_disponibilita(void);
+
+/*
+ * Funzione: distruggi_indice_disponibilita
+ * ----------------------------------------
+ * Libera la memoria dell'indice. I veicoli non vengono toccati.
+ *
+ * Parametri:
+ *    indice: l'indice da distruggere
+ *
+ * Pre-condizioni:
+ *    indice: può essere NULL (nessuna operazione)
+ *    i veicoli indicizzati devono essere già stati distrutti, oppure non devono
+ *    più ricevere prenotazioni: i loro osservatori puntano ancora all'indice
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    libera la memoria dell'indice e delle sue fasce
+ */
+void distruggi_indice_disponibilita(IndiceDisponibilita indice);
+
+/*
+ * Funzione: ricostruisci_indice_disponibilita
+ * -------------------------------------------
+ * Ricostruisce l'indice a partire dalle prenotazioni dei veicoli forniti e
+ * si registra come osservatore dei veicoli, così da restare aggiornato a ogni
+ * `aggiungi_prenotazione` e `cancella_prenotazione` successive. Le prenotazioni
+ * dei veicoli non ancora costruite non vengono costruite.
+ *
+ * Parametri:
+ *    indice: l'indice da ricostruire
+ *    veicoli: i veicoli della flotta, nell'ordine in cui verranno restituiti
+ *    n: numero di veicoli
+ *
+ * Pre-condizioni:
+ *    indice: non deve essere NULL
+ *    veicoli: non deve essere NULL se `n` è maggiore di 0
+ *    deve contenere tutti i veicoli ancora vivi indicizzati in precedenza
+ *
+ * Post-condizioni:
+ *    restituisce 1 e l'indice diventa valido, oppure 0 in caso di errore di
+ *    allocazione; in tal caso l'indice resta non valido e nessun veicolo lo osserva
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    sostituisce l'osservatore di ogni veicolo
+ */
+Byte ricostruisci_indice_disponibilita(IndiceDisponibilita indice, Veicolo *veicoli, unsigned int n);
+
+/*
+ * Funzione: aggiungi_a_indice_disponibilita
+ * -----------------------------------------
+ * Accoda all'indice un veicolo appena inserito nella flotta, senza ricostruirlo.
+ *
+ * Parametri:
+ *    indice: l'indice da aggiornare
+ *    veicolo: il veicolo da accodare
+ *
+ * Pre-condizioni:
+ *    indice: può essere NULL (nessuna operazione)
+ *    veicolo: non deve essere NULL né già indicizzato
+ *
+ * Post-condizioni:
+ *    non restituisce niente; se l'indice non è valido il veicolo entrerà con la
+ *    prossima ricostruzione, e in caso di errore l'indice diventa non valido
+ *
+ * Side-effect:
+ *    registra l'indice come osservatore del veicolo
+ */
+void aggiungi_a_indice_disponibilita(IndiceDisponibilita indice, Veicolo veicolo);
+
+/*
+ * Funzione: invalida_indice_disponibilita
+ * ---------------------------------------
+ * Segnala che la flotta è cambiata: l'indice va ricostruito prima del prossimo uso.
+ *
+ * Parametri:
+ *    indice: l'indice da invalidare
+ *
+ * Pre-condizioni:
+ *    indice: può essere NULL (nessuna operazione)
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    le notifiche delle prenotazioni vengono ignorate fino alla ricostruzione
+ */
+void invalida_indice_disponibilita(IndiceDisponibilita indice);
+
+/*
+ * Funzione: indice_disponibilita_valido
+ * -------------------------------------
+ * Indica se l'indice rispecchia le prenotazioni attuali della flotta.
+ *
+ * Parametri:
+ *    indice: l'indice da controllare
+ *
+ * Pre-condizioni:
+ *    indice: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se l'indice è valido, 0 se va ricostruito o è NULL
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ */
+Byte indice_disponibilita_valido(const IndiceDisponibilita indice);
+
+/*
+ * Funzione: veicoli_liberi_da_indice
+ * ----------------------------------
+ * Restituisce i veicoli senza prenotazioni che si sovrappongono all'intervallo.
+ *
+ * Parametri:
+ *    indice: l'indice da interrogare
+ *    intervallo: l'intervallo di tempo da controllare
+ *    dimensione: puntatore in cui salvare il numero di veicoli restituiti
+ *
+ * Pre-condizioni:
+ *    indice: non deve essere NULL e deve essere valido
+ *    intervallo: non deve essere NULL
+ *    dimensione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce un vettore di veicoli liberi, nell'ordine passato a
+ *    `ricostruisci_indice_disponibilita` seguito da quelli accodati; NULL se l'indice
+ *    non contiene veicoli o in caso di errore, e in tal caso l'indice può essere
+ *    diventato non valido
+ *
+ * Ritorna:
+ *    un array di veicoli o NULL
+ *
+ * Side-effect:
+ *    alloca dinamicamente un array che dovrà essere liberato dal chiamante
+ */
+Veicolo *veicoli_liberi_da_indice(IndiceDisponibilita indice, Intervallo intervallo, unsigned int *dimensione);
+
+#endif //INDICE_DISPONIBILITA_H
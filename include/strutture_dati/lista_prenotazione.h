@@ -20,8 +20,8 @@ typedef struct nodo *ListaPre;
 /*
  * Funzione: distruggi_lista_prenotazione
  * --------------------------------------
- * Libera tutta la memoria occupata da una lista di prenotazioni,
- * inclusi tutti i nodi e le prenotazioni contenute.
+ * Libera tutta la memoria occupata da una lista di prenotazioni: i nodi
+ * vengono liberati e le prenotazioni contenute rilasciate con `distruggi_prenotazione`.
  *
  * Parametri:
  *    l: lista di prenotazioni da distruggere
@@ -33,7 +33,7 @@ typedef struct nodo *ListaPre;
  *    non restituisce niente
  *
  * Side-effect:
- *    tutta la memoria della lista e delle prenotazioni viene liberata
+ *    tutta la memoria della lista e delle prenotazioni non più condivise viene liberata
  */
 void distruggi_lista_prenotazione(ListaPre l);
 
@@ -0,0 +1,131 @@
+#ifndef OCCUPAZIONE_H
+#define OCCUPAZIONE_H
+
+#include <stdint.h>
+#include <time.h>
+#include "modelli/byte.h"
+
+#define DURATA_QUARTO 900                                   // Granularità della mappa: 15 minuti
+#define GIORNI_ORIZZONTE 30                                 // Giorni coperti dalla mappa
+#define QUARTI_ORIZZONTE (GIORNI_ORIZZONTE * 24 * 4)
+#define PAROLE_OCCUPAZIONE ((QUARTI_ORIZZONTE + 63) / 64)
+
+// Esito di `esito_occupazione` quando la risposta va chiesta alle prenotazioni (OK e OCCUPATO in prenotazioni.h)
+#define INCERTO 2
+
+typedef struct albero *Prenotazioni;
+
+/*
+ * Definizione: Occupazione
+ * ------------------------
+ * Mappa di occupazione a breve termine di una struttura `Prenotazioni`.
+ * Copre GIORNI_ORIZZONTE giorni a partire da `origine`, un bit per quarto d'ora:
+ * il bit è a 1 se almeno una prenotazione si sovrappone a quel quarto d'ora.
+ * La struttura `Prenotazioni` resta l'unica fonte autorevole; la mappa serve a
+ * rispondere senza visitarla quando l'intervallo cade nell'orizzonte.
+ *
+ *    origine: inizio del primo quarto d'ora coperto (mezzanotte UTC)
+ *    quarti: i bit dei quarti d'ora
+ */
+typedef struct {
+    time_t origine;
+    uint64_t quarti[PAROLE_OCCUPAZIONE];
+} Occupazione;
+
+/*
+ * Funzione: inizializza_occupazione
+ * ---------------------------------
+ * Prepara una mappa vuota il cui orizzonte parte dalla mezzanotte UTC di `adesso`.
+ *
+ * Parametri:
+ *    occupazione: la mappa da inizializzare
+ *    adesso: l'istante corrente
+ *
+ * Pre-condizioni:
+ *    occupazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente; tutti i quarti d'ora risultano liberi
+ */
+void inizializza_occupazione(Occupazione *occupazione, time_t adesso);
+
+/*
+ * Funzione: segna_occupazione
+ * ---------------------------
+ * Segna come occupati i quarti d'ora dell'orizzonte toccati da [inizio, fine).
+ *
+ * Parametri:
+ *    occupazione: la mappa da aggiornare
+ *    inizio, fine: estremi della prenotazione
+ *
+ * Pre-condizioni:
+ *    occupazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente; la parte fuori dall'orizzonte viene ignorata
+ */
+void segna_occupazione(Occupazione *occupazione, time_t inizio, time_t fine);
+
+/*
+ * Funzione: libera_occupazione
+ * ----------------------------
+ * Aggiorna la mappa dopo che la prenotazione [inizio, fine) è stata rimossa da `prenotazioni`.
+ *
+ * Parametri:
+ *    occupazione: la mappa da aggiornare
+ *    prenotazioni: la struttura da cui la prenotazione è già stata rimossa
+ *    inizio, fine: estremi della prenotazione rimossa
+ *
+ * Pre-condizioni:
+ *    occupazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ */
+void libera_occupazione(Occupazione *occupazione, Prenotazioni prenotazioni, time_t inizio, time_t fine);
+
+/*
+ * Funzione: aggiorna_orizzonte_occupazione
+ * ----------------------------------------
+ * Sposta in avanti l'orizzonte quando `adesso` ne ha superato l'inizio di almeno due giorni.
+ *
+ * Parametri:
+ *    occupazione: la mappa da aggiornare
+ *    prenotazioni: la struttura da cui ricostruire la mappa
+ *    adesso: l'istante corrente
+ *
+ * Pre-condizioni:
+ *    occupazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    se l'orizzonte si sposta visita le prenotazioni del nuovo orizzonte
+ */
+void aggiorna_orizzonte_occupazione(Occupazione *occupazione, Prenotazioni prenotazioni, time_t adesso);
+
+/*
+ * Funzione: esito_occupazione
+ * ---------------------------
+ * Risponde, se possibile, alla domanda "[inizio, fine) è libero?" usando solo la mappa.
+ *
+ * Parametri:
+ *    occupazione: la mappa da interrogare
+ *    inizio, fine: estremi dell'intervallo
+ *
+ * Pre-condizioni:
+ *    occupazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce OK se nessuna prenotazione tocca i quarti d'ora dell'intervallo,
+ *    OCCUPATO se una prenotazione tocca un quarto d'ora interamente contenuto
+ *    nell'intervallo, INCERTO se l'intervallo esce dall'orizzonte o se sono
+ *    occupati solo i quarti d'ora di bordo
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(OK, OCCUPATO o INCERTO)
+ */
+Byte esito_occupazione(const Occupazione *occupazione, time_t inizio, time_t fine);
+
+#endif //OCCUPAZIONE_H
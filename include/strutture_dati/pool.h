@@ -0,0 +1,139 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+/*
+ * Tipo opaco per la gestione di un pool di elementi a dimensione fissa.
+ * Gli elementi vengono distribuiti a partire da blocchi contigui di memoria,
+ * così da ridurre le chiamate a malloc/free per strutture piccole e numerose.
+ */
+typedef struct pool *Pool;
+
+/*
+ * Definizione: StatistichePool
+ * ----------------------------
+ * Contatori delle allocazioni effettuate tramite un pool.
+ *
+ *    richieste: numero di elementi richiesti con `alloca_da_pool`
+ *    rilasci: numero di elementi restituiti con `rilascia_in_pool`
+ *    blocchi: numero di blocchi allocati al sistema (chiamate a malloc)
+ *    in_uso: numero di elementi attualmente in uso
+ */
+typedef struct {
+    unsigned long richieste;
+    unsigned long rilasci;
+    unsigned long blocchi;
+    unsigned long in_uso;
+} StatistichePool;
+
+/*
+ * Funzione: crea_pool
+ * -------------------
+ * Crea un nuovo pool per elementi della dimensione indicata.
+ *
+ * Parametri:
+ *    dimensione_elemento: dimensione in byte di ogni elemento
+ *    elementi_per_blocco: numero massimo di elementi contenuti in un blocco contiguo
+ *                         (i blocchi partono piccoli e raddoppiano fino a questo valore)
+ *
+ * Pre-condizioni:
+ *    dimensione_elemento: deve essere maggiore di 0
+ *    elementi_per_blocco: deve essere maggiore di 0
+ *
+ * Post-condizioni:
+ *    restituisce un nuovo pool vuoto se l'allocazione è riuscita, altrimenti NULL
+ *
+ * Ritorna:
+ *    un puntatore alla struttura Pool o NULL
+ *
+ * Side-effect:
+ *    alloca memoria dinamicamente per la struttura del pool; i blocchi
+ *    vengono allocati solo alla prima richiesta
+ */
+Pool crea_pool(size_t dimensione_elemento, unsigned int elementi_per_blocco);
+
+/*
+ * Funzione: distruggi_pool
+ * ------------------------
+ * Libera in blocco tutta la memoria del pool, compresi gli elementi ancora in uso.
+ *
+ * Parametri:
+ *    pool: il pool da distruggere
+ *
+ * Pre-condizioni:
+ *    pool: può essere NULL (nessuna operazione)
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    tutti i puntatori ottenuti dal pool diventano non validi
+ */
+void distruggi_pool(Pool pool);
+
+/*
+ * Funzione: alloca_da_pool
+ * ------------------------
+ * Restituisce un elemento libero del pool, allocando un nuovo blocco se necessario.
+ *
+ * Parametri:
+ *    pool: il pool da cui prelevare l'elemento
+ *
+ * Pre-condizioni:
+ *    pool: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce un puntatore ad un'area di `dimensione_elemento` byte
+ *    azzerata, oppure NULL in caso di errore di allocazione
+ *
+ * Ritorna:
+ *    un puntatore all'elemento o NULL
+ *
+ * Side-effect:
+ *    può allocare un nuovo blocco; aggiorna le statistiche del pool
+ */
+void *alloca_da_pool(Pool pool);
+
+/*
+ * Funzione: rilascia_in_pool
+ * --------------------------
+ * Restituisce un elemento al pool, rendendolo disponibile per richieste successive.
+ *
+ * Parametri:
+ *    pool: il pool da cui l'elemento è stato ottenuto
+ *    elemento: l'elemento da rilasciare
+ *
+ * Pre-condizioni:
+ *    pool: non deve essere NULL
+ *    elemento: deve essere stato ottenuto da `pool` tramite `alloca_da_pool`
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    l'elemento viene inserito nella lista libera del pool (la memoria non
+ *    viene restituita al sistema fino a `distruggi_pool`)
+ */
+void rilascia_in_pool(Pool pool, void *elemento);
+
+/*
+ * Funzione: ottieni_statistiche_pool
+ * ----------------------------------
+ * Restituisce i contatori delle allocazioni effettuate tramite il pool.
+ *
+ * Parametri:
+ *    pool: il pool da interrogare
+ *
+ * Pre-condizioni:
+ *    pool: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce le statistiche del pool, oppure contatori a zero se `pool` è NULL
+ *
+ * Ritorna:
+ *    una struttura StatistichePool
+ */
+StatistichePool ottieni_statistiche_pool(Pool pool);
+
+#endif // POOL_H
@@ -9,12 +9,36 @@
 #define OK 1
 #define OCCUPATO 0
 
+#include <time.h>
 #include "modelli/byte.h"
+#include "strutture_dati/pool.h"
 
 typedef struct intervallo *Intervallo;
 typedef struct prenotazione *Prenotazione;
 typedef struct albero *Prenotazioni;
 
+/*
+ * Definizione: VisitatorePrenotazioni
+ * -----------------------------------
+ * Funzione chiamata dalle visite dell'albero per ogni prenotazione incontrata.
+ *
+ *    p: la prenotazione visitata, in prestito: appartiene all'albero e non deve
+ *       essere distrutta né modificata
+ *    contesto: il puntatore passato alla funzione di visita
+ */
+typedef void (*VisitatorePrenotazioni)(const Prenotazione p, void *contesto);
+
+/*
+ * Definizione: OsservatorePrenotazioni
+ * ------------------------------------
+ * Funzione chiamata dalla struttura dopo ogni inserimento o cancellazione riuscita.
+ *
+ *    inizio, fine: gli estremi della prenotazione aggiunta o rimossa
+ *    aggiunta: 1 se la prenotazione è stata aggiunta, 0 se è stata rimossa
+ *    contesto: il puntatore passato a `imposta_osservatore_prenotazioni`
+ */
+typedef void (*OsservatorePrenotazioni)(time_t inizio, time_t fine, Byte aggiunta, void *contesto);
+
 /*
  * Funzione: crea_prenotazioni
  * ---------------------------
@@ -40,6 +64,36 @@ typedef struct albero *Prenotazioni;
  */
 Prenotazioni crea_prenotazioni();
 
+/*
+ * Funzione: crea_prenotazioni_da_vettore
+ * --------------------------------------
+ * Crea una struttura `Prenotazioni` a partire da un vettore di prenotazioni
+ * già ordinate per data di inizio, costruendo direttamente un albero bilanciato
+ * in tempo O(n), senza i controlli di sovrapposizione e i ribilanciamenti
+ * di `aggiungi_prenotazione`. Pensata per il caricamento da file.
+ *
+ * Parametri:
+ *    vettore: il vettore di prenotazioni ordinato per data di inizio.
+ *    n: il numero di elementi del vettore.
+ *
+ * Pre-condizioni:
+ *    vettore: può essere NULL solo se `n` è 0
+ *
+ * Post-condizioni:
+ *    Restituisce la nuova struttura `Prenotazioni`, che diventa proprietaria delle
+ *    prenotazioni del vettore (il vettore stesso resta del chiamante).
+ *    Restituisce NULL se il vettore non è ordinato, se due prenotazioni si sovrappongono
+ *    o in caso di errore di allocazione; in questo caso le prenotazioni restano del chiamante.
+ *
+ * Ritorna:
+ *    un puntatore alla struttura prenotazioni o NULL
+ *
+ * Side-effect:
+ *    Alloca memoria per la struttura e per i nodi dell'albero. La memoria
+ *    deve essere liberata chiamando `distruggi_prenotazioni`.
+ */
+Prenotazioni crea_prenotazioni_da_vettore(Prenotazione *vettore, unsigned int n);
+
 /*
  * Funzione: distruggi_prenotazioni
  * --------------------------------
@@ -57,7 +111,7 @@ Prenotazioni crea_prenotazioni();
  *
  * Side-effect:
  *    Tutta la memoria dinamicamente allocata per l'albero delle prenotazioni
- *    e i suoi nodi viene liberata.
+ *    e i suoi nodi viene liberata (i nodi in blocco, tramite il pool dell'albero).
  */
 void distruggi_prenotazioni(Prenotazioni prenotazioni);
 
@@ -167,7 +221,8 @@ Byte cancella_prenotazione(Prenotazioni prenotazioni, Intervallo i);
  *
  * Side-effect:
  *    Alloca memoria dinamicamente per l'array risultante. La memoria deve essere
- *    liberata dal chiamante (`free`).
+ *    liberata dal chiamante (`free`), dopo aver rilasciato ogni prenotazione con
+ *    `distruggi_prenotazione`: sono riferimenti condivisi con l'albero, non copie.
  */
 Prenotazione *ottieni_vettore_prenotazioni_ordinate(Prenotazioni prenotazioni, unsigned int *size);
 
@@ -198,10 +253,106 @@ Prenotazione *ottieni_vettore_prenotazioni_ordinate(Prenotazioni prenotazioni, u
  *
  * Side-effect:
  *    Alloca memoria dinamicamente per l'array `result` e per la coda temporanea.
- *    La memoria dell'array restituito deve essere liberata dal chiamante (`free`).
+ *    La memoria dell'array restituito deve essere liberata dal chiamante (`free`),
+ *    dopo aver rilasciato ogni prenotazione (riferimento condiviso) con `distruggi_prenotazione`.
  */
 Prenotazione *ottieni_vettore_prenotazioni_per_file(Prenotazioni prenotazioni, unsigned int *size);
 
+/*
+ * Funzione: dimensione_prenotazioni
+ * ---------------------------------
+ * Restituisce il numero di prenotazioni contenute nell'albero.
+ *
+ * Parametri:
+ *    prenotazioni: il puntatore alla struttura `Prenotazioni` da interrogare.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL
+ *
+ * Post-condizioni:
+ *    Restituisce il numero di prenotazioni, 0 se `prenotazioni` è NULL.
+ *
+ * Ritorna:
+ *    un intero senza segno
+ */
+unsigned int dimensione_prenotazioni(Prenotazioni prenotazioni);
+
+/*
+ * Funzione: visita_prenotazioni_in_ordine
+ * ---------------------------------------
+ * Chiama `visita` su tutte le prenotazioni dell'albero in ordine cronologico
+ * di inizio, senza copiarle.
+ *
+ * Parametri:
+ *    prenotazioni: il puntatore alla struttura `Prenotazioni` da visitare.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL (nessuna operazione)
+ *    visita: non deve essere NULL
+ *    `visita` non deve aggiungere o cancellare prenotazioni dall'albero.
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    Nessuna allocazione di memoria; gli effetti sono quelli di `visita`.
+ */
+void visita_prenotazioni_in_ordine(Prenotazioni prenotazioni, VisitatorePrenotazioni visita, void *contesto);
+
+/*
+ * Funzione: visita_prenotazioni_per_livello
+ * -----------------------------------------
+ * Chiama `visita` su tutte le prenotazioni dell'albero in ordine di livello
+ * (lo stesso ordine di `ottieni_vettore_prenotazioni_per_file`), senza copiarle.
+ *
+ * Parametri:
+ *    prenotazioni: il puntatore alla struttura `Prenotazioni` da visitare.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL (nessuna operazione)
+ *    visita: non deve essere NULL
+ *    `visita` non deve aggiungere o cancellare prenotazioni dall'albero.
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    Nessuna allocazione di memoria; gli effetti sono quelli di `visita`.
+ */
+void visita_prenotazioni_per_livello(Prenotazioni prenotazioni, VisitatorePrenotazioni visita, void *contesto);
+
+/*
+ * Funzione: visita_prenotazioni_in_intervallo
+ * -------------------------------------------
+ * Chiama `visita`, in ordine cronologico di inizio, solo sulle prenotazioni che
+ * si sovrappongono all'intervallo [da, a), senza copiarle. I sottoalberi che
+ * non possono contenere prenotazioni nell'intervallo non vengono visitati.
+ *
+ * Parametri:
+ *    prenotazioni: il puntatore alla struttura `Prenotazioni` da visitare.
+ *    da: inizio dell'intervallo di interesse.
+ *    a: fine dell'intervallo di interesse.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL (nessuna operazione)
+ *    visita: non deve essere NULL
+ *    `visita` non deve aggiungere o cancellare prenotazioni dall'albero.
+ *
+ * Post-condizioni:
+ *    non restituisce niente; se `da >= a` non viene visitata nessuna prenotazione
+ *
+ * Side-effect:
+ *    Nessuna allocazione di memoria; gli effetti sono quelli di `visita`.
+ */
+void visita_prenotazioni_in_intervallo(Prenotazioni prenotazioni, time_t da, time_t a,
+                                       VisitatorePrenotazioni visita, void *contesto);
+
 /*
  * Funzione: ottieni_intervallo_disponibile
  * ----------------------------------------
@@ -228,4 +379,52 @@ Prenotazione *ottieni_vettore_prenotazioni_per_file(Prenotazioni prenotazioni, u
  */
 Intervallo ottieni_intervallo_disponibile(Prenotazioni prenotazioni, Intervallo i);
 
+/*
+ * Funzione: imposta_osservatore_prenotazioni
+ * ------------------------------------------
+ * Registra la funzione da avvisare dopo ogni `aggiungi_prenotazione` e
+ * `cancella_prenotazione` riuscite, così che una struttura esterna (ad esempio
+ * l'indice di disponibilità della flotta) resti allineata qualunque sia il
+ * chiamante che modifica le prenotazioni.
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da osservare.
+ *    osserva: la funzione da chiamare, NULL per rimuovere l'osservatore.
+ *    contesto: puntatore passato invariato a `osserva`.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL (nessuna operazione)
+ *    `osserva` non deve aggiungere o cancellare prenotazioni dalla struttura.
+ *
+ * Post-condizioni:
+ *    non restituisce niente; un eventuale osservatore precedente viene sostituito
+ *
+ * Side-effect:
+ *    Nessuno; le prenotazioni già presenti non vengono notificate.
+ */
+void imposta_osservatore_prenotazioni(Prenotazioni prenotazioni, OsservatorePrenotazioni osserva, void *contesto);
+
+/*
+ * Funzione: ottieni_statistiche_prenotazioni
+ * ------------------------------------------
+ * Restituisce i contatori delle allocazioni dei nodi dell'albero delle prenotazioni.
+ * I nodi sono prelevati da un pool per albero e liberati in blocco da
+ * `distruggi_prenotazioni`: il campo `blocchi` indica quante chiamate a malloc
+ * sono state effettivamente necessarie per i nodi.
+ *
+ * Parametri:
+ *    prenotazioni: il puntatore alla struttura `Prenotazioni` da interrogare.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL
+ *
+ * Post-condizioni:
+ *    Restituisce le statistiche del pool dei nodi, oppure contatori a zero
+ *    se `prenotazioni` è NULL.
+ *
+ * Ritorna:
+ *    una struttura StatistichePool
+ */
+StatistichePool ottieni_statistiche_prenotazioni(Prenotazioni prenotazioni);
+
 #endif //PRENOTAZIONI_H
@@ -11,6 +11,23 @@
 typedef struct tabella_hash *TabellaHash;
 typedef struct nodo* Nodo;
 
+/*
+ * Definizione: IteratoreTabella
+ * -----------------------------
+ * Cursore per visitare i valori di una tabella hash senza allocare memoria.
+ * Va dichiarato dal chiamante (tipicamente sulla pila) e inizializzato con
+ * `tabella_iter_init`; i campi sono riservati all'implementazione.
+ *
+ *    tabella: la tabella visitata
+ *    indice: bucket (o slot) da cui riprendere la visita
+ *    prossimo: posizione interna al bucket corrente
+ */
+typedef struct {
+    TabellaHash tabella;
+    unsigned int indice;
+    void *prossimo;
+} IteratoreTabella;
+
 /*
  * Funzione: nuova_tabella_hash
  * ----------------------------
@@ -79,10 +96,45 @@ void distruggi_tabella(TabellaHash tabella_hash, void (*funzione_distruggi_valor
  *    un valore di tipo Byte(1 oppure 0)
  *
  * Side-effect:
- *    modifica la tabella hash aggiungendo un nuovo elemento e ridimensiona la tabella se necessario
+ *    modifica la tabella hash aggiungendo un nuovo elemento e ridimensiona la tabella se necessario;
+ *    con il motore a liste di trabocco il ridimensionamento è incrementale e ogni chiamata
+ *    sposta al più un numero costante di bucket
  */
 Byte inserisci_in_tabella(TabellaHash tabella_hash, const char *chiave, void *valore);
 
+/*
+ * Funzione: inserisci_in_blocco
+ * -----------------------------
+ *
+ * inserisce nella tabella un vettore di valori con chiavi tutte distinte, senza
+ * controllare i duplicati. La tabella viene portata una sola volta alla grandezza
+ * finale, quindi durante l'inserimento non avviene nessun ridimensionamento.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    valori: vettore dei valori da inserire, può contenere elementi NULL che vengono saltati
+ *    dimensione: numero di elementi del vettore
+ *    chiave_di: funzione che restituisce la chiave di un valore
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *    valori: non deve essere NULL
+ *    chiave_di: non deve essere NULL
+ *    le chiavi dei valori devono essere distinte tra loro e assenti dalla tabella
+ *    (ad esempio perché i valori sono stati salvati da un'altra tabella)
+ *
+ * Post-condizioni:
+ *    restituisce il numero di elementi di `valori` esaminati: i valori non NULL con
+ *    indice minore sono stati inseriti, gli altri no (dimensione se non ci sono errori)
+ *
+ * Ritorna:
+ *    un intero senza segno
+ *
+ * Side-effect:
+ *    modifica la tabella hash aggiungendo gli elementi e può sostituire l'array dei bucket
+ */
+unsigned int inserisci_in_blocco(TabellaHash tabella_hash, void **valori, unsigned int dimensione, const char *(*chiave_di)(const void *valore));
+
 /*
  * Funzione: cancella_dalla_tabella
  * -----------------------------------
@@ -108,6 +160,7 @@ Byte inserisci_in_tabella(TabellaHash tabella_hash, const char *chiave, void *va
  * Side-effect:
  *    - modifica la tabella hash rimuovendo l'elemento associato alla chiave
  *    - libera memoria dinamicamente associata al nodo e al valore
+ *    - può proseguire un ridimensionamento incrementale in corso
  */
 Byte cancella_dalla_tabella(const TabellaHash tabella_hash, const char *chiave, void (*funzione_distruggi_valore)(void *));
 
@@ -131,6 +184,9 @@ Byte cancella_dalla_tabella(const TabellaHash tabella_hash, const char *chiave,
  *
  * Ritorna:
  *    un puntatore generico o NULL
+ *
+ * Side-effect:
+ *    può proseguire un ridimensionamento incrementale in corso (senza modificare i valori)
  */
 const void *cerca_in_tabella(TabellaHash tabella_hash, const char *chiave);
 
@@ -160,4 +216,95 @@ const void *cerca_in_tabella(TabellaHash tabella_hash, const char *chiave);
  */
 void **ottieni_vettore(const TabellaHash tabella_hash, unsigned int *dimensione);
 
+/*
+ * Funzione: dimensione_tabella
+ * ----------------------------
+ *
+ * restituisce il numero di elementi contenuti nella tabella hash
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *
+ * Pre-condizioni:
+ *    tabella_hash: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce il numero di elementi, oppure 0 se `tabella_hash` è NULL
+ *
+ * Ritorna:
+ *    un intero senza segno
+ */
+unsigned int dimensione_tabella(const TabellaHash tabella_hash);
+
+/*
+ * Funzione: tabella_iter_init
+ * ---------------------------
+ *
+ * prepara un iteratore per visitare tutti i valori della tabella hash, senza allocare memoria
+ *
+ * Parametri:
+ *    iteratore: puntatore all'iteratore da inizializzare
+ *    tabella_hash: puntatore alla tabella hash da visitare
+ *
+ * Pre-condizioni:
+ *    iteratore: non deve essere NULL
+ *    tabella_hash: può essere NULL (la visita è vuota)
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    se un ridimensionamento incrementale è in corso viene completato, così che le
+ *    ricerche effettuate durante la visita non spostino elementi; la tabella non deve
+ *    essere modificata (inserimenti o cancellazioni) finché la visita non è terminata
+ */
+void tabella_iter_init(IteratoreTabella *iteratore, TabellaHash tabella_hash);
+
+/*
+ * Funzione: tabella_iter_next
+ * ---------------------------
+ *
+ * restituisce il prossimo valore della visita iniziata con tabella_iter_init
+ *
+ * Parametri:
+ *    iteratore: puntatore all'iteratore
+ *
+ * Pre-condizioni:
+ *    iteratore: non deve essere NULL e deve essere stato inizializzato con tabella_iter_init
+ *
+ * Post-condizioni:
+ *    restituisce il prossimo valore, oppure NULL quando tutti i valori sono stati visitati.
+ *    I valori vengono restituiti nello stesso ordine di ottieni_vettore.
+ *
+ * Ritorna:
+ *    un puntatore generico o NULL
+ *
+ * Side-effect:
+ *    avanza l'iteratore
+ */
+void *tabella_iter_next(IteratoreTabella *iteratore);
+
+/*
+ * Funzione: tabella_per_ogni
+ * --------------------------
+ *
+ * applica una funzione a tutti i valori della tabella hash, senza allocare memoria
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    funzione: funzione da chiamare per ogni valore; riceve il valore e `contesto`
+ *    contesto: puntatore passato invariato ad ogni chiamata di `funzione`, può essere NULL
+ *
+ * Pre-condizioni:
+ *    tabella_hash: può essere NULL (nessuna operazione)
+ *    funzione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    quelli di `funzione`, che non deve inserire o cancellare elementi della tabella
+ */
+void tabella_per_ogni(TabellaHash tabella_hash, void (*funzione)(void *valore, void *contesto), void *contesto);
+
 #endif //TABELLA_HASH_H
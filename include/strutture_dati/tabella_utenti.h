@@ -149,13 +149,16 @@ Byte rimuovi_utente_in_tabella(TabellaUtenti tabella_utenti, char *email);
  *    tabella_utenti: non deve essere NULL
  *    utente: non deve essere NULL
  *    dimensione: deve essere maggiore di 0
+ *    le email devono essere distinte tra loro e assenti dalla tabella, come
+ *    negli utenti letti da un archivio salvato da una tabella
  *
  * Post-condizioni:
  *    Non restituisce niente
  *
  * Side-effect:
- *    gli utenti vengono inseriti nella tabella hash. Se un utente ha un'email
- *    uguale rispetto a uno già presente, l'utente non viene inserito
+ *    gli utenti vengono inseriti nella tabella hash, che ne acquisisce la proprietà;
+ *    gli elementi NULL dell'array vengono saltati e gli utenti che non è stato
+ *    possibile inserire per mancanza di memoria vengono distrutti
  */
 void carica_utenti(TabellaUtenti tabella_utenti, Utente *utente, unsigned int dimensione);
 
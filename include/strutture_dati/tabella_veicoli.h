@@ -7,10 +7,11 @@
 #define HASHMAP_VEICOLI_H
 
 #include "modelli/byte.h"
+#include "strutture_dati/tabella_hash.h"
 
-// Rinominata TabellaHash in TabellaVeicoli
+// TabellaHash dei veicoli per targa, affiancata dall'indice di disponibilità della flotta
 typedef struct intervallo *Intervallo;
-typedef struct tabella_hash *TabellaVeicoli;
+typedef struct tabella_veicoli *TabellaVeicoli;
 typedef struct veicolo *Veicolo;
 
 /*
@@ -149,13 +150,21 @@ Byte rimuovi_veicolo_in_tabella(TabellaVeicoli tabella_veicoli, char *targa);
  *    dimensione: non deve essere NULL
  *
  * Post-condizioni:
- *    Restituisce un array allocato dinamicamente di puntatori a veicoli, restituisce NULL in caso di errore
+ *    Restituisce un array allocato dinamicamente contenente solo i veicoli disponibili,
+ *    restituisce NULL in caso di errore o se la tabella è vuota
  *
  * Ritorna:
  *    un array di veicoli o NULL
  *
  * Side-effect:
  *    Alloca dinamicamente un array che dovrà essere liberato dal chiamante.
+ *    I veicoli sono nell'ordine di visita della tabella (`tabella_veicoli_iter_init`)
+ *    all'ultima ricostruzione dell'indice di disponibilità della flotta, seguiti da
+ *    quelli inseriti in seguito; l'indice è ricostruito alla prima chiamata dopo il
+ *    caricamento o la rimozione di veicoli.
+ *    Le prenotazioni aggiunte o cancellate con `aggiungi_prenotazione` e
+ *    `cancella_prenotazione` (anche tramite il veicolo) aggiornano l'indice;
+ *    le prenotazioni sostituite con `imposta_prenotazioni` non vengono osservate.
  */
 Veicolo *ottieni_veicoli_disponibili(TabellaVeicoli tabella_veicoli, Intervallo intervallo, unsigned int *dimensione);
 
@@ -174,14 +183,103 @@ Veicolo *ottieni_veicoli_disponibili(TabellaVeicoli tabella_veicoli, Intervallo
  *    - tabella_veicoli: non deve essere NULL
  *    - veicolo: non deve essere NULL
  *    - dimensione: deve essere maggiore di 0
+ *    - le targhe devono essere distinte tra loro e assenti dalla tabella, come
+ *      nei veicoli letti da un archivio salvato da una tabella
  *
  * Post-condizioni:
  *    Non restituisce niente
  *
  * Side-effect:
- *    I veicoli vengono inseriti nella tabella hash. Se un veicolo ha una targa
- *    uguale rispetto a uno già presente, il veicolo non viene inserito
+ *    I veicoli vengono inseriti nella tabella hash, che ne acquisisce la proprietà;
+ *    gli elementi NULL dell'array vengono saltati e i veicoli che non è stato
+ *    possibile inserire per mancanza di memoria vengono distrutti
  */
 void carica_veicoli(TabellaVeicoli tabella_veicoli, Veicolo *veicolo, unsigned int dimensione);
 
+/*
+ * Funzione: dimensione_tabella_veicoli
+ * ------------------------------------
+ *
+ * restituisce il numero di veicoli contenuti nella tabella
+ *
+ * Parametri:
+ *    tabella_veicoli: puntatore alla tabella dei veicoli
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce il numero di veicoli, 0 se la tabella è NULL
+ *
+ * Ritorna:
+ *    un intero senza segno
+ */
+unsigned int dimensione_tabella_veicoli(const TabellaVeicoli tabella_veicoli);
+
+/*
+ * Funzione: tabella_veicoli_iter_init
+ * -----------------------------------
+ *
+ * inizializza un IteratoreTabella sui veicoli, da scorrere con `tabella_iter_next`
+ *
+ * Parametri:
+ *    iteratore: l'iteratore da inizializzare
+ *    tabella_veicoli: puntatore alla tabella dei veicoli
+ *
+ * Pre-condizioni:
+ *    iteratore: non deve essere NULL
+ *    tabella_veicoli: può essere NULL (l'iteratore non restituisce elementi)
+ *    la tabella non deve essere modificata durante la visita
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ */
+void tabella_veicoli_iter_init(IteratoreTabella *iteratore, TabellaVeicoli tabella_veicoli);
+
+/*
+ * Funzione: tabella_veicoli_per_ogni
+ * ----------------------------------
+ *
+ * chiama `funzione` su ogni veicolo della tabella, senza copiarla
+ *
+ * Parametri:
+ *    tabella_veicoli: puntatore alla tabella dei veicoli
+ *    funzione: la funzione da chiamare, che riceve il veicolo e `contesto`
+ *    contesto: puntatore passato invariato a `funzione`
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: può essere NULL (nessuna operazione)
+ *    funzione: non deve essere NULL e non deve modificare la tabella
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ */
+void tabella_veicoli_per_ogni(TabellaVeicoli tabella_veicoli, void (*funzione)(void *valore, void *contesto), void *contesto);
+
+/*
+ * Funzione: ottieni_vettore_veicoli
+ * ---------------------------------
+ *
+ * restituisce un array con tutti i veicoli della tabella
+ *
+ * Parametri:
+ *    tabella_veicoli: puntatore alla tabella dei veicoli
+ *    dimensione: puntatore a un intero dove verrà salvata la dimensione del vettore restituito
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: non deve essere NULL
+ *    dimensione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce un array di puntatori ai veicoli, NULL se la tabella è vuota o in caso di errore
+ *
+ * Ritorna:
+ *    un array di veicoli o NULL
+ *
+ * Side-effect:
+ *    Alloca dinamicamente un array che dovrà essere liberato dal chiamante;
+ *    i veicoli restano della tabella.
+ */
+Veicolo *ottieni_vettore_veicoli(const TabellaVeicoli tabella_veicoli, unsigned int *dimensione);
+
 #endif //HASHMAP_VEICOLI_H
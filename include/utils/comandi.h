@@ -0,0 +1,68 @@
+#ifndef COMANDI_H
+#define COMANDI_H
+
+#include <stdio.h>
+#include "modelli/byte.h"
+#include "modelli/utente.h"
+#include "strutture_dati/tabella_utenti.h"
+#include "strutture_dati/tabella_veicoli.h"
+#include "utils/giornale.h"
+
+/*
+ * Protocollo a righe usato dalla modalità batch e dal server. Ogni riga è un comando
+ * con i campi separati da ';' e le date nel formato gg/mm/aaaa hh:mm:
+ *     registra;nome;cognome;email;password
+ *     accedi;email;password
+ *     esci
+ *     prenota;targa;inizio;fine
+ *     cancella;id
+ *     modifica;id;inizio;fine
+ *     disponibilita;inizio;fine
+ *     storico
+ * `prenota`, `cancella`, `modifica` e `storico` agiscono sul cliente che ha eseguito l'ultimo `accedi`.
+ *
+ * Ogni comando produce una riga di esito:
+ *     OK;comando[;dati]   oppure   ERRORE;comando;motivo
+ * `prenota` restituisce id;targa;costo;sconto;costo_scontato, `modifica` id;costo;sconto;costo_scontato
+ * con il costo ricalcolato sul nuovo intervallo, `disponibilita` e `storico`
+ * il numero di righe che seguono, una per veicolo (targa;modello;tipo;posizione;tariffa)
+ * o per prenotazione (id;targa;inizio;fine;costo).
+ * Come nei menu, `prenota` rifiuta un inizio nel passato e `cancella` una prenotazione
+ * già terminata; `modifica` applica entrambe le regole.
+ */
+#define GRANDEZZA_RIGA_COMANDO 1024   // Lunghezza massima di una riga, terminatore compreso
+
+/*
+ * Funzione: esegui_comando
+ * ------------------------
+ *
+ * Esegue un singolo comando del protocollo e ne scrive l'esito su `uscita`
+ *
+ * Parametri:
+ *    riga: la riga del comando, senza il carattere di a capo
+ *    sessione: puntatore all'utente che ha eseguito l'accesso (NULL se nessuno)
+ *    uscita: file su cui scrivere l'esito
+ *    tabella_utenti: tabella hash degli utenti
+ *    tabella_veicoli: tabella hash dei veicoli
+ *    giornale: giornale su cui registrare le modifiche (può essere NULL)
+ *
+ * Pre-condizioni:
+ *    riga: non deve essere NULL
+ *    sessione: non deve essere NULL
+ *    uscita: deve essere un file aperto in scrittura
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce 1 se il comando è riuscito, 0 altrimenti
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    modifica `riga`, `*sessione`, le tabelle e il giornale; scrive su `uscita`
+ */
+Byte esegui_comando(char *riga, Utente *sessione, FILE *uscita, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli,
+                    Giornale giornale);
+
+#endif // COMANDI_H
@@ -1,8 +1,13 @@
 #ifndef GESTORE_FILE_H
 #define GESTORE_FILE_H
 
+#include <stdint.h>
+#include "modelli/byte.h"
+
 typedef struct veicolo *Veicolo;
 typedef struct utente *Utente;
+typedef struct tabella_hash *TabellaUtenti;
+typedef struct tabella_veicoli *TabellaVeicoli;
 
 /*
  * Autore: Russo Nello Manuel
@@ -18,21 +23,26 @@ typedef struct utente *Utente;
  *    nome_file_prenotazioni: file in cui salvare le prenotazioni
  *    vettore: array di veicoli da salvare
  *    num_veicoli: numero di elementi nel vettore
+ *    generazione: generazione del salvataggio, scritta nelle intestazioni dei due file
  *
  * Pre-condizioni:
  *    nome_file_veicolo: deve essere diverso da NULL
  *    nome_file_prenotazioni: deve essere diverso da NULL
- *    vettore: deve essere diverso da NULL
- *    num_veicoli: deve essere maggiore di 0
+ *    vettore: deve essere diverso da NULL se num_veicoli è maggiore di 0
  *
  * Post-condizioni:
- *    non restituisce niente
+ *    restituisce 1 se entrambi i file sono stati scritti e chiusi senza errori,
+ *    altrimenti 0. Con num_veicoli uguale a 0 vengono scritti file vuoti.
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
  *
  * Side-effect:
  *    i dati dei veicoli e delle relative prenotazioni vengono scritti
  *    nei file specificati in formato binario
  */
-void salva_vettore_veicoli(const char *nome_file_veicolo, const char *nome_file_prenotazioni, Veicolo vettore[], unsigned int num_veicoli);
+Byte salva_vettore_veicoli(const char *nome_file_veicolo, const char *nome_file_prenotazioni, Veicolo vettore[], unsigned int num_veicoli,
+                           uint64_t generazione);
 
 /*
  * Autore: Russo Nello Manuel
@@ -55,12 +65,14 @@ void salva_vettore_veicoli(const char *nome_file_veicolo, const char *nome_file_
  *
  * Post-condizioni:
  *    Restituisce un array di Veicolo e ne imposta la dimensione in num_veicoli, restituisce NULL in caso di errore
+ *    o se i due file hanno generazioni diverse. Le prenotazioni di ogni veicolo vengono costruite dal file al primo `ottieni_prenotazioni`
  *
  * Ritorna:
  *    un array di Veicolo o NULL
  *
  * Side-effect:
- *    Alloca memoria dinamicamente per il vettore restituito (va liberata dal chiamante)
+ *    Alloca memoria dinamicamente per il vettore restituito (va liberata dal chiamante);
+ *    il file delle prenotazioni resta mappato finché un veicolo non le ha costruite
  */
 Veicolo *carica_vettore_veicoli(const char *nome_file_veicolo, const char *nome_file_prenotazioni, unsigned int *num_veicoli);
 
@@ -75,19 +87,25 @@ Veicolo *carica_vettore_veicoli(const char *nome_file_veicolo, const char *nome_
  *    nome_file_data: nome del file per i dati storici
  *    vettore: array di puntatori a Utente
  *    num_utenti: numero di utenti nell'array
+ *    generazione: generazione del salvataggio, scritta nelle intestazioni dei due file
  *
  * Pre-condizione:
  *    nome_file_utente: non deve essere NULL
  *    nome_file_data: non deve essere NULL
- *    vettore: non deve essere NULL
+ *    vettore: non deve essere NULL se num_utenti è maggiore di 0
  *
  * Post-condizione:
- *    non restituisce niente
+ *    restituisce 1 se entrambi i file sono stati scritti e chiusi senza errori,
+ *    altrimenti 0. Con num_utenti uguale a 0 vengono scritti file vuoti.
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
  *
  * Side-effect:
  *    i dati degli utenti sono scritti nei file
  */
-void salva_vettore_utenti(const char *nome_file_utente, const char *nome_file_data, Utente vettore[], unsigned int num_utenti);
+Byte salva_vettore_utenti(const char *nome_file_utente, const char *nome_file_data, Utente vettore[], unsigned int num_utenti,
+                          uint64_t generazione);
 
 /*
  * Funzione: carica_vettore_utenti
@@ -106,14 +124,121 @@ void salva_vettore_utenti(const char *nome_file_utente, const char *nome_file_da
  *    num_utenti: non deve essere NULL
  *
  * Post-condizione:
- *    restituisce il vettore contenente gli utenti caricati dai file
+ *    restituisce il vettore contenente gli utenti caricati dai file, NULL se i due
+ *    file hanno generazioni diverse.
+ *    Lo storico di ogni cliente viene costruito dal file al primo accesso; il
+ *    numero di prenotazioni è disponibile subito
  *
  * Ritorna:
  *    un array di Utente, o NULL in caso di errore
  *
  * Side-effect:
- *    lettura da file, allocazione dinamica di memoria
+ *    lettura da file, allocazione dinamica di memoria; il file degli storici
+ *    resta mappato finché un cliente non ha costruito il proprio storico
  */
 Utente *carica_vettore_utenti(const char *nome_file_utente, const char *nome_file_data, unsigned int *num_utenti);
 
+/*
+ * Funzione: generazione_istantanea
+ * --------------------------------
+ *
+ * Legge la generazione del salvataggio a cui appartiene un file dell'archivio.
+ *
+ * Parametri:
+ *    nome_file: nome del file da leggere
+ *
+ * Post-condizione:
+ *    restituisce la generazione scritta da `salva_vettore_*`, o 0 se il file manca,
+ *    è incompleto o è in un formato precedente
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit
+ */
+uint64_t generazione_istantanea(const char *nome_file);
+
+/*
+ * Funzione: sostituisci_istantanee
+ * --------------------------------
+ *
+ * Sostituisce i file dell'archivio con quelli appena salvati in file temporanei.
+ *
+ * Parametri:
+ *    temporanei: file scritti da `salva_vettore_*`, tutti della stessa generazione
+ *    definitivi: file da sostituire, nello stesso ordine
+ *    num_file: numero di file
+ *
+ * Pre-condizioni:
+ *    temporanei, definitivi: non devono essere NULL
+ *
+ * Post-condizione:
+ *    restituisce 1 se tutti i file sono stati rinominati e la cartella sincronizzata, 0 altrimenti
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    rinomina i file; se si interrompe a metà, la sostituzione va completata con
+ *    `completa_sostituzione_istantanee`
+ */
+Byte sostituisci_istantanee(const char *temporanei[], const char *definitivi[], unsigned int num_file);
+
+/*
+ * Funzione: completa_sostituzione_istantanee
+ * ------------------------------------------
+ *
+ * Da chiamare prima del caricamento: porta a termine una `sostituisci_istantanee`
+ * interrotta e rimuove i temporanei di un salvataggio mai iniziato a sostituire.
+ *
+ * Parametri:
+ *    temporanei: file temporanei, come in `sostituisci_istantanee`
+ *    definitivi: file dell'archivio, nello stesso ordine
+ *    num_file: numero di file
+ *
+ * Pre-condizioni:
+ *    temporanei, definitivi: non devono essere NULL
+ *
+ * Post-condizione:
+ *    restituisce 1 se non restano temporanei da sostituire, 0 altrimenti
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    rinomina o rimuove i file temporanei
+ */
+Byte completa_sostituzione_istantanee(const char *temporanei[], const char *definitivi[], unsigned int num_file);
+
+/*
+ * Funzione: carica_tabelle
+ * ------------------------
+ *
+ * Carica le tabelle degli utenti e dei veicoli dai file dell'archivio
+ *
+ * Implementazione:
+ *    - Le due tabelle vengono caricate contemporaneamente su due thread con `esegui_a_blocchi`
+ *    - Se il caricamento di un file fallisce, la relativa tabella viene creata vuota
+ *    - Ogni tabella ha almeno `grandezza` posizioni, e almeno il doppio degli elementi caricati
+ *
+ * Parametri:
+ *    file_archivio: file degli utenti, dei dati degli utenti, dei veicoli e delle prenotazioni
+ *    grandezza: dimensione minima delle tabelle hash
+ *    tabella_utenti: puntatore in cui salvare la tabella degli utenti
+ *    tabella_veicoli: puntatore in cui salvare la tabella dei veicoli
+ *
+ * Pre-condizioni:
+ *    file_archivio: deve contenere quattro nomi di file, nell'ordine indicato
+ *    tabella_utenti, tabella_veicoli: non devono essere NULL
+ *
+ * Post-condizione:
+ *    restituisce 1 se entrambe le tabelle sono state create, 0 altrimenti; in caso di
+ *    errore nessuna tabella resta allocata e i due puntatori valgono NULL
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    legge i file dell'archivio e alloca memoria per le tabelle
+ */
+Byte carica_tabelle(const char *file_archivio[], unsigned int grandezza, TabellaUtenti *tabella_utenti, TabellaVeicoli *tabella_veicoli);
+
 #endif //GESTORE_FILE_H
@@ -0,0 +1,108 @@
+#ifndef GESTORE_PRENOTAZIONI_H
+#define GESTORE_PRENOTAZIONI_H
+
+#include <stdint.h>
+#include "modelli/byte.h"
+#include "modelli/prenotazione.h"
+#include "utils/giornale.h"
+
+/*
+ * Operazioni sulle prenotazioni indicate per identificativo (`ottieni_id_prenotazione`).
+ * La prenotazione viene trovata con `cerca_prenotazione_per_id`, senza scorrere gli
+ * storici dei clienti né le prenotazioni dei veicoli, e ogni modifica viene applicata
+ * sia all'albero del veicolo sia allo storico del cliente e registrata nel giornale.
+ */
+
+/*
+ * Funzione: cancella_prenotazione_per_id
+ * --------------------------------------
+ * Cancella la prenotazione con l'identificativo dato dal veicolo e dallo storico del cliente.
+ *
+ * Parametri:
+ *    tabella_utenti: tabella degli utenti
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare la cancellazione (può essere NULL)
+ *    id: identificativo della prenotazione
+ *
+ * Pre-condizioni:
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se la prenotazione è stata tolta dal veicolo o dallo storico,
+ *    0 se nessuna prenotazione viva ha quell'identificativo o non è in nessuno dei due
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    modifica l'albero del veicolo e lo storico del cliente, scrive un record nel giornale;
+ *    la prenotazione viene liberata se nessun'altra vista la usa
+ */
+Byte cancella_prenotazione_per_id(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale, uint64_t id);
+
+/*
+ * Funzione: cancella_prenotazioni_per_id
+ * --------------------------------------
+ * Cancella le prenotazioni con gli identificativi dati, come `cancella_prenotazione_per_id`.
+ *
+ * Parametri:
+ *    tabella_utenti: tabella degli utenti
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare le cancellazioni (può essere NULL)
+ *    id: vettore degli identificativi
+ *    num_id: numero di elementi di `id`
+ *
+ * Pre-condizioni:
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *    id: non deve essere NULL se num_id è maggiore di 0
+ *
+ * Post-condizioni:
+ *    restituisce il numero di prenotazioni cancellate
+ *
+ * Ritorna:
+ *    un intero senza segno
+ *
+ * Side-effect:
+ *    come `cancella_prenotazione_per_id`, per ogni identificativo
+ */
+unsigned int cancella_prenotazioni_per_id(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale,
+                                          const uint64_t *id, unsigned int num_id);
+
+/*
+ * Funzione: modifica_prenotazione_per_id
+ * --------------------------------------
+ * Sposta la prenotazione con l'identificativo dato nell'intervallo `nuovo` e ne aggiorna
+ * il costo. La modifica è visibile anche dallo storico del cliente, che condivide la
+ * stessa prenotazione.
+ *
+ * Parametri:
+ *    tabella_utenti: tabella degli utenti
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare la modifica (può essere NULL)
+ *    id: identificativo della prenotazione
+ *    nuovo: il nuovo intervallo
+ *    costo: il nuovo costo
+ *
+ * Pre-condizioni:
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *    nuovo: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se la prenotazione è stata modificata, 0 se non esiste, se il suo
+ *    veicolo non è in tabella o se `nuovo` si sovrappone a un'altra prenotazione del
+ *    veicolo; in questi casi la prenotazione resta invariata
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    può costruire lo storico del cliente; modifica la prenotazione e l'albero del veicolo,
+ *    scrive due record nel giornale
+ */
+Byte modifica_prenotazione_per_id(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale, uint64_t id,
+                                  Intervallo nuovo, double costo);
+
+#endif //GESTORE_PRENOTAZIONI_H
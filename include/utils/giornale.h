@@ -0,0 +1,309 @@
+#ifndef GIORNALE_H
+#define GIORNALE_H
+
+#include "modelli/byte.h"
+
+/*
+ * Definizione: Giornale
+ * ---------------------
+ * Giornale delle modifiche (write-ahead log) scritto in coda a un file binario.
+ * Ogni modifica a utenti, veicoli e prenotazioni viene registrata appena avviene:
+ * all'avvio il giornale viene riapplicato sopra l'ultima istantanea dei file
+ * dell'archivio, e la compattazione lo svuota dopo aver riscritto l'istantanea (o,
+ * se l'istantanea è stata salvata mentre si registravano altre modifiche, ne scarta
+ * solo i record precedenti al confine segnato).
+ *
+ * Ogni record ha la forma:
+ *    [unsigned int lunghezza][Byte tipo][contenuto][uint32_t controllo]
+ * dove `controllo` è un hash FNV-1a di tipo e contenuto: un record troncato o
+ * corrotto (ad esempio da un arresto durante la scrittura) chiude il giornale.
+ */
+typedef struct giornale *Giornale;
+typedef struct tabella_hash *TabellaUtenti;
+typedef struct tabella_veicoli *TabellaVeicoli;
+typedef struct utente *Utente;
+typedef struct veicolo *Veicolo;
+typedef struct prenotazione *Prenotazione;
+
+/*
+ * Funzione: apri_giornale
+ * -----------------------
+ * Apre (o crea) il giornale memorizzato nel file indicato.
+ *
+ * Parametri:
+ *    nome_file: percorso del file del giornale
+ *
+ * Pre-condizioni:
+ *    nome_file: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce il giornale aperto, con i nuovi record scritti in coda al file
+ *
+ * Ritorna:
+ *    un oggetto Giornale oppure NULL in caso di errore
+ *
+ * Side-effect:
+ *    alloca memoria e apre il file, creandolo se non esiste
+ */
+Giornale apri_giornale(const char *nome_file);
+
+/*
+ * Funzione: chiudi_giornale
+ * -------------------------
+ * Chiude il giornale e libera la memoria associata.
+ *
+ * Parametri:
+ *    giornale: il giornale da chiudere
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    chiude il file; i record già registrati restano sul disco
+ */
+void chiudi_giornale(Giornale giornale);
+
+/*
+ * Funzione: riapplica_giornale
+ * ----------------------------
+ * Riapplica alle tabelle, nell'ordine in cui sono stati scritti, i record del giornale.
+ *
+ * Parametri:
+ *    giornale: il giornale da leggere
+ *    tabella_utenti: la tabella degli utenti caricata dall'istantanea
+ *    tabella_veicoli: la tabella dei veicoli caricata dall'istantanea
+ *
+ * Pre-condizioni:
+ *    giornale, tabella_utenti, tabella_veicoli: non devono essere NULL
+ *
+ * Post-condizioni:
+ *    ogni record viene applicato solo se il suo effetto non è già presente nelle
+ *    tabelle, quindi riapplicare un giornale già contenuto nell'istantanea non
+ *    cambia niente. La lettura si ferma al primo record troncato o corrotto.
+ *
+ * Ritorna:
+ *    il numero di record letti, oppure -1 se il giornale termina con un record
+ *    troncato o corrotto (i record precedenti sono stati applicati)
+ *
+ * Side-effect:
+ *    modifica le tabelle
+ */
+int riapplica_giornale(Giornale giornale, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli);
+
+/*
+ * Funzione: svuota_giornale
+ * -------------------------
+ * Elimina tutti i record del giornale, da chiamare dopo aver salvato un'istantanea completa.
+ *
+ * Parametri:
+ *    giornale: il giornale da svuotare
+ *
+ * Pre-condizioni:
+ *    giornale: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il file è stato svuotato, 0 in caso di errore
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    tronca il file del giornale
+ */
+Byte svuota_giornale(Giornale giornale);
+
+/*
+ * Funzione: segna_confine_giornale
+ * --------------------------------
+ * Ricorda fin dove arriva il giornale, prima di salvare un'istantanea in un altro processo:
+ * i record registrati in seguito restano oltre il confine.
+ *
+ * Parametri:
+ *    giornale: il giornale da segnare
+ *
+ * Pre-condizioni:
+ *    giornale: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il confine è stato segnato, 0 se il file non è disponibile
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    scrive sul file i dati rimasti nel buffer
+ */
+Byte segna_confine_giornale(Giornale giornale);
+
+/*
+ * Funzione: scarta_fino_al_confine
+ * --------------------------------
+ * Elimina i record scritti prima del confine, da chiamare quando l'istantanea che li
+ * contiene è stata salvata. Se l'operazione fallisce il giornale resta completo.
+ *
+ * Parametri:
+ *    giornale: il giornale da accorciare
+ *
+ * Pre-condizioni:
+ *    giornale: non deve essere NULL, con un confine segnato da `segna_confine_giornale`
+ *
+ * Post-condizioni:
+ *    restituisce 1 se i record precedenti al confine sono stati eliminati, 0 altrimenti;
+ *    in entrambi i casi il confine viene dimenticato
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    riscrive il file del giornale
+ */
+Byte scarta_fino_al_confine(Giornale giornale);
+
+/*
+ * Funzione: dimensione_giornale
+ * -----------------------------
+ * Restituisce il numero di record contenuti nel giornale: quelli riapplicati
+ * all'avvio più quelli registrati in seguito, azzerato dallo svuotamento.
+ *
+ * Parametri:
+ *    giornale: il giornale da interrogare
+ *
+ * Ritorna:
+ *    il numero di record, 0 se `giornale` è NULL
+ */
+unsigned int dimensione_giornale(Giornale giornale);
+
+/*
+ * Funzione: giornale_integro
+ * --------------------------
+ * Indica se tutte le scritture sul giornale sono andate a buon fine.
+ *
+ * Parametri:
+ *    giornale: il giornale da interrogare
+ *
+ * Post-condizioni:
+ *    restituisce 0 se `giornale` è NULL, se una scrittura è fallita o se la
+ *    riapplicazione ha trovato una coda corrotta: in quel caso il giornale non
+ *    descrive più tutte le modifiche e serve un'istantanea completa
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ */
+Byte giornale_integro(Giornale giornale);
+
+/*
+ * Funzione: registra_utente_in_giornale
+ * -------------------------------------
+ * Registra l'aggiunta di un nuovo utente.
+ *
+ * Parametri:
+ *    giornale: il giornale su cui scrivere
+ *    utente: l'utente aggiunto alla tabella
+ *
+ * Pre-condizioni:
+ *    utente: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il record è stato scritto, 0 altrimenti (anche se `giornale` è NULL)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    scrive un record in coda al file e lo svuota verso il sistema operativo
+ */
+Byte registra_utente_in_giornale(Giornale giornale, Utente utente);
+
+/*
+ * Funzione: registra_veicolo_in_giornale
+ * --------------------------------------
+ * Registra l'aggiunta di un nuovo veicolo, senza prenotazioni.
+ *
+ * Parametri:
+ *    giornale: il giornale su cui scrivere
+ *    veicolo: il veicolo aggiunto alla tabella
+ *
+ * Pre-condizioni:
+ *    veicolo: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il record è stato scritto, 0 altrimenti (anche se `giornale` è NULL)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    scrive un record in coda al file e lo svuota verso il sistema operativo
+ */
+Byte registra_veicolo_in_giornale(Giornale giornale, Veicolo veicolo);
+
+/*
+ * Funzione: registra_rimozione_veicolo_in_giornale
+ * ------------------------------------------------
+ * Registra la rimozione di un veicolo.
+ *
+ * Parametri:
+ *    giornale: il giornale su cui scrivere
+ *    targa: la targa del veicolo rimosso
+ *
+ * Pre-condizioni:
+ *    targa: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il record è stato scritto, 0 altrimenti (anche se `giornale` è NULL)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    scrive un record in coda al file e lo svuota verso il sistema operativo
+ */
+Byte registra_rimozione_veicolo_in_giornale(Giornale giornale, const char *targa);
+
+/*
+ * Funzione: registra_prenotazione_in_giornale
+ * -------------------------------------------
+ * Registra una nuova prenotazione, aggiunta al veicolo e allo storico del cliente.
+ *
+ * Parametri:
+ *    giornale: il giornale su cui scrivere
+ *    prenotazione: la prenotazione aggiunta
+ *
+ * Pre-condizioni:
+ *    prenotazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il record è stato scritto, 0 altrimenti (anche se `giornale` è NULL)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    scrive un record in coda al file e lo svuota verso il sistema operativo
+ */
+Byte registra_prenotazione_in_giornale(Giornale giornale, Prenotazione prenotazione);
+
+/*
+ * Funzione: registra_cancellazione_in_giornale
+ * --------------------------------------------
+ * Registra la cancellazione di una prenotazione dal veicolo e dallo storico del cliente.
+ *
+ * Parametri:
+ *    giornale: il giornale su cui scrivere
+ *    prenotazione: la prenotazione cancellata
+ *
+ * Pre-condizioni:
+ *    prenotazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il record è stato scritto, 0 altrimenti (anche se `giornale` è NULL)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    scrive un record in coda al file e lo svuota verso il sistema operativo
+ */
+Byte registra_cancellazione_in_giornale(Giornale giornale, Prenotazione prenotazione);
+
+#endif //GIORNALE_H
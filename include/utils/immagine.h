@@ -0,0 +1,83 @@
+#ifndef IMMAGINE_H
+#define IMMAGINE_H
+
+#include <stddef.h>
+
+/*
+ * Definizione: Immagine
+ * ---------------------
+ * Contenuto di un file in sola lettura, accessibile come un unico blocco di byte.
+ * Sui sistemi POSIX il file viene mappato in memoria con `mmap`, così le pagine
+ * vengono lette dal sistema operativo solo quando servono; altrove viene letto
+ * con una sola `fread`.
+ */
+typedef struct immagine *Immagine;
+
+/*
+ * Funzione: apri_immagine
+ * -----------------------
+ * Rende accessibile in memoria l'intero contenuto del file indicato.
+ *
+ * Parametri:
+ *    nome_file: percorso del file da aprire
+ *
+ * Pre-condizioni:
+ *    nome_file: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce l'immagine del file; un file vuoto dà un'immagine di dimensione 0
+ *
+ * Ritorna:
+ *    un oggetto Immagine oppure NULL se il file non esiste o non può essere letto
+ *
+ * Side-effect:
+ *    alloca memoria e mappa (o legge) il file
+ */
+Immagine apri_immagine(const char *nome_file);
+
+/*
+ * Funzione: dati_immagine
+ * -----------------------
+ * Restituisce il primo byte dell'immagine.
+ *
+ * Parametri:
+ *    immagine: l'immagine da interrogare
+ *
+ * Post-condizioni:
+ *    il blocco resta valido fino a `chiudi_immagine` e non deve essere modificato
+ *
+ * Ritorna:
+ *    un puntatore ai dati, NULL se `immagine` è NULL o vuota
+ */
+const unsigned char *dati_immagine(const Immagine immagine);
+
+/*
+ * Funzione: dimensione_immagine
+ * -----------------------------
+ * Restituisce il numero di byte dell'immagine.
+ *
+ * Parametri:
+ *    immagine: l'immagine da interrogare
+ *
+ * Ritorna:
+ *    la dimensione in byte, 0 se `immagine` è NULL
+ */
+size_t dimensione_immagine(const Immagine immagine);
+
+/*
+ * Funzione: chiudi_immagine
+ * -------------------------
+ * Rilascia l'immagine; i puntatori ottenuti da `dati_immagine` non sono più validi.
+ *
+ * Parametri:
+ *    immagine: l'immagine da chiudere
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    smappa il file o libera la memoria in cui era stato letto
+ */
+void chiudi_immagine(Immagine immagine);
+
+#endif //IMMAGINE_H
@@ -0,0 +1,74 @@
+#ifndef PARALLELO_H
+#define PARALLELO_H
+
+#include "modelli/byte.h"
+
+/*
+ * Definizione: FunzioneBlocco
+ * ---------------------------
+ * Lavoro da eseguire sugli elementi [inizio, fine) di un intervallo. Blocchi
+ * diversi possono essere eseguiti contemporaneamente su thread diversi, quindi
+ * la funzione deve scrivere solo negli elementi del proprio blocco.
+ */
+typedef void (*FunzioneBlocco)(void *contesto, unsigned int inizio, unsigned int fine);
+
+/*
+ * Funzione: imposta_numero_thread
+ * -------------------------------
+ * Imposta il numero massimo di thread usati da `esegui_a_blocchi`.
+ *
+ * Parametri:
+ *    num_thread: numero di thread, 0 per usarne uno per processore
+ *
+ * Pre-condizioni:
+ *    nessuna `esegui_a_blocchi` deve essere in corso
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    modifica l'impostazione globale del modulo
+ */
+void imposta_numero_thread(unsigned int num_thread);
+
+/*
+ * Funzione: ottieni_numero_thread
+ * -------------------------------
+ * Restituisce il numero massimo di thread usati da `esegui_a_blocchi`.
+ *
+ * Ritorna:
+ *    il numero di thread impostato, o il numero di processori se non è stato
+ *    impostato (almeno 1)
+ */
+unsigned int ottieni_numero_thread(void);
+
+/*
+ * Funzione: esegui_a_blocchi
+ * --------------------------
+ * Divide [0, num_elementi) in blocchi di `dimensione_blocco` elementi ed esegue
+ * `funzione` su ogni blocco, usando fino a `ottieni_numero_thread()` thread.
+ *
+ * Parametri:
+ *    num_elementi: numero di elementi da elaborare
+ *    dimensione_blocco: numero di elementi di ogni blocco (l'ultimo può essere più corto)
+ *    funzione: il lavoro da eseguire su ogni blocco
+ *    contesto: puntatore passato invariato a `funzione`
+ *
+ * Pre-condizioni:
+ *    dimensione_blocco: deve essere maggiore di 0
+ *    funzione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 quando tutti i blocchi sono stati eseguiti, 0 se i parametri
+ *    non sono validi. Se un thread non può essere creato, i suoi blocchi vengono
+ *    eseguiti dagli altri.
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    crea e attende i thread di lavoro; il thread chiamante esegue anch'esso dei blocchi
+ */
+Byte esegui_a_blocchi(unsigned int num_elementi, unsigned int dimensione_blocco, FunzioneBlocco funzione, void *contesto);
+
+#endif //PARALLELO_H
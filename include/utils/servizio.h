@@ -0,0 +1,272 @@
+#ifndef SERVIZIO_H
+#define SERVIZIO_H
+
+#include <stdint.h>
+#include "modelli/intervallo.h"
+#include "modelli/prenotazione.h"
+#include "modelli/utente.h"
+#include "modelli/veicolo.h"
+#include "strutture_dati/prenotazioni.h"
+#include "strutture_dati/tabella_utenti.h"
+#include "strutture_dati/tabella_veicoli.h"
+#include "utils/giornale.h"
+#include "utils/tariffe.h"
+
+/*
+ * Operazioni del cliente sulle tabelle caricate, senza interazione con il terminale:
+ * sono usate dai menu, dalla modalità batch e da chi collega il motore a un'altra
+ * interfaccia. Ogni modifica viene applicata all'albero del veicolo e allo storico
+ * del cliente e registrata nel giornale (che può essere NULL).
+ */
+
+typedef enum {
+    SERVIZIO_OK,
+    SERVIZIO_ACCESSO_NEGATO,             // Nessun cliente ha eseguito l'accesso
+    SERVIZIO_VEICOLO_NON_TROVATO,
+    SERVIZIO_INTERVALLO_NON_VALIDO,
+    SERVIZIO_VEICOLO_OCCUPATO,
+    SERVIZIO_PRENOTAZIONE_NON_TROVATA,   // Inesistente o di un altro cliente
+    SERVIZIO_MEMORIA_INSUFFICIENTE,
+} EsitoServizio;
+
+// Prezzo di una prenotazione: la prenotazione memorizza il costo pieno
+typedef struct {
+    double costo;                        // Costo pieno (`calcola_costo`)
+    double sconto;                       // Sconto totale (es. 0.35 per 35%)
+    double costo_scontato;
+    char motivo[MOTIVO_SCONTO * 2];      // Motivo dello sconto, vuoto se non ce ne sono
+} Preventivo;
+
+/*
+ * Funzione: descrivi_esito_servizio
+ * ---------------------------------
+ *
+ * Restituisce una descrizione testuale dell'esito di un'operazione
+ *
+ * Parametri:
+ *    esito: l'esito da descrivere
+ *
+ * Pre-condizioni:
+ *    nessuna
+ *
+ * Post-condizione:
+ *    restituisce la descrizione corrispondente
+ *
+ * Ritorna:
+ *    Una stringa costante
+ */
+const char *descrivi_esito_servizio(EsitoServizio esito);
+
+/*
+ * Funzione: prepara_prenotazione
+ * ------------------------------
+ *
+ * Crea la prenotazione del veicolo `targa` per il cliente nell'intervallo dato e ne
+ * calcola il preventivo, senza aggiungerla al veicolo né allo storico
+ *
+ * Parametri:
+ *    tabella_veicoli: tabella dei veicoli
+ *    utente: il cliente che prenota
+ *    targa: targa del veicolo
+ *    intervallo: intervallo della prenotazione
+ *    preventivo: dove scrivere il prezzo (può essere NULL)
+ *    prenotazione: dove scrivere la prenotazione creata
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: non deve essere NULL
+ *    prenotazione: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK e la prenotazione in `*prenotazione`, altrimenti il motivo
+ *    dell'errore e NULL in `*prenotazione`; un intervallo che inizia nel passato
+ *    restituisce SERVIZIO_INTERVALLO_NON_VALIDO
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    alloca la prenotazione, che va passata a `conferma_prenotazione` o distrutta
+ */
+EsitoServizio prepara_prenotazione(TabellaVeicoli tabella_veicoli, Utente utente, const char *targa, Intervallo intervallo,
+                                   Preventivo *preventivo, Prenotazione *prenotazione);
+
+/*
+ * Funzione: conferma_prenotazione
+ * -------------------------------
+ *
+ * Aggiunge una prenotazione creata da `prepara_prenotazione` al veicolo e allo storico
+ * del cliente e la registra nel giornale
+ *
+ * Parametri:
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare la prenotazione (può essere NULL)
+ *    utente: il cliente che prenota
+ *    prenotazione: la prenotazione da confermare
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: non deve essere NULL
+ *    prenotazione: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK se la prenotazione è stata aggiunta, SERVIZIO_VEICOLO_OCCUPATO
+ *    se si sovrappone a una prenotazione del veicolo
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    prende il riferimento del chiamante alla prenotazione, che viene liberata in caso di errore;
+ *    modifica l'albero del veicolo, lo storico del cliente e il giornale
+ */
+EsitoServizio conferma_prenotazione(TabellaVeicoli tabella_veicoli, Giornale giornale, Utente utente, Prenotazione prenotazione);
+
+/*
+ * Funzione: prenota
+ * -----------------
+ *
+ * Prenota il veicolo `targa` per il cliente nell'intervallo dato, applicando gli sconti
+ * di `calcola_sconto_totale`
+ *
+ * Parametri:
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare la prenotazione (può essere NULL)
+ *    utente: il cliente che prenota
+ *    targa: targa del veicolo
+ *    intervallo: intervallo della prenotazione
+ *    preventivo: dove scrivere il prezzo (può essere NULL)
+ *    id: dove scrivere l'identificativo della prenotazione (può essere NULL)
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK se la prenotazione è stata aggiunta, altrimenti il motivo dell'errore
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    modifica l'albero del veicolo, lo storico del cliente e il giornale
+ */
+EsitoServizio prenota(TabellaVeicoli tabella_veicoli, Giornale giornale, Utente utente, const char *targa, Intervallo intervallo,
+                      Preventivo *preventivo, uint64_t *id);
+
+/*
+ * Funzione: cancella
+ * ------------------
+ *
+ * Cancella la prenotazione del cliente con l'identificativo dato
+ *
+ * Parametri:
+ *    tabella_utenti: tabella degli utenti
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare la cancellazione (può essere NULL)
+ *    utente: il cliente a cui appartiene la prenotazione
+ *    id: identificativo della prenotazione
+ *
+ * Pre-condizioni:
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK se la prenotazione è stata cancellata, SERVIZIO_PRENOTAZIONE_NON_TROVATA
+ *    se non esiste, appartiene a un altro cliente o è già terminata
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    può costruire lo storico del cliente; modifica l'albero del veicolo, lo storico e il giornale
+ */
+EsitoServizio cancella(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale, Utente utente, uint64_t id);
+
+/*
+ * Funzione: modifica
+ * ------------------
+ *
+ * Sposta la prenotazione del cliente con l'identificativo dato in un nuovo intervallo,
+ * ricalcolandone il costo
+ *
+ * Parametri:
+ *    tabella_utenti: tabella degli utenti
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare la modifica (può essere NULL)
+ *    utente: il cliente a cui appartiene la prenotazione
+ *    id: identificativo della prenotazione
+ *    intervallo: il nuovo intervallo
+ *    preventivo: se non è NULL, riceve il nuovo costo e lo sconto applicabile
+ *
+ * Pre-condizioni:
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK se la prenotazione è stata spostata, altrimenti il motivo
+ *    dell'errore: SERVIZIO_PRENOTAZIONE_NON_TROVATA come in `cancella`,
+ *    SERVIZIO_INTERVALLO_NON_VALIDO se il nuovo intervallo inizia nel passato,
+ *    SERVIZIO_VEICOLO_NON_TROVATO o SERVIZIO_VEICOLO_OCCUPATO; in caso di errore la
+ *    prenotazione resta invariata
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    può costruire lo storico del cliente; modifica la prenotazione, l'albero del veicolo e il giornale
+ */
+EsitoServizio modifica(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale, Utente utente, uint64_t id,
+                       Intervallo intervallo, Preventivo *preventivo);
+
+/*
+ * Funzione: disponibilita
+ * -----------------------
+ *
+ * Restituisce i veicoli liberi per tutto l'intervallo dato
+ *
+ * Parametri:
+ *    tabella_veicoli: tabella dei veicoli
+ *    intervallo: intervallo richiesto
+ *    veicoli: dove scrivere il vettore dei veicoli disponibili
+ *    num_veicoli: dove scrivere il numero di veicoli disponibili
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: non deve essere NULL
+ *    veicoli e num_veicoli: non devono essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK e il vettore in `*veicoli` (NULL se non ci sono veicoli
+ *    disponibili), SERVIZIO_INTERVALLO_NON_VALIDO se `intervallo` è NULL
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    alloca il vettore, che va liberato con free; i veicoli restano della tabella
+ */
+EsitoServizio disponibilita(TabellaVeicoli tabella_veicoli, Intervallo intervallo, Veicolo **veicoli, unsigned int *num_veicoli);
+
+/*
+ * Funzione: storico
+ * -----------------
+ *
+ * Visita le prenotazioni dello storico del cliente
+ *
+ * Parametri:
+ *    utente: il cliente
+ *    visita: funzione chiamata per ogni prenotazione
+ *    contesto: argomento passato a `visita`
+ *
+ * Pre-condizioni:
+ *    visita: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK, oppure SERVIZIO_ACCESSO_NEGATO se `utente` non è un cliente
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    costruisce lo storico del cliente se non è ancora stato letto dall'archivio
+ */
+EsitoServizio storico(Utente utente, VisitatorePrenotazioni visita, void *contesto);
+
+#endif // SERVIZIO_H
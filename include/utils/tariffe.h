@@ -0,0 +1,105 @@
+#ifndef TARIFFE_H
+#define TARIFFE_H
+
+#include <stddef.h>
+#include <time.h>
+#include "modelli/utente.h"
+
+/*
+ * Sconti applicati a una nuova prenotazione: premio fedeltà del cliente e
+ * fascia oraria di inizio. Il costo pieno è quello di `calcola_costo` (utils.h).
+ */
+#define MOTIVO_SCONTO 30   // Dimensione del motivo di un singolo sconto
+
+typedef enum {
+    FASCIA_NORMALE,      // Orari di punta - nessuno sconto
+    FASCIA_NOTTURNA,     // 00:00-06:00 e 22:00-23:59 - sconto per bassa domanda
+    FASCIA_MATTUTINA,    // 06:00-08:00  - sconto leggero
+} TipoFascia;
+
+/*
+ * Funzione: determina_fascia_oraria
+ * ---------------------------------
+ *
+ * Determina la fascia oraria di un timestamp
+ *
+ * Parametri:
+ *    timestamp: valore time_t rappresentante il tempo da analizzare
+ *
+ * Pre-condizioni:
+ *    timestamp: deve essere un valore valido
+ *
+ * Post-condizione:
+ *    restituisce la fascia oraria corrispondente
+ *
+ * Ritorna:
+ *    Un valore dell'enum TipoFascia
+ */
+TipoFascia determina_fascia_oraria(time_t timestamp);
+
+/*
+ * Funzione: calcola_sconto_percentuale
+ * ------------------------------------
+ *
+ * Calcola lo sconto percentuale in base alla fascia oraria
+ *
+ * Parametri:
+ *    fascia: tipo di fascia oraria
+ *
+ * Pre-condizioni:
+ *    fascia: deve essere un valore valido dell'enum TipoFascia
+ *
+ * Post-condizione:
+ *    restituisce la percentuale di sconto corrispondente
+ *
+ * Ritorna:
+ *    Un double rappresentante la percentuale di sconto (es. 0.15 per 15%)
+ */
+double calcola_sconto_percentuale(TipoFascia fascia);
+
+/*
+ * Funzione: ottieni_descrizione_fascia
+ * ------------------------------------
+ *
+ * Restituisce una descrizione testuale della fascia oraria
+ *
+ * Parametri:
+ *    fascia: tipo di fascia oraria
+ *
+ * Pre-condizioni:
+ *    fascia: deve essere un valore valido dell'enum TipoFascia
+ *
+ * Post-condizione:
+ *    restituisce la descrizione corrispondente
+ *
+ * Ritorna:
+ *    Una stringa costante costante
+ */
+const char* ottieni_descrizione_fascia(TipoFascia fascia);
+
+/*
+ * Funzione: calcola_sconto_totale
+ * -------------------------------
+ *
+ * Calcola lo sconto di una nuova prenotazione dell'utente e ne scrive il motivo: premio
+ * fedeltà del 20% ogni 5 prenotazioni più lo sconto della fascia oraria di inizio
+ *
+ * Parametri:
+ *    utente: l'utente che prenota
+ *    inizio: istante di inizio della prenotazione
+ *    motivo: stringa in cui scrivere il motivo dello sconto
+ *    dimensione_motivo: dimensione di `motivo`
+ *
+ * Pre-condizioni:
+ *    utente: non deve essere NULL
+ *    motivo: non deve essere NULL e dimensione_motivo deve essere maggiore di 0
+ *
+ * Post-condizione:
+ *    restituisce lo sconto totale; `motivo` è vuoto se non ci sono sconti
+ *
+ * Ritorna:
+ *    Un double rappresentante lo sconto (es. 0.35 per 35%)
+ */
+double calcola_sconto_totale(Utente utente, time_t inizio, char *motivo, size_t dimensione_motivo);
+
+#endif // TARIFFE_H
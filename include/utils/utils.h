@@ -7,7 +7,7 @@
 #define UTILS_H
 
 #include "modelli/byte.h"
-typedef struct tabella_hash *TabellaVeicoli;
+typedef struct tabella_veicoli *TabellaVeicoli;
 typedef struct intervallo *Intervallo;
 
 
@@ -0,0 +1,99 @@
+#ifndef VETTORE_BIT_H
+#define VETTORE_BIT_H
+
+#include <stdint.h>
+#include "modelli/byte.h"
+
+/*
+ * Operazioni su vettori di bit memorizzati in parole da 64 bit; il bit `k`
+ * è il bit `k % 64` della parola `k / 64`. Le scansioni di molte parole usano
+ * istruzioni AVX2 o SSE2 quando il compilatore le abilita (ad esempio con
+ * -mavx2 o -march=native), altrimenti un ciclo su interi a 64 bit.
+ */
+#define BIT_PER_PAROLA 64
+
+/*
+ * Funzione: imposta_bit
+ * ---------------------
+ * Imposta a 1 i bit in [da, a).
+ *
+ * Parametri:
+ *    parole: il vettore di bit
+ *    da: primo bit da impostare
+ *    a: bit successivo all'ultimo da impostare
+ *
+ * Pre-condizioni:
+ *    parole: non deve essere NULL e deve contenere il bit `a - 1`
+ *
+ * Post-condizioni:
+ *    non restituisce niente; se `da >= a` il vettore non cambia
+ *
+ * Side-effect:
+ *    modifica il vettore di bit
+ */
+void imposta_bit(uint64_t *parole, unsigned int da, unsigned int a);
+
+/*
+ * Funzione: azzera_bit
+ * --------------------
+ * Imposta a 0 i bit in [da, a).
+ *
+ * Parametri:
+ *    parole: il vettore di bit
+ *    da: primo bit da azzerare
+ *    a: bit successivo all'ultimo da azzerare
+ *
+ * Pre-condizioni:
+ *    parole: non deve essere NULL e deve contenere il bit `a - 1`
+ *
+ * Post-condizioni:
+ *    non restituisce niente; se `da >= a` il vettore non cambia
+ *
+ * Side-effect:
+ *    modifica il vettore di bit
+ */
+void azzera_bit(uint64_t *parole, unsigned int da, unsigned int a);
+
+/*
+ * Funzione: bit_impostati
+ * -----------------------
+ * Indica se almeno un bit in [da, a) è a 1.
+ *
+ * Parametri:
+ *    parole: il vettore di bit
+ *    da: primo bit da controllare
+ *    a: bit successivo all'ultimo da controllare
+ *
+ * Pre-condizioni:
+ *    parole: non deve essere NULL e deve contenere il bit `a - 1`
+ *
+ * Post-condizioni:
+ *    restituisce 1 se almeno un bit è a 1, 0 altrimenti (anche se `da >= a`)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ */
+Byte bit_impostati(const uint64_t *parole, unsigned int da, unsigned int a);
+
+/*
+ * Funzione: unisci_bit
+ * --------------------
+ * Calcola `destinazione |= sorgente` parola per parola.
+ *
+ * Parametri:
+ *    destinazione: il vettore da aggiornare
+ *    sorgente: il vettore da unire
+ *    n: numero di parole
+ *
+ * Pre-condizioni:
+ *    destinazione, sorgente: non devono essere NULL se `n` è maggiore di 0
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    modifica `destinazione`
+ */
+void unisci_bit(uint64_t *destinazione, const uint64_t *sorgente, unsigned int n);
+
+#endif //VETTORE_BIT_H
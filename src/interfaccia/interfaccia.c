@@ -17,6 +17,8 @@
 #include "strutture_dati/tabella_veicoli.h"
 #include "strutture_dati/lista.h"
 #include "strutture_dati/lista_prenotazione.h"
+#include "utils/giornale.h"
+#include "utils/gestore_prenotazioni.h"
 
 #define DIMENSIONE_STRINGA_PASSWORD (64 + 2)
 #define DIMENSIONE_INTERVALLO (16 + 2)
@@ -423,12 +425,13 @@ Utente interfaccia_accesso(TabellaUtenti tabella_utenti){
  *    Richiede l'inserimento di nome, cognome, email e password.
  *    Verifica la forza della password e chiede conferma.
  *    Se la conferma è corretta, la password viene cifrata con MD5.
- *    Viene creato un nuovo utente e aggiunto alla tabella.
+ *    Viene creato un nuovo utente, aggiunto alla tabella e registrato nel giornale.
  *    Restituisce 1 se la registrazione ha successo, 0 altrimenti.
  *
  * Parametri:
  *    tabella_utenti: struttura contenente la lista di utenti registrati
  *    permesso: livello di permesso da assegnare al nuovo utente
+ *    giornale: giornale su cui registrare il nuovo utente (può essere NULL)
  *
  * Pre-condizione:
  *    tabella_utenti deve essere inizializzata e non nullo
@@ -442,9 +445,9 @@ Utente interfaccia_accesso(TabellaUtenti tabella_utenti){
  *    un valore di tipo Byte(0, 1 o -1)
  *
  * Side-effect:
- *    Aggiunta di un nuovo utente alla tabella utenti
+ *    Aggiunta di un nuovo utente alla tabella utenti e al giornale
  */
-Byte interfaccia_registrazione(TabellaUtenti tabella_utenti, Byte permesso){
+Byte interfaccia_registrazione(TabellaUtenti tabella_utenti, Byte permesso, Giornale giornale){
     char nome[DIMENSIONE_NOME];
     char cognome[DIMENSIONE_COGNOME];
     char email[DIMENSIONE_EMAIL];
@@ -500,6 +503,7 @@ Byte interfaccia_registrazione(TabellaUtenti tabella_utenti, Byte permesso){
     utente = crea_utente(email, password_mod, nome, cognome, permesso);
 
     if(aggiungi_utente_in_tabella(tabella_utenti, utente)){
+        registra_utente_in_giornale(giornale, utente);
         return 1;
     }
 
@@ -518,6 +522,7 @@ Byte interfaccia_registrazione(TabellaUtenti tabella_utenti, Byte permesso){
  *
  * Parametri:
  *    tabella_utenti: tabella contenente gli utenti registrati
+ *    giornale: giornale su cui registrare il nuovo utente (può essere NULL)
  *
  * Pre-condizione:
  *    tabella_utenti deve essere inizializzata e non NULL
@@ -529,9 +534,9 @@ Byte interfaccia_registrazione(TabellaUtenti tabella_utenti, Byte permesso){
  *    L'utente è stato registrato (se operazione riuscita) e informato del risultato
  *    Output su console, attesa input utente, possibile modifica tabella utenti
  */
-void menu_registrazione(TabellaUtenti tabella_utenti){
+void menu_registrazione(TabellaUtenti tabella_utenti, Giornale giornale){
     stampa_header("REGISTRAZIONE");
-    Byte codice_reg = interfaccia_registrazione(tabella_utenti, CLIENTE);
+    Byte codice_reg = interfaccia_registrazione(tabella_utenti, CLIENTE, giornale);
 
     if (codice_reg == 1) {
         stampa_successo("Registrazione completata!");
@@ -762,8 +767,9 @@ static void stampa_veicolo(const Veicolo v, Intervallo i) {
  * permette all'utente di selezionare un veicolo mostrando quelli disponibili nell'intervallo specificato
  *
  * Implementazione:
- *    Recupera i veicoli disponibili nell'intervallo, li stampa in una tabella
- *    e chiede all'utente di selezionarne uno inserendo la targa.
+ *    Ottiene i veicoli disponibili nell'intervallo dall'indice di disponibilità della
+ *    flotta (`ottieni_veicoli_disponibili`), li stampa in una tabella e chiede
+ *    all'utente di selezionarne uno inserendo la targa.
  *    Conferma la scelta prima di restituire il veicolo selezionato.
  *
  * Parametri:
@@ -785,31 +791,29 @@ static void stampa_veicolo(const Veicolo v, Intervallo i) {
  *    Stampa a video, acquisizione input utente
  */
 Veicolo interfaccia_seleziona_veicolo(TabellaVeicoli tabella_veicoli, Intervallo i){
-    unsigned int dimensione;
-    Veicolo *v = ottieni_veicoli_disponibili(tabella_veicoli, i, &dimensione);
-
-    if(v == NULL){
+    if(dimensione_tabella_veicoli(tabella_veicoli) == 0){
         printf("Nessun veicolo disponibile\n");
         return NULL;
     }
     char targa[NUM_CARATTERI_TARGA];
     char scelta;
+    unsigned int numero_disponibili = 0;
+    Veicolo *disponibili = ottieni_veicoli_disponibili(tabella_veicoli, i, &numero_disponibili);
 
     printf("TABELLA VEICOLI DISPONIBILI:\n");
 
 	stampa_intestazione_tabella();
-    for (unsigned int j = 0; j < dimensione; j++) {
-        if(v[j] == NULL) continue;
-        stampa_veicolo(v[j], i);
+    for (unsigned int k = 0; disponibili != NULL && k < numero_disponibili; k++) {
+        stampa_veicolo(disponibili[k], i);
     }
     stampa_riga_separatrice();
+    free(disponibili);
 
     while(1){
         printf("Inserisci la targa del veicolo che vuoi selezionare (per uscire digita E): ");
         ottieni_parola(targa, NUM_CARATTERI_TARGA);
 
         if(uscita(targa)){
-            free(v);
             return NULL;
         }
 
@@ -824,7 +828,6 @@ Veicolo interfaccia_seleziona_veicolo(TabellaVeicoli tabella_veicoli, Intervallo
             //stdin_fflush();
 
             if(scelta == 's' || scelta == 'S'){
-                free(v);
                 return trovato;
             }
         }
@@ -832,8 +835,6 @@ Veicolo interfaccia_seleziona_veicolo(TabellaVeicoli tabella_veicoli, Intervallo
             printf("Veicolo non trovato\n");
         }
     }
-
-    free(v);
 }
 
 /*
@@ -1030,6 +1031,7 @@ static time_t fine_giornata(time_t inizio) {
  * Implementazione:
  *    Crea un ciclo interattivo che aggiorna periodicamente la visualizzazione dei veicoli
  *    disponibili, calcolando per ciascuno la disponibilità rimanente nella giornata corrente
+ *    (la tabella viene visitata con un iteratore, senza copiarne i veicoli in un vettore)
  *    e mostrando costo e durata. Permette aggiornamento manuale e uscita dal menu
  *
  * Parametri:
@@ -1049,8 +1051,9 @@ static time_t fine_giornata(time_t inizio) {
  *    allocazione e deallocazione di memoria per le stringhe temporanee
  */
 void visualizza_veicoli_disponibili(TabellaVeicoli tabella_veicoli, time_t data_riferimento) {
-    unsigned int dimensione;
     char comando;
+    IteratoreTabella it;
+    Veicolo veicolo;
 
     do {
         system("clear || cls");
@@ -1059,7 +1062,6 @@ void visualizza_veicoli_disponibili(TabellaVeicoli tabella_veicoli, time_t data_
         time_t fine_della_giornata = fine_giornata(ora_corrente_aggiornata);
         Intervallo resto_giornata = crea_intervallo(ora_corrente_aggiornata, fine_della_giornata);
 
-        Veicolo *vettore_veicoli = (Veicolo*) ottieni_vettore(tabella_veicoli, &dimensione);
         char *ultima_data = formatta_data(ora_corrente_aggiornata);
 
         printf("\n+-------------------------------------------------------------+\n");
@@ -1073,15 +1075,16 @@ void visualizza_veicoli_disponibili(TabellaVeicoli tabella_veicoli, time_t data_
         printf("----+----------------------+----------+-------------+--------------------+----------+------------------+---------------\n");
 
         int j = 0;
-        for (unsigned int i = 0; i < dimensione; i++) {
-            Intervallo disponibile = ottieni_intervallo_disponibile(ottieni_prenotazioni(vettore_veicoli[i]), resto_giornata);
+        tabella_veicoli_iter_init(&it, tabella_veicoli);
+        while ((veicolo = tabella_iter_next(&it)) != NULL) {
+            Intervallo disponibile = ottieni_intervallo_disponibile(ottieni_prenotazioni(veicolo), resto_giornata);
 
             if (disponibile != NULL) {
-                const char *modello = ottieni_modello(vettore_veicoli[i]);
-                const char *targa = ottieni_targa(vettore_veicoli[i]);
-                const char *tipo = ottieni_tipo_veicolo(vettore_veicoli[i]);
-                const char *posizione = ottieni_posizione(vettore_veicoli[i]);
-                double prezzo_min = ottieni_tariffa(vettore_veicoli[i]);
+                const char *modello = ottieni_modello(veicolo);
+                const char *targa = ottieni_targa(veicolo);
+                const char *tipo = ottieni_tipo_veicolo(veicolo);
+                const char *posizione = ottieni_posizione(veicolo);
+                double prezzo_min = ottieni_tariffa(veicolo);
 
                 char costo_str[16];
                 snprintf(costo_str, sizeof(costo_str), "%.2f EUR", calcola_costo(prezzo_min, disponibile)); // Changed to EUR for broad use
@@ -1110,9 +1113,6 @@ void visualizza_veicoli_disponibili(TabellaVeicoli tabella_veicoli, time_t data_
         }
         distruggi_intervallo(resto_giornata);
 
-        free(vettore_veicoli);
-        vettore_veicoli = NULL;
-
         printf("\n---------------------------------------------------------------\n");
         printf("Trovati/o %d veicoli disponibili.\n", j);
         printf("---------------------------------------------------------------\n\n");
@@ -1222,13 +1222,15 @@ Byte visualizza_storico(const char *email_utente, TabellaUtenti tabella_utenti,
  *
  * Implementazione:
  *    Recupera le prenotazioni attive dell'utente, le visualizza in una tabella formattata
- *    e permette all'utente di selezionarne una per la cancellazione.
+ *    e permette all'utente di selezionarne una per la cancellazione, che avviene per
+ *    identificativo con `cancella_prenotazione_per_id`.
  *    Gestisce tutti i casi edge (nessuna prenotazione, input non valido, conferma).
  *
  * Parametri:
  *    email_utente: stringa costante contenente l'email dell'utente
  *    tabella_utenti: puntatore a tabella degli utenti
  *    tabella_veicoli: puntatore a tabella dei veicoli
+ *    giornale: giornale su cui registrare le cancellazioni (può essere NULL)
  *
  * Pre-condizioni:
  *    email_utente: non deve essere NULL
@@ -1243,9 +1245,10 @@ Byte visualizza_storico(const char *email_utente, TabellaUtenti tabella_utenti,
  *
  * Side-effect:
  *    Modifica lo storico prenotazioni se l'utente cancella una prenotazione
+ *    e registra la cancellazione nel giornale
  *    Stampa a video l'interfaccia utente
  */
-Byte gestisci_le_mie_prenotazioni(const char *email_utente, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli) {
+Byte gestisci_le_mie_prenotazioni(const char *email_utente, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale) {
     Utente u = cerca_utente_in_tabella(tabella_utenti, email_utente);
     if(u == NULL) {
         return -1;
@@ -1254,7 +1257,7 @@ Byte gestisci_le_mie_prenotazioni(const char *email_utente, TabellaUtenti tabell
     time_t ora = time(NULL);
     unsigned int num_ele = ottieni_numero_prenotazioni_utente(u);
 
-    Prenotazione vettore_prenotazione[num_ele];
+    uint64_t id_prenotazioni[num_ele > 0 ? num_ele : 1];
     unsigned int id;
     ListaPre lista = NULL;
     while(1) {
@@ -1282,7 +1285,7 @@ Byte gestisci_le_mie_prenotazioni(const char *email_utente, TabellaUtenti tabell
                 const char *modello = ottieni_modello(v);
                 char *periodo = intervallo_in_stringa(i);
                 double costo = ottieni_costo_prenotazione(p);
-                vettore_prenotazione[id] = p;
+                id_prenotazioni[id] = ottieni_id_prenotazione(p);
 
                  /* STAMPA RIGA PRENOTAZIONE */
                 printf("| %2u | %-16s | %-11s | %-37s | %9.2f |\n",
@@ -1332,12 +1335,9 @@ Byte gestisci_le_mie_prenotazioni(const char *email_utente, TabellaUtenti tabell
             continue;
         }
 
-        Prenotazione p = vettore_prenotazione[scelta];
-        Veicolo v = cerca_veicolo_in_tabella(tabella_veicoli, ottieni_veicolo_prenotazione(p));
-        Byte codice = rimuovi_prenotazione_veicolo(v, ottieni_intervallo_prenotazione(p));
-        codice &= rimuovi_da_storico_utente(u, p);
         distruggi_lista_prenotazione(lista);
         lista = NULL;
+        Byte codice = cancella_prenotazione_per_id(tabella_utenti, tabella_veicoli, giornale, id_prenotazioni[scelta]);
 
         if(!codice) {
             printf("\nErrore durante la cancellazione. Premere INVIO per continuare...");
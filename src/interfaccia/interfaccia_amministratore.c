@@ -13,10 +13,15 @@
 #include "strutture_dati/tabella_utenti.h"
 #include "modelli/veicolo.h"
 #include "strutture_dati/tabella_veicoli.h"
+#include "utils/giornale.h"
 #include "utils/utils.h"
 
 static void intest_noleggi();
 static void sep_noleggi();
+static void stampa_cliente(void *valore, void *contesto);
+static void stampa_noleggi_veicolo(void *valore, void *contesto);
+static void stampa_riga_noleggio(const Prenotazione p, void *contesto);
+static void stampa_veicolo_in_elenco(void *valore, void *contesto);
 
 /*
  * Autore: Marco Visone
@@ -28,7 +33,7 @@ static void sep_noleggi();
  * per un utente specifico selezionato dalla lista degli utenti registrati
  *
  * Implementazione:
- *   La funzione recupera tutti gli utenti dalla tabella e mostra solo quelli non amministratori.
+ *   La funzione visita la tabella degli utenti con tabella_per_ogni e mostra solo quelli non amministratori.
  *   L'utente può inserire l'email di un utente per visualizzarne lo storico oppure 'E' per uscire.
  *   Se l'utente non viene trovato, viene chiesta conferma per continuare o uscire.
  *   Il ciclo continua finché l'utente non decide di uscire.
@@ -52,12 +57,10 @@ static void sep_noleggi();
  *    - Allocazione e deallocazione dinamica della memoria
  */
 Byte storico_noleggi(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli){
-    unsigned int dimensione = 0;
     char email[DIMENSIONE_EMAIL];
     char scelta;
 
-    Utente *utenti = (Utente *)ottieni_vettore(tabella_utenti, &dimensione);
-    if (utenti == NULL) {
+    if (dimensione_tabella(tabella_utenti) == 0) {
         return -1;
     }
 
@@ -65,17 +68,8 @@ Byte storico_noleggi(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicol
     printf("         UTENTI REGISTRATI              \n");
     printf("========================================\n");
 
-    unsigned j = 0;
-    for(unsigned int i = 0; i < dimensione; i++){
-        Utente u = utenti[i];
-        if(u != NULL && ottieni_permesso(u) != ADMIN){
-            char *str = utente_in_stringa(u);
-            printf("%s\n", str);
-            printf("----------------------------------------\n");
-            j++;
-            free(str);
-        }
-    }
+    unsigned int j = 0;
+    tabella_per_ogni(tabella_utenti, stampa_cliente, &j);
 
     if(j == 0){
         return -1;
@@ -101,8 +95,6 @@ Byte storico_noleggi(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicol
         }
     }
 
-    free(utenti);
-
     printf("\nUscita dal visualizzatore storico completata.\n");
     return 0;
 }
@@ -163,6 +155,143 @@ static void sep_noleggi() {
     printf("+---------------------------+---------------------------------------+------------+\n");
 }
 
+/*
+ * Funzione: stampa_cliente
+ * ------------------------
+ * Funzione da passare a tabella_per_ogni che stampa un utente se non è amministratore
+ *
+ * Implementazione:
+ *   Se l'utente non è un amministratore ne stampa la rappresentazione testuale
+ *   seguita da un separatore e incrementa il contatore passato come contesto
+ *
+ * Parametri:
+ *    - valore: l'utente da stampare
+ *    - contesto: puntatore ad un unsigned int che conta gli utenti stampati
+ *
+ * Pre-condizioni:
+ *    - contesto: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    nessuna
+ *
+ * Side-effects:
+ *    - Output formattato su console
+ *    - Incrementa il contatore puntato da contesto
+ */
+static void stampa_cliente(void *valore, void *contesto) {
+    Utente u = valore;
+    unsigned int *stampati = contesto;
+
+    if (u == NULL || ottieni_permesso(u) == ADMIN) return;
+
+    char *str = utente_in_stringa(u);
+    printf("%s\n", str);
+    printf("----------------------------------------\n");
+    (*stampati)++;
+    free(str);
+}
+
+/*
+ * Funzione: stampa_noleggi_veicolo
+ * --------------------------------
+ * Funzione da passare a tabella_veicoli_per_ogni che stampa un veicolo e le sue prenotazioni
+ *
+ * Implementazione:
+ *   Stampa targa e modello del veicolo. Se il veicolo ha prenotazioni, le visualizza
+ *   in ordine cronologico in una tabella con cliente, periodo e costo visitando
+ *   l'albero senza copiarle, altrimenti stampa un messaggio appropriato
+ *
+ * Parametri:
+ *    - valore: il veicolo da stampare
+ *    - contesto: non usato
+ *
+ * Pre-condizioni:
+ *    - valore: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    nessuna
+ *
+ * Side-effects:
+ *    - Output formattato su console
+ */
+static void stampa_noleggi_veicolo(void *valore, void *contesto) {
+    (void)contesto;
+    Veicolo v = valore;
+
+    printf("\nVeicolo: %s  —  %s\n", ottieni_targa(v), ottieni_modello(v));
+
+    Prenotazioni pre = ottieni_prenotazioni(v);
+
+    if (dimensione_prenotazioni(pre) > 0) {
+        intest_noleggi();
+        visita_prenotazioni_in_ordine(pre, stampa_riga_noleggio, NULL);
+        sep_noleggi();
+    }
+    else {
+        printf("  (Nessuna prenotazione per questo veicolo)\n");
+    }
+}
+
+/*
+ * Funzione: stampa_riga_noleggio
+ * ------------------------------
+ * Funzione da passare a visita_prenotazioni_in_ordine che stampa una riga
+ * della tabella dei noleggi
+ *
+ * Implementazione:
+ *   Stampa cliente, periodo e costo della prenotazione nel formato di intest_noleggi
+ *
+ * Parametri:
+ *    - p: la prenotazione da stampare (in prestito dall'albero)
+ *    - contesto: non usato
+ *
+ * Pre-condizioni:
+ *    - p: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    nessuna
+ *
+ * Side-effects:
+ *    - Output formattato su console
+ */
+static void stampa_riga_noleggio(const Prenotazione p, void *contesto) {
+    (void)contesto;
+    const char *cliente = ottieni_cliente_prenotazione(p);
+    char *periodo = intervallo_in_stringa(ottieni_intervallo_prenotazione(p));
+    double costo = ottieni_costo_prenotazione(p);
+    printf("| %-25s | %-37s | %10.2f |\n",
+           cliente, periodo, costo);
+    free(periodo);
+}
+
+/*
+ * Funzione: stampa_veicolo_in_elenco
+ * ----------------------------------
+ * Funzione da passare a tabella_veicoli_per_ogni che stampa un veicolo seguito da un separatore
+ *
+ * Parametri:
+ *    - valore: il veicolo da stampare
+ *    - contesto: non usato
+ *
+ * Pre-condizioni:
+ *    - valore: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    nessuna
+ *
+ * Side-effects:
+ *    - Output formattato su console
+ */
+static void stampa_veicolo_in_elenco(void *valore, void *contesto) {
+    (void)contesto;
+    char *str = veicolo_in_stringa(valore);
+    if (str) {
+        printf("%s\n", str);
+        free(str);
+        printf("----------------------------------------\n");
+    }
+}
+
 /*
  * Autore: Marco Visone
  * Data: 26/05/2025
@@ -172,7 +301,7 @@ static void sep_noleggi() {
  * Visualizza tutti i veicoli e le relative prenotazioni in formato tabellare
  *
  * Implementazione:
- *   Per ogni veicolo nella tabella, mostra targa e modello.
+ *   Visita la tabella con tabella_veicoli_per_ogni e, per ogni veicolo, mostra targa e modello.
  *   Se il veicolo ha prenotazioni, le visualizza in una tabella formattata
  *   con cliente, periodo e costo. Se non ha prenotazioni, mostra un messaggio appropriato.
  *
@@ -194,40 +323,9 @@ static void sep_noleggi() {
  */
 Byte gestione_noleggi(TabellaVeicoli tabella_veicoli) {
     if (!tabella_veicoli) return -1;
-    unsigned int nv = 0;
-    Veicolo *vettore = (Veicolo*) ottieni_vettore(tabella_veicoli, &nv);
-    if (!vettore) return -1;
-
-    for (unsigned int i = 0; i < nv; i++) {
-        const char *targa   = ottieni_targa(vettore[i]);
-        const char *modello = ottieni_modello(vettore[i]);
-        printf("\nVeicolo: %s  —  %s\n", targa, modello);
-
-        Prenotazioni pre = ottieni_prenotazioni(vettore[i]);
-        unsigned int np = 0;
-        Prenotazione *p = pre? ottieni_vettore_prenotazioni_ordinate(pre, &np): NULL;
-
-        if (p && np > 0) {
-            intest_noleggi();
-            for (unsigned int j = 0; j < np; j++) {
-                const char *cliente = ottieni_cliente_prenotazione(p[j]);
-                char *periodo = intervallo_in_stringa(ottieni_intervallo_prenotazione(p[j]));
-                double costo = ottieni_costo_prenotazione(p[j]);
-                printf("| %-25s | %-37s | %10.2f |\n",
-                       cliente, periodo, costo);
-                free(periodo);
-                distruggi_prenotazione(p[j]);
-            }
-            sep_noleggi();
-        }
-        else {
-            printf("  (Nessuna prenotazione per questo veicolo)\n");
-        }
-        if (p){
-            free(p);
-        }
-    }
-    free(vettore);
+    if (dimensione_tabella_veicoli(tabella_veicoli) == 0) return -1;
+
+    tabella_veicoli_per_ogni(tabella_veicoli, stampa_noleggi_veicolo, NULL);
     return 1;
 }
 
@@ -345,6 +443,7 @@ Veicolo interfaccia_aggiungi_veicolo(TabellaVeicoli tabella_veicoli){
  *
  * Parametri:
  *    - tabella_veicoli: la tabella veicoli
+ *    - giornale: giornale su cui registrare la rimozione (può essere NULL)
  *
  * Pre-condizioni:
  *    tabella_veicoli: non deve essere NULL
@@ -358,16 +457,15 @@ Veicolo interfaccia_aggiungi_veicolo(TabellaVeicoli tabella_veicoli){
  * Side-effects:
  *    - Input/output su console
  *    - Allocazione e deallocazione dinamica della memoria
- *    - Il veicolo selezionato, se presente e confermato, viene rimosso dalla tabella.
+ *    - Il veicolo selezionato, se presente e confermato, viene rimosso dalla tabella
+ *    e la rimozione viene registrata nel giornale.
  */
-Byte interfaccia_rimuovi_veicolo(TabellaVeicoli tabella_veicoli){
-	unsigned int dimensione;
+Byte interfaccia_rimuovi_veicolo(TabellaVeicoli tabella_veicoli, Giornale giornale){
     char targa[NUM_CARATTERI_TARGA];
 	char scelta;
 
 	do{
-	    Veicolo *vettore_veicoli = (Veicolo*) ottieni_vettore(tabella_veicoli, &dimensione);
-		if(vettore_veicoli == NULL){
+		if(dimensione_tabella_veicoli(tabella_veicoli) == 0){
 			printf("Nessun veicolo presente\n");
 			return 0;
 		}
@@ -378,20 +476,12 @@ Byte interfaccia_rimuovi_veicolo(TabellaVeicoli tabella_veicoli){
         printf("         TABELLA VEICOLI DISPONIBILI    \n");
         printf("========================================\n");
 
-		for(unsigned int i = 0; i < dimensione; i++){
-			char *str = veicolo_in_stringa(vettore_veicoli[i]);
-			if (str) {
-                printf("%s\n", str);
-                free(str);
-                printf("----------------------------------------\n");
-            }
-		}
+		tabella_veicoli_per_ogni(tabella_veicoli, stampa_veicolo_in_elenco, NULL);
 
 		printf("Inserisci la targa del veicolo che vuoi eliminare (per uscire digita E): ");
         ottieni_parola(targa, NUM_CARATTERI_TARGA);
 
 		 if (strcmp(targa, "E") == 0 || strcmp(targa, "e") == 0) {
-            free(vettore_veicoli);
             return 0;
         }
 
@@ -404,12 +494,13 @@ Byte interfaccia_rimuovi_veicolo(TabellaVeicoli tabella_veicoli){
 
 			if(rim == 0) printf("\nErrore durante la rimozione del veicolo\n");
 
-			else printf("\nVeicolo eliminato correttamente\n");
+			else {
+				registra_rimozione_veicolo_in_giornale(giornale, targa);
+				printf("\nVeicolo eliminato correttamente\n");
+			}
 
 			printf("Premi INVIO per continuare...");
             getchar();
 		}
-
-		free(vettore_veicoli);
 	}while(1);
 }
@@ -0,0 +1,527 @@
+#ifdef __linux__
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "interfaccia/server.h"
+#include "modelli/byte.h"
+#include "modelli/utente.h"
+#include "utils/comandi.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#define EVENTI_PER_ATTESA 256
+#define LETTURE_PER_EVENTO 16          // Un client che invia molto non blocca gli altri
+#define LIMITE_USCITA (1 << 20)        // Byte in attesa di invio oltre i quali non si leggono altri comandi
+#define CAPACITA_USCITA_INIZIALE 4096
+#define CAPACITA_USCITA_TRATTENUTA (64 * 1024)   // Oltre, il buffer svuotato viene liberato
+
+static volatile sig_atomic_t segnale_ricevuto = 0;
+
+// Stato di un client collegato
+struct connessione {
+    int fd;
+    Utente sessione;                   // Utente che ha eseguito `accedi` su questa connessione
+    char riga[GRANDEZZA_RIGA_COMANDO];
+    size_t lunghezza;                  // Byte letti della riga corrente
+    Byte scarta;                       // La riga corrente è troppo lunga: viene scartata fino all'a capo
+    Byte chiusa_in_lettura;            // Il client non invierà altri comandi
+    char *uscita;                      // Esiti da inviare, da `inviati` a `dimensione_uscita`
+    size_t dimensione_uscita;
+    size_t inviati;
+    size_t capacita_uscita;
+    uint32_t eventi;                   // Eventi registrati in epoll
+    struct connessione *precedente;
+    struct connessione *successiva;
+};
+
+struct server {
+    int epoll;
+    int ascolto;
+    Byte ascolto_sospeso;              // Descrittori esauriti: nuove connessioni rimandate
+    struct connessione *connessioni;
+    unsigned long connessioni_aperte;
+    unsigned long connessioni_totali;
+    unsigned long comandi;
+    unsigned long errori;
+    TabellaUtenti tabella_utenti;
+    TabellaVeicoli tabella_veicoli;
+    Giornale giornale;
+    ManutenzioneServer manutenzione;
+};
+
+/*
+ * Funzione: ferma_server
+ * ----------------------
+ * Gestore di SIGINT e SIGTERM: chiede al ciclo degli eventi di terminare.
+ */
+static void ferma_server(int segnale){
+    (void)segnale;
+    segnale_ricevuto = 1;
+}
+
+/*
+ * Funzione: imposta_non_bloccante
+ * -------------------------------
+ * Rende non bloccante il descrittore `fd`; restituisce 1 in caso di successo.
+ */
+static Byte imposta_non_bloccante(int fd){
+    int flag = fcntl(fd, F_GETFL, 0);
+    return flag >= 0 && fcntl(fd, F_SETFL, flag | O_NONBLOCK) == 0;
+}
+
+/*
+ * Funzione: aumenta_limite_descrittori
+ * ------------------------------------
+ * Porta il limite di descrittori aperti al massimo consentito, così il server
+ * può tenere migliaia di connessioni.
+ */
+static void aumenta_limite_descrittori(void){
+    struct rlimit limite;
+    if(getrlimit(RLIMIT_NOFILE, &limite) != 0 || limite.rlim_cur == limite.rlim_max) return;
+
+    limite.rlim_cur = limite.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limite);
+}
+
+/*
+ * Funzione: crea_socket_ascolto
+ * -----------------------------
+ * Crea il socket di dominio Unix non bloccante in ascolto su `percorso`, sostituendo
+ * un socket rimasto da un'esecuzione precedente; restituisce -1 in caso di errore.
+ */
+static int crea_socket_ascolto(const char *percorso){
+    struct sockaddr_un indirizzo;
+    struct stat informazioni;
+
+    if(strlen(percorso) >= sizeof(indirizzo.sun_path)){
+        fprintf(stderr, "Percorso del socket troppo lungo: %s\n", percorso);
+        return -1;
+    }
+    memset(&indirizzo, 0, sizeof(indirizzo));
+    indirizzo.sun_family = AF_UNIX;
+    strcpy(indirizzo.sun_path, percorso);
+
+    // Solo un socket può essere rimosso: un file qualsiasi con lo stesso nome resta intatto
+    if(stat(percorso, &informazioni) == 0 && S_ISSOCK(informazioni.st_mode)) unlink(percorso);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0){
+        perror("socket");
+        return -1;
+    }
+    if(bind(fd, (struct sockaddr *)&indirizzo, sizeof(indirizzo)) != 0 || listen(fd, SOMAXCONN) != 0
+       || !imposta_non_bloccante(fd)){
+        perror(percorso);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/*
+ * Funzione: uscita_in_attesa
+ * --------------------------
+ * Restituisce il numero di byte di esiti non ancora inviati al client.
+ */
+static size_t uscita_in_attesa(const struct connessione *c){
+    return c->dimensione_uscita - c->inviati;
+}
+
+/*
+ * Funzione: accoda_uscita
+ * -----------------------
+ * Aggiunge `dimensione` byte agli esiti da inviare al client.
+ *
+ * Implementazione:
+ *    Prima di ingrandire il buffer sposta in testa i byte non ancora inviati;
+ *    la capacità raddoppia finché non basta.
+ */
+static Byte accoda_uscita(struct connessione *c, const char *dati, size_t dimensione){
+    if(c->dimensione_uscita + dimensione > c->capacita_uscita){
+        size_t in_attesa = uscita_in_attesa(c);
+        if(in_attesa > 0) memmove(c->uscita, c->uscita + c->inviati, in_attesa);
+        c->dimensione_uscita = in_attesa;
+        c->inviati = 0;
+    }
+    if(c->dimensione_uscita + dimensione > c->capacita_uscita){
+        size_t capacita = c->capacita_uscita > 0 ? c->capacita_uscita : CAPACITA_USCITA_INIZIALE;
+        while(capacita < c->dimensione_uscita + dimensione) capacita *= 2;
+
+        char *uscita = realloc(c->uscita, capacita);
+        if(uscita == NULL) return 0;
+        c->uscita = uscita;
+        c->capacita_uscita = capacita;
+    }
+    memcpy(c->uscita + c->dimensione_uscita, dati, dimensione);
+    c->dimensione_uscita += dimensione;
+    return 1;
+}
+
+/*
+ * Funzione: invia_uscita
+ * ----------------------
+ * Invia al client gli esiti in attesa finché il socket li accetta; restituisce 0
+ * se la connessione non è più utilizzabile.
+ */
+static Byte invia_uscita(struct connessione *c){
+    while(uscita_in_attesa(c) > 0){
+        ssize_t inviati = send(c->fd, c->uscita + c->inviati, uscita_in_attesa(c), MSG_NOSIGNAL);
+        if(inviati < 0){
+            if(errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        c->inviati += (size_t)inviati;
+    }
+
+    c->inviati = c->dimensione_uscita = 0;
+    if(c->capacita_uscita > CAPACITA_USCITA_TRATTENUTA){
+        free(c->uscita);
+        c->uscita = NULL;
+        c->capacita_uscita = 0;
+    }
+    return 1;
+}
+
+/*
+ * Funzione: esegui_riga
+ * ---------------------
+ * Esegue un comando del client con `esegui_comando` e ne accoda l'esito.
+ *
+ * Implementazione:
+ *    L'esito viene scritto in un file in memoria (open_memstream), così il
+ *    protocollo è lo stesso della modalità batch; le righe vuote e i commenti
+ *    vengono ignorati come nei file batch.
+ */
+static Byte esegui_riga(struct server *s, struct connessione *c, char *riga){
+    char *esito = NULL;
+    size_t dimensione = 0;
+
+    riga[strcspn(riga, "\r")] = '\0';
+    if(riga[0] == '\0' || riga[0] == '#') return 1;
+
+    FILE *uscita = open_memstream(&esito, &dimensione);
+    if(uscita == NULL) return 0;
+    s->errori += !esegui_comando(riga, &c->sessione, uscita, s->tabella_utenti, s->tabella_veicoli, s->giornale);
+    s->comandi++;
+    Byte accodato = fclose(uscita) == 0 && accoda_uscita(c, esito, dimensione);
+    free(esito);
+
+    if(s->manutenzione != NULL) s->manutenzione(s->giornale, s->tabella_utenti, s->tabella_veicoli);
+    return accodato;
+}
+
+/*
+ * Funzione: esegui_righe
+ * ----------------------
+ * Esegue le righe complete ricevute dal client e conserva l'eventuale riga parziale.
+ */
+static Byte esegui_righe(struct server *s, struct connessione *c){
+    char *inizio = c->riga;
+    char *fine = c->riga + c->lunghezza;
+    char *a_capo;
+
+    while((a_capo = memchr(inizio, '\n', (size_t)(fine - inizio))) != NULL){
+        *a_capo = '\0';
+        if(c->scarta) c->scarta = 0;
+        else if(!esegui_riga(s, c, inizio)) return 0;
+        inizio = a_capo + 1;
+    }
+
+    // Senza a capo i byte di una riga troppo lunga non servono
+    c->lunghezza = c->scarta ? 0 : (size_t)(fine - inizio);
+    memmove(c->riga, inizio, c->lunghezza);
+    return 1;
+}
+
+/*
+ * Funzione: leggi_connessione
+ * ---------------------------
+ * Legge ed esegue i comandi disponibili sul socket del client; restituisce 0 se
+ * la connessione va chiusa.
+ *
+ * Implementazione:
+ *    Legge al più LETTURE_PER_EVENTO volte e si ferma quando gli esiti in attesa
+ *    superano LIMITE_USCITA: con epoll in modalità a livello i dati rimasti vengono
+ *    segnalati di nuovo al giro successivo. Una riga che non entra nel buffer produce
+ *    un errore e viene scartata fino all'a capo. L'ultima riga senza a capo viene
+ *    eseguita quando il client chiude il suo lato della connessione.
+ */
+static Byte leggi_connessione(struct server *s, struct connessione *c){
+    for(unsigned int letture = 0; letture < LETTURE_PER_EVENTO && uscita_in_attesa(c) < LIMITE_USCITA; letture++){
+        if(c->lunghezza == GRANDEZZA_RIGA_COMANDO - 1){
+            const char errore[] = "ERRORE;?;riga troppo lunga\n";
+            if(!accoda_uscita(c, errore, sizeof(errore) - 1)) return 0;
+            s->comandi++;
+            s->errori++;
+            c->scarta = 1;
+            c->lunghezza = 0;
+        }
+
+        ssize_t letti = read(c->fd, c->riga + c->lunghezza, GRANDEZZA_RIGA_COMANDO - 1 - c->lunghezza);
+        if(letti < 0){
+            if(errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        if(letti == 0){
+            c->chiusa_in_lettura = 1;
+            c->riga[c->lunghezza] = '\0';
+            Byte esito = c->scarta || esegui_riga(s, c, c->riga);
+            c->lunghezza = 0;
+            return esito;
+        }
+
+        c->lunghezza += (size_t)letti;
+        if(!esegui_righe(s, c)) return 0;
+    }
+    return 1;
+}
+
+/*
+ * Funzione: chiudi_connessione
+ * ----------------------------
+ * Chiude la connessione, la toglie dall'elenco e libera la memoria; se le nuove
+ * connessioni erano sospese per mancanza di descrittori le riattiva.
+ */
+static void chiudi_connessione(struct server *s, struct connessione *c){
+    epoll_ctl(s->epoll, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+
+    if(c->precedente != NULL) c->precedente->successiva = c->successiva;
+    else s->connessioni = c->successiva;
+    if(c->successiva != NULL) c->successiva->precedente = c->precedente;
+    s->connessioni_aperte--;
+
+    free(c->uscita);
+    free(c);
+
+    if(s->ascolto_sospeso){
+        struct epoll_event evento = { .events = EPOLLIN, .data.ptr = NULL };
+        if(epoll_ctl(s->epoll, EPOLL_CTL_MOD, s->ascolto, &evento) == 0) s->ascolto_sospeso = 0;
+    }
+}
+
+/*
+ * Funzione: aggiorna_eventi
+ * -------------------------
+ * Registra in epoll gli eventi che interessano la connessione nel suo stato attuale:
+ * lettura finché il client invia e gli esiti in attesa sono pochi, scrittura finché
+ * ci sono esiti da inviare. Chiude la connessione quando non resta niente da fare.
+ */
+static void aggiorna_eventi(struct server *s, struct connessione *c){
+    uint32_t eventi = 0;
+
+    if(!c->chiusa_in_lettura && uscita_in_attesa(c) < LIMITE_USCITA) eventi |= EPOLLIN;
+    if(uscita_in_attesa(c) > 0) eventi |= EPOLLOUT;
+    if(eventi == 0){
+        chiudi_connessione(s, c);
+        return;
+    }
+    if(eventi == c->eventi) return;
+
+    struct epoll_event evento = { .events = eventi, .data.ptr = c };
+    if(epoll_ctl(s->epoll, EPOLL_CTL_MOD, c->fd, &evento) != 0){
+        chiudi_connessione(s, c);
+        return;
+    }
+    c->eventi = eventi;
+}
+
+/*
+ * Funzione: gestisci_connessione
+ * ------------------------------
+ * Risponde agli eventi epoll di un client: legge ed esegue i comandi, invia gli esiti.
+ */
+static void gestisci_connessione(struct server *s, struct connessione *c, uint32_t eventi){
+    Byte valida = !(eventi & EPOLLERR);
+
+    if(valida && !c->chiusa_in_lettura && (eventi & (EPOLLIN | EPOLLHUP)))
+        valida = leggi_connessione(s, c);
+    // Gli esiti vengono inviati subito: EPOLLOUT serve solo se il socket è pieno
+    if(valida) valida = invia_uscita(c);
+
+    if(!valida) chiudi_connessione(s, c);
+    else aggiorna_eventi(s, c);
+}
+
+/*
+ * Funzione: accetta_connessioni
+ * -----------------------------
+ * Accetta tutte le connessioni in attesa sul socket di ascolto.
+ *
+ * Implementazione:
+ *    Se i descrittori sono esauriti il socket di ascolto viene tolto dagli eventi,
+ *    altrimenti epoll continuerebbe a segnalarlo; `chiudi_connessione` lo riattiva.
+ */
+static void accetta_connessioni(struct server *s){
+    for(;;){
+        int fd = accept(s->ascolto, NULL, NULL);
+        if(fd < 0){
+            if(errno == EINTR || errno == ECONNABORTED) continue;
+            if(errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM){
+                struct epoll_event evento = { .events = 0, .data.ptr = NULL };
+                if(s->connessioni_aperte > 0 && epoll_ctl(s->epoll, EPOLL_CTL_MOD, s->ascolto, &evento) == 0)
+                    s->ascolto_sospeso = 1;
+                fprintf(stderr, "Connessioni rimandate: %s\n", strerror(errno));
+            }
+            return;
+        }
+
+        struct connessione *c = calloc(1, sizeof(struct connessione));
+        struct epoll_event evento = { .events = EPOLLIN, .data.ptr = c };
+        if(c == NULL || !imposta_non_bloccante(fd) || epoll_ctl(s->epoll, EPOLL_CTL_ADD, fd, &evento) != 0){
+            free(c);
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        c->eventi = EPOLLIN;
+        c->successiva = s->connessioni;
+        if(s->connessioni != NULL) s->connessioni->precedente = c;
+        s->connessioni = c;
+        s->connessioni_aperte++;
+        s->connessioni_totali++;
+    }
+}
+
+/*
+ * Funzione: esegui_server
+ * -----------------------
+ *
+ * Accetta connessioni sul socket `percorso` ed esegue i comandi dei client finché
+ * il processo non riceve SIGINT o SIGTERM
+ *
+ * Implementazione:
+ *    - Un solo thread con un ciclo di eventi epoll (modalità a livello) su socket non
+ *      bloccanti: i comandi vengono eseguiti uno alla volta, quindi le tabelle e il
+ *      giornale non hanno bisogno di sincronizzazione
+ *    - Ogni connessione ha la propria sessione, il proprio buffer di lettura e quello
+ *      degli esiti da inviare; un client che non legge gli esiti smette di essere letto
+ *      finché non li ha ricevuti
+ *    - SIGINT e SIGTERM restano bloccati fuori da epoll_pwait, così un segnale non può
+ *      andare perso tra il controllo di `segnale_ricevuto` e l'attesa
+ *    - Al termine chiude le connessioni, rimuove il socket e ripristina i segnali
+ *
+ * Parametri:
+ *    percorso: percorso del socket da creare
+ *    tabella_utenti: tabella hash degli utenti
+ *    tabella_veicoli: tabella hash dei veicoli
+ *    giornale: giornale su cui registrare le modifiche (può essere NULL)
+ *    manutenzione: funzione chiamata dopo ogni comando (può essere NULL)
+ *
+ * Pre-condizioni:
+ *    percorso: non deve essere NULL
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce 1 se il server è stato fermato da un segnale, 0 se non è stato
+ *    possibile avviarlo
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    crea e rimuove il file del socket, modifica le tabelle e il giornale,
+ *    scrive su stderr il riepilogo delle connessioni e dei comandi
+ */
+Byte esegui_server(const char *percorso, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale,
+                   ManutenzioneServer manutenzione){
+    struct server s = { .epoll = -1, .ascolto = -1, .tabella_utenti = tabella_utenti,
+                        .tabella_veicoli = tabella_veicoli, .giornale = giornale, .manutenzione = manutenzione };
+    struct epoll_event eventi[EVENTI_PER_ATTESA];
+    struct sigaction azione, vecchio_int, vecchio_term;
+    sigset_t bloccati, maschera_attesa;
+    struct timespec inizio, fine;
+
+    aumenta_limite_descrittori();
+    s.ascolto = crea_socket_ascolto(percorso);
+    if(s.ascolto < 0) return 0;
+
+    s.epoll = epoll_create1(0);
+    struct epoll_event evento = { .events = EPOLLIN, .data.ptr = NULL };
+    if(s.epoll < 0 || epoll_ctl(s.epoll, EPOLL_CTL_ADD, s.ascolto, &evento) != 0){
+        perror("epoll");
+        if(s.epoll >= 0) close(s.epoll);
+        close(s.ascolto);
+        unlink(percorso);
+        return 0;
+    }
+
+    memset(&azione, 0, sizeof(azione));
+    azione.sa_handler = ferma_server;
+    sigemptyset(&azione.sa_mask);
+    sigaction(SIGINT, &azione, &vecchio_int);
+    sigaction(SIGTERM, &azione, &vecchio_term);
+    sigemptyset(&bloccati);
+    sigaddset(&bloccati, SIGINT);
+    sigaddset(&bloccati, SIGTERM);
+    sigprocmask(SIG_BLOCK, &bloccati, &maschera_attesa);
+    sigdelset(&maschera_attesa, SIGINT);
+    sigdelset(&maschera_attesa, SIGTERM);
+
+    fprintf(stderr, "Server in ascolto su %s\n", percorso);
+    clock_gettime(CLOCK_MONOTONIC, &inizio);
+    segnale_ricevuto = 0;
+    while(!segnale_ricevuto){
+        int num_eventi = epoll_pwait(s.epoll, eventi, EVENTI_PER_ATTESA, -1, &maschera_attesa);
+        if(num_eventi < 0){
+            if(errno == EINTR) continue;
+            perror("epoll_pwait");
+            break;
+        }
+
+        for(int i = 0; i < num_eventi; i++){
+            if(eventi[i].data.ptr == NULL) accetta_connessioni(&s);
+            else gestisci_connessione(&s, eventi[i].data.ptr, eventi[i].events);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fine);
+
+    while(s.connessioni != NULL) chiudi_connessione(&s, s.connessioni);
+    close(s.epoll);
+    close(s.ascolto);
+    unlink(percorso);
+
+    sigprocmask(SIG_UNBLOCK, &bloccati, NULL);
+    sigaction(SIGINT, &vecchio_int, NULL);
+    sigaction(SIGTERM, &vecchio_term, NULL);
+
+    double secondi = (double)(fine.tv_sec - inizio.tv_sec) + (fine.tv_nsec - inizio.tv_nsec) / 1e9;
+    fprintf(stderr, "connessioni;comandi;errori;secondi;comandi_al_secondo\n%lu;%lu;%lu;%.3f;%.0f\n",
+            s.connessioni_totali, s.comandi, s.errori, secondi, secondi > 0 ? s.comandi / secondi : 0.0);
+    return 1;
+}
+
+#else
+
+/*
+ * Funzione: esegui_server
+ * -----------------------
+ * Il server usa epoll e socket di dominio Unix: su questo sistema non è disponibile.
+ */
+Byte esegui_server(const char *percorso, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale,
+                   ManutenzioneServer manutenzione){
+    (void)percorso;
+    (void)tabella_utenti;
+    (void)tabella_veicoli;
+    (void)giornale;
+    (void)manutenzione;
+    fprintf(stderr, "Server non disponibile su questo sistema.\n");
+    return 0;
+}
+
+#endif
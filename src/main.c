@@ -1,3 +1,5 @@
+#define _POSIX_C_SOURCE 199309L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -5,6 +7,7 @@
 
 #include "interfaccia/interfaccia.h"
 #include "interfaccia/interfaccia_amministratore.h"
+#include "interfaccia/server.h"
 #include "modelli/byte.h"
 #include "modelli/data.h"
 #include "modelli/intervallo.h"
@@ -16,21 +19,46 @@
 #include "strutture_dati/tabella_utenti.h"
 #include "strutture_dati/tabella_veicoli.h"
 #include "utils/md5.h"
+#include "utils/comandi.h"
 #include "utils/utils.h"
 #include "utils/gestore_file.h"
+#include "utils/gestore_prenotazioni.h"
+#include "utils/giornale.h"
+#include "utils/servizio.h"
+#include "utils/tariffe.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #define TABELLA_GRANDEZZA 20
-#define MOTIVO_SCONTO 30
 #define FILE_UTENTI "archivio/utenti.bin"
 #define FILE_DATI_UTENTI "archivio/dati_utenti.bin"
 #define FILE_VEICOLI "archivio/veicoli.bin"
 #define FILE_PRENOTAZIONI_VEICOLI "archivio/prenotazioni_veicoli.bin"
-
-typedef enum {
-    FASCIA_NORMALE,      // Orari di punta - nessuno sconto
-    FASCIA_NOTTURNA,     // 00:00-06:00 e 22:00-23:59 - sconto per bassa domanda
-    FASCIA_MATTUTINA,    // 06:00-08:00  - sconto leggero
-} TipoFascia;
+#define FILE_GIORNALE "archivio/giornale.bin"
+#define ESTENSIONE_TEMPORANEA ".tmp"
+#define SOGLIA_COMPATTAZIONE 512   // Record del giornale oltre i quali l'istantanea viene riscritta
+#define INTERVALLO_COMPATTAZIONE 5  // Secondi minimi tra l'avvio di due compattazioni
+#define OPZIONE_BATCH "--batch"
+#define OPZIONE_SERVER "--server"
+
+// File dell'archivio e temporanei in cui viene scritta la nuova istantanea, nello stesso ordine
+static const char *file_archivio[] = {FILE_UTENTI, FILE_DATI_UTENTI, FILE_VEICOLI, FILE_PRENOTAZIONI_VEICOLI};
+static const char *file_temporanei[] = {FILE_UTENTI ESTENSIONE_TEMPORANEA, FILE_DATI_UTENTI ESTENSIONE_TEMPORANEA,
+                                        FILE_VEICOLI ESTENSIONE_TEMPORANEA, FILE_PRENOTAZIONI_VEICOLI ESTENSIONE_TEMPORANEA};
+#define NUMERO_FILE_ARCHIVIO (sizeof(file_archivio) / sizeof(file_archivio[0]))
+
+// Istante (secondi di CLOCK_MONOTONIC) in cui è stata avviata l'ultima compattazione
+static time_t ultima_compattazione = -INTERVALLO_COMPATTAZIONE;
+
+#ifndef _WIN32
+// Processo che sta salvando l'istantanea, 0 se nessuna compattazione è in corso
+static pid_t compattazione_in_corso = 0;
+#endif
 
 // Dichiarazioni delle funzioni di utilità per il main
 /*
@@ -54,147 +82,6 @@ typedef enum {
  */
 void invio();
 
-/*
- * Funzione: carica_tabella_utenti
- * -------------------------------
- *
- * Carica una tabella hash di utenti da file
- *
- * Implementazione:
- *    - Tenta di caricare un vettore di utenti dai file specificati
- *    - Se il caricamento fallisce, crea una tabella vuota
- *    - Calcola una dimensione appropriata per la tabella
- *    - Inserisce tutti gli utenti caricati nella tabella
- *    - Libera la memoria del vettore temporaneo
- *
- * Parametri:
- *    grandezza: dimensione minima della tabella hash
- *    file_utente: percorso del file contenente i dati degli utenti
- *    file_dati: percorso del file contenente i dati aggiuntivi degli utenti
- *
- * Pre-condizioni:
- *    file_utente: non deve essere NULL
- *    file_dati: non deve essere NULL
- *
- * Post-condizione:
- *    restituisce una tabella hash contenente gli utenti caricati
- *    oppure una tabella vuota se il caricamento fallisce
- *
- * Ritorna:
- *    Una tabella hash di utenti (TabellaUtenti) oppure NULL in caso di errore
- *
- * Side-effect:
- *    alloca memoria per la tabella hash e per gli utenti
- */
-TabellaUtenti carica_tabella_utenti(unsigned int grandezza, const char *file_utente, const char *file_dati);
-
-/*
- * Funzione: carica_tabella_veicoli
- * --------------------------------
- *
- * Carica una tabella hash di veicoli da file
- *
- * Implementazione:
- *    - Tenta di caricare un vettore di veicoli dai file specificati
- *    - Se il caricamento fallisce, crea una tabella vuota
- *    - Calcola una dimensione appropriata per la tabella
- *    - Inserisce tutti i veicoli caricati nella tabella
- *    - Libera la memoria del vettore temporaneo
- *
- * Parametri:
- *    grandezza: dimensione minima della tabella hash
- *    file_veicolo: percorso del file contenente i dati dei veicoli
- *    file_prenotazioni: percorso del file contenente le prenotazioni
- *
- * Pre-condizioni:
- *    file_veicolo: non deve essere NULL
- *    file_prenotazioni: non deve essere NULL
- *
- * Post-condizione:
- *    restituisce una tabella hash contenente i veicoli caricati
- *    oppure una tabella vuota se il caricamento fallisce
- *
- * Ritorna:
- *    Una tabella hash di veicoli (TabellaVeicoli) oppure NULL in caso di errore
- *
- * Side-effect:
- *    alloca memoria per la tabella hash e per i veicoli
- */
-TabellaVeicoli carica_tabella_veicoli(unsigned int grandezza, const char *file_veicolo, const char *file_prenotazioni);
-
-/*
- * Funzione: determina_fascia_oraria
- * ---------------------------------
- *
- * Determina la fascia oraria di un timestamp
- *
- * Implementazione:
- *    - Analizza l'ora e il giorno della settimana
- *    - Classifica il timestamp in una delle fasce disponibili
- *    - Gestisce eventuali errori nella conversione del tempo
- *
- * Parametri:
- *    timestamp: valore time_t rappresentante il tempo da analizzare
- *
- * Pre-condizioni:
- *    timestamp: deve essere un valore valido
- *
- * Post-condizione:
- *    restituisce la fascia oraria corrispondente
- *
- * Ritorna:
- *    Un valore dell'enum TipoFascia
- */
-TipoFascia determina_fascia_oraria(time_t timestamp);
-
-/*
- * Funzione: calcola_sconto_percentuale
- * ------------------------------------
- *
- * Calcola lo sconto percentuale in base alla fascia oraria
- *
- * Implementazione:
- *    - Utilizza uno switch per selezionare la percentuale di sconto
- *    - Restituisce valori predefiniti per ogni fascia
- *
- * Parametri:
- *    fascia: tipo di fascia oraria
- *
- * Pre-condizioni:
- *    fascia: deve essere un valore valido dell'enum TipoFascia
- *
- * Post-condizione:
- *    restituisce la percentuale di sconto corrispondente
- *
- * Ritorna:
- *    Un double rappresentante la percentuale di sconto (es. 0.15 per 15%)
- */
-double calcola_sconto_percentuale(TipoFascia fascia);
-
-/*
- * Funzione: ottieni_descrizione_fascia
- * ------------------------------------
- *
- * Restituisce una descrizione testuale della fascia oraria
- *
- * Implementazione:
- *    - Utilizza uno switch per selezionare la stringa descrittiva
- *    - Restituisce stringhe costanti predefinite
- *
- * Parametri:
- *    fascia: tipo di fascia oraria
- *
- * Pre-condizioni:
- *    fascia: deve essere un valore valido dell'enum TipoFascia
- *
- * Post-condizione:
- *    restituisce la descrizione corrispondente
- *
- * Ritorna:
- *    Una stringa costante costante
- */
-const char* ottieni_descrizione_fascia(TipoFascia fascia);
-
 /*
  * Funzione: menu_utente
  * ---------------------
@@ -210,6 +97,7 @@ const char* ottieni_descrizione_fascia(TipoFascia fascia);
  *    utente: l'utente loggato
  *    tabella_veicoli: tabella hash dei veicoli disponibili
  *    tabella_utenti: tabella hash degli utenti registrati
+ *    giornale: giornale su cui registrare le modifiche (può essere NULL)
  *
  * Pre-condizioni:
  *    utente: deve essere un utente valido con permesso CLIENTE
@@ -222,8 +110,9 @@ const char* ottieni_descrizione_fascia(TipoFascia fascia);
  * Side-effect:
  *    esegue le operazioni richieste dall'utente fino al logout
  *    modifica lo stato delle prenotazioni e dello storico utente
+ *    e registra le modifiche nel giornale
  */
-void menu_utente(Utente utente, TabellaVeicoli tabella_veicoli, TabellaUtenti tabella_utenti);
+void menu_utente(Utente utente, TabellaVeicoli tabella_veicoli, TabellaUtenti tabella_utenti, Giornale giornale);
 
 /*
  * Funzione: menu_amministratore
@@ -240,6 +129,7 @@ void menu_utente(Utente utente, TabellaVeicoli tabella_veicoli, TabellaUtenti ta
  *    amministratore: l'utente loggato
  *    tabella_veicoli: tabella hash dei veicoli disponibili
  *    tabella_utenti: tabella hash degli utenti registrati
+ *    giornale: giornale su cui registrare le modifiche (può essere NULL)
  *
  * Pre-condizioni:
  *    amministratore: deve essere un utente valido con permesso ADMIN
@@ -252,8 +142,9 @@ void menu_utente(Utente utente, TabellaVeicoli tabella_veicoli, TabellaUtenti ta
  * Side-effect:
  *    esegue le operazioni di amministrazione fino al logout
  *    modifica lo stato dei veicoli e delle prenotazioni
+ *    e registra le modifiche nel giornale
  */
-void menu_amministratore(Utente amministratore, TabellaVeicoli tabella_veicoli, TabellaUtenti tabella_utenti);
+void menu_amministratore(Utente amministratore, TabellaVeicoli tabella_veicoli, TabellaUtenti tabella_utenti, Giornale giornale);
 
 /*
  * Funzione: menu_utente
@@ -312,6 +203,7 @@ void scelta_menu(Utente utente, TabellaVeicoli tabella_veicoli, TabellaUtenti);
  *    tabella_utenti: tabella hash da salvare
  *    file_utente: percorso del file per i dati principali
  *    file_dati: percorso del file per i dati aggiuntivi
+ *    generazione: generazione del salvataggio, scritta in entrambi i file
  *
  * Pre-condizioni:
  *    tabella_utenti: non deve essere NULL
@@ -319,12 +211,15 @@ void scelta_menu(Utente utente, TabellaVeicoli tabella_veicoli, TabellaUtenti);
  *    file_dati: non deve essere NULL
  *
  * Post-condizione:
- *    non restituisce niente
+ *    restituisce 1 se i file sono stati scritti (anche vuoti, se non ci sono utenti), 0 altrimenti
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
  *
  * Side-effect:
  *    i dati degli utenti sono salvati sui file specificati e alloca memoria temporanea per il vettore
  */
-void salva_tabella_utenti(TabellaUtenti tabella_utenti, const char *file_utente, const char *file_dati);
+Byte salva_tabella_utenti(TabellaUtenti tabella_utenti, const char *file_utente, const char *file_dati, uint64_t generazione);
 
 /*
  * Funzione: salva_tabella_veicoli
@@ -341,18 +236,188 @@ void salva_tabella_utenti(TabellaUtenti tabella_utenti, const char *file_utente,
  *    tabella_veicoli: tabella hash da salvare
  *    file_veicoli: percorso del file per i dati dei veicoli
  *    file_prenotazioni: percorso del file per le prenotazioni
+ *    generazione: generazione del salvataggio, scritta in entrambi i file
  *
  * Pre-condizioni:
  *    tabella_veicoli: non deve essere NULL
  *    file_veicoli e file_prenotazioni devono essere percorsi validi
  *
  * Post-condizione:
- *    non restituisce niente
+ *    restituisce 1 se i file sono stati scritti (anche vuoti, se non ci sono veicoli), 0 altrimenti
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
  *
  * Side-effect:
  *    i dati dei veicoli sono salvati sui file specificati e alloca memoria temporanea per il vettore
  */
-void salva_tabella_veicoli(TabellaVeicoli tabella_veicoli, const char *file_veicoli, const char *file_prenotazioni);
+Byte salva_tabella_veicoli(TabellaVeicoli tabella_veicoli, const char *file_veicoli, const char *file_prenotazioni, uint64_t generazione);
+
+/*
+ * Funzione: compatta_archivio
+ * ---------------------------
+ *
+ * Riscrive l'istantanea completa dell'archivio e svuota il giornale
+ *
+ * Implementazione:
+ *    - Salva utenti e veicoli su file con estensione ESTENSIONE_TEMPORANEA, tutti con
+ *      la generazione successiva a quella dei file dell'archivio, e li porta su disco
+ *    - Sostituisce i file dell'archivio con `sostituisci_istantanee`; se il programma si
+ *      interrompe a metà, `completa_sostituzione_istantanee` all'avvio rinomina i
+ *      temporanei rimasti, perché un file indice non venga mai letto con i dati di
+ *      un altro salvataggio
+ *    - Svuota il giornale solo se tutti i file sono stati sostituiti
+ *
+ * Parametri:
+ *    giornale: il giornale da svuotare (può essere NULL)
+ *    tabella_utenti: tabella hash degli utenti
+ *    tabella_veicoli: tabella hash dei veicoli
+ *
+ * Pre-condizioni:
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce 1 se l'istantanea è stata riscritta e il giornale svuotato, 0 altrimenti
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    riscrive i file dell'archivio e tronca il giornale
+ */
+Byte compatta_archivio(Giornale giornale, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli);
+
+/*
+ * Funzione: compatta_se_necessario
+ * --------------------------------
+ *
+ * Compatta l'archivio quando il giornale ha raggiunto SOGLIA_COMPATTAZIONE record
+ *
+ * Implementazione:
+ *    - Il costo della compattazione è proporzionale ai dati: l'istantanea viene salvata
+ *      da un processo figlio con `avvia_compattazione`, mentre il chiamante continua a
+ *      servire i comandi; finché il figlio non ha terminato non ne viene avviato un altro
+ *    - Tra l'avvio di due compattazioni passano almeno INTERVALLO_COMPATTAZIONE secondi:
+ *      sotto carico il giornale cresce un po' di più invece di riscrivere di continuo l'archivio
+ *    - Se il processo non può essere creato la compattazione avviene subito
+ *    - Un giornale non integro viene compattato subito, dopo aver atteso quella in
+ *      corso, così l'istantanea torna a contenere tutte le modifiche
+ *
+ * Parametri:
+ *    giornale: il giornale da controllare (può essere NULL)
+ *    tabella_utenti: tabella hash degli utenti
+ *    tabella_veicoli: tabella hash dei veicoli
+ *
+ * Pre-condizioni:
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizione:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    può riscrivere i file dell'archivio e troncare il giornale
+ */
+void compatta_se_necessario(Giornale giornale, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli);
+
+/*
+ * Funzione: avvia_compattazione
+ * -----------------------------
+ *
+ * Avvia la compattazione dell'archivio in un processo figlio
+ *
+ * Implementazione:
+ *    - Segna il confine del giornale: i record precedenti sono quelli contenuti
+ *      nell'istantanea, quelli successivi arrivano mentre il figlio la salva
+ *    - Il figlio creato con fork vede le tabelle come erano in quel momento e le salva
+ *      con `compatta_archivio`, senza toccare il giornale; esce con `_exit`, così non
+ *      scrive i buffer di stdio ereditati
+ *    - Non disponibile su Windows
+ *
+ * Parametri:
+ *    giornale: il giornale di cui segnare il confine
+ *    tabella_utenti: tabella hash degli utenti
+ *    tabella_veicoli: tabella hash dei veicoli
+ *
+ * Pre-condizioni:
+ *    giornale: non deve essere NULL
+ *    nessuna compattazione deve essere in corso
+ *
+ * Post-condizione:
+ *    restituisce 1 se il processo figlio è stato avviato, 0 altrimenti
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    crea un processo che riscrive i file dell'archivio
+ */
+Byte avvia_compattazione(Giornale giornale, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli);
+
+/*
+ * Funzione: concludi_compattazione
+ * --------------------------------
+ *
+ * Raccoglie l'esito della compattazione avviata da `avvia_compattazione`
+ *
+ * Implementazione:
+ *    Se il figlio è uscito con successo scarta dal giornale i record precedenti al
+ *    confine, ormai contenuti nell'istantanea; altrimenti il giornale resta intero e
+ *    l'errore viene riportato su stderr
+ *
+ * Parametri:
+ *    giornale: il giornale da accorciare
+ *    attendi: 1 per attendere la fine del figlio, 0 per controllarla soltanto
+ *
+ * Pre-condizioni:
+ *    giornale: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce 1 se non c'è più una compattazione in corso, 0 se il figlio sta ancora salvando
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    può riscrivere il file del giornale
+ */
+Byte concludi_compattazione(Giornale giornale, Byte attendi);
+
+/*
+ * Funzione: esegui_batch
+ * ----------------------
+ *
+ * Esegue senza interazione i comandi letti da un file, uno per riga, e scrive i risultati su stdout
+ *
+ * Implementazione:
+ *    - Legge il file riga per riga e passa ogni comando a `esegui_comando`, che
+ *      scrive l'esito su stdout (il formato dei comandi è descritto in comandi.h)
+ *    - Ignora le righe vuote e quelle che iniziano con '#'
+ *    - Compatta l'archivio quando necessario, come dopo ogni operazione dei menu
+ *    - Al termine scrive su stderr il numero di comandi, di errori e i comandi al secondo
+ *
+ * Parametri:
+ *    comandi: il file da cui leggere i comandi
+ *    tabella_utenti: tabella hash degli utenti
+ *    tabella_veicoli: tabella hash dei veicoli
+ *    giornale: giornale su cui registrare le modifiche (può essere NULL)
+ *
+ * Pre-condizioni:
+ *    comandi: deve essere un file aperto in lettura
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce il numero di comandi terminati con un errore
+ *
+ * Ritorna:
+ *    un intero senza segno
+ *
+ * Side-effect:
+ *    modifica le tabelle, registra le modifiche nel giornale e scrive su stdout e stderr
+ */
+unsigned long esegui_batch(FILE *comandi, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale);
 
 /*
  * Funzione: main
@@ -360,11 +425,21 @@ void salva_tabella_veicoli(TabellaVeicoli tabella_veicoli, const char *file_veic
  * Punto di ingresso principale del programma
  *
  * Implementazione:
- *    - Carica le tabelle hash da file
+ *    - Carica in parallelo le tabelle hash dall'ultima istantanea e vi riapplica il giornale
  *    - Crea l'amministratore di default se necessario
  *    - Gestisce il ciclo principale di accesso/registrazione
  *    - Mostra i menu appropriati in base al tipo di utente
- *    - Salva i dati prima di terminare
+ *    - Registra ogni modifica nel giornale appena avviene e compatta
+ *      l'archivio ogni SOGLIA_COMPATTAZIONE modifiche, in un processo separato
+ *    - Riscrive l'istantanea completa all'uscita solo se il giornale non è utilizzabile
+ *    - Con `--batch file` esegue i comandi del file con `esegui_batch` al posto dei
+ *      menu (con `-` li legge da stdin)
+ *    - Con `--server percorso` serve i client collegati al socket con `esegui_server`
+ *      finché non riceve SIGINT o SIGTERM, poi salva come all'uscita dai menu
+ *
+ * Parametri:
+ *    argc: numero di argomenti
+ *    argv: argomenti della riga di comando
  *
  * Pre-condizioni:
  *    nessuna
@@ -379,23 +454,53 @@ void salva_tabella_veicoli(TabellaVeicoli tabella_veicoli, const char *file_veic
  * Side-effect:
  *    gestisce tutte le risorse di memoria e file del programma
  */
-int main() {
-    TabellaUtenti tabella_utenti = carica_tabella_utenti(TABELLA_GRANDEZZA, FILE_UTENTI, FILE_DATI_UTENTI);
-    TabellaVeicoli tabella_veicoli = carica_tabella_veicoli(TABELLA_GRANDEZZA, FILE_VEICOLI, FILE_PRENOTAZIONI_VEICOLI);
+int main(int argc, char **argv) {
+    FILE *comandi = NULL;
+    const char *percorso_server = NULL;
+    int esito = 0;
+    if(argc > 1){
+        if(argc != 3 || (strcmp(argv[1], OPZIONE_BATCH) != 0 && strcmp(argv[1], OPZIONE_SERVER) != 0)){
+            fprintf(stderr, "Uso: %s [" OPZIONE_BATCH " file_comandi | " OPZIONE_SERVER " percorso_socket]\n", argv[0]);
+            return -1;
+        }
+        if(strcmp(argv[1], OPZIONE_SERVER) == 0){
+            percorso_server = argv[2];
+        } else {
+            comandi = strcmp(argv[2], "-") == 0 ? stdin : fopen(argv[2], "r");
+            if(comandi == NULL){
+                fprintf(stderr, "Impossibile aprire %s\n", argv[2]);
+                return -1;
+            }
+        }
+    }
+
+    // Una compattazione interrotta durante i rename va completata prima di leggere l'archivio
+    if(!completa_sostituzione_istantanee(file_temporanei, file_archivio, NUMERO_FILE_ARCHIVIO))
+        fprintf(stderr, "Attenzione: impossibile completare l'ultimo salvataggio dell'archivio.\n");
+
+    TabellaUtenti tabella_utenti = NULL;
+    TabellaVeicoli tabella_veicoli = NULL;
     uint8_t password[DIMENSIONE_PASSWORD];
 
-    if(tabella_utenti == NULL || tabella_veicoli == NULL){
+    if(!carica_tabelle(file_archivio, TABELLA_GRANDEZZA, &tabella_utenti, &tabella_veicoli)){
         printf("Errore del sistema!\n");
-        // Pulizia delle risorse parzialmente allocate
-        if(tabella_utenti != NULL) {
-            distruggi_tabella_utenti(tabella_utenti);
-        }
-        if(tabella_veicoli != NULL) {
-            distruggi_tabella_veicoli(tabella_veicoli);
-        }
         return -1;
     }
 
+    // Le modifiche successive all'ultima istantanea sono nel giornale.
+    // Gli avvisi vanno su stderr, così in modalità batch stdout contiene solo gli esiti
+    Giornale giornale = apri_giornale(FILE_GIORNALE);
+    if(giornale == NULL){
+        fprintf(stderr, "Attenzione: giornale non disponibile, i dati saranno salvati solo all'uscita.\n");
+    } else {
+        // Una coda corrotta rende il giornale non integro: l'istantanea viene riscritta subito.
+        // All'avvio nessun comando è in attesa, quindi non serve un processo separato
+        if(riapplica_giornale(giornale, tabella_utenti, tabella_veicoli) < 0)
+            fprintf(stderr, "Attenzione: giornale troncato, vengono recuperate le modifiche precedenti.\n");
+        if(!giornale_integro(giornale) || dimensione_giornale(giornale) >= SOGLIA_COMPATTAZIONE)
+            compatta_archivio(giornale, tabella_utenti, tabella_veicoli);
+    }
+
     // Creazione admin in caso non è stato già caricato (primo avvio)
     Utente admin_presente = cerca_utente_in_tabella(tabella_utenti, "admin@email.com");
     if (admin_presente == NULL) {
@@ -408,6 +513,7 @@ int main() {
         if(admin_presente == NULL){
             printf("Errore: Impossibile creare l'amministratore di default.\n");
             // Pulizia delle risorse prima di uscire
+            chiudi_giornale(giornale);
             distruggi_tabella_utenti(tabella_utenti);
             distruggi_tabella_veicoli(tabella_veicoli);
             return -1;
@@ -417,20 +523,32 @@ int main() {
             distruggi_utente(admin_presente);
             printf("Errore: Impossibile aggiungere l'amministratore\n");
             //  Pulizia delle risorse prima di uscire
+            chiudi_giornale(giornale);
             distruggi_tabella_utenti(tabella_utenti);
             distruggi_tabella_veicoli(tabella_veicoli);
             return -1;
         }
+        registra_utente_in_giornale(giornale, admin_presente);
     }
 
     // --- CICLO PRINCIPALE DI ACCESSO/REGISTRAZIONE ---
-    Byte scelta;
-    do {
+    // In modalità batch i comandi del file sostituiscono i menu, in modalità server
+    // quelli dei client collegati al socket
+    Byte scelta = 0;
+    if(comandi != NULL){
+        esegui_batch(comandi, tabella_utenti, tabella_veicoli, giornale);
+        if(comandi != stdin) fclose(comandi);
+        scelta = '3';
+    } else if(percorso_server != NULL){
+        if(!esegui_server(percorso_server, tabella_utenti, tabella_veicoli, giornale, compatta_se_necessario)) esito = -1;
+        scelta = '3';
+    }
+    while (scelta != '3') {
         scelta = benvenuto();
 
         switch (scelta) {
             case '1': {
-                menu_registrazione(tabella_utenti);
+                menu_registrazione(tabella_utenti, giornale);
                 break;
             }
             case '2': {
@@ -441,8 +559,8 @@ int main() {
                 Byte permesso = ottieni_permesso(utente_loggato);
 
                 if(permesso == CLIENTE){
-                    menu_utente(utente_loggato, tabella_veicoli, tabella_utenti);
-                }else menu_amministratore(utente_loggato, tabella_veicoli, tabella_utenti);
+                    menu_utente(utente_loggato, tabella_veicoli, tabella_utenti, giornale);
+                }else menu_amministratore(utente_loggato, tabella_veicoli, tabella_utenti, giornale);
 
                 break;
             }
@@ -457,14 +575,22 @@ int main() {
                 break;
             }
         }
-    } while (scelta != '3');
+        compatta_se_necessario(giornale, tabella_utenti, tabella_veicoli);
+    }
 
-    // Salvataggio PRIMA della distruzione delle tabelle
-    // Questo evita l'accesso a memoria già liberata durante il salvataggio
-    printf("Salvataggio dei dati in corso...\n");
-    salva_tabella_utenti(tabella_utenti, FILE_UTENTI, FILE_DATI_UTENTI);
-    salva_tabella_veicoli(tabella_veicoli, FILE_VEICOLI, FILE_PRENOTAZIONI_VEICOLI);
-    printf("Salvataggio completato.\n");
+    // Le modifiche sono già nel giornale: l'istantanea completa serve solo se il
+    // giornale manca o una scrittura è fallita. Va fatta PRIMA della distruzione delle tabelle,
+    // dopo aver atteso un'eventuale compattazione in corso
+    if(giornale != NULL) concludi_compattazione(giornale, 1);
+    if(!giornale_integro(giornale)){
+        fprintf(stderr, "Salvataggio dei dati in corso...\n");
+        if(compatta_archivio(giornale, tabella_utenti, tabella_veicoli) || giornale == NULL)
+            fprintf(stderr, "Salvataggio completato.\n");
+        else
+            fprintf(stderr, "Errore durante il salvataggio dei dati!\n");
+    }
+    chiudi_giornale(giornale);
+    giornale = NULL;
 
     // Pulizia finale con controlli di validità
     // Distrugge le tabelle hash e tutti gli elementi al loro interno
@@ -478,8 +604,8 @@ int main() {
         tabella_veicoli = NULL; // Prevenire accessi accidentali
     }
 
-    printf("\n>> Programma terminato e memoria liberata correttamente.\n");
-    return 0;
+    if(comandi == NULL && percorso_server == NULL) printf("\n>> Programma terminato e memoria liberata correttamente.\n");
+    return esito;
 }
 
 void invio(){
@@ -488,123 +614,8 @@ void invio(){
     while(c != '\n') c = getchar();
 }
 
-TabellaUtenti carica_tabella_utenti(unsigned int grandezza, const char *file_utente, const char *file_dati){
-    TabellaUtenti tabella_utenti = NULL;
-
-    unsigned int num_utenti_caricati = 0;
-    Utente *utenti_caricati = carica_vettore_utenti(file_utente, file_dati, &num_utenti_caricati);
-
-    if(utenti_caricati == NULL){
-        tabella_utenti = crea_tabella_utenti(grandezza);
-        return tabella_utenti;
-    }
-
-    unsigned int dimensione_tabella = (num_utenti_caricati * 2 > grandezza) ?
-                                      num_utenti_caricati * 2 : grandezza;
-    tabella_utenti = crea_tabella_utenti(dimensione_tabella);
-
-    if(tabella_utenti == NULL){
-        printf("Errore caricamento utenti!\n");
-        // Pulizia sicura degli utenti caricati
-        for(unsigned i = 0; i < num_utenti_caricati; i++) {
-            if(utenti_caricati[i] != NULL) {
-                distruggi_utente(utenti_caricati[i]);
-            }
-        }
-        free(utenti_caricati);
-        return NULL;
-    }
-
-    carica_utenti(tabella_utenti, utenti_caricati, num_utenti_caricati);
-
-    // Pulizia sicura del vettore
-    free(utenti_caricati);
-    utenti_caricati = NULL;
-
-    return tabella_utenti;
-}
-
-TabellaVeicoli carica_tabella_veicoli(unsigned int grandezza, const char *file_veicolo, const char *file_prenotazioni){
-    TabellaVeicoli tabella_veicoli = NULL;
-
-    unsigned int num_veicoli_caricati = 0;
-    Veicolo *veicoli_caricati = carica_vettore_veicoli(file_veicolo, file_prenotazioni, &num_veicoli_caricati);
-
-    if(veicoli_caricati == NULL){
-        tabella_veicoli = crea_tabella_veicoli(grandezza);
-        return tabella_veicoli;
-    }
-
-    unsigned int dimensione_tabella = (num_veicoli_caricati * 2 > grandezza) ?
-                                      num_veicoli_caricati * 2 : grandezza;
-    tabella_veicoli = crea_tabella_veicoli(dimensione_tabella);
-
-    if(tabella_veicoli == NULL){
-        printf("Errore caricamento veicoli!\n");
-        for(unsigned i = 0; i < num_veicoli_caricati; i++) {
-            if(veicoli_caricati[i] != NULL) {
-                distruggi_veicolo(veicoli_caricati[i]);
-            }
-        }
-        free(veicoli_caricati);
-        return NULL;
-    }
-
-    carica_veicoli(tabella_veicoli, veicoli_caricati, num_veicoli_caricati);
-
-    free(veicoli_caricati);
-    veicoli_caricati = NULL;
-
-    return tabella_veicoli;
-}
-
-TipoFascia determina_fascia_oraria(time_t timestamp) {
-    struct tm *tm_info = localtime(&timestamp);
-    if(tm_info == NULL) {
-        // Gestione errore localtime
-        return FASCIA_NORMALE;
-    }
-
-    int ora = tm_info->tm_hour;
-    int giorno_settimana = tm_info->tm_wday;
-
-    // Weekend = nessuno sconto (alta domanda per tempo libero)
-    if (giorno_settimana == 0 || giorno_settimana == 6) {
-        return FASCIA_NORMALE;
-    }
-
-    if (ora >= 22 || ora < 6) {
-        return FASCIA_NOTTURNA;     // Notte: poca domanda
-    }
-
-    if (ora >= 6 && ora < 8) {
-        return FASCIA_MATTUTINA;    // Prima mattina: incentivo per partenze precoci
-    }
-
-    //orari di punta = prezzo pieno
-    return FASCIA_NORMALE;
-}
-
-double calcola_sconto_percentuale(TipoFascia fascia) {
-    switch (fascia) {
-        case FASCIA_NOTTURNA:     return 0.15;  // 15% sconto - molto meno richiesta
-        case FASCIA_MATTUTINA:    return 0.10;  // 10% sconto - incentivo mattutino
-        case FASCIA_NORMALE:
-        default:                  return 0.0;   // Nessuno sconto - orari normali/di punta
-    }
-}
-
-const char* ottieni_descrizione_fascia(TipoFascia fascia) {
-    switch (fascia) {
-        case FASCIA_NOTTURNA:     return "Sconto notturno";
-        case FASCIA_MATTUTINA:    return "Sconto mattutino";
-        case FASCIA_NORMALE:
-        default:                  return "Nessuno";
-    }
-}
-
 // --- Menu per Utente Normale (Cliente) ---
-void menu_utente(Utente utente, TabellaVeicoli tabella_veicoli, TabellaUtenti tabella_utenti) {
+void menu_utente(Utente utente, TabellaVeicoli tabella_veicoli, TabellaUtenti tabella_utenti, Giornale giornale) {
     char scelta_menu_utente;
     do {
         system("clear || cls");
@@ -645,68 +656,37 @@ void menu_utente(Utente utente, TabellaVeicoli tabella_veicoli, TabellaUtenti ta
                     break;
                 }
 
-                Prenotazione nuova_prenotazione = crea_prenotazione(
-                    ottieni_email(utente),
-                    ottieni_targa(veicolo_selezionato),
-                    intervallo_prenotazione,
-                    calcola_costo(ottieni_tariffa(veicolo_selezionato), intervallo_prenotazione)
-                );
-
-                if (nuova_prenotazione == NULL) {
+                Preventivo preventivo;
+                Prenotazione nuova_prenotazione;
+                EsitoServizio esito = prepara_prenotazione(tabella_veicoli, utente, ottieni_targa(veicolo_selezionato),
+                                                           intervallo_prenotazione, &preventivo, &nuova_prenotazione);
+                distruggi_intervallo(intervallo_prenotazione);
+                if (esito != SERVIZIO_OK) {
                     stampa_errore("Errore nella creazione della prenotazione.");
-                    distruggi_intervallo(intervallo_prenotazione);
                     invio();
                     break;
                 }
 
-                double sconto_totale = 0;
-                char motivo_sconto[MOTIVO_SCONTO * 2];
-                //  Inizializzazione sicura della stringa
-                memset(motivo_sconto, 0, sizeof(motivo_sconto));
-
-                /*Se il numero di prenotazioni è 0 allora nessun premio frequenza!*/
-                Byte molto_frequente = 0;
-                unsigned int num_prenotazioni = ottieni_numero_prenotazioni_utente(utente);
                 getchar();
-                if(num_prenotazioni > 0)
-                    molto_frequente = (num_prenotazioni % 5) == 0;
-
-                TipoFascia fascia_oraria = determina_fascia_oraria(inizio_intervallo(intervallo_prenotazione));
-                distruggi_intervallo(intervallo_prenotazione);
-
-                if(molto_frequente){
-                    sconto_totale += 0.20; // 20% di sconto
-                    strncpy(motivo_sconto, "Premio fedeltà (20%)", sizeof(motivo_sconto) - 1);
-                }
-
-                if (fascia_oraria != FASCIA_NORMALE) {
-                    double sconto_fascia = calcola_sconto_percentuale(fascia_oraria);
-                    sconto_totale += sconto_fascia;
-
-                    if (strlen(motivo_sconto) > 0) {
-                        strncat(motivo_sconto, " + ", sizeof(motivo_sconto) - strlen(motivo_sconto) - 1);
-                    }
-                    char temp[MOTIVO_SCONTO];
-                    snprintf(temp, sizeof(temp), "%s (%.0f%%)",
-                             ottieni_descrizione_fascia(fascia_oraria), sconto_fascia * 100);
-                    strncat(motivo_sconto, temp, sizeof(motivo_sconto) - strlen(motivo_sconto) - 1);
-                }
-
-                if (!prenota_veicolo(veicolo_selezionato, nuova_prenotazione, sconto_totale, motivo_sconto)) {
+                if (!prenota_veicolo(veicolo_selezionato, nuova_prenotazione, preventivo.sconto, preventivo.motivo)) {
                     stampa_errore("Prenotazione annullata dall'utente o errore.");
                     distruggi_prenotazione(nuova_prenotazione);
                     invio();
                     break;
                 }
 
-                aggiungi_a_storico_utente(utente, nuova_prenotazione);
-                aggiungi_prenotazione_veicolo(veicolo_selezionato, nuova_prenotazione);
+                // Aggiunge la prenotazione al veicolo e allo storico e la registra nel giornale
+                if (conferma_prenotazione(tabella_veicoli, giornale, utente, nuova_prenotazione) != SERVIZIO_OK) {
+                    stampa_errore("Il veicolo non è più disponibile per l'intervallo.");
+                    invio();
+                    break;
+                }
                 stampa_successo("Veicolo prenotato con successo!");
                 invio();
                 break;
             }
             case '3': { // Gestisci le mie prenotazioni
-                Byte codice = gestisci_le_mie_prenotazioni(ottieni_email(utente), tabella_utenti, tabella_veicoli);
+                Byte codice = gestisci_le_mie_prenotazioni(ottieni_email(utente), tabella_utenti, tabella_veicoli, giornale);
                 if (codice < 0) {
                     stampa_errore("Errore sconosciuto!");
                     invio();
@@ -731,11 +711,12 @@ void menu_utente(Utente utente, TabellaVeicoli tabella_veicoli, TabellaUtenti ta
                 break;
             }
         }
+        compatta_se_necessario(giornale, tabella_utenti, tabella_veicoli);
     } while (scelta_menu_utente != '5');
 }
 
 //Menu per Amministratore
-void menu_amministratore(Utente amministratore, TabellaVeicoli tabella_veicoli, TabellaUtenti tabella_utenti) {
+void menu_amministratore(Utente amministratore, TabellaVeicoli tabella_veicoli, TabellaUtenti tabella_utenti, Giornale giornale) {
     char scelta_menu_admin;
     do {
         system("clear || cls");
@@ -759,6 +740,7 @@ void menu_amministratore(Utente amministratore, TabellaVeicoli tabella_veicoli,
                 } else {
                     Byte codice = aggiungi_veicolo_in_tabella(tabella_veicoli, v);
                     if(codice){
+                        registra_veicolo_in_giornale(giornale, v);
                         stampa_successo("Veicolo aggiunto con successo!");
                     }else{
                         stampa_errore("Veicolo non aggiunto! La targa potrebbe essere già in uso.");
@@ -771,7 +753,7 @@ void menu_amministratore(Utente amministratore, TabellaVeicoli tabella_veicoli,
             }
             case '2': { // Rimuovi un veicolo
                 stampa_header("RIMUOVI VEICOLO");
-                interfaccia_rimuovi_veicolo(tabella_veicoli);
+                interfaccia_rimuovi_veicolo(tabella_veicoli, giornale);
                 invio();
                 break;
             }
@@ -801,56 +783,177 @@ void menu_amministratore(Utente amministratore, TabellaVeicoli tabella_veicoli,
                 break;
             }
         }
+        compatta_se_necessario(giornale, tabella_utenti, tabella_veicoli);
     } while (scelta_menu_admin != '5');
 }
 
-void salva_tabella_utenti(TabellaUtenti tabella_utenti, const char *file_utente, const char *file_dati){
+Byte salva_tabella_utenti(TabellaUtenti tabella_utenti, const char *file_utente, const char *file_dati, uint64_t generazione){
     //  Controlli di validità prima dell'accesso
     if(tabella_utenti == NULL || file_utente == NULL || file_dati == NULL) {
         printf("Errore: parametri non validi per il salvataggio utenti\n");
-        return;
+        return 0;
     }
 
     unsigned int numero_utenti = 0;
     Utente *vettore_utenti = (Utente*)ottieni_vettore(tabella_utenti, &numero_utenti);
 
-    if (vettore_utenti == NULL || numero_utenti == 0) {
-        printf("Nessun utente da salvare\n");
-        return;
+    // Una tabella vuota va comunque salvata, altrimenti resterebbe l'istantanea precedente
+    if (vettore_utenti == NULL && dimensione_tabella(tabella_utenti) > 0) {
+        printf("Errore: impossibile leggere gli utenti da salvare\n");
+        return 0;
     }
+    if (vettore_utenti == NULL) numero_utenti = 0;
 
     // IMPORTANTE: salva_vettore_utenti deve essere chiamata PRIMA che le strutture Utente
     // vengano distrutte, perché le funzioni ottieni_* restituiscono const char* che puntano
     // direttamente ai dati interni degli oggetti Utente
-    salva_vettore_utenti(file_utente, file_dati, vettore_utenti, numero_utenti);
+    Byte esito = salva_vettore_utenti(file_utente, file_dati, vettore_utenti, numero_utenti, generazione);
 
     //  Libera solo il vettore di puntatori, NON gli oggetti Utente
     // Gli oggetti Utente saranno liberati da distruggi_tabella_utenti()
     free(vettore_utenti);
     vettore_utenti = NULL;
+    return esito;
 }
 
-void salva_tabella_veicoli(TabellaVeicoli tabella_veicoli, const char *file_veicoli, const char *file_prenotazioni){
+Byte salva_tabella_veicoli(TabellaVeicoli tabella_veicoli, const char *file_veicoli, const char *file_prenotazioni, uint64_t generazione){
     //  Controlli di validità prima dell'accesso
     if(tabella_veicoli == NULL || file_veicoli == NULL || file_prenotazioni == NULL) {
         printf("Errore: parametri non validi per il salvataggio veicoli\n");
-        return;
+        return 0;
     }
 
     unsigned int numero_veicoli = 0;
-    Veicolo *vettore_veicoli = (Veicolo*)ottieni_vettore(tabella_veicoli, &numero_veicoli);
+    Veicolo *vettore_veicoli = ottieni_vettore_veicoli(tabella_veicoli, &numero_veicoli);
 
-    if (vettore_veicoli == NULL) {
-        printf("Nessun veicolo da salvare\n");
-        return;
+    if (vettore_veicoli == NULL && dimensione_tabella_veicoli(tabella_veicoli) > 0) {
+        printf("Errore: impossibile leggere i veicoli da salvare\n");
+        return 0;
     }
+    if (vettore_veicoli == NULL) numero_veicoli = 0;
 
     // IMPORTANTE: salva_vettore_veicoli deve essere chiamata PRIMA che le strutture Veicolo
     // vengano distrutte, perché le funzioni ottieni_* restituiscono const char* che puntano
     // direttamente ai dati interni degli oggetti Veicolo
-    salva_vettore_veicoli(file_veicoli, file_prenotazioni, vettore_veicoli, numero_veicoli);
+    Byte esito = salva_vettore_veicoli(file_veicoli, file_prenotazioni, vettore_veicoli, numero_veicoli, generazione);
 
     // Gli oggetti Veicolo saranno liberati da distruggi_tabella_veicoli()
     free(vettore_veicoli);
     vettore_veicoli = NULL;
+    return esito;
+}
+
+Byte compatta_archivio(Giornale giornale, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli){
+    uint64_t generazione = 0;
+    for(unsigned int i = 0; i < NUMERO_FILE_ARCHIVIO; i++){
+        uint64_t corrente = generazione_istantanea(file_archivio[i]);
+        if(corrente > generazione) generazione = corrente;
+    }
+    generazione++;
+
+    if(!salva_tabella_utenti(tabella_utenti, file_temporanei[0], file_temporanei[1], generazione) ||
+       !salva_tabella_veicoli(tabella_veicoli, file_temporanei[2], file_temporanei[3], generazione)){
+        for(unsigned int i = 0; i < NUMERO_FILE_ARCHIVIO; i++) remove(file_temporanei[i]);
+        return 0;
+    }
+
+    if(!sostituisci_istantanee(file_temporanei, file_archivio, NUMERO_FILE_ARCHIVIO)){
+        fprintf(stderr, "Errore: impossibile aggiornare l'archivio\n");
+        return 0;
+    }
+
+    if(giornale == NULL) return 1;
+    return svuota_giornale(giornale);
+}
+
+void compatta_se_necessario(Giornale giornale, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli){
+    if(giornale == NULL) return;
+    if(!giornale_integro(giornale)){
+        concludi_compattazione(giornale, 1);
+        compatta_archivio(giornale, tabella_utenti, tabella_veicoli);
+        return;
+    }
+    if(!concludi_compattazione(giornale, 0) || dimensione_giornale(giornale) < SOGLIA_COMPATTAZIONE) return;
+
+    struct timespec adesso;
+    clock_gettime(CLOCK_MONOTONIC, &adesso);
+    if(adesso.tv_sec - ultima_compattazione < INTERVALLO_COMPATTAZIONE) return;
+    ultima_compattazione = adesso.tv_sec;
+
+    if(!avvia_compattazione(giornale, tabella_utenti, tabella_veicoli))
+        compatta_archivio(giornale, tabella_utenti, tabella_veicoli);
+}
+
+Byte avvia_compattazione(Giornale giornale, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli){
+#ifndef _WIN32
+    if(!segna_confine_giornale(giornale)) return 0;
+
+    pid_t figlio = fork();
+    if(figlio < 0) return 0;
+    if(figlio == 0) _exit(compatta_archivio(NULL, tabella_utenti, tabella_veicoli) ? 0 : 1);
+
+    compattazione_in_corso = figlio;
+    return 1;
+#else
+    (void)giornale;
+    (void)tabella_utenti;
+    (void)tabella_veicoli;
+    return 0;
+#endif
 }
+
+Byte concludi_compattazione(Giornale giornale, Byte attendi){
+#ifndef _WIN32
+    if(compattazione_in_corso == 0) return 1;
+
+    int stato;
+    pid_t esito;
+    while((esito = waitpid(compattazione_in_corso, &stato, attendi ? 0 : WNOHANG)) < 0 && errno == EINTR);
+    if(esito == 0) return 0;
+
+    compattazione_in_corso = 0;
+    if(esito > 0 && WIFEXITED(stato) && WEXITSTATUS(stato) == 0) scarta_fino_al_confine(giornale);
+    else fprintf(stderr, "Errore: compattazione dell'archivio non riuscita\n");
+#else
+    (void)giornale;
+    (void)attendi;
+#endif
+    return 1;
+}
+
+unsigned long esegui_batch(FILE *comandi, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale){
+    char riga[GRANDEZZA_RIGA_COMANDO];
+    unsigned long eseguiti = 0, errori = 0;
+    Utente sessione = NULL;
+    struct timespec inizio, fine;
+
+    clock_gettime(CLOCK_MONOTONIC, &inizio);
+    while(fgets(riga, sizeof(riga), comandi)){
+        size_t lunghezza = strcspn(riga, "\r\n");
+        Byte completa = riga[lunghezza] != '\0' || feof(comandi);
+        riga[lunghezza] = '\0';
+
+        if(!completa){
+            // Scarta il resto di una riga troppo lunga
+            int c;
+            while((c = fgetc(comandi)) != EOF && c != '\n');
+            printf("ERRORE;?;riga troppo lunga\n");
+            errori++;
+            eseguiti++;
+            continue;
+        }
+        if(riga[0] == '\0' || riga[0] == '#') continue;
+
+        errori += !esegui_comando(riga, &sessione, stdout, tabella_utenti, tabella_veicoli, giornale);
+        eseguiti++;
+        compatta_se_necessario(giornale, tabella_utenti, tabella_veicoli);
+    }
+    fflush(stdout);
+    clock_gettime(CLOCK_MONOTONIC, &fine);
+
+    double secondi = (double)(fine.tv_sec - inizio.tv_sec) + (fine.tv_nsec - inizio.tv_nsec) / 1e9;
+    fprintf(stderr, "comandi;errori;secondi;comandi_al_secondo\n%lu;%lu;%.3f;%.0f\n",
+            eseguiti, errori, secondi, secondi > 0 ? eseguiti / secondi : 0.0);
+    return errori;
+}
+
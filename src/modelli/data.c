@@ -8,14 +8,40 @@
 
 #include "modelli/data.h"
 #include "modelli/prenotazione.h"
+#include "modelli/intervallo.h"
 #include "strutture_dati/lista_prenotazione.h"
 #include <strutture_dati/lista.h>
 
+/*
+ * Lo storico è una lista doppia i cui collegamenti stanno nelle prenotazioni stesse
+ * (`imposta_vicine_storico`): lo storico tiene un riferimento condiviso alla stessa
+ * prenotazione dell'albero del veicolo, senza copie né nodi separati.
+ */
 struct data{
-  ListaPre storico;
+  Prenotazione storico;     // Testa della lista
   unsigned int numero_prenotazioni;
 };
 
+/*
+ * Funzione: stacca_da_storico
+ * ---------------------------
+ * Toglie dalla lista dello storico una prenotazione che vi appartiene, in tempo costante.
+ *
+ * Implementazione:
+ *    Collega tra loro la precedente e la successiva (o aggiorna la testa) e azzera
+ *    i collegamenti di 'p', che può restare in uso nell'albero del veicolo.
+ */
+static void stacca_da_storico(Data data, Prenotazione p){
+    Prenotazione precedente = ottieni_precedente_storico(p);
+    Prenotazione successiva = ottieni_successiva_storico(p);
+
+    if (precedente != NULL) imposta_vicine_storico(precedente, ottieni_precedente_storico(precedente), successiva);
+    else data->storico = successiva;
+    if (successiva != NULL) imposta_vicine_storico(successiva, precedente, ottieni_successiva_storico(successiva));
+
+    scollega_da_storico(p);
+}
+
 /*
  * Funzione: crea_data
  * -------------------
@@ -23,7 +49,7 @@ struct data{
  *
  * Implementazione:
  *    - Alloca memoria per la struttura `Data` con `calloc`, inizializzando una struttura vuota.
- *    - Inizializza il campo `storico` con una lista vuota.
+ *    - Inizializza il campo `storico` con una lista vuota (NULL).
  *    - Imposta a zero il numero di prenotazioni.
  *
  * Parametri:
@@ -46,7 +72,7 @@ Data crea_data() {
     Data data = calloc(1, sizeof(struct data));
     if (data == NULL) return NULL;
 
-    data->storico = crea_lista();
+    data->storico = NULL;
     data->numero_prenotazioni = 0;
 
     return data;
@@ -59,7 +85,8 @@ Data crea_data() {
  *
  * Implementazione:
  *    - Verifica che `data` non sia NULL.
- *    - Chiama `distruggi_lista_prenotazione` per liberare lo storico.
+ *    - Stacca ogni prenotazione dallo storico e ne rilascia il riferimento con
+ *    `distruggi_prenotazione`: quelle ancora nell'albero di un veicolo restano valide.
  *    - Libera la memoria della struttura stessa.
  *
  * Parametri:
@@ -76,18 +103,26 @@ Data crea_data() {
  */
 void distruggi_data(Data data) {
     if (data == NULL) return;
-    distruggi_lista_prenotazione(data->storico);
+
+    while (data->storico != NULL) {
+        Prenotazione p = data->storico;
+        stacca_da_storico(data, p);
+        distruggi_prenotazione(p);
+    }
     free(data);
  }
 
 /*
  * Funzione: ottieni_storico_lista
  * -------------------------------
- * Restituisce una copia dello storico delle prenotazioni associato a un utente.
+ * Restituisce una lista con le prenotazioni dello storico associato a un utente.
  *
  * Implementazione:
  *    - Verifica che `data` non sia NULL.
- *    - Chiama `duplica_lista_prenotazioni` per restituire una copia della lista.
+ *    - Scorre lo storico e aggiunge in testa a una nuova lista un riferimento condiviso
+ *    (`condividi_prenotazione`) a ogni prenotazione, poi la inverte per mantenerne l'ordine.
+ *    Le prenotazioni non vengono copiate: quelle della lista sono le stesse dello storico,
+ *    quindi possono essere passate a `rimuovi_da_storico_lista`.
  *
  * Parametri:
  *    data: struttura `Data` contenente lo storico.
@@ -96,20 +131,69 @@ void distruggi_data(Data data) {
  *    data: non deve essere NULL
  *
  * Post-condizioni:
- *    restituisce una copia della lista delle prenotazioni originale, oppure NULL in caso di errore
+ *    restituisce una lista con le prenotazioni dello storico, nello stesso ordine, oppure
+ *    NULL se lo storico è vuoto o in caso di errore
  *
  * Ritorna:
  *    puntatore ad una lista o NULL
  *
  * Side-effect:
- *    - Alloca memoria per la copia della lista.
+ *    - Alloca memoria per i nodi della lista, da liberare con `distruggi_lista_prenotazione`
+ *    (che rilascia anche i riferimenti alle prenotazioni).
  */
 ListaPre ottieni_storico_lista(Data data){
     if (data == NULL) {
         return NULL;
     }
 
-    return duplica_lista_prenotazioni(data->storico);
+    ListaPre lista = crea_lista();
+    for (Prenotazione p = data->storico; p != NULL; p = ottieni_successiva_storico(p)) {
+        ListaPre temp = aggiungi_prenotazione_lista(lista, p);
+        if (temp == NULL) {
+            distruggi_lista_prenotazione(lista);
+            return NULL;
+        }
+        condividi_prenotazione(p);
+        lista = temp;
+    }
+
+    return inverti_lista(lista);
+}
+
+/*
+ * Funzione: visita_storico_lista
+ * ------------------------------
+ * Chiama `visita` su ogni prenotazione dello storico, nell'ordine della lista,
+ * senza copiarle.
+ *
+ * Implementazione:
+ *    Scorre la lista con `ottieni_successiva_storico`, al contrario di `ottieni_storico_lista`
+ *    che alloca una nuova lista: chi deve solo leggere lo storico non paga i nodi.
+ *
+ * Parametri:
+ *    data: struttura `Data` contenente lo storico.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    data: può essere NULL (nessuna operazione)
+ *    visita: non deve essere NULL
+ *    `visita` non deve modificare lo storico.
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    Nessuna allocazione di memoria; gli effetti sono quelli di `visita`.
+ */
+void visita_storico_lista(Data data, void (*visita)(const Prenotazione p, void *contesto), void *contesto){
+    if (data == NULL || visita == NULL) {
+        return;
+    }
+
+    for (Prenotazione p = data->storico; p != NULL; p = ottieni_successiva_storico(p)) {
+        visita(p, contesto);
+    }
 }
 
 /*
@@ -118,9 +202,12 @@ ListaPre ottieni_storico_lista(Data data){
  * Aggiunge una prenotazione allo storico dell'utente.
  *
  * Implementazione:
- *    - Verifica che `data` non sia NULL.
- *    - Chiama `aggiungi_prenotazione_lista` per inserire la prenotazione.
- *    - Se il risultato è valido, aggiorna il campo `storico` e incrementa `numero_prenotazioni`.
+ *    - Verifica che `data` e `prenotazione` non siano NULL e che la prenotazione non
+ *    appartenga già a uno storico: due archivi con lo stesso identificativo restituiscono
+ *    la stessa prenotazione, che non va collegata due volte.
+ *    - Prende un riferimento condiviso alla prenotazione (`condividi_prenotazione`),
+ *    senza copiarla, e la collega in testa alla lista.
+ *    - Incrementa `numero_prenotazioni`.
  *
  * Parametri:
  *    data: puntatore alla struttura `Data`.
@@ -128,35 +215,32 @@ ListaPre ottieni_storico_lista(Data data){
  *
  * Pre-condizioni:
  *    data: non deve essere NULL
- *    prenotazione: non deve essere NULL
+ *    prenotazione: non deve essere NULL e non deve appartenere già a uno storico
  *
  * Post-condizioni:
  *    - 1 se l'inserimento è avvenuto con successo.
- *    - 0 in caso di errore (puntatori NULL o fallimento nell'aggiunta alla lista).
+ *    - 0 in caso di errore (puntatori NULL o prenotazione già in uno storico).
+ *    Il chiamante mantiene il proprio riferimento alla prenotazione.
  *
  * Ritorna:
  *    un valore di tipo Byte(0 o 1)
  *
  * Side-effect:
- *    modifica la lista `storico`
+ *    modifica la lista `storico` e i collegamenti della prenotazione
  */
 Byte aggiungi_a_storico_lista(Data data, Prenotazione prenotazione) {
-    if (data == NULL) {
+    if (data == NULL || prenotazione == NULL || appartiene_a_storico(prenotazione)) {
         return 0;
     }
 
-    Prenotazione p = duplica_prenotazione(prenotazione);
-    ListaPre temp = aggiungi_prenotazione_lista(data->storico, p);
+    imposta_vicine_storico(condividi_prenotazione(prenotazione), NULL, data->storico);
+    if (data->storico != NULL)
+        imposta_vicine_storico(data->storico, prenotazione, ottieni_successiva_storico(data->storico));
 
-    if(temp == NULL){
-        distruggi_prenotazione(p);
-        return 0;
-    }
-
-    data->storico = temp;
+    data->storico = prenotazione;
     data->numero_prenotazioni +=1;
 
-    return temp != NULL;
+    return 1;
 }
 
 /*
@@ -165,10 +249,12 @@ Byte aggiungi_a_storico_lista(Data data, Prenotazione prenotazione) {
  * Rimuove una prenotazione dallo storico dell'utente.
  *
  * Implementazione:
- *    - Verifica che `data` non sia NULL.
- *    - Chiama `rimuovi_prenotazione_lista`.
- *    - Se il contatore `numero_prenotazioni`non è 0, lo decrementa.
- *    - Ritorna se la lista risultante è valida.
+ *    - Verifica che `data` e `prenotazione` non siano NULL.
+ *    - Se `prenotazione` è collegata a uno storico (`appartiene_a_storico`), per la
+ *    pre-condizione è questo: la stacca in tempo costante, senza scorrere la lista.
+ *    - Altrimenti è una prenotazione con gli stessi dati ma creata altrove (ad esempio
+ *    rilette dal giornale): cerca nello storico la prima con intervallo uguale.
+ *    - Rilascia il riferimento dello storico e decrementa `numero_prenotazioni`.
  *
  * Parametri:
  *    data: struttura `Data` da cui rimuovere.
@@ -176,7 +262,7 @@ Byte aggiungi_a_storico_lista(Data data, Prenotazione prenotazione) {
  *
  * Pre-condizioni:
  *    data: non deve essere NULL
- *    prenotazione: non deve essere NULL
+ *    prenotazione: non deve essere NULL e non deve appartenere allo storico di un altro utente
  *
  * Post-condizioni:
  *    restituisce 1 se la prenotazione è stata rimossa, altrimenti 0
@@ -185,18 +271,27 @@ Byte aggiungi_a_storico_lista(Data data, Prenotazione prenotazione) {
  *    un valore di tipo Byte(0 o 1)
  *
  * Side-effect:
- *    modifica la lista
+ *    modifica la lista; la prenotazione viene liberata se nessun'altra vista la usa
  */
 Byte rimuovi_da_storico_lista(Data data, Prenotazione prenotazione) {
-    if (data == NULL) {
+    if (data == NULL || prenotazione == NULL) {
         return 0;
     }
 
-    data->storico = rimuovi_prenotazione_lista(data->storico, prenotazione);
+    Prenotazione p = prenotazione;
+    if (!appartiene_a_storico(p)) {
+        Intervallo i = ottieni_intervallo_prenotazione(prenotazione);
+        for (p = data->storico; p != NULL; p = ottieni_successiva_storico(p)) {
+            if (compara_intervalli(i, ottieni_intervallo_prenotazione(p)) == 0) break;
+        }
+        if (p == NULL) return 0;
+    }
 
-    if(data->numero_prenotazioni) data->numero_prenotazioni -=1;
+    stacca_da_storico(data, p);
+    distruggi_prenotazione(p);
+    data->numero_prenotazioni -=1;
 
-    return data->storico != NULL;
+    return 1;
 }
 
 /*
@@ -229,63 +324,3 @@ unsigned int ottieni_numero_prenotazioni(Data data){
     }
     return data->numero_prenotazioni;
 }
-
-/*
- * Funzione: imposta_numero_prenotazioni
- * -------------------------------------
- * Imposta manualmente il numero di prenotazioni in una struttura `Data`.
- *
- * Implementazione:
- *    - Verifica che `data` non sia NULL.
- *    - Imposta `numero_prenotazioni` con il valore dato.
- *
- * Parametri:
- *    data: struttura `Data` da modificare.
- *    numero_prenotazioni: valore da impostare.
- *
- * Pre-condizioni:
- *    data: non deve essere NULL
- *
- * Post-condizioni:
- *    non restituisce niente
- *
- * Side-effect:
- *    Il campo `numero_prenotazioni` viene aggiornato.
- */
-void imposta_numero_prenotazioni(Data data, int numero_prenotazioni){
-    if (data == NULL) {
-        return;
-    }
-
-    data->numero_prenotazioni = numero_prenotazioni;
-}
-
-/*
- * Funzione: imposta_storico_lista
- * -------------------------------
- * Imposta direttamente la lista dello storico in una struttura `Data`.
- *
- * Implementazione:
- *    - Verifica che `data` non sia NULL.
- *    - Assegna indirizzo a cui punta lista_prenotazione al campo `storico`.
- *
- * Parametri:
- *    data: struttura `Data` da modificare.
- *    lista_prenotazione: lista da assegnare al campo `storico`.
- *
- * Pre-condizioni:
- *    data: non deve essere NULL
- *
- * Post-condizioni:
- *    non restituisce niente
- *
- * Side-effect:
- *    Il campo `storico` della struttura viene aggiornato.
- */
-void imposta_storico_lista(Data data, ListaPre lista_prenotazione){
-    if (data == NULL) {
-        return;
-    }
-
-    data->storico = lista_prenotazione;
-}
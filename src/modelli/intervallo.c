@@ -4,18 +4,26 @@
  */
 
 #include "modelli/intervallo.h"
+#include "strutture_dati/pool.h"
 #include <stdlib.h>
 #include <time.h>
 #include <stdio.h>
 
 #define DIMENSIONE_BUFFER 25
 #define DIMENSIONE_BUFFER_FINALE (2 * DIMENSIONE_BUFFER + 5)
+#define INTERVALLI_PER_BLOCCO 1024
 
 struct intervallo{
     time_t inizio;
     time_t fine;
 };
 
+/*
+ * Pool condiviso da cui vengono prelevati tutti gli intervalli.
+ * Viene creato alla prima richiesta e riutilizza gli intervalli distrutti.
+ */
+static Pool pool_intervalli = NULL;
+
 /*
  * Funzione: converti_data_in_time_t
  * ---------------------------------
@@ -59,9 +67,9 @@ struct intervallo{
  * Crea un nuovo intervallo temporale.
  *
  * Implementazione:
- *    Verifica che inizio <= fine, alloca memoria per la struttura
- *    e inizializza i campi. Se l'allocazione fallisce o i parametri
- *    non sono validi, restituisce NULL.
+ *    Verifica che inizio <= fine, preleva la struttura dal pool condiviso
+ *    (creandolo alla prima chiamata) e inizializza i campi. Se l'allocazione
+ *    fallisce o i parametri non sono validi, restituisce NULL.
  *
  * Parametri:
  *    inizio: timestamp di inizio
@@ -79,11 +87,15 @@ struct intervallo{
  *    un nuovo intervallo o NULL
  *
  * Side-effect:
- *    Alloca memoria per la struttura intervallo
+ *    Preleva memoria dal pool degli intervalli
  */
 Intervallo crea_intervallo(time_t inizio, time_t fine){
     if(inizio >= fine) return NULL;
-    Intervallo i = (Intervallo) malloc(sizeof(struct intervallo));
+    if(pool_intervalli == NULL){
+        pool_intervalli = crea_pool(sizeof(struct intervallo), INTERVALLI_PER_BLOCCO);
+        if(pool_intervalli == NULL) return NULL;
+    }
+    Intervallo i = (Intervallo) alloca_da_pool(pool_intervalli);
     if(i == NULL){
         return NULL;
     }
@@ -99,7 +111,7 @@ Intervallo crea_intervallo(time_t inizio, time_t fine){
  * Libera la memoria di un intervallo.
  *
  * Implementazione:
- *    Verifica che il puntatore non sia NULL prima di deallocare.
+ *    Verifica che il puntatore non sia NULL prima di restituirlo al pool.
  *
  * Parametri:
  *    i: intervallo da deallocare
@@ -111,14 +123,14 @@ Intervallo crea_intervallo(time_t inizio, time_t fine){
  *    non restituisce niente
  *
  * Side-effect:
- *    Dealloca memoria se i non è NULL
+ *    Restituisce l'intervallo al pool se i non è NULL
  */
 void distruggi_intervallo(Intervallo i){
     if(i == NULL){
         return;
     }
 
-    free(i);
+    rilascia_in_pool(pool_intervalli, i);
 }
 
 /*
@@ -355,3 +367,28 @@ char *intervallo_in_stringa(Intervallo i) {
 
     return buffer_end;
 }
+
+/*
+ * Funzione: ottieni_statistiche_pool_intervallo
+ * ---------------------------------------------
+ * Restituisce i contatori del pool condiviso degli intervalli.
+ *
+ * Implementazione:
+ *    Delega a `ottieni_statistiche_pool`; se il pool non è ancora stato creato
+ *    i contatori sono tutti a zero.
+ *
+ * Parametri:
+ *    Nessuno
+ *
+ * Pre-condizioni:
+ *    Nessuna
+ *
+ * Post-condizioni:
+ *    restituisce le statistiche del pool degli intervalli
+ *
+ * Ritorna:
+ *    una struttura StatistichePool
+ */
+StatistichePool ottieni_statistiche_pool_intervallo(void){
+    return ottieni_statistiche_pool(pool_intervalli);
+}
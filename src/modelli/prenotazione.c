@@ -5,30 +5,239 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "modelli/prenotazione.h"
 #include "modelli/intervallo.h"
+#include "modelli/veicolo.h"
+#include "strutture_dati/pool.h"
 #include "utils/utils.h"
 
 #define DIMENSIONE_BUFFER 1024
+#define DIMENSIONE_CLIENTE_BREVE 48
+#define PRENOTAZIONI_PER_BLOCCO 1024
+#define CAPACITA_INIZIALE_INDICE 1024
 
 struct prenotazione {
-    char *cliente;
-    char *targa;
+    char *cliente;      // Punta a `cliente_breve` o, se troppo lungo, a una copia dinamica
     Intervallo date;
     double costo;
+    uint64_t id;                               // Identificativo assegnato alla creazione, mai riusato
+    struct prenotazione *precedente_storico;   // Vicine nello storico del cliente (NULL agli estremi)
+    struct prenotazione *successiva_storico;
+    unsigned int riferimenti;                  // Viste che condividono la prenotazione (albero, storico, copie)
+    Byte nello_storico;                        // 1 se collegata allo storico di un cliente
+    char targa[NUM_CARATTERI_TARGA];
+    char cliente_breve[DIMENSIONE_CLIENTE_BREVE];
 };
 
+/*
+ * Pool condiviso da cui vengono prelevate tutte le strutture `prenotazione`.
+ * Viene creato alla prima richiesta e riutilizza le prenotazioni distrutte.
+ */
+static Pool pool_prenotazioni = NULL;
+
+/*
+ * Indice globale identificativo -> prenotazione, con tutte le prenotazioni vive.
+ * È una tabella a indirizzamento aperto con scansione lineare (celle NULL libere)
+ * la cui capacità è una potenza di 2 e viene raddoppiata oltre metà riempimento.
+ * Come il pool, non è protetto da lock.
+ */
+static Prenotazione *indice_id = NULL;
+static size_t capacita_indice_id = 0;
+static size_t num_indicizzate = 0;
+static uint64_t ultimo_id = 0;      // Identificativo più alto assegnato o riservato
+
+/*
+ * Funzione: cella_indice
+ * ----------------------
+ * Restituisce la cella dell'indice che contiene `id` o, se assente, la cella
+ * libera in cui andrebbe inserito.
+ *
+ * Implementazione:
+ *    Hash moltiplicativo di Fibonacci ridotto con una maschera, poi scansione
+ *    lineare fino alla prenotazione cercata o a una cella vuota.
+ */
+static size_t cella_indice(uint64_t id){
+    size_t maschera = capacita_indice_id - 1;
+    uint64_t h = id * 0x9E3779B97F4A7C15ULL;
+    size_t cella = (size_t)(h ^ (h >> 32)) & maschera;
+
+    while(indice_id[cella] != NULL && indice_id[cella]->id != id)
+        cella = (cella + 1) & maschera;
+    return cella;
+}
+
+/*
+ * Funzione: indicizza_prenotazione
+ * --------------------------------
+ * Inserisce 'p' nell'indice per identificativo, raddoppiandolo se serve.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 in caso di errore di allocazione
+ */
+static Byte indicizza_prenotazione(Prenotazione p){
+    if((num_indicizzate + 1) * 2 > capacita_indice_id){
+        size_t vecchia_capacita = capacita_indice_id;
+        Prenotazione *vecchio = indice_id;
+        size_t nuova_capacita = vecchia_capacita ? vecchia_capacita * 2 : CAPACITA_INIZIALE_INDICE;
+
+        Prenotazione *nuovo = calloc(nuova_capacita, sizeof(Prenotazione));
+        if(nuovo == NULL) return 0;
+        indice_id = nuovo;
+        capacita_indice_id = nuova_capacita;
+        for(size_t i = 0; i < vecchia_capacita; i++)
+            if(vecchio[i] != NULL) indice_id[cella_indice(vecchio[i]->id)] = vecchio[i];
+        free(vecchio);
+    }
+
+    indice_id[cella_indice(p->id)] = p;
+    num_indicizzate++;
+    return 1;
+}
+
+/*
+ * Funzione: togli_da_indice
+ * -------------------------
+ * Rimuove 'p' dall'indice per identificativo.
+ *
+ * Implementazione:
+ *    Svuota la cella e riporta indietro gli elementi successivi della stessa
+ *    sequenza di scansione, così non servono celle "cancellate".
+ */
+static void togli_da_indice(Prenotazione p){
+    if(capacita_indice_id == 0) return;
+
+    size_t maschera = capacita_indice_id - 1;
+    size_t vuota = cella_indice(p->id);
+    if(indice_id[vuota] != p) return;
+
+    indice_id[vuota] = NULL;
+    num_indicizzate--;
+    for(size_t cella = (vuota + 1) & maschera; indice_id[cella] != NULL; cella = (cella + 1) & maschera){
+        uint64_t h = indice_id[cella]->id * 0x9E3779B97F4A7C15ULL;
+        size_t ideale = (size_t)(h ^ (h >> 32)) & maschera;
+        // L'elemento resta dov'è se la sua cella ideale cade tra la cella vuota (esclusa) e la sua
+        if(((cella - ideale) & maschera) < ((cella - vuota) & maschera)) continue;
+        indice_id[vuota] = indice_id[cella];
+        indice_id[cella] = NULL;
+        vuota = cella;
+    }
+}
+
+/*
+ * Funzione: imposta_stringa_cliente
+ * ---------------------------------
+ * Copia il cliente nella prenotazione evitando allocazioni per le stringhe brevi.
+ *
+ * Implementazione:
+ *    Libera l'eventuale copia dinamica precedente. Se la nuova stringa entra in
+ *    `cliente_breve` viene copiata lì, altrimenti viene duplicata con `mia_strdup`.
+ *    Una stringa NULL lascia il cliente a NULL.
+ *
+ * Parametri:
+ *    p: puntatore alla prenotazione.
+ *    cliente: stringa costante contenente il cliente (può essere NULL).
+ *
+ * Pre-condizioni:
+ *    p: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se la copia è riuscita, 0 in caso di errore di allocazione
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(0 o 1)
+ *
+ * Side-effect:
+ *    può allocare memoria dinamica per clienti più lunghi di `DIMENSIONE_CLIENTE_BREVE`
+ */
+static Byte imposta_stringa_cliente(Prenotazione p, const char *cliente){
+    if (p->cliente != p->cliente_breve) free(p->cliente);
+    p->cliente = NULL;
+
+    if (cliente == NULL) return 1;
+
+    size_t len = strlen(cliente) + 1;
+    if (len <= DIMENSIONE_CLIENTE_BREVE) {
+        memcpy(p->cliente_breve, cliente, len);
+        p->cliente = p->cliente_breve;
+        return 1;
+    }
+
+    p->cliente = mia_strdup(cliente);
+    return p->cliente != NULL;
+}
+
+/*
+ * Funzione: stessi_dati
+ * ---------------------
+ * Indica se 'p' ha cliente, targa, estremi e costo indicati.
+ */
+static Byte stessi_dati(Prenotazione p, const char *cliente, const char *targa, Intervallo i, double costo) {
+    if (cliente == NULL || targa == NULL || i == NULL || p->cliente == NULL || p->date == NULL) return 0;
+
+    return strcmp(p->cliente, cliente) == 0 && strcmp(p->targa, targa) == 0 && p->costo == costo &&
+           inizio_intervallo(p->date) == inizio_intervallo(i) && fine_intervallo(p->date) == fine_intervallo(i);
+}
+
+/*
+ * Funzione: nuova_prenotazione
+ * ----------------------------
+ * Crea una prenotazione con identificativo `id`, come descritto in `crea_prenotazione`,
+ * e la inserisce nell'indice; `ultimo_id` viene portato almeno a `id`.
+ */
+static Prenotazione nuova_prenotazione(uint64_t id, const char *cliente, const char *targa, Intervallo i, double costo) {
+    if (pool_prenotazioni == NULL) {
+        pool_prenotazioni = crea_pool(sizeof(struct prenotazione), PRENOTAZIONI_PER_BLOCCO);
+        if (pool_prenotazioni == NULL) return NULL;
+    }
+
+    Prenotazione p = alloca_da_pool(pool_prenotazioni);
+    if (p == NULL) return NULL;
+    p->cliente = NULL;  // Il pool riusa il campo per la lista dei liberi
+
+    if (!imposta_stringa_cliente(p, cliente)) {
+        rilascia_in_pool(pool_prenotazioni, p);
+        return NULL;
+    }
+
+    if (targa != NULL) snprintf(p->targa, NUM_CARATTERI_TARGA, "%s", targa);
+
+    p->date = duplica_intervallo(i);
+    if (i != NULL && p->date == NULL) {
+        imposta_stringa_cliente(p, NULL);
+        rilascia_in_pool(pool_prenotazioni, p);
+        return NULL;
+    }
+
+    p->costo = costo;
+    p->riferimenti = 1;
+    p->id = id;
+
+    if (!indicizza_prenotazione(p)) {
+        distruggi_intervallo(p->date);
+        imposta_stringa_cliente(p, NULL);
+        rilascia_in_pool(pool_prenotazioni, p);
+        return NULL;
+    }
+    if (id > ultimo_id) ultimo_id = id;
+
+    return p;
+}
+
 /*
  * Funzione: crea_prenotazione
  * ---------------------------
  * Crea una nuova prenotazione con i dati specificati.
  *
  * Implementazione:
- *    Alloca memoria per una nuova struttura 'prenotazione'. Se l'allocazione fallisce,
- *    restituisce NULL. Duplica le stringhe 'cliente' e 'targa' usando `mia_strdup`,
- *    e duplica intervallo con 'duplica_intervallo' per assicurare che la prenotazione abbia le proprie copie indipendenti.
- *    Infine, il costo viene assegnato. In caso di fallimento della duplicazione delle stringhe,
- *    la memoria allocata per la struttura e le stringhe già duplicate viene liberata.
+ *    Preleva una nuova struttura 'prenotazione' dal pool condiviso (creandolo alla
+ *    prima chiamata). Se l'allocazione fallisce, restituisce NULL. Copia 'targa' nel
+ *    campo a dimensione fissa e 'cliente' nel buffer interno (o in una copia dinamica
+ *    se troppo lungo), e duplica intervallo con 'duplica_intervallo' per assicurare
+ *    che la prenotazione abbia le proprie copie indipendenti.
+ *    Infine, il costo viene assegnato insieme al primo identificativo libero e la
+ *    prenotazione viene inserita nell'indice globale per identificativo. In caso di
+ *    fallimento di una copia o dell'inserimento, la prenotazione viene restituita al pool.
  *
  * Parametri:
  *    cliente: stringa costante contenente il nome del cliente che effettua la prenotazione.
@@ -50,49 +259,71 @@ struct prenotazione {
  *    un puntatore a prenotazione o NULL
  *
  * Side-effect:
- *    - Alloca memoria dinamica per la struttura 'Prenotazione' e per le stringhe 'cliente' e 'targa' e Intervallo 'date'.
+ *    - Preleva la struttura 'Prenotazione' dal pool condiviso e l'Intervallo 'date' dal pool
+ *    degli intervalli; alloca memoria dinamica solo per clienti più lunghi del buffer interno.
+ *    - Registra la prenotazione nell'indice globale per identificativo.
  */
 Prenotazione crea_prenotazione(const char *cliente, const char *targa, Intervallo i, double costo) {
-    Prenotazione p = calloc(1, sizeof(struct prenotazione));
-    if (p == NULL) return NULL;
-
-    p->cliente = cliente ? mia_strdup(cliente) : NULL;
-    if (cliente != NULL && p->cliente == NULL) {
-        free(p);
-        return NULL;
-    }
-
-    p->targa = targa ? mia_strdup(targa) : NULL;
+    return nuova_prenotazione(ultimo_id + 1, cliente, targa, i, costo);
+}
 
-    if (targa != NULL && p->targa == NULL) {
-        free(p->cliente);
-        free(p);
-        return NULL;
-    }
+/*
+ * Funzione: crea_prenotazione_con_id
+ * ----------------------------------
+ * Crea una prenotazione con un identificativo già noto, come quello letto da un archivio
+ * o dal giornale.
+ *
+ * Implementazione:
+ *    Con `id` uguale a 0 si comporta come `crea_prenotazione`. Se una prenotazione con
+ *    lo stesso identificativo e gli stessi dati è ancora viva (ad esempio perché lo storico
+ *    del cliente è già stato caricato) ne restituisce un nuovo riferimento con
+ *    `condividi_prenotazione`: le viste caricate separatamente tornano così a condividere
+ *    un'unica prenotazione. Se i dati sono diversi l'identificativo appartiene a un'altra
+ *    prenotazione (ad esempio un archivio caricato due volte dopo una modifica) e ne
+ *    viene assegnato uno nuovo. Altrimenti la crea con quell'identificativo.
+ *
+ * Parametri:
+ *    id: l'identificativo, 0 per assegnarne uno nuovo.
+ *    cliente, targa, i, costo: come in `crea_prenotazione`.
+ *
+ * Pre-condizioni:
+ *    come in `crea_prenotazione`
+ *
+ * Post-condizioni:
+ *    restituisce la prenotazione con identificativo `id` (o con uno nuovo, se `id` è
+ *    già usato da una prenotazione diversa), o NULL in caso di errore di allocazione
+ *
+ * Ritorna:
+ *    un puntatore a prenotazione o NULL
+ *
+ * Side-effect:
+ *    come `crea_prenotazione`; gli identificativi assegnati in seguito saranno maggiori di `id`
+ */
+Prenotazione crea_prenotazione_con_id(uint64_t id, const char *cliente, const char *targa, Intervallo i, double costo) {
+    if (id == 0) return crea_prenotazione(cliente, targa, i, costo);
 
-    p->date = duplica_intervallo(i);
-    if (i != NULL && p->date == NULL) {
-        free(p->cliente);
-        free(p->targa);
-        free(p);
-        return NULL;
+    Prenotazione esistente = cerca_prenotazione_per_id(id);
+    if (esistente != NULL) {
+        if (stessi_dati(esistente, cliente, targa, i, costo)) return condividi_prenotazione(esistente);
+        return crea_prenotazione(cliente, targa, i, costo);
     }
 
-    p->costo = costo;
-
-    return p;
+    return nuova_prenotazione(id, cliente, targa, i, costo);
 }
 
 /*
  * Funzione: distruggi_prenotazione
  * -------------------------------
- * Libera la memoria allocata per una data prenotazione.
+ * Rilascia un riferimento alla prenotazione e, se era l'ultimo, libera la memoria.
  *
  * Implementazione:
  *    Verifica che il puntatore 'p' non sia NULL altrimenti ferma la funzione.
- *    Invoca `distruggi_intervallo` per deallocare correttamente l'intervallo associato,
- *    successivamente, libera la memoria allocata per le stringhe 'targa' e 'cliente'
- *    Infine, dealloca la struttura 'prenotazione' stessa.
+ *    Decrementa `riferimenti`: se altre viste (l'albero del veicolo, lo storico del
+ *    cliente, una lista ottenuta in lettura) la condividono ancora, si ferma.
+ *    Altrimenti toglie la prenotazione dall'indice per identificativo e invoca
+ *    `distruggi_intervallo` per deallocare correttamente l'intervallo associato,
+ *    successivamente, libera l'eventuale copia dinamica del 'cliente'.
+ *    Infine, restituisce la struttura 'prenotazione' stessa al pool condiviso.
  *
  * Parametri:
  *    p: puntatore alla prenotazione da distruggere.
@@ -104,16 +335,17 @@ Prenotazione crea_prenotazione(const char *cliente, const char *targa, Intervall
  *    non restituisce niente
  *
  * Side-effect:
- *    - La memoria associata alla prenotazione 'p' (inclusi i campi interni 'cliente', 'targa' e 'intervallo')
- *    viene deallocata.
+ *    - Al rilascio dell'ultimo riferimento, la memoria associata alla prenotazione 'p'
+ *    (inclusi i campi interni 'cliente', 'targa' e 'intervallo') viene deallocata.
  */
 void distruggi_prenotazione(Prenotazione p) {
     if (p == NULL) return;
+    if (--p->riferimenti > 0) return;
 
+    togli_da_indice(p);
     distruggi_intervallo(p->date); // Distrugge l'intervallo associato
-    free(p->targa);
-    free(p->cliente);
-    free(p);
+    imposta_stringa_cliente(p, NULL);
+    rilascia_in_pool(pool_prenotazioni, p);
 }
 
 /*
@@ -250,10 +482,9 @@ double ottieni_costo_prenotazione(Prenotazione p) {
  * Modifica il nome del cliente associato alla prenotazione.
  *
  * Implementazione:
- *    Verifica che il puntatore 'p' non sia NULL. Prima di assegnare il nuovo nome,
- *    la vecchia stringa del cliente viene liberata per evitare memory leak.
- *    Successivamente, la nuova stringa 'cliente' viene duplicata usando `mia_strdup`
- *    e il puntatore risultante viene assegnato al campo 'cliente' della struttura.
+ *    Verifica che il puntatore 'p' non sia NULL. Delega a `imposta_stringa_cliente`,
+ *    che libera l'eventuale copia dinamica precedente e copia la nuova stringa nel
+ *    buffer interno, duplicandola con `mia_strdup` solo se troppo lunga.
  *
  * Parametri:
  *    p: puntatore alla prenotazione.
@@ -269,15 +500,14 @@ double ottieni_costo_prenotazione(Prenotazione p) {
  * Side-effect:
  *    - Il nome del cliente nella prenotazione 'p' viene aggiornato con la nuova stringa 'cliente'.
  *    - Se 'p' è NULL, la funzione non ha alcun effetto.
- *    - Dealloca la memoria precedentemente allocata per il vecchio nome del cliente.
- *    - Alloca nuova memoria dinamica per duplicare la stringa 'cliente'.
+ *    - Dealloca l'eventuale copia dinamica del vecchio nome del cliente.
+ *    - Alloca memoria dinamica solo se la stringa 'cliente' non entra nel buffer interno.
  *    - Modifica la memoria interna della struttura 'Prenotazione'.
  */
 void imposta_cliente_prenotazione(Prenotazione p, const char *cliente) {
     if (p == NULL) return;
 
-    free(p->cliente); // Libera la vecchia stringa
-    p->cliente = mia_strdup(cliente); // Alloca e copia la nuova stringa
+    imposta_stringa_cliente(p, cliente);
 }
 
 /*
@@ -286,10 +516,9 @@ void imposta_cliente_prenotazione(Prenotazione p, const char *cliente) {
  * Modifica la targa del veicolo associato alla prenotazione.
  *
  * Implementazione:
- *    Verifica che il puntatore 'p' non sia NULL. Prima di assegnare la nuova targa,
- *    la vecchia stringa della targa viene liberata per evitare memory leak.
- *    Successivamente, la nuova stringa 'targa' viene duplicata usando `mia_strdup`
- *    e il puntatore risultante viene assegnato al campo 'targa' della struttura.
+ *    Verifica che il puntatore 'p' non sia NULL. La nuova stringa 'targa' viene
+ *    copiata con `snprintf` nel campo a dimensione fissa della struttura,
+ *    come avviene per la targa di un veicolo.
  *
  * Parametri:
  *    p: puntatore alla prenotazione.
@@ -304,15 +533,12 @@ void imposta_cliente_prenotazione(Prenotazione p, const char *cliente) {
  *
  * Side-effect:
  *    - La targa del veicolo nella prenotazione 'p' viene aggiornata con la nuova stringa 'targa'.
- *    - Dealloca la memoria precedentemente allocata per la vecchia targa del veicolo.
- *    - Alloca nuova memoria dinamica per duplicare la stringa 'targa'.
  *    - Modifica la memoria interna della struttura 'Prenotazione'.
  */
 void imposta_veicolo_prenotazione(Prenotazione p, const char *targa){
-    if(p == NULL) return;
+    if(p == NULL || targa == NULL) return;
 
-    free(p->targa); // Libera la vecchia stringa
-    p->targa = mia_strdup(targa); // Alloca e copia la nuova stringa
+    snprintf(p->targa, NUM_CARATTERI_TARGA, "%s", targa);
 }
 
 /*
@@ -393,7 +619,8 @@ void imposta_costo_prenotazione(Prenotazione p, double costo) {
  *    Successivamente, crea una nuova prenotazione utilizzando la funzione
  *    `crea_prenotazione`, passando le stringhe originali 'cliente' e 'targa'
  *    (che verranno duplicate internamente da `crea_prenotazione`) e la copia
- *    dell'intervallo e il costo.
+ *    dell'intervallo e il costo. La copia è una prenotazione distinta e riceve
+ *    quindi un nuovo identificativo.
  *
  * Parametri:
  *    p: puntatore alla prenotazione da duplicare.
@@ -420,6 +647,292 @@ Prenotazione duplica_prenotazione(Prenotazione p) {
     return copia;
 }
 
+/*
+ * Funzione: condividi_prenotazione
+ * --------------------------------
+ * Restituisce un nuovo riferimento alla stessa prenotazione, senza copiarla.
+ *
+ * Implementazione:
+ *    Incrementa `riferimenti`: ogni riferimento va rilasciato con `distruggi_prenotazione`
+ *    e la prenotazione viene liberata solo al rilascio dell'ultimo. Le modifiche fatte
+ *    con le funzioni `imposta_*` sono quindi visibili da tutte le viste che la condividono.
+ *
+ * Parametri:
+ *    p: la prenotazione da condividere.
+ *
+ * Pre-condizioni:
+ *    p: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce `p`
+ *
+ * Ritorna:
+ *    un puntatore a prenotazione o NULL se 'p' è NULL
+ *
+ * Side-effect:
+ *    incrementa il contatore dei riferimenti di 'p'
+ */
+Prenotazione condividi_prenotazione(Prenotazione p) {
+    if (p == NULL) return NULL;
+
+    p->riferimenti++;
+    return p;
+}
+
+/*
+ * Funzione: ottieni_precedente_storico
+ * ------------------------------------
+ * Restituisce la prenotazione che precede 'p' nello storico del cliente.
+ *
+ * Implementazione:
+ *    Legge il collegamento mantenuto da `imposta_vicine_storico`.
+ *
+ * Parametri:
+ *    p: la prenotazione.
+ *
+ * Pre-condizioni:
+ *    p: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce la precedente, NULL se 'p' è in testa, fuori da uno storico o NULL
+ *
+ * Ritorna:
+ *    un puntatore a prenotazione o NULL
+ *
+ * Side-effect:
+ *    nessuno
+ */
+Prenotazione ottieni_precedente_storico(const Prenotazione p) {
+    if (p == NULL) return NULL;
+    return p->precedente_storico;
+}
+
+/*
+ * Funzione: ottieni_successiva_storico
+ * ------------------------------------
+ * Restituisce la prenotazione che segue 'p' nello storico del cliente.
+ *
+ * Implementazione:
+ *    Legge il collegamento mantenuto da `imposta_vicine_storico`.
+ *
+ * Parametri:
+ *    p: la prenotazione.
+ *
+ * Pre-condizioni:
+ *    p: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce la successiva, NULL se 'p' è in coda, fuori da uno storico o NULL
+ *
+ * Ritorna:
+ *    un puntatore a prenotazione o NULL
+ *
+ * Side-effect:
+ *    nessuno
+ */
+Prenotazione ottieni_successiva_storico(const Prenotazione p) {
+    if (p == NULL) return NULL;
+    return p->successiva_storico;
+}
+
+/*
+ * Funzione: imposta_vicine_storico
+ * --------------------------------
+ * Collega 'p' alle prenotazioni che la precedono e la seguono nello storico del cliente.
+ *
+ * Implementazione:
+ *    Lo storico è una lista doppia i cui collegamenti stanno nelle prenotazioni stesse:
+ *    non servono nodi separati e una prenotazione si stacca in tempo costante. Aggiorna
+ *    solo 'p', che viene segnata come appartenente a uno storico; le vicine vanno
+ *    collegate dal chiamante (il modulo `data`).
+ *
+ * Parametri:
+ *    p: la prenotazione da collegare.
+ *    precedente: la prenotazione precedente, NULL se 'p' è in testa.
+ *    successiva: la prenotazione successiva, NULL se 'p' è in coda.
+ *
+ * Pre-condizioni:
+ *    p: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    modifica i collegamenti di 'p'
+ */
+void imposta_vicine_storico(Prenotazione p, Prenotazione precedente, Prenotazione successiva) {
+    if (p == NULL) return;
+
+    p->precedente_storico = precedente;
+    p->successiva_storico = successiva;
+    p->nello_storico = 1;
+}
+
+/*
+ * Funzione: scollega_da_storico
+ * -----------------------------
+ * Segna 'p' come non appartenente ad alcuno storico.
+ *
+ * Implementazione:
+ *    Azzera i collegamenti e l'indicatore `nello_storico`; come per
+ *    `imposta_vicine_storico`, le vicine vanno ricollegate dal chiamante.
+ *
+ * Parametri:
+ *    p: la prenotazione da scollegare.
+ *
+ * Pre-condizioni:
+ *    p: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    modifica i collegamenti di 'p'
+ */
+void scollega_da_storico(Prenotazione p) {
+    if (p == NULL) return;
+
+    p->precedente_storico = NULL;
+    p->successiva_storico = NULL;
+    p->nello_storico = 0;
+}
+
+/*
+ * Funzione: appartiene_a_storico
+ * ------------------------------
+ * Indica se 'p' è collegata allo storico di un cliente.
+ *
+ * Implementazione:
+ *    Legge l'indicatore mantenuto da `imposta_vicine_storico` e `scollega_da_storico`:
+ *    una prenotazione sola nello storico non ha vicine, quindi i collegamenti non bastano.
+ *
+ * Parametri:
+ *    p: la prenotazione.
+ *
+ * Pre-condizioni:
+ *    p: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se 'p' appartiene a uno storico, 0 altrimenti o se 'p' è NULL
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(0 o 1)
+ *
+ * Side-effect:
+ *    nessuno
+ */
+Byte appartiene_a_storico(const Prenotazione p) {
+    if (p == NULL) return 0;
+    return p->nello_storico;
+}
+
+/*
+ * Funzione: ottieni_id_prenotazione
+ * ---------------------------------
+ * Restituisce l'identificativo della prenotazione.
+ *
+ * Implementazione:
+ *    Legge il campo `id`, assegnato alla creazione e mai cambiato.
+ *
+ * Parametri:
+ *    p: la prenotazione.
+ *
+ * Pre-condizioni:
+ *    p: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce l'identificativo, 0 se 'p' è NULL
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit, maggiore di 0 per ogni prenotazione
+ *
+ * Side-effect:
+ *    nessuno
+ */
+uint64_t ottieni_id_prenotazione(const Prenotazione p) {
+    if (p == NULL) return 0;
+    return p->id;
+}
+
+/*
+ * Funzione: cerca_prenotazione_per_id
+ * -----------------------------------
+ * Cerca tra le prenotazioni vive quella con l'identificativo dato.
+ *
+ * Implementazione:
+ *    Una sola ricerca nell'indice globale, in tempo costante medio.
+ *
+ * Parametri:
+ *    id: l'identificativo cercato.
+ *
+ * Pre-condizioni:
+ *    nessuna
+ *
+ * Post-condizioni:
+ *    restituisce la prenotazione, NULL se nessuna prenotazione viva ha quell'identificativo
+ *
+ * Ritorna:
+ *    un puntatore a prenotazione o NULL. Il riferimento non viene incrementato.
+ *
+ * Side-effect:
+ *    nessuno
+ */
+Prenotazione cerca_prenotazione_per_id(uint64_t id) {
+    if (id == 0 || num_indicizzate == 0) return NULL;
+    return indice_id[cella_indice(id)];
+}
+
+/*
+ * Funzione: riserva_id_prenotazioni
+ * ---------------------------------
+ * Garantisce che i prossimi identificativi assegnati siano maggiori di `id`.
+ *
+ * Implementazione:
+ *    Porta `ultimo_id` almeno a `id`; non lo riduce mai.
+ *
+ * Parametri:
+ *    id: l'identificativo più alto già usato, ad esempio quello salvato in un archivio.
+ *
+ * Pre-condizioni:
+ *    nessuna
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    modifica il contatore globale degli identificativi
+ */
+void riserva_id_prenotazioni(uint64_t id) {
+    if (id > ultimo_id) ultimo_id = id;
+}
+
+/*
+ * Funzione: ottieni_ultimo_id_prenotazione
+ * ----------------------------------------
+ * Restituisce l'identificativo più alto assegnato o riservato finora.
+ *
+ * Implementazione:
+ *    Legge il contatore globale `ultimo_id`.
+ *
+ * Parametri:
+ *    Nessuno
+ *
+ * Pre-condizioni:
+ *    Nessuna
+ *
+ * Post-condizioni:
+ *    restituisce l'ultimo identificativo, 0 se non ne è stato assegnato nessuno
+ *
+ * Ritorna:
+ *    un intero senza segno a 64 bit
+ *
+ * Side-effect:
+ *    nessuno
+ */
+uint64_t ottieni_ultimo_id_prenotazione(void) {
+    return ultimo_id;
+}
+
 /*
  * Funzione: prenotazione_in_stringa
  * --------------------------------
@@ -479,3 +992,28 @@ char* prenotazione_in_stringa(Prenotazione p) {
     free(date_str); // Libera la memoria allocata da intervallo_in_stringa
     return buffer;
 }
+
+/*
+ * Funzione: ottieni_statistiche_pool_prenotazione
+ * -----------------------------------------------
+ * Restituisce i contatori del pool condiviso delle prenotazioni.
+ *
+ * Implementazione:
+ *    Delega a `ottieni_statistiche_pool`; se il pool non è ancora stato creato
+ *    i contatori sono tutti a zero.
+ *
+ * Parametri:
+ *    Nessuno
+ *
+ * Pre-condizioni:
+ *    Nessuna
+ *
+ * Post-condizioni:
+ *    restituisce le statistiche del pool delle prenotazioni
+ *
+ * Ritorna:
+ *    una struttura StatistichePool
+ */
+StatistichePool ottieni_statistiche_pool_prenotazione(void) {
+    return ottieni_statistiche_pool(pool_prenotazioni);
+}
@@ -19,8 +19,49 @@ struct utente {
     uint8_t password[DIMENSIONE_PASSWORD];
     Byte permesso;
     Data data;
+    SorgenteStorico *sorgente;     // Se non è NULL, lo storico non è ancora stato costruito
+    unsigned int prima_prenotazione;
+    unsigned int num_prenotazioni;
 };
 
+/*
+ * Funzione: rilascia_sorgente
+ * ---------------------------
+ * Rilascia il riferimento dell'utente alla sorgente dello storico.
+ *
+ * Implementazione:
+ *    Decrementa i riferimenti della sorgente e la libera se era l'ultimo.
+ */
+static void rilascia_sorgente(Utente utente){
+    if(utente->sorgente == NULL) return;
+
+    if(--utente->sorgente->riferimenti == 0) utente->sorgente->rilascia(utente->sorgente);
+    utente->sorgente = NULL;
+}
+
+/*
+ * Funzione: costruisci_storico_utente
+ * -----------------------------------
+ * Costruisce, se non è ancora stato fatto, lo storico dell'utente dalla sorgente.
+ *
+ * Implementazione:
+ *    In caso di errore la sorgente resta associata all'utente, così un accesso
+ *    successivo può riprovare.
+ *
+ * Ritorna:
+ *    la struttura Data dell'utente, NULL se è un admin o se la costruzione fallisce
+ */
+static Data costruisci_storico_utente(Utente utente){
+    if(utente->sorgente != NULL){
+        Data data = utente->sorgente->carica(utente->sorgente, utente->prima_prenotazione, utente->num_prenotazioni);
+        if(data == NULL) return NULL;
+
+        utente->data = data;
+        rilascia_sorgente(utente);
+    }
+    return utente->data;
+}
+
 /*
  * Funzione: crea_utente
  * ---------------------
@@ -80,10 +121,91 @@ Utente crea_utente(const char *email, const uint8_t *password,  const char *nome
     else {
         u->data = NULL;
     }
+    u->sorgente = NULL;
+    u->prima_prenotazione = 0;
+    u->num_prenotazioni = 0;
 
     return u;
 }
 
+/*
+ * Funzione: crea_cliente_differito
+ * --------------------------------
+ * Crea un nuovo cliente il cui storico verrà costruito dalla sorgente al primo accesso.
+ *
+ * Implementazione:
+ *    Crea l'utente come admin, così `crea_utente` non alloca la struttura Data,
+ *    poi imposta il permesso CLIENTE e memorizza sorgente e record. Lo storico
+ *    viene costruito dalle funzioni che lo leggono o lo modificano.
+ *
+ * Parametri:
+ *    email, password, nome, cognome: come in `crea_utente`
+ *    sorgente: la sorgente da cui costruire lo storico
+ *    prima: indice del primo record della sorgente che appartiene al cliente
+ *    num: numero di record che appartengono al cliente
+ *
+ * Pre-condizioni:
+ *    come in `crea_utente`
+ *    sorgente: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce un nuovo utente con permesso CLIENTE, in caso di errore restituisce NULL.
+ *    `ottieni_numero_prenotazioni_utente` restituisce `num` senza costruire lo storico
+ *
+ * Ritorna:
+ *    un puntatore a utente o NULL
+ *
+ * Side-effect:
+ *    alloca memoria dinamica per l'utente e incrementa i riferimenti della sorgente
+ */
+Utente crea_cliente_differito(const char *email, const uint8_t *password, const char *nome, const char *cognome,
+                              SorgenteStorico *sorgente, unsigned int prima, unsigned int num){
+    if(sorgente == NULL) return NULL;
+
+    Utente u = crea_utente(email, password, nome, cognome, ADMIN);
+    if(u == NULL) return NULL;
+
+    u->permesso = CLIENTE;
+    u->sorgente = sorgente;
+    u->prima_prenotazione = prima;
+    u->num_prenotazioni = num;
+    sorgente->riferimenti++;
+
+    return u;
+}
+
+/*
+ * Funzione: ottieni_storico_differito
+ * -----------------------------------
+ * Indica se lo storico dell'utente non è ancora stato costruito e, in quel caso,
+ * da quali record della sorgente verrà costruito.
+ *
+ * Implementazione:
+ *    Non costruisce lo storico: permette di copiarlo (ad esempio nel salvataggio)
+ *    senza costruire la lista.
+ *
+ * Parametri:
+ *    utente: puntatore all'oggetto `Utente`.
+ *    sorgente, prima, num: puntatori in cui salvare sorgente e record
+ *
+ * Pre-condizioni:
+ *    utente, sorgente, prima, num: non devono essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 e imposta i parametri se lo storico è ancora nella sorgente, 0 altrimenti
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(0 o 1)
+ */
+Byte ottieni_storico_differito(const Utente utente, SorgenteStorico **sorgente, unsigned int *prima, unsigned int *num){
+    if(utente == NULL || utente->sorgente == NULL || sorgente == NULL || prima == NULL || num == NULL) return 0;
+
+    *sorgente = utente->sorgente;
+    *prima = utente->prima_prenotazione;
+    *num = utente->num_prenotazioni;
+    return 1;
+}
+
 /*
  * Funzione: distruggi_utente
  * --------------------------
@@ -109,6 +231,7 @@ Utente crea_utente(const char *email, const uint8_t *password,  const char *nome
  */
 void distruggi_utente(Utente utente){
     if(utente == NULL) return;
+    rilascia_sorgente(utente);
     distruggi_data(utente->data);
     free(utente);
 }
@@ -304,6 +427,7 @@ void imposta_data(Utente utente, Data data) {
         return;
     }
 
+    rilascia_sorgente(utente);
     if (utente->data != NULL) {
         distruggi_data(utente->data);
     }
@@ -471,7 +595,8 @@ Byte ottieni_permesso(Utente utente){
  *
  * Implementazione:
  *    - Se `utente` è NULL, ritorna NULL.
- *    - Altrimenti chiama `ottieni_storico_lista` passando il campo `data`.
+ *    - Altrimenti chiama `ottieni_storico_lista` passando il campo `data`,
+ *    dopo averlo costruito dalla sorgente se è il primo accesso.
  *
  * Parametri:
  *    utente: puntatore all'oggetto `Utente`.
@@ -490,17 +615,49 @@ ListaPre ottieni_storico_utente(Utente utente) {
         return NULL;
     }
 
-    return ottieni_storico_lista(utente->data);
+    return ottieni_storico_lista(costruisci_storico_utente(utente));
+}
+
+/*
+ * Funzione: visita_storico_utente
+ * -------------------------------
+ * Chiama `visita` su ogni prenotazione dello storico di un utente, senza copiarle.
+ *
+ * Implementazione:
+ *    Costruisce lo storico se necessario e delega a `visita_storico_lista`.
+ *
+ * Parametri:
+ *    utente: puntatore all'oggetto `Utente`.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    utente: può essere NULL (nessuna operazione)
+ *    visita: non deve essere NULL
+ *    `visita` non deve modificare lo storico.
+ *
+ * Post-condizioni:
+ *    non restituisce niente. Al primo accesso lo storico viene costruito dalla sorgente.
+ *
+ * Side-effect:
+ *    gli effetti sono quelli di `visita`
+ */
+void visita_storico_utente(Utente utente, void (*visita)(const Prenotazione p, void *contesto), void *contesto){
+    if(utente == NULL || visita == NULL) return;
+
+    visita_storico_lista(costruisci_storico_utente(utente), visita, contesto);
 }
 
 /*
  * Funzione: aggiungi_a_storico_utente
  * -----------------------------------
- * Aggiunge una prenotazione allo storico di un utente.
+ * Aggiunge una prenotazione allo storico di un utente. Lo storico ne tiene un
+ * riferimento condiviso (non una copia): il chiamante mantiene il proprio.
  *
  * Implementazione:
  *    - Se `utente` è NULL, ritorna 0.
- *    - Chiama `aggiungi_a_storico_lista` con lo storico dati dell'utente e la prenotazione.
+ *    - Chiama `aggiungi_a_storico_lista` con lo storico dati dell'utente (costruito
+ *    dalla sorgente se è il primo accesso) e la prenotazione.
  *
  * Parametri:
  *    utente: puntatore all'oggetto `Utente`.
@@ -524,21 +681,19 @@ Byte aggiungi_a_storico_utente(Utente utente, Prenotazione prenotazione) {
         return 0;
     }
 
-    return aggiungi_a_storico_lista(utente->data, prenotazione);
+    return aggiungi_a_storico_lista(costruisci_storico_utente(utente), prenotazione);
 }
 
 /*
  * Funzione: rimuovi_da_storico_utente
  * -----------------------------------
- * Rimuove una prenotazione dallo storico di un utente.
- * Se lo storico risulta vuoto dopo la rimozione, imposta lo storico a NULL.
+ * Rimuove una prenotazione dallo storico di un utente, in tempo costante se
+ * `prenotazione` proviene dal suo storico.
  *
  * Implementazione:
  *    - Se `utente` è NULL, ritorna 0.
- *    - Chiama `rimuovi_da_storico_lista` per rimuovere la prenotazione.
- *    - Se dopo la rimozione lo storico è vuoto e la rimozione ha avuto successo,
- *    imposta lo storico a NULL e ritorna 1.
- *    - Altrimenti ritorna il codice di ritorno della rimozione.
+ *    - Chiama `rimuovi_da_storico_lista` con lo storico dati dell'utente (costruito
+ *    dalla sorgente se è il primo accesso) e ne ritorna il codice.
  *
  * Parametri:
  *    utente: puntatore all'oggetto `Utente`.
@@ -562,14 +717,7 @@ Byte rimuovi_da_storico_utente(Utente utente, Prenotazione prenotazione) {
         return 0;
     }
 
-    Byte codice = rimuovi_da_storico_lista(utente->data, prenotazione);
-
-    if(!ottieni_numero_prenotazioni(utente->data) && !codice){
-        imposta_storico_lista(utente->data, NULL);
-        return 1;
-    }
-
-    return codice;
+    return rimuovi_da_storico_lista(costruisci_storico_utente(utente), prenotazione);
 }
 
 /*
@@ -579,6 +727,8 @@ Byte rimuovi_da_storico_utente(Utente utente, Prenotazione prenotazione) {
  *
  * Implementazione:
  *    - Se `utente` è NULL, ritorna 0.
+ *    - Se lo storico non è ancora stato costruito, ritorna il numero di record
+ *    della sorgente senza costruirlo.
  *    - Altrimenti chiama `ottieni_numero_prenotazioni` sul campo `data` dell'utente.
  *
  * Parametri:
@@ -595,6 +745,7 @@ Byte rimuovi_da_storico_utente(Utente utente, Prenotazione prenotazione) {
  */
 unsigned int ottieni_numero_prenotazioni_utente(Utente u){
     if(u == NULL) return 0;
+    if(u->sorgente != NULL) return u->num_prenotazioni;
 
     return ottieni_numero_prenotazioni(u->data);
 }
@@ -629,6 +780,7 @@ Byte crea_nuova_data(Utente u){
         return 0;
     }
 
+    rilascia_sorgente(u);
     distruggi_data(u->data);
 
     if(u->permesso == CLIENTE){
@@ -19,8 +19,69 @@ struct veicolo{
     double tariffa;
 	char tipo_veicolo[MAX_LUNGHEZZA_TIPO];
     Prenotazioni prenotazioni;
+    SorgentePrenotazioni *sorgente;     // Se non è NULL, le prenotazioni non sono ancora state costruite
+    unsigned int prima_prenotazione;
+    unsigned int num_prenotazioni;
+    OsservatoreVeicolo osservatore;     // Passato alle prenotazioni quando vengono costruite
+    void *contesto_osservatore;
+};
+
+// Visita degli intervalli di un albero già costruito, da `visita_intervalli_veicolo`
+struct visita_intervalli {
+    VisitatoreIntervalli visitatore;
+    void *contesto;
 };
 
+/*
+ * Funzione: rilascia_sorgente
+ * ---------------------------
+ * Rilascia il riferimento del veicolo alla sorgente delle prenotazioni.
+ *
+ * Implementazione:
+ *    Decrementa i riferimenti della sorgente e la libera se era l'ultimo.
+ */
+static void rilascia_sorgente(Veicolo v){
+    if(v->sorgente == NULL) return;
+
+    if(--v->sorgente->riferimenti == 0) v->sorgente->rilascia(v->sorgente);
+    v->sorgente = NULL;
+}
+
+/*
+ * Funzione: costruisci_prenotazioni_veicolo
+ * -----------------------------------------
+ * Costruisce, se non è ancora stato fatto, le prenotazioni del veicolo dalla sorgente.
+ *
+ * Implementazione:
+ *    In caso di errore la sorgente resta associata al veicolo, così un accesso
+ *    successivo può riprovare.
+ *
+ * Ritorna:
+ *    le prenotazioni del veicolo, NULL se la costruzione fallisce
+ */
+static Prenotazioni costruisci_prenotazioni_veicolo(Veicolo v){
+    if(v->sorgente != NULL){
+        Prenotazioni prenotazioni = v->sorgente->carica(v->sorgente, v->prima_prenotazione, v->num_prenotazioni);
+        if(prenotazioni == NULL) return NULL;
+
+        v->prenotazioni = prenotazioni;
+        rilascia_sorgente(v);
+        if(v->osservatore != NULL) imposta_osservatore_prenotazioni(prenotazioni, v->osservatore, v->contesto_osservatore);
+    }
+    return v->prenotazioni;
+}
+
+/*
+ * Funzione: visita_intervallo_prenotazione
+ * ----------------------------------------
+ * Visitatore dell'albero che passa gli estremi della prenotazione a `visita_intervalli_veicolo`.
+ */
+static void visita_intervallo_prenotazione(const Prenotazione p, void *contesto){
+    struct visita_intervalli *visita = contesto;
+    Intervallo i = ottieni_intervallo_prenotazione(p);
+    visita->visitatore(inizio_intervallo(i), fine_intervallo(i), visita->contesto);
+}
+
 /*
  * Funzione: crea_veicolo
  * ----------------------
@@ -73,10 +134,160 @@ Veicolo crea_veicolo(const char *tipo, const char *targa, const char *modello, c
     v->tariffa = tariffa;
 
     v->prenotazioni = prenotazioni;
+    v->sorgente = NULL;
+    v->prima_prenotazione = 0;
+    v->num_prenotazioni = 0;
+    v->osservatore = NULL;
+    v->contesto_osservatore = NULL;
+
+    return v;
+}
+
+/*
+ * Funzione: crea_veicolo_differito
+ * --------------------------------
+ * Crea un nuovo veicolo le cui prenotazioni verranno costruite dalla sorgente
+ * al primo accesso
+ *
+ * Implementazione:
+ *    Crea il veicolo senza prenotazioni e memorizza sorgente e record; le
+ *    prenotazioni vengono costruite da `ottieni_prenotazioni` e dalle funzioni
+ *    che le modificano.
+ *
+ * Parametri:
+ *    tipo, targa, modello, posizione, tariffa: come in `crea_veicolo`
+ *    sorgente: la sorgente da cui costruire le prenotazioni
+ *    prima: indice del primo record della sorgente che appartiene al veicolo
+ *    num: numero di record che appartengono al veicolo
+ *
+ * Pre-condizioni:
+ *    come in `crea_veicolo`
+ *    sorgente: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce un nuovo oggetto Veicolo se l'allocazione è andata a buon fine,
+ *    altrimenti restituisce NULL
+ *
+ * Ritorna:
+ *    Un oggetto di tipo Veicolo oppure NULL
+ *
+ * Side-effect:
+ *    alloca memoria dinamicamente per il veicolo e incrementa i riferimenti della sorgente
+ */
+Veicolo crea_veicolo_differito(const char *tipo, const char *targa, const char *modello, const char *posizione, double tariffa,
+                               SorgentePrenotazioni *sorgente, unsigned int prima, unsigned int num){
+    if(sorgente == NULL) return NULL;
+
+    Veicolo v = crea_veicolo(tipo, targa, modello, posizione, tariffa, NULL);
+    if(v == NULL) return NULL;
+
+    v->sorgente = sorgente;
+    v->prima_prenotazione = prima;
+    v->num_prenotazioni = num;
+    sorgente->riferimenti++;
 
     return v;
 }
 
+/*
+ * Funzione: ottieni_prenotazioni_differite
+ * ----------------------------------------
+ * Indica se le prenotazioni del veicolo non sono ancora state costruite e, in
+ * quel caso, da quali record della sorgente verranno costruite
+ *
+ * Implementazione:
+ *    Non costruisce le prenotazioni: permette di copiarle (ad esempio nel
+ *    salvataggio) senza costruire l'albero.
+ *
+ * Parametri:
+ *    v: puntatore ad un veicolo
+ *    sorgente, prima, num: puntatori in cui salvare sorgente e record
+ *
+ * Pre-condizioni:
+ *    v, sorgente, prima, num: non devono essere NULL
+ *
+ * Post-condizione:
+ *    restituisce 1 e imposta i parametri se le prenotazioni sono ancora nella
+ *    sorgente, 0 altrimenti
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ */
+Byte ottieni_prenotazioni_differite(const Veicolo v, SorgentePrenotazioni **sorgente, unsigned int *prima, unsigned int *num){
+    if(v == NULL || v->sorgente == NULL || sorgente == NULL || prima == NULL || num == NULL) return 0;
+
+    *sorgente = v->sorgente;
+    *prima = v->prima_prenotazione;
+    *num = v->num_prenotazioni;
+    return 1;
+}
+
+/*
+ * Funzione: visita_intervalli_veicolo
+ * -----------------------------------
+ * Visita gli estremi delle prenotazioni del veicolo che si sovrappongono a [da, a),
+ * senza costruire le prenotazioni se sono ancora nella sorgente
+ *
+ * Implementazione:
+ *    Se il veicolo è differito delega alla `visita` della sorgente, che legge i
+ *    record senza creare prenotazioni; altrimenti usa `visita_prenotazioni_in_intervallo`.
+ *
+ * Parametri:
+ *    v: puntatore ad un veicolo
+ *    da, a: estremi dell'intervallo da visitare
+ *    visitatore: funzione chiamata per ogni prenotazione
+ *    contesto: puntatore passato al visitatore
+ *
+ * Pre-condizioni:
+ *    v, visitatore: non devono essere NULL
+ *
+ * Post-condizione:
+ *    restituisce 1 se la visita è stata completata, 0 se la sorgente non è valida
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ */
+Byte visita_intervalli_veicolo(const Veicolo v, time_t da, time_t a, VisitatoreIntervalli visitatore, void *contesto){
+    if(v == NULL || visitatore == NULL) return 0;
+
+    if(v->sorgente != NULL)
+        return v->sorgente->visita(v->sorgente, v->prima_prenotazione, v->num_prenotazioni, da, a, visitatore, contesto);
+
+    struct visita_intervalli visita = { visitatore, contesto };
+    visita_prenotazioni_in_intervallo(v->prenotazioni, da, a, visita_intervallo_prenotazione, &visita);
+    return 1;
+}
+
+/*
+ * Funzione: imposta_osservatore_veicolo
+ * -------------------------------------
+ * Registra la funzione da avvisare dopo ogni inserimento o cancellazione di una
+ * prenotazione del veicolo, anche se le prenotazioni non sono ancora state costruite
+ *
+ * Implementazione:
+ *    Conserva l'osservatore nel veicolo e, se le prenotazioni esistono già, lo
+ *    registra con `imposta_osservatore_prenotazioni`; altrimenti lo registra
+ *    `costruisci_prenotazioni_veicolo` al primo accesso.
+ *
+ * Parametri:
+ *    v: puntatore ad un veicolo
+ *    osserva: la funzione da chiamare, NULL per rimuovere l'osservatore
+ *    contesto: puntatore passato a `osserva`
+ *
+ * Pre-condizioni:
+ *    v: non deve essere NULL
+ *
+ * Post-condizione:
+ *    non restituisce niente; un eventuale osservatore precedente viene sostituito
+ */
+void imposta_osservatore_veicolo(Veicolo v, OsservatoreVeicolo osserva, void *contesto){
+    if(v == NULL) return;
+
+    v->osservatore = osserva;
+    v->contesto_osservatore = osserva != NULL ? contesto : NULL;
+    if(v->sorgente == NULL) imposta_osservatore_prenotazioni(v->prenotazioni, osserva, contesto);
+}
+
 /*
  * Funzione: distruggi_veicolo
  * ---------------------------
@@ -100,6 +311,7 @@ Veicolo crea_veicolo(const char *tipo, const char *targa, const char *modello, c
  */
 void distruggi_veicolo(Veicolo v){
 	if(v == NULL) return;
+    rilascia_sorgente(v);
     distruggi_prenotazioni(v->prenotazioni);
     free(v);
 }
@@ -336,7 +548,8 @@ void imposta_tariffa(Veicolo v, double tariffa){
  *
  * Implementazione:
  *    Se il puntatore al veicolo è NULL, restituisce NULL, altrimenti
- *    restituisce l'albero contenente le prenotazioni del veicolo
+ *    restituisce l'albero contenente le prenotazioni del veicolo, dopo
+ *    averlo costruito dalla sorgente se è il primo accesso
  *
  * Parametri:
  *    v: puntatore ad un veicolo
@@ -352,7 +565,7 @@ void imposta_tariffa(Veicolo v, double tariffa){
  */
 Prenotazioni ottieni_prenotazioni(const Veicolo v){
     if(v == NULL) return NULL;
-    return v->prenotazioni;
+    return costruisci_prenotazioni_veicolo(v);
 }
 
 /*
@@ -382,6 +595,7 @@ Prenotazioni ottieni_prenotazioni(const Veicolo v){
  */
 void imposta_prenotazioni(Veicolo v, Prenotazioni prenotazioni){
     if(v == NULL) return;
+    rilascia_sorgente(v);
     v->prenotazioni = prenotazioni;
 }
 
@@ -499,7 +713,7 @@ Byte confronta_tipo(const Veicolo v, const char *tipo){
 Byte aggiungi_prenotazione_veicolo(Veicolo v, Prenotazione prenotazione){
 	if(v == NULL || prenotazione == NULL) return 0;
 
-	return aggiungi_prenotazione(v->prenotazioni, prenotazione);
+	return aggiungi_prenotazione(costruisci_prenotazioni_veicolo(v), prenotazione);
 }
 
 /*
@@ -531,7 +745,7 @@ Byte aggiungi_prenotazione_veicolo(Veicolo v, Prenotazione prenotazione){
 Byte rimuovi_prenotazione_veicolo(Veicolo v, Intervallo intervallo){
 	if(v == NULL || intervallo == NULL) return 0;
 
-	Byte codice = cancella_prenotazione(v->prenotazioni, intervallo);
+	Byte codice = cancella_prenotazione(costruisci_prenotazioni_veicolo(v), intervallo);
 
 	if(!codice) return 0;
 
@@ -0,0 +1,818 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "modelli/intervallo.h"
+#include "modelli/prenotazione.h"
+#include "modelli/veicolo.h"
+#include "strutture_dati/pool.h"
+#include "strutture_dati/prenotazioni.h"
+#include "strutture_dati/indice_disponibilita.h"
+#include "utils/vettore_bit.h"
+
+#define DURATA_FASCIA 3600      // Durata in secondi di una fascia dell'indice
+#define FASCE_PER_BLOCCO 256    // Fasce allocate insieme dal pool
+#define SECCHI_INIZIALI 64      // Dimensione iniziale della tabella delle fasce (potenza di 2)
+#define SECONDI_GIORNO 86400
+#define GIORNI_ORIZZONTE_INDICE 30      // Giorni indicizzati a partire dall'origine
+#define GIORNI_PRIMA_DI_SPOSTARE 2      // Giorni trascorsi dall'origine prima di spostare l'orizzonte
+
+/*
+ * Fascia oraria [numero * DURATA_FASCIA, (numero + 1) * DURATA_FASCIA) con almeno
+ * un veicolo occupato. Il bit `k` è a 1 se il k-esimo veicolo ha una prenotazione
+ * che si sovrappone alla fascia. Le fasce senza veicoli occupati non esistono.
+ */
+struct fascia {
+    long long numero;
+    unsigned int occupati;      // Numero di bit a 1
+    struct fascia *successiva;  // Catena nella tabella delle fasce
+    uint64_t bit[];
+};
+
+/*
+ * Veicolo indicizzato; è anche il contesto dell'osservatore delle sue prenotazioni,
+ * quindi non si sposta in memoria quando il vettore dei posti cresce.
+ */
+struct posto {
+    struct indice_disponibilita *indice;
+    Veicolo veicolo;
+    unsigned int k;                 // Posizione del bit del veicolo
+};
+
+/*
+ * Solo le fasce dell'orizzonte [origine, origine + GIORNI_ORIZZONTE_INDICE giorni)
+ * sono indicizzate, come nella mappa di occupazione delle prenotazioni: lo storico non
+ * occupa memoria e le interrogazioni fuori dall'orizzonte passano alle prenotazioni.
+ */
+struct indice_disponibilita {
+    struct posto **posti;           // Veicoli nell'ordine di restituzione
+    unsigned int num_veicoli;
+    unsigned int capacita_posti;
+    unsigned int parole;            // Parole a 64 bit di ogni vettore di bit, anche non ancora usate
+    struct fascia **secchi;         // Tabella delle fasce, indicizzata per numero di fascia
+    unsigned int num_secchi;
+    unsigned int num_fasce;
+    Pool fasce;                     // Pool da cui vengono allocate le fasce
+    time_t origine;                 // Inizio dell'orizzonte (mezzanotte UTC)
+    Byte valido;                    // 0 se la flotta è cambiata dopo l'ultima ricostruzione
+};
+
+/*
+ * Funzione: fascia_di
+ * -------------------
+ * Restituisce il numero della fascia che contiene l'istante `t`.
+ *
+ * Implementazione:
+ *    Divisione arrotondata verso il basso, corretta anche per istanti negativi.
+ *
+ * Parametri:
+ *    t: l'istante di tempo
+ *
+ * Ritorna:
+ *    il numero della fascia
+ */
+static long long fascia_di(time_t t){
+    long long q = (long long)t / DURATA_FASCIA;
+    if((long long)t % DURATA_FASCIA < 0) q--;
+    return q;
+}
+
+/*
+ * Funzione: fine_orizzonte
+ * ------------------------
+ * Restituisce il primo istante dopo l'orizzonte indicizzato.
+ */
+static time_t fine_orizzonte(const struct indice_disponibilita *indice){
+    return indice->origine + (time_t)GIORNI_ORIZZONTE_INDICE * SECONDI_GIORNO;
+}
+
+/*
+ * Funzione: limita_a_orizzonte
+ * ----------------------------
+ * Riduce [inizio, fine) alla parte che cade nell'orizzonte.
+ *
+ * Ritorna:
+ *    1 se ne resta una parte non vuota, 0 altrimenti
+ */
+static Byte limita_a_orizzonte(const struct indice_disponibilita *indice, time_t *inizio, time_t *fine){
+    if(*inizio < indice->origine) *inizio = indice->origine;
+    if(*fine > fine_orizzonte(indice)) *fine = fine_orizzonte(indice);
+    return *inizio < *fine;
+}
+
+/*
+ * Funzione: cerca_fascia
+ * ----------------------
+ * Cerca la fascia con il numero indicato.
+ *
+ * Parametri:
+ *    indice: l'indice in cui cercare
+ *    numero: il numero della fascia
+ *
+ * Pre-condizioni:
+ *    indice: non deve essere NULL e deve avere la tabella delle fasce allocata
+ *
+ * Ritorna:
+ *    la fascia, oppure NULL se nessun veicolo è occupato in quella fascia
+ */
+static struct fascia *cerca_fascia(const struct indice_disponibilita *indice, long long numero){
+    struct fascia *f = indice->secchi[(unsigned long long)numero & (indice->num_secchi - 1)];
+    while(f != NULL && f->numero != numero) f = f->successiva;
+    return f;
+}
+
+/*
+ * Funzione: ingrandisci_secchi
+ * ----------------------------
+ * Raddoppia la tabella delle fasce e vi ridistribuisce le fasce esistenti.
+ *
+ * Implementazione:
+ *    Le fasce sono indicizzate con i bit bassi del loro numero: fasce consecutive
+ *    finiscono in secchi consecutivi, quindi le catene restano corte.
+ *
+ * Parametri:
+ *    indice: l'indice da ingrandire
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 in caso di errore di allocazione (tabella invariata)
+ */
+static Byte ingrandisci_secchi(struct indice_disponibilita *indice){
+    unsigned int nuova_dimensione = indice->num_secchi * 2;
+    struct fascia **nuovi = calloc(nuova_dimensione, sizeof(struct fascia *));
+    if(nuovi == NULL) return 0;
+
+    for(unsigned int s = 0; s < indice->num_secchi; s++){
+        struct fascia *f = indice->secchi[s];
+        while(f != NULL){
+            struct fascia *successiva = f->successiva;
+            unsigned int d = (unsigned int)((unsigned long long)f->numero & (nuova_dimensione - 1));
+            f->successiva = nuovi[d];
+            nuovi[d] = f;
+            f = successiva;
+        }
+    }
+
+    free(indice->secchi);
+    indice->secchi = nuovi;
+    indice->num_secchi = nuova_dimensione;
+    return 1;
+}
+
+/*
+ * Funzione: ingrandisci_fasce
+ * ---------------------------
+ * Raddoppia le parole dei vettori di bit, per fare posto a nuovi veicoli.
+ *
+ * Implementazione:
+ *    Le fasce hanno dimensione fissa nel pool: vengono copiate in un nuovo pool con
+ *    le parole aggiunte a 0. Le copie sono inserite in una nuova tabella, così in
+ *    caso di errore l'indice resta invariato. Il costo, proporzionale alle fasce
+ *    dell'orizzonte, si ripete solo ogni volta che i veicoli raddoppiano.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 in caso di errore di allocazione
+ */
+static Byte ingrandisci_fasce(struct indice_disponibilita *indice){
+    unsigned int nuove_parole = indice->parole * 2;
+    Pool nuove = crea_pool(sizeof(struct fascia) + sizeof(uint64_t) * nuove_parole, FASCE_PER_BLOCCO);
+    struct fascia **nuovi = calloc(indice->num_secchi, sizeof(struct fascia *));
+    if(nuove == NULL || nuovi == NULL){
+        distruggi_pool(nuove);
+        free(nuovi);
+        return 0;
+    }
+
+    for(unsigned int s = 0; s < indice->num_secchi; s++){
+        for(struct fascia *f = indice->secchi[s]; f != NULL; f = f->successiva){
+            struct fascia *copia = alloca_da_pool(nuove);
+            if(copia == NULL){
+                distruggi_pool(nuove);
+                free(nuovi);
+                return 0;
+            }
+            copia->numero = f->numero;
+            copia->occupati = f->occupati;
+            memcpy(copia->bit, f->bit, sizeof(uint64_t) * indice->parole);
+            memset(copia->bit + indice->parole, 0, sizeof(uint64_t) * (nuove_parole - indice->parole));
+            copia->successiva = nuovi[s];
+            nuovi[s] = copia;
+        }
+    }
+
+    distruggi_pool(indice->fasce);
+    free(indice->secchi);
+    indice->fasce = nuove;
+    indice->secchi = nuovi;
+    indice->parole = nuove_parole;
+    return 1;
+}
+
+/*
+ * Funzione: ottieni_o_crea_fascia
+ * -------------------------------
+ * Restituisce la fascia con il numero indicato, creandola vuota se non esiste.
+ *
+ * Parametri:
+ *    indice: l'indice in cui cercare
+ *    numero: il numero della fascia
+ *
+ * Ritorna:
+ *    la fascia, oppure NULL in caso di errore di allocazione
+ *
+ * Side-effect:
+ *    può prelevare una fascia dal pool e ingrandire la tabella delle fasce
+ */
+static struct fascia *ottieni_o_crea_fascia(struct indice_disponibilita *indice, long long numero){
+    struct fascia *f = cerca_fascia(indice, numero);
+    if(f != NULL) return f;
+
+    // Un ingrandimento fallito lascia solo catene più lunghe
+    if(indice->num_fasce >= indice->num_secchi) ingrandisci_secchi(indice);
+
+    f = alloca_da_pool(indice->fasce);
+    if(f == NULL) return NULL;
+
+    memset(f->bit, 0, sizeof(uint64_t) * indice->parole);
+    f->numero = numero;
+    f->occupati = 0;
+
+    unsigned int s = (unsigned int)((unsigned long long)numero & (indice->num_secchi - 1));
+    f->successiva = indice->secchi[s];
+    indice->secchi[s] = f;
+    indice->num_fasce++;
+    return f;
+}
+
+/*
+ * Funzione: rimuovi_fascia
+ * ------------------------
+ * Toglie dalla tabella una fascia rimasta senza veicoli occupati.
+ *
+ * Parametri:
+ *    indice: l'indice che contiene la fascia
+ *    fascia: la fascia da rimuovere
+ *
+ * Side-effect:
+ *    restituisce la fascia al pool
+ */
+static void rimuovi_fascia(struct indice_disponibilita *indice, struct fascia *fascia){
+    struct fascia **p = &indice->secchi[(unsigned long long)fascia->numero & (indice->num_secchi - 1)];
+    while(*p != fascia) p = &(*p)->successiva;
+    *p = fascia->successiva;
+    rilascia_in_pool(indice->fasce, fascia);
+    indice->num_fasce--;
+}
+
+/*
+ * Funzione: segna_occupato
+ * ------------------------
+ * Imposta il bit del veicolo `k` in tutte le fasce dell'orizzonte toccate da [inizio, fine).
+ *
+ * Parametri:
+ *    indice: l'indice da aggiornare
+ *    k: posizione del veicolo
+ *    inizio, fine: estremi della prenotazione
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 in caso di errore di allocazione
+ */
+static Byte segna_occupato(struct indice_disponibilita *indice, unsigned int k, time_t inizio, time_t fine){
+    if(!limita_a_orizzonte(indice, &inizio, &fine)) return 1;
+
+    uint64_t maschera = (uint64_t)1 << (k % BIT_PER_PAROLA);
+    long long ultima = fascia_di(fine - 1);
+    for(long long n = fascia_di(inizio); n <= ultima; n++){
+        struct fascia *f = ottieni_o_crea_fascia(indice, n);
+        if(f == NULL) return 0;
+        if(!(f->bit[k / BIT_PER_PAROLA] & maschera)){
+            f->bit[k / BIT_PER_PAROLA] |= maschera;
+            f->occupati++;
+        }
+    }
+    return 1;
+}
+
+/*
+ * Funzione: segnala_presenza
+ * --------------------------
+ * Visitatore che segnala di aver incontrato almeno una prenotazione.
+ */
+static void segnala_presenza(const Prenotazione p, void *trovata){
+    (void)p;
+    *(Byte *)trovata = 1;
+}
+
+/*
+ * Funzione: segna_libero
+ * ----------------------
+ * Dopo la cancellazione di [inizio, fine) azzera il bit del veicolo `k` nelle
+ * fasce in cui non ha più prenotazioni.
+ *
+ * Implementazione:
+ *    Una fascia può contenere più prenotazioni dello stesso veicolo: per ogni
+ *    fascia toccata si chiede alle prenotazioni del veicolo, già costruite dalla
+ *    cancellazione, se ne resta qualcuna. Le fasce rimaste senza veicoli occupati
+ *    vengono rimosse.
+ *
+ * Parametri:
+ *    indice: l'indice da aggiornare
+ *    k: posizione del veicolo
+ *    inizio, fine: estremi della prenotazione rimossa
+ */
+static void segna_libero(struct indice_disponibilita *indice, unsigned int k, time_t inizio, time_t fine){
+    if(!limita_a_orizzonte(indice, &inizio, &fine)) return;
+
+    Prenotazioni prenotazioni = ottieni_prenotazioni(indice->posti[k]->veicolo);
+    uint64_t maschera = (uint64_t)1 << (k % BIT_PER_PAROLA);
+    long long ultima = fascia_di(fine - 1);
+    for(long long n = fascia_di(inizio); n <= ultima; n++){
+        struct fascia *f = cerca_fascia(indice, n);
+        if(f == NULL || !(f->bit[k / BIT_PER_PAROLA] & maschera)) continue;
+
+        Byte trovata = 0;
+        visita_prenotazioni_in_intervallo(prenotazioni, (time_t)(n * DURATA_FASCIA),
+                                          (time_t)((n + 1) * DURATA_FASCIA), segnala_presenza, &trovata);
+        if(trovata) continue;
+
+        f->bit[k / BIT_PER_PAROLA] &= ~maschera;
+        if(--f->occupati == 0) rimuovi_fascia(indice, f);
+    }
+}
+
+/*
+ * Funzione: notifica_prenotazione
+ * -------------------------------
+ * Osservatore registrato su ogni veicolo indicizzato.
+ *
+ * Implementazione:
+ *    Ignora le notifiche se l'indice non è valido (verrà ricostruito da capo).
+ *    Se un aggiornamento fallisce per mancanza di memoria l'indice viene invalidato,
+ *    così che non restituisca mai veicoli occupati.
+ */
+static void notifica_prenotazione(time_t inizio, time_t fine, Byte aggiunta, void *contesto){
+    struct posto *posto = contesto;
+    struct indice_disponibilita *indice = posto->indice;
+    if(!indice->valido) return;
+
+    if(aggiunta){
+        if(!segna_occupato(indice, posto->k, inizio, fine)) indice->valido = 0;
+    }else{
+        segna_libero(indice, posto->k, inizio, fine);
+    }
+}
+
+/*
+ * Contesto della visita che segna le prenotazioni di un veicolo.
+ */
+struct indicizzazione {
+    struct indice_disponibilita *indice;
+    unsigned int k;
+    Byte errore;
+};
+
+/*
+ * Funzione: indicizza_intervallo
+ * ------------------------------
+ * Visitatore che segna nell'indice una prenotazione già presente.
+ */
+static void indicizza_intervallo(time_t inizio, time_t fine, void *contesto){
+    struct indicizzazione *r = contesto;
+    if(r->errore) return;
+
+    if(!segna_occupato(r->indice, r->k, inizio, fine)) r->errore = 1;
+}
+
+/*
+ * Funzione: indicizza_veicolo
+ * ---------------------------
+ * Segna le prenotazioni del veicolo `k` che toccano [da, a).
+ *
+ * Implementazione:
+ *    Usa `visita_intervalli_veicolo`: le prenotazioni di un veicolo caricato
+ *    dall'archivio vengono lette dai record senza costruirne l'albero.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 in caso di errore
+ */
+static Byte indicizza_veicolo(struct indice_disponibilita *indice, unsigned int k, time_t da, time_t a){
+    struct indicizzazione r = { indice, k, 0 };
+    return visita_intervalli_veicolo(indice->posti[k]->veicolo, da, a, indicizza_intervallo, &r) && !r.errore;
+}
+
+/*
+ * Funzione: aggiungi_posto
+ * ------------------------
+ * Accoda un veicolo all'indice, ne segna le prenotazioni dell'orizzonte e si
+ * registra come suo osservatore.
+ *
+ * Implementazione:
+ *    Vettore dei posti e parole dei vettori di bit crescono raddoppiando.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 in caso di errore (il veicolo può essere rimasto
+ *    in parte segnato: l'indice va considerato non valido)
+ */
+static Byte aggiungi_posto(struct indice_disponibilita *indice, Veicolo veicolo){
+    if(indice->num_veicoli == indice->capacita_posti){
+        unsigned int capacita = indice->capacita_posti > 0 ? indice->capacita_posti * 2 : BIT_PER_PAROLA;
+        struct posto **posti = realloc(indice->posti, sizeof(struct posto *) * capacita);
+        if(posti == NULL) return 0;
+        indice->posti = posti;
+        indice->capacita_posti = capacita;
+    }
+    if(indice->num_veicoli == indice->parole * BIT_PER_PAROLA && !ingrandisci_fasce(indice)) return 0;
+
+    struct posto *posto = malloc(sizeof(struct posto));
+    if(posto == NULL) return 0;
+
+    unsigned int k = indice->num_veicoli++;
+    posto->indice = indice;
+    posto->veicolo = veicolo;
+    posto->k = k;
+    indice->posti[k] = posto;
+
+    if(!indicizza_veicolo(indice, k, indice->origine, fine_orizzonte(indice))) return 0;
+    imposta_osservatore_veicolo(veicolo, notifica_prenotazione, posto);
+    return 1;
+}
+
+/*
+ * Funzione: sposta_orizzonte
+ * --------------------------
+ * Sposta l'orizzonte al giorno di `adesso` quando ne ha superato l'inizio di almeno
+ * GIORNI_PRIMA_DI_SPOSTARE giorni.
+ *
+ * Implementazione:
+ *    Rimuove le fasce ormai passate e segna, per ogni veicolo, solo le prenotazioni
+ *    dei giorni entrati nell'orizzonte.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 in caso di errore (l'indice va ricostruito)
+ */
+static Byte sposta_orizzonte(struct indice_disponibilita *indice, time_t adesso){
+    if(adesso < indice->origine ||
+       adesso - indice->origine < (time_t)GIORNI_PRIMA_DI_SPOSTARE * SECONDI_GIORNO) return 1;
+
+    time_t vecchia_fine = fine_orizzonte(indice);
+    indice->origine = adesso - adesso % SECONDI_GIORNO;
+
+    long long prima = fascia_di(indice->origine);
+    for(unsigned int s = 0; s < indice->num_secchi; s++){
+        struct fascia **p = &indice->secchi[s];
+        while(*p != NULL){
+            struct fascia *f = *p;
+            if(f->numero >= prima){
+                p = &f->successiva;
+                continue;
+            }
+            *p = f->successiva;
+            rilascia_in_pool(indice->fasce, f);
+            indice->num_fasce--;
+        }
+    }
+
+    time_t da = vecchia_fine > indice->origine ? vecchia_fine : indice->origine;
+    for(unsigned int k = 0; k < indice->num_veicoli; k++)
+        if(!indicizza_veicolo(indice, k, da, fine_orizzonte(indice))) return 0;
+    return 1;
+}
+
+/*
+ * Funzione: svuota_indice
+ * -----------------------
+ * Libera fasce e veicoli dell'indice, che torna vuoto e non valido.
+ */
+static void svuota_indice(struct indice_disponibilita *indice){
+    for(unsigned int k = 0; k < indice->num_veicoli; k++) free(indice->posti[k]);
+    distruggi_pool(indice->fasce);
+    free(indice->secchi);
+    free(indice->posti);
+    indice->fasce = NULL;
+    indice->secchi = NULL;
+    indice->posti = NULL;
+    indice->num_secchi = 0;
+    indice->num_fasce = 0;
+    indice->num_veicoli = 0;
+    indice->capacita_posti = 0;
+    indice->parole = 0;
+    indice->valido = 0;
+}
+
+/*
+ * Funzione: crea_indice_disponibilita
+ * -----------------------------------
+ * Crea un indice vuoto e non valido: va riempito con `ricostruisci_indice_disponibilita`.
+ *
+ * Implementazione:
+ *    Alloca solo la struttura: fasce e veicoli sono allocati alla ricostruzione,
+ *    quando è noto il numero di veicoli e quindi la dimensione dei vettori di bit.
+ *
+ * Parametri:
+ *    Nessuno
+ *
+ * Pre-condizioni:
+ *    Nessuna
+ *
+ * Post-condizioni:
+ *    restituisce un nuovo indice, oppure NULL in caso di errore di allocazione
+ *
+ * Ritorna:
+ *    un oggetto IndiceDisponibilita o NULL
+ *
+ * Side-effect:
+ *    alloca memoria dinamicamente; va liberata con `distruggi_indice_disponibilita`
+ */
+IndiceDisponibilita crea_indice_disponibilita(void){
+    IndiceDisponibilita indice = calloc(1, sizeof(struct indice_disponibilita));
+    return indice;
+}
+
+/*
+ * Funzione: distruggi_indice_disponibilita
+ * ----------------------------------------
+ * Libera la memoria dell'indice. I veicoli non vengono toccati.
+ *
+ * Implementazione:
+ *    Le fasce sono liberate in blocco distruggendo il pool.
+ *
+ * Parametri:
+ *    indice: l'indice da distruggere
+ *
+ * Pre-condizioni:
+ *    indice: può essere NULL (nessuna operazione)
+ *    i veicoli indicizzati devono essere già stati distrutti, oppure non devono
+ *    più ricevere prenotazioni: i loro osservatori puntano ancora all'indice
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    libera la memoria dell'indice e delle sue fasce
+ */
+void distruggi_indice_disponibilita(IndiceDisponibilita indice){
+    if(indice == NULL) return;
+
+    svuota_indice(indice);
+    free(indice);
+}
+
+/*
+ * Funzione: ricostruisci_indice_disponibilita
+ * -------------------------------------------
+ * Ricostruisce l'indice a partire dalle prenotazioni dei veicoli forniti e
+ * si registra come osservatore dei veicoli.
+ *
+ * Implementazione:
+ *    - Libera le fasce precedenti, porta l'origine dell'orizzonte alla mezzanotte
+ *    UTC di oggi e dimensiona i vettori di bit sul nuovo numero di veicoli.
+ *    - Accoda ogni veicolo con `aggiungi_posto`: sono segnate solo le prenotazioni
+ *    dell'orizzonte, e quelle dei veicoli caricati dall'archivio sono lette dai
+ *    record senza costruire gli alberi. Il costo è proporzionale alle prenotazioni
+ *    lette, non allo storico in memoria.
+ *    - In caso di errore rimuove l'osservatore da tutti i veicoli e svuota l'indice.
+ *
+ * Parametri:
+ *    indice: l'indice da ricostruire
+ *    veicoli: i veicoli della flotta, nell'ordine in cui verranno restituiti
+ *    n: numero di veicoli
+ *
+ * Pre-condizioni:
+ *    indice: non deve essere NULL
+ *    veicoli: non deve essere NULL se `n` è maggiore di 0
+ *    deve contenere tutti i veicoli ancora vivi indicizzati in precedenza
+ *
+ * Post-condizioni:
+ *    restituisce 1 e l'indice diventa valido, oppure 0 in caso di errore di
+ *    allocazione; in tal caso l'indice resta non valido e nessun veicolo lo osserva
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    sostituisce l'osservatore di ogni veicolo
+ */
+Byte ricostruisci_indice_disponibilita(IndiceDisponibilita indice, Veicolo *veicoli, unsigned int n){
+    if(indice == NULL || (veicoli == NULL && n > 0)) return 0;
+
+    svuota_indice(indice);
+
+    time_t adesso = time(NULL);
+    indice->origine = adesso - adesso % SECONDI_GIORNO;
+    indice->parole = n > 0 ? (n + BIT_PER_PAROLA - 1) / BIT_PER_PAROLA : 1;
+    indice->secchi = calloc(SECCHI_INIZIALI, sizeof(struct fascia *));
+    indice->fasce = crea_pool(sizeof(struct fascia) + sizeof(uint64_t) * indice->parole, FASCE_PER_BLOCCO);
+    indice->num_secchi = SECCHI_INIZIALI;
+
+    Byte errore = indice->secchi == NULL || indice->fasce == NULL;
+    for(unsigned int k = 0; k < n && !errore; k++) errore = !aggiungi_posto(indice, veicoli[k]);
+
+    if(errore){
+        for(unsigned int k = 0; k < n; k++) imposta_osservatore_veicolo(veicoli[k], NULL, NULL);
+        svuota_indice(indice);
+        return 0;
+    }
+
+    indice->valido = 1;
+    return 1;
+}
+
+/*
+ * Funzione: aggiungi_a_indice_disponibilita
+ * -----------------------------------------
+ * Accoda un nuovo veicolo all'indice senza ricostruirlo.
+ *
+ * Implementazione:
+ *    Se l'indice non è valido non fa nulla: il veicolo entrerà con la prossima
+ *    ricostruzione. Altrimenti lo accoda con `aggiungi_posto`; in caso di errore
+ *    l'indice viene invalidato.
+ *
+ * Parametri:
+ *    indice: l'indice da aggiornare
+ *    veicolo: il veicolo appena inserito nella flotta
+ *
+ * Pre-condizioni:
+ *    indice: può essere NULL (nessuna operazione)
+ *    veicolo: non deve essere NULL né già indicizzato
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    registra l'indice come osservatore del veicolo
+ */
+void aggiungi_a_indice_disponibilita(IndiceDisponibilita indice, Veicolo veicolo){
+    if(indice == NULL || veicolo == NULL || !indice->valido) return;
+
+    if(!aggiungi_posto(indice, veicolo)) indice->valido = 0;
+}
+
+/*
+ * Funzione: invalida_indice_disponibilita
+ * ---------------------------------------
+ * Segnala che la flotta è cambiata: l'indice va ricostruito prima del prossimo uso.
+ *
+ * Implementazione:
+ *    Azzera il flag `valido`; le fasce restano allocate fino alla ricostruzione.
+ *
+ * Parametri:
+ *    indice: l'indice da invalidare
+ *
+ * Pre-condizioni:
+ *    indice: può essere NULL (nessuna operazione)
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    le notifiche delle prenotazioni vengono ignorate fino alla ricostruzione
+ */
+void invalida_indice_disponibilita(IndiceDisponibilita indice){
+    if(indice == NULL) return;
+    indice->valido = 0;
+}
+
+/*
+ * Funzione: indice_disponibilita_valido
+ * -------------------------------------
+ * Indica se l'indice rispecchia le prenotazioni attuali della flotta.
+ *
+ * Implementazione:
+ *    Restituisce il flag `valido`.
+ *
+ * Parametri:
+ *    indice: l'indice da controllare
+ *
+ * Pre-condizioni:
+ *    indice: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se l'indice è valido, 0 se va ricostruito o è NULL
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ */
+Byte indice_disponibilita_valido(const IndiceDisponibilita indice){
+    return indice != NULL && indice->valido;
+}
+
+/*
+ * Funzione: veicoli_liberi_da_indice
+ * ----------------------------------
+ * Restituisce i veicoli senza prenotazioni che si sovrappongono all'intervallo.
+ *
+ * Implementazione:
+ *    - Sposta prima l'orizzonte, se necessario, con `sposta_orizzonte`.
+ *    - Le fasce interamente contenute nell'intervallo danno veicoli sicuramente
+ *    occupati: i loro vettori di bit vengono uniti con OR in `occupati`
+ *    (`unisci_bit`, vettorizzata con AVX2/SSE2).
+ *    - Le due fasce di bordo, coperte solo in parte, danno solo candidati: per
+ *    questi pochi veicoli la risposta è chiesta alle loro prenotazioni, che nei
+ *    prossimi giorni rispondono con la loro mappa di occupazione.
+ *    - Se l'intervallo esce dall'orizzonte, l'indice non sa nulla della parte
+ *    esterna: tutti i veicoli non sicuramente occupati diventano candidati e la
+ *    risposta è chiesta alle loro prenotazioni.
+ *    - Se l'intervallo copre più fasce di quante ne esistono si scorre la tabella
+ *    delle fasce invece dell'intervallo.
+ *    - Infine si raccolgono i veicoli con bit a 0, una parola di 64 veicoli alla volta.
+ *    Nell'orizzonte nessun veicolo libero viene letto: il costo dipende dalle fasce
+ *    toccate, dai veicoli ai bordi e dalla dimensione del risultato.
+ *
+ * Parametri:
+ *    indice: l'indice da interrogare
+ *    intervallo: l'intervallo di tempo da controllare
+ *    dimensione: puntatore in cui salvare il numero di veicoli restituiti
+ *
+ * Pre-condizioni:
+ *    indice: non deve essere NULL e deve essere valido
+ *    intervallo: non deve essere NULL
+ *    dimensione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce un vettore di veicoli liberi, nell'ordine in cui sono stati
+ *    indicizzati; NULL se l'indice non contiene veicoli o in caso di errore, e in
+ *    tal caso l'indice può essere diventato non valido
+ *
+ * Ritorna:
+ *    un array di veicoli o NULL
+ *
+ * Side-effect:
+ *    alloca dinamicamente un array che dovrà essere liberato dal chiamante
+ */
+Veicolo *veicoli_liberi_da_indice(IndiceDisponibilita indice, Intervallo intervallo, unsigned int *dimensione){
+    if(indice == NULL || !indice->valido || intervallo == NULL || dimensione == NULL) return NULL;
+    if(indice->num_veicoli == 0) return NULL;
+
+    if(!sposta_orizzonte(indice, time(NULL))){
+        indice->valido = 0;
+        return NULL;
+    }
+
+    unsigned int parole = (indice->num_veicoli + BIT_PER_PAROLA - 1) / BIT_PER_PAROLA;
+    uint64_t *occupati = calloc(2 * (size_t)parole, sizeof(uint64_t));
+    if(occupati == NULL) return NULL;
+    uint64_t *candidati = occupati + parole;
+
+    time_t inizio = inizio_intervallo(intervallo);
+    time_t fine = fine_intervallo(intervallo);
+    Byte nell_orizzonte = inizio >= indice->origine && fine <= fine_orizzonte(indice);
+    time_t da = inizio, a = fine;
+    unsigned int w;
+
+    if(limita_a_orizzonte(indice, &da, &a)){
+        long long prima = fascia_di(da);
+        long long ultima = fascia_di(a - 1);
+        if(ultima - prima + 1 <= (long long)indice->num_fasce){
+            for(long long n = prima; n <= ultima; n++){
+                struct fascia *f = cerca_fascia(indice, n);
+                if(f == NULL) continue;
+                Byte interna = n * DURATA_FASCIA >= (long long)inizio && (n + 1) * DURATA_FASCIA <= (long long)fine;
+                unisci_bit(interna ? occupati : candidati, f->bit, parole);
+            }
+        }else{
+            for(unsigned int s = 0; s < indice->num_secchi; s++){
+                for(struct fascia *f = indice->secchi[s]; f != NULL; f = f->successiva){
+                    if(f->numero < prima || f->numero > ultima) continue;
+                    Byte interna = f->numero * DURATA_FASCIA >= (long long)inizio && (f->numero + 1) * DURATA_FASCIA <= (long long)fine;
+                    unisci_bit(interna ? occupati : candidati, f->bit, parole);
+                }
+            }
+        }
+    }
+    if(!nell_orizzonte) memset(candidati, 0xFF, sizeof(uint64_t) * parole);
+
+    // Veicoli non decisi dall'indice: la risposta è nelle loro prenotazioni
+    for(w = 0; w < parole; w++){
+        uint64_t dubbi = candidati[w] & ~occupati[w];
+        if(w == parole - 1 && indice->num_veicoli % BIT_PER_PAROLA)
+            dubbi &= ((uint64_t)1 << (indice->num_veicoli % BIT_PER_PAROLA)) - 1;
+        while(dubbi){
+            unsigned int b = (unsigned int)__builtin_ctzll(dubbi);
+            dubbi &= dubbi - 1;
+            Veicolo v = indice->posti[w * BIT_PER_PAROLA + b]->veicolo;
+            if(controlla_prenotazione(ottieni_prenotazioni(v), intervallo) == OCCUPATO)
+                occupati[w] |= (uint64_t)1 << b;
+        }
+    }
+
+    Veicolo *vettore = malloc(sizeof(Veicolo) * indice->num_veicoli);
+    if(vettore == NULL){
+        free(occupati);
+        return NULL;
+    }
+
+    unsigned int n = 0;
+    for(w = 0; w < parole; w++){
+        uint64_t liberi = ~occupati[w];
+        if(w == parole - 1 && indice->num_veicoli % BIT_PER_PAROLA)
+            liberi &= ((uint64_t)1 << (indice->num_veicoli % BIT_PER_PAROLA)) - 1;
+        while(liberi){
+            unsigned int b = (unsigned int)__builtin_ctzll(liberi);
+            liberi &= liberi - 1;
+            vettore[n++] = indice->posti[w * BIT_PER_PAROLA + b]->veicolo;
+        }
+    }
+
+    free(occupati);
+    *dimensione = n;
+    return vettore;
+}
@@ -42,8 +42,9 @@ static void distruggi_prenotazione_t(void *prenotazione){
  * Libera tutta la memoria della lista di prenotazioni.
  *
  * Implementazione:
- *    Scorre la lista nodo per nodo, deallocando ogni nodo
- *    e la prenotazione associata usando distruggi_prenotazione_t.
+ *    Scorre la lista nodo per nodo, deallocando ogni nodo e rilasciando
+ *    la prenotazione associata usando distruggi_prenotazione_t: una prenotazione
+ *    condivisa (ad esempio con lo storico) resta valida finché altri la usano.
  *
  * Parametri:
  *    l: lista da distruggere
@@ -55,7 +56,7 @@ static void distruggi_prenotazione_t(void *prenotazione){
  *    non restituisce niente
  *
  * Side-effect:
- *    tutta la memoria della lista e delle prenotazioni viene liberata
+ *    tutta la memoria della lista e delle prenotazioni non più condivise viene liberata
  */
 void distruggi_lista_prenotazione(ListaPre l){
     if(lista_vuota(l)) return;
@@ -0,0 +1,227 @@
+#include "modelli/intervallo.h"
+#include "modelli/prenotazione.h"
+#include "strutture_dati/prenotazioni.h"
+#include "strutture_dati/occupazione.h"
+#include "utils/vettore_bit.h"
+
+#define SECONDI_GIORNO 86400
+#define GIORNI_PRIMA_DI_SPOSTARE 2  // Giorni trascorsi dall'origine prima di spostare l'orizzonte
+
+/*
+ * Funzione: quarto_di
+ * -------------------
+ * Restituisce l'indice del quarto d'ora che contiene `t`, relativo all'origine.
+ *
+ * Implementazione:
+ *    Divisione arrotondata verso il basso, corretta anche prima dell'origine.
+ */
+static long long quarto_di(const Occupazione *occupazione, time_t t){
+    long long d = (long long)t - (long long)occupazione->origine;
+    long long q = d / DURATA_QUARTO;
+    if(d % DURATA_QUARTO < 0) q--;
+    return q;
+}
+
+/*
+ * Funzione: quarti_toccati
+ * ------------------------
+ * Calcola i quarti d'ora toccati da [inizio, fine), limitati all'orizzonte.
+ *
+ * Parametri:
+ *    occupazione: la mappa
+ *    inizio, fine: estremi dell'intervallo
+ *    da, a: puntatori in cui salvare il primo quarto e quello successivo all'ultimo
+ *
+ * Ritorna:
+ *    1 se almeno un quarto toccato cade nell'orizzonte, 0 altrimenti
+ */
+static Byte quarti_toccati(const Occupazione *occupazione, time_t inizio, time_t fine, unsigned int *da, unsigned int *a){
+    time_t limite = occupazione->origine + (time_t)QUARTI_ORIZZONTE * DURATA_QUARTO;
+    if(inizio >= fine || fine <= occupazione->origine || inizio >= limite) return 0;
+
+    // Limitati all'orizzonte prima della sottrazione, che agli estremi di time_t traboccherebbe
+    if(inizio < occupazione->origine) inizio = occupazione->origine;
+    if(fine > limite) fine = limite;
+    long long primo = quarto_di(occupazione, inizio);
+    long long dopo_ultimo = quarto_di(occupazione, fine - 1) + 1;
+
+    *da = (unsigned int)primo;
+    *a = (unsigned int)dopo_ultimo;
+    return 1;
+}
+
+/*
+ * Funzione: segna_prenotazione_visitata
+ * -------------------------------------
+ * Visitatore che segna nella mappa passata come contesto la prenotazione visitata.
+ */
+static void segna_prenotazione_visitata(const Prenotazione p, void *occupazione){
+    Intervallo i = ottieni_intervallo_prenotazione(p);
+    segna_occupazione(occupazione, inizio_intervallo(i), fine_intervallo(i));
+}
+
+/*
+ * Funzione: inizializza_occupazione
+ * ---------------------------------
+ * Prepara una mappa vuota il cui orizzonte parte dalla mezzanotte UTC di `adesso`.
+ *
+ * Implementazione:
+ *    Arrotonda `adesso` al giorno e azzera tutte le parole.
+ *
+ * Parametri:
+ *    occupazione: la mappa da inizializzare
+ *    adesso: l'istante corrente
+ *
+ * Pre-condizioni:
+ *    occupazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente; tutti i quarti d'ora risultano liberi
+ */
+void inizializza_occupazione(Occupazione *occupazione, time_t adesso){
+    if(occupazione == NULL) return;
+
+    occupazione->origine = adesso - adesso % SECONDI_GIORNO;
+    azzera_bit(occupazione->quarti, 0, QUARTI_ORIZZONTE);
+}
+
+/*
+ * Funzione: segna_occupazione
+ * ---------------------------
+ * Segna come occupati i quarti d'ora dell'orizzonte toccati da [inizio, fine).
+ *
+ * Implementazione:
+ *    Un quarto d'ora toccato anche solo in parte viene segnato per intero.
+ *
+ * Parametri:
+ *    occupazione: la mappa da aggiornare
+ *    inizio, fine: estremi della prenotazione
+ *
+ * Pre-condizioni:
+ *    occupazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente; la parte fuori dall'orizzonte viene ignorata
+ */
+void segna_occupazione(Occupazione *occupazione, time_t inizio, time_t fine){
+    unsigned int da, a;
+    if(occupazione == NULL || !quarti_toccati(occupazione, inizio, fine, &da, &a)) return;
+
+    imposta_bit(occupazione->quarti, da, a);
+}
+
+/*
+ * Funzione: libera_occupazione
+ * ----------------------------
+ * Aggiorna la mappa dopo che la prenotazione [inizio, fine) è stata rimossa da `prenotazioni`.
+ *
+ * Implementazione:
+ *    Azzera i quarti d'ora toccati dalla prenotazione. Non essendoci sovrapposizioni,
+ *    solo il primo e l'ultimo possono essere condivisi con un'altra prenotazione:
+ *    le prenotazioni che li toccano vengono segnate di nuovo.
+ *
+ * Parametri:
+ *    occupazione: la mappa da aggiornare
+ *    prenotazioni: la struttura da cui la prenotazione è già stata rimossa
+ *    inizio, fine: estremi della prenotazione rimossa
+ *
+ * Pre-condizioni:
+ *    occupazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ */
+void libera_occupazione(Occupazione *occupazione, Prenotazioni prenotazioni, time_t inizio, time_t fine){
+    unsigned int da, a;
+    if(occupazione == NULL || !quarti_toccati(occupazione, inizio, fine, &da, &a)) return;
+
+    azzera_bit(occupazione->quarti, da, a);
+
+    time_t origine = occupazione->origine;
+    visita_prenotazioni_in_intervallo(prenotazioni, origine + (time_t)da * DURATA_QUARTO,
+                                      origine + (time_t)(da + 1) * DURATA_QUARTO,
+                                      segna_prenotazione_visitata, occupazione);
+    if(a - 1 > da){
+        visita_prenotazioni_in_intervallo(prenotazioni, origine + (time_t)(a - 1) * DURATA_QUARTO,
+                                          origine + (time_t)a * DURATA_QUARTO,
+                                          segna_prenotazione_visitata, occupazione);
+    }
+}
+
+/*
+ * Funzione: aggiorna_orizzonte_occupazione
+ * ----------------------------------------
+ * Sposta in avanti l'orizzonte quando `adesso` ne ha superato l'inizio di almeno due giorni.
+ *
+ * Implementazione:
+ *    Reinizializza la mappa a partire dal giorno di `adesso` e segna le prenotazioni
+ *    del nuovo orizzonte con `visita_prenotazioni_in_intervallo`. Lo spostamento
+ *    avviene al più una volta ogni GIORNI_PRIMA_DI_SPOSTARE giorni.
+ *
+ * Parametri:
+ *    occupazione: la mappa da aggiornare
+ *    prenotazioni: la struttura da cui ricostruire la mappa
+ *    adesso: l'istante corrente
+ *
+ * Pre-condizioni:
+ *    occupazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    se l'orizzonte si sposta visita le prenotazioni del nuovo orizzonte
+ */
+void aggiorna_orizzonte_occupazione(Occupazione *occupazione, Prenotazioni prenotazioni, time_t adesso){
+    if(occupazione == NULL) return;
+    if(adesso >= occupazione->origine &&
+       adesso - occupazione->origine < (time_t)GIORNI_PRIMA_DI_SPOSTARE * SECONDI_GIORNO) return;
+
+    inizializza_occupazione(occupazione, adesso);
+    visita_prenotazioni_in_intervallo(prenotazioni, occupazione->origine,
+                                      occupazione->origine + (time_t)QUARTI_ORIZZONTE * DURATA_QUARTO,
+                                      segna_prenotazione_visitata, occupazione);
+}
+
+/*
+ * Funzione: esito_occupazione
+ * ---------------------------
+ * Risponde, se possibile, alla domanda "[inizio, fine) è libero?" usando solo la mappa.
+ *
+ * Implementazione:
+ *    - Se nessun bit dei quarti d'ora toccati è a 1, nessuna prenotazione può
+ *    sovrapporsi all'intervallo: OK.
+ *    - Se è a 1 un quarto d'ora interamente contenuto nell'intervallo, la
+ *    prenotazione che lo tocca si sovrappone all'intervallo: OCCUPATO.
+ *    - Altrimenti la prenotazione potrebbe toccare solo la parte del quarto
+ *    d'ora di bordo esterna all'intervallo: INCERTO.
+ *
+ * Parametri:
+ *    occupazione: la mappa da interrogare
+ *    inizio, fine: estremi dell'intervallo
+ *
+ * Pre-condizioni:
+ *    occupazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce OK, OCCUPATO o INCERTO come descritto sopra
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(OK, OCCUPATO o INCERTO)
+ */
+Byte esito_occupazione(const Occupazione *occupazione, time_t inizio, time_t fine){
+    if(occupazione == NULL || inizio >= fine) return INCERTO;
+    if(inizio < occupazione->origine ||
+       fine > occupazione->origine + (time_t)QUARTI_ORIZZONTE * DURATA_QUARTO) return INCERTO;
+
+    unsigned int primo = (unsigned int)quarto_di(occupazione, inizio);
+    unsigned int dopo_ultimo = (unsigned int)quarto_di(occupazione, fine - 1) + 1;
+    if(!bit_impostati(occupazione->quarti, primo, dopo_ultimo)) return OK;
+
+    // Quarti d'ora interamente contenuti in [inizio, fine)
+    unsigned int primo_pieno = (unsigned int)quarto_di(occupazione, inizio + DURATA_QUARTO - 1);
+    unsigned int dopo_ultimo_pieno = (unsigned int)quarto_di(occupazione, fine);
+    if(bit_impostati(occupazione->quarti, primo_pieno, dopo_ultimo_pieno)) return OCCUPATO;
+
+    return INCERTO;
+}
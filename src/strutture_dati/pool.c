@@ -0,0 +1,254 @@
+#include "strutture_dati/pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Allineamento minimo garantito per ogni elemento del pool: deve essere
+ * adatto a puntatori, interi lunghi e double.
+ */
+typedef union {
+    void *puntatore;
+    long intero;
+    double reale;
+} Allineamento;
+
+#define ELEMENTI_PRIMO_BLOCCO 4
+#define ALLINEA(x) ((((x) + sizeof(Allineamento) - 1) / sizeof(Allineamento)) * sizeof(Allineamento))
+
+/*
+ * Struttura interna che rappresenta un blocco contiguo di elementi.
+ * Gli elementi seguono l'intestazione del blocco in memoria.
+ */
+struct blocco {
+    struct blocco *prossimo;
+    Allineamento dati[];
+};
+
+/*
+ * Un elemento libero riutilizza la propria memoria per collegarsi
+ * al successivo elemento libero.
+ */
+struct libero {
+    struct libero *prossimo;
+};
+
+struct pool {
+    size_t dimensione_elemento;
+    unsigned int elementi_per_blocco;  // Dimensione massima di un blocco
+    unsigned int prossimo_blocco;      // Elementi del prossimo blocco da allocare
+    struct blocco *blocchi;      // Lista dei blocchi allocati
+    struct libero *liberi;       // Lista degli elementi restituiti
+    unsigned char *cursore;      // Prossimo elemento mai usato del blocco corrente
+    unsigned int rimanenti;      // Elementi mai usati rimasti nel blocco corrente
+    StatistichePool statistiche;
+};
+
+/*
+ * Funzione: crea_pool
+ * -------------------
+ * Crea un nuovo pool per elementi della dimensione indicata.
+ *
+ * Implementazione:
+ *    Alloca la struttura del pool e arrotonda la dimensione dell'elemento
+ *    all'allineamento richiesto (almeno la dimensione di un puntatore, per
+ *    poter collegare gli elementi liberi). Nessun blocco viene allocato finché
+ *    non arriva la prima richiesta; il primo blocco è piccolo e i successivi
+ *    raddoppiano fino a `elementi_per_blocco`, così che un pool poco usato
+ *    non occupi un blocco intero.
+ *
+ * Parametri:
+ *    dimensione_elemento: dimensione in byte di ogni elemento
+ *    elementi_per_blocco: numero massimo di elementi contenuti in un blocco contiguo
+ *
+ * Pre-condizioni:
+ *    dimensione_elemento: deve essere maggiore di 0
+ *    elementi_per_blocco: deve essere maggiore di 0
+ *
+ * Post-condizioni:
+ *    restituisce un nuovo pool vuoto se l'allocazione è riuscita, altrimenti NULL
+ *
+ * Ritorna:
+ *    un puntatore alla struttura Pool o NULL
+ *
+ * Side-effect:
+ *    alloca memoria dinamicamente per la struttura del pool
+ */
+Pool crea_pool(size_t dimensione_elemento, unsigned int elementi_per_blocco){
+    if(dimensione_elemento == 0 || elementi_per_blocco == 0) return NULL;
+
+    Pool pool = calloc(1, sizeof(struct pool));
+    if(pool == NULL) return NULL;
+
+    if(dimensione_elemento < sizeof(struct libero)) dimensione_elemento = sizeof(struct libero);
+    pool->dimensione_elemento = ALLINEA(dimensione_elemento);
+    pool->elementi_per_blocco = elementi_per_blocco;
+    pool->prossimo_blocco = elementi_per_blocco < ELEMENTI_PRIMO_BLOCCO ?
+                            elementi_per_blocco : ELEMENTI_PRIMO_BLOCCO;
+
+    return pool;
+}
+
+/*
+ * Funzione: distruggi_pool
+ * ------------------------
+ * Libera in blocco tutta la memoria del pool.
+ *
+ * Implementazione:
+ *    Scorre la lista dei blocchi e libera ciascun blocco con una sola `free`,
+ *    indipendentemente dal numero di elementi che contiene. Infine libera
+ *    la struttura del pool.
+ *
+ * Parametri:
+ *    pool: il pool da distruggere
+ *
+ * Pre-condizioni:
+ *    pool: può essere NULL (nessuna operazione)
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    tutti i puntatori ottenuti dal pool diventano non validi
+ */
+void distruggi_pool(Pool pool){
+    if(pool == NULL) return;
+
+    struct blocco *curr = pool->blocchi;
+    while(curr != NULL){
+        struct blocco *prossimo = curr->prossimo;
+        free(curr);
+        curr = prossimo;
+    }
+
+    free(pool);
+}
+
+/*
+ * Funzione: alloca_da_pool
+ * ------------------------
+ * Restituisce un elemento libero del pool.
+ *
+ * Implementazione:
+ *    - Se la lista degli elementi liberi non è vuota, estrae la testa.
+ *    - Altrimenti, se il blocco corrente ha ancora elementi mai usati,
+ *    avanza il cursore.
+ *    - Altrimenti alloca un nuovo blocco (di dimensione doppia rispetto al
+ *    precedente, fino a `elementi_per_blocco` elementi), lo inserisce in testa
+ *    alla lista dei blocchi e ne prende il primo elemento.
+ *    - L'elemento restituito viene azzerato, come farebbe `calloc`.
+ *
+ * Parametri:
+ *    pool: il pool da cui prelevare l'elemento
+ *
+ * Pre-condizioni:
+ *    pool: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce un puntatore ad un'area azzerata, oppure NULL in caso di errore
+ *
+ * Ritorna:
+ *    un puntatore all'elemento o NULL
+ *
+ * Side-effect:
+ *    può allocare un nuovo blocco; aggiorna le statistiche del pool
+ */
+void *alloca_da_pool(Pool pool){
+    if(pool == NULL) return NULL;
+
+    void *elemento;
+
+    if(pool->liberi != NULL){
+        elemento = pool->liberi;
+        pool->liberi = pool->liberi->prossimo;
+    }
+    else {
+        if(pool->rimanenti == 0){
+            struct blocco *nuovo = malloc(sizeof(struct blocco) +
+                                          pool->dimensione_elemento * pool->prossimo_blocco);
+            if(nuovo == NULL) return NULL;
+
+            nuovo->prossimo = pool->blocchi;
+            pool->blocchi = nuovo;
+            pool->cursore = (unsigned char *)nuovo->dati;
+            pool->rimanenti = pool->prossimo_blocco;
+            pool->statistiche.blocchi++;
+
+            // Il blocco successivo sarà il doppio, fino al massimo consentito
+            if(pool->prossimo_blocco < pool->elementi_per_blocco){
+                pool->prossimo_blocco *= 2;
+                if(pool->prossimo_blocco > pool->elementi_per_blocco)
+                    pool->prossimo_blocco = pool->elementi_per_blocco;
+            }
+        }
+
+        elemento = pool->cursore;
+        pool->cursore += pool->dimensione_elemento;
+        pool->rimanenti--;
+    }
+
+    memset(elemento, 0, pool->dimensione_elemento);
+    pool->statistiche.richieste++;
+    pool->statistiche.in_uso++;
+    return elemento;
+}
+
+/*
+ * Funzione: rilascia_in_pool
+ * --------------------------
+ * Restituisce un elemento al pool.
+ *
+ * Implementazione:
+ *    Inserisce l'elemento in testa alla lista degli elementi liberi,
+ *    riutilizzando i primi byte dell'elemento come collegamento.
+ *
+ * Parametri:
+ *    pool: il pool da cui l'elemento è stato ottenuto
+ *    elemento: l'elemento da rilasciare
+ *
+ * Pre-condizioni:
+ *    pool: non deve essere NULL
+ *    elemento: deve essere stato ottenuto da `pool` tramite `alloca_da_pool`
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    l'elemento viene reso disponibile per le richieste successive
+ */
+void rilascia_in_pool(Pool pool, void *elemento){
+    if(pool == NULL || elemento == NULL) return;
+
+    struct libero *l = elemento;
+    l->prossimo = pool->liberi;
+    pool->liberi = l;
+
+    pool->statistiche.rilasci++;
+    pool->statistiche.in_uso--;
+}
+
+/*
+ * Funzione: ottieni_statistiche_pool
+ * ----------------------------------
+ * Restituisce i contatori delle allocazioni effettuate tramite il pool.
+ *
+ * Implementazione:
+ *    Restituisce per valore la copia dei contatori mantenuti nel pool.
+ *
+ * Parametri:
+ *    pool: il pool da interrogare
+ *
+ * Pre-condizioni:
+ *    pool: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce le statistiche del pool, oppure contatori a zero se `pool` è NULL
+ *
+ * Ritorna:
+ *    una struttura StatistichePool
+ */
+StatistichePool ottieni_statistiche_pool(Pool pool){
+    StatistichePool vuote = {0, 0, 0, 0};
+    if(pool == NULL) return vuote;
+
+    return pool->statistiche;
+}
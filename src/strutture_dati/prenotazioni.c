@@ -7,6 +7,8 @@
 #include "modelli/prenotazione.h"
 #include "modelli/intervallo.h"
 #include "strutture_dati/coda.h"
+#include "strutture_dati/pool.h"
+#include "strutture_dati/occupazione.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <time.h>
@@ -14,18 +16,31 @@
 #define massimo(x, y) (x > y ? x : y)
 #define ottieni_massimo(x) (x ? x->massimo : 0)
 #define altezza(x) (x ? x->altezza : 0)
+#define NODI_PER_BLOCCO 256
 
+/*
+ * Gli estremi dell'intervallo sono copiati nel nodo: confronti, ricerche di
+ * sovrapposizioni e ribilanciamenti leggono solo la memoria del nodo, senza
+ * passare per Prenotazione e Intervallo. La prenotazione, usata solo quando
+ * va restituita al chiamante, è in fondo alla struttura.
+ */
 struct nodo {
-    Prenotazione prenotazione;
+    time_t inizio;      // Inizio dell'intervallo della prenotazione
+    time_t fine;        // Fine dell'intervallo della prenotazione
     time_t massimo;     // Fine massima degli intervalli nel sottoalbero
-    int altezza;        // Altezza del nodo
-    struct nodo *destra;
     struct nodo *sinistra;
+    struct nodo *destra;
+    int altezza;        // Altezza del nodo
+    Prenotazione prenotazione;
 };
 
 struct albero {
     struct nodo *radice;
     unsigned int num_nodi;
+    Pool nodi;          // Pool da cui vengono allocati i nodi dell'albero
+    OsservatorePrenotazioni osservatore;   // Avvisato dopo inserimenti e cancellazioni, può essere NULL
+    void *contesto_osservatore;
+    Occupazione occupazione;    // Quarti d'ora occupati nei prossimi giorni, per rispondere senza visitare l'albero
 };
 
 /*
@@ -34,17 +49,20 @@ struct albero {
  * Crea un nuovo nodo per l'albero AVL.
  *
  * Implementazione:
- *    - Alloca memoria per una nuova struttura `struct nodo`.
+ *    - Preleva una nuova struttura `struct nodo` dal pool dei nodi dell'albero.
  *    - Inizializza il campo `prenotazione` con la prenotazione fornita.
  *    - Imposta i puntatori `sinistra` e `destra` a NULL, poiché è un nuovo nodo (foglia).
  *    - Inizializza `altezza` a 1, dato che è una foglia.
+ *    - Copia nel nodo `inizio` e `fine` dell'intervallo della prenotazione.
  *    - Inizializza `massimo` con la fine dell'intervallo della prenotazione corrente,
  *    essendo l'unico elemento nel suo sottoalbero iniziale.
  *
  * Parametri:
+ *    nodi: il pool da cui prelevare il nodo.
  *    prenotazione: la prenotazione da inserire nel nuovo nodo.
  *
  * Pre-condizioni:
+ *    nodi: non deve essere NULL
  *    prenotazione: non deve essere NULL
  *
  * Post-condizioni:
@@ -55,16 +73,19 @@ struct albero {
  *    un puntatore ad un nodo o NULL
  *
  * Side-effect:
- *    - Alloca memoria dinamicamente per la nuova struttura `struct nodo`.
+ *    - Può allocare un nuovo blocco di nodi nel pool.
  */
-static struct nodo* nuovo_nodo(Prenotazione prenotazione) {
-    struct nodo* nodo = malloc(sizeof(struct nodo));
+static struct nodo* nuovo_nodo(Pool nodi, Prenotazione prenotazione) {
+    struct nodo* nodo = alloca_da_pool(nodi);
     if (!nodo) return NULL;
 
+    Intervallo i = ottieni_intervallo_prenotazione(prenotazione);
     nodo->prenotazione = prenotazione;
+    nodo->inizio = inizio_intervallo(i);
+    nodo->fine = fine_intervallo(i);
     nodo->sinistra = nodo->destra = NULL;
     nodo->altezza = 1;
-    nodo->massimo = fine_intervallo(ottieni_intervallo_prenotazione(prenotazione));
+    nodo->massimo = nodo->fine;
     return nodo;
 }
 
@@ -74,11 +95,9 @@ static struct nodo* nuovo_nodo(Prenotazione prenotazione) {
  * Aggiorna i campi `altezza` e `massimo` di un dato nodo AVL.
  *
  * Implementazione:
- *    - Ottiene l'intervallo associato alla prenotazione del nodo corrente e la sua fine.
  *    - Ricalcola `altezza` come 1 più il massimo tra l'altezza del figlio sinistro
  *    e l'altezza del figlio destro (gestendo il caso di figli NULL che hanno altezza 0).
- *    - Ricalcola `massimo` come il valore più grande tra la fine dell'intervallo della
- *    propria prenotazione e i valori `massimo` dei suoi figli sinistro e destro
+ *    - Ricalcola `massimo` come il valore più grande tra la `fine` del nodo e i valori `massimo` dei suoi figli sinistro e destro
  *    (gestendo il caso di figli NULL che hanno massimo 0).
  *
  * Parametri:
@@ -95,13 +114,10 @@ static struct nodo* nuovo_nodo(Prenotazione prenotazione) {
  *    correttamente lo stato attuale del sottoalbero radicato in `n`.
  */
 static void aggiorna_nodo(struct nodo *n) {
-    Intervallo iv = ottieni_intervallo_prenotazione(n->prenotazione);
-    time_t fi = fine_intervallo(iv);
-
     // L'altezza è 1 + l'altezza massima tra il figlio sinistro e destro
     n->altezza = 1 + massimo(altezza(n->sinistra), altezza(n->destra));
     // Il massimo è il più grande tra la propria fine e il massimo dei figli
-    n->massimo = massimo(fi, massimo(ottieni_massimo(n->sinistra), ottieni_massimo(n->destra)));
+    n->massimo = massimo(n->fine, massimo(ottieni_massimo(n->sinistra), ottieni_massimo(n->destra)));
 }
 
 /*
@@ -211,19 +227,17 @@ static struct nodo *ruota_sinistra(struct nodo *x) {
  * Implementazione:
  *    - Calcola il fattore di bilanciamento del `nodo` corrente (altezza figlio sinistro - altezza figlio destro).
  *    - Se il fattore di bilanciamento è maggiore di 1 (sbilanciamento a sinistra):
- *    - Determina se l'inserimento che ha causato lo sbilanciamento è avvenuto
- *    nel sottoalbero sinistro-sinistro o sinistro-destro, confrontando `inizio` con l'inizio
- *    della prenotazione nel figlio sinistro. Applica la rotazione a destra o la rotazione sinistra-destra.
+ *    - Distingue il caso sinistro-sinistro dal caso sinistro-destro in base al fattore
+ *    di bilanciamento del figlio sinistro. Applica la rotazione a destra o la rotazione sinistra-destra.
  *    - Se il fattore di bilanciamento è minore di -1 (sbilanciamento a destra):
- *    - Determina se l'inserimento è avvenuto nel sottoalbero destro-destro o destro-sinistro,
- *    confrontando `inizio` con l'inizio della prenotazione nel figlio destro.
- *    Applica la rotazione a sinistra o la rotazione destra-sinistra.
+ *    - Distingue il caso destro-destro dal caso destro-sinistro in base al fattore
+ *    di bilanciamento del figlio destro. Applica la rotazione a sinistra o la rotazione destra-sinistra.
+ *    Guardare i figli invece della chiave appena inserita rende la funzione corretta
+ *    anche dopo una cancellazione.
  *    - Se il nodo è bilanciato (fattore tra -1 e 1), lo restituisce senza modifiche.
  *
  * Parametri:
  *    nodo: il nodo potenzialmente sbilanciato da bilanciare.
- *    inizio: il timestamp di inizio della prenotazione appena inserita, usato per distinguere
- *    tra i sotto-casi di rotazione doppia (es. Left-Left vs Left-Right).
  *
  * Pre-condizioni:
  *    nodo: non deve essere NULL
@@ -238,25 +252,25 @@ static struct nodo *ruota_sinistra(struct nodo *x) {
  *    Modifica la struttura dell'albero tramite rotazioni.
  *    Aggiorna i campi `altezza` e `massimo` dei nodi coinvolti nelle rotazioni.
  */
-static struct nodo *casi_bilanciamento(struct nodo *nodo, time_t inizio) {
+static struct nodo *casi_bilanciamento(struct nodo *nodo) {
     int bilancio = altezza(nodo->sinistra) - altezza(nodo->destra);
 
     // Caso Sinistra-Sinistra o Sinistra-Destra
     if (bilancio > 1 && nodo->sinistra) {
-        time_t inizio_l = inizio_intervallo(ottieni_intervallo_prenotazione(nodo->sinistra->prenotazione));
-        if (inizio < inizio_l) // Inserimento nel sottoalbero sinistro-sinistro (LL)
+        struct nodo *figlio = nodo->sinistra;
+        if (altezza(figlio->sinistra) >= altezza(figlio->destra)) // Sottoalbero sinistro-sinistro (LL)
             return ruota_destra(nodo);
-        // Inserimento nel sottoalbero sinistro-destro (LR)
+        // Sottoalbero sinistro-destro (LR)
         nodo->sinistra = ruota_sinistra(nodo->sinistra);
         return ruota_destra(nodo);
     }
 
     // Caso Destra-Destra o Destra-Sinistra
     if (bilancio < -1 && nodo->destra) {
-        time_t inizio_r = inizio_intervallo(ottieni_intervallo_prenotazione(nodo->destra->prenotazione));
-        if (inizio > inizio_r) // Inserimento nel sottoalbero destro-destro (RR)
+        struct nodo *figlio = nodo->destra;
+        if (altezza(figlio->destra) >= altezza(figlio->sinistra)) // Sottoalbero destro-destro (RR)
             return ruota_sinistra(nodo);
-        // Inserimento nel sottoalbero destro-sinistro (RL)
+        // Sottoalbero destro-sinistro (RL)
         nodo->destra = ruota_destra(nodo->destra);
         return ruota_sinistra(nodo);
     }
@@ -273,38 +287,41 @@ static struct nodo *casi_bilanciamento(struct nodo *nodo, time_t inizio) {
  *    - Se il `nodo` è NULL, non fa nulla.
  *    - Chiama `distruggi_prenotazione` per deallocare la memoria associata all'oggetto
  *    `Prenotazione` contenuto nel nodo (poiché la prenotazione è stata allocata dinamicamente).
- *    - Libera la memoria del nodo stesso.
+ *    - Restituisce il nodo stesso al pool dei nodi.
  *
  * Parametri:
+ *    nodi: il pool da cui il nodo è stato prelevato.
  *    nodo: il puntatore al nodo da distruggere.
  *
  * Pre-condizioni:
+ *    nodi: non deve essere NULL
  *    nodo: non deve essere NULL
  *
  * Post-condizioni:
  *    non restituisce niente
  *
  * Side-effect:
- *    La memoria del nodo e della sua prenotazione associata viene liberata.
+ *    La prenotazione viene liberata e il nodo torna disponibile nel pool.
  */
-static void distruggi_nodo_prenotazioni(struct nodo *nodo) {
+static void distruggi_nodo_prenotazioni(Pool nodi, struct nodo *nodo) {
     if (!nodo) return;
 
     distruggi_prenotazione(nodo->prenotazione); // Dealloca la prenotazione
-    free(nodo); // Dealloca il nodo
+    rilascia_in_pool(nodi, nodo); // Restituisce il nodo al pool
 }
 
 /*
  * Funzione: _distruggi_prenotazioni
  * --------------------------------
- * Funzione ausiliaria ricorsiva per deallocare tutti i nodi di un albero AVL delle prenotazioni.
+ * Funzione ausiliaria ricorsiva per deallocare tutte le prenotazioni di un albero AVL.
  *
  * Implementazione:
  *    - Esegue una visita in post-order dell'albero (sinistra, destra, radice).
  *    - Visita ricorsivamente il figlio sinistro del `nodo`.
  *    - Visita ricorsivamente il figlio destro del `nodo`.
- *    - Dopo aver deallocato i figli, chiama `distruggi_nodo_prenotazioni` per liberare
- *    la memoria del `nodo` corrente e della sua prenotazione.
+ *    - Dopo aver visitato i figli, chiama `distruggi_prenotazione` sulla prenotazione
+ *    del `nodo` corrente. I nodi non vengono liberati uno alla volta: la loro memoria
+ *    viene restituita in blocco distruggendo il pool dell'albero.
  *
  * Parametri:
  *    nodo: la radice del sottoalbero da distruggere.
@@ -313,18 +330,17 @@ static void distruggi_nodo_prenotazioni(struct nodo *nodo) {
  *    nodo: non deve essere NULL
  *
  * Post-condizioni:
- *    Tutti i nodi nel sottoalbero radicato in `nodo` e le loro prenotazioni associate
- *    vengono deallocati ricorsivamente.
+ *    Tutte le prenotazioni nel sottoalbero radicato in `nodo` vengono deallocate ricorsivamente.
  *
  * Side-effect:
- *    Dealloca memoria dinamicamente per tutti i nodi e le prenotazioni dell'albero.
+ *    Dealloca memoria dinamicamente per tutte le prenotazioni dell'albero.
  */
 static void _distruggi_prenotazioni(struct nodo *nodo) {
     if (!nodo) return;
 
     _distruggi_prenotazioni(nodo->sinistra);
     _distruggi_prenotazioni(nodo->destra);
-    distruggi_nodo_prenotazioni(nodo);
+    distruggi_prenotazione(nodo->prenotazione);
 }
 
 /*
@@ -334,28 +350,36 @@ static void _distruggi_prenotazioni(struct nodo *nodo) {
  *
  * Implementazione:
  *    - Caso base: Se `albero` è NULL, crea un nuovo nodo con la `prenotazione` e lo restituisce.
- *    - Verifica sovrapposizione: Ottiene gli intervalli della prenotazione nel nodo corrente
- *    e della nuova prenotazione. Se si sovrappongono, restituisce NULL per indicare un conflitto.
+ *    - Verifica sovrapposizione: confronta `inizio` e `fine` della nuova prenotazione con
+ *    gli estremi salvati nel nodo corrente. Se si sovrappongono, imposta `*esito` a `OCCUPATO`
+ *    e restituisce il sottoalbero invariato.
  *    - Inserimento ricorsivo:
  *    - Se il timestamp di inizio della nuova prenotazione è minore di quello del nodo corrente,
  *    tenta di inserire a sinistra.
  *    - Altrimenti, tenta di inserire a destra.
- *    - Se la chiamata ricorsiva restituisce NULL (indicando una sovrapposizione a un livello inferiore),
- *    propaga il fallimento restituendo NULL.
+ *    - Il figlio viene sostituito solo se l'inserimento ricorsivo è riuscito: in caso di
+ *    sovrapposizione a un livello inferiore l'albero resta intatto.
  *    - Aggiornamento e bilanciamento: Dopo l'inserimento ricorsivo, `aggiorna_nodo` per ricalcolare
  *    altezza e massimo del nodo corrente. Infine, `casi_bilanciamento` viene chiamato per
  *    ripristinare la proprietà AVL se necessario, e la nuova radice del sottoalbero viene restituita.
  *
  * Parametri:
+ *    nodi: il pool da cui prelevare il nuovo nodo.
  *    albero: la radice del sottoalbero corrente in cui tentare l'inserimento.
  *    prenotazione: la prenotazione da aggiungere.
+ *    inizio: l'inizio dell'intervallo della prenotazione.
+ *    fine: la fine dell'intervallo della prenotazione.
+ *    esito: puntatore a un `Byte` impostato a `OCCUPATO` in caso di sovrapposizione
+ *    o di errore di allocazione.
  *
  * Pre-condizioni:
+ *    nodi: non deve essere NULL.
  *    prenotazione: non deve essere NULL.
+ *    esito: non deve essere NULL e deve valere `OK` alla prima chiamata.
  *
  * Post-condizioni:
  *    Restituisce la nuova radice del sottoalbero dopo l'inserimento e il bilanciamento.
- *    Restituisce NULL se la prenotazione si sovrappone con una esistente o in caso di errore di allocazione.
+ *    Se `*esito` vale `OCCUPATO` il sottoalbero non è stato modificato.
  *
  * Ritorna:
  *    un puntatore ad un nodo
@@ -364,38 +388,32 @@ static void _distruggi_prenotazioni(struct nodo *nodo) {
  *    Modifica la struttura dell'albero.
  *    Può allocare memoria per un nuovo nodo.
  */
-static struct nodo *aggiungi_prenotazione_t(struct nodo *albero, Prenotazione prenotazione) {
-    if (!prenotazione) return NULL;
-    if (!albero) return nuovo_nodo(prenotazione);
-
-    Intervallo intervallo_albero = ottieni_intervallo_prenotazione(albero->prenotazione);
-    Intervallo nuovo_intervallo = ottieni_intervallo_prenotazione(prenotazione);
-
-    if (intervalli_si_sovrappongono(nuovo_intervallo, intervallo_albero)) {
-        return NULL; // Rilevata sovrapposizione
+static struct nodo *aggiungi_prenotazione_t(Pool nodi, struct nodo *albero, Prenotazione prenotazione,
+                                            time_t inizio, time_t fine, Byte *esito) {
+    if (!albero) {
+        struct nodo *nodo = nuovo_nodo(nodi, prenotazione);
+        if (!nodo) *esito = OCCUPATO;
+        return nodo;
     }
 
-    time_t inizio_albero = inizio_intervallo(intervallo_albero);
-    time_t nuovo_inizio = inizio_intervallo(nuovo_intervallo);
+    if (inizio < albero->fine && albero->inizio < fine) {
+        *esito = OCCUPATO; // Rilevata sovrapposizione
+        return albero;
+    }
 
-    if (nuovo_inizio < inizio_albero) {
-        albero->sinistra = aggiungi_prenotazione_t(albero->sinistra, prenotazione);
-        // Se la chiamata ricorsiva a sinistra ha fallito per sovrapposizione, propagala.
-        // La condizione `nuovo_inizio < inizio_albero` è un'euristica per il debugging
-        // o per chiarire il contesto del fallimento.
-        if (albero->sinistra == NULL && nuovo_inizio < inizio_albero) {
-            return NULL; // Propagazione di fallimento per sovrapposizione
-        }
+    struct nodo *figlio;
+    if (inizio < albero->inizio) {
+        figlio = aggiungi_prenotazione_t(nodi, albero->sinistra, prenotazione, inizio, fine, esito);
+        if (*esito != OK) return albero; // Propaga il fallimento senza toccare l'albero
+        albero->sinistra = figlio;
     } else {
-        albero->destra = aggiungi_prenotazione_t(albero->destra, prenotazione);
-        // Se la chiamata ricorsiva a destra ha fallito per sovrapposizione, propagala.
-        if (albero->destra == NULL && nuovo_inizio >= inizio_albero) {
-             return NULL; // Propagazione di fallimento per sovrapposizione
-        }
+        figlio = aggiungi_prenotazione_t(nodi, albero->destra, prenotazione, inizio, fine, esito);
+        if (*esito != OK) return albero;
+        albero->destra = figlio;
     }
 
     aggiorna_nodo(albero);
-    return casi_bilanciamento(albero, nuovo_inizio);
+    return casi_bilanciamento(albero);
 }
 
 /*
@@ -415,14 +433,19 @@ static struct nodo *aggiungi_prenotazione_t(struct nodo *albero, Prenotazione pr
  *    di una sovrapposizione nel sottoalbero sinistro. In tal caso, prosegue la ricerca ricorsivamente.
  *    Questa euristica permette di evitare di visitare sottoalberi non pertinenti.
  *    - Ricerca nel figlio destro: Se la ricerca nel figlio sinistro non ha trovato sovrapposizioni
- *    (o se non è stata eseguita), prosegue la ricerca ricorsivamente nel figlio destro.
+ *    (o se non è stata eseguita), prosegue la ricerca ricorsivamente nel figlio destro, ma solo
+ *    se il nodo corrente inizia prima della fine di `i`: tutte le prenotazioni del sottoalbero
+ *    destro iniziano dopo il nodo corrente, quindi altrimenti nessuna può sovrapporsi.
+ *    Senza questo controllo un'interrogazione che scende a sinistra visiterebbe
+ *    interi sottoalberi destri, rendendo il costo lineare invece che logaritmico.
  *
  * Parametri:
  *    radice: la radice del sottoalbero corrente da controllare.
- *    i: l'intervallo di tempo da verificare per la disponibilità.
+ *    inizio: l'inizio dell'intervallo di tempo da verificare.
+ *    fine: la fine dell'intervallo di tempo da verificare.
  *
  * Pre-condizioni:
- *    i: non deve essere NULL
+ *    nessuna
  *
  * Post-condizioni:
  *    Restituisce `OCCUPATO` (1) se `i` si sovrappone con almeno una prenotazione esistente.
@@ -432,25 +455,26 @@ static struct nodo *aggiungi_prenotazione_t(struct nodo *albero, Prenotazione pr
  *    un valore di tipo Byte(0 o 1)
  *
  */
-static Byte controlla_prenotazione_t(struct nodo *radice, Intervallo i) {
+static Byte controlla_prenotazione_t(struct nodo *radice, time_t inizio, time_t fine) {
     if (!radice) return OK;
 
-    Intervallo i_attuale = ottieni_intervallo_prenotazione(radice->prenotazione);
-    time_t inizio_intervallo_da_cercare = inizio_intervallo(i);
-
-    if (intervalli_si_sovrappongono(i_attuale, i))
+    if (inizio < radice->fine && radice->inizio < fine)
         return OCCUPATO;
 
     // Controlla il sottoalbero sinistro solo se il suo 'massimo' supera l'inizio dell'intervallo da cercare.
     // Questo è il cuore dell'ottimizzazione dell'Interval Tree.
-    if (radice->sinistra && radice->sinistra->massimo >= inizio_intervallo_da_cercare) {
-        Byte risultato_sinistra = controlla_prenotazione_t(radice->sinistra, i);
+    if (radice->sinistra && radice->sinistra->massimo >= inizio) {
+        Byte risultato_sinistra = controlla_prenotazione_t(radice->sinistra, inizio, fine);
         if (risultato_sinistra == OCCUPATO) return OCCUPATO;
     }
 
+    // Il sottoalbero destro contiene solo prenotazioni che iniziano dopo il nodo corrente:
+    // se questo inizia già dopo la fine dell'intervallo cercato, non serve scendere.
+    if (radice->inizio >= fine) return OK;
+
     // Se non c'è sovrapposizione a sinistra, controlla il sottoalbero destro.
     // Per gli alberi di intervalli, è spesso necessario controllare entrambi i lati.
-    return controlla_prenotazione_t(radice->destra, i);
+    return controlla_prenotazione_t(radice->destra, inizio, fine);
 }
 
 /*
@@ -505,7 +529,7 @@ static struct nodo *trova_minimo(struct nodo *nodo) {
  *    deallocato e sostituito direttamente dal suo unico figlio (o NULL). `*controllo` è impostato a 1.
  *    - **Caso 2 figli:** Trova il successore in-order (il nodo con il valore minimo
  *    nel sottoalbero destro). La prenotazione del nodo corrente viene sostituita
- *    con una **duplicazione** della prenotazione del successore. Successivamente,
+ *    con un **riferimento condiviso** alla prenotazione del successore. Successivamente,
  *    il successore in-order viene rimosso ricorsivamente dal sottoalbero destro.
  *    `*controllo` viene impostato a 1 se la sottocancellazione ha successo.
  *    - **Ribilanciamento:** Dopo ogni operazione ricorsiva (sia per la ricerca che per la cancellazione),
@@ -513,14 +537,17 @@ static struct nodo *trova_minimo(struct nodo *nodo) {
  *    viene chiamata per ripristinare l'equilibrio AVL se necessario.
  *
  * Parametri:
+ *    nodi: il pool a cui restituire il nodo rimosso.
  *    radice: la radice del sottoalbero corrente.
  *    i: l'intervallo di tempo della prenotazione da rimuovere.
  *    controllo: puntatore a un `Byte` che viene impostato a 1 se la prenotazione è stata effettivamente rimossa,
  *    altrimenti rimane a 0.
+ *    fine: puntatore in cui salvare la fine della prenotazione rimossa.
  *
  * Pre-condizioni:
  *    i: non deve essere NULL.
  *    controllo: non deve essere NULL
+ *    fine: non deve essere NULL
  *    radice: non deve essere NULL
  *
  * Post-condizioni:
@@ -532,20 +559,20 @@ static struct nodo *trova_minimo(struct nodo *nodo) {
  *
  * Side-effect:
  * - Modifica la struttura dell'albero.
- * - Dealloca memoria per il nodo rimosso e la sua prenotazione.
- * - Potrebbe allocare memoria per la duplicazione della prenotazione nel caso di 2 figli.
+ * - Dealloca memoria per il nodo rimosso e rilascia il riferimento alla sua prenotazione.
  */
-static struct nodo *cancella_prenotazione_t(struct nodo *radice, Intervallo i, Byte *controllo) {
+static struct nodo *cancella_prenotazione_t(Pool nodi, struct nodo *radice, Intervallo i, Byte *controllo, time_t *fine) {
     if (!radice) return radice; // Prenotazione non trovata
 
-    Intervallo i_attuale = ottieni_intervallo_prenotazione(radice->prenotazione);
+    time_t inizio_attuale = radice->inizio;
     time_t inizio_intervallo_da_rimuovere = inizio_intervallo(i);
 
-    if (compara_intervalli(i_attuale, i) == 0) { // Trovato il nodo da rimuovere
+    if (inizio_attuale == inizio_intervallo_da_rimuovere) { // Trovato il nodo da rimuovere
+        *fine = radice->fine;
         // Gestione casi di cancellazione: 0, 1 o 2 figli
         if (!radice->sinistra || !radice->destra) {
             struct nodo *temp = radice->sinistra ? radice->sinistra : radice->destra;
-            distruggi_nodo_prenotazioni(radice);
+            distruggi_nodo_prenotazioni(nodi, radice);
             *controllo = 1;
             return temp;
         } else { // Nodo con due figli
@@ -554,10 +581,13 @@ static struct nodo *cancella_prenotazione_t(struct nodo *radice, Intervallo i, B
 
             // Sostituisci la prenotazione del nodo corrente con quella del successore in-order
             distruggi_prenotazione(radice->prenotazione);
-            radice->prenotazione = duplica_prenotazione(temp->prenotazione); // ATTENZIONE: qui si duplica
+            radice->prenotazione = condividi_prenotazione(temp->prenotazione); // Il successore viene rilasciato sotto
+            radice->inizio = temp->inizio;
+            radice->fine = temp->fine;
 
             Byte controllo_dx = 0; // Variabile di controllo per la sottocancellazione
-            radice->destra = cancella_prenotazione_t(radice->destra, i_min_temp, &controllo_dx);
+            time_t fine_successore;
+            radice->destra = cancella_prenotazione_t(nodi, radice->destra, i_min_temp, &controllo_dx, &fine_successore);
             if (controllo_dx)
                 *controllo = 1; // Se il successore è stato rimosso, allora l'operazione è riuscita
         }
@@ -565,17 +595,17 @@ static struct nodo *cancella_prenotazione_t(struct nodo *radice, Intervallo i, B
     // Ricerca ricorsiva della prenotazione da rimuovere
     // Per una cancellazione precisa, la condizione dovrebbe essere basata solo sul confronto delle chiavi
     // (inizio_intervallo), non sul campo 'massimo'. Il campo 'massimo' è per la ricerca di sovrapposizioni.
-    else if (inizio_intervallo_da_rimuovere < inizio_intervallo(i_attuale)) {
-        radice->sinistra = cancella_prenotazione_t(radice->sinistra, i, controllo);
+    else if (inizio_intervallo_da_rimuovere < inizio_attuale) {
+        radice->sinistra = cancella_prenotazione_t(nodi, radice->sinistra, i, controllo, fine);
     }
     else {
-        radice->destra = cancella_prenotazione_t(radice->destra, i, controllo);
+        radice->destra = cancella_prenotazione_t(nodi, radice->destra, i, controllo, fine);
     }
 
     if (!radice) return radice; // Se il nodo è stato rimosso, non bilanciare
 
     aggiorna_nodo(radice);
-    return casi_bilanciamento(radice, inizio_intervallo(i_attuale)); // Bilancia l'albero
+    return casi_bilanciamento(radice); // Bilancia l'albero
 }
 
 /*
@@ -587,8 +617,8 @@ static struct nodo *cancella_prenotazione_t(struct nodo *radice, Intervallo i, B
  * Implementazione:
  *    - Caso base: Se la `radice` è NULL, la ricorsione termina.
  *    - Visita il sottoalbero sinistro ricorsivamente.
- *    - Al ritorno dal sottoalbero sinistro, copia la `prenotazione` del nodo corrente
- *    nell'array `result` all'indice specificato da `*index`, e poi incrementa `*index`.
+ *    - Al ritorno dal sottoalbero sinistro, mette un riferimento condiviso alla `prenotazione`
+ *    del nodo corrente nell'array `result` all'indice specificato da `*index`, e poi incrementa `*index`.
  *    - Visita il sottoalbero destro ricorsivamente.
  *    Questa sequenza garantisce che le prenotazioni vengano aggiunte all'array
  *    in ordine cronologico di inizio.
@@ -616,11 +646,169 @@ static void prenotazioni_in_vettore_t(struct nodo *radice, Prenotazione *result,
     if (!radice) return;
 
     prenotazioni_in_vettore_t(radice->sinistra, result, index);
-    result[*index] = duplica_prenotazione(radice->prenotazione);
+    result[*index] = condividi_prenotazione(radice->prenotazione);
     (*index)++;
     prenotazioni_in_vettore_t(radice->destra, result, index);
 }
 
+/*
+ * Funzione: visita_in_ordine_t
+ * ----------------------------
+ * Funzione ausiliaria ricorsiva per la visita in-order dell'albero.
+ *
+ * Implementazione:
+ *    Visita il sottoalbero sinistro, chiama `visita` sulla prenotazione del nodo
+ *    corrente e poi visita il sottoalbero destro.
+ *
+ * Parametri:
+ *    radice: la radice del sottoalbero corrente.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    visita: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ */
+static void visita_in_ordine_t(struct nodo *radice, VisitatorePrenotazioni visita, void *contesto) {
+    if (!radice) return;
+
+    visita_in_ordine_t(radice->sinistra, visita, contesto);
+    visita(radice->prenotazione, contesto);
+    visita_in_ordine_t(radice->destra, visita, contesto);
+}
+
+/*
+ * Funzione: visita_livello_t
+ * --------------------------
+ * Funzione ausiliaria ricorsiva che visita, da sinistra verso destra, i soli nodi
+ * che si trovano a profondità `livello` rispetto a `radice`.
+ *
+ * Implementazione:
+ *    Scende nei figli decrementando `livello` e chiama `visita` quando arriva a 0.
+ *    Ripetendo la visita per ogni livello si ottiene l'ordine BFS senza coda:
+ *    essendo l'albero bilanciato, i nodi dei livelli superiori sono meno della metà
+ *    del totale, quindi il costo complessivo resta O(n).
+ *
+ * Parametri:
+ *    radice: la radice del sottoalbero corrente.
+ *    livello: profondità dei nodi da visitare.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    visita: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ */
+static void visita_livello_t(struct nodo *radice, int livello, VisitatorePrenotazioni visita, void *contesto) {
+    if (!radice) return;
+
+    if (livello == 0) {
+        visita(radice->prenotazione, contesto);
+        return;
+    }
+    visita_livello_t(radice->sinistra, livello - 1, visita, contesto);
+    visita_livello_t(radice->destra, livello - 1, visita, contesto);
+}
+
+/*
+ * Funzione: visita_in_intervallo_t
+ * --------------------------------
+ * Funzione ausiliaria ricorsiva per la visita in-order delle sole prenotazioni
+ * che si sovrappongono a [da, a).
+ *
+ * Implementazione:
+ *    - Se il campo `massimo` del sottoalbero non supera `da`, nessuna prenotazione
+ *    del sottoalbero termina dopo `da`: il sottoalbero viene saltato.
+ *    - Visita il sottoalbero sinistro, poi il nodo corrente se si sovrappone.
+ *    - Il sottoalbero destro contiene solo prenotazioni che iniziano dopo il nodo
+ *    corrente: se questo inizia già da `a` in poi, il sottoalbero destro viene saltato.
+ *
+ * Parametri:
+ *    radice: la radice del sottoalbero corrente.
+ *    da: inizio dell'intervallo di interesse.
+ *    a: fine dell'intervallo di interesse.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    visita: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ */
+static void visita_in_intervallo_t(struct nodo *radice, time_t da, time_t a,
+                                   VisitatorePrenotazioni visita, void *contesto) {
+    if (!radice || radice->massimo <= da) return;
+
+    visita_in_intervallo_t(radice->sinistra, da, a, visita, contesto);
+
+    if (radice->inizio >= a) return;
+
+    if (radice->fine > da) {
+        visita(radice->prenotazione, contesto);
+    }
+    visita_in_intervallo_t(radice->destra, da, a, visita, contesto);
+}
+
+/*
+ * Funzione: costruisci_da_vettore_t
+ * ---------------------------------
+ * Funzione ausiliaria ricorsiva che costruisce un sottoalbero bilanciato a partire
+ * da una porzione di un vettore di prenotazioni già ordinato.
+ *
+ * Implementazione:
+ *    - Caso base: se la porzione è vuota (`sinistra > destra`) restituisce NULL.
+ *    - Sceglie come radice l'elemento centrale della porzione, così che i due
+ *    sottoalberi differiscano al più di un elemento.
+ *    - Costruisce ricorsivamente il sottoalbero sinistro con gli elementi precedenti
+ *    e il sottoalbero destro con quelli successivi.
+ *    - Chiama `aggiorna_nodo` sulla radice: essendo i figli già completi, `altezza`
+ *    e `massimo` risultano corretti senza bisogno di rotazioni.
+ *    Ogni elemento viene visitato una sola volta, quindi il costo è O(n).
+ *
+ * Parametri:
+ *    nodi: il pool da cui prelevare i nodi.
+ *    vettore: il vettore ordinato di prenotazioni.
+ *    sinistra: indice del primo elemento della porzione.
+ *    destra: indice dell'ultimo elemento della porzione.
+ *    errore: puntatore a un `Byte` impostato a 1 se un'allocazione fallisce.
+ *
+ * Pre-condizioni:
+ *    nodi: non deve essere NULL
+ *    vettore: non deve essere NULL
+ *    errore: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    Restituisce la radice del sottoalbero costruito, oppure NULL se la porzione è vuota
+ *    o in caso di errore di allocazione (`*errore` vale 1).
+ *
+ * Ritorna:
+ *    un puntatore ad un nodo o NULL
+ *
+ * Side-effect:
+ *    Preleva un nodo dal pool per ogni elemento della porzione.
+ */
+static struct nodo *costruisci_da_vettore_t(Pool nodi, Prenotazione *vettore, long sinistra, long destra, Byte *errore) {
+    if (sinistra > destra || *errore) return NULL;
+
+    long centro = sinistra + (destra - sinistra) / 2;
+    struct nodo *radice = nuovo_nodo(nodi, vettore[centro]);
+    if (!radice) {
+        *errore = 1;
+        return NULL;
+    }
+
+    radice->sinistra = costruisci_da_vettore_t(nodi, vettore, sinistra, centro - 1, errore);
+    radice->destra = costruisci_da_vettore_t(nodi, vettore, centro + 1, destra, errore);
+
+    aggiorna_nodo(radice);
+    return radice;
+}
+
 /*
  * Funzione: crea_prenotazioni
  * ---------------------------
@@ -630,6 +818,8 @@ static void prenotazioni_in_vettore_t(struct nodo *radice, Prenotazione *result,
  *    - Alloca memoria per una nuova struttura `struct albero`.
  *    - Se l'allocazione ha successo, inizializza il puntatore `radice` a NULL
  *    e `num_nodi` a 0, indicando che l'albero è inizialmente vuoto.
+ *    - Crea il pool da cui verranno prelevati i nodi dell'albero.
+ *    - Inizializza la mappa di occupazione con l'orizzonte che parte da oggi.
  *
  * Parametri:
  *    Nessuno
@@ -655,6 +845,14 @@ Prenotazioni crea_prenotazioni() {
 
     albero->num_nodi = 0;
     albero->radice = NULL;
+    albero->osservatore = NULL;
+    albero->contesto_osservatore = NULL;
+    inizializza_occupazione(&albero->occupazione, time(NULL));
+    albero->nodi = crea_pool(sizeof(struct nodo), NODI_PER_BLOCCO);
+    if (!albero->nodi) {
+        free(albero);
+        return NULL;
+    }
     return albero;
 }
 
@@ -668,9 +866,8 @@ Prenotazioni crea_prenotazioni() {
  *    - Se `prenotazioni` è NULL, la funzione termina senza fare nulla.
  *    - Chiama la funzione ausiliaria ricorsiva `_distruggi_prenotazioni`,
  *    passando la radice dell'albero. Questa funzione si occupa di
- *    deallocare ricorsivamente tutti i nodi in post-order.
- *    - Dopo che tutti i nodi sono stati deallocati, imposta `radice` a NULL
- *    e `num_nodi` a 0 per pulire lo stato dell'albero.
+ *    deallocare ricorsivamente tutte le prenotazioni in post-order.
+ *    - Distrugge il pool dei nodi, liberando in blocco la memoria di tutti i nodi.
  *    - Infine, libera la memoria della struttura `Prenotazioni` stessa.
  *
  * Parametri:
@@ -689,9 +886,82 @@ Prenotazioni crea_prenotazioni() {
 void distruggi_prenotazioni(Prenotazioni prenotazioni) {
     if (!prenotazioni) return;
     if(prenotazioni->num_nodi) _distruggi_prenotazioni(prenotazioni->radice);
+    distruggi_pool(prenotazioni->nodi);
     free(prenotazioni);
 }
 
+/*
+ * Funzione: crea_prenotazioni_da_vettore
+ * --------------------------------------
+ * Crea una struttura `Prenotazioni` a partire da un vettore di prenotazioni
+ * ordinate per data di inizio e prive di sovrapposizioni, in tempo lineare.
+ *
+ * Implementazione:
+ *    - Verifica in un'unica passata che ogni prenotazione termini non oltre l'inizio
+ *    della successiva: questa condizione garantisce sia l'ordinamento sia l'assenza
+ *    di sovrapposizioni (per transitività), senza interrogare l'albero.
+ *    - Crea una struttura vuota con `crea_prenotazioni`.
+ *    - Costruisce l'albero con `costruisci_da_vettore_t`, scegliendo ricorsivamente
+ *    l'elemento centrale come radice. L'albero risultante è perfettamente bilanciato
+ *    (quindi rispetta la proprietà AVL) e i campi `massimo` sono già aggiornati.
+ *    - Segna nella mappa di occupazione le prenotazioni che cadono nell'orizzonte.
+ *    - In caso di errore di allocazione distrugge il pool e la struttura, senza
+ *    toccare le prenotazioni, che restano del chiamante.
+ *
+ * Parametri:
+ *    vettore: il vettore di prenotazioni ordinato per data di inizio.
+ *    n: il numero di elementi del vettore.
+ *
+ * Pre-condizioni:
+ *    vettore: può essere NULL solo se `n` è 0
+ *
+ * Post-condizioni:
+ *    Restituisce la nuova struttura `Prenotazioni` che possiede le prenotazioni del vettore.
+ *    Restituisce NULL se il vettore non è ordinato, contiene sovrapposizioni o in caso
+ *    di errore di allocazione; in tal caso le prenotazioni restano del chiamante.
+ *
+ * Ritorna:
+ *    un puntatore alla struttura prenotazioni o NULL
+ *
+ * Side-effect:
+ *    Alloca memoria per la struttura e per i nodi dell'albero.
+ */
+Prenotazioni crea_prenotazioni_da_vettore(Prenotazione *vettore, unsigned int n) {
+    if (!vettore && n > 0) return NULL;
+
+    unsigned int i;
+    for (i = 0; i < n; i++) {
+        if (!vettore[i]) return NULL;
+        if (i > 0) {
+            Intervallo precedente = ottieni_intervallo_prenotazione(vettore[i - 1]);
+            Intervallo corrente = ottieni_intervallo_prenotazione(vettore[i]);
+            if (fine_intervallo(precedente) > inizio_intervallo(corrente))
+                return NULL; // Vettore non ordinato o con sovrapposizioni
+        }
+    }
+
+    Prenotazioni albero = crea_prenotazioni();
+    if (!albero) return NULL;
+    if (n == 0) return albero;
+
+    Byte errore = 0;
+    struct nodo *radice = costruisci_da_vettore_t(albero->nodi, vettore, 0, (long)n - 1, &errore);
+    if (errore) {
+        // I nodi sono liberati in blocco, le prenotazioni restano al chiamante
+        distruggi_pool(albero->nodi);
+        free(albero);
+        return NULL;
+    }
+
+    albero->radice = radice;
+    albero->num_nodi = n;
+    for (i = 0; i < n; i++) {
+        Intervallo intervallo = ottieni_intervallo_prenotazione(vettore[i]);
+        segna_occupazione(&albero->occupazione, inizio_intervallo(intervallo), fine_intervallo(intervallo));
+    }
+    return albero;
+}
+
 /*
  * Funzione: aggiungi_prenotazione
  * -------------------------------
@@ -699,17 +969,17 @@ void distruggi_prenotazioni(Prenotazioni prenotazioni) {
  *
  * Implementazione:
  *    - Verifica che `albero` e `prenotazione` non siano NULL.
+ *    - Se la mappa di occupazione indica già una sovrapposizione restituisce `OCCUPATO`.
  *    - Chiama la funzione ausiliaria ricorsiva `aggiungi_prenotazione_t` per
  *    gestire l'inserimento effettivo della prenotazione, il controllo delle
  *    sovrapposizioni e il bilanciamento dell'albero.
- *    - Analizza il valore di ritorno di `aggiungi_prenotazione_t`:
- *    - Se `nuova_radice` è NULL e la radice originale dell'albero non era NULL,
- *    significa che l'inserimento è fallito a causa di una sovrapposizione esistente,
- *    quindi restituisce `OCCUPATO`.
- *    - Se `nuova_radice` è NULL e la radice originale era NULL (ovvero, si è tentato
- *    di inserire il primo nodo ma l'allocazione è fallita), restituisce 0 (errore generico).
- *    - Se `nuova_radice` non è NULL, l'inserimento è riuscito. La radice dell'albero
- *    viene aggiornata e il contatore `num_nodi` viene incrementato. Restituisce `OK`.
+ *    - Gli estremi dell'intervallo vengono letti una sola volta e passati alla ricorsione.
+ *    - Se `aggiungi_prenotazione_t` segnala una sovrapposizione o un errore di allocazione,
+ *    l'albero non è stato modificato e viene restituito `OCCUPATO`.
+ *    - Altrimenti l'inserimento è riuscito: la radice dell'albero viene aggiornata,
+ *    il contatore `num_nodi` viene incrementato, la mappa di occupazione aggiornata
+ *    (spostandone l'orizzonte se necessario) e l'eventuale osservatore avvisato.
+ *    Restituisce `OK`.
  *
  * Parametri:
  *    albero: il puntatore alla struttura `Prenotazioni` a cui aggiungere la prenotazione.
@@ -735,17 +1005,23 @@ void distruggi_prenotazioni(Prenotazioni prenotazioni) {
 Byte aggiungi_prenotazione(Prenotazioni albero, Prenotazione prenotazione) {
     if (!albero || !prenotazione) return 0;
 
-    struct nodo *nuova_radice = aggiungi_prenotazione_t(albero->radice, prenotazione);
-    if (nuova_radice == NULL && albero->radice != NULL) {
-        return OCCUPATO; // Inserimento fallito per sovrapposizione
-    } else if (nuova_radice == NULL && albero->radice == NULL) {
-        // Questo caso si verifica se `nuovo_nodo` in `aggiungi_prenotazione_t` restituisce NULL
-        // quando `albero->radice` è inizialmente NULL (primo inserimento fallito).
-        return OCCUPATO; // Errore generico (es. allocazione fallita per il primo nodo)
+    Intervallo i = ottieni_intervallo_prenotazione(prenotazione);
+    if (esito_occupazione(&albero->occupazione, inizio_intervallo(i), fine_intervallo(i)) == OCCUPATO)
+        return OCCUPATO;
+
+    Byte esito = OK;
+    struct nodo *nuova_radice = aggiungi_prenotazione_t(albero->nodi, albero->radice, prenotazione,
+                                                        inizio_intervallo(i), fine_intervallo(i), &esito);
+    if (esito != OK) {
+        return OCCUPATO; // Sovrapposizione o allocazione fallita: l'albero è invariato
     }
 
     albero->radice = nuova_radice;
     albero->num_nodi++;
+    aggiorna_orizzonte_occupazione(&albero->occupazione, albero, time(NULL));
+    segna_occupazione(&albero->occupazione, inizio_intervallo(i), fine_intervallo(i));
+    if (albero->osservatore)
+        albero->osservatore(inizio_intervallo(i), fine_intervallo(i), 1, albero->contesto_osservatore);
     return OK;
 }
 
@@ -757,7 +1033,9 @@ Byte aggiungi_prenotazione(Prenotazioni albero, Prenotazione prenotazione) {
  *
  * Implementazione:
  *    - Verifica che i puntatori `prenotazioni` e `i` non siano NULL.
- *    - Delega il controllo effettivo alla funzione ausiliaria ricorsiva `controlla_prenotazione_t`,
+ *    - Se l'intervallo cade nell'orizzonte della mappa di occupazione, di solito la
+ *    risposta arriva da pochi bit senza visitare l'albero (`esito_occupazione`).
+ *    - Altrimenti delega il controllo effettivo alla funzione ausiliaria ricorsiva `controlla_prenotazione_t`,
  *    che implementa la logica di ricerca efficiente specifica per gli alberi di intervalli
  *    (utilizzando il campo `massimo` per ottimizzare le traversate).
  *    - Restituisce il risultato direttamente da `controlla_prenotazione_t`.
@@ -780,7 +1058,12 @@ Byte aggiungi_prenotazione(Prenotazioni albero, Prenotazione prenotazione) {
  */
 Byte controlla_prenotazione(Prenotazioni prenotazioni, Intervallo i) {
     if (!prenotazioni || !i) return OK;
-    return controlla_prenotazione_t(prenotazioni->radice, i);
+
+    time_t inizio = inizio_intervallo(i);
+    time_t fine = fine_intervallo(i);
+    Byte esito = esito_occupazione(&prenotazioni->occupazione, inizio, fine);
+    if (esito != INCERTO) return esito;
+    return controlla_prenotazione_t(prenotazioni->radice, inizio, fine);
 }
 
 /*
@@ -797,7 +1080,9 @@ Byte controlla_prenotazione(Prenotazioni prenotazioni, Intervallo i) {
  *    - Chiama `cancella_prenotazione_t` per eseguire l'operazione di cancellazione
  *    e ripristino dell'equilibrio AVL.
  *    - Se `controllo` è stato impostato a 1 (significando che la prenotazione è stata rimossa),
- *    decrementa il contatore `num_nodi` nella struttura `Prenotazioni`.
+ *    decrementa il contatore `num_nodi` nella struttura `Prenotazioni`, aggiorna la
+ *    mappa di occupazione e avvisa l'eventuale osservatore con gli estremi della
+ *    prenotazione rimossa.
  *    - Restituisce il valore finale di `controllo`.
  *
  * Parametri:
@@ -825,8 +1110,14 @@ Byte cancella_prenotazione(Prenotazioni prenotazioni, Intervallo i) {
     if (!prenotazioni || !i) return 0;
 
     Byte controllo = 0; // Verrà impostato a 1 se la cancellazione ha successo
-    prenotazioni->radice = cancella_prenotazione_t(prenotazioni->radice, i, &controllo);
-    if (controllo) prenotazioni->num_nodi--; // Decrementa il contatore solo se la prenotazione è stata rimossa
+    time_t fine = 0;    // Fine della prenotazione rimossa, che può differire da quella di `i`
+    prenotazioni->radice = cancella_prenotazione_t(prenotazioni->nodi, prenotazioni->radice, i, &controllo, &fine);
+    if (!controllo) return 0;
+
+    prenotazioni->num_nodi--; // Decrementa il contatore solo se la prenotazione è stata rimossa
+    libera_occupazione(&prenotazioni->occupazione, prenotazioni, inizio_intervallo(i), fine);
+    if (prenotazioni->osservatore)
+        prenotazioni->osservatore(inizio_intervallo(i), fine, 0, prenotazioni->contesto_osservatore);
     return controllo;
 }
 
@@ -866,7 +1157,8 @@ Byte cancella_prenotazione(Prenotazioni prenotazioni, Intervallo i) {
  *
  * Side-effect:
  *    Alloca memoria dinamicamente per l'array risultante. La memoria deve essere
- *    liberata dal chiamante (`free`).
+ *    liberata dal chiamante (`free`), dopo aver rilasciato ogni prenotazione con
+ *    `distruggi_prenotazione`: sono riferimenti condivisi con l'albero, non copie.
  */
 Prenotazione *ottieni_vettore_prenotazioni_ordinate(Prenotazioni prenotazioni, unsigned int *size) {
     if (!prenotazioni || !size) return NULL;
@@ -922,7 +1214,8 @@ Prenotazione *ottieni_vettore_prenotazioni_ordinate(Prenotazioni prenotazioni, u
  *
  * Side-effect:
  *    Alloca memoria dinamicamente per l'array `result` e per la coda temporanea.
- *    La memoria dell'array restituito deve essere liberata dal chiamante (`free`).
+ *    La memoria dell'array restituito deve essere liberata dal chiamante (`free`),
+ *    dopo aver rilasciato ogni prenotazione (riferimento condiviso) con `distruggi_prenotazione`.
  */
 Prenotazione *ottieni_vettore_prenotazioni_per_file(Prenotazioni prenotazioni, unsigned int *size) {
     if (!prenotazioni || !size) return NULL;
@@ -953,7 +1246,7 @@ Prenotazione *ottieni_vettore_prenotazioni_per_file(Prenotazioni prenotazioni, u
         struct nodo *temp = (struct nodo *)rimuovi_dalla_coda(q);
         if (!temp) continue; // Dovrebbe accadere solo se la coda è stata corrotta
 
-        result[i++] = duplica_prenotazione(temp->prenotazione); // Aggiungi la prenotazione all'array
+        result[i++] = condividi_prenotazione(temp->prenotazione); // Aggiungi la prenotazione all'array
 
         // Aggiungi i figli alla coda (se esistono)
         if (temp->sinistra) {
@@ -979,65 +1272,170 @@ Prenotazione *ottieni_vettore_prenotazioni_per_file(Prenotazioni prenotazioni, u
 }
 
 /*
- * Funzione: ottieni_intervallo_disponibile_t
- * ------------------------------------------
- * Cerca un intervallo di tempo disponibile all'interno di un intervallo dato `i`
- * scorrendo ricorsivamente un albero binario di prenotazioni.
+ * Funzione: dimensione_prenotazioni
+ * ---------------------------------
+ * Restituisce il numero di prenotazioni contenute nell'albero.
  *
  * Implementazione:
- *    - Se il nodo radice è NULL, restituisce una copia dell'intervallo `i`.
- *    - Ottiene l'intervallo della prenotazione corrente dal nodo radice.
- *    - Calcola il tempo di inizio dell'intervallo `i` (start_cerca).
- *    - Se gli intervalli `cur` e `i` si sovrappongono:
- *    - Se l'inizio di `cur` è successivo a `start_cerca`, restituisce un intervallo
- *    che va da `start_cerca` all'inizio di `cur`.
- *    - Altrimenti restituisce NULL (nessun intervallo disponibile prima della sovrapposizione).
+ *    Restituisce il contatore `num_nodi` mantenuto da inserimenti e cancellazioni.
  *
  * Parametri:
- *    radice: puntatore al nodo corrente dell'albero di prenotazioni.
- *    i: intervallo temporale da verificare per disponibilità.
+ *    prenotazioni: il puntatore alla struttura `Prenotazioni` da interrogare.
  *
  * Pre-condizioni:
- *    i: non deve essere NULL
- *    radice: non deve essere NULL
+ *    prenotazioni: può essere NULL
  *
  * Post-condizioni:
- *    Restituisce un intervallo disponibile all'interno di `i` se trovato, NULL altrimenti.
+ *    Restituisce il numero di prenotazioni, 0 se `prenotazioni` è NULL.
  *
  * Ritorna:
- *    un puntatore alla struttura intervallo o NULL
+ *    un intero senza segno
+ */
+unsigned int dimensione_prenotazioni(Prenotazioni prenotazioni) {
+    if (!prenotazioni) return 0;
+    return prenotazioni->num_nodi;
+}
+
+/*
+ * Funzione: visita_prenotazioni_in_ordine
+ * ---------------------------------------
+ * Chiama `visita` su tutte le prenotazioni dell'albero in ordine cronologico
+ * di inizio, senza copiarle.
+ *
+ * Implementazione:
+ *    Delega la visita in-order alla funzione ricorsiva `visita_in_ordine_t`;
+ *    la profondità della ricorsione è limitata dall'altezza dell'albero AVL.
+ *
+ * Parametri:
+ *    prenotazioni: il puntatore alla struttura `Prenotazioni` da visitare.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL (nessuna operazione)
+ *    visita: non deve essere NULL
+ *    `visita` non deve aggiungere o cancellare prenotazioni dall'albero.
+ *
+ * Post-condizioni:
+ *    non restituisce niente
  *
  * Side-effect:
- *    Può allocare memoria per l'intervallo restituito; la gestione della memoria
- *    è responsabilità del chiamante.
+ *    Nessuna allocazione di memoria; gli effetti sono quelli di `visita`.
  */
-static Intervallo ottieni_intervallo_disponibile_t(struct nodo *radice, Intervallo i) {
-    if (!radice)
-        return duplica_intervallo(i);
-
-    Intervallo cur = ottieni_intervallo_prenotazione(radice->prenotazione);
-    time_t start_cerca = inizio_intervallo(i);
-
-    // 1) Se si sovrappone, viene restituito subito il gap prima o NULL
-    if (intervalli_si_sovrappongono(cur, i)) {
-        time_t s_cur = inizio_intervallo(cur);
-        if (s_cur > start_cerca)
-            return crea_intervallo(start_cerca, s_cur);
-        else
-            return NULL;
-    }
+void visita_prenotazioni_in_ordine(Prenotazioni prenotazioni, VisitatorePrenotazioni visita, void *contesto) {
+    if (!prenotazioni || !visita) return;
+    visita_in_ordine_t(prenotazioni->radice, visita, contesto);
+}
 
-    // 2) Provo a cercare nel sottoalbero sinistro, se ha potenziale
-    if (radice->sinistra && radice->sinistra->massimo >= start_cerca) {
-        Intervallo left = ottieni_intervallo_disponibile_t(radice->sinistra, i);
-        if (left)
-            return left;
-        else
-            return NULL;
+/*
+ * Funzione: visita_prenotazioni_per_livello
+ * -----------------------------------------
+ * Chiama `visita` su tutte le prenotazioni dell'albero in ordine di livello,
+ * senza copiarle.
+ *
+ * Implementazione:
+ *    Invece di usare una coda (che richiederebbe un'allocazione per ogni nodo),
+ *    visita un livello alla volta con `visita_livello_t`, da 0 fino all'altezza
+ *    della radice meno uno.
+ *
+ * Parametri:
+ *    prenotazioni: il puntatore alla struttura `Prenotazioni` da visitare.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL (nessuna operazione)
+ *    visita: non deve essere NULL
+ *    `visita` non deve aggiungere o cancellare prenotazioni dall'albero.
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    Nessuna allocazione di memoria; gli effetti sono quelli di `visita`.
+ */
+void visita_prenotazioni_per_livello(Prenotazioni prenotazioni, VisitatorePrenotazioni visita, void *contesto) {
+    if (!prenotazioni || !visita) return;
+
+    int livelli = altezza(prenotazioni->radice);
+    for (int livello = 0; livello < livelli; livello++) {
+        visita_livello_t(prenotazioni->radice, livello, visita, contesto);
     }
+}
 
-    // 3) Altrimenti cerco nel sottoalbero destro
-    return ottieni_intervallo_disponibile_t(radice->destra, i);
+/*
+ * Funzione: visita_prenotazioni_in_intervallo
+ * -------------------------------------------
+ * Chiama `visita`, in ordine cronologico di inizio, solo sulle prenotazioni che
+ * si sovrappongono all'intervallo [da, a), senza copiarle.
+ *
+ * Implementazione:
+ *    Delega a `visita_in_intervallo_t`, che usa il campo `massimo` e l'ordinamento
+ *    per inizio dell'albero per saltare i sottoalberi fuori dall'intervallo.
+ *    Il costo è O(log n + k), con k il numero di prenotazioni visitate.
+ *
+ * Parametri:
+ *    prenotazioni: il puntatore alla struttura `Prenotazioni` da visitare.
+ *    da: inizio dell'intervallo di interesse.
+ *    a: fine dell'intervallo di interesse.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL (nessuna operazione)
+ *    visita: non deve essere NULL
+ *    `visita` non deve aggiungere o cancellare prenotazioni dall'albero.
+ *
+ * Post-condizioni:
+ *    non restituisce niente; se `da >= a` non viene visitata nessuna prenotazione
+ *
+ * Side-effect:
+ *    Nessuna allocazione di memoria; gli effetti sono quelli di `visita`.
+ */
+void visita_prenotazioni_in_intervallo(Prenotazioni prenotazioni, time_t da, time_t a,
+                                       VisitatorePrenotazioni visita, void *contesto) {
+    if (!prenotazioni || !visita || da >= a) return;
+    visita_in_intervallo_t(prenotazioni->radice, da, a, visita, contesto);
+}
+
+/*
+ * Funzione: prima_sovrapposizione_t
+ * ---------------------------------
+ * Cerca, tra le prenotazioni che si sovrappongono a [inizio, fine), quella che
+ * inizia per prima.
+ *
+ * Implementazione:
+ *    - Se il sottoalbero è vuoto o il suo `massimo` non supera `inizio`, nessuna
+ *    prenotazione del sottoalbero può sovrapporsi: restituisce NULL.
+ *    - Cerca prima nel sottoalbero sinistro, che contiene le prenotazioni che iniziano prima.
+ *    - Altrimenti controlla il nodo corrente.
+ *    - Infine scende a destra, ma solo se il nodo corrente inizia prima di `fine`.
+ *
+ * Parametri:
+ *    radice: la radice del sottoalbero corrente.
+ *    inizio: l'inizio dell'intervallo di interesse.
+ *    fine: la fine dell'intervallo di interesse.
+ *
+ * Pre-condizioni:
+ *    nessuna
+ *
+ * Post-condizioni:
+ *    Restituisce il nodo della prima prenotazione che si sovrappone all'intervallo,
+ *    NULL se non ce ne sono.
+ *
+ * Ritorna:
+ *    un puntatore ad un nodo o NULL
+ */
+static struct nodo *prima_sovrapposizione_t(struct nodo *radice, time_t inizio, time_t fine) {
+    if (!radice || radice->massimo <= inizio) return NULL;
+
+    struct nodo *trovato = prima_sovrapposizione_t(radice->sinistra, inizio, fine);
+    if (trovato) return trovato;
+
+    if (inizio < radice->fine && radice->inizio < fine) return radice;
+
+    if (radice->inizio >= fine) return NULL;
+    return prima_sovrapposizione_t(radice->destra, inizio, fine);
 }
 
 /*
@@ -1048,8 +1446,10 @@ static Intervallo ottieni_intervallo_disponibile_t(struct nodo *radice, Interval
  *
  * Implementazione:
  *    - Controlla che `prenotazioni` e `i` non siano NULL.
- *    - Invoca la funzione ausiliaria `ottieni_intervallo_disponibile_t` passando la radice
- *    dell'albero delle prenotazioni e l'intervallo `i`.
+ *    - Cerca con `prima_sovrapposizione_t` la prima prenotazione che si sovrappone a `i`:
+ *    - se non esiste, l'intero intervallo è disponibile e ne restituisce una copia;
+ *    - se inizia dopo l'inizio di `i`, restituisce il tratto libero fino al suo inizio;
+ *    - altrimenti l'inizio di `i` è occupato e restituisce NULL.
  *
  * Parametri:
  *    prenotazioni: struttura contenente l'albero delle prenotazioni.
@@ -1074,5 +1474,67 @@ Intervallo ottieni_intervallo_disponibile(Prenotazioni prenotazioni, Intervallo
         return NULL;
     }
 
-    return ottieni_intervallo_disponibile_t(prenotazioni->radice, i);
+    time_t inizio = inizio_intervallo(i);
+    struct nodo *occupato = prima_sovrapposizione_t(prenotazioni->radice, inizio, fine_intervallo(i));
+
+    if (!occupato) return duplica_intervallo(i);          // Intervallo interamente libero
+    if (occupato->inizio > inizio) return crea_intervallo(inizio, occupato->inizio);
+    return NULL;                                          // L'inizio di `i` è già occupato
+}
+
+/*
+ * Funzione: imposta_osservatore_prenotazioni
+ * ------------------------------------------
+ * Registra la funzione da avvisare dopo ogni inserimento o cancellazione riuscita.
+ *
+ * Implementazione:
+ *    Salva funzione e contesto nella struttura; `aggiungi_prenotazione` e
+ *    `cancella_prenotazione` li usano solo quando la modifica è avvenuta.
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da osservare.
+ *    osserva: la funzione da chiamare, NULL per rimuovere l'osservatore.
+ *    contesto: puntatore passato invariato a `osserva`.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL (nessuna operazione)
+ *
+ * Post-condizioni:
+ *    non restituisce niente; un eventuale osservatore precedente viene sostituito
+ *
+ * Side-effect:
+ *    Nessuno; le prenotazioni già presenti non vengono notificate.
+ */
+void imposta_osservatore_prenotazioni(Prenotazioni prenotazioni, OsservatorePrenotazioni osserva, void *contesto){
+    if(prenotazioni == NULL) return;
+
+    prenotazioni->osservatore = osserva;
+    prenotazioni->contesto_osservatore = contesto;
+}
+
+/*
+ * Funzione: ottieni_statistiche_prenotazioni
+ * ------------------------------------------
+ * Restituisce i contatori delle allocazioni dei nodi dell'albero delle prenotazioni.
+ *
+ * Implementazione:
+ *    Delega a `ottieni_statistiche_pool` sul pool dei nodi dell'albero.
+ *
+ * Parametri:
+ *    prenotazioni: il puntatore alla struttura `Prenotazioni` da interrogare.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL
+ *
+ * Post-condizioni:
+ *    Restituisce le statistiche del pool dei nodi, oppure contatori a zero
+ *    se `prenotazioni` è NULL.
+ *
+ * Ritorna:
+ *    una struttura StatistichePool
+ */
+StatistichePool ottieni_statistiche_prenotazioni(Prenotazioni prenotazioni){
+    if(prenotazioni == NULL) return ottieni_statistiche_pool(NULL);
+
+    return ottieni_statistiche_pool(prenotazioni->nodi);
 }
@@ -0,0 +1,982 @@
+/*
+ * Implementazione di Prenotazioni a blocchi ordinati (un B+-albero a due livelli).
+ * Le prenotazioni sono tenute in ordine di inizio dentro blocchi di capacità fissa;
+ * ogni blocco memorizza in vettori contigui gli inizi, le fini e i riferimenti alle
+ * prenotazioni. Un indice, anch'esso contiguo, conserva per ogni blocco l'inizio
+ * dell'ultima prenotazione e la fine massima del blocco.
+ *
+ * Poiché le prenotazioni di un veicolo non si sovrappongono e non sono mai vuote,
+ * ordinandole per inizio anche le fini risultano ordinate: la fine massima di un blocco è
+ * quella del suo ultimo elemento e ogni interrogazione si riduce a una ricerca
+ * binaria sull'indice seguita dalla scansione di un solo blocco.
+ *
+ * Espone la stessa interfaccia di `prenotazioni.c` (albero AVL):
+ * il motore da collegare si sceglie nel Makefile.
+ */
+
+#include "strutture_dati/prenotazioni.h"
+#include "modelli/prenotazione.h"
+#include "modelli/intervallo.h"
+#include "strutture_dati/pool.h"
+#include "strutture_dati/occupazione.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CAPACITA_BLOCCO 64          // Prenotazioni per blocco
+#define RIEMPIMENTO_INIZIALE 48     // Prenotazioni per blocco nella costruzione da vettore
+#define BLOCCHI_PER_POOL 64
+#define CAPACITA_INDICE_MINIMA 4
+
+struct blocco {
+    unsigned int n;                             // Prenotazioni presenti nel blocco
+    time_t inizio[CAPACITA_BLOCCO];
+    time_t fine[CAPACITA_BLOCCO];
+    Prenotazione prenotazione[CAPACITA_BLOCCO];
+};
+
+/*
+ * Voce dell'indice: permette di scegliere il blocco giusto senza leggerne il contenuto.
+ */
+struct voce {
+    time_t ultimo_inizio;   // Inizio dell'ultima prenotazione del blocco
+    time_t massimo;         // Fine massima delle prenotazioni del blocco
+    struct blocco *blocco;
+};
+
+struct albero {
+    struct voce *indice;        // Voci dei blocchi, in ordine
+    unsigned int num_blocchi;
+    unsigned int capacita_indice;
+    unsigned int num_nodi;      // Numero totale di prenotazioni
+    OsservatorePrenotazioni osservatore;   // Avvisato dopo inserimenti e cancellazioni, può essere NULL
+    void *contesto_osservatore;
+    Occupazione occupazione;    // Quarti d'ora occupati nei prossimi giorni, per rispondere senza cercare nei blocchi
+};
+
+/*
+ * Pool condiviso da cui vengono prelevati i blocchi di tutti i veicoli, come per le
+ * prenotazioni e gli intervalli: un veicolo con poche prenotazioni occupa un solo
+ * blocco invece del primo blocco di un pool proprio. Viene creato alla prima
+ * richiesta e, come gli altri pool condivisi, non è protetto da lock.
+ */
+static Pool pool_blocchi = NULL;
+
+/*
+ * Funzione: aggiorna_voce
+ * -----------------------
+ * Ricalcola la voce dell'indice relativa al blocco `b`.
+ *
+ * Implementazione:
+ *    Copia l'inizio dell'ultimo elemento; essendo le fini ordinate,
+ *    la fine dell'ultimo elemento è anche la fine massima del blocco.
+ *
+ * Parametri:
+ *    albero: la struttura che contiene l'indice
+ *    b: posizione del blocco nell'indice
+ *
+ * Pre-condizioni:
+ *    albero: non deve essere NULL
+ *    b: deve essere minore di `num_blocchi` e il blocco non deve essere vuoto
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    modifica la voce `b` dell'indice
+ */
+static void aggiorna_voce(Prenotazioni albero, unsigned int b) {
+    struct blocco *blocco = albero->indice[b].blocco;
+    albero->indice[b].ultimo_inizio = blocco->inizio[blocco->n - 1];
+    albero->indice[b].massimo = blocco->fine[blocco->n - 1];
+}
+
+/*
+ * Funzione: primo_blocco_con_fine_oltre
+ * -------------------------------------
+ * Cerca il primo blocco che contiene una prenotazione che termina dopo `t`.
+ *
+ * Implementazione:
+ *    Ricerca binaria sul campo `massimo` dell'indice, che è non decrescente.
+ *
+ * Parametri:
+ *    albero: la struttura in cui cercare
+ *    t: l'istante di riferimento
+ *
+ * Pre-condizioni:
+ *    albero: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce la posizione del blocco, oppure `num_blocchi` se nessuna
+ *    prenotazione termina dopo `t`
+ *
+ * Ritorna:
+ *    un intero senza segno
+ */
+static unsigned int primo_blocco_con_fine_oltre(Prenotazioni albero, time_t t) {
+    unsigned int sinistra = 0, destra = albero->num_blocchi;
+    while (sinistra < destra) {
+        unsigned int centro = sinistra + (destra - sinistra) / 2;
+        if (albero->indice[centro].massimo > t) destra = centro;
+        else sinistra = centro + 1;
+    }
+    return sinistra;
+}
+
+/*
+ * Funzione: trova_prima_con_fine_oltre
+ * ------------------------------------
+ * Cerca la prima prenotazione (in ordine) che termina dopo `t`.
+ *
+ * Implementazione:
+ *    Sceglie il blocco con `primo_blocco_con_fine_oltre` e lo scandisce
+ *    sequenzialmente: i vettori delle fini sono contigui in memoria.
+ *
+ * Parametri:
+ *    albero: la struttura in cui cercare
+ *    t: l'istante di riferimento
+ *    blocco: puntatore in cui salvare la posizione del blocco
+ *    posizione: puntatore in cui salvare la posizione nel blocco
+ *
+ * Pre-condizioni:
+ *    albero, blocco, posizione: non devono essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 e imposta `*blocco` e `*posizione` se la prenotazione esiste,
+ *    altrimenti restituisce 0
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(0 o 1)
+ */
+static Byte trova_prima_con_fine_oltre(Prenotazioni albero, time_t t, unsigned int *blocco, unsigned int *posizione) {
+    unsigned int b = primo_blocco_con_fine_oltre(albero, t);
+    if (b >= albero->num_blocchi) return 0;
+
+    struct blocco *bl = albero->indice[b].blocco;
+    unsigned int i = 0;
+    while (bl->fine[i] <= t) i++;   // Esiste: il massimo del blocco supera t
+
+    *blocco = b;
+    *posizione = i;
+    return 1;
+}
+
+/*
+ * Funzione: sovrapposizione
+ * -------------------------
+ * Verifica se l'intervallo [inizio, fine) si sovrappone a una prenotazione.
+ *
+ * Implementazione:
+ *    Trova la prima prenotazione che termina dopo `inizio`: è l'unica candidata,
+ *    perché le successive iniziano dopo di essa. C'è sovrapposizione se questa
+ *    inizia prima di `fine`.
+ *
+ * Parametri:
+ *    albero: la struttura da interrogare
+ *    inizio: l'inizio dell'intervallo
+ *    fine: la fine dell'intervallo
+ *
+ * Pre-condizioni:
+ *    albero: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se esiste una sovrapposizione, 0 altrimenti
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(0 o 1)
+ */
+static Byte sovrapposizione(Prenotazioni albero, time_t inizio, time_t fine) {
+    unsigned int b, i;
+    if (!trova_prima_con_fine_oltre(albero, inizio, &b, &i)) return 0;
+    return albero->indice[b].blocco->inizio[i] < fine;
+}
+
+/*
+ * Funzione: riserva_indice
+ * ------------------------
+ * Garantisce che l'indice possa contenere almeno `richiesti` blocchi.
+ *
+ * Implementazione:
+ *    Raddoppia la capacità dell'indice con realloc finché non è sufficiente.
+ *
+ * Parametri:
+ *    albero: la struttura da modificare
+ *    richiesti: numero di voci necessarie
+ *
+ * Pre-condizioni:
+ *    albero: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 in caso di successo, 0 se l'allocazione fallisce (l'indice resta invariato)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(0 o 1)
+ *
+ * Side-effect:
+ *    può riallocare l'indice
+ */
+static Byte riserva_indice(Prenotazioni albero, unsigned int richiesti) {
+    if (richiesti <= albero->capacita_indice) return 1;
+
+    unsigned int capacita = albero->capacita_indice ? albero->capacita_indice : CAPACITA_INDICE_MINIMA;
+    while (capacita < richiesti) capacita *= 2;
+
+    struct voce *nuovo = realloc(albero->indice, sizeof(struct voce) * capacita);
+    if (!nuovo) return 0;
+
+    albero->indice = nuovo;
+    albero->capacita_indice = capacita;
+    return 1;
+}
+
+/*
+ * Funzione: nuovo_blocco
+ * ----------------------
+ * Preleva un blocco vuoto dal pool condiviso (creandolo alla prima richiesta) e lo
+ * inserisce nell'indice alla posizione `b`.
+ *
+ * Parametri:
+ *    albero: la struttura da modificare
+ *    b: posizione del nuovo blocco nell'indice
+ *
+ * Pre-condizioni:
+ *    albero: non deve essere NULL
+ *    b: deve essere minore o uguale a `num_blocchi`
+ *
+ * Post-condizioni:
+ *    restituisce il nuovo blocco, oppure NULL in caso di errore di allocazione
+ *    (la struttura resta invariata)
+ *
+ * Ritorna:
+ *    un puntatore ad un blocco o NULL
+ *
+ * Side-effect:
+ *    sposta le voci successive a `b`; la voce `b` va aggiornata dal chiamante
+ *    dopo aver riempito il blocco
+ */
+static struct blocco *nuovo_blocco(Prenotazioni albero, unsigned int b) {
+    if (!riserva_indice(albero, albero->num_blocchi + 1)) return NULL;
+
+    if (!pool_blocchi) {
+        pool_blocchi = crea_pool(sizeof(struct blocco), BLOCCHI_PER_POOL);
+        if (!pool_blocchi) return NULL;
+    }
+    struct blocco *blocco = alloca_da_pool(pool_blocchi);
+    if (!blocco) return NULL;
+
+    memmove(&albero->indice[b + 1], &albero->indice[b], sizeof(struct voce) * (albero->num_blocchi - b));
+    albero->indice[b].blocco = blocco;
+    albero->num_blocchi++;
+    return blocco;
+}
+
+/*
+ * Funzione: rimuovi_blocco
+ * ------------------------
+ * Toglie dall'indice il blocco in posizione `b` e lo restituisce al pool.
+ *
+ * Parametri:
+ *    albero: la struttura da modificare
+ *    b: posizione del blocco nell'indice
+ *
+ * Pre-condizioni:
+ *    albero: non deve essere NULL
+ *    b: deve essere minore di `num_blocchi`
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    sposta le voci successive a `b`; le prenotazioni del blocco non vengono distrutte
+ */
+static void rimuovi_blocco(Prenotazioni albero, unsigned int b) {
+    rilascia_in_pool(pool_blocchi, albero->indice[b].blocco);
+    memmove(&albero->indice[b], &albero->indice[b + 1], sizeof(struct voce) * (albero->num_blocchi - b - 1));
+    albero->num_blocchi--;
+}
+
+/*
+ * Funzione: dividi_blocco
+ * -----------------------
+ * Divide a metà il blocco pieno in posizione `b`.
+ *
+ * Implementazione:
+ *    Crea un nuovo blocco subito dopo `b` e vi sposta la seconda metà degli elementi.
+ *
+ * Parametri:
+ *    albero: la struttura da modificare
+ *    b: posizione del blocco da dividere
+ *
+ * Pre-condizioni:
+ *    albero: non deve essere NULL
+ *    b: deve essere minore di `num_blocchi`
+ *
+ * Post-condizioni:
+ *    restituisce 1 in caso di successo, 0 in caso di errore di allocazione
+ *    (la struttura resta invariata)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(0 o 1)
+ *
+ * Side-effect:
+ *    aggiunge un blocco all'indice
+ */
+static Byte dividi_blocco(Prenotazioni albero, unsigned int b) {
+    struct blocco *destro = nuovo_blocco(albero, b + 1);
+    if (!destro) return 0;
+
+    struct blocco *sinistro = albero->indice[b].blocco;
+    unsigned int meta = sinistro->n / 2;
+    unsigned int spostati = sinistro->n - meta;
+
+    memcpy(destro->inizio, &sinistro->inizio[meta], sizeof(time_t) * spostati);
+    memcpy(destro->fine, &sinistro->fine[meta], sizeof(time_t) * spostati);
+    memcpy(destro->prenotazione, &sinistro->prenotazione[meta], sizeof(Prenotazione) * spostati);
+    destro->n = spostati;
+    sinistro->n = meta;
+
+    aggiorna_voce(albero, b);
+    aggiorna_voce(albero, b + 1);
+    return 1;
+}
+
+/*
+ * Funzione: crea_prenotazioni
+ * ---------------------------
+ * Crea e inizializza una nuova struttura `Prenotazioni` vuota.
+ *
+ * Implementazione:
+ *    Alloca la sola struttura: l'indice viene allocato e i blocchi vengono
+ *    prelevati dal pool condiviso al primo inserimento.
+ *
+ * Parametri:
+ *    Nessuno
+ *
+ * Pre-condizioni:
+ *    Nessuna
+ *
+ * Post-condizioni:
+ *    Restituisce un puntatore a una nuova struttura `Prenotazioni` inizializzata
+ *    se l'allocazione ha successo, NULL altrimenti.
+ *
+ * Ritorna:
+ *    un puntatore alla struttura prenotazioni
+ *
+ * Side-effect:
+ *    Alloca memoria dinamicamente; va liberata con `distruggi_prenotazioni`.
+ */
+Prenotazioni crea_prenotazioni() {
+    Prenotazioni albero = malloc(sizeof(struct albero));
+    if (!albero) return NULL;
+
+    albero->indice = NULL;
+    albero->num_blocchi = 0;
+    albero->capacita_indice = 0;
+    albero->num_nodi = 0;
+    albero->osservatore = NULL;
+    albero->contesto_osservatore = NULL;
+    inizializza_occupazione(&albero->occupazione, time(NULL));
+    return albero;
+}
+
+/*
+ * Funzione: crea_prenotazioni_da_vettore
+ * --------------------------------------
+ * Costruisce una struttura `Prenotazioni` a partire da un vettore di prenotazioni
+ * già ordinato per data di inizio e privo di sovrapposizioni.
+ *
+ * Implementazione:
+ *    - Verifica in un unico passaggio che il vettore non contenga NULL e sia ordinato e
+ *    senza sovrapposizioni.
+ *    - Riempie i blocchi in sequenza con `RIEMPIMENTO_INIZIALE` elementi ciascuno,
+ *    lasciando spazio per inserimenti successivi senza divisioni immediate,
+ *    e segna le prenotazioni nella mappa di occupazione. Il costo è O(n).
+ *
+ * Parametri:
+ *    vettore: il vettore ordinato di prenotazioni.
+ *    n: il numero di prenotazioni nel vettore.
+ *
+ * Pre-condizioni:
+ *    vettore: non deve essere NULL se `n` è maggiore di 0.
+ *
+ * Post-condizioni:
+ *    Restituisce una nuova struttura che contiene tutte le prenotazioni del vettore,
+ *    oppure NULL se il vettore contiene NULL, non è ordinato, contiene sovrapposizioni o
+ *    un'allocazione fallisce. In caso di errore le prenotazioni restano del chiamante.
+ *
+ * Ritorna:
+ *    un puntatore alla struttura prenotazioni o NULL
+ *
+ * Side-effect:
+ *    In caso di successo la struttura diventa proprietaria delle prenotazioni del vettore.
+ */
+Prenotazioni crea_prenotazioni_da_vettore(Prenotazione *vettore, unsigned int n) {
+    if (n > 0 && !vettore) return NULL;
+
+    unsigned int i;
+    for (i = 0; i < n; i++) {
+        if (!vettore[i]) return NULL;
+    }
+    for (i = 1; i < n; i++) {
+        Intervallo precedente = ottieni_intervallo_prenotazione(vettore[i - 1]);
+        Intervallo corrente = ottieni_intervallo_prenotazione(vettore[i]);
+        if (fine_intervallo(precedente) > inizio_intervallo(corrente))
+            return NULL;
+    }
+
+    Prenotazioni albero = crea_prenotazioni();
+    if (!albero) return NULL;
+
+    if (!riserva_indice(albero, (n + RIEMPIMENTO_INIZIALE - 1) / RIEMPIMENTO_INIZIALE)) {
+        free(albero);
+        return NULL;
+    }
+
+    struct blocco *blocco = NULL;
+    for (i = 0; i < n; i++) {
+        if (!blocco || blocco->n == RIEMPIMENTO_INIZIALE) {
+            blocco = nuovo_blocco(albero, albero->num_blocchi);
+            if (!blocco) {
+                // Le prenotazioni restano del chiamante: si liberano solo indice e blocchi
+                while (albero->num_blocchi > 0) rimuovi_blocco(albero, albero->num_blocchi - 1);
+                free(albero->indice);
+                free(albero);
+                return NULL;
+            }
+        }
+        Intervallo iv = ottieni_intervallo_prenotazione(vettore[i]);
+        blocco->inizio[blocco->n] = inizio_intervallo(iv);
+        blocco->fine[blocco->n] = fine_intervallo(iv);
+        blocco->prenotazione[blocco->n] = vettore[i];
+        blocco->n++;
+        aggiorna_voce(albero, albero->num_blocchi - 1);
+        segna_occupazione(&albero->occupazione, inizio_intervallo(iv), fine_intervallo(iv));
+    }
+
+    albero->num_nodi = n;
+    return albero;
+}
+
+/*
+ * Funzione: distruggi_prenotazioni
+ * --------------------------------
+ * Dealloca la struttura, tutte le prenotazioni che contiene e i blocchi.
+ *
+ * Implementazione:
+ *    Distrugge le prenotazioni blocco per blocco restituendo ogni blocco al
+ *    pool condiviso, poi libera l'indice e la struttura.
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da distruggere.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL (nessuna operazione)
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    Libera tutta la memoria associata alla struttura.
+ */
+void distruggi_prenotazioni(Prenotazioni prenotazioni) {
+    if (!prenotazioni) return;
+
+    unsigned int b, i;
+    for (b = 0; b < prenotazioni->num_blocchi; b++) {
+        struct blocco *blocco = prenotazioni->indice[b].blocco;
+        for (i = 0; i < blocco->n; i++) distruggi_prenotazione(blocco->prenotazione[i]);
+        rilascia_in_pool(pool_blocchi, blocco);
+    }
+
+    free(prenotazioni->indice);
+    free(prenotazioni);
+}
+
+/*
+ * Funzione: aggiungi_prenotazione
+ * -------------------------------
+ * Aggiunge una nuova prenotazione se non si sovrappone a quelle esistenti.
+ *
+ * Implementazione:
+ *    - Controlla la sovrapposizione con la mappa di occupazione e, se non basta,
+ *    con `sovrapposizione`.
+ *    - Sceglie con una ricerca binaria sull'indice il primo blocco il cui ultimo
+ *    elemento segue la nuova prenotazione (o l'ultimo blocco).
+ *    - Se il blocco è pieno lo divide a metà e sceglie la metà corretta.
+ *    - Sposta in avanti gli elementi successivi del blocco e inserisce la prenotazione.
+ *    - Aggiorna la mappa di occupazione e avvisa l'eventuale osservatore.
+ *
+ * Parametri:
+ *    albero: la struttura a cui aggiungere la prenotazione.
+ *    prenotazione: la prenotazione da aggiungere.
+ *
+ * Pre-condizioni:
+ *    albero: non deve essere NULL.
+ *    prenotazione: non deve essere NULL.
+ *
+ * Post-condizioni:
+ *    Restituisce `OK` se l'inserimento è avvenuto, `OCCUPATO` se la prenotazione si
+ *    sovrappone con una esistente o in caso di errore di allocazione (struttura invariata).
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(0 o 1)
+ *
+ * Side-effect:
+ *    In caso di successo la struttura diventa proprietaria della prenotazione.
+ *    Può allocare un nuovo blocco o ingrandire l'indice.
+ */
+Byte aggiungi_prenotazione(Prenotazioni albero, Prenotazione prenotazione) {
+    if (!albero || !prenotazione) return 0;
+
+    Intervallo iv = ottieni_intervallo_prenotazione(prenotazione);
+    time_t inizio = inizio_intervallo(iv);
+    time_t fine = fine_intervallo(iv);
+
+    Byte libero = esito_occupazione(&albero->occupazione, inizio, fine);
+    if (libero == OCCUPATO || (libero == INCERTO && sovrapposizione(albero, inizio, fine))) return OCCUPATO;
+
+    unsigned int b;
+    if (albero->num_blocchi == 0) {
+        if (!nuovo_blocco(albero, 0)) return OCCUPATO;
+        b = 0;
+    } else {
+        // Primo blocco il cui ultimo elemento segue la nuova prenotazione, altrimenti l'ultimo
+        unsigned int sinistra = 0, destra = albero->num_blocchi;
+        while (sinistra < destra) {
+            unsigned int centro = sinistra + (destra - sinistra) / 2;
+            struct voce *v = &albero->indice[centro];
+            if (inizio < v->ultimo_inizio) destra = centro;
+            else sinistra = centro + 1;
+        }
+        b = sinistra < albero->num_blocchi ? sinistra : albero->num_blocchi - 1;
+    }
+
+    struct blocco *blocco = albero->indice[b].blocco;
+    if (blocco->n == CAPACITA_BLOCCO) {
+        if (!dividi_blocco(albero, b)) return OCCUPATO;
+        blocco = albero->indice[b].blocco;
+        if (inizio > albero->indice[b].ultimo_inizio) {
+            b++;
+            blocco = albero->indice[b].blocco;
+        }
+    }
+
+    unsigned int i = 0;
+    while (i < blocco->n && blocco->inizio[i] < inizio) i++;
+
+    unsigned int spostati = blocco->n - i;
+    memmove(&blocco->inizio[i + 1], &blocco->inizio[i], sizeof(time_t) * spostati);
+    memmove(&blocco->fine[i + 1], &blocco->fine[i], sizeof(time_t) * spostati);
+    memmove(&blocco->prenotazione[i + 1], &blocco->prenotazione[i], sizeof(Prenotazione) * spostati);
+    blocco->inizio[i] = inizio;
+    blocco->fine[i] = fine;
+    blocco->prenotazione[i] = prenotazione;
+    blocco->n++;
+
+    aggiorna_voce(albero, b);
+    albero->num_nodi++;
+    aggiorna_orizzonte_occupazione(&albero->occupazione, albero, time(NULL));
+    segna_occupazione(&albero->occupazione, inizio, fine);
+    if (albero->osservatore) albero->osservatore(inizio, fine, 1, albero->contesto_osservatore);
+    return OK;
+}
+
+/*
+ * Funzione: controlla_prenotazione
+ * --------------------------------
+ * Verifica se un intervallo di tempo è libero.
+ *
+ * Implementazione:
+ *    Se l'intervallo cade nell'orizzonte della mappa di occupazione di solito
+ *    bastano pochi bit; altrimenti delega a `sovrapposizione`: una ricerca
+ *    binaria sull'indice e la scansione di un solo blocco.
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da interrogare.
+ *    i: l'intervallo di tempo da verificare.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: non deve essere NULL
+ *    i: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    Restituisce `OCCUPATO` se `i` si sovrappone con almeno una prenotazione, `OK` altrimenti.
+ *    Restituisce `OK` se `prenotazioni` o `i` sono NULL.
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(0 o 1)
+ */
+Byte controlla_prenotazione(Prenotazioni prenotazioni, Intervallo i) {
+    if (!prenotazioni || !i) return OK;
+
+    time_t inizio = inizio_intervallo(i);
+    time_t fine = fine_intervallo(i);
+    Byte esito = esito_occupazione(&prenotazioni->occupazione, inizio, fine);
+    if (esito != INCERTO) return esito;
+    return sovrapposizione(prenotazioni, inizio, fine) ? OCCUPATO : OK;
+}
+
+/*
+ * Funzione: cancella_prenotazione
+ * ------------------------------
+ * Rimuove la prenotazione che inizia nello stesso istante dell'intervallo `i`.
+ *
+ * Implementazione:
+ *    - Individua la prima prenotazione con inizio maggiore o uguale a quello di `i`.
+ *    - Se l'inizio coincide la distrugge e compatta il blocco; un blocco rimasto
+ *    vuoto viene tolto dall'indice.
+ *    - Aggiorna la mappa di occupazione e avvisa l'eventuale osservatore con gli
+ *    estremi della prenotazione rimossa.
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da cui rimuovere la prenotazione.
+ *    i: l'intervallo di tempo della prenotazione da rimuovere.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: non deve essere NULL
+ *    i: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    Restituisce 1 se la prenotazione è stata trovata e rimossa, 0 altrimenti.
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(0 o 1)
+ *
+ * Side-effect:
+ *    Dealloca la prenotazione rimossa.
+ */
+Byte cancella_prenotazione(Prenotazioni prenotazioni, Intervallo i) {
+    if (!prenotazioni || !i) return 0;
+
+    time_t inizio = inizio_intervallo(i);
+
+    unsigned int sinistra = 0, destra = prenotazioni->num_blocchi;
+    while (sinistra < destra) {
+        unsigned int centro = sinistra + (destra - sinistra) / 2;
+        if (prenotazioni->indice[centro].ultimo_inizio >= inizio) destra = centro;
+        else sinistra = centro + 1;
+    }
+    if (sinistra >= prenotazioni->num_blocchi) return 0;
+
+    unsigned int b = sinistra;
+    struct blocco *blocco = prenotazioni->indice[b].blocco;
+    unsigned int k = 0;
+    while (blocco->inizio[k] < inizio) k++;
+    if (blocco->inizio[k] != inizio) return 0;
+
+    time_t fine = blocco->fine[k];
+    distruggi_prenotazione(blocco->prenotazione[k]);
+
+    unsigned int spostati = blocco->n - k - 1;
+    memmove(&blocco->inizio[k], &blocco->inizio[k + 1], sizeof(time_t) * spostati);
+    memmove(&blocco->fine[k], &blocco->fine[k + 1], sizeof(time_t) * spostati);
+    memmove(&blocco->prenotazione[k], &blocco->prenotazione[k + 1], sizeof(Prenotazione) * spostati);
+    blocco->n--;
+
+    if (blocco->n == 0) rimuovi_blocco(prenotazioni, b);
+    else aggiorna_voce(prenotazioni, b);
+
+    prenotazioni->num_nodi--;
+    libera_occupazione(&prenotazioni->occupazione, prenotazioni, inizio, fine);
+    if (prenotazioni->osservatore) prenotazioni->osservatore(inizio, fine, 0, prenotazioni->contesto_osservatore);
+    return 1;
+}
+
+/*
+ * Funzione: ottieni_vettore_prenotazioni_ordinate
+ * -----------------------------------------------
+ * Restituisce un vettore con un riferimento condiviso a ogni prenotazione, in ordine di inizio.
+ *
+ * Implementazione:
+ *    Scorre i blocchi in ordine condividendo ogni prenotazione (`condividi_prenotazione`).
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da cui estrarre le prenotazioni.
+ *    size: puntatore in cui salvare la dimensione del vettore.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: non deve essere NULL.
+ *    size: non deve essere NULL.
+ *
+ * Post-condizioni:
+ *    Restituisce il vettore allocato dinamicamente, NULL in caso di errore.
+ *
+ * Ritorna:
+ *    un puntatore a un array di `Prenotazione` o NULL
+ *
+ * Side-effect:
+ *    Alloca il vettore; il chiamante lo libera dopo aver rilasciato ogni prenotazione
+ *    con `distruggi_prenotazione`.
+ */
+Prenotazione *ottieni_vettore_prenotazioni_ordinate(Prenotazioni prenotazioni, unsigned int *size) {
+    if (!prenotazioni || !size) return NULL;
+
+    Prenotazione *result = malloc(sizeof(Prenotazione) * prenotazioni->num_nodi);
+    if (!result) return NULL;
+
+    unsigned int b, i, k = 0;
+    for (b = 0; b < prenotazioni->num_blocchi; b++) {
+        struct blocco *blocco = prenotazioni->indice[b].blocco;
+        for (i = 0; i < blocco->n; i++) result[k++] = condividi_prenotazione(blocco->prenotazione[i]);
+    }
+
+    *size = k;
+    return result;
+}
+
+/*
+ * Funzione: ottieni_vettore_prenotazioni_per_file
+ * -----------------------------------------------
+ * Restituisce un vettore con un riferimento condiviso a ogni prenotazione, nell'ordine di salvataggio.
+ *
+ * Implementazione:
+ *    Questa struttura non ha livelli: l'ordine di salvataggio è quello di inizio,
+ *    che permette a `crea_prenotazioni_da_vettore` di ricostruirla in tempo lineare.
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da cui estrarre le prenotazioni.
+ *    size: puntatore in cui salvare la dimensione del vettore.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: non deve essere NULL
+ *    size: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    Restituisce il vettore allocato dinamicamente, NULL in caso di errore.
+ *
+ * Ritorna:
+ *    un puntatore a un array di `Prenotazione` o NULL
+ *
+ * Side-effect:
+ *    Alloca il vettore; il chiamante lo libera dopo aver rilasciato ogni prenotazione
+ *    con `distruggi_prenotazione`.
+ */
+Prenotazione *ottieni_vettore_prenotazioni_per_file(Prenotazioni prenotazioni, unsigned int *size) {
+    return ottieni_vettore_prenotazioni_ordinate(prenotazioni, size);
+}
+
+/*
+ * Funzione: dimensione_prenotazioni
+ * ---------------------------------
+ * Restituisce il numero di prenotazioni contenute nella struttura.
+ *
+ * Implementazione:
+ *    Restituisce il contatore `num_nodi`.
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da interrogare.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL
+ *
+ * Post-condizioni:
+ *    Restituisce il numero di prenotazioni, 0 se `prenotazioni` è NULL.
+ *
+ * Ritorna:
+ *    un intero senza segno
+ */
+unsigned int dimensione_prenotazioni(Prenotazioni prenotazioni) {
+    if (!prenotazioni) return 0;
+    return prenotazioni->num_nodi;
+}
+
+/*
+ * Funzione: visita_prenotazioni_in_ordine
+ * ---------------------------------------
+ * Chiama `visita` su tutte le prenotazioni in ordine di inizio, senza copiarle.
+ *
+ * Implementazione:
+ *    Scorre sequenzialmente i blocchi nell'ordine dell'indice.
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da visitare.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL (nessuna operazione)
+ *    visita: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    Nessuna allocazione di memoria; gli effetti sono quelli di `visita`.
+ */
+void visita_prenotazioni_in_ordine(Prenotazioni prenotazioni, VisitatorePrenotazioni visita, void *contesto) {
+    if (!prenotazioni || !visita) return;
+
+    unsigned int b, i;
+    for (b = 0; b < prenotazioni->num_blocchi; b++) {
+        struct blocco *blocco = prenotazioni->indice[b].blocco;
+        for (i = 0; i < blocco->n; i++) visita(blocco->prenotazione[i], contesto);
+    }
+}
+
+/*
+ * Funzione: visita_prenotazioni_per_livello
+ * -----------------------------------------
+ * Chiama `visita` su tutte le prenotazioni nell'ordine di salvataggio, senza copiarle.
+ *
+ * Implementazione:
+ *    Come `ottieni_vettore_prenotazioni_per_file`, l'ordine è quello di inizio.
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da visitare.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL (nessuna operazione)
+ *    visita: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    Nessuna allocazione di memoria; gli effetti sono quelli di `visita`.
+ */
+void visita_prenotazioni_per_livello(Prenotazioni prenotazioni, VisitatorePrenotazioni visita, void *contesto) {
+    visita_prenotazioni_in_ordine(prenotazioni, visita, contesto);
+}
+
+/*
+ * Funzione: visita_prenotazioni_in_intervallo
+ * -------------------------------------------
+ * Chiama `visita`, in ordine di inizio, sulle prenotazioni che si sovrappongono a [da, a).
+ *
+ * Implementazione:
+ *    Parte dalla prima prenotazione che termina dopo `da` e scorre i blocchi
+ *    finché le prenotazioni iniziano prima di `a`.
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da visitare.
+ *    da: inizio dell'intervallo di interesse.
+ *    a: fine dell'intervallo di interesse.
+ *    visita: la funzione da chiamare per ogni prenotazione.
+ *    contesto: puntatore passato invariato a `visita`.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL (nessuna operazione)
+ *    visita: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente; se `da >= a` non viene visitata nessuna prenotazione
+ *
+ * Side-effect:
+ *    Nessuna allocazione di memoria; gli effetti sono quelli di `visita`.
+ */
+void visita_prenotazioni_in_intervallo(Prenotazioni prenotazioni, time_t da, time_t a,
+                                       VisitatorePrenotazioni visita, void *contesto) {
+    if (!prenotazioni || !visita || da >= a) return;
+
+    unsigned int b, i;
+    if (!trova_prima_con_fine_oltre(prenotazioni, da, &b, &i)) return;
+
+    for (; b < prenotazioni->num_blocchi; b++, i = 0) {
+        struct blocco *blocco = prenotazioni->indice[b].blocco;
+        for (; i < blocco->n; i++) {
+            if (blocco->inizio[i] >= a) return;
+            visita(blocco->prenotazione[i], contesto);
+        }
+    }
+}
+
+/*
+ * Funzione: ottieni_intervallo_disponibile
+ * ----------------------------------------
+ * Restituisce la parte libera iniziale dell'intervallo `i`.
+ *
+ * Implementazione:
+ *    Trova la prima prenotazione che termina dopo l'inizio di `i`:
+ *    - se non esiste o inizia dopo la fine di `i`, l'intero intervallo è libero;
+ *    - se inizia dopo l'inizio di `i`, è libero il tratto fino al suo inizio;
+ *    - altrimenti l'inizio di `i` è occupato.
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da interrogare.
+ *    i: intervallo temporale da verificare.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: non deve essere NULL.
+ *    i: non deve essere NULL e deve essere un intervallo valido.
+ *
+ * Post-condizioni:
+ *    Restituisce un intervallo disponibile all'interno di `i` se trovato, NULL altrimenti.
+ *
+ * Ritorna:
+ *    un puntatore alla struttura intervallo o NULL
+ *
+ * Side-effect:
+ *    Alloca l'intervallo restituito; va liberato dal chiamante.
+ */
+Intervallo ottieni_intervallo_disponibile(Prenotazioni prenotazioni, Intervallo i) {
+    if (!prenotazioni || !i) return NULL;
+
+    time_t inizio = inizio_intervallo(i);
+    unsigned int b, k;
+    if (!trova_prima_con_fine_oltre(prenotazioni, inizio, &b, &k)) return duplica_intervallo(i);
+
+    time_t inizio_occupato = prenotazioni->indice[b].blocco->inizio[k];
+    if (inizio_occupato >= fine_intervallo(i)) return duplica_intervallo(i);
+    if (inizio_occupato > inizio) return crea_intervallo(inizio, inizio_occupato);
+    return NULL;
+}
+
+/*
+ * Funzione: ottieni_statistiche_prenotazioni
+ * ------------------------------------------
+ * Restituisce i contatori delle allocazioni dei blocchi.
+ *
+ * Implementazione:
+ *    Restituisce le statistiche del pool dei blocchi, condiviso da tutte le strutture:
+ *    i contatori non sono quelli della sola `prenotazioni`.
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da interrogare.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL
+ *
+ * Post-condizioni:
+ *    Restituisce le statistiche del pool condiviso dei blocchi, oppure contatori a zero
+ *    se `prenotazioni` è NULL.
+ *
+ * Ritorna:
+ *    una struttura StatistichePool
+ */
+StatistichePool ottieni_statistiche_prenotazioni(Prenotazioni prenotazioni) {
+    if (!prenotazioni) return ottieni_statistiche_pool(NULL);
+
+    return ottieni_statistiche_pool(pool_blocchi);
+}
+
+/*
+ * Funzione: imposta_osservatore_prenotazioni
+ * ------------------------------------------
+ * Registra la funzione da avvisare dopo ogni inserimento o cancellazione riuscita.
+ *
+ * Implementazione:
+ *    Salva funzione e contesto nella struttura; `aggiungi_prenotazione` e
+ *    `cancella_prenotazione` li usano solo quando la modifica è avvenuta.
+ *
+ * Parametri:
+ *    prenotazioni: la struttura da osservare.
+ *    osserva: la funzione da chiamare, NULL per rimuovere l'osservatore.
+ *    contesto: puntatore passato invariato a `osserva`.
+ *
+ * Pre-condizioni:
+ *    prenotazioni: può essere NULL (nessuna operazione)
+ *
+ * Post-condizioni:
+ *    non restituisce niente; un eventuale osservatore precedente viene sostituito
+ *
+ * Side-effect:
+ *    Nessuno; le prenotazioni già presenti non vengono notificate.
+ */
+void imposta_osservatore_prenotazioni(Prenotazioni prenotazioni, OsservatorePrenotazioni osserva, void *contesto) {
+    if (!prenotazioni) return;
+
+    prenotazioni->osservatore = osserva;
+    prenotazioni->contesto_osservatore = contesto;
+}
@@ -6,11 +6,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <limits.h>
 #include "strutture_dati/tabella_hash.h"
 #include "strutture_dati/lista.h"
-#include "utils/utils.h"
 
 #define PERCENTUALE_DI_RIEMPIMENTO 0.75
+#define BUCKET_PER_PASSO 4  // Bucket migrati ad ogni operazione durante un ridimensionamento
 
 static unsigned long djb2_hash(const char *str);
 
@@ -23,6 +24,9 @@ struct tabella_hash{
 	unsigned int grandezza;
 	Nodo *buckets;
 	unsigned int numero_buckets;
+	Nodo *vecchi_buckets;             // Bucket in migrazione, NULL se nessun ridimensionamento è in corso
+	unsigned int vecchia_grandezza;
+	unsigned int prossimo_da_migrare; // I vecchi bucket con indice minore sono già stati migrati
 };
 
 /*
@@ -67,8 +71,9 @@ static unsigned long djb2_hash(const char *str) {
  * crea una nuova tabella hash per la memorizzazione degli oggetti con la dimensione specificata
  *
  * Implementazione:
- *    Alloca memoria per una struttura TabellaHash e per un array di bucket.
- *    Ogni bucket è inizializzato come una nuova lista vuota creata con crea_lista().
+ *    Alloca memoria per una struttura TabellaHash e, con una sola calloc, per l'array
+ *    dei bucket: una lista vuota è un puntatore NULL (crea_lista), quindi i bucket
+ *    sono già vuoti e le pagine vengono toccate solo quando si riempiono.
  *
  * Parametri:
  *    grandezza: dimensione iniziale della tabella hash
@@ -96,6 +101,9 @@ TabellaHash nuova_tabella_hash(const unsigned int grandezza){
 
 	tabella_hash->numero_buckets = 0;
 	tabella_hash->grandezza = grandezza;
+	tabella_hash->vecchi_buckets = NULL;
+	tabella_hash->vecchia_grandezza = 0;
+	tabella_hash->prossimo_da_migrare = 0;
 	tabella_hash->buckets = calloc(grandezza, sizeof(Nodo));
 
 	if(tabella_hash->buckets == NULL){
@@ -103,14 +111,53 @@ TabellaHash nuova_tabella_hash(const unsigned int grandezza){
 		return NULL;
 	}
 
-	unsigned int i = 0;
-	for(i = 0; i < grandezza; i++){
-		tabella_hash->buckets[i] = crea_lista();
-	}
-
 	return tabella_hash;
 }
 
+/*
+ * Funzione: distruggi_buckets
+ * ---------------------------
+ *
+ * libera le liste di un intervallo di bucket, insieme alle chiavi e ai valori che contengono
+ *
+ * Implementazione:
+ *    Per ogni bucket con indice in [da, a) scorre la lista liberando ogni nodo,
+ *    l'item (che contiene anche la chiave) e il valore tramite funzione_distruggi_valore
+ *    se non è NULL.
+ *
+ * Parametri:
+ *    buckets: array di bucket
+ *    da: indice del primo bucket da liberare
+ *    a: indice successivo all'ultimo bucket da liberare
+ *    funzione_distruggi_valore: funzione da applicare ad ogni valore, può essere NULL
+ *
+ * Pre-condizioni:
+ *    buckets: non deve essere NULL e deve contenere almeno `a` bucket
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    libera la memoria dei nodi, delle chiavi e dei valori; l'array dei bucket non viene liberato
+ */
+static void distruggi_buckets(Nodo *buckets, unsigned int da, unsigned int a, void (*funzione_distruggi_valore)(void *)){
+	for(unsigned int i = da; i < a; i++){
+		Nodo curr = buckets[i];
+		while(!lista_vuota(curr)){
+		    Nodo temp = ottieni_prossimo(curr);
+			struct item *item = (struct item *)ottieni_item(curr);
+
+			if(item){
+				if(item->valore && funzione_distruggi_valore != NULL) funzione_distruggi_valore(item->valore);
+				free(item);
+			}
+
+			free(curr);
+			curr = temp;
+		}
+	}
+}
+
 /*
  * Funzione: distruggi_tabella
  * -----------------------------
@@ -118,9 +165,10 @@ TabellaHash nuova_tabella_hash(const unsigned int grandezza){
  * libera la memoria allocata per una tabella hash, inclusi tutti gli elementi memorizzati
  *
  * Implementazione:
- *    Scorre ogni bucket della tabella e distrugge la lista associata, liberando ogni nodo e il valore associato
- *    tramite la funzione funzione_distruggi_valore in caso essa non sia NULL.
- *    Poi libera l'array dei bucket e la struttura TabellaHash.
+ *    Scorre ogni bucket della tabella (e, se un ridimensionamento è in corso, ogni vecchio
+ *    bucket non ancora migrato) e distrugge la lista associata, liberando ogni nodo e il valore
+ *    associato tramite la funzione funzione_distruggi_valore in caso essa non sia NULL.
+ *    Poi libera gli array dei bucket e la struttura TabellaHash.
  *
  * Parametri:
  *    tabella_hash: puntatore alla tabella hash da eliminare
@@ -138,41 +186,148 @@ TabellaHash nuova_tabella_hash(const unsigned int grandezza){
 void distruggi_tabella(TabellaHash tabella_hash, void (*funzione_distruggi_valore)(void *)){
 	if(tabella_hash == NULL) return;
 
-    // Scorre tutti i bucket della tabella e libera ogni nodo e il relativo valore
-	for(unsigned int i = 0; i < tabella_hash->grandezza; i++){
-		Nodo curr = tabella_hash->buckets[i];
-		while(!lista_vuota(curr)){
-		    Nodo temp = ottieni_prossimo(curr);
-			struct item *item = (struct item *)ottieni_item(curr);
-			if(!item) continue;
+	distruggi_buckets(tabella_hash->buckets, 0, tabella_hash->grandezza, funzione_distruggi_valore);
+	if(tabella_hash->vecchi_buckets != NULL){
+		distruggi_buckets(tabella_hash->vecchi_buckets, tabella_hash->prossimo_da_migrare,
+		                  tabella_hash->vecchia_grandezza, funzione_distruggi_valore);
+		free(tabella_hash->vecchi_buckets);
+	}
 
-			if(item->chiave) free(item->chiave);
+	free(tabella_hash->buckets);
+	free(tabella_hash);
+}
 
-			if(item->valore) funzione_distruggi_valore(item->valore);
+/*
+ * Funzione: migra_bucket
+ * ----------------------
+ *
+ * sposta tutti gli elementi di un vecchio bucket nei bucket della nuova tabella.
+ *
+ * Implementazione:
+ *    Scorre la lista del vecchio bucket e ricollega ogni nodo in testa al nuovo bucket
+ *    calcolato con la nuova grandezza. I nodi non vengono riallocati, quindi la migrazione
+ *    non può fallire. Al termine il vecchio bucket resta vuoto.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash in ridimensionamento
+ *    indice: indice del vecchio bucket da migrare
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL e deve avere un ridimensionamento in corso
+ *    indice: deve essere minore di vecchia_grandezza
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    modifica le liste del vecchio bucket e dei nuovi bucket
+ */
+static void migra_bucket(TabellaHash tabella_hash, unsigned int indice){
+	Nodo curr = tabella_hash->vecchi_buckets[indice];
+	while(!lista_vuota(curr)){
+		Nodo next = ottieni_prossimo(curr);
+		struct item *item = (struct item *)ottieni_item(curr);
+		unsigned long nuovo_indice = djb2_hash(item->chiave) % tabella_hash->grandezza;
 
-			free(item);
-			free(curr);
-			curr = temp;
-		}
+		imposta_prossimo(curr, tabella_hash->buckets[nuovo_indice]);
+		tabella_hash->buckets[nuovo_indice] = curr;
+		curr = next;
 	}
+	tabella_hash->vecchi_buckets[indice] = crea_lista();
+}
 
-	free(tabella_hash->buckets);
-	free(tabella_hash);
+/*
+ * Funzione: migra_buckets
+ * -----------------------
+ *
+ * esegue un passo del ridimensionamento incrementale, migrando al più `massimo` vecchi bucket.
+ *
+ * Implementazione:
+ *    - Se non c'è un ridimensionamento in corso non fa nulla.
+ *    - Migra i vecchi bucket a partire da prossimo_da_migrare, fino a `massimo` bucket.
+ *    - Quando tutti i vecchi bucket sono stati migrati libera il vecchio array
+ *      e conclude il ridimensionamento.
+ *    Il lavoro svolto ad ogni chiamata è quindi limitato, indipendentemente
+ *    dal numero di elementi nella tabella.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    massimo: numero massimo di vecchi bucket da migrare
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    sposta elementi tra i bucket e può liberare il vecchio array dei bucket
+ */
+static void migra_buckets(TabellaHash tabella_hash, unsigned int massimo){
+	if(tabella_hash->vecchi_buckets == NULL) return;
+
+	unsigned int migrati = 0;
+	while(migrati < massimo && tabella_hash->prossimo_da_migrare < tabella_hash->vecchia_grandezza){
+		migra_bucket(tabella_hash, tabella_hash->prossimo_da_migrare);
+		tabella_hash->prossimo_da_migrare++;
+		migrati++;
+	}
+
+	if(tabella_hash->prossimo_da_migrare == tabella_hash->vecchia_grandezza){
+		free(tabella_hash->vecchi_buckets);
+		tabella_hash->vecchi_buckets = NULL;
+		tabella_hash->vecchia_grandezza = 0;
+		tabella_hash->prossimo_da_migrare = 0;
+	}
+}
+
+/*
+ * Funzione: bucket_di
+ * -------------------
+ *
+ * restituisce il bucket in cui si trova (o deve essere inserita) una chiave con l'hash dato.
+ *
+ * Implementazione:
+ *    Durante un ridimensionamento ogni chiave si trova in un solo posto: nel vecchio bucket
+ *    se questo non è ancora stato migrato, altrimenti nel nuovo. Gli inserimenti seguono la
+ *    stessa regola, quindi ricerca, inserimento e cancellazione consultano un solo bucket.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    hash: hash della chiave
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce il puntatore alla testa della lista del bucket
+ *
+ * Ritorna:
+ *    un puntatore ad un Nodo
+ */
+static Nodo *bucket_di(TabellaHash tabella_hash, unsigned long hash){
+	if(tabella_hash->vecchi_buckets != NULL){
+		unsigned long vecchio_indice = hash % tabella_hash->vecchia_grandezza;
+		if(vecchio_indice >= tabella_hash->prossimo_da_migrare){
+			return &tabella_hash->vecchi_buckets[vecchio_indice];
+		}
+	}
+	return &tabella_hash->buckets[hash % tabella_hash->grandezza];
 }
 
 /*
  * Funzione: ridimensiona_tabella_hash
  * -----------------------------------
  *
- * raddoppia la dimensione della tabella hash per ridurre i conflitti e migliorare le prestazioni.
+ * avvia il raddoppio della tabella hash per ridurre i conflitti e migliorare le prestazioni.
  *
  * Implementazione:
- *    - Calcola una nuova dimensione doppia rispetto all'attuale.
- *    - Alloca un nuovo array di bucket inizializzati come liste vuote.
- *    - Scorre tutti i bucket esistenti e reinserisce ogni elemento nella nuova posizione
- *      calcolata in base all'hash della chiave e alla nuova dimensione.
- *    - Dopo il reinserimento, libera i nodi della vecchia tabella (ma non i dati, che vengono mantenuti).
- *    - Sostituisce l'array di bucket e la dimensione nella struttura TabellaHash
+ *    - Se un ridimensionamento precedente non è ancora concluso, lo completa.
+ *    - Alloca con calloc un nuovo array di bucket di grandezza doppia, già vuoti.
+ *    - Non sposta subito gli elementi: il vecchio array viene conservato accanto al nuovo
+ *      e i suoi bucket vengono migrati pochi alla volta (BUCKET_PER_PASSO) ad ogni
+ *      inserimento, ricerca e cancellazione successivi, tramite migra_buckets.
+ *      In questo modo nessuna singola operazione paga il costo O(n) del rehash.
  *
  * Parametri:
  *    tabella_hash: puntatore alla struttura della tabella hash da ridimensionare
@@ -184,40 +339,66 @@ void distruggi_tabella(TabellaHash tabella_hash, void (*funzione_distruggi_valor
  *    non restituisce niente
  *
  * Side-effect:
- *    la tabella hash avrà il doppio della dimensione iniziale
- *    e conterrà tutti gli elementi precedenti nei nuovi bucket
+ *    la tabella hash avrà il doppio della dimensione iniziale; gli elementi
+ *    restano nel vecchio array finché non vengono migrati
  */
 static void ridimensiona_tabella_hash(TabellaHash tabella_hash){
+	// Un solo ridimensionamento alla volta: conclude quello in corso
+	migra_buckets(tabella_hash, tabella_hash->vecchia_grandezza);
+
     unsigned int nuova_grandezza = tabella_hash->grandezza * 2;
     Nodo *nuovi_buckets = calloc(nuova_grandezza, sizeof(Nodo));
 
     if (nuovi_buckets == NULL) return;
 
-    // Inizializza ogni nuovo bucket con una lista vuota
-    for (unsigned int j = 0; j < nuova_grandezza; j++) {
-        nuovi_buckets[j] = crea_lista();
-    }
-
-    // Reinserisce tutti gli elementi esistenti nei nuovi bucket calcolando il nuovo indice
-    for (unsigned int i = 0; i < tabella_hash->grandezza; i++) {
-        Nodo curr = tabella_hash->buckets[i];
-        while (!lista_vuota(curr)) {
-            struct item *item = (struct item *)ottieni_item(curr);
-            unsigned long nuovo_indice = djb2_hash(item->chiave) % nuova_grandezza;
-
-            nuovi_buckets[nuovo_indice] = aggiungi_nodo(item, nuovi_buckets[nuovo_indice]);
-
-            Nodo next = ottieni_prossimo(curr);
-            free(curr);  //distruggi solo nodo, non item
-            curr = next;
-        }
-    }
-
-    free(tabella_hash->buckets);
+    /* Non inizializza i bucket uno ad uno: calloc restituisce memoria azzerata e una lista
+     * vuota è un puntatore NULL (crea_lista), così anche l'avvio del ridimensionamento
+     * non costa O(n) e le pagine vengono toccate solo man mano che i bucket si riempiono
+     */
+    tabella_hash->vecchi_buckets = tabella_hash->buckets;
+    tabella_hash->vecchia_grandezza = tabella_hash->grandezza;
+    tabella_hash->prossimo_da_migrare = 0;
     tabella_hash->buckets = nuovi_buckets;
     tabella_hash->grandezza = nuova_grandezza;
 }
 
+/*
+ * Funzione: crea_item
+ * -------------------
+ *
+ * crea un item con una copia della chiave, allocando item e chiave in un solo blocco.
+ *
+ * Implementazione:
+ *    La chiave viene copiata subito dopo la struttura item, così ogni elemento costa
+ *    una sola allocazione e viene liberato con una sola free.
+ *
+ * Parametri:
+ *    chiave: stringa costante contenente la chiave
+ *    valore: puntatore al valore da associare alla chiave
+ *
+ * Pre-condizioni:
+ *    chiave: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce il nuovo item o NULL in caso di errore di allocazione
+ *
+ * Ritorna:
+ *    un puntatore a struct item o NULL
+ *
+ * Side-effect:
+ *    alloca memoria dinamicamente
+ */
+static struct item *crea_item(const char *chiave, void *valore){
+	size_t lunghezza = strlen(chiave) + 1;
+	struct item *item = malloc(sizeof(struct item) + lunghezza);
+	if(item == NULL) return NULL;
+
+	item->chiave = (char *)(item + 1);
+	memcpy(item->chiave, chiave, lunghezza);
+	item->valore = valore;
+	return item;
+}
+
 /*
  * Funzione: inserisci_in_tabella
  * ------------------------------------
@@ -225,11 +406,13 @@ static void ridimensiona_tabella_hash(TabellaHash tabella_hash){
  * inserisce un elemento nella tabella hash associando una chiave a un valore
  *
  * Implementazione:
- *    - Calcola la percentuale di riempimento e ridimensiona la tabella se necessario.
- *    - Calcola l'indice del bucket usando una funzione hash (djb2_hash).
+ *    - Calcola la percentuale di riempimento e avvia il ridimensionamento se necessario
+ *      (e se non ne è già in corso uno).
+ *    - Esegue un passo del ridimensionamento incrementale, se in corso.
+ *    - Individua il bucket usando una funzione hash (djb2_hash) e bucket_di.
  *    - Scorre la lista associata a quel bucket per verificare se la chiave è già presente.
  *    - Se la chiave è duplicata, l'inserimento viene annullato.
- *    - Altrimenti, crea una nuova struttura item, duplica la chiave, e la inserisce
+ *    - Altrimenti, crea un nuovo item con una copia della chiave (crea_item) e lo inserisce
  *      in testa alla lista del bucket.
  *    - Incrementa il numero di elementi della tabella.
  *
@@ -257,13 +440,13 @@ Byte inserisci_in_tabella(TabellaHash tabella_hash, const char *chiave, void *va
 
 	// Limita la percentuale di collisioni ad una percentuale minore del 100%
 	double percentuale = (double)tabella_hash->numero_buckets / (double)tabella_hash->grandezza;
-	if(percentuale > PERCENTUALE_DI_RIEMPIMENTO){
+	if(percentuale > PERCENTUALE_DI_RIEMPIMENTO && tabella_hash->vecchi_buckets == NULL){
 		ridimensiona_tabella_hash(tabella_hash);
 	}
+	migra_buckets(tabella_hash, BUCKET_PER_PASSO);
 
-	unsigned long indice = djb2_hash(chiave) % tabella_hash->grandezza;
-
-	Nodo lista = tabella_hash->buckets[indice];
+	Nodo *bucket = bucket_di(tabella_hash, djb2_hash(chiave));
+	Nodo lista = *bucket;
 	Nodo i;
 
     // Verifica se la chiave è già presente nella lista e se lo è restituisce 0
@@ -274,19 +457,118 @@ Byte inserisci_in_tabella(TabellaHash tabella_hash, const char *chiave, void *va
 		}
 	}
 
-	struct item *nuovo_item = malloc(sizeof(struct item));
+	struct item *nuovo_item = crea_item(chiave, valore);
 
 	if(nuovo_item == NULL){
 		return 0;
 	}
 
-	nuovo_item->chiave = mia_strdup(chiave); //alloca una nuova stringa chiave dentro alla chiave
-	nuovo_item->valore = valore;
-	tabella_hash->buckets[indice] = aggiungi_nodo(nuovo_item, lista);
+	*bucket = aggiungi_nodo(nuovo_item, lista);
 	tabella_hash->numero_buckets++;
 	return 1;
 }
 
+/*
+ * Funzione: prepara_grandezza
+ * ---------------------------
+ *
+ * porta la tabella alla grandezza necessaria per contenere `totale` elementi senza
+ * superare la percentuale di riempimento.
+ *
+ * Implementazione:
+ *    - Conclude l'eventuale ridimensionamento in corso.
+ *    - Se la grandezza attuale basta non fa altro; altrimenti alloca con una sola calloc
+ *      l'array dei bucket della grandezza finale e vi ricollega tutti i nodi presenti,
+ *      senza riallocarli.
+ *    Se l'allocazione fallisce la tabella resta invariata: gli inserimenti successivi
+ *    restano corretti, solo con liste più lunghe.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    totale: numero di elementi che la tabella dovrà contenere
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    può sostituire l'array dei bucket
+ */
+static void prepara_grandezza(TabellaHash tabella_hash, unsigned int totale){
+	migra_buckets(tabella_hash, tabella_hash->vecchia_grandezza);
+
+	unsigned long necessaria = (unsigned long)(totale / PERCENTUALE_DI_RIEMPIMENTO) + 1;
+	if(necessaria <= tabella_hash->grandezza || necessaria > UINT_MAX) return;
+
+	Nodo *nuovi_buckets = calloc(necessaria, sizeof(Nodo));
+	if(nuovi_buckets == NULL) return;
+
+	// Riusa migra_bucket: il vecchio array diventa temporaneamente quello in migrazione
+	tabella_hash->vecchi_buckets = tabella_hash->buckets;
+	tabella_hash->vecchia_grandezza = tabella_hash->grandezza;
+	tabella_hash->prossimo_da_migrare = 0;
+	tabella_hash->buckets = nuovi_buckets;
+	tabella_hash->grandezza = (unsigned int)necessaria;
+	migra_buckets(tabella_hash, tabella_hash->vecchia_grandezza);
+}
+
+/*
+ * Funzione: inserisci_in_blocco
+ * -----------------------------
+ *
+ * inserisce nella tabella un vettore di valori con chiavi tutte distinte, senza
+ * controllare i duplicati
+ *
+ * Implementazione:
+ *    - Porta la tabella alla grandezza finale con prepara_grandezza, così durante
+ *      il caricamento non parte nessun ridimensionamento.
+ *    - Per ogni valore non NULL crea l'item con crea_item e lo inserisce in testa
+ *      al bucket, senza scorrere la lista: l'unicità delle chiavi è garantita dal chiamante.
+ *    - Si ferma al primo errore di allocazione.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    valori: vettore dei valori da inserire, può contenere elementi NULL che vengono saltati
+ *    dimensione: numero di elementi del vettore
+ *    chiave_di: funzione che restituisce la chiave di un valore
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *    valori: non deve essere NULL
+ *    chiave_di: non deve essere NULL
+ *    le chiavi dei valori devono essere distinte tra loro e assenti dalla tabella
+ *
+ * Post-condizioni:
+ *    restituisce il numero di elementi di `valori` esaminati: i valori non NULL con
+ *    indice minore sono stati inseriti, gli altri no (dimensione se non ci sono errori)
+ *
+ * Ritorna:
+ *    un intero senza segno
+ *
+ * Side-effect:
+ *    modifica la tabella hash aggiungendo gli elementi e può sostituire l'array dei bucket
+ */
+unsigned int inserisci_in_blocco(TabellaHash tabella_hash, void **valori, unsigned int dimensione, const char *(*chiave_di)(const void *valore)){
+	if(tabella_hash == NULL || valori == NULL || chiave_di == NULL) return 0;
+
+	prepara_grandezza(tabella_hash, tabella_hash->numero_buckets + dimensione);
+
+	for(unsigned int i = 0; i < dimensione; i++){
+		if(valori[i] == NULL) continue;
+
+		const char *chiave = chiave_di(valori[i]);
+		struct item *nuovo_item = chiave != NULL ? crea_item(chiave, valori[i]) : NULL;
+		if(nuovo_item == NULL) return i;
+
+		Nodo *bucket = &tabella_hash->buckets[djb2_hash(chiave) % tabella_hash->grandezza];
+		*bucket = aggiungi_nodo(nuovo_item, *bucket);
+		tabella_hash->numero_buckets++;
+	}
+	return dimensione;
+}
+
 /*
  * Funzione: cancella_dalla_tabella
  * -----------------------------------
@@ -294,10 +576,11 @@ Byte inserisci_in_tabella(TabellaHash tabella_hash, const char *chiave, void *va
  * rimuove un oggetto dalla tabella hash utilizzando la chiave fornita
  *
  * Implementazione:
- *    - Calcola l'indice del bucket tramite la funzione hash.
+ *    - Esegue un passo del ridimensionamento incrementale, se in corso.
+ *    - Individua il bucket tramite la funzione hash e bucket_di.
  *    - Scorre la lista associata al bucket, confrontando ogni chiave.
  *    - Se trova la chiave, rimuove il nodo aggiornando il puntatore del nodo precedente.
- *    - Libera la memoria associata alla chiave e al valore tramite la funzione passata.
+ *    - Libera l'item, che contiene anche la chiave, e il valore tramite la funzione passata.
  *    - Aggiorna il conteggio degli elementi nella tabella.
  *    - Restituisce 1 in caso di successo, 0 se la chiave non è presente.
  *
@@ -324,8 +607,9 @@ Byte inserisci_in_tabella(TabellaHash tabella_hash, const char *chiave, void *va
 Byte cancella_dalla_tabella(TabellaHash tabella_hash, const char *chiave, void (*funzione_distruggi_valore)(void *)){
 	if(tabella_hash == NULL || chiave == NULL) return 0;
 
-	unsigned long indice = djb2_hash(chiave) % tabella_hash->grandezza;
-	Nodo *head = &tabella_hash->buckets[indice];
+	migra_buckets(tabella_hash, BUCKET_PER_PASSO);
+
+	Nodo *head = bucket_di(tabella_hash, djb2_hash(chiave));
 	Nodo curr = *head;
 	Nodo prec = NULL;
 
@@ -341,7 +625,6 @@ Byte cancella_dalla_tabella(TabellaHash tabella_hash, const char *chiave, void (
             else{
 				*head = ottieni_prossimo(curr);
 			}
-			free(item->chiave);
 			if(funzione_distruggi_valore != NULL) funzione_distruggi_valore(item->valore);
 			free(item);
 			free(curr);
@@ -361,7 +644,8 @@ Byte cancella_dalla_tabella(TabellaHash tabella_hash, const char *chiave, void (
  * cerca un elemento nella tabella hash tramite la chiave specificata
  *
  * Implementazione:
- *    - Calcola l'indice del bucket associato alla chiave usando la funzione di hash.
+ *    - Esegue un passo del ridimensionamento incrementale, se in corso.
+ *    - Individua il bucket associato alla chiave usando la funzione di hash e bucket_di.
  *    - Scorre la lista collegata a quel bucket.
  *    - Confronta ciascuna chiave con quella cercata.
  *    - Se trova la chiave, restituisce il valore associato.
@@ -385,8 +669,9 @@ Byte cancella_dalla_tabella(TabellaHash tabella_hash, const char *chiave, void (
 const void *cerca_in_tabella(const TabellaHash tabella_hash, const char *chiave){
 	if(tabella_hash == NULL || chiave == NULL) return NULL;
 
-	unsigned long indice = djb2_hash(chiave) % tabella_hash->grandezza;
-	Nodo curr = tabella_hash->buckets[indice];
+	migra_buckets(tabella_hash, BUCKET_PER_PASSO);
+
+	Nodo curr = *bucket_di(tabella_hash, djb2_hash(chiave));
 
     // Scorre la lista del bucket alla ricerca dell'item con la chiave corrispondente
 	while(!lista_vuota(curr)){
@@ -407,7 +692,8 @@ const void *cerca_in_tabella(const TabellaHash tabella_hash, const char *chiave)
  *
  * Implementazione:
  *    - Alloca un array di puntatori void* con dimensione pari al numero di elementi presenti.
- *    - Scorre ogni bucket della tabella hash.
+ *    - Scorre ogni bucket della tabella hash e, se un ridimensionamento è in corso,
+ *      ogni vecchio bucket non ancora migrato.
  *    - Per ogni nodo nella lista del bucket, estrae il valore e lo inserisce nel vettore.
  *    - Al termine, assegna al parametro dimensione il numero di elementi raccolti.
  *    - Restituisce il puntatore al vettore popolato.
@@ -450,6 +736,156 @@ void **ottieni_vettore(const TabellaHash tabella_hash, unsigned int *dimensione)
         }
     }
 
+    // Durante un ridimensionamento, raccoglie anche i vecchi bucket non ancora migrati
+    if(tabella_hash->vecchi_buckets != NULL){
+        for(unsigned int i = tabella_hash->prossimo_da_migrare; i < tabella_hash->vecchia_grandezza && n < tabella_hash->numero_buckets; i++){
+            Nodo curr = tabella_hash->vecchi_buckets[i];
+            while(!lista_vuota(curr) && n < tabella_hash->numero_buckets){
+                struct item *item = (struct item *)ottieni_item(curr);
+                vettore[n++] = item->valore;
+                curr = ottieni_prossimo(curr);
+            }
+        }
+    }
+
     *dimensione = n;
     return vettore;
 }
+
+/*
+ * Funzione: dimensione_tabella
+ * ----------------------------
+ *
+ * restituisce il numero di elementi contenuti nella tabella hash
+ *
+ * Implementazione:
+ *    Restituisce il contatore numero_buckets, aggiornato da inserimenti e cancellazioni.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *
+ * Pre-condizioni:
+ *    tabella_hash: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce il numero di elementi, oppure 0 se `tabella_hash` è NULL
+ *
+ * Ritorna:
+ *    un intero senza segno
+ */
+unsigned int dimensione_tabella(const TabellaHash tabella_hash){
+    if(tabella_hash == NULL) return 0;
+    return tabella_hash->numero_buckets;
+}
+
+/*
+ * Funzione: tabella_iter_init
+ * ---------------------------
+ *
+ * prepara un iteratore per visitare tutti i valori della tabella hash, senza allocare memoria
+ *
+ * Implementazione:
+ *    - Completa l'eventuale ridimensionamento in corso: la visita costa comunque O(n)
+ *      e, con un solo array di bucket, le ricerche fatte durante la visita non
+ *      spostano più i nodi sotto l'iteratore.
+ *    - Posiziona l'iteratore prima del primo bucket.
+ *
+ * Parametri:
+ *    iteratore: puntatore all'iteratore da inizializzare
+ *    tabella_hash: puntatore alla tabella hash da visitare
+ *
+ * Pre-condizioni:
+ *    iteratore: non deve essere NULL
+ *    tabella_hash: può essere NULL (la visita è vuota)
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    può completare un ridimensionamento incrementale
+ */
+void tabella_iter_init(IteratoreTabella *iteratore, TabellaHash tabella_hash){
+    if(iteratore == NULL) return;
+
+    if(tabella_hash != NULL) migra_buckets(tabella_hash, tabella_hash->vecchia_grandezza);
+
+    iteratore->tabella = tabella_hash;
+    iteratore->indice = 0;
+    iteratore->prossimo = NULL;
+}
+
+/*
+ * Funzione: tabella_iter_next
+ * ---------------------------
+ *
+ * restituisce il prossimo valore della visita iniziata con tabella_iter_init
+ *
+ * Implementazione:
+ *    Se il bucket corrente ha ancora nodi, restituisce il valore del prossimo nodo;
+ *    altrimenti avanza fino al primo bucket non vuoto. Il campo `prossimo`
+ *    dell'iteratore conserva il nodo da cui riprendere, `indice` il bucket successivo.
+ *
+ * Parametri:
+ *    iteratore: puntatore all'iteratore
+ *
+ * Pre-condizioni:
+ *    iteratore: non deve essere NULL e deve essere stato inizializzato con tabella_iter_init
+ *
+ * Post-condizioni:
+ *    restituisce il prossimo valore, oppure NULL quando tutti i valori sono stati visitati
+ *
+ * Ritorna:
+ *    un puntatore generico o NULL
+ *
+ * Side-effect:
+ *    avanza l'iteratore
+ */
+void *tabella_iter_next(IteratoreTabella *iteratore){
+    if(iteratore == NULL || iteratore->tabella == NULL) return NULL;
+
+    Nodo curr = (Nodo)iteratore->prossimo;
+    while(lista_vuota(curr)){
+        if(iteratore->indice >= iteratore->tabella->grandezza) return NULL;
+        curr = iteratore->tabella->buckets[iteratore->indice++];
+    }
+
+    struct item *item = (struct item *)ottieni_item(curr);
+    iteratore->prossimo = ottieni_prossimo(curr);
+    return item->valore;
+}
+
+/*
+ * Funzione: tabella_per_ogni
+ * --------------------------
+ *
+ * applica una funzione a tutti i valori della tabella hash, senza allocare memoria
+ *
+ * Implementazione:
+ *    Visita la tabella con un IteratoreTabella e chiama `funzione` su ogni valore.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    funzione: funzione da chiamare per ogni valore; riceve il valore e `contesto`
+ *    contesto: puntatore passato invariato ad ogni chiamata di `funzione`, può essere NULL
+ *
+ * Pre-condizioni:
+ *    tabella_hash: può essere NULL (nessuna operazione)
+ *    funzione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    quelli di `funzione`
+ */
+void tabella_per_ogni(TabellaHash tabella_hash, void (*funzione)(void *valore, void *contesto), void *contesto){
+    if(tabella_hash == NULL || funzione == NULL) return;
+
+    IteratoreTabella iteratore;
+    void *valore;
+
+    tabella_iter_init(&iteratore, tabella_hash);
+    while((valore = tabella_iter_next(&iteratore)) != NULL){
+        funzione(valore, contesto);
+    }
+}
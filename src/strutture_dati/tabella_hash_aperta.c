@@ -0,0 +1,860 @@
+/*
+ * Implementazione della TabellaHash ad indirizzamento aperto con scansione lineare.
+ * Le voci sono memorizzate in un unico vettore di slot allineati alla linea di cache:
+ * ogni slot contiene l'hash già calcolato della chiave, il valore e, se abbastanza
+ * corta, la chiave stessa. Una ricerca tocca quindi, nel caso tipico, una o due
+ * linee di cache e non ricalcola mai l'hash delle chiavi già inserite.
+ *
+ * Espone la stessa interfaccia di `tabella_hash.c` (liste di trabocco):
+ * il motore da collegare si sceglie nel Makefile.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include "strutture_dati/tabella_hash.h"
+#include "utils/utils.h"
+
+#define PERCENTUALE_DI_RIEMPIMENTO 0.75
+#define CAPACITA_MINIMA 8
+#define LUNGHEZZA_CHIAVE_BREVE 40   // Chiavi fino a 39 caratteri sono memorizzate nello slot
+#define LINEA_DI_CACHE 64
+
+/*
+ * Uno slot occupa esattamente una linea di cache (sui sistemi a 64 bit).
+ * Uno slot è libero quando `valore` è NULL: l'interfaccia non permette
+ * di inserire valori NULL, quindi non servono altri marcatori.
+ */
+struct slot {
+    unsigned long hash;         // Hash della chiave, calcolato una sola volta
+    void *valore;
+    union {
+        char breve[LUNGHEZZA_CHIAVE_BREVE];
+        char *lunga;
+    } chiave;
+    unsigned char chiave_lunga; // 1 se la chiave è allocata fuori dallo slot
+};
+
+struct tabella_hash {
+    struct slot *slot;          // Vettore degli slot, allineato alla linea di cache
+    void *memoria;              // Puntatore restituito da calloc, da passare a free
+    unsigned int capacita;      // Numero di slot, sempre una potenza di 2
+    unsigned int numero_elementi;
+};
+
+static unsigned long djb2_hash(const char *str);
+
+/*
+ * Funzione: djb2_hash
+ * -------------------
+ *
+ * Calcola un valore hash per una stringa usando l'algoritmo DJB2.
+ *
+ * Implementazione:
+ *    - Inizializza il valore di hash a 5381.
+ *    - Per ogni carattere della stringa moltiplica l'hash per 33 e aggiunge il carattere.
+ *
+ * Parametri:
+ *    str: stringa costante di input di cui calcolare l'hash
+ *
+ * Pre-condizioni:
+ *    str: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce un numero che rappresenta il valore hash della stringa
+ *
+ * Ritorna:
+ *    un intero non negativo
+ */
+static unsigned long djb2_hash(const char *str) {
+    unsigned long hash = 5381;
+    int c;
+    while ((c = *str++)) {
+        hash = ((hash << 5) + hash) + c;
+    }
+    return hash;
+}
+
+/*
+ * Funzione: indice_ideale
+ * -----------------------
+ *
+ * Calcola lo slot in cui una chiave con l'hash dato dovrebbe trovarsi.
+ *
+ * Implementazione:
+ *    I bit bassi di DJB2 variano poco tra chiavi simili (es. targhe che differiscono
+ *    nell'ultimo carattere), quindi prima di applicare la maschera l'hash viene
+ *    rimescolato con alcuni passi di xor-shift e moltiplicazione.
+ *
+ * Parametri:
+ *    hash: hash della chiave
+ *    capacita: numero di slot della tabella (potenza di 2)
+ *
+ * Pre-condizioni:
+ *    capacita: deve essere una potenza di 2
+ *
+ * Post-condizioni:
+ *    restituisce un indice compreso tra 0 e capacita - 1
+ *
+ * Ritorna:
+ *    un intero senza segno
+ */
+static unsigned int indice_ideale(unsigned long hash, unsigned int capacita) {
+    uint32_t h = (uint32_t)(hash ^ (hash >> 16));
+    h ^= h >> 16;
+    h *= 0x45d9f3bU;
+    h ^= h >> 16;
+    return h & (capacita - 1);
+}
+
+/*
+ * Funzione: chiave_slot
+ * ---------------------
+ *
+ * Restituisce la chiave memorizzata in uno slot.
+ *
+ * Parametri:
+ *    s: slot occupato
+ *
+ * Pre-condizioni:
+ *    s: non deve essere NULL e deve essere occupato
+ *
+ * Ritorna:
+ *    un puntatore alla stringa della chiave
+ */
+static const char *chiave_slot(const struct slot *s) {
+    return s->chiave_lunga ? s->chiave.lunga : s->chiave.breve;
+}
+
+/*
+ * Funzione: alloca_slot
+ * ---------------------
+ *
+ * Alloca un vettore di slot vuoti allineato alla linea di cache.
+ *
+ * Implementazione:
+ *    Alloca con calloc una linea di cache in più del necessario e sposta il puntatore
+ *    in avanti fino al primo indirizzo multiplo di LINEA_DI_CACHE, così che ogni slot
+ *    occupi una sola linea. Il puntatore originale viene restituito in `memoria`.
+ *
+ * Parametri:
+ *    capacita: numero di slot da allocare
+ *    memoria: puntatore in cui salvare l'indirizzo da passare a free
+ *
+ * Pre-condizioni:
+ *    capacita: deve essere maggiore di 0
+ *    memoria: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce il vettore di slot azzerati, o NULL in caso di errore
+ *
+ * Ritorna:
+ *    un puntatore al primo slot o NULL
+ *
+ * Side-effect:
+ *    alloca memoria dinamicamente
+ */
+static struct slot *alloca_slot(unsigned int capacita, void **memoria) {
+    *memoria = calloc(1, (size_t)capacita * sizeof(struct slot) + LINEA_DI_CACHE);
+    if (*memoria == NULL) return NULL;
+
+    uintptr_t indirizzo = (uintptr_t)*memoria;
+    indirizzo = (indirizzo + LINEA_DI_CACHE - 1) & ~(uintptr_t)(LINEA_DI_CACHE - 1);
+    return (struct slot *)indirizzo;
+}
+
+/*
+ * Funzione: trova_slot
+ * --------------------
+ *
+ * Cerca lo slot che contiene la chiave data.
+ *
+ * Implementazione:
+ *    Parte dallo slot ideale e avanza linearmente finché non trova uno slot vuoto.
+ *    La stringa viene confrontata solo quando l'hash memorizzato coincide con quello
+ *    della chiave cercata, quindi le collisioni costano un confronto tra interi.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    chiave: chiave da cercare
+ *    hash: hash della chiave
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *    chiave: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce l'indice dello slot che contiene la chiave, oppure -1 se la chiave non è presente
+ *
+ * Ritorna:
+ *    un intero con segno
+ */
+static long trova_slot(const TabellaHash tabella_hash, const char *chiave, unsigned long hash) {
+    unsigned int maschera = tabella_hash->capacita - 1;
+    unsigned int i = indice_ideale(hash, tabella_hash->capacita);
+
+    while (tabella_hash->slot[i].valore != NULL) {
+        struct slot *s = &tabella_hash->slot[i];
+        if (s->hash == hash && strcmp(chiave_slot(s), chiave) == 0) {
+            return (long)i;
+        }
+        i = (i + 1) & maschera;
+    }
+    return -1;
+}
+
+/*
+ * Funzione: colloca_slot
+ * ----------------------
+ *
+ * Copia uno slot nella prima posizione libera a partire dal suo indice ideale.
+ *
+ * Implementazione:
+ *    Usato durante il ridimensionamento: le chiavi sono già tutte distinte, quindi
+ *    non serve confrontarle, e l'hash memorizzato evita di ricalcolarlo.
+ *
+ * Parametri:
+ *    slot: vettore di destinazione
+ *    capacita: numero di slot del vettore di destinazione
+ *    s: slot da copiare
+ *
+ * Pre-condizioni:
+ *    il vettore di destinazione deve avere almeno uno slot libero
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    modifica uno slot del vettore di destinazione
+ */
+static void colloca_slot(struct slot *slot, unsigned int capacita, const struct slot *s) {
+    unsigned int i = indice_ideale(s->hash, capacita);
+    while (slot[i].valore != NULL) {
+        i = (i + 1) & (capacita - 1);
+    }
+    slot[i] = *s;
+}
+
+/*
+ * Funzione: occupa_slot
+ * ---------------------
+ *
+ * Scrive chiave, hash e valore in uno slot libero.
+ *
+ * Implementazione:
+ *    Copia la chiave nello slot se è corta, altrimenti la duplica con mia_strdup.
+ *
+ * Parametri:
+ *    s: slot libero da occupare
+ *    chiave: chiave dell'elemento
+ *    hash: hash della chiave
+ *    valore: valore da associare alla chiave
+ *
+ * Pre-condizioni:
+ *    s, chiave e valore: non devono essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se lo slot è stato occupato, 0 se la duplicazione della chiave
+ *    è fallita (in tal caso lo slot resta libero)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    modifica lo slot e può allocare memoria per la chiave
+ */
+static Byte occupa_slot(struct slot *s, const char *chiave, unsigned long hash, void *valore){
+    size_t lunghezza = strlen(chiave);
+    if(lunghezza < LUNGHEZZA_CHIAVE_BREVE){
+        memcpy(s->chiave.breve, chiave, lunghezza + 1);
+        s->chiave_lunga = 0;
+    }
+    else {
+        s->chiave.lunga = mia_strdup(chiave);
+        if(s->chiave.lunga == NULL) return 0;
+        s->chiave_lunga = 1;
+    }
+
+    s->hash = hash;
+    s->valore = valore;
+    return 1;
+}
+
+/*
+ * Funzione: nuova_tabella_hash
+ * -----------------------------
+ *
+ * crea una nuova tabella hash per la memorizzazione degli oggetti con la dimensione specificata
+ *
+ * Implementazione:
+ *    Arrotonda la grandezza richiesta alla potenza di 2 successiva (almeno CAPACITA_MINIMA),
+ *    così che l'indice si ottenga con una maschera, e alloca il vettore degli slot vuoti.
+ *
+ * Parametri:
+ *    grandezza: dimensione iniziale della tabella hash
+ *
+ * Pre-condizioni:
+ *    grandezza: deve essere maggiore di 0
+ *
+ * Post-condizioni:
+ *    restituisce una nuova TabellaHash se l'allocazione è riuscita,
+ *    altrimenti restituisce NULL
+ *
+ * Ritorna:
+ *    un puntatore a una nuova struttura TabellaHash o NULL
+ *
+ * Side-effect:
+ *   alloca memoria dinamicamente per la tabella hash e i suoi slot
+ */
+TabellaHash nuova_tabella_hash(const unsigned int grandezza){
+    if(grandezza == 0) return NULL;
+
+    TabellaHash tabella_hash = malloc(sizeof(struct tabella_hash));
+    if(tabella_hash == NULL) return NULL;
+
+    unsigned int capacita = CAPACITA_MINIMA;
+    while(capacita < grandezza) capacita <<= 1;
+
+    tabella_hash->slot = alloca_slot(capacita, &tabella_hash->memoria);
+    if(tabella_hash->slot == NULL){
+        free(tabella_hash);
+        return NULL;
+    }
+
+    tabella_hash->capacita = capacita;
+    tabella_hash->numero_elementi = 0;
+    return tabella_hash;
+}
+
+/*
+ * Funzione: distruggi_tabella
+ * -----------------------------
+ *
+ * libera la memoria allocata per una tabella hash, inclusi tutti gli elementi memorizzati
+ *
+ * Implementazione:
+ *    Scorre il vettore degli slot: per ogni slot occupato libera la chiave, se allocata
+ *    fuori dallo slot, e il valore tramite funzione_distruggi_valore se non è NULL.
+ *    Poi libera il vettore e la struttura TabellaHash.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash da eliminare
+ *    funzione_distruggi_valore: funzione da applicare ad ogni valore per liberare la memoria associata
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce nulla
+ *
+ * Side-effect:
+ *    libera la memoria associata alla struttura TabellaHash e ai suoi elementi
+ */
+void distruggi_tabella(TabellaHash tabella_hash, void (*funzione_distruggi_valore)(void *)){
+    if(tabella_hash == NULL) return;
+
+    for(unsigned int i = 0; i < tabella_hash->capacita; i++){
+        struct slot *s = &tabella_hash->slot[i];
+        if(s->valore == NULL) continue;
+
+        if(s->chiave_lunga) free(s->chiave.lunga);
+        if(funzione_distruggi_valore != NULL) funzione_distruggi_valore(s->valore);
+    }
+
+    free(tabella_hash->memoria);
+    free(tabella_hash);
+}
+
+/*
+ * Funzione: ridimensiona_tabella_hash
+ * -----------------------------------
+ *
+ * raddoppia la capacità della tabella hash per mantenere corte le sequenze di scansione.
+ *
+ * Implementazione:
+ *    - Alloca un nuovo vettore di slot di capacità doppia.
+ *    - Copia ogni slot occupato nella nuova posizione tramite colloca_slot,
+ *      riutilizzando l'hash memorizzato e senza duplicare le chiavi.
+ *    - Libera il vecchio vettore e aggiorna la struttura.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla struttura della tabella hash da ridimensionare
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il ridimensionamento è riuscito, 0 altrimenti
+ *    (in tal caso la tabella resta invariata)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    la tabella hash avrà il doppio della capacità e conterrà tutti gli elementi precedenti
+ */
+static Byte ridimensiona_tabella_hash(TabellaHash tabella_hash){
+    unsigned int nuova_capacita = tabella_hash->capacita * 2;
+    void *nuova_memoria;
+    struct slot *nuovi_slot = alloca_slot(nuova_capacita, &nuova_memoria);
+    if(nuovi_slot == NULL) return 0;
+
+    for(unsigned int i = 0; i < tabella_hash->capacita; i++){
+        if(tabella_hash->slot[i].valore != NULL){
+            colloca_slot(nuovi_slot, nuova_capacita, &tabella_hash->slot[i]);
+        }
+    }
+
+    free(tabella_hash->memoria);
+    tabella_hash->memoria = nuova_memoria;
+    tabella_hash->slot = nuovi_slot;
+    tabella_hash->capacita = nuova_capacita;
+    return 1;
+}
+
+/*
+ * Funzione: inserisci_in_tabella
+ * ------------------------------------
+ *
+ * inserisce un elemento nella tabella hash associando una chiave a un valore
+ *
+ * Implementazione:
+ *    - Se dopo l'inserimento la tabella supererebbe la percentuale di riempimento,
+ *      la ridimensiona; se la tabella è piena e il ridimensionamento fallisce,
+ *      l'inserimento viene annullato.
+ *    - Calcola l'hash della chiave una sola volta e scorre gli slot a partire dall'indice
+ *      ideale: se trova la chiave l'inserimento viene annullato, altrimenti si ferma
+ *      al primo slot libero.
+ *    - Occupa lo slot con occupa_slot, che copia la chiave nello slot se è corta
+ *      e altrimenti la duplica con mia_strdup.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    chiave: stringa costante contenente la chiave dell'elemento
+ *    valore: puntatore al valore da associare alla chiave
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *    chiave: non deve essere NULL
+ *    valore: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se l'inserimento è avvenuto con successo, 0 in caso di errore
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    modifica la tabella hash aggiungendo un nuovo elemento e ridimensiona la tabella se necessario
+ */
+Byte inserisci_in_tabella(TabellaHash tabella_hash, const char *chiave, void *valore){
+    if(tabella_hash == NULL || chiave == NULL || valore == NULL) return 0;
+
+    double percentuale = (double)(tabella_hash->numero_elementi + 1) / (double)tabella_hash->capacita;
+    if(percentuale > PERCENTUALE_DI_RIEMPIMENTO){
+        // Deve restare sempre almeno uno slot libero, altrimenti la scansione non termina
+        if(!ridimensiona_tabella_hash(tabella_hash) &&
+           tabella_hash->numero_elementi + 1 >= tabella_hash->capacita) return 0;
+    }
+
+    unsigned long hash = djb2_hash(chiave);
+    unsigned int maschera = tabella_hash->capacita - 1;
+    unsigned int i = indice_ideale(hash, tabella_hash->capacita);
+
+    // Verifica se la chiave è già presente e se lo è restituisce 0
+    while(tabella_hash->slot[i].valore != NULL){
+        struct slot *s = &tabella_hash->slot[i];
+        if(s->hash == hash && strcmp(chiave_slot(s), chiave) == 0){
+            return 0;
+        }
+        i = (i + 1) & maschera;
+    }
+
+    if(!occupa_slot(&tabella_hash->slot[i], chiave, hash, valore)) return 0;
+    tabella_hash->numero_elementi++;
+    return 1;
+}
+
+/*
+ * Funzione: prepara_capacita
+ * --------------------------
+ *
+ * porta la tabella alla capacità necessaria per contenere `totale` elementi senza
+ * superare la percentuale di riempimento.
+ *
+ * Implementazione:
+ *    Calcola la potenza di 2 finale e, se è maggiore di quella attuale, alloca il nuovo
+ *    vettore con una sola alloca_slot e vi colloca gli slot occupati, come
+ *    ridimensiona_tabella_hash ma senza passare per i raddoppi intermedi.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    totale: numero di elementi che la tabella dovrà contenere
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se la capacità è sufficiente, 0 se l'allocazione è fallita
+ *    (in tal caso la tabella resta invariata)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    può sostituire il vettore degli slot
+ */
+static Byte prepara_capacita(TabellaHash tabella_hash, unsigned int totale){
+    unsigned long capacita = tabella_hash->capacita;
+    while((double)totale / (double)capacita > PERCENTUALE_DI_RIEMPIMENTO) capacita <<= 1;
+    if(capacita == tabella_hash->capacita) return 1;
+    if(capacita > UINT_MAX) return 0;
+
+    void *nuova_memoria;
+    struct slot *nuovi_slot = alloca_slot((unsigned int)capacita, &nuova_memoria);
+    if(nuovi_slot == NULL) return 0;
+
+    for(unsigned int i = 0; i < tabella_hash->capacita; i++){
+        if(tabella_hash->slot[i].valore != NULL){
+            colloca_slot(nuovi_slot, (unsigned int)capacita, &tabella_hash->slot[i]);
+        }
+    }
+
+    free(tabella_hash->memoria);
+    tabella_hash->memoria = nuova_memoria;
+    tabella_hash->slot = nuovi_slot;
+    tabella_hash->capacita = (unsigned int)capacita;
+    return 1;
+}
+
+/*
+ * Funzione: inserisci_in_blocco
+ * -----------------------------
+ *
+ * inserisce nella tabella un vettore di valori con chiavi tutte distinte, senza
+ * controllare i duplicati
+ *
+ * Implementazione:
+ *    - Porta la tabella alla capacità finale con prepara_capacita; se non ci riesce
+ *      ripiega su inserisci_in_tabella, che ridimensiona quando serve.
+ *    - Per ogni valore non NULL occupa il primo slot libero a partire dall'indice
+ *      ideale, senza confrontare le chiavi: l'unicità è garantita dal chiamante.
+ *    - Si ferma al primo errore di allocazione.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    valori: vettore dei valori da inserire, può contenere elementi NULL che vengono saltati
+ *    dimensione: numero di elementi del vettore
+ *    chiave_di: funzione che restituisce la chiave di un valore
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *    valori: non deve essere NULL
+ *    chiave_di: non deve essere NULL
+ *    le chiavi dei valori devono essere distinte tra loro e assenti dalla tabella
+ *
+ * Post-condizioni:
+ *    restituisce il numero di elementi di `valori` esaminati: i valori non NULL con
+ *    indice minore sono stati inseriti, gli altri no (dimensione se non ci sono errori)
+ *
+ * Ritorna:
+ *    un intero senza segno
+ *
+ * Side-effect:
+ *    modifica la tabella hash aggiungendo gli elementi e può sostituire il vettore degli slot
+ */
+unsigned int inserisci_in_blocco(TabellaHash tabella_hash, void **valori, unsigned int dimensione, const char *(*chiave_di)(const void *valore)){
+    if(tabella_hash == NULL || valori == NULL || chiave_di == NULL) return 0;
+
+    Byte pronta = prepara_capacita(tabella_hash, tabella_hash->numero_elementi + dimensione);
+    unsigned int maschera = tabella_hash->capacita - 1;
+
+    for(unsigned int i = 0; i < dimensione; i++){
+        if(valori[i] == NULL) continue;
+
+        const char *chiave = chiave_di(valori[i]);
+        if(chiave == NULL) return i;
+        if(!pronta){
+            if(!inserisci_in_tabella(tabella_hash, chiave, valori[i])) return i;
+            continue;
+        }
+
+        unsigned long hash = djb2_hash(chiave);
+        unsigned int j = indice_ideale(hash, tabella_hash->capacita);
+        while(tabella_hash->slot[j].valore != NULL) j = (j + 1) & maschera;
+
+        if(!occupa_slot(&tabella_hash->slot[j], chiave, hash, valori[i])) return i;
+        tabella_hash->numero_elementi++;
+    }
+    return dimensione;
+}
+
+/*
+ * Funzione: cancella_dalla_tabella
+ * -----------------------------------
+ *
+ * rimuove un oggetto dalla tabella hash utilizzando la chiave fornita
+ *
+ * Implementazione:
+ *    - Cerca lo slot della chiave con trova_slot.
+ *    - Libera la chiave, se allocata fuori dallo slot, e il valore tramite la funzione passata.
+ *    - Invece di lasciare un marcatore di cancellazione, sposta indietro gli elementi
+ *      successivi della stessa sequenza di scansione che possono occupare lo slot liberato
+ *      (backward shift), così che le ricerche future non si allunghino.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    chiave: stringa costante contenente la chiave dell'elemento da rimuovere
+ *    funzione_distruggi_valore: funzione da applicare al valore per liberare la memoria associata
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *    chiave: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se la rimozione ha avuto successo, 0 se la chiave non è presente
+ *    o se si verifica un errore
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    - modifica la tabella hash rimuovendo l'elemento associato alla chiave
+ *    - libera memoria dinamicamente associata alla chiave e al valore
+ */
+Byte cancella_dalla_tabella(TabellaHash tabella_hash, const char *chiave, void (*funzione_distruggi_valore)(void *)){
+    if(tabella_hash == NULL || chiave == NULL) return 0;
+
+    long trovato = trova_slot(tabella_hash, chiave, djb2_hash(chiave));
+    if(trovato < 0) return 0;
+
+    unsigned int maschera = tabella_hash->capacita - 1;
+    unsigned int libero = (unsigned int)trovato;
+    struct slot *s = &tabella_hash->slot[libero];
+
+    if(s->chiave_lunga) free(s->chiave.lunga);
+    if(funzione_distruggi_valore != NULL) funzione_distruggi_valore(s->valore);
+
+    /* Scorre gli elementi successivi: un elemento può essere spostato nello slot libero
+     * solo se il suo indice ideale non cade tra lo slot libero (escluso) e la sua posizione
+     */
+    unsigned int j = (libero + 1) & maschera;
+    while(tabella_hash->slot[j].valore != NULL){
+        unsigned int ideale = indice_ideale(tabella_hash->slot[j].hash, tabella_hash->capacita);
+        if(((j - ideale) & maschera) >= ((j - libero) & maschera)){
+            tabella_hash->slot[libero] = tabella_hash->slot[j];
+            libero = j;
+        }
+        j = (j + 1) & maschera;
+    }
+
+    memset(&tabella_hash->slot[libero], 0, sizeof(struct slot));
+    tabella_hash->numero_elementi--;
+    return 1;
+}
+
+/*
+ * Funzione: cerca_in_tabella
+ * ---------------------------------
+ *
+ * cerca un elemento nella tabella hash tramite la chiave specificata
+ *
+ * Implementazione:
+ *    Calcola l'hash della chiave e delega la scansione a trova_slot.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    chiave: stringa costante contenente la chiave da cercare
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *    chiave: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    Se la chiave è presente, restituisce il puntatore al valore associato;
+ *    altrimenti restituisce NULL
+ *
+ * Ritorna:
+ *    un puntatore generico o NULL
+ */
+const void *cerca_in_tabella(const TabellaHash tabella_hash, const char *chiave){
+    if(tabella_hash == NULL || chiave == NULL) return NULL;
+
+    long trovato = trova_slot(tabella_hash, chiave, djb2_hash(chiave));
+    if(trovato < 0) return NULL;
+
+    return tabella_hash->slot[trovato].valore;
+}
+
+/*
+ * Funzione: ottieni_vettore
+ * -------------------------
+ *
+ * estrae tutti i valori contenuti nella tabella hash e li restituisce in un array.
+ *
+ * Implementazione:
+ *    Alloca un array di dimensione pari al numero di elementi e scorre il vettore
+ *    degli slot in ordine, copiando il valore di ogni slot occupato.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    dimensione: puntatore ad un intero dove verrà memorizzata la dimensione del vettore restituito
+ *
+ * Pre-condizioni:
+ *    tabella_hash: non deve essere NULL
+ *    dimensione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce un array di puntatori ai valori presenti nella tabella hash,
+ *    oppure NULL se ci sono errori o la tabella è vuota.
+ *
+ * Ritorna:
+ *    un array di puntatori generico o NULL
+ *
+ * Side-effect:
+ *    alloca dinamicamente memoria per il vettore risultante
+ */
+void **ottieni_vettore(const TabellaHash tabella_hash, unsigned int *dimensione){
+    if(tabella_hash == NULL || dimensione == NULL) return NULL;
+
+    void **vettore = malloc(sizeof(void *) * tabella_hash->numero_elementi);
+    if(vettore == NULL){
+        return NULL;
+    }
+
+    unsigned int n = 0;
+    for(unsigned int i = 0; i < tabella_hash->capacita && n < tabella_hash->numero_elementi; i++){
+        if(tabella_hash->slot[i].valore != NULL){
+            vettore[n++] = tabella_hash->slot[i].valore;
+        }
+    }
+
+    *dimensione = n;
+    return vettore;
+}
+
+/*
+ * Funzione: dimensione_tabella
+ * ----------------------------
+ *
+ * restituisce il numero di elementi contenuti nella tabella hash
+ *
+ * Implementazione:
+ *    Restituisce il contatore numero_elementi, aggiornato da inserimenti e cancellazioni.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *
+ * Pre-condizioni:
+ *    tabella_hash: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce il numero di elementi, oppure 0 se `tabella_hash` è NULL
+ *
+ * Ritorna:
+ *    un intero senza segno
+ */
+unsigned int dimensione_tabella(const TabellaHash tabella_hash){
+    if(tabella_hash == NULL) return 0;
+    return tabella_hash->numero_elementi;
+}
+
+/*
+ * Funzione: tabella_iter_init
+ * ---------------------------
+ *
+ * prepara un iteratore per visitare tutti i valori della tabella hash, senza allocare memoria
+ *
+ * Implementazione:
+ *    Posiziona l'iteratore sul primo slot; il campo `prossimo` non è usato da questo motore.
+ *
+ * Parametri:
+ *    iteratore: puntatore all'iteratore da inizializzare
+ *    tabella_hash: puntatore alla tabella hash da visitare
+ *
+ * Pre-condizioni:
+ *    iteratore: non deve essere NULL
+ *    tabella_hash: può essere NULL (la visita è vuota)
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ */
+void tabella_iter_init(IteratoreTabella *iteratore, TabellaHash tabella_hash){
+    if(iteratore == NULL) return;
+
+    iteratore->tabella = tabella_hash;
+    iteratore->indice = 0;
+    iteratore->prossimo = NULL;
+}
+
+/*
+ * Funzione: tabella_iter_next
+ * ---------------------------
+ *
+ * restituisce il prossimo valore della visita iniziata con tabella_iter_init
+ *
+ * Implementazione:
+ *    Avanza sugli slot a partire da `indice` fino al primo slot occupato
+ *    e ne restituisce il valore.
+ *
+ * Parametri:
+ *    iteratore: puntatore all'iteratore
+ *
+ * Pre-condizioni:
+ *    iteratore: non deve essere NULL e deve essere stato inizializzato con tabella_iter_init
+ *
+ * Post-condizioni:
+ *    restituisce il prossimo valore, oppure NULL quando tutti i valori sono stati visitati
+ *
+ * Ritorna:
+ *    un puntatore generico o NULL
+ *
+ * Side-effect:
+ *    avanza l'iteratore
+ */
+void *tabella_iter_next(IteratoreTabella *iteratore){
+    if(iteratore == NULL || iteratore->tabella == NULL) return NULL;
+
+    while(iteratore->indice < iteratore->tabella->capacita){
+        void *valore = iteratore->tabella->slot[iteratore->indice++].valore;
+        if(valore != NULL) return valore;
+    }
+    return NULL;
+}
+
+/*
+ * Funzione: tabella_per_ogni
+ * --------------------------
+ *
+ * applica una funzione a tutti i valori della tabella hash, senza allocare memoria
+ *
+ * Implementazione:
+ *    Visita la tabella con un IteratoreTabella e chiama `funzione` su ogni valore.
+ *
+ * Parametri:
+ *    tabella_hash: puntatore alla tabella hash
+ *    funzione: funzione da chiamare per ogni valore; riceve il valore e `contesto`
+ *    contesto: puntatore passato invariato ad ogni chiamata di `funzione`, può essere NULL
+ *
+ * Pre-condizioni:
+ *    tabella_hash: può essere NULL (nessuna operazione)
+ *    funzione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    quelli di `funzione`
+ */
+void tabella_per_ogni(TabellaHash tabella_hash, void (*funzione)(void *valore, void *contesto), void *contesto){
+    if(tabella_hash == NULL || funzione == NULL) return;
+
+    IteratoreTabella iteratore;
+    void *valore;
+
+    tabella_iter_init(&iteratore, tabella_hash);
+    while((valore = tabella_iter_next(&iteratore)) != NULL){
+        funzione(valore, contesto);
+    }
+}
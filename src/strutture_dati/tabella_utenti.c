@@ -62,6 +62,26 @@ static void distruggi_utente_t(void *utente){
     distruggi_utente(u);
 }
 
+/*
+ * Funzione: email_utente_t
+ * ------------------------
+ *
+ * funzione di supporto che restituisce l'email, chiave della tabella, di un utente
+ * passato come puntatore generico, per l'utilizzo con inserisci_in_blocco
+ *
+ * Parametri:
+ *    utente: puntatore generico a un utente
+ *
+ * Pre-condizioni:
+ *    utente: non deve essere NULL
+ *
+ * Ritorna:
+ *    l'email dell'utente
+ */
+static const char *email_utente_t(const void *utente){
+    return ottieni_email((Utente)utente);
+}
+
 /*
  * Funzione: distruggi_tabella_utenti
  * -----------------------------------
@@ -201,8 +221,10 @@ Byte rimuovi_utente_in_tabella(TabellaUtenti tabella_utenti, char *email){
  * carica un insieme di utenti in una tabella hash
  *
  * Implementazione:
- *    itera sull'array di utenti fornito e li inserisce uno a uno nella tabella
- *    usando la funzione aggiungi_utente_in_tabella.
+ *    inserisce l'intero array con inserisci_in_blocco, che porta la tabella alla
+ *    grandezza finale una sola volta e non controlla le email duplicate. Se
+ *    l'inserimento si interrompe per mancanza di memoria, gli utenti rimasti
+ *    fuori dalla tabella vengono distrutti.
  *
  * Parametri:
  *    tabella_utenti: puntatore alla tabella hash in cui inserire gli utenti
@@ -213,18 +235,21 @@ Byte rimuovi_utente_in_tabella(TabellaUtenti tabella_utenti, char *email){
  *    tabella_utenti: non deve essere NULL
  *    utente: non deve essere NULL
  *    dimensione: deve essere maggiore di 0
+ *    le email devono essere distinte tra loro e assenti dalla tabella, come
+ *    negli utenti letti da un archivio salvato da una tabella
  *
  * Post-condizioni:
  *    Non restituisce niente
  *
  * Side-effect:
- *    gli utenti vengono inseriti nella tabella hash. Se un utente ha un'email
- *    uguale rispetto a uno già presente, l'utente non viene inserito
+ *    gli utenti vengono inseriti nella tabella hash, che ne acquisisce la proprietà;
+ *    gli elementi NULL dell'array vengono saltati
  */
 void carica_utenti(TabellaUtenti tabella_utenti, Utente *utente, unsigned int dimensione){
     if(tabella_utenti == NULL || utente == NULL || !dimensione) return;
 
-    for(unsigned int i = 0; i < dimensione; i++){
-        aggiungi_utente_in_tabella(tabella_utenti, utente[i]);
+    unsigned int inseriti = inserisci_in_blocco(tabella_utenti, (void **)utente, dimensione, email_utente_t);
+    for(unsigned int i = inseriti; i < dimensione; i++){
+        distruggi_utente(utente[i]);
     }
 }
@@ -4,11 +4,26 @@
  */
 
 #include <stddef.h>
+#include <stdlib.h>
 #include "strutture_dati/prenotazioni.h"
 #include "modelli/veicolo.h"
 #include "strutture_dati/tabella_hash.h"
+#include "strutture_dati/indice_disponibilita.h"
 #include "strutture_dati/tabella_veicoli.h"
 
+/*
+ * La tabella hash contiene i veicoli indicizzati per targa; l'indice di
+ * disponibilità risponde a `ottieni_veicoli_disponibili` senza interrogare
+ * le prenotazioni di ogni veicolo. I veicoli inseriti vengono accodati all'indice;
+ * l'indice è ricostruito alla prima interrogazione dopo un caricamento o una
+ * rimozione di veicoli, e resta aggiornato da solo a ogni prenotazione aggiunta
+ * o cancellata.
+ */
+struct tabella_veicoli {
+    TabellaHash veicoli;
+    IndiceDisponibilita indice;
+};
+
 /*
  * Funzione: crea_tabella_veicoli
  * ------------------------------
@@ -17,7 +32,8 @@
  *
  * Implementazione:
  *    Sfrutta la funzione nuova_tabella_hash per creare e inizializzare
- *    una nuova tabella hash con la grandezza specificata.
+ *    una nuova tabella hash con la grandezza specificata, e crea l'indice
+ *    di disponibilità vuoto.
  *
  * Parametri:
  *    grandezza: dimensione iniziale della tabella hash
@@ -36,7 +52,18 @@
  *    Alloca dinamicamente memoria per la struttura tabella hash
  */
 TabellaVeicoli crea_tabella_veicoli(unsigned int grandezza){
-    return nuova_tabella_hash(grandezza);
+    TabellaVeicoli tabella_veicoli = malloc(sizeof(struct tabella_veicoli));
+    if(tabella_veicoli == NULL) return NULL;
+
+    tabella_veicoli->veicoli = nuova_tabella_hash(grandezza);
+    tabella_veicoli->indice = crea_indice_disponibilita();
+    if(tabella_veicoli->veicoli == NULL || tabella_veicoli->indice == NULL){
+        distruggi_tabella(tabella_veicoli->veicoli, NULL);
+        distruggi_indice_disponibilita(tabella_veicoli->indice);
+        free(tabella_veicoli);
+        return NULL;
+    }
+    return tabella_veicoli;
 }
 
 /*
@@ -64,6 +91,26 @@ static void distruggi_veicolo_t(void *veicolo){
     distruggi_veicolo(v);
 }
 
+/*
+ * Funzione: targa_veicolo_t
+ * -------------------------
+ *
+ * funzione di supporto che restituisce la targa, chiave della tabella, di un veicolo
+ * passato come puntatore generico, per l'utilizzo con inserisci_in_blocco
+ *
+ * Parametri:
+ *    veicolo: puntatore generico a un veicolo
+ *
+ * Pre-condizioni:
+ *    veicolo: non deve essere NULL
+ *
+ * Ritorna:
+ *    la targa del veicolo
+ */
+static const char *targa_veicolo_t(const void *veicolo){
+    return ottieni_targa((Veicolo)veicolo);
+}
+
 /*
  * Funzione: distruggi_tabella_veicoli
  * -----------------------------------
@@ -73,7 +120,8 @@ static void distruggi_veicolo_t(void *veicolo){
  *
  * Implementazione:
  *    Utilizza la funzione `distruggi_tabella`, passando una funzione
- *    di distruzione specifica per i veicoli (`distruggi_veicolo_t`).
+ *    di distruzione specifica per i veicoli (`distruggi_veicolo_t`),
+ *    poi distrugge l'indice di disponibilità.
  *
  * Parametri:
  *    tabella_veicoli: tabella hash contenente i veicoli
@@ -95,7 +143,9 @@ void distruggi_tabella_veicoli(TabellaVeicoli tabella_veicoli){
     /* Viene passata la funzione distruggi_veicolo_t per rispettare il parametro
      * che deve restituire un void e avere come parametro un puntatore void
      */
-    distruggi_tabella(tabella_veicoli, distruggi_veicolo_t);
+    distruggi_tabella(tabella_veicoli->veicoli, distruggi_veicolo_t);
+    distruggi_indice_disponibilita(tabella_veicoli->indice);
+    free(tabella_veicoli);
 }
 
 /*
@@ -106,7 +156,8 @@ void distruggi_tabella_veicoli(TabellaVeicoli tabella_veicoli){
  *
  * Implementazione:
  *    chiama la funzione inserisci_in_tabella utilizzando la targa del veicolo come chiave
- *    e il puntatore al veicolo come valore.
+ *    e il puntatore al veicolo come valore. Se l'inserimento riesce il veicolo
+ *    viene accodato all'indice di disponibilità.
  *
  * Parametri:
  *    tabella_veicoli: puntatore alla tabella hash dei veicoli
@@ -128,7 +179,9 @@ void distruggi_tabella_veicoli(TabellaVeicoli tabella_veicoli){
 Byte aggiungi_veicolo_in_tabella(TabellaVeicoli tabella_veicoli, Veicolo veicolo){
     if(tabella_veicoli == NULL || veicolo == NULL) return 0;
 
-    return inserisci_in_tabella(tabella_veicoli, ottieni_targa(veicolo), (Veicolo)veicolo);
+    Byte esito = inserisci_in_tabella(tabella_veicoli->veicoli, ottieni_targa(veicolo), (Veicolo)veicolo);
+    if(esito) aggiungi_a_indice_disponibilita(tabella_veicoli->indice, veicolo);
+    return esito;
 }
 
 /*
@@ -159,7 +212,7 @@ Byte aggiungi_veicolo_in_tabella(TabellaVeicoli tabella_veicoli, Veicolo veicolo
 Veicolo cerca_veicolo_in_tabella(const TabellaVeicoli tabella_veicoli, const char *targa){
     if(tabella_veicoli == NULL || targa == NULL) return NULL;
 
-    return (Veicolo)cerca_in_tabella(tabella_veicoli, targa);
+    return (Veicolo)cerca_in_tabella(tabella_veicoli->veicoli, targa);
 }
 
 /*
@@ -170,7 +223,8 @@ Veicolo cerca_veicolo_in_tabella(const TabellaVeicoli tabella_veicoli, const cha
  *
  * Implementazione:
  *    richiama la funzione cancella_dalla_tabella passando la targa come chiave
- *    e la funzione distruggi_veicolo_t per liberare la memoria del veicolo
+ *    e la funzione distruggi_veicolo_t per liberare la memoria del veicolo.
+ *    Se la rimozione riesce l'indice di disponibilità viene invalidato.
  *
  * Parametri:
  *    tabella_veicoli: puntatore alla tabella hash contenente i veicoli
@@ -194,7 +248,106 @@ Veicolo cerca_veicolo_in_tabella(const TabellaVeicoli tabella_veicoli, const cha
 Byte rimuovi_veicolo_in_tabella(TabellaVeicoli tabella_veicoli, char *targa){
     if(tabella_veicoli == NULL || targa == NULL) return 0;
 
-    return cancella_dalla_tabella(tabella_veicoli, targa, distruggi_veicolo_t);
+    Byte esito = cancella_dalla_tabella(tabella_veicoli->veicoli, targa, distruggi_veicolo_t);
+    if(esito) invalida_indice_disponibilita(tabella_veicoli->indice);
+    return esito;
+}
+
+/*
+ * Funzione: scansiona_veicoli_disponibili
+ * ---------------------------------------
+ *
+ * restituisce i veicoli disponibili interrogando le prenotazioni di ognuno
+ *
+ * Implementazione:
+ *    alloca un vettore grande quanto il numero di veicoli e visita la tabella con
+ *    un IteratoreTabella, copiando solo i veicoli liberi nell'intervallo specificato.
+ *    È usata solo se l'indice di disponibilità non può essere ricostruito.
+ *
+ * Parametri:
+ *    tabella_veicoli: puntatore alla tabella dei veicoli
+ *    intervallo: l'intervallo di tempo da controllare
+ *    dimensione: puntatore a un intero dove verrà salvata la dimensione del vettore restituito
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: non deve essere NULL
+ *    dimensione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    Restituisce un array allocato dinamicamente di puntatori a veicoli, restituisce NULL in caso di errore
+ *
+ * Ritorna:
+ *    un array di veicoli o NULL
+ *
+ * Side-effect:
+ *    Alloca dinamicamente un array che dovrà essere liberato dal chiamante.
+ */
+static Veicolo *scansiona_veicoli_disponibili(TabellaVeicoli tabella_veicoli, Intervallo intervallo, unsigned int *dimensione){
+    unsigned int numero_veicoli = dimensione_tabella(tabella_veicoli->veicoli);
+    if(numero_veicoli == 0) return NULL;
+
+    Veicolo *vettore = malloc(sizeof(Veicolo) * numero_veicoli);
+    if(vettore == NULL) return NULL;
+
+    IteratoreTabella it;
+    Veicolo v;
+    unsigned int n = 0;
+
+    tabella_iter_init(&it, tabella_veicoli->veicoli);
+    while((v = tabella_iter_next(&it)) != NULL){
+        if(controlla_prenotazione(ottieni_prenotazioni(v), intervallo) != OCCUPATO){
+            vettore[n++] = v;
+        }
+    }
+
+    *dimensione = n;
+    return vettore;
+}
+
+/*
+ * Funzione: ricostruisci_indice
+ * -----------------------------
+ *
+ * ricostruisce l'indice di disponibilità con i veicoli nell'ordine di visita della tabella
+ *
+ * Implementazione:
+ *    raccoglie i veicoli con un IteratoreTabella, così che l'indice li restituisca
+ *    nell'ordine di visita della tabella al momento della ricostruzione, e li passa a
+ *    ricostruisci_indice_disponibilita. I veicoli inseriti in seguito vengono
+ *    restituiti dopo gli altri.
+ *
+ * Parametri:
+ *    tabella_veicoli: puntatore alla tabella dei veicoli
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se l'indice è stato ricostruito, 0 in caso di errore di allocazione
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    registra l'indice come osservatore di ogni veicolo
+ */
+static Byte ricostruisci_indice(TabellaVeicoli tabella_veicoli){
+    unsigned int numero_veicoli = dimensione_tabella(tabella_veicoli->veicoli);
+    Veicolo *vettore = malloc(sizeof(Veicolo) * (numero_veicoli > 0 ? numero_veicoli : 1));
+    if(vettore == NULL) return 0;
+
+    IteratoreTabella it;
+    Veicolo v;
+    unsigned int n = 0;
+
+    tabella_iter_init(&it, tabella_veicoli->veicoli);
+    while((v = tabella_iter_next(&it)) != NULL){
+        vettore[n++] = v;
+    }
+
+    Byte esito = ricostruisci_indice_disponibilita(tabella_veicoli->indice, vettore, n);
+    free(vettore);
+    return esito;
 }
 
 /*
@@ -204,9 +357,10 @@ Byte rimuovi_veicolo_in_tabella(TabellaVeicoli tabella_veicoli, char *targa){
  * restituisce un array di veicoli disponibili in un determinato intervallo di tempo
  *
  * Implementazione:
- *    estrae tutti i veicoli dalla tabella hash e verifica per ciascuno
- *    se è occupato nell'intervallo specificato. Se lo è, imposta il corrispondente
- *    elemento del vettore a NULL.
+ *    interroga l'indice di disponibilità della flotta, ricostruendolo prima se
+ *    veicoli sono stati caricati o rimossi dall'ultima interrogazione. Se l'indice
+ *    non può essere ricostruito o aggiornato per mancanza di memoria, ripiega
+ *    sulla scansione di tutti i veicoli.
  *
  * Parametri:
  *    tabella_veicoli: puntatore alla tabella hash contenente i veicoli
@@ -225,17 +379,19 @@ Byte rimuovi_veicolo_in_tabella(TabellaVeicoli tabella_veicoli, char *targa){
  *
  * Side-effect:
  *    Alloca dinamicamente un array che dovrà essere liberato dal chiamante.
+ *    Può ricostruire l'indice di disponibilità.
  */
 Veicolo *ottieni_veicoli_disponibili(TabellaVeicoli tabella_veicoli, Intervallo intervallo, unsigned int *dimensione){
-    Veicolo *vettore = (Veicolo *)ottieni_vettore(tabella_veicoli, dimensione);
-    if(vettore == NULL || dimensione == NULL) return NULL;
+    if(tabella_veicoli == NULL || dimensione == NULL) return NULL;
+    if(dimensione_tabella(tabella_veicoli->veicoli) == 0) return NULL;
 
-    for(unsigned int i = 0; i < *dimensione; i++){
-        if(controlla_prenotazione(ottieni_prenotazioni(vettore[i]), intervallo) == OCCUPATO){
-            vettore[i] = NULL;
-        }
+    if(intervallo != NULL &&
+       (indice_disponibilita_valido(tabella_veicoli->indice) || ricostruisci_indice(tabella_veicoli))){
+        Veicolo *vettore = veicoli_liberi_da_indice(tabella_veicoli->indice, intervallo, dimensione);
+        if(vettore != NULL || indice_disponibilita_valido(tabella_veicoli->indice)) return vettore;
     }
-    return vettore;
+
+    return scansiona_veicoli_disponibili(tabella_veicoli, intervallo, dimensione);
 }
 
 /*
@@ -245,8 +401,10 @@ Veicolo *ottieni_veicoli_disponibili(TabellaVeicoli tabella_veicoli, Intervallo
  * carica un insieme di veicoli in una tabella hash
  *
  * Implementazione:
- *    itera sull'array di veicoli fornito e li inserisce uno a uno nella tabella
- *    usando la funzione aggiungi_veicolo_in_tabella.
+ *    invalida l'indice di disponibilità e inserisce l'intero array con inserisci_in_blocco,
+ *    che porta la tabella alla grandezza finale una sola volta e non controlla le targhe
+ *    duplicate. Se l'inserimento si interrompe per mancanza di memoria, i veicoli
+ *    rimasti fuori dalla tabella vengono distrutti.
  *
  * Parametri:
  *    tabella_veicoli: puntatore alla tabella hash in cui inserire i veicoli
@@ -257,18 +415,134 @@ Veicolo *ottieni_veicoli_disponibili(TabellaVeicoli tabella_veicoli, Intervallo
  *    - tabella_veicoli: non deve essere NULL
  *    - veicolo: non deve essere NULL
  *    - dimensione: deve essere maggiore di 0
+ *    - le targhe devono essere distinte tra loro e assenti dalla tabella, come
+ *      nei veicoli letti da un archivio salvato da una tabella
  *
  * Post-condizioni:
  *    Non restituisce niente
  *
  * Side-effect:
- *    I veicoli vengono inseriti nella tabella hash. Se un veicolo ha una targa
- *    uguale rispetto a uno già presente, il veicolo non viene inserito
+ *    I veicoli vengono inseriti nella tabella hash, che ne acquisisce la proprietà;
+ *    gli elementi NULL dell'array vengono saltati
  */
 void carica_veicoli(TabellaVeicoli tabella_veicoli, Veicolo *veicolo, unsigned int dimensione){
 	if(tabella_veicoli == NULL || veicolo == NULL || !dimensione) return;
 
-	for(unsigned int i = 0; i < dimensione; i++){
-		aggiungi_veicolo_in_tabella(tabella_veicoli, veicolo[i]);
+	invalida_indice_disponibilita(tabella_veicoli->indice);
+	unsigned int inseriti = inserisci_in_blocco(tabella_veicoli->veicoli, (void **)veicolo, dimensione, targa_veicolo_t);
+	for(unsigned int i = inseriti; i < dimensione; i++){
+		distruggi_veicolo(veicolo[i]);
 	}
 }
+
+/*
+ * Funzione: dimensione_tabella_veicoli
+ * ------------------------------------
+ *
+ * restituisce il numero di veicoli contenuti nella tabella
+ *
+ * Implementazione:
+ *    delega a dimensione_tabella sulla tabella hash dei veicoli
+ *
+ * Parametri:
+ *    tabella_veicoli: puntatore alla tabella dei veicoli
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: può essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce il numero di veicoli, 0 se la tabella è NULL
+ *
+ * Ritorna:
+ *    un intero senza segno
+ */
+unsigned int dimensione_tabella_veicoli(const TabellaVeicoli tabella_veicoli){
+    if(tabella_veicoli == NULL) return 0;
+
+    return dimensione_tabella(tabella_veicoli->veicoli);
+}
+
+/*
+ * Funzione: tabella_veicoli_iter_init
+ * -----------------------------------
+ *
+ * inizializza un IteratoreTabella sui veicoli, da scorrere con `tabella_iter_next`
+ *
+ * Implementazione:
+ *    delega a tabella_iter_init sulla tabella hash dei veicoli
+ *
+ * Parametri:
+ *    iteratore: l'iteratore da inizializzare
+ *    tabella_veicoli: puntatore alla tabella dei veicoli
+ *
+ * Pre-condizioni:
+ *    iteratore: non deve essere NULL
+ *    tabella_veicoli: può essere NULL (l'iteratore non restituisce elementi)
+ *    la tabella non deve essere modificata durante la visita
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ */
+void tabella_veicoli_iter_init(IteratoreTabella *iteratore, TabellaVeicoli tabella_veicoli){
+    tabella_iter_init(iteratore, tabella_veicoli != NULL ? tabella_veicoli->veicoli : NULL);
+}
+
+/*
+ * Funzione: tabella_veicoli_per_ogni
+ * ----------------------------------
+ *
+ * chiama `funzione` su ogni veicolo della tabella, senza copiarla
+ *
+ * Implementazione:
+ *    delega a tabella_per_ogni sulla tabella hash dei veicoli
+ *
+ * Parametri:
+ *    tabella_veicoli: puntatore alla tabella dei veicoli
+ *    funzione: la funzione da chiamare, che riceve il veicolo e `contesto`
+ *    contesto: puntatore passato invariato a `funzione`
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: può essere NULL (nessuna operazione)
+ *    funzione: non deve essere NULL e non deve modificare la tabella
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ */
+void tabella_veicoli_per_ogni(TabellaVeicoli tabella_veicoli, void (*funzione)(void *valore, void *contesto), void *contesto){
+    if(tabella_veicoli == NULL) return;
+
+    tabella_per_ogni(tabella_veicoli->veicoli, funzione, contesto);
+}
+
+/*
+ * Funzione: ottieni_vettore_veicoli
+ * ---------------------------------
+ *
+ * restituisce un array con tutti i veicoli della tabella
+ *
+ * Implementazione:
+ *    delega a ottieni_vettore sulla tabella hash dei veicoli
+ *
+ * Parametri:
+ *    tabella_veicoli: puntatore alla tabella dei veicoli
+ *    dimensione: puntatore a un intero dove verrà salvata la dimensione del vettore restituito
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: non deve essere NULL
+ *    dimensione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce un array di puntatori ai veicoli, NULL se la tabella è vuota o in caso di errore
+ *
+ * Ritorna:
+ *    un array di veicoli o NULL
+ *
+ * Side-effect:
+ *    Alloca dinamicamente un array che dovrà essere liberato dal chiamante;
+ *    i veicoli restano della tabella.
+ */
+Veicolo *ottieni_vettore_veicoli(const TabellaVeicoli tabella_veicoli, unsigned int *dimensione){
+    if(tabella_veicoli == NULL || dimensione == NULL) return NULL;
+
+    return (Veicolo *)ottieni_vettore(tabella_veicoli->veicoli, dimensione);
+}
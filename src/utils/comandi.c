@@ -0,0 +1,219 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "utils/comandi.h"
+#include "utils/giornale.h"
+#include "utils/md5.h"
+#include "utils/servizio.h"
+#include "utils/utils.h"
+#include "modelli/intervallo.h"
+#include "modelli/prenotazione.h"
+#include "modelli/utente.h"
+#include "modelli/veicolo.h"
+#include "strutture_dati/tabella_utenti.h"
+#include "strutture_dati/tabella_veicoli.h"
+
+#define DIMENSIONE_DATA_COMANDO 20   // "gg/mm/aaaa hh:mm" e terminatore
+
+/*
+ * Funzione: scrivi_data
+ * ---------------------
+ * Scrive `t` in `data` nel formato gg/mm/aaaa hh:mm letto dai comandi.
+ */
+static void scrivi_data(char *data, time_t t){
+    struct tm *tm_info = localtime(&t);
+    if(tm_info == NULL || strftime(data, DIMENSIONE_DATA_COMANDO, "%d/%m/%Y %H:%M", tm_info) == 0) data[0] = '\0';
+}
+
+/*
+ * Funzione: stampa_prenotazione
+ * -----------------------------
+ * Visitatore dello storico: scrive sul file `contesto` una riga id;targa;inizio;fine;costo.
+ */
+static void stampa_prenotazione(const Prenotazione p, void *contesto){
+    char inizio[DIMENSIONE_DATA_COMANDO], fine[DIMENSIONE_DATA_COMANDO];
+    Intervallo i = ottieni_intervallo_prenotazione(p);
+
+    scrivi_data(inizio, inizio_intervallo(i));
+    scrivi_data(fine, fine_intervallo(i));
+    fprintf((FILE *)contesto, "%llu;%s;%s;%s;%.2f\n", (unsigned long long)ottieni_id_prenotazione(p),
+            ottieni_veicolo_prenotazione(p), inizio, fine, ottieni_costo_prenotazione(p));
+}
+
+/*
+ * Funzione: errore_comando
+ * ------------------------
+ * Scrive la riga di esito di un comando fallito e restituisce 0.
+ */
+static Byte errore_comando(FILE *uscita, const char *comando, const char *motivo){
+    fprintf(uscita, "ERRORE;%s;%s\n", comando, motivo);
+    return 0;
+}
+
+/*
+ * Funzione: esegui_comando
+ * ------------------------
+ *
+ * Esegue un singolo comando del protocollo e ne scrive l'esito su `uscita`
+ *
+ * Implementazione:
+ *    - Separa i campi della riga con strtok e sceglie l'operazione dal primo
+ *    - Registrazione e accesso usano `aggiungi_utente_in_tabella` e la verifica
+ *      dell'hash MD5 della password, come i menu
+ *    - Le operazioni del cliente sono quelle del servizio (`prenota`, `cancella`,
+ *      `modifica`, `disponibilita` e `storico`), di cui l'errore riporta `descrivi_esito_servizio`
+ *
+ * Parametri:
+ *    riga: la riga del comando, senza il carattere di a capo
+ *    sessione: puntatore all'utente che ha eseguito l'accesso (NULL se nessuno)
+ *    uscita: file su cui scrivere l'esito
+ *    tabella_utenti: tabella hash degli utenti
+ *    tabella_veicoli: tabella hash dei veicoli
+ *    giornale: giornale su cui registrare le modifiche (può essere NULL)
+ *
+ * Pre-condizioni:
+ *    riga: non deve essere NULL
+ *    sessione: non deve essere NULL
+ *    uscita: deve essere un file aperto in scrittura
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce 1 se il comando è riuscito, 0 altrimenti
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    modifica `riga`, `*sessione`, le tabelle e il giornale; scrive su `uscita`
+ */
+Byte esegui_comando(char *riga, Utente *sessione, FILE *uscita, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli,
+                    Giornale giornale){
+    char *comando = strtok(riga, ";");
+    char *campi[4] = { NULL, NULL, NULL, NULL };
+    unsigned int num_campi = 0;
+    char *campo;
+
+    if(comando == NULL) return errore_comando(uscita, "?", "comando vuoto");
+    while((campo = strtok(NULL, ";")) != NULL){
+        if(num_campi == 4) return errore_comando(uscita, comando, "troppi campi");
+        campi[num_campi++] = campo;
+    }
+
+    if(strcmp(comando, "registra") == 0){
+        if(num_campi != 4) return errore_comando(uscita, comando, "uso: registra;nome;cognome;email;password");
+        if(strlen(campi[0]) >= DIMENSIONE_NOME || strlen(campi[1]) >= DIMENSIONE_COGNOME || strlen(campi[2]) >= DIMENSIONE_EMAIL)
+            return errore_comando(uscita, comando, "campo troppo lungo");
+        // Stesso criterio dell'interfaccia: la password deve superare tutti i controlli
+        if(controllo_password(campi[3]) < 2) return errore_comando(uscita, comando, "password non valida");
+
+        uint8_t password[DIMENSIONE_PASSWORD];
+        md5(campi[3], strlen(campi[3]), password);
+        Utente utente = crea_utente(campi[2], password, campi[0], campi[1], CLIENTE);
+        if(utente == NULL) return errore_comando(uscita, comando, "memoria insufficiente");
+        if(!aggiungi_utente_in_tabella(tabella_utenti, utente)){
+            distruggi_utente(utente);
+            return errore_comando(uscita, comando, "email già in uso");
+        }
+        registra_utente_in_giornale(giornale, utente);
+        fprintf(uscita, "OK;registra;%s\n", campi[2]);
+        return 1;
+    }
+
+    if(strcmp(comando, "accedi") == 0){
+        if(num_campi != 2) return errore_comando(uscita, comando, "uso: accedi;email;password");
+        uint8_t password[DIMENSIONE_PASSWORD];
+        md5(campi[1], strlen(campi[1]), password);
+
+        Utente utente = cerca_utente_in_tabella(tabella_utenti, campi[0]);
+        *sessione = NULL;
+        if(utente == NULL || !hash_equals(ottieni_password(utente), password, DIMENSIONE_PASSWORD))
+            return errore_comando(uscita, comando, "email o password errati");
+        *sessione = utente;
+        fprintf(uscita, "OK;accedi;%s\n", campi[0]);
+        return 1;
+    }
+
+    if(strcmp(comando, "esci") == 0){
+        *sessione = NULL;
+        fprintf(uscita, "OK;esci\n");
+        return 1;
+    }
+
+    if(strcmp(comando, "disponibilita") == 0){
+        if(num_campi != 2) return errore_comando(uscita, comando, "uso: disponibilita;inizio;fine");
+        Intervallo intervallo = converti_data_in_intervallo(campi[0], campi[1]);
+        Veicolo *disponibili;
+        unsigned int num_disponibili;
+        EsitoServizio esito = disponibilita(tabella_veicoli, intervallo, &disponibili, &num_disponibili);
+        distruggi_intervallo(intervallo);
+        if(esito != SERVIZIO_OK) return errore_comando(uscita, comando, descrivi_esito_servizio(esito));
+
+        fprintf(uscita, "OK;disponibilita;%u\n", num_disponibili);
+        for(unsigned int i = 0; i < num_disponibili; i++){
+            Veicolo v = disponibili[i];
+            fprintf(uscita, "%s;%s;%s;%s;%.3f\n", ottieni_targa(v), ottieni_modello(v), ottieni_tipo_veicolo(v),
+                    ottieni_posizione(v), ottieni_tariffa(v));
+        }
+        free(disponibili);
+        return 1;
+    }
+
+    // Le operazioni seguenti sono quelle del menu cliente
+    if(strcmp(comando, "prenota") != 0 && strcmp(comando, "cancella") != 0 && strcmp(comando, "modifica") != 0 &&
+       strcmp(comando, "storico") != 0)
+        return errore_comando(uscita, comando, "comando sconosciuto");
+    Utente utente = *sessione;
+    if(utente == NULL || ottieni_permesso(utente) != CLIENTE) return errore_comando(uscita, comando, descrivi_esito_servizio(SERVIZIO_ACCESSO_NEGATO));
+
+    if(strcmp(comando, "storico") == 0){
+        if(num_campi != 0) return errore_comando(uscita, comando, "uso: storico");
+        fprintf(uscita, "OK;storico;%u\n", ottieni_numero_prenotazioni_utente(utente));
+        storico(utente, stampa_prenotazione, uscita);
+        return 1;
+    }
+
+    if(strcmp(comando, "cancella") == 0){
+        if(num_campi != 1) return errore_comando(uscita, comando, "uso: cancella;id");
+        char *fine_id;
+        uint64_t id = (uint64_t)strtoull(campi[0], &fine_id, 10);
+        if(*fine_id != '\0' || id == 0) return errore_comando(uscita, comando, "id non valido");
+
+        EsitoServizio esito = cancella(tabella_utenti, tabella_veicoli, giornale, utente, id);
+        if(esito != SERVIZIO_OK) return errore_comando(uscita, comando, descrivi_esito_servizio(esito));
+        fprintf(uscita, "OK;cancella;%s\n", campi[0]);
+        return 1;
+    }
+
+    if(strcmp(comando, "modifica") == 0){
+        if(num_campi != 3) return errore_comando(uscita, comando, "uso: modifica;id;inizio;fine");
+        char *fine_id;
+        uint64_t id = (uint64_t)strtoull(campi[0], &fine_id, 10);
+        if(*fine_id != '\0' || id == 0) return errore_comando(uscita, comando, "id non valido");
+
+        Intervallo intervallo = converti_data_in_intervallo(campi[1], campi[2]);
+        Preventivo preventivo;
+        EsitoServizio esito = modifica(tabella_utenti, tabella_veicoli, giornale, utente, id, intervallo, &preventivo);
+        distruggi_intervallo(intervallo);
+        if(esito != SERVIZIO_OK) return errore_comando(uscita, comando, descrivi_esito_servizio(esito));
+
+        fprintf(uscita, "OK;modifica;%s;%.2f;%.0f;%.2f\n", campi[0], preventivo.costo, preventivo.sconto * 100,
+                preventivo.costo_scontato);
+        return 1;
+    }
+
+    // prenota
+    if(num_campi != 3) return errore_comando(uscita, comando, "uso: prenota;targa;inizio;fine");
+    Intervallo intervallo = converti_data_in_intervallo(campi[1], campi[2]);
+    Preventivo preventivo;
+    uint64_t id;
+    EsitoServizio esito = prenota(tabella_veicoli, giornale, utente, campi[0], intervallo, &preventivo, &id);
+    distruggi_intervallo(intervallo);
+    if(esito != SERVIZIO_OK) return errore_comando(uscita, comando, descrivi_esito_servizio(esito));
+
+    fprintf(uscita, "OK;prenota;%llu;%s;%.2f;%.0f;%.2f\n", (unsigned long long)id, campi[0],
+            preventivo.costo, preventivo.sconto * 100, preventivo.costo_scontato);
+    return 1;
+}
@@ -1,84 +1,233 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include "utils/gestore_file.h"
+#include "utils/immagine.h"
+#include "utils/parallelo.h"
 #include "modelli/intervallo.h"
 #include "modelli/prenotazione.h"
-#include "strutture_dati/lista.h"
-#include "strutture_dati/lista_prenotazione.h"
 #include "strutture_dati/prenotazioni.h"
+#include "strutture_dati/tabella_utenti.h"
+#include "strutture_dati/tabella_veicoli.h"
 #include "modelli/veicolo.h"
 #include "modelli/data.h"
 #include "modelli/utente.h"
 
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
 #define DIMENSIONE_BUFFER 1024
 
+/*
+ * Formato delle istantanee
+ * ------------------------
+ * Ogni file dell'archivio è un'istantanea leggibile con una sola mappatura in memoria.
+ * Nel formato CAS4, scritto dal salvataggio:
+ *    veicoli, utenti:       [intestazione][num_record record a dimensione fissa][stringhe]
+ *    prenotazioni, storici: [intestazione][flusso compatto][dizionario][stringhe]
+ * La tabella delle stringhe contiene stringhe terminate da '\0' senza ripetizioni; i
+ * campi stringa dei record a dimensione fissa ne sono posizioni. Le prenotazioni di un
+ * veicolo (e lo storico di un utente) sono codificate di seguito nel flusso, a partire
+ * dal byte `prima_prenotazione`, come interi a lunghezza variabile (7 bit per byte,
+ * zigzag per i valori con segno):
+ *    inizio - inizio precedente, fine - inizio, costo, cliente - cliente precedente,
+ *    targa - targa precedente, identificativo - identificativo precedente
+ * dove cliente e targa sono voci del dizionario (il vettore delle posizioni delle
+ * stringhe di quella istantanea) e i valori precedenti valgono 0 all'inizio di ogni
+ * sequenza. Il costo è in centesimi, con il bit meno significativo a 0; se non è
+ * rappresentabile esattamente in centesimi vale 1 ed è seguito dagli 8 byte del double.
+ * L'identificativo è quello della prenotazione (0 se non ne ha uno salvato), così la
+ * prenotazione di un veicolo e quella dello storico del cliente tornano a essere la stessa
+ * dopo il caricamento; l'intestazione riporta l'ultimo identificativo assegnato.
+ * L'intestazione riporta anche la generazione del salvataggio, la stessa nei quattro file
+ * scritti insieme: una coppia di file di generazioni diverse non viene caricata.
+ * Restano leggibili il formato CAS3, uguale ma senza generazione (che vale 0), il formato
+ * CAS2, anche senza identificativi, e il formato CAS1,
+ * con le prenotazioni come record da 32 byte e `prima_prenotazione` indice del primo
+ * record: le loro prenotazioni ricevono identificativi nuovi. Gli interi sono nell'ordine dei byte della
+ * macchina, come nel formato precedente.
+ */
+#define MAGICO_ISTANTANEA 0x31534143u           // "CAS1" letto come intero little-endian
+#define MAGICO_ISTANTANEA_COMPATTA 0x32534143u  // "CAS2"
+#define MAGICO_ISTANTANEA_ID 0x33534143u        // "CAS3"
+#define MAGICO_ISTANTANEA_GENERAZIONE 0x34534143u  // "CAS4"
+#define ISTANTANEA_VEICOLI 1
+#define ISTANTANEA_PRENOTAZIONI 2
+#define ISTANTANEA_UTENTI 3
+#define ISTANTANEA_STORICI 4
+#define CAPACITA_INIZIALE_BLOCCO 4096
+#define CAPACITA_INIZIALE_INDICE 256
+#define DIMENSIONE_USCITA (1u << 20)    // Byte accumulati prima di ogni scrittura su file
+#define MAX_PRENOTAZIONE_COMPATTA 64    // Byte massimi di una prenotazione nel flusso
+#define MAX_COSTO_IN_CENTESIMI 1e15     // Oltre, il costo viene salvato come double
+
+// Nel formato CAS1 l'intestazione termina con `dimensione_stringhe`, nel CAS2 con `dimensione_flusso`,
+// nel CAS3 con `ultimo_id`
+struct intestazione_istantanea {
+    uint32_t magico;
+    uint32_t tipo;
+    uint32_t num_record;
+    uint32_t dimensione_stringhe;
+    uint32_t num_voci;             // voci del dizionario, 0 per veicoli e utenti
+    uint32_t dimensione_flusso;    // byte del flusso compatto, 0 per veicoli e utenti
+    uint64_t ultimo_id;            // identificativo di prenotazione più alto al salvataggio
+    uint64_t generazione;          // salvataggio di cui il file fa parte, uguale nei quattro file
+};
+
+struct record_veicolo {
+    double tariffa;
+    uint32_t tipo, targa, modello, posizione;
+    uint32_t prima_prenotazione, num_prenotazioni;
+};
+
+struct record_prenotazione {
+    int64_t inizio, fine;
+    double costo;
+    uint32_t cliente, targa;
+};
+
+struct record_utente {
+    uint32_t nome, cognome, email;
+    uint32_t prima_prenotazione, num_prenotazioni;
+    uint8_t password[DIMENSIONE_PASSWORD];
+    uint8_t permesso;
+    uint8_t riempimento[3];
+};
+
+// Vista sulle sezioni di un'istantanea mappata: i puntatori sono interni all'immagine
+struct sezioni_istantanea {
+    struct intestazione_istantanea intestazione;
+    Byte compatta;                       // 1 se le prenotazioni sono nel flusso compatto
+    Byte con_id;                         // 1 se il flusso compatto contiene gli identificativi (CAS3, CAS4)
+    const unsigned char *record;         // record a dimensione fissa o flusso compatto
+    const unsigned char *dizionario;     // posizioni delle voci, solo se `compatta`
+    const char *stringhe;
+};
+
+// Lettura delle prenotazioni di una sequenza, con i valori precedenti del flusso compatto
+struct cursore_prenotazioni {
+    const struct sezioni_istantanea *sezioni;
+    size_t posizione;          // indice del record (CAS1) o byte del flusso (CAS2, CAS3)
+    int64_t inizio;
+    uint32_t cliente, targa;
+    uint64_t id;
+};
+
+// Buffer in crescita in cui vengono preparate le sezioni prima della scrittura
+struct blocco {
+    unsigned char *dati;
+    size_t lunghezza;
+    size_t capacita;
+};
+
+// File in scrittura: i record passano da un buffer riutilizzato e raggiungono il file
+// con poche fwrite da DIMENSIONE_USCITA byte, senza tenere in memoria l'intera sezione
+struct uscita {
+    FILE *fp;
+    unsigned char *buffer;
+    size_t lunghezza;
+    Byte errore;
+};
+
+// Lettura sequenziale di un file del formato precedente, interamente in memoria
+struct lettore {
+    const unsigned char *dati;
+    size_t dimensione;
+    size_t posizione;
+};
+
+// Tabella delle stringhe in costruzione, con indice hash per eliminare le ripetizioni
+struct tabella_stringhe {
+    struct blocco testo;
+    uint32_t *indice;          // celle di `passo` interi: posizione + 1 della stringa (0 se la
+                               // cella è libera) e, con il dizionario, la sua voce
+    size_t capacita_indice;
+    size_t num_stringhe;
+    Byte con_dizionario;       // 1 se le stringhe sono numerate, per le prenotazioni compatte
+    struct blocco posizioni;   // posizione nel testo di ogni voce, come uint32_t, se `con_dizionario`
+};
+
+// Prenotazioni di un'istantanea mappata, costruite veicolo per veicolo al primo accesso
+struct archivio_prenotazioni {
+    SorgentePrenotazioni sorgente;     // Deve restare il primo campo
+    Immagine immagine;
+    struct sezioni_istantanea sezioni;
+};
+
+// Storici di un'istantanea mappata, costruiti cliente per cliente al primo accesso
+struct archivio_storici {
+    SorgenteStorico sorgente;          // Deve restare il primo campo
+    Immagine immagine;
+    struct sezioni_istantanea sezioni;
+};
+
+// Tabelle caricate in parallelo da `carica_tabelle`
+struct tabelle_caricate {
+    const char **file_archivio;
+    unsigned int grandezza;
+    TabellaUtenti utenti;
+    TabellaVeicoli veicoli;
+};
+
+// Prenotazioni compatte, scritte man mano sul file, e relative stringhe in costruzione
+struct scrittore_prenotazioni {
+    struct uscita record;
+    struct tabella_stringhe stringhe;
+    uint32_t num_record;
+    size_t dimensione_flusso;  // byte del flusso scritti finora
+    uint32_t ultima_targa;     // voce della targa dell'ultimo record, se num_record > 0
+    uint32_t ultimo_cliente;   // voce del cliente dell'ultimo record, se num_record > 0
+    int64_t inizio_precedente; // valori precedenti della sequenza in corso
+    uint32_t cliente_precedente, targa_precedente;
+    uint64_t id_precedente;
+    Byte errore;
+};
+
 // Dichiarazioni statiche delle funzioni interne (con buffer passato come parametro dove serve)
-static void salva_prenotazione(FILE *fp, Prenotazione prenotazione);
-static Prenotazione carica_prenotazione(FILE *fp, char *buffer_str);
-static void salva_prenotazioni(FILE *fp, Prenotazioni prenotazioni);
-static Prenotazioni carica_prenotazioni(FILE *fp, char *buffer_str);
-static void salva_veicolo(FILE *file_veicolo, FILE *file_prenotazioni, Veicolo v);
-static Veicolo carica_veicolo(FILE *file_veicolo, FILE *file_prenotazioni, char *buffer_str);
-static void salva_data(FILE *file_data, Utente u);
-static void carica_data(Utente u, FILE *file_data, char *buffer_str);
-static void salva_utente(FILE *file_utente, FILE *file_data, Utente u);
-static Utente carica_utente(FILE *file_utente, FILE *file_data, char *buffer_str);
+static Prenotazione carica_prenotazione(struct lettore *fp, char *buffer_str);
+static Prenotazioni carica_prenotazioni(struct lettore *fp, char *buffer_str);
+static void distruggi_vettore_prenotazioni(Prenotazione *vettore, unsigned int n);
+static Prenotazioni costruisci_prenotazioni(Prenotazione *vettore, unsigned int n);
+static Veicolo carica_veicolo(struct lettore *file_veicolo, struct lettore *file_prenotazioni, char *buffer_str);
+static void carica_data(Utente u, struct lettore *file_data, char *buffer_str);
+static Utente carica_utente(struct lettore *file_utente, struct lettore *file_data, char *buffer_str);
+static Veicolo *carica_veicoli_formato_precedente(const char *nome_file_veicolo, const char *nome_file_prenotazioni, unsigned int *num_veicoli);
+static Utente *carica_utenti_formato_precedente(const char *nome_file_utente, const char *nome_file_data, unsigned int *num_utenti);
+
+// Il formato precedente costruisce subito le prenotazioni, che usano pool non condivisibili
+// tra thread: utenti e veicoli in quel formato vengono quindi caricati uno alla volta.
+// Lo stesso mutex protegge il contatore degli identificativi, aggiornato da ogni archivio
+static pthread_mutex_t mutex_formato_precedente = PTHREAD_MUTEX_INITIALIZER;
 
 static uint8_t password_buffer[DIMENSIONE_PASSWORD];
 
-
 /*
- * Autore: Marco Visone
- * Data: 15/05/2025
- *
- * Funzione: salva_prenotazione
- * ----------------------------
- * Salva una singola prenotazione su un file binario.
+ * Funzione: leggi_lettore
+ * -----------------------
+ * Copia in `destinazione` i prossimi `n` byte del lettore e li consuma.
  *
  * Implementazione:
- *    Scrive nel file la lunghezza e il contenuto delle stringhe 'cliente' e 'targa',
- *    il costo della prenotazione e gli orari di inizio e fine dell'intervallo.
- *
- * Parametri:
- *    fp: puntatore al file su cui salvare la prenotazione
- *    prenotazione: la prenotazione da salvare
- *
- * Pre-condizioni:
- *    fp: non deve essere NULL
- *    prenotazione: non deve essere NULL
- *
- * Post-condizioni:
- *    non restituisce niente
+ *    Il file è già in memoria (apri_immagine), quindi ogni campo costa una memcpy
+ *    invece di una fread.
  *
- * Side-effect:
- *    La prenotazione viene scritta nel file.
+ * Ritorna:
+ *    1 in caso di successo, 0 se il file ha meno di `n` byte rimasti
  */
-static void salva_prenotazione(FILE *fp, Prenotazione prenotazione){
-    if(fp == NULL || prenotazione == NULL) return;
-
-    const char *cliente = ottieni_cliente_prenotazione(prenotazione);
-    if(cliente == NULL) return;
-    unsigned int len = (unsigned int)strlen(cliente) + 1;
-    fwrite(&len, sizeof(len), 1, fp);
-    fwrite(cliente, sizeof(char), len, fp);
+static Byte leggi_lettore(struct lettore *lettore, void *destinazione, size_t n){
+    if(n > lettore->dimensione - lettore->posizione) return 0;
 
-    const char *targa = ottieni_veicolo_prenotazione(prenotazione);
-    if(targa == NULL) return;
-    len = strlen(targa) + 1;
-    fwrite(&len, sizeof(len), 1, fp);
-    fwrite(targa, sizeof(char), len, fp);
-
-    double costo = ottieni_costo_prenotazione(prenotazione);
-    fwrite(&costo, sizeof(costo), 1, fp);
-
-    Intervallo iv = ottieni_intervallo_prenotazione(prenotazione);
-    if(iv == NULL) return;
-
-    time_t inizio = inizio_intervallo(iv);
-    time_t fine = fine_intervallo(iv);
-    fwrite(&inizio, sizeof(inizio), 1, fp);
-    fwrite(&fine, sizeof(fine), 1, fp);
+    memcpy(destinazione, lettore->dati + lettore->posizione, n);
+    lettore->posizione += n;
+    return 1;
 }
 
 /*
@@ -95,7 +244,7 @@ static void salva_prenotazione(FILE *fp, Prenotazione prenotazione){
  *    ricostruendo l'oggetto Prenotazione.
  *
  * Parametri:
- *    fp: puntatore al file da cui caricare la prenotazione
+ *    fp: lettore del file da cui caricare la prenotazione
  *    buffer_str: buffer temporaneo per le stringhe
  *
  * Pre-condizioni:
@@ -108,37 +257,34 @@ static void salva_prenotazione(FILE *fp, Prenotazione prenotazione){
  * Ritorna:
  *    un puntatore alla struttura prenotazione o NULL
  */
-static Prenotazione carica_prenotazione(FILE *fp, char *buffer_str){
+static Prenotazione carica_prenotazione(struct lettore *fp, char *buffer_str){
     if(fp == NULL || buffer_str == NULL) return NULL;
 
     Prenotazione p = crea_prenotazione(NULL, NULL, NULL, 0);
     if (p == NULL) return NULL;
 
     unsigned int len;
-    size_t n_read;
     Intervallo i = NULL;
 
      // Legge cliente
-    if(fread(&len, sizeof(len), 1, fp) != 1) goto errore;
+    if(!leggi_lettore(fp, &len, sizeof(len))) goto errore;
     if (len == 0 || len > DIMENSIONE_BUFFER) goto errore;
-    n_read = fread(buffer_str, sizeof(char), len, fp);
-    if (n_read != len) goto errore;
+    if (!leggi_lettore(fp, buffer_str, len)) goto errore;
     imposta_cliente_prenotazione(p, buffer_str);
 
      // Legge targa
-    if(fread(&len, sizeof(len), 1, fp) != 1) goto errore;
+    if(!leggi_lettore(fp, &len, sizeof(len))) goto errore;
     if (len == 0 || len > DIMENSIONE_BUFFER) goto errore;
-    n_read = fread(buffer_str, sizeof(char), len, fp);
-    if (n_read != len) goto errore;
+    if (!leggi_lettore(fp, buffer_str, len)) goto errore;
     imposta_veicolo_prenotazione(p, buffer_str);
      // Legge costo
     double costo;
-    if(fread(&costo, sizeof(costo), 1, fp) != 1) goto errore;
+    if(!leggi_lettore(fp, &costo, sizeof(costo))) goto errore;
     imposta_costo_prenotazione(p, costo);
     // Legge intervallo
     time_t inizio, fine;
-    if(fread(&inizio, sizeof(inizio), 1, fp) != 1 ||
-        fread(&fine, sizeof(fine), 1, fp) != 1) goto errore;
+    if(!leggi_lettore(fp, &inizio, sizeof(inizio)) ||
+        !leggi_lettore(fp, &fine, sizeof(fine))) goto errore;
 
     i = crea_intervallo(inizio, fine);
     if(i == NULL) goto errore;
@@ -154,49 +300,30 @@ static Prenotazione carica_prenotazione(FILE *fp, char *buffer_str){
 
 
 /*
- * Autore: Marco Visone
- * Data: 15/05/2025
- *
- * Funzione: salva_prenotazioni
- * ----------------------------
- * Salva tutte le prenotazioni di una struttura Prenotazioni su un file binario.
+ * Funzione: distruggi_vettore_prenotazioni
+ * ----------------------------------------
+ * Distrugge le prenotazioni contenute in un vettore, senza liberare il vettore stesso.
  *
  * Implementazione:
- *    Ottiene un vettore delle prenotazioni dall'albero, scrive la dimensione del vettore,
- *    e poi cicla salvando ogni singola prenotazione.
+ *    Chiama `distruggi_prenotazione` sui primi `n` elementi.
  *
  * Parametri:
- *    fp: puntatore al file su cui salvare le prenotazioni
- *    prenotazioni: la struttura Prenotazioni da salvare
+ *    vettore: il vettore di prenotazioni
+ *    n: il numero di prenotazioni da distruggere
  *
  * Pre-condizioni:
- *    fp: non deve essere NULL
- *    prenotazioni: non deve essere NULL
+ *    vettore: può essere NULL
  *
  * Post-condizioni:
  *    non restituisce niente
  *
  * Side-effect:
- *    Tutte le prenotazioni vengono scritte nel file
+ *    Libera la memoria delle prenotazioni; il vettore resta del chiamante.
  */
-static void salva_prenotazioni(FILE *fp, Prenotazioni prenotazioni) {
-    if (fp == NULL || prenotazioni == NULL) return;
-    unsigned int size = 0, i;
-    Prenotazione *p = ottieni_vettore_prenotazioni_per_file(prenotazioni, &size);
-    if (p == NULL) {
-        // Se non ci sono prenotazioni, scrive 0
-        fwrite(&size, sizeof(size), 1, fp);
-        return;
-    }
-
-    fwrite(&size, sizeof(size), 1, fp);
-
-    for (i = 0; i < size; i++) {
-        salva_prenotazione(fp, p[i]);
-        distruggi_prenotazione(p[i]);
-    }
-
-    free(p);
+static void distruggi_vettore_prenotazioni(Prenotazione *vettore, unsigned int n) {
+    if (vettore == NULL) return;
+    unsigned int i;
+    for (i = 0; i < n; i++) distruggi_prenotazione(vettore[i]);
 }
 
 /*
@@ -208,11 +335,11 @@ static void salva_prenotazioni(FILE *fp, Prenotazioni prenotazioni) {
  * Carica tutte le prenotazioni da un file binario e le inserisce in una nuova struttura Prenotazioni.
  *
  * Implementazione:
- *    Legge la dimensione del set di prenotazioni, crea una nuova struttura Prenotazioni,
- *    e poi cicla caricando ogni singola prenotazione e aggiungendola alla struttura.
+ *    Legge la dimensione del set di prenotazioni, carica tutte le prenotazioni in un vettore
+ *    e costruisce la struttura con `costruisci_prenotazioni`.
  *
  * Parametri:
- *    fp: puntatore al file da cui caricare le prenotazioni
+ *    fp: lettore del file da cui caricare le prenotazioni
  *    buffer_str: buffer temporaneo per le stringhe
  *
  * Pre-condizioni:
@@ -225,88 +352,83 @@ static void salva_prenotazioni(FILE *fp, Prenotazioni prenotazioni) {
  * Ritorna:
  *    un puntatore alla struttura prenotazioni o NULL
  */
-static Prenotazioni carica_prenotazioni(FILE *fp, char *buffer_str) {
+static Prenotazioni carica_prenotazioni(struct lettore *fp, char *buffer_str) {
     if (fp == NULL || buffer_str == NULL) return NULL;
     unsigned int size = 0, i;
-    if (fread(&size, sizeof size, 1, fp) != 1) return NULL;
+    if (!leggi_lettore(fp, &size, sizeof size)) return NULL;
 
-    Prenotazioni pren = crea_prenotazioni();
-    if (pren == NULL) return NULL; // Controllo allocazione
+    if (size == 0) return crea_prenotazioni();
+
+    Prenotazione *vettore = malloc(sizeof(Prenotazione) * size);
+    if (vettore == NULL) return NULL; // Controllo allocazione
 
     for (i = 0; i < size; i++) {
-        Prenotazione p_caricata = carica_prenotazione(fp, buffer_str);
-        if (p_caricata == NULL) {
-            distruggi_prenotazioni(pren); // Libera le prenotazioni già aggiunte
-            return NULL;
-        }
-        if(!aggiungi_prenotazione(pren, p_caricata)) {
-            distruggi_prenotazione(p_caricata);
-            distruggi_prenotazioni(pren);
+        vettore[i] = carica_prenotazione(fp, buffer_str);
+        if (vettore[i] == NULL) {
+            distruggi_vettore_prenotazioni(vettore, i); // Libera le prenotazioni già lette
+            free(vettore);
             return NULL;
         }
     }
-    return pren;
+
+    return costruisci_prenotazioni(vettore, size);
 }
 
 /*
- * Autore: Russo Nello Manuel
- * Data: 18/05/2025
- *
- * Funzione: salva_veicolo
- * -----------------------
- *
- * salva le informazioni di un singolo veicolo su un file binario, includendo anche le sue prenotazioni
+ * Funzione: costruisci_prenotazioni
+ * ---------------------------------
+ * Costruisce una struttura Prenotazioni a partire da un vettore di prenotazioni.
  *
  * Implementazione:
- *    - Scrive nel file file_veicolo i seguenti campi, ciascuno preceduto dalla sua lunghezza:
- *    - tipo del veicolo, targa, modello, posizione, tariffa
- *    - Le prenotazioni associate vengono salvate nel file file_prenotazioni tramite la funzione salva_prenotazioni
+ *    Se il vettore è ordinato e privo di sovrapposizioni (file scritti in ordine)
+ *    l'albero viene costruito in tempo lineare con `crea_prenotazioni_da_vettore`.
+ *    Altrimenti (file salvati nel vecchio formato in ordine di livello) crea una nuova
+ *    struttura Prenotazioni e aggiunge le prenotazioni una alla volta.
  *
  * Parametri:
- *    file_veicolo: puntatore a FILE aperto in modalità scrittura binaria, destinato ai dati del veicolo
- *    file_prenotazioni: puntatore a FILE aperto in modalità scrittura binaria, destinato alle prenotazioni
- *    v: veicolo da salvare
+ *    vettore: vettore allocato dinamicamente di prenotazioni
+ *    n: numero di prenotazioni nel vettore
  *
  * Pre-condizioni:
- *    file_veicolo: deve essere diverso da NULL
- *    file_prenotazioni: deve essere diverso da NULL
- *    v: deve essere diverso da NULL
+ *    vettore: non deve essere NULL, n maggiore di 0
  *
  * Post-condizioni:
- *    non restituisce niente
+ *    Restituisce una nuova struttura Prenotazioni, o NULL in caso di errore.
+ *
+ * Ritorna:
+ *    un puntatore alla struttura prenotazioni o NULL
  *
  * Side-effect:
- *    - I dati del veicolo vengono scritti nel file file_veicolo
- *    - Le prenotazioni vengono scritte nel file file_prenotazioni
+ *    Libera il vettore; le prenotazioni passano alla struttura, o vengono distrutte in caso di errore.
  */
-static void salva_veicolo(FILE *file_veicolo, FILE *file_prenotazioni, Veicolo v){
-	if (file_veicolo == NULL || v == NULL || file_prenotazioni == NULL) return;
-
-    // Utilizzo di const char* per i getter
-    const char *tipo_veicolo = ottieni_tipo_veicolo(v);
-	unsigned int len = strlen(tipo_veicolo)+1;
-    fwrite(&len, sizeof(unsigned int), 1, file_veicolo);
-    fwrite(tipo_veicolo, sizeof(char), len, file_veicolo);
-
-    const char *targa = ottieni_targa(v);
-    len = strlen(targa)+1;
-    fwrite(&len, sizeof(unsigned int), 1, file_veicolo);
-    fwrite(targa, sizeof(char), len, file_veicolo);
-
-    const char *modello = ottieni_modello(v);
-    len = strlen(modello)+1;
-    fwrite(&len, sizeof(unsigned int), 1, file_veicolo);
-    fwrite(modello, sizeof(char), len, file_veicolo);
-
-    const char *posizione = ottieni_posizione(v);
-    len = strlen(posizione) + 1;
-    fwrite(&len, sizeof(unsigned int), 1, file_veicolo);
-    fwrite(posizione, sizeof(char), len, file_veicolo);
+static Prenotazioni costruisci_prenotazioni(Prenotazione *vettore, unsigned int n) {
+    unsigned int i;
+
+    // Caso comune: prenotazioni salvate in ordine, costruzione in blocco
+    Prenotazioni pren = crea_prenotazioni_da_vettore(vettore, n);
+    if (pren != NULL) {
+        free(vettore);
+        return pren;
+    }
 
-	double tariffa = ottieni_tariffa(v);
-	fwrite(&tariffa, sizeof(tariffa), 1, file_veicolo);
+    // Vecchio formato (ordine di livello): inserimento una alla volta
+    pren = crea_prenotazioni();
+    if (pren == NULL) {
+        distruggi_vettore_prenotazioni(vettore, n);
+        free(vettore);
+        return NULL;
+    }
 
-	salva_prenotazioni(file_prenotazioni, ottieni_prenotazioni(v));
+    for (i = 0; i < n; i++) {
+        if(!aggiungi_prenotazione(pren, vettore[i])) {
+            distruggi_vettore_prenotazioni(vettore + i, n - i);
+            free(vettore);
+            distruggi_prenotazioni(pren);
+            return NULL;
+        }
+    }
+    free(vettore);
+    return pren;
 }
 
 /*
@@ -325,8 +447,8 @@ static void salva_veicolo(FILE *file_veicolo, FILE *file_prenotazioni, Veicolo v
  *    - Crea il veicolo con i dati letti e lo restituisce.
  *
  * Parametri:
- *    file_veicolo: file binario da cui leggere i dati del veicolo
- *    file_prenotazioni: file binario da cui leggere le prenotazioni associate al veicolo
+ *    file_veicolo: lettore del file binario da cui leggere i dati del veicolo
+ *    file_prenotazioni: lettore del file binario da cui leggere le prenotazioni associate al veicolo
  *    buffer_str: buffer temporaneo per le stringhe
  *
  * Pre-condizioni:
@@ -343,7 +465,7 @@ static void salva_veicolo(FILE *file_veicolo, FILE *file_prenotazioni, Veicolo v
  * Side-effect:
  *    Alloca memoria dinamicamente per le stringhe temporanee (poi liberate), e per un nuovo oggetto Veicolo
  */
-static Veicolo carica_veicolo(FILE *file_veicolo, FILE *file_prenotazioni, char *buffer_str){
+static Veicolo carica_veicolo(struct lettore *file_veicolo, struct lettore *file_prenotazioni, char *buffer_str){
 	if (file_veicolo == NULL || file_prenotazioni == NULL || buffer_str == NULL) return NULL;
 
     char *tipo_veicolo = NULL;
@@ -354,39 +476,34 @@ static Veicolo carica_veicolo(FILE *file_veicolo, FILE *file_prenotazioni, char
     Veicolo v = NULL;
 
     unsigned int len;
-    size_t n_read;
 
     // Legge tipo veicolo
-    if (fread(&len, sizeof(unsigned int), 1, file_veicolo) != 1 || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
+    if (!leggi_lettore(file_veicolo, &len, sizeof(unsigned int)) || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
     tipo_veicolo = malloc(sizeof(char) * len);
     if (tipo_veicolo == NULL) goto errore;
-    n_read = fread(tipo_veicolo, sizeof(char), len, file_veicolo);
-    if (n_read != len) goto errore;
+    if (!leggi_lettore(file_veicolo, tipo_veicolo, len)) goto errore;
 
     // Legge targa veicolo
-    if (fread(&len, sizeof(unsigned int), 1, file_veicolo) != 1 || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
+    if (!leggi_lettore(file_veicolo, &len, sizeof(unsigned int)) || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
     targa_veicolo = malloc(sizeof(char) * len);
     if (targa_veicolo == NULL) goto errore;
-    n_read = fread(targa_veicolo, sizeof(char), len, file_veicolo);
-    if (n_read != len) goto errore;
+    if (!leggi_lettore(file_veicolo, targa_veicolo, len)) goto errore;
 
     // Legge modello veicolo
-    if (fread(&len, sizeof(unsigned int), 1, file_veicolo) != 1 || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
+    if (!leggi_lettore(file_veicolo, &len, sizeof(unsigned int)) || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
     modello_veicolo = malloc(sizeof(char) * len);
     if (modello_veicolo == NULL) goto errore;
-    n_read = fread(modello_veicolo, sizeof(char), len, file_veicolo);
-    if (n_read != len) goto errore;
+    if (!leggi_lettore(file_veicolo, modello_veicolo, len)) goto errore;
 
     // Legge posizione veicolo
-    if (fread(&len, sizeof(unsigned int), 1, file_veicolo) != 1 || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
+    if (!leggi_lettore(file_veicolo, &len, sizeof(unsigned int)) || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
     posizione_veicolo = malloc(sizeof(char) * len);
     if (posizione_veicolo == NULL) goto errore;
-    n_read = fread(posizione_veicolo, sizeof(char), len, file_veicolo);
-    if (n_read != len) goto errore;
+    if (!leggi_lettore(file_veicolo, posizione_veicolo, len)) goto errore;
 
     // Legge tariffa
 	double tariffa;
-	if (fread(&tariffa, sizeof(tariffa), 1, file_veicolo) != 1) goto errore;
+	if (!leggi_lettore(file_veicolo, &tariffa, sizeof(tariffa))) goto errore;
 
     // Carica prenotazioni
 	p_veicolo = carica_prenotazioni(file_prenotazioni, buffer_str);
@@ -417,72 +534,15 @@ errore:
  * Autore: Russo Nello Manuel
  * Data: 18/05/2025
  *
- * Funzione: salva_vettore_veicoli
- * -------------------------------
- *
- * salva su un file binario un vettore di veicoli e su un altro le relative prenotazioni
- *
- * Implementazione:
- *    - Apre due file binari in modalità scrittura:
- *    - uno per i dati dei veicoli, nome_file_veicolo
- *    - uno per le prenotazioni associate, nome_file_prenotazioni
- *    - Scrive nel file dei veicoli il numero totale di veicoli da salvare
- *    - Per ogni veicolo nel vettore, chiama la funzione salva_veicolo
- *    che scrive i dati nei rispettivi file
- *    - Chiude entrambi i file al termine
- *
- * Parametri:
- *    nome_file_veicolo: file in cui salvare i dati dei veicoli
- *    nome_file_prenotazioni: file in cui salvare le prenotazioni
- *    vettore: array di veicoli da salvare
- *    num_veicoli: numero di elementi nel vettore
- *
- * Pre-condizioni:
- *    nome_file_veicolo: deve essere diverso da NULL
- *    nome_file_prenotazioni: deve essere diverso da NULL
- *    vettore: deve essere diverso da NULL
- *    num_veicoli: deve essere diverso di 0
- *
- * Post-condizioni:
- *    non restituisce niente
- *
- * Side-effect:
- *    i dati dei veicoli e delle relative prenotazioni vengono scritti
- *    nei file specificati in formato binario
- */
-void salva_vettore_veicoli(const char *nome_file_veicolo, const char *nome_file_prenotazioni, Veicolo vettore[], unsigned int num_veicoli){
-	if(nome_file_veicolo == NULL || nome_file_prenotazioni == NULL || vettore == NULL || num_veicoli == 0) return; // !num_veicoli è corretto, ma num_veicoli == 0 è più esplicito
-
-	FILE *file_veicolo = fopen(nome_file_veicolo, "wb");
-    if (file_veicolo == NULL) return;
-
-    FILE *file_prenotazioni = fopen(nome_file_prenotazioni, "wb");
-    if (file_prenotazioni == NULL){
-        fclose(file_veicolo);
-        return;
-    }
-
-    fwrite(&num_veicoli, sizeof(unsigned int), 1, file_veicolo);
-
-    for (unsigned i = 0; i < num_veicoli; i++){
-        salva_veicolo(file_veicolo, file_prenotazioni, vettore[i]);
-    }
-
-    fclose(file_veicolo);
-    fclose(file_prenotazioni);
-}
-
-/*
- * Autore: Russo Nello Manuel
- * Data: 18/05/2025
- *
- * Funzione: carica_vettore_veicoli
- * --------------------------------
+ * Funzione: carica_veicoli_formato_precedente
+ * -------------------------------------------
  *
- * carica un insieme di veicoli da un file binario e le relative prenotazioni da un secondo file binario
+ * carica un insieme di veicoli da un file binario e le relative prenotazioni da un secondo file binario,
+ * scritti nel formato a campi con lunghezza usato prima delle istantanee
  *
  * Implementazione:
- *    - Apre due file binari in lettura: uno per i veicoli e uno per le prenotazioni
+ *    - Porta in memoria con apri_immagine i due file binari, uno per i veicoli e uno
+ *    per le prenotazioni, e li legge in sequenza con due lettori
  *    - Legge il numero totale di veicoli da caricare dal file dei veicoli
  *    - Alloca dinamicamente un array di puntatori a Veicolo
  *    - Per ogni veicolo, richiama la funzione carica_veicolo per leggere i dati e le prenotazioni
@@ -506,40 +566,25 @@ void salva_vettore_veicoli(const char *nome_file_veicolo, const char *nome_file_
  * Side-effect:
  *    Alloca memoria dinamicamente per il vettore restituito (va liberata dal chiamante)
  */
-Veicolo *carica_vettore_veicoli(const char *nome_file_veicolo, const char *nome_file_prenotazioni, unsigned int *num_veicoli){
+static Veicolo *carica_veicoli_formato_precedente(const char *nome_file_veicolo, const char *nome_file_prenotazioni, unsigned int *num_veicoli){
 	if(nome_file_veicolo == NULL || nome_file_prenotazioni == NULL || num_veicoli == NULL) return NULL;
 
-	FILE *file_veicolo = fopen(nome_file_veicolo, "rb");
-    if (file_veicolo == NULL) return NULL;
-
+    Immagine immagine_veicoli = apri_immagine(nome_file_veicolo);
+    Immagine immagine_prenotazioni = apri_immagine(nome_file_prenotazioni);
     char *buffer_local = calloc(DIMENSIONE_BUFFER, sizeof(char)); // Buffer locale
-    if(buffer_local == NULL){
-        fclose(file_veicolo);
-        return NULL;
-    }
+    Veicolo *vettore = NULL;
+    if(immagine_veicoli == NULL || immagine_prenotazioni == NULL || buffer_local == NULL) goto fine;
 
-    FILE *file_prenotazioni = fopen(nome_file_prenotazioni, "rb");
-    if (file_prenotazioni == NULL){
-        fclose(file_veicolo);
-        free(buffer_local); // Libera il buffer locale in caso di fallimento
-        return NULL;
-    }
+    struct lettore lettore_veicoli = {dati_immagine(immagine_veicoli), dimensione_immagine(immagine_veicoli), 0};
+    struct lettore lettore_prenotazioni = {dati_immagine(immagine_prenotazioni), dimensione_immagine(immagine_prenotazioni), 0};
+    struct lettore *file_veicolo = &lettore_veicoli;
+    struct lettore *file_prenotazioni = &lettore_prenotazioni;
 
     // Legge il numero di veicoli
-    if (fread(num_veicoli, sizeof(unsigned int), 1, file_veicolo) != 1) {
-        fclose(file_veicolo);
-        fclose(file_prenotazioni);
-        free(buffer_local);
-        return NULL;
-    }
+    if (!leggi_lettore(file_veicolo, num_veicoli, sizeof(unsigned int))) goto fine;
 
-    Veicolo *vettore = malloc(sizeof(Veicolo) * (*num_veicoli));
-    if(vettore == NULL) {
-        fclose(file_veicolo);
-        fclose(file_prenotazioni);
-        free(buffer_local);
-        return NULL;
-    }
+    vettore = malloc(sizeof(Veicolo) * (*num_veicoli));
+    if(vettore == NULL) goto fine;
 
     for (unsigned i = 0; i < *num_veicoli; i++){
         vettore[i] = carica_veicolo(file_veicolo, file_prenotazioni, buffer_local); // Passa il buffer
@@ -549,67 +594,20 @@ Veicolo *carica_vettore_veicoli(const char *nome_file_veicolo, const char *nome_
                 distruggi_veicolo(vettore[j]);
             }
             free(vettore);
-            fclose(file_veicolo);
-            fclose(file_prenotazioni);
-            free(buffer_local);
+            vettore = NULL;
             *num_veicoli = 0;
-            return NULL;
+            break;
         }
     }
 
-    fclose(file_veicolo);
-    fclose(file_prenotazioni);
+fine:
+    chiudi_immagine(immagine_veicoli);
+    chiudi_immagine(immagine_prenotazioni);
     free(buffer_local); // Libera il buffer locale
 
     return vettore;
 }
 
-/*
- * Funzione: salva_data
- * --------------------
- *
- * Salva su file le informazioni della struttura Data.
- *
- * Implementazione:
- *    Scrive su file il numero di prenotazioni e l'intero storico
- *    delle prenotazioni contenuto nella struttura Data.
- *
- * Parametri:
- *    file_data: puntatore al file su cui salvare i dati
- *    d: struttura Data da salvare
- *
- * Pre-condizione:
- *    file_data: non deve essere NULL
- *    u: non deve essere NULL
- *
- * Post-condizione:
- *    non restituisce niente
- *
- * Side-effect:
- *    i dati della struttura sono scritti nel file
- */
-static void salva_data(FILE *file_data, Utente u){
-    if(file_data == NULL || u == NULL){
-        return;
-    }
-
-    // Ottieni la lista e il numero di prenotazioni prima di scriverli
-    ListaPre lista_prenotazioni = ottieni_storico_utente(u);
-    unsigned int numero_prenotazioni = ottieni_numero_prenotazioni_utente(u);
-
-    fwrite(&numero_prenotazioni, sizeof(numero_prenotazioni), 1, file_data);
-
-    // Iterare sulla lista originale senza modificarla
-    ListaPre curr = lista_prenotazioni;
-    for(unsigned int i = 0; curr && (i < numero_prenotazioni); i++){
-        salva_prenotazione(file_data, (Prenotazione)ottieni_item(curr));
-        curr = ottieni_prossimo(curr);
-    }
-
-    distruggi_lista_prenotazione(lista_prenotazioni);
-
-}
-
 /*
  * Funzione: carica_data
  * ---------------------
@@ -621,7 +619,7 @@ static void salva_data(FILE *file_data, Utente u){
  *    lo storico delle prenotazioni. Restituisce una nuova struttura Data.
  *
  * Parametri:
- *    file_data: puntatore al file da cui leggere i dati
+ *    file_data: lettore del file da cui leggere i dati
  *    buffer_str: buffer temporaneo per le stringhe
  *
  * Pre-condizione:
@@ -635,7 +633,7 @@ static void salva_data(FILE *file_data, Utente u){
  * Side-effect:
  *    lettura da file, allocazione dinamica
  */
-static void carica_data(Utente u, FILE *file_data, char *buffer_str){
+static void carica_data(Utente u, struct lettore *file_data, char *buffer_str){
     if(file_data == NULL || buffer_str == NULL || u == NULL){
         return;
     }
@@ -645,7 +643,7 @@ static void carica_data(Utente u, FILE *file_data, char *buffer_str){
     }
 
     unsigned int numero_prenotazioni;
-    if (fread(&numero_prenotazioni, sizeof(numero_prenotazioni), 1, file_data) != 1) {
+    if (!leggi_lettore(file_data, &numero_prenotazioni, sizeof(numero_prenotazioni))) {
         return;
     }
 
@@ -662,63 +660,6 @@ static void carica_data(Utente u, FILE *file_data, char *buffer_str){
     }
 }
 
-/*
- * Funzione: salva_utente
- * ----------------------
- *
- * Salva le informazioni di un utente su due file distinti: uno per l'anagrafica,
- * uno per i dati associati.
- *
- * Implementazione:
- *    Scrive nome, cognome, email, password, permesso e chiama salva_data
- *    per salvare la struttura Data.
- *
- * Parametri:
- *    file_utente: file su cui scrivere i dati dell'utente
- *    file_data: file su cui scrivere i dati storici dell'utente
- *    u: utente da salvare
- *
- * Pre-condizione:
- *    file_utente: non deve essere NULL
- *    u: non deve essere NULL
- *    file_data: non deve essere NULL
- *
- * Post-condizione:
- *    non restituisce niente
- *
- * Side-effect:
- *    i dati dell'utente sono salvati nei file
- */
-static void salva_utente(FILE *file_utente, FILE *file_data, Utente u){
-    if (file_utente == NULL || u == NULL) return;
-
-    // Utilizzo di const char* per i getter
-    const char *nome = ottieni_nome(u);
-    unsigned int len = strlen(nome)+1;
-    fwrite(&len, sizeof(unsigned int), 1, file_utente);
-    fwrite(nome, sizeof(char), len, file_utente);
-
-    const char *cognome = ottieni_cognome(u);
-    len = strlen(cognome)+1;
-    fwrite(&len, sizeof(unsigned int), 1, file_utente);
-    fwrite(cognome, sizeof(char), len, file_utente);
-
-    const char *email = ottieni_email(u);
-    len = strlen(email) + 1;
-    fwrite(&len, sizeof(unsigned int), 1, file_utente);
-    fwrite(email, sizeof(char), len, file_utente);
-
-    const uint8_t *password = ottieni_password(u);
-    fwrite(password, sizeof(uint8_t), DIMENSIONE_PASSWORD, file_utente);
-
-    Byte permesso = ottieni_permesso(u);
-    fwrite(&permesso, sizeof(Byte), 1, file_utente);
-
-    if (permesso == CLIENTE) { // Salva lo storico solo se l'utente è un CLIENTE
-        salva_data(file_data, u);
-    }
-}
-
 /*
  * Funzione: carica_utente
  * -----------------------
@@ -730,8 +671,8 @@ static void salva_utente(FILE *file_utente, FILE *file_data, Utente u){
  *    anche la struttura Data associata.
  *
  * Parametri:
- *    file_utente: file da cui leggere i dati dell'utente
- *    file_data: file da cui leggere i dati storici
+ *    file_utente: lettore del file da cui leggere i dati dell'utente
+ *    file_data: lettore del file da cui leggere i dati storici
  *    buffer_str: buffer temporaneo per le stringhe
  *
  * Pre-condizione:
@@ -748,42 +689,38 @@ static void salva_utente(FILE *file_utente, FILE *file_data, Utente u){
  * Side-effect:
  *    lettura da file, allocazione dinamica di memoria
  */
-static Utente carica_utente(FILE *file_utente, FILE *file_data, char *buffer_str) {
+static Utente carica_utente(struct lettore *file_utente, struct lettore *file_data, char *buffer_str) {
     if (!file_utente || !buffer_str) return NULL;
     Utente u = crea_utente(NULL, NULL, NULL, NULL, ADMIN);
     if (!u) return NULL;
 
     unsigned int len;
     Byte permesso;
-    size_t n;
 
     // ---- NOME ----
-    if (fread(&len, sizeof(len), 1, file_utente) != 1 || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
-    n = fread(buffer_str, sizeof(char), len, file_utente);
-    if (n != len) goto errore;
+    if (!leggi_lettore(file_utente, &len, sizeof(len)) || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
+    if (!leggi_lettore(file_utente, buffer_str, len)) goto errore;
     buffer_str[len-1] = '\0';
     imposta_nome(u, buffer_str);
 
     // ---- COGNOME ----
-    if (fread(&len, sizeof(len), 1, file_utente) != 1 || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
-    n = fread(buffer_str, sizeof(char), len, file_utente);
-    if (n != len) goto errore;
+    if (!leggi_lettore(file_utente, &len, sizeof(len)) || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
+    if (!leggi_lettore(file_utente, buffer_str, len)) goto errore;
     buffer_str[len-1] = '\0';
     imposta_cognome(u, buffer_str);
 
     // ---- EMAIL ----
-    if (fread(&len, sizeof(len), 1, file_utente) != 1 || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
-    n = fread(buffer_str, sizeof(char), len, file_utente);
-    if (n != len) goto errore;
+    if (!leggi_lettore(file_utente, &len, sizeof(len)) || len == 0 || len > DIMENSIONE_BUFFER) goto errore;
+    if (!leggi_lettore(file_utente, buffer_str, len)) goto errore;
     buffer_str[len-1] = '\0';
     imposta_email(u, buffer_str);
 
     // ---- PASSWORD ----
-    if (fread(password_buffer, sizeof(uint8_t), DIMENSIONE_PASSWORD, file_utente) != DIMENSIONE_PASSWORD) goto errore;
+    if (!leggi_lettore(file_utente, password_buffer, DIMENSIONE_PASSWORD)) goto errore;
     imposta_password(u, password_buffer);
 
     // ---- PERMESSO ----
-    if (fread(&permesso, sizeof(permesso), 1, file_utente) != 1) goto errore;
+    if (!leggi_lettore(file_utente, &permesso, sizeof(permesso))) goto errore;
     imposta_permesso(u, permesso);
 
     // ---- DATA (solo se cliente) ----
@@ -800,61 +737,15 @@ static Utente carica_utente(FILE *file_utente, FILE *file_data, char *buffer_str
 
 
 /*
- * Funzione: salva_vettore_utenti
- * ------------------------------
- *
- * Salva un array di utenti su due file: uno per l'anagrafica, uno per i dati.
- *
- * Implementazione:
- *    Apre due file, scrive il numero di utenti e salva ciascun utente.
- *
- * Parametri:
- *    nome_file_utente: nome del file per l'anagrafica
- *    nome_file_data: nome del file per i dati storici
- *    vettore: array di puntatori a Utente
- *    num_utenti: numero di utenti nell'array
- *
- * Pre-condizione:
- *    nome_file_utente: non deve essere NULL
- *    nome_file_data: non deve essere NULL
- *    vettore: non deve essere NULL
- *
- * Post-condizione:
- *    non restituisce niente
- *
- * Side-effect:
- *    i dati degli utenti sono scritti nei file
- */
-void salva_vettore_utenti(const char *nome_file_utente, const char *nome_file_data, Utente vettore[], unsigned int num_utenti){
-    if(nome_file_utente == NULL || nome_file_data == NULL || vettore == NULL || num_utenti == 0) return;
-
-    FILE *file_utente = fopen(nome_file_utente, "wb");
-    if (file_utente == NULL) return;
-
-    FILE *file_data = fopen(nome_file_data, "wb");
-    if (file_data == NULL){
-        fclose(file_utente);
-        return;
-    }
-
-    fwrite(&num_utenti, sizeof(unsigned int), 1, file_utente);
-
-    for (unsigned int i = 0; i < num_utenti; i++){
-        salva_utente(file_utente, file_data, vettore[i]);
-    }
-
-    fclose(file_utente);
-    fclose(file_data);
-}
-
-/*
- * Funzione: carica_vettore_utenti
- * -------------------------------
+ * Funzione: carica_utenti_formato_precedente
+ * ------------------------------------------
  *
- * Carica da due file un array di utenti.
+ * Carica da due file un array di utenti, scritti nel formato a campi con lunghezza
+ * usato prima delle istantanee.
  *
  * Implementazione:
- *    Apre i file, legge il numero di utenti e chiama carica_utente per ognuno.
+ *    Porta in memoria i due file con apri_immagine, legge il numero di utenti e
+ *    chiama carica_utente per ognuno.
  *
  * Parametri:
  *    nome_file_utente: nome del file contenente i dati anagrafici
@@ -875,40 +766,25 @@ void salva_vettore_utenti(const char *nome_file_utente, const char *nome_file_da
  * Side-effect:
  *    lettura da file, allocazione dinamica di memoria
  */
-Utente *carica_vettore_utenti(const char *nome_file_utente, const char *nome_file_data, unsigned int *num_utenti){
+static Utente *carica_utenti_formato_precedente(const char *nome_file_utente, const char *nome_file_data, unsigned int *num_utenti){
     if(nome_file_utente == NULL || nome_file_data == NULL || num_utenti == NULL) return NULL;
 
-    FILE *file_utente = fopen(nome_file_utente, "rb");
-    if (file_utente == NULL) return NULL;
-
+    Immagine immagine_utenti = apri_immagine(nome_file_utente);
+    Immagine immagine_data = apri_immagine(nome_file_data);
     char *buffer_local = calloc(DIMENSIONE_BUFFER, sizeof(char)); // Buffer locale
-    if(buffer_local == NULL){
-        fclose(file_utente);
-        return NULL;
-    }
+    Utente *vettore = NULL;
+    if(immagine_utenti == NULL || immagine_data == NULL || buffer_local == NULL) goto fine;
 
-    FILE *file_data = fopen(nome_file_data, "rb");
-    if (file_data == NULL){
-        fclose(file_utente);
-        free(buffer_local);
-        return NULL;
-    }
+    struct lettore lettore_utenti = {dati_immagine(immagine_utenti), dimensione_immagine(immagine_utenti), 0};
+    struct lettore lettore_data = {dati_immagine(immagine_data), dimensione_immagine(immagine_data), 0};
+    struct lettore *file_utente = &lettore_utenti;
+    struct lettore *file_data = &lettore_data;
 
     // Legge il numero di utenti
-    if (fread(num_utenti, sizeof(unsigned int), 1, file_utente) != 1) {
-        fclose(file_utente);
-        fclose(file_data);
-        free(buffer_local);
-        return NULL;
-    }
+    if (!leggi_lettore(file_utente, num_utenti, sizeof(unsigned int))) goto fine;
 
-    Utente *vettore = malloc(sizeof(Utente) * (*num_utenti));
-    if(vettore == NULL) {
-        fclose(file_utente);
-        fclose(file_data);
-        free(buffer_local);
-        return NULL;
-    }
+    vettore = malloc(sizeof(Utente) * (*num_utenti));
+    if(vettore == NULL) goto fine;
 
     for (unsigned int i = 0; i < *num_utenti; i++){
         vettore[i] = carica_utente(file_utente, file_data, buffer_local);
@@ -918,17 +794,1645 @@ Utente *carica_vettore_utenti(const char *nome_file_utente, const char *nome_fil
                 distruggi_utente(vettore[j]);
             }
             free(vettore);
-            fclose(file_utente);
-            fclose(file_data);
-            free(buffer_local);
+            vettore = NULL;
             *num_utenti = 0;
-            return NULL;
+            break;
         }
     }
 
-    fclose(file_utente);
-    fclose(file_data);
+fine:
+    chiudi_immagine(immagine_utenti);
+    chiudi_immagine(immagine_data);
     free(buffer_local);
 
     return vettore;
 }
+
+/*
+ * Funzione: accoda_blocco
+ * -----------------------
+ * Accoda `n` byte al blocco, raddoppiandone la capacità quando serve.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 se l'allocazione fallisce
+ */
+static Byte accoda_blocco(struct blocco *blocco, const void *dati, size_t n){
+    if(blocco->lunghezza + n > blocco->capacita){
+        size_t capacita = blocco->capacita ? blocco->capacita : CAPACITA_INIZIALE_BLOCCO;
+        while(capacita < blocco->lunghezza + n) capacita *= 2;
+
+        unsigned char *nuovi = realloc(blocco->dati, capacita);
+        if(nuovi == NULL) return 0;
+        blocco->dati = nuovi;
+        blocco->capacita = capacita;
+    }
+
+    memcpy(blocco->dati + blocco->lunghezza, dati, n);
+    blocco->lunghezza += n;
+    return 1;
+}
+
+/*
+ * Funzione: apri_uscita
+ * ---------------------
+ * Crea il file di un'istantanea e il buffer di uscita, riservando lo spazio
+ * dell'intestazione, che viene scritta da `scrivi_istantanea` alla fine.
+ *
+ * Implementazione:
+ *    Il buffer di stdio viene disattivato: ogni fwrite del buffer di uscita
+ *    diventa una sola scrittura sul file.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 altrimenti (in tal caso `errore` è impostato)
+ */
+static Byte apri_uscita(struct uscita *uscita, const char *nome_file){
+    memset(uscita, 0, sizeof(*uscita));
+    uscita->buffer = malloc(DIMENSIONE_USCITA);
+    uscita->fp = uscita->buffer != NULL ? fopen(nome_file, "wb") : NULL;
+    if(uscita->fp == NULL){
+        uscita->errore = 1;
+        return 0;
+    }
+
+    setvbuf(uscita->fp, NULL, _IONBF, 0);
+    memset(uscita->buffer, 0, sizeof(struct intestazione_istantanea));
+    uscita->lunghezza = sizeof(struct intestazione_istantanea);
+    return 1;
+}
+
+/*
+ * Funzione: svuota_uscita
+ * -----------------------
+ * Scrive sul file il contenuto del buffer di uscita e lo svuota.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 se la scrittura fallisce
+ */
+static Byte svuota_uscita(struct uscita *uscita){
+    if(!uscita->errore && uscita->lunghezza > 0 &&
+       fwrite(uscita->buffer, 1, uscita->lunghezza, uscita->fp) != uscita->lunghezza)
+        uscita->errore = 1;
+    uscita->lunghezza = 0;
+    return !uscita->errore;
+}
+
+/*
+ * Funzione: scrivi_uscita
+ * -----------------------
+ * Accoda `n` byte al buffer di uscita, svuotandolo quando è pieno.
+ *
+ * Implementazione:
+ *    Un blocco più grande del buffer (come la tabella delle stringhe) viene
+ *    scritto direttamente, senza copiarlo.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 se una scrittura precedente o questa è fallita
+ */
+static Byte scrivi_uscita(struct uscita *uscita, const void *dati, size_t n){
+    if(uscita->errore) return 0;
+    if(n == 0) return 1;
+    if(uscita->lunghezza + n > DIMENSIONE_USCITA && !svuota_uscita(uscita)) return 0;
+
+    if(n >= DIMENSIONE_USCITA){
+        if(fwrite(dati, 1, n, uscita->fp) != n) uscita->errore = 1;
+        return !uscita->errore;
+    }
+
+    memcpy(uscita->buffer + uscita->lunghezza, dati, n);
+    uscita->lunghezza += n;
+    return 1;
+}
+
+/*
+ * Funzione: chiudi_uscita
+ * -----------------------
+ * Chiude il file e libera il buffer di uscita, senza scrivere i dati rimasti nel buffer.
+ *
+ * Implementazione:
+ *    Se la scrittura è riuscita, il file viene portato su disco con fsync prima della
+ *    chiusura: il salvataggio lo rinomina subito dopo al posto del file precedente.
+ */
+static void chiudi_uscita(struct uscita *uscita){
+    if(uscita->fp == NULL){
+        free(uscita->buffer);
+        uscita->buffer = NULL;
+        return;
+    }
+
+    if(!uscita->errore && fflush(uscita->fp) != 0) uscita->errore = 1;
+#ifndef _WIN32
+    if(!uscita->errore && fsync(fileno(uscita->fp)) != 0) uscita->errore = 1;
+#endif
+    if(fclose(uscita->fp) != 0) uscita->errore = 1;
+    free(uscita->buffer);
+    uscita->fp = NULL;
+    uscita->buffer = NULL;
+}
+
+/*
+ * Funzione: hash_stringa
+ * ----------------------
+ * Hash FNV-1a di una stringa terminata da '\0'.
+ */
+static uint32_t hash_stringa(const char *s){
+    uint32_t h = 2166136261u;
+    while(*s){
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/*
+ * Funzione: testo_voce
+ * --------------------
+ * Restituisce la stringa della voce indicata della tabella delle stringhe.
+ */
+static const char *testo_voce(const struct tabella_stringhe *tabella, uint32_t voce){
+    const uint32_t *posizioni = (const uint32_t *)tabella->posizioni.dati;
+    return (const char *)tabella->testo.dati + posizioni[voce];
+}
+
+/*
+ * Funzione: passo_indice
+ * ----------------------
+ * Restituisce il numero di interi di ogni cella dell'indice: la voce sta accanto alla
+ * posizione, così la ricerca non legge un altro vettore.
+ */
+static size_t passo_indice(const struct tabella_stringhe *tabella){
+    return tabella->con_dizionario ? 2 : 1;
+}
+
+/*
+ * Funzione: ingrandisci_indice
+ * ----------------------------
+ * Raddoppia l'indice della tabella delle stringhe e vi reinserisce le celle.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 se l'allocazione fallisce
+ */
+static Byte ingrandisci_indice(struct tabella_stringhe *tabella){
+    size_t passo = passo_indice(tabella);
+    size_t capacita = tabella->capacita_indice ? tabella->capacita_indice * 2 : CAPACITA_INIZIALE_INDICE;
+    uint32_t *indice = calloc(capacita * passo, sizeof(uint32_t));
+    if(indice == NULL) return 0;
+
+    for(size_t i = 0; i < tabella->capacita_indice; i++){
+        const uint32_t *cella = tabella->indice + i * passo;
+        if(cella[0] == 0) continue;
+
+        size_t j = hash_stringa((const char *)tabella->testo.dati + cella[0] - 1) & (capacita - 1);
+        while(indice[j * passo] != 0) j = (j + 1) & (capacita - 1);
+        memcpy(indice + j * passo, cella, passo * sizeof(uint32_t));
+    }
+
+    free(tabella->indice);
+    tabella->indice = indice;
+    tabella->capacita_indice = capacita;
+    return 1;
+}
+
+/*
+ * Funzione: cerca_stringa
+ * -----------------------
+ * Restituisce la cella dell'indice di `stringa`, aggiungendola alla tabella solo se
+ * non è già presente.
+ *
+ * Implementazione:
+ *    Indirizzamento aperto con scansione lineare, fattore di carico al più 1/2.
+ *    Con il dizionario le voci sono numerate da 0 nell'ordine di inserimento e
+ *    `posizioni` ne conserva la posizione nel testo.
+ *    Una stringa NULL viene salvata come stringa vuota.
+ *
+ * Ritorna:
+ *    la cella della stringa, NULL se l'allocazione fallisce o la tabella supera i 4 GiB
+ */
+static const uint32_t *cerca_stringa(struct tabella_stringhe *tabella, const char *stringa){
+    if(stringa == NULL) stringa = "";
+    if((tabella->num_stringhe + 1) * 2 > tabella->capacita_indice && !ingrandisci_indice(tabella)) return NULL;
+
+    size_t passo = passo_indice(tabella);
+    size_t maschera = tabella->capacita_indice - 1;
+    size_t j = hash_stringa(stringa) & maschera;
+    uint32_t *cella;
+    while(*(cella = tabella->indice + j * passo) != 0){
+        if(strcmp((const char *)tabella->testo.dati + cella[0] - 1, stringa) == 0) return cella;
+        j = (j + 1) & maschera;
+    }
+
+    size_t lunghezza = strlen(stringa) + 1;
+    uint32_t posizione = (uint32_t)tabella->testo.lunghezza;
+    if(tabella->testo.lunghezza + lunghezza >= UINT32_MAX) return NULL;
+    if(tabella->con_dizionario && !accoda_blocco(&tabella->posizioni, &posizione, sizeof(posizione))) return NULL;
+    if(!accoda_blocco(&tabella->testo, stringa, lunghezza)){
+        if(tabella->con_dizionario) tabella->posizioni.lunghezza -= sizeof(posizione);
+        return NULL;
+    }
+
+    cella[0] = posizione + 1;
+    if(tabella->con_dizionario) cella[1] = (uint32_t)tabella->num_stringhe;
+    tabella->num_stringhe++;
+    return cella;
+}
+
+/*
+ * Funzione: inserisci_stringa
+ * ---------------------------
+ * Restituisce in `voce` il numero d'ordine di `stringa` in una tabella con dizionario,
+ * aggiungendola solo se non è già presente.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 se l'allocazione fallisce o la tabella supera i 4 GiB
+ */
+static Byte inserisci_stringa(struct tabella_stringhe *tabella, const char *stringa, uint32_t *voce){
+    const uint32_t *cella = cerca_stringa(tabella, stringa);
+    if(cella == NULL) return 0;
+
+    *voce = cella[1];
+    return 1;
+}
+
+/*
+ * Funzione: inserisci_posizione
+ * -----------------------------
+ * Come `inserisci_stringa`, ma restituisce in `posizione` la posizione della stringa
+ * nel testo, usata dai record a dimensione fissa.
+ */
+static Byte inserisci_posizione(struct tabella_stringhe *tabella, const char *stringa, uint32_t *posizione){
+    const uint32_t *cella = cerca_stringa(tabella, stringa);
+    if(cella == NULL) return 0;
+
+    *posizione = cella[0] - 1;
+    return 1;
+}
+
+/*
+ * Funzione: libera_tabella_stringhe
+ * ---------------------------------
+ * Libera il testo, l'indice e il dizionario della tabella delle stringhe.
+ */
+static void libera_tabella_stringhe(struct tabella_stringhe *tabella){
+    free(tabella->testo.dati);
+    free(tabella->indice);
+    free(tabella->posizioni.dati);
+}
+
+/*
+ * Funzione: inserisci_stringa_ripetuta
+ * ------------------------------------
+ * Come `inserisci_stringa`, ma se `stringa` è uguale alla voce `ultima` (quando
+ * `ripetibile` è 1) la riusa senza consultare l'indice.
+ */
+static Byte inserisci_stringa_ripetuta(struct tabella_stringhe *tabella, Byte ripetibile, uint32_t ultima, const char *stringa, uint32_t *voce){
+    if(ripetibile && stringa != NULL && strcmp(testo_voce(tabella, ultima), stringa) == 0){
+        *voce = ultima;
+        return 1;
+    }
+    return inserisci_stringa(tabella, stringa, voce);
+}
+
+/*
+ * Funzione: zigzag
+ * ----------------
+ * Trasforma un intero con segno in uno senza segno piccolo se il valore è vicino a 0.
+ */
+static uint64_t zigzag(int64_t valore){
+    return ((uint64_t)valore << 1) ^ (valore < 0 ? UINT64_MAX : 0);
+}
+
+/*
+ * Funzione: da_zigzag
+ * -------------------
+ * Inversa di `zigzag`.
+ */
+static int64_t da_zigzag(uint64_t valore){
+    return (int64_t)(valore >> 1) ^ -(int64_t)(valore & 1);
+}
+
+/*
+ * Funzione: somma
+ * ---------------
+ * Restituisce a + b in aritmetica modulo 2^64, così la somma non trabocca mai.
+ */
+static int64_t somma(int64_t a, int64_t b){
+    return (int64_t)((uint64_t)a + (uint64_t)b);
+}
+
+/*
+ * Funzione: codifica_varint
+ * -------------------------
+ * Scrive `valore` in `destinazione` a 7 bit per byte, dal meno significativo; il bit
+ * alto di ogni byte indica che ne segue un altro.
+ *
+ * Ritorna:
+ *    il numero di byte scritti (al più 10)
+ */
+static size_t codifica_varint(unsigned char *destinazione, uint64_t valore){
+    size_t n = 0;
+    while(valore >= 0x80){
+        destinazione[n++] = (unsigned char)(valore | 0x80);
+        valore >>= 7;
+    }
+    destinazione[n++] = (unsigned char)valore;
+    return n;
+}
+
+/*
+ * Funzione: codifica_differenza
+ * -----------------------------
+ * Scrive con `codifica_varint` lo zigzag di a - b, calcolata modulo 2^64 così la
+ * differenza non trabocca mai.
+ */
+static size_t codifica_differenza(unsigned char *destinazione, int64_t a, int64_t b){
+    uint64_t d = (uint64_t)a - (uint64_t)b;
+    return codifica_varint(destinazione, (d << 1) ^ (d >> 63 ? UINT64_MAX : 0));
+}
+
+/*
+ * Funzione: codifica_costo
+ * ------------------------
+ * Scrive il costo in centesimi se la conversione lo restituisce identico, altrimenti
+ * il marcatore 1 seguito dagli 8 byte del double.
+ *
+ * Ritorna:
+ *    il numero di byte scritti (al più 10)
+ */
+static size_t codifica_costo(unsigned char *destinazione, double costo){
+    if(costo >= -MAX_COSTO_IN_CENTESIMI && costo <= MAX_COSTO_IN_CENTESIMI){
+        int64_t centesimi = (int64_t)(costo * 100.0 + (costo < 0 ? -0.5 : 0.5));
+        double decodificato = (double)centesimi / 100.0;
+        if(memcmp(&decodificato, &costo, sizeof(costo)) == 0) return codifica_varint(destinazione, zigzag(centesimi) << 1);
+    }
+
+    destinazione[0] = 1;
+    memcpy(destinazione + 1, &costo, sizeof(costo));
+    return 1 + sizeof(costo);
+}
+
+/*
+ * Funzione: inizia_sequenza
+ * -------------------------
+ * Inizia le prenotazioni di un veicolo (o lo storico di un cliente): azzera i valori
+ * precedenti del flusso compatto.
+ *
+ * Ritorna:
+ *    il byte del flusso da cui inizia la sequenza
+ */
+static uint32_t inizia_sequenza(struct scrittore_prenotazioni *scrittore){
+    scrittore->inizio_precedente = 0;
+    scrittore->cliente_precedente = 0;
+    scrittore->targa_precedente = 0;
+    scrittore->id_precedente = 0;
+    return (uint32_t)scrittore->dimensione_flusso;
+}
+
+/*
+ * Funzione: scrivi_record_prenotazione
+ * ------------------------------------
+ * Aggiunge allo scrittore la prenotazione `id`, codificata nel flusso compatto, inserendo
+ * cliente e targa nel suo dizionario; i campi cliente e targa di `record` non sono usati.
+ *
+ * Implementazione:
+ *    Le prenotazioni di un veicolo (e lo storico di un cliente) vengono scritte di
+ *    seguito: se la targa o il cliente sono gli stessi del record precedente ne riusa
+ *    la voce senza cercarli nell'indice, e la loro differenza nel flusso occupa un byte.
+ *    In caso di errore, o se il flusso supera i 4 GiB, imposta `errore`; i record
+ *    successivi vengono ignorati.
+ */
+static void scrivi_record_prenotazione(struct scrittore_prenotazioni *scrittore, const struct record_prenotazione *record, uint64_t id, const char *cliente, const char *targa){
+    if(scrittore->errore) return;
+
+    uint32_t voce_cliente, voce_targa;
+    Byte ripetibile = scrittore->num_record > 0;
+    if(!inserisci_stringa_ripetuta(&scrittore->stringhe, ripetibile, scrittore->ultima_targa, targa, &voce_targa) ||
+       !inserisci_stringa_ripetuta(&scrittore->stringhe, ripetibile, scrittore->ultimo_cliente, cliente, &voce_cliente)){
+        scrittore->errore = 1;
+        return;
+    }
+
+    unsigned char codifica[MAX_PRENOTAZIONE_COMPATTA];
+    size_t n = codifica_differenza(codifica, record->inizio, scrittore->inizio_precedente);
+    n += codifica_differenza(codifica + n, record->fine, record->inizio);
+    n += codifica_costo(codifica + n, record->costo);
+    n += codifica_differenza(codifica + n, voce_cliente, scrittore->cliente_precedente);
+    n += codifica_differenza(codifica + n, voce_targa, scrittore->targa_precedente);
+    n += codifica_differenza(codifica + n, (int64_t)id, (int64_t)scrittore->id_precedente);
+
+    if(scrittore->dimensione_flusso + n > UINT32_MAX || !scrivi_uscita(&scrittore->record, codifica, n)){
+        scrittore->errore = 1;
+        return;
+    }
+    scrittore->dimensione_flusso += n;
+    scrittore->inizio_precedente = record->inizio;
+    scrittore->cliente_precedente = scrittore->ultimo_cliente = voce_cliente;
+    scrittore->targa_precedente = scrittore->ultima_targa = voce_targa;
+    scrittore->id_precedente = id;
+    scrittore->num_record++;
+}
+
+/*
+ * Funzione: scrivi_prenotazione
+ * -----------------------------
+ * Aggiunge allo scrittore il record di una prenotazione.
+ */
+static void scrivi_prenotazione(struct scrittore_prenotazioni *scrittore, const Prenotazione prenotazione){
+    if(scrittore->errore || prenotazione == NULL) return;
+
+    Intervallo intervallo = ottieni_intervallo_prenotazione(prenotazione);
+    if(intervallo == NULL) return;
+
+    struct record_prenotazione record;
+    memset(&record, 0, sizeof(record));
+    record.inizio = (int64_t)inizio_intervallo(intervallo);
+    record.fine = (int64_t)fine_intervallo(intervallo);
+    record.costo = ottieni_costo_prenotazione(prenotazione);
+
+    scrivi_record_prenotazione(scrittore, &record, ottieni_id_prenotazione(prenotazione),
+                               ottieni_cliente_prenotazione(prenotazione), ottieni_veicolo_prenotazione(prenotazione));
+}
+
+/*
+ * Funzione: scrivi_prenotazione_visitata
+ * --------------------------------------
+ * Visitatore che aggiunge allo scrittore passato come contesto la prenotazione visitata.
+ */
+static void scrivi_prenotazione_visitata(const Prenotazione prenotazione, void *scrittore){
+    scrivi_prenotazione((struct scrittore_prenotazioni *)scrittore, prenotazione);
+}
+
+/*
+ * Funzione: sezione_compatta
+ * --------------------------
+ * Indica se le istantanee CAS2 e CAS3 del tipo indicato contengono il flusso compatto delle
+ * prenotazioni invece dei record a dimensione fissa.
+ */
+static Byte sezione_compatta(uint32_t tipo){
+    return tipo == ISTANTANEA_PRENOTAZIONI || tipo == ISTANTANEA_STORICI;
+}
+
+/*
+ * Funzione: scrivi_istantanea
+ * ---------------------------
+ * Completa un'istantanea i cui record (o il cui flusso compatto, di `dimensione_flusso`
+ * byte) sono già stati scritti nell'uscita: accoda il dizionario, per le prenotazioni,
+ * e la tabella delle stringhe, torna all'inizio del file per scrivere l'intestazione,
+ * con l'ultimo identificativo di prenotazione assegnato e la `generazione`, e chiude l'uscita.
+ *
+ * Ritorna:
+ *    1 se il file è stato scritto e chiuso senza errori, 0 altrimenti
+ */
+static Byte scrivi_istantanea(struct uscita *uscita, uint32_t tipo, uint32_t num_record, uint32_t dimensione_flusso,
+                              const struct tabella_stringhe *stringhe, uint64_t generazione){
+    Byte compatta = sezione_compatta(tipo);
+    struct intestazione_istantanea intestazione = {MAGICO_ISTANTANEA_GENERAZIONE, tipo, num_record, (uint32_t)stringhe->testo.lunghezza,
+                                                   compatta ? (uint32_t)stringhe->num_stringhe : 0, dimensione_flusso,
+                                                   ottieni_ultimo_id_prenotazione(), generazione};
+
+    if((!compatta || scrivi_uscita(uscita, stringhe->posizioni.dati, stringhe->posizioni.lunghezza)) &&
+       scrivi_uscita(uscita, stringhe->testo.dati, stringhe->testo.lunghezza) && svuota_uscita(uscita) &&
+       (fseek(uscita->fp, 0, SEEK_SET) != 0 || fwrite(&intestazione, sizeof(intestazione), 1, uscita->fp) != 1))
+        uscita->errore = 1;
+
+    chiudi_uscita(uscita);
+    return !uscita->errore;
+}
+
+/*
+ * Funzione: ha_intestazione_istantanea
+ * ------------------------------------
+ * Indica se l'immagine inizia con l'intestazione di un'istantanea (da CAS1 a CAS4); in
+ * caso contrario il file è stato scritto nel formato precedente.
+ */
+static Byte ha_intestazione_istantanea(const Immagine immagine){
+    uint32_t magico;
+    if(dimensione_immagine(immagine) < sizeof(magico)) return 0;
+
+    memcpy(&magico, dati_immagine(immagine), sizeof(magico));
+    return magico == MAGICO_ISTANTANEA || magico == MAGICO_ISTANTANEA_COMPATTA || magico == MAGICO_ISTANTANEA_ID ||
+           magico == MAGICO_ISTANTANEA_GENERAZIONE;
+}
+
+/*
+ * Funzione: leggi_sezioni
+ * -----------------------
+ * Individua le sezioni di un'istantanea mappata e ne verifica la coerenza.
+ *
+ * Implementazione:
+ *    Controlla tipo, dimensione esatta del file e terminazione della tabella delle
+ *    stringhe: ogni posizione minore di `dimensione_stringhe` indica quindi una
+ *    stringa terminata all'interno dell'immagine. Un'intestazione CAS1 viene letta
+ *    con `num_voci` e `dimensione_flusso` a 0 e i record a dimensione fissa, anche
+ *    per le prenotazioni; un'intestazione CAS2 con `ultimo_id` a 0 e un flusso
+ *    compatto senza identificativi; un'intestazione CAS3 con `generazione` a 0.
+ *
+ * Ritorna:
+ *    1 se l'istantanea è valida, 0 altrimenti
+ */
+static Byte leggi_sezioni(const Immagine immagine, uint32_t tipo, size_t dimensione_record, struct sezioni_istantanea *sezioni){
+    const unsigned char *dati = dati_immagine(immagine);
+    size_t dimensione = dimensione_immagine(immagine);
+    size_t dimensione_intestazione = offsetof(struct intestazione_istantanea, num_voci);
+    if(dati == NULL || dimensione < dimensione_intestazione) return 0;
+
+    struct intestazione_istantanea *intestazione = &sezioni->intestazione;
+    memset(intestazione, 0, sizeof(*intestazione));
+    memcpy(intestazione, dati, dimensione_intestazione);
+    sezioni->compatta = 0;
+    sezioni->con_id = 0;
+    sezioni->dizionario = NULL;
+    if(intestazione->magico == MAGICO_ISTANTANEA_COMPATTA || intestazione->magico == MAGICO_ISTANTANEA_ID ||
+       intestazione->magico == MAGICO_ISTANTANEA_GENERAZIONE){
+        sezioni->con_id = intestazione->magico != MAGICO_ISTANTANEA_COMPATTA;
+        if(intestazione->magico == MAGICO_ISTANTANEA_GENERAZIONE) dimensione_intestazione = sizeof(*intestazione);
+        else if(sezioni->con_id) dimensione_intestazione = offsetof(struct intestazione_istantanea, generazione);
+        else dimensione_intestazione = offsetof(struct intestazione_istantanea, ultimo_id);
+        if(dimensione < dimensione_intestazione) return 0;
+        memcpy(intestazione, dati, dimensione_intestazione);
+        sezioni->compatta = sezione_compatta(tipo);
+    }
+    else if(intestazione->magico != MAGICO_ISTANTANEA) return 0;
+    if(intestazione->tipo != tipo) return 0;
+
+    size_t resto = dimensione - dimensione_intestazione;
+    size_t byte_record;
+    if(sezioni->compatta){
+        if(intestazione->dimensione_flusso > resto ||
+           intestazione->num_voci > (resto - intestazione->dimensione_flusso) / sizeof(uint32_t)) return 0;
+        byte_record = intestazione->dimensione_flusso + (size_t)intestazione->num_voci * sizeof(uint32_t);
+    }
+    else{
+        if(intestazione->num_record > resto / dimensione_record) return 0;
+        byte_record = (size_t)intestazione->num_record * dimensione_record;
+    }
+    if(resto - byte_record != intestazione->dimensione_stringhe) return 0;
+
+    sezioni->record = dati + dimensione_intestazione;
+    if(sezioni->compatta) sezioni->dizionario = sezioni->record + intestazione->dimensione_flusso;
+    sezioni->stringhe = (const char *)(sezioni->record + byte_record);
+    if(intestazione->dimensione_stringhe > 0 && sezioni->stringhe[intestazione->dimensione_stringhe - 1] != '\0') return 0;
+    return 1;
+}
+
+/*
+ * Funzione: stringa_istantanea
+ * ----------------------------
+ * Restituisce la stringa dell'istantanea indicata da un campo di un record, senza
+ * copiarla: una voce del dizionario nelle sezioni compatte, una posizione altrimenti.
+ *
+ * Ritorna:
+ *    un puntatore interno all'immagine, NULL se il riferimento non è valido
+ */
+static const char *stringa_istantanea(const struct sezioni_istantanea *sezioni, uint32_t riferimento){
+    uint32_t posizione = riferimento;
+    if(sezioni->compatta){
+        if(riferimento >= sezioni->intestazione.num_voci) return NULL;
+        memcpy(&posizione, sezioni->dizionario + (size_t)riferimento * sizeof(posizione), sizeof(posizione));
+    }
+
+    if(posizione >= sezioni->intestazione.dimensione_stringhe) return NULL;
+    return sezioni->stringhe + posizione;
+}
+
+/*
+ * Funzione: intervallo_record_valido
+ * ----------------------------------
+ * Verifica che le `num` prenotazioni a partire da `prima` possano esistere
+ * nell'istantanea: nel flusso compatto ognuna occupa almeno un byte, gli errori
+ * successivi vengono rilevati dalla decodifica.
+ */
+static Byte intervallo_record_valido(const struct sezioni_istantanea *sezioni, uint32_t prima, uint32_t num){
+    uint32_t totale = sezioni->compatta ? sezioni->intestazione.dimensione_flusso : sezioni->intestazione.num_record;
+    return num <= totale && prima <= totale - num;
+}
+
+/*
+ * Funzione: apri_cursore
+ * ----------------------
+ * Posiziona il cursore sulla prima prenotazione di una sequenza: il record `prima`,
+ * o il byte `prima` del flusso compatto.
+ */
+static void apri_cursore(struct cursore_prenotazioni *cursore, const struct sezioni_istantanea *sezioni, uint32_t prima){
+    cursore->sezioni = sezioni;
+    cursore->posizione = prima;
+    cursore->inizio = 0;
+    cursore->cliente = 0;
+    cursore->targa = 0;
+    cursore->id = 0;
+}
+
+/*
+ * Funzione: leggi_varint
+ * ----------------------
+ * Legge dal flusso compatto un intero scritto da `codifica_varint`.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 se il flusso termina o l'intero supera i 64 bit
+ */
+static Byte leggi_varint(struct cursore_prenotazioni *cursore, uint64_t *valore){
+    const unsigned char *flusso = cursore->sezioni->record;
+    size_t fine = cursore->sezioni->intestazione.dimensione_flusso;
+    uint64_t risultato = 0;
+
+    for(unsigned int spostamento = 0; spostamento < 64 && cursore->posizione < fine; spostamento += 7){
+        unsigned char byte = flusso[cursore->posizione++];
+        risultato |= (uint64_t)(byte & 0x7F) << spostamento;
+        if(!(byte & 0x80)){
+            *valore = risultato;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Funzione: leggi_record_cursore
+ * ------------------------------
+ * Legge la prenotazione sotto il cursore, con il suo identificativo (0 se l'istantanea
+ * non li contiene), e lo fa avanzare alla successiva.
+ *
+ * Implementazione:
+ *    Nel formato CAS1 copia il record con una sola memcpy, così l'accesso non dipende
+ *    dall'allineamento. Nel flusso compatto decodifica le differenze rispetto ai valori
+ *    precedenti, conservati nel cursore; cliente e targa restano voci del dizionario,
+ *    da risolvere con `stringa_istantanea`.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 se i dati non sono validi
+ */
+static Byte leggi_record_cursore(struct cursore_prenotazioni *cursore, struct record_prenotazione *record, uint64_t *id){
+    const struct sezioni_istantanea *sezioni = cursore->sezioni;
+    *id = 0;
+    if(!sezioni->compatta){
+        if(cursore->posizione >= sezioni->intestazione.num_record) return 0;
+        memcpy(record, sezioni->record + cursore->posizione * sizeof(*record), sizeof(*record));
+        cursore->posizione++;
+        return 1;
+    }
+
+    uint64_t inizio, durata, costo, cliente, targa, differenza_id = 0;
+    if(!leggi_varint(cursore, &inizio) || !leggi_varint(cursore, &durata) || !leggi_varint(cursore, &costo)) return 0;
+    if(costo & 1){
+        if(costo != 1 || sezioni->intestazione.dimensione_flusso - cursore->posizione < sizeof(record->costo)) return 0;
+        memcpy(&record->costo, sezioni->record + cursore->posizione, sizeof(record->costo));
+        cursore->posizione += sizeof(record->costo);
+    }
+    else record->costo = (double)da_zigzag(costo >> 1) / 100.0;
+    if(!leggi_varint(cursore, &cliente) || !leggi_varint(cursore, &targa)) return 0;
+    if(sezioni->con_id && !leggi_varint(cursore, &differenza_id)) return 0;
+
+    cursore->inizio = somma(cursore->inizio, da_zigzag(inizio));
+    cursore->cliente += (uint32_t)da_zigzag(cliente);
+    cursore->targa += (uint32_t)da_zigzag(targa);
+    cursore->id += (uint64_t)da_zigzag(differenza_id);
+
+    record->inizio = cursore->inizio;
+    record->fine = somma(cursore->inizio, da_zigzag(durata));
+    record->cliente = cursore->cliente;
+    record->targa = cursore->targa;
+    *id = cursore->id;
+    return 1;
+}
+
+/*
+ * Funzione: prenotazione_da_cursore
+ * ---------------------------------
+ * Crea la prenotazione sotto il cursore e lo fa avanzare alla successiva.
+ *
+ * Implementazione:
+ *    Le stringhe sono lette direttamente dall'immagine. Se la prenotazione con lo
+ *    stesso identificativo è già viva, perché l'altra vista (albero del veicolo o
+ *    storico del cliente) è già stata costruita, ne restituisce un riferimento.
+ *
+ * Ritorna:
+ *    una nuova prenotazione, o NULL se il record non è valido
+ */
+static Prenotazione prenotazione_da_cursore(struct cursore_prenotazioni *cursore){
+    struct record_prenotazione record;
+    uint64_t id;
+    if(!leggi_record_cursore(cursore, &record, &id)) return NULL;
+
+    const char *cliente = stringa_istantanea(cursore->sezioni, record.cliente);
+    const char *targa = stringa_istantanea(cursore->sezioni, record.targa);
+    if(cliente == NULL || targa == NULL) return NULL;
+
+    Intervallo intervallo = crea_intervallo((time_t)record.inizio, (time_t)record.fine);
+    if(intervallo == NULL) return NULL;
+
+    Prenotazione p = crea_prenotazione_con_id(id, cliente, targa, intervallo, record.costo);
+    distruggi_intervallo(intervallo);
+    return p;
+}
+
+/*
+ * Funzione: prenotazioni_da_istantanea
+ * ------------------------------------
+ * Costruisce la struttura Prenotazioni con le `num` prenotazioni a partire da `prima`.
+ *
+ * Ritorna:
+ *    una nuova struttura Prenotazioni, o NULL in caso di errore
+ */
+static Prenotazioni prenotazioni_da_istantanea(const struct sezioni_istantanea *sezioni, uint32_t prima, uint32_t num){
+    if(num == 0) return crea_prenotazioni();
+
+    Prenotazione *vettore = malloc(sizeof(Prenotazione) * num);
+    if(vettore == NULL) return NULL;
+
+    struct cursore_prenotazioni cursore;
+    apri_cursore(&cursore, sezioni, prima);
+    for(uint32_t i = 0; i < num; i++){
+        vettore[i] = prenotazione_da_cursore(&cursore);
+        if(vettore[i] == NULL){
+            distruggi_vettore_prenotazioni(vettore, i);
+            free(vettore);
+            return NULL;
+        }
+    }
+
+    return costruisci_prenotazioni(vettore, num);
+}
+
+/*
+ * Funzione: carica_da_archivio
+ * ----------------------------
+ * Costruisce le `num` prenotazioni di un veicolo a partire da `prima` nell'archivio.
+ */
+static Prenotazioni carica_da_archivio(SorgentePrenotazioni *sorgente, unsigned int prima, unsigned int num){
+    struct archivio_prenotazioni *archivio = (struct archivio_prenotazioni *)sorgente;
+    return prenotazioni_da_istantanea(&archivio->sezioni, prima, num);
+}
+
+/*
+ * Funzione: visita_da_archivio
+ * ----------------------------
+ * Visita gli estremi delle prenotazioni di un veicolo che si sovrappongono a [da, a),
+ * leggendo i record dall'archivio senza creare prenotazioni.
+ *
+ * Implementazione:
+ *    Le prenotazioni di un veicolo sono salvate in ordine di inizio e non si
+ *    sovrappongono: la lettura si ferma alla prima che inizia da `a` in poi.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 se un record non è valido
+ */
+static Byte visita_da_archivio(SorgentePrenotazioni *sorgente, unsigned int prima, unsigned int num, time_t da, time_t a,
+                               VisitatoreIntervalli visitatore, void *contesto){
+    struct archivio_prenotazioni *archivio = (struct archivio_prenotazioni *)sorgente;
+    struct cursore_prenotazioni cursore;
+    struct record_prenotazione record;
+    uint64_t id;
+
+    apri_cursore(&cursore, &archivio->sezioni, prima);
+    for(unsigned int i = 0; i < num; i++){
+        if(!leggi_record_cursore(&cursore, &record, &id)) return 0;
+        if(record.inizio >= (int64_t)a) break;
+        if(record.fine > (int64_t)da) visitatore((time_t)record.inizio, (time_t)record.fine, contesto);
+    }
+    return 1;
+}
+
+/*
+ * Funzione: rilascia_archivio
+ * ---------------------------
+ * Chiude l'immagine dell'archivio quando nessun veicolo vi fa più riferimento.
+ */
+static void rilascia_archivio(SorgentePrenotazioni *sorgente){
+    struct archivio_prenotazioni *archivio = (struct archivio_prenotazioni *)sorgente;
+    chiudi_immagine(archivio->immagine);
+    free(archivio);
+}
+
+/*
+ * Funzione: apri_archivio_prenotazioni
+ * ------------------------------------
+ * Mappa l'istantanea delle prenotazioni dei veicoli e ne verifica le sezioni.
+ *
+ * Implementazione:
+ *    L'archivio nasce con un riferimento, del chiamante, da rilasciare con
+ *    `rilascia_riferimento_archivio` dopo aver creato i veicoli.
+ *    Riserva gli identificativi fino all'`ultimo_id` dell'intestazione.
+ *
+ * Ritorna:
+ *    l'archivio, o NULL se il file manca o non è valido
+ */
+static struct archivio_prenotazioni *apri_archivio_prenotazioni(const char *nome_file){
+    struct archivio_prenotazioni *archivio = calloc(1, sizeof(struct archivio_prenotazioni));
+    if(archivio == NULL) return NULL;
+
+    archivio->immagine = apri_immagine(nome_file);
+    if(!leggi_sezioni(archivio->immagine, ISTANTANEA_PRENOTAZIONI, sizeof(struct record_prenotazione), &archivio->sezioni)){
+        chiudi_immagine(archivio->immagine);
+        free(archivio);
+        return NULL;
+    }
+
+    // Gli identificativi assegnati d'ora in poi non devono coincidere con quelli salvati
+    pthread_mutex_lock(&mutex_formato_precedente);
+    riserva_id_prenotazioni(archivio->sezioni.intestazione.ultimo_id);
+    pthread_mutex_unlock(&mutex_formato_precedente);
+
+    archivio->sorgente.carica = carica_da_archivio;
+    archivio->sorgente.visita = visita_da_archivio;
+    archivio->sorgente.rilascia = rilascia_archivio;
+    archivio->sorgente.riferimenti = 1;
+    return archivio;
+}
+
+/*
+ * Funzione: rilascia_riferimento_archivio
+ * ---------------------------------------
+ * Rilascia un riferimento all'archivio, chiudendolo se era l'ultimo.
+ */
+static void rilascia_riferimento_archivio(struct archivio_prenotazioni *archivio){
+    if(--archivio->sorgente.riferimenti == 0) rilascia_archivio(&archivio->sorgente);
+}
+
+/*
+ * Funzione: veicolo_da_record
+ * ---------------------------
+ * Crea il veicolo descritto dal record `indice`; le sue prenotazioni verranno
+ * costruite dall'archivio al primo accesso.
+ *
+ * Ritorna:
+ *    un nuovo veicolo, o NULL se il record non è valido
+ */
+static Veicolo veicolo_da_record(const struct sezioni_istantanea *veicoli, struct archivio_prenotazioni *archivio, uint32_t indice){
+    struct record_veicolo record;
+    memcpy(&record, veicoli->record + (size_t)indice * sizeof(record), sizeof(record));
+
+    const char *tipo = stringa_istantanea(veicoli, record.tipo);
+    const char *targa = stringa_istantanea(veicoli, record.targa);
+    const char *modello = stringa_istantanea(veicoli, record.modello);
+    const char *posizione = stringa_istantanea(veicoli, record.posizione);
+    if(tipo == NULL || targa == NULL || modello == NULL || posizione == NULL) return NULL;
+    if(!intervallo_record_valido(&archivio->sezioni, record.prima_prenotazione, record.num_prenotazioni)) return NULL;
+
+    return crea_veicolo_differito(tipo, targa, modello, posizione, record.tariffa,
+                                  &archivio->sorgente, record.prima_prenotazione, record.num_prenotazioni);
+}
+
+/*
+ * Funzione: copia_record_istantanea
+ * ---------------------------------
+ * Aggiunge allo scrittore le `num` prenotazioni di un'istantanea a partire da `prima`,
+ * senza costruire le prenotazioni: vengono solo ricodificate con il dizionario dello
+ * scrittore, conservandone gli identificativi.
+ */
+static void copia_record_istantanea(struct scrittore_prenotazioni *scrittore, const struct sezioni_istantanea *sezioni, uint32_t prima, uint32_t num){
+    struct cursore_prenotazioni cursore;
+    apri_cursore(&cursore, sezioni, prima);
+
+    for(uint32_t i = 0; i < num && !scrittore->errore; i++){
+        struct record_prenotazione record;
+        uint64_t id;
+        const char *cliente = NULL, *targa = NULL;
+        if(leggi_record_cursore(&cursore, &record, &id)){
+            cliente = stringa_istantanea(sezioni, record.cliente);
+            targa = stringa_istantanea(sezioni, record.targa);
+        }
+        if(cliente == NULL || targa == NULL){
+            scrittore->errore = 1;
+            return;
+        }
+        scrivi_record_prenotazione(scrittore, &record, id, cliente, targa);
+    }
+}
+
+/*
+ * Funzione: storico_da_istantanea
+ * -------------------------------
+ * Costruisce la struttura Data con le `num` prenotazioni a partire da `prima`.
+ *
+ * Implementazione:
+ *    Ogni prenotazione viene collegata allo storico, che ne prende un riferimento,
+ *    e il riferimento di chi l'ha decodificata viene rilasciato subito. Una prenotazione
+ *    già collegata a un altro storico (lo stesso archivio caricato due volte) viene copiata.
+ *
+ * Ritorna:
+ *    una nuova struttura Data, o NULL in caso di errore
+ */
+static Data storico_da_istantanea(const struct sezioni_istantanea *sezioni, uint32_t prima, uint32_t num){
+    Data data = crea_data();
+    if(data == NULL) return NULL;
+
+    struct cursore_prenotazioni cursore;
+    apri_cursore(&cursore, sezioni, prima);
+
+    for(uint32_t i = 0; i < num; i++){
+        Prenotazione p = prenotazione_da_cursore(&cursore);
+        if(p != NULL && appartiene_a_storico(p)){
+            Prenotazione copia = duplica_prenotazione(p);
+            distruggi_prenotazione(p);
+            p = copia;
+        }
+        if(p == NULL){
+            distruggi_data(data);
+            return NULL;
+        }
+        aggiungi_a_storico_lista(data, p);
+        distruggi_prenotazione(p);
+    }
+
+    return data;
+}
+
+/*
+ * Funzione: carica_storico_da_archivio
+ * ------------------------------------
+ * Costruisce lo storico di un cliente, `num` prenotazioni a partire da `prima` nell'archivio.
+ */
+static Data carica_storico_da_archivio(SorgenteStorico *sorgente, unsigned int prima, unsigned int num){
+    struct archivio_storici *archivio = (struct archivio_storici *)sorgente;
+    return storico_da_istantanea(&archivio->sezioni, prima, num);
+}
+
+/*
+ * Funzione: rilascia_archivio_storici
+ * -----------------------------------
+ * Chiude l'immagine dell'archivio quando nessun cliente vi fa più riferimento.
+ */
+static void rilascia_archivio_storici(SorgenteStorico *sorgente){
+    struct archivio_storici *archivio = (struct archivio_storici *)sorgente;
+    chiudi_immagine(archivio->immagine);
+    free(archivio);
+}
+
+/*
+ * Funzione: apri_archivio_storici
+ * -------------------------------
+ * Mappa l'istantanea degli storici degli utenti e ne verifica le sezioni.
+ *
+ * Implementazione:
+ *    Come `apri_archivio_prenotazioni`: l'archivio nasce con il riferimento del
+ *    chiamante, da rilasciare con `rilascia_riferimento_storici`.
+ *
+ * Ritorna:
+ *    l'archivio, o NULL se il file manca o non è valido
+ */
+static struct archivio_storici *apri_archivio_storici(const char *nome_file){
+    struct archivio_storici *archivio = calloc(1, sizeof(struct archivio_storici));
+    if(archivio == NULL) return NULL;
+
+    archivio->immagine = apri_immagine(nome_file);
+    if(!leggi_sezioni(archivio->immagine, ISTANTANEA_STORICI, sizeof(struct record_prenotazione), &archivio->sezioni)){
+        chiudi_immagine(archivio->immagine);
+        free(archivio);
+        return NULL;
+    }
+
+    // Gli identificativi assegnati d'ora in poi non devono coincidere con quelli salvati
+    pthread_mutex_lock(&mutex_formato_precedente);
+    riserva_id_prenotazioni(archivio->sezioni.intestazione.ultimo_id);
+    pthread_mutex_unlock(&mutex_formato_precedente);
+
+    archivio->sorgente.carica = carica_storico_da_archivio;
+    archivio->sorgente.rilascia = rilascia_archivio_storici;
+    archivio->sorgente.riferimenti = 1;
+    return archivio;
+}
+
+/*
+ * Funzione: rilascia_riferimento_storici
+ * --------------------------------------
+ * Rilascia un riferimento all'archivio degli storici, chiudendolo se era l'ultimo.
+ */
+static void rilascia_riferimento_storici(struct archivio_storici *archivio){
+    if(--archivio->sorgente.riferimenti == 0) rilascia_archivio_storici(&archivio->sorgente);
+}
+
+/*
+ * Funzione: utente_da_record
+ * --------------------------
+ * Crea l'utente descritto dal record `indice`; lo storico di un cliente verrà
+ * costruito dall'archivio al primo accesso.
+ *
+ * Ritorna:
+ *    un nuovo utente, o NULL se il record non è valido
+ */
+static Utente utente_da_record(const struct sezioni_istantanea *utenti, struct archivio_storici *archivio, uint32_t indice){
+    struct record_utente record;
+    memcpy(&record, utenti->record + (size_t)indice * sizeof(record), sizeof(record));
+
+    const char *nome = stringa_istantanea(utenti, record.nome);
+    const char *cognome = stringa_istantanea(utenti, record.cognome);
+    const char *email = stringa_istantanea(utenti, record.email);
+    if(nome == NULL || cognome == NULL || email == NULL) return NULL;
+    if(!intervallo_record_valido(&archivio->sezioni, record.prima_prenotazione, record.num_prenotazioni)) return NULL;
+
+    if(record.permesso != CLIENTE) return crea_utente(email, record.password, nome, cognome, record.permesso);
+
+    return crea_cliente_differito(email, record.password, nome, cognome,
+                                  &archivio->sorgente, record.prima_prenotazione, record.num_prenotazioni);
+}
+
+/*
+ * Autore: Russo Nello Manuel
+ * Data: 18/05/2025
+ *
+ * Funzione: salva_vettore_veicoli
+ * -------------------------------
+ *
+ * salva su un file binario un vettore di veicoli e su un altro le relative prenotazioni
+ *
+ * Implementazione:
+ *    - Scrive i record dei veicoli e le prenotazioni (visitate in ordine, veicolo per
+ *    veicolo) nel flusso compatto, con cliente e targa come voci del dizionario e
+ *    inizi crescenti codificati come differenze, attraverso due buffer di uscita che
+ *    raggiungono i file con poche fwrite da DIMENSIONE_USCITA byte; in memoria restano
+ *    solo le due tabelle delle stringhe
+ *    - Accoda dizionario e tabelle delle stringhe e scrive le intestazioni con
+ *    `scrivi_istantanea`
+ *
+ * Parametri:
+ *    nome_file_veicolo: file in cui salvare i dati dei veicoli
+ *    nome_file_prenotazioni: file in cui salvare le prenotazioni
+ *    vettore: array di veicoli da salvare
+ *    num_veicoli: numero di elementi nel vettore
+ *    generazione: generazione del salvataggio, scritta nelle intestazioni dei due file
+ *
+ * Pre-condizioni:
+ *    nome_file_veicolo: deve essere diverso da NULL
+ *    nome_file_prenotazioni: deve essere diverso da NULL
+ *    vettore: deve essere diverso da NULL se num_veicoli è maggiore di 0
+ *
+ * Post-condizioni:
+ *    restituisce 1 se entrambi i file sono stati scritti e chiusi senza errori,
+ *    altrimenti 0. Con num_veicoli uguale a 0 vengono scritte istantanee vuote.
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    i dati dei veicoli e delle relative prenotazioni vengono scritti
+ *    nei file specificati in formato binario
+ */
+Byte salva_vettore_veicoli(const char *nome_file_veicolo, const char *nome_file_prenotazioni, Veicolo vettore[], unsigned int num_veicoli,
+                           uint64_t generazione){
+	if(nome_file_veicolo == NULL || nome_file_prenotazioni == NULL || (vettore == NULL && num_veicoli > 0)) return 0;
+
+    struct uscita record_veicoli;
+    struct tabella_stringhe stringhe_veicoli;
+    struct scrittore_prenotazioni prenotazioni;
+    memset(&stringhe_veicoli, 0, sizeof(stringhe_veicoli));
+    memset(&prenotazioni, 0, sizeof(prenotazioni));
+    prenotazioni.stringhe.con_dizionario = 1;
+
+    Byte esito = apri_uscita(&record_veicoli, nome_file_veicolo) &
+                 apri_uscita(&prenotazioni.record, nome_file_prenotazioni);
+    prenotazioni.errore = prenotazioni.record.errore;
+    for(unsigned int i = 0; i < num_veicoli && esito; i++){
+        Veicolo v = vettore[i];
+        if(v == NULL){
+            esito = 0;
+            break;
+        }
+
+        struct record_veicolo record;
+        memset(&record, 0, sizeof(record));
+        record.tariffa = ottieni_tariffa(v);
+        record.prima_prenotazione = inizia_sequenza(&prenotazioni);
+        uint32_t scritte = prenotazioni.num_record;
+
+        // Le prenotazioni mai usate vengono copiate dall'archivio senza costruire l'albero
+        SorgentePrenotazioni *sorgente;
+        unsigned int prima, num;
+        if(ottieni_prenotazioni_differite(v, &sorgente, &prima, &num) && sorgente->carica == carica_da_archivio)
+            copia_record_istantanea(&prenotazioni, &((struct archivio_prenotazioni *)sorgente)->sezioni, prima, num);
+        else
+            visita_prenotazioni_in_ordine(ottieni_prenotazioni(v), scrivi_prenotazione_visitata, &prenotazioni);
+        record.num_prenotazioni = prenotazioni.num_record - scritte;
+
+        esito = !prenotazioni.errore &&
+                inserisci_posizione(&stringhe_veicoli, ottieni_tipo_veicolo(v), &record.tipo) &&
+                inserisci_posizione(&stringhe_veicoli, ottieni_targa(v), &record.targa) &&
+                inserisci_posizione(&stringhe_veicoli, ottieni_modello(v), &record.modello) &&
+                inserisci_posizione(&stringhe_veicoli, ottieni_posizione(v), &record.posizione) &&
+                scrivi_uscita(&record_veicoli, &record, sizeof(record));
+    }
+
+    // Entrambe le uscite vanno chiuse anche in caso di errore
+    if(!esito) record_veicoli.errore = prenotazioni.record.errore = 1;
+    esito = scrivi_istantanea(&record_veicoli, ISTANTANEA_VEICOLI, num_veicoli, 0, &stringhe_veicoli, generazione) &
+            scrivi_istantanea(&prenotazioni.record, ISTANTANEA_PRENOTAZIONI, prenotazioni.num_record,
+                              (uint32_t)prenotazioni.dimensione_flusso, &prenotazioni.stringhe, generazione);
+
+    libera_tabella_stringhe(&stringhe_veicoli);
+    libera_tabella_stringhe(&prenotazioni.stringhe);
+    return esito;
+}
+
+/*
+ * Autore: Russo Nello Manuel
+ * Data: 18/05/2025
+ *
+ * Funzione: carica_vettore_veicoli
+ * --------------------------------
+ *
+ * carica un insieme di veicoli da un file binario e le relative prenotazioni da un secondo file binario
+ *
+ * Implementazione:
+ *    - Mappa in memoria le due istantanee e ne verifica le sezioni
+ *    - Crea ogni veicolo leggendo il record e le stringhe direttamente dall'immagine,
+ *    senza letture per campo né buffer temporanei
+ *    - Le prenotazioni non vengono costruite: ogni veicolo ricorda dove iniziano nel
+ *    flusso compatto (o tra i record CAS1) e costruisce l'albero al primo accesso. L'archivio resta mappato
+ *    finché almeno un veicolo non ha costruito le proprie prenotazioni
+ *    - Se il file dei veicoli non ha l'intestazione di un'istantanea, lo legge con
+ *    `carica_veicoli_formato_precedente`
+ *    - Rifiuta due file di generazioni diverse: i record dei veicoli indicherebbero
+ *    posizioni del flusso di un altro salvataggio
+ *
+ * Parametri:
+ *    nome_file_veicolo: nome del file contenente i dati dei veicoli
+ *    nome_file_prenotazioni: nome del file contenente le prenotazioni associate
+ *    num_veicoli: puntatore a variabile dove verrà salvato il numero di veicoli caricati
+ *
+ * Pre-condizioni:
+ *    nome_file_veicolo: deve essere diverso da NULL
+ *    nome_file_prenotazioni: deve essere diverso da NULL
+ *    num_veicoli: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    Restituisce un array di Veicolo e ne imposta la dimensione in num_veicoli, restituisce NULL in caso di errore
+ *
+ * Ritorna:
+ *    un array di Veicolo o NULL
+ *
+ * Side-effect:
+ *    Alloca memoria dinamicamente per il vettore restituito (va liberata dal chiamante)
+ */
+Veicolo *carica_vettore_veicoli(const char *nome_file_veicolo, const char *nome_file_prenotazioni, unsigned int *num_veicoli){
+	if(nome_file_veicolo == NULL || nome_file_prenotazioni == NULL || num_veicoli == NULL) return NULL;
+
+    Immagine immagine_veicoli = apri_immagine(nome_file_veicolo);
+    if(immagine_veicoli == NULL) return NULL;
+
+    if(!ha_intestazione_istantanea(immagine_veicoli)){
+        chiudi_immagine(immagine_veicoli);
+        pthread_mutex_lock(&mutex_formato_precedente);
+        Veicolo *vettore = carica_veicoli_formato_precedente(nome_file_veicolo, nome_file_prenotazioni, num_veicoli);
+        pthread_mutex_unlock(&mutex_formato_precedente);
+        return vettore;
+    }
+
+    struct archivio_prenotazioni *archivio = apri_archivio_prenotazioni(nome_file_prenotazioni);
+    struct sezioni_istantanea veicoli;
+    Veicolo *vettore = NULL;
+    *num_veicoli = 0;
+
+    if(archivio == NULL || !leggi_sezioni(immagine_veicoli, ISTANTANEA_VEICOLI, sizeof(struct record_veicolo), &veicoli)) goto fine;
+
+    // Un file dei veicoli di un altro salvataggio indicizzerebbe prenotazioni altrui
+    if(veicoli.intestazione.generazione != archivio->sezioni.intestazione.generazione) goto fine;
+
+    uint32_t n = veicoli.intestazione.num_record;
+    vettore = malloc(sizeof(Veicolo) * (n > 0 ? n : 1));
+    if(vettore == NULL) goto fine;
+
+    for(uint32_t i = 0; i < n; i++){
+        vettore[i] = veicolo_da_record(&veicoli, archivio, i);
+        if(vettore[i] == NULL){
+            // Se un caricamento fallisce, libera gli oggetti già caricati
+            for(uint32_t j = 0; j < i; j++) distruggi_veicolo(vettore[j]);
+            free(vettore);
+            vettore = NULL;
+            goto fine;
+        }
+    }
+    *num_veicoli = n;
+
+fine:
+    chiudi_immagine(immagine_veicoli);
+    if(archivio != NULL) rilascia_riferimento_archivio(archivio);
+    return vettore;
+}
+
+/*
+ * Funzione: salva_vettore_utenti
+ * ------------------------------
+ *
+ * Salva un array di utenti su due file: uno per l'anagrafica, uno per i dati.
+ *
+ * Implementazione:
+ *    Scrive i record degli utenti e, nel flusso compatto, gli storici dei clienti
+ *    (visitati con `visita_storico_utente`, senza copiarli) attraverso due buffer di uscita, che raggiungono i file con poche fwrite da DIMENSIONE_USCITA byte;
+ *    in memoria restano solo le due tabelle delle stringhe, accodate alla fine insieme
+ *    al dizionario degli storici e alle intestazioni da `scrivi_istantanea`.
+ *
+ * Parametri:
+ *    nome_file_utente: nome del file per l'anagrafica
+ *    nome_file_data: nome del file per i dati storici
+ *    vettore: array di puntatori a Utente
+ *    num_utenti: numero di utenti nell'array
+ *    generazione: generazione del salvataggio, scritta nelle intestazioni dei due file
+ *
+ * Pre-condizione:
+ *    nome_file_utente: non deve essere NULL
+ *    nome_file_data: non deve essere NULL
+ *    vettore: non deve essere NULL se num_utenti è maggiore di 0
+ *
+ * Post-condizione:
+ *    restituisce 1 se entrambi i file sono stati scritti e chiusi senza errori,
+ *    altrimenti 0. Con num_utenti uguale a 0 vengono scritte istantanee vuote.
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    i dati degli utenti sono scritti nei file
+ */
+Byte salva_vettore_utenti(const char *nome_file_utente, const char *nome_file_data, Utente vettore[], unsigned int num_utenti,
+                          uint64_t generazione){
+    if(nome_file_utente == NULL || nome_file_data == NULL || (vettore == NULL && num_utenti > 0)) return 0;
+
+    struct uscita record_utenti;
+    struct tabella_stringhe stringhe_utenti;
+    struct scrittore_prenotazioni storici;
+    memset(&stringhe_utenti, 0, sizeof(stringhe_utenti));
+    memset(&storici, 0, sizeof(storici));
+    storici.stringhe.con_dizionario = 1;
+
+    Byte esito = apri_uscita(&record_utenti, nome_file_utente) &
+                 apri_uscita(&storici.record, nome_file_data);
+    storici.errore = storici.record.errore;
+    for(unsigned int i = 0; i < num_utenti && esito; i++){
+        Utente u = vettore[i];
+        if(u == NULL){
+            esito = 0;
+            break;
+        }
+
+        struct record_utente record;
+        memset(&record, 0, sizeof(record));
+        memcpy(record.password, ottieni_password(u), DIMENSIONE_PASSWORD);
+        record.permesso = ottieni_permesso(u);
+        record.prima_prenotazione = inizia_sequenza(&storici);
+        uint32_t scritte = storici.num_record;
+
+        // Lo storico mai usato viene copiato dall'archivio senza costruire la lista
+        SorgenteStorico *sorgente;
+        unsigned int prima, num;
+        if(ottieni_storico_differito(u, &sorgente, &prima, &num) && sorgente->carica == carica_storico_da_archivio){
+            copia_record_istantanea(&storici, &((struct archivio_storici *)sorgente)->sezioni, prima, num);
+        }
+        else if(record.permesso == CLIENTE){ // Salva lo storico solo se l'utente è un CLIENTE
+            visita_storico_utente(u, scrivi_prenotazione_visitata, &storici);
+        }
+        record.num_prenotazioni = storici.num_record - scritte;
+
+        esito = !storici.errore &&
+                inserisci_posizione(&stringhe_utenti, ottieni_nome(u), &record.nome) &&
+                inserisci_posizione(&stringhe_utenti, ottieni_cognome(u), &record.cognome) &&
+                inserisci_posizione(&stringhe_utenti, ottieni_email(u), &record.email) &&
+                scrivi_uscita(&record_utenti, &record, sizeof(record));
+    }
+
+    // Entrambe le uscite vanno chiuse anche in caso di errore
+    if(!esito) record_utenti.errore = storici.record.errore = 1;
+    esito = scrivi_istantanea(&record_utenti, ISTANTANEA_UTENTI, num_utenti, 0, &stringhe_utenti, generazione) &
+            scrivi_istantanea(&storici.record, ISTANTANEA_STORICI, storici.num_record,
+                              (uint32_t)storici.dimensione_flusso, &storici.stringhe, generazione);
+
+    libera_tabella_stringhe(&stringhe_utenti);
+    libera_tabella_stringhe(&storici.stringhe);
+    return esito;
+}
+
+/*
+ * Funzione: carica_vettore_utenti
+ * -------------------------------
+ *
+ * Carica da due file un array di utenti.
+ *
+ * Implementazione:
+ *    Mappa in memoria le due istantanee e crea ogni utente leggendo record e stringhe
+ *    direttamente dall'immagine. Lo storico dei clienti non viene costruito: il
+ *    record dell'utente ne indica posizione e numero di prenotazioni, così il
+ *    conteggio è disponibile subito e la lista viene costruita al primo accesso.
+ *    Se il file degli utenti non ha l'intestazione di un'istantanea, lo legge con
+ *    `carica_utenti_formato_precedente`. Due file di generazioni diverse vengono rifiutati.
+ *
+ * Parametri:
+ *    nome_file_utente: nome del file contenente i dati anagrafici
+ *    nome_file_data: nome del file contenente i dati storici
+ *    num_utenti: puntatore a intero dove memorizzare il numero di utenti caricati
+ *
+ * Pre-condizione:
+ *    nome_file_utente: non deve essere NULL
+ *    nome_file_data: non deve essere NULL
+ *    num_utenti: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce il vettore contenente gli utenti caricati dai file
+ *
+ * Ritorna:
+ *    un array di Utente, o NULL in caso di errore
+ *
+ * Side-effect:
+ *    mappatura dei file, allocazione dinamica di memoria
+ */
+Utente *carica_vettore_utenti(const char *nome_file_utente, const char *nome_file_data, unsigned int *num_utenti){
+    if(nome_file_utente == NULL || nome_file_data == NULL || num_utenti == NULL) return NULL;
+
+    Immagine immagine_utenti = apri_immagine(nome_file_utente);
+    if(immagine_utenti == NULL) return NULL;
+
+    if(!ha_intestazione_istantanea(immagine_utenti)){
+        chiudi_immagine(immagine_utenti);
+        pthread_mutex_lock(&mutex_formato_precedente);
+        Utente *vettore = carica_utenti_formato_precedente(nome_file_utente, nome_file_data, num_utenti);
+        pthread_mutex_unlock(&mutex_formato_precedente);
+        return vettore;
+    }
+
+    struct archivio_storici *archivio = apri_archivio_storici(nome_file_data);
+    struct sezioni_istantanea utenti;
+    Utente *vettore = NULL;
+    *num_utenti = 0;
+
+    if(archivio == NULL || !leggi_sezioni(immagine_utenti, ISTANTANEA_UTENTI, sizeof(struct record_utente), &utenti)) goto fine;
+
+    // Come per i veicoli, gli storici devono essere dello stesso salvataggio
+    if(utenti.intestazione.generazione != archivio->sezioni.intestazione.generazione) goto fine;
+
+    uint32_t n = utenti.intestazione.num_record;
+    vettore = malloc(sizeof(Utente) * (n > 0 ? n : 1));
+    if(vettore == NULL) goto fine;
+
+    for(uint32_t i = 0; i < n; i++){
+        vettore[i] = utente_da_record(&utenti, archivio, i);
+        if(vettore[i] == NULL){
+            // Se un caricamento fallisce, libera gli oggetti già caricati
+            for(uint32_t j = 0; j < i; j++) distruggi_utente(vettore[j]);
+            free(vettore);
+            vettore = NULL;
+            goto fine;
+        }
+    }
+    *num_utenti = n;
+
+fine:
+    chiudi_immagine(immagine_utenti);
+    if(archivio != NULL) rilascia_riferimento_storici(archivio);
+    return vettore;
+}
+
+/*
+ * Funzione: generazione_istantanea
+ * --------------------------------
+ * Legge la generazione di un'istantanea completa.
+ *
+ * Implementazione:
+ *    Mappa il file e ne verifica le sezioni con `leggi_sezioni`, con il tipo indicato
+ *    nell'intestazione: un file interrotto durante la scrittura ha l'intestazione a zero
+ *    (viene scritta per ultima) o una dimensione diversa da quella attesa.
+ *
+ * Ritorna:
+ *    la generazione, o 0 se il file manca, non è valido o è in un formato senza generazione
+ */
+uint64_t generazione_istantanea(const char *nome_file){
+    if(nome_file == NULL) return 0;
+
+    Immagine immagine = apri_immagine(nome_file);
+    const unsigned char *dati = dati_immagine(immagine);
+    struct intestazione_istantanea intestazione;
+    struct sezioni_istantanea sezioni;
+    uint64_t generazione = 0;
+
+    if(dati != NULL && dimensione_immagine(immagine) >= sizeof(intestazione)){
+        memcpy(&intestazione, dati, sizeof(intestazione));
+        size_t dimensione_record = intestazione.tipo == ISTANTANEA_VEICOLI ? sizeof(struct record_veicolo) :
+                                   intestazione.tipo == ISTANTANEA_UTENTI ? sizeof(struct record_utente) :
+                                   sizeof(struct record_prenotazione);
+        if(intestazione.magico == MAGICO_ISTANTANEA_GENERAZIONE &&
+           leggi_sezioni(immagine, intestazione.tipo, dimensione_record, &sezioni))
+            generazione = sezioni.intestazione.generazione;
+    }
+    chiudi_immagine(immagine);
+    return generazione;
+}
+
+/*
+ * Funzione: sincronizza_cartella
+ * ------------------------------
+ * Porta su disco la cartella che contiene `nome_file`, e con essa i rename appena fatti.
+ *
+ * Ritorna:
+ *    1 in caso di successo (o dove non è supportato), 0 altrimenti
+ */
+static Byte sincronizza_cartella(const char *nome_file){
+#ifndef _WIN32
+    char cartella[DIMENSIONE_BUFFER] = ".";
+    const char *separatore = strrchr(nome_file, '/');
+    if(separatore != NULL){
+        size_t lunghezza = separatore == nome_file ? 1 : (size_t)(separatore - nome_file);
+        if(lunghezza >= sizeof(cartella)) return 0;
+        memcpy(cartella, nome_file, lunghezza);
+        cartella[lunghezza] = '\0';
+    }
+
+    int fd = open(cartella, O_RDONLY);
+    if(fd < 0) return 0;
+    Byte esito = fsync(fd) == 0;
+    close(fd);
+    return esito;
+#else
+    (void)nome_file;
+    return 1;
+#endif
+}
+
+/*
+ * Funzione: sostituisci_istantanee
+ * --------------------------------
+ * Sostituisce con rename i file definitivi con quelli temporanei appena salvati.
+ *
+ * Implementazione:
+ *    I temporanei sono già su disco (`chiudi_uscita` li sincronizza): dopo i rename
+ *    viene sincronizzata anche la cartella. Se il processo si interrompe a metà, i
+ *    temporanei rimasti hanno la generazione dei file già sostituiti e vengono
+ *    rinominati da `completa_sostituzione_istantanee` al riavvio.
+ *
+ * Ritorna:
+ *    1 se tutti i file sono stati sostituiti, 0 altrimenti
+ */
+Byte sostituisci_istantanee(const char *temporanei[], const char *definitivi[], unsigned int num_file){
+    if(temporanei == NULL || definitivi == NULL) return 0;
+
+    for(unsigned int i = 0; i < num_file; i++)
+        if(rename(temporanei[i], definitivi[i]) != 0) return 0;
+
+    Byte esito = 1;
+    for(unsigned int i = 0; i < num_file; i++) esito &= sincronizza_cartella(definitivi[i]);
+    return esito;
+}
+
+/*
+ * Funzione: completa_sostituzione_istantanee
+ * ------------------------------------------
+ * Completa una sostituzione interrotta, o ne scarta i temporanei.
+ *
+ * Implementazione:
+ *    Un temporaneo valido la cui generazione coincide con quella di un file
+ *    definitivo appartiene a un salvataggio di cui almeno un rename è avvenuto, quindi
+ *    tutti i suoi temporanei erano completi: viene rinominato. Gli altri temporanei
+ *    (salvataggio interrotto prima di ogni rename) vengono rimossi.
+ *
+ * Ritorna:
+ *    1 se non restano temporanei da sostituire, 0 se un rename è fallito
+ */
+Byte completa_sostituzione_istantanee(const char *temporanei[], const char *definitivi[], unsigned int num_file){
+    if(temporanei == NULL || definitivi == NULL) return 0;
+
+    Byte esito = 1, rinominati = 0;
+    for(unsigned int i = 0; i < num_file; i++){
+        uint64_t generazione = generazione_istantanea(temporanei[i]);
+        Byte completo = 0;
+        for(unsigned int j = 0; j < num_file && generazione != 0 && !completo; j++)
+            completo = generazione_istantanea(definitivi[j]) == generazione;
+
+        if(!completo) remove(temporanei[i]);
+        else if(rename(temporanei[i], definitivi[i]) != 0) esito = 0;
+        else rinominati = 1;
+    }
+
+    if(rinominati) esito &= sincronizza_cartella(definitivi[0]);
+    return esito;
+}
+
+/*
+ * Funzione: carica_tabella_utenti
+ * -------------------------------
+ * Carica gli utenti dell'archivio in una tabella di almeno `grandezza` posizioni.
+ *
+ * Implementazione:
+ *    Se il caricamento fallisce crea una tabella vuota, altrimenti una grande il
+ *    doppio degli utenti caricati, in cui li inserisce.
+ *
+ * Ritorna:
+ *    la tabella, o NULL se non è stato possibile crearla
+ */
+static TabellaUtenti carica_tabella_utenti(unsigned int grandezza, const char *file_utente, const char *file_dati){
+    TabellaUtenti tabella_utenti = NULL;
+
+    unsigned int num_utenti_caricati = 0;
+    Utente *utenti_caricati = carica_vettore_utenti(file_utente, file_dati, &num_utenti_caricati);
+
+    if(utenti_caricati == NULL){
+        tabella_utenti = crea_tabella_utenti(grandezza);
+        return tabella_utenti;
+    }
+
+    unsigned int dimensione_tabella = (num_utenti_caricati * 2 > grandezza) ?
+                                      num_utenti_caricati * 2 : grandezza;
+    tabella_utenti = crea_tabella_utenti(dimensione_tabella);
+
+    if(tabella_utenti == NULL){
+        printf("Errore caricamento utenti!\n");
+        // Pulizia sicura degli utenti caricati
+        for(unsigned i = 0; i < num_utenti_caricati; i++) {
+            if(utenti_caricati[i] != NULL) {
+                distruggi_utente(utenti_caricati[i]);
+            }
+        }
+        free(utenti_caricati);
+        return NULL;
+    }
+
+    carica_utenti(tabella_utenti, utenti_caricati, num_utenti_caricati);
+
+    // Pulizia sicura del vettore
+    free(utenti_caricati);
+    utenti_caricati = NULL;
+
+    return tabella_utenti;
+}
+
+/*
+ * Funzione: carica_tabella_veicoli
+ * --------------------------------
+ * Carica i veicoli dell'archivio in una tabella di almeno `grandezza` posizioni,
+ * come `carica_tabella_utenti`.
+ *
+ * Ritorna:
+ *    la tabella, o NULL se non è stato possibile crearla
+ */
+static TabellaVeicoli carica_tabella_veicoli(unsigned int grandezza, const char *file_veicolo, const char *file_prenotazioni){
+    TabellaVeicoli tabella_veicoli = NULL;
+
+    unsigned int num_veicoli_caricati = 0;
+    Veicolo *veicoli_caricati = carica_vettore_veicoli(file_veicolo, file_prenotazioni, &num_veicoli_caricati);
+
+    if(veicoli_caricati == NULL){
+        tabella_veicoli = crea_tabella_veicoli(grandezza);
+        return tabella_veicoli;
+    }
+
+    unsigned int dimensione_tabella = (num_veicoli_caricati * 2 > grandezza) ?
+                                      num_veicoli_caricati * 2 : grandezza;
+    tabella_veicoli = crea_tabella_veicoli(dimensione_tabella);
+
+    if(tabella_veicoli == NULL){
+        printf("Errore caricamento veicoli!\n");
+        for(unsigned i = 0; i < num_veicoli_caricati; i++) {
+            if(veicoli_caricati[i] != NULL) {
+                distruggi_veicolo(veicoli_caricati[i]);
+            }
+        }
+        free(veicoli_caricati);
+        return NULL;
+    }
+
+    carica_veicoli(tabella_veicoli, veicoli_caricati, num_veicoli_caricati);
+
+    free(veicoli_caricati);
+    veicoli_caricati = NULL;
+
+    return tabella_veicoli;
+}
+
+/*
+ * Funzione: carica_tabella_blocco
+ * -------------------------------
+ * Carica le tabelle di indice [inizio, fine): 0 è la tabella degli utenti, 1 quella dei
+ * veicoli. Eseguita da `esegui_a_blocchi` con blocchi di una tabella.
+ */
+static void carica_tabella_blocco(void *contesto, unsigned int inizio, unsigned int fine){
+    struct tabelle_caricate *tabelle = contesto;
+
+    for(unsigned int i = inizio; i < fine; i++){
+        if(i == 0) tabelle->utenti = carica_tabella_utenti(tabelle->grandezza, tabelle->file_archivio[0], tabelle->file_archivio[1]);
+        else tabelle->veicoli = carica_tabella_veicoli(tabelle->grandezza, tabelle->file_archivio[2], tabelle->file_archivio[3]);
+    }
+}
+
+/*
+ * Funzione: carica_tabelle
+ * ------------------------
+ * Carica le tabelle degli utenti e dei veicoli dai file dell'archivio.
+ *
+ * Implementazione:
+ *    Le due tabelle vengono caricate contemporaneamente su due thread da
+ *    `esegui_a_blocchi`, che con un solo thread le carica una dopo l'altra.
+ *
+ * Ritorna:
+ *    1 se entrambe le tabelle sono state create, 0 altrimenti
+ */
+Byte carica_tabelle(const char *file_archivio[], unsigned int grandezza, TabellaUtenti *tabella_utenti, TabellaVeicoli *tabella_veicoli){
+    if(file_archivio == NULL || tabella_utenti == NULL || tabella_veicoli == NULL) return 0;
+
+    struct tabelle_caricate tabelle = { file_archivio, grandezza, NULL, NULL };
+    esegui_a_blocchi(2, 1, carica_tabella_blocco, &tabelle);
+
+    if(tabelle.utenti == NULL || tabelle.veicoli == NULL){
+        // Pulizia delle risorse parzialmente allocate
+        if(tabelle.utenti != NULL) distruggi_tabella_utenti(tabelle.utenti);
+        if(tabelle.veicoli != NULL) distruggi_tabella_veicoli(tabelle.veicoli);
+        *tabella_utenti = NULL;
+        *tabella_veicoli = NULL;
+        return 0;
+    }
+
+    *tabella_utenti = tabelle.utenti;
+    *tabella_veicoli = tabelle.veicoli;
+    return 1;
+}
@@ -0,0 +1,215 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include "utils/gestore_prenotazioni.h"
+#include "utils/giornale.h"
+#include "modelli/intervallo.h"
+#include "modelli/prenotazione.h"
+#include "modelli/utente.h"
+#include "modelli/veicolo.h"
+#include "strutture_dati/prenotazioni.h"
+#include "strutture_dati/tabella_utenti.h"
+#include "strutture_dati/tabella_veicoli.h"
+
+/*
+ * Funzione: ignora_prenotazione
+ * -----------------------------
+ * Visitatore vuoto: visitare uno storico ancora nell'archivio basta a costruirlo.
+ */
+static void ignora_prenotazione(const Prenotazione p, void *contesto){
+    (void)p;
+    (void)contesto;
+}
+
+/*
+ * Funzione: costruisci_storico_del_cliente
+ * ----------------------------------------
+ * Costruisce lo storico del cliente di `p` se è ancora nell'archivio e lo restituisce.
+ *
+ * Implementazione:
+ *    Lo storico costruito condivide le prenotazioni vive con lo stesso identificativo e
+ *    gli stessi dati. Va quindi costruito prima di cambiare `p`: dopo, il suo record non
+ *    coinciderebbe più e lo storico ne creerebbe una copia con un altro identificativo.
+ */
+static Utente costruisci_storico_del_cliente(TabellaUtenti tabella_utenti, Prenotazione p){
+    SorgenteStorico *sorgente;
+    unsigned int prima, num;
+    Utente u = cerca_utente_in_tabella(tabella_utenti, ottieni_cliente_prenotazione(p));
+    if(u != NULL && ottieni_storico_differito(u, &sorgente, &prima, &num)) visita_storico_utente(u, ignora_prenotazione, NULL);
+    return u;
+}
+
+/*
+ * Funzione: cancella_prenotazione_per_id
+ * --------------------------------------
+ * Cancella la prenotazione con l'identificativo dato dal veicolo e dallo storico del cliente.
+ *
+ * Implementazione:
+ *    Trova la prenotazione nell'indice per identificativo e ne prende un riferimento,
+ *    così resta valida mentre le viste rilasciano i propri. Costruito lo storico del
+ *    cliente, se era ancora nell'archivio, la toglie dall'albero del
+ *    veicolo, cercandola per intervallo in tempo logaritmico, e dallo storico del cliente,
+ *    da cui si stacca in tempo costante perché vi è collegata (`rimuovi_da_storico_lista`).
+ *    Se è stata tolta da almeno una delle due viste registra la cancellazione nel giornale.
+ *
+ * Parametri:
+ *    tabella_utenti: tabella degli utenti
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare la cancellazione (può essere NULL)
+ *    id: identificativo della prenotazione
+ *
+ * Pre-condizioni:
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se la prenotazione è stata tolta dal veicolo o dallo storico,
+ *    0 se nessuna prenotazione viva ha quell'identificativo o non è in nessuno dei due
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    modifica l'albero del veicolo e lo storico del cliente, scrive un record nel giornale;
+ *    la prenotazione viene liberata se nessun'altra vista la usa
+ */
+Byte cancella_prenotazione_per_id(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale, uint64_t id){
+    Prenotazione p = condividi_prenotazione(cerca_prenotazione_per_id(id));
+    if(p == NULL) return 0;
+
+    costruisci_storico_del_cliente(tabella_utenti, p);
+    Veicolo v = cerca_veicolo_in_tabella(tabella_veicoli, ottieni_veicolo_prenotazione(p));
+    Byte dal_veicolo = v != NULL && rimuovi_prenotazione_veicolo(v, ottieni_intervallo_prenotazione(p));
+
+    // Una prenotazione fuori dallo storico è una copia dell'albero (archivi senza identificativi):
+    // lo storico la cerca per intervallo
+    Utente u = cerca_utente_in_tabella(tabella_utenti, ottieni_cliente_prenotazione(p));
+    Byte dallo_storico = u != NULL && (dal_veicolo || appartiene_a_storico(p)) && rimuovi_da_storico_utente(u, p);
+    if(dal_veicolo || dallo_storico) registra_cancellazione_in_giornale(giornale, p);
+
+    distruggi_prenotazione(p);
+    return dal_veicolo || dallo_storico;
+}
+
+/*
+ * Funzione: cancella_prenotazioni_per_id
+ * --------------------------------------
+ * Cancella le prenotazioni con gli identificativi dati, come `cancella_prenotazione_per_id`.
+ *
+ * Implementazione:
+ *    Ogni cancellazione costa una ricerca nell'indice, una nell'albero del veicolo e
+ *    uno stacco in tempo costante dallo storico: il totale non dipende dal numero di
+ *    prenotazioni degli storici. Gli identificativi non trovati vengono ignorati.
+ *
+ * Parametri:
+ *    tabella_utenti: tabella degli utenti
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare le cancellazioni (può essere NULL)
+ *    id: vettore degli identificativi
+ *    num_id: numero di elementi di `id`
+ *
+ * Pre-condizioni:
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *    id: non deve essere NULL se num_id è maggiore di 0
+ *
+ * Post-condizioni:
+ *    restituisce il numero di prenotazioni cancellate
+ *
+ * Ritorna:
+ *    un intero senza segno
+ *
+ * Side-effect:
+ *    come `cancella_prenotazione_per_id`, per ogni identificativo
+ */
+unsigned int cancella_prenotazioni_per_id(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale,
+                                          const uint64_t *id, unsigned int num_id){
+    unsigned int cancellate = 0;
+    if(id == NULL) return 0;
+
+    for(unsigned int i = 0; i < num_id; i++)
+        cancellate += cancella_prenotazione_per_id(tabella_utenti, tabella_veicoli, giornale, id[i]);
+    return cancellate;
+}
+
+/*
+ * Funzione: modifica_prenotazione_per_id
+ * --------------------------------------
+ * Sposta la prenotazione con l'identificativo dato nell'intervallo `nuovo` e ne aggiorna
+ * il costo.
+ *
+ * Implementazione:
+ *    Toglie la prenotazione dall'albero del veicolo, tenendone un riferimento, ne cambia
+ *    intervallo e costo e la reinserisce: l'indice di disponibilità del veicolo resta così
+ *    coerente. Se il nuovo intervallo si sovrappone a un'altra prenotazione vengono
+ *    ripristinati i valori precedenti. Lo storico del cliente non va toccato perché
+ *    condivide la stessa prenotazione; se è ancora nell'archivio viene costruito prima
+ *    della modifica, così da condividerla anch'esso. Se invece ne ha una copia (archivi
+ *    senza identificativi), la copia viene sostituita dalla prenotazione.
+ *    Nel giornale la modifica è una cancellazione con i valori precedenti seguita da una
+ *    prenotazione con i valori finali, entrambe con lo stesso identificativo.
+ *
+ * Parametri:
+ *    tabella_utenti: tabella degli utenti
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare la modifica (può essere NULL)
+ *    id: identificativo della prenotazione
+ *    nuovo: il nuovo intervallo
+ *    costo: il nuovo costo
+ *
+ * Pre-condizioni:
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *    nuovo: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se la prenotazione è stata modificata, 0 se non esiste, se il suo
+ *    veicolo non è in tabella o se `nuovo` si sovrappone a un'altra prenotazione del
+ *    veicolo; in questi casi la prenotazione resta invariata
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    può costruire lo storico del cliente; modifica la prenotazione e l'albero del veicolo,
+ *    scrive due record nel giornale
+ */
+Byte modifica_prenotazione_per_id(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale, uint64_t id,
+                                  Intervallo nuovo, double costo){
+    Prenotazione p = cerca_prenotazione_per_id(id);
+    if(p == NULL || nuovo == NULL) return 0;
+
+    Veicolo v = cerca_veicolo_in_tabella(tabella_veicoli, ottieni_veicolo_prenotazione(p));
+    Intervallo vecchio = duplica_intervallo(ottieni_intervallo_prenotazione(p));
+    if(v == NULL || vecchio == NULL){
+        distruggi_intervallo(vecchio);
+        return 0;
+    }
+    double vecchio_costo = ottieni_costo_prenotazione(p);
+
+    // Negli archivi senza identificativi lo storico ha una copia della prenotazione
+    // dell'albero: la copia lascia il posto alla prenotazione, che così condividono
+    Utente u = costruisci_storico_del_cliente(tabella_utenti, p);
+    if(u != NULL && !appartiene_a_storico(p) && rimuovi_da_storico_utente(u, p)) aggiungi_a_storico_utente(u, p);
+
+    // Il riferimento preso qui passa all'albero quando la prenotazione viene reinserita
+    condividi_prenotazione(p);
+    if(!rimuovi_prenotazione_veicolo(v, vecchio)){
+        distruggi_prenotazione(p);
+        distruggi_intervallo(vecchio);
+        return 0;
+    }
+    registra_cancellazione_in_giornale(giornale, p);
+
+    imposta_intervallo_prenotazione(p, nuovo);
+    imposta_costo_prenotazione(p, costo);
+    Byte esito = ottieni_intervallo_prenotazione(p) != NULL && aggiungi_prenotazione_veicolo(v, p) == OK;
+    if(!esito){
+        imposta_intervallo_prenotazione(p, vecchio);
+        imposta_costo_prenotazione(p, vecchio_costo);
+    }
+    registra_prenotazione_in_giornale(giornale, p);
+    if(!esito && aggiungi_prenotazione_veicolo(v, p) != OK) distruggi_prenotazione(p);
+
+    distruggi_intervallo(vecchio);
+    return esito;
+}
@@ -0,0 +1,940 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils/giornale.h"
+#include "modelli/intervallo.h"
+#include "modelli/prenotazione.h"
+#include "modelli/utente.h"
+#include "modelli/veicolo.h"
+#include "strutture_dati/lista.h"
+#include "strutture_dati/lista_prenotazione.h"
+#include "strutture_dati/prenotazioni.h"
+#include "strutture_dati/tabella_utenti.h"
+#include "strutture_dati/tabella_veicoli.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// Tipi di record
+#define RECORD_UTENTE 1
+#define RECORD_VEICOLO 2
+#define RECORD_RIMOZIONE_VEICOLO 3
+#define RECORD_PRENOTAZIONE 4
+#define RECORD_CANCELLAZIONE 5
+
+#define DIMENSIONE_INTESTAZIONE (sizeof(unsigned int) + sizeof(Byte))
+#define DIMENSIONE_MASSIMA_RECORD 65536    // Oltre questa lunghezza un record è considerato corrotto
+#define ESTENSIONE_TEMPORANEA ".tmp"
+
+struct giornale {
+    FILE *fp;
+    char *nome_file;
+    unsigned int num_record;    // Record contenuti nel file
+    Byte integro;               // 0 dopo una scrittura fallita o una coda corrotta
+    Byte confine_segnato;       // 1 tra `segna_confine_giornale` e lo scarto dei record precedenti
+    long confine;               // Byte del file contenuti nell'istantanea in corso di salvataggio
+    unsigned int record_al_confine;
+    unsigned char *record;      // Record in composizione
+    size_t lunghezza;
+    size_t capacita;
+};
+
+/*
+ * Contenuto di un record letto dal file, consumato campo per campo.
+ */
+struct lettore {
+    unsigned char *dati;
+    size_t resto;
+};
+
+/*
+ * Funzione: controllo_fnv1a
+ * -------------------------
+ * Calcola l'hash FNV-1a a 32 bit dei byte indicati.
+ */
+static uint32_t controllo_fnv1a(const unsigned char *dati, size_t n){
+    uint32_t h = 2166136261u;
+    for(size_t i = 0; i < n; i++){
+        h ^= dati[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/*
+ * Funzione: accoda_dati
+ * ---------------------
+ * Aggiunge `n` byte al record in composizione, ingrandendo il buffer se necessario.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 in caso di errore di allocazione
+ */
+static Byte accoda_dati(struct giornale *giornale, const void *dati, size_t n){
+    if(giornale->lunghezza + n > giornale->capacita){
+        size_t nuova_capacita = giornale->capacita ? giornale->capacita : 256;
+        while(nuova_capacita < giornale->lunghezza + n) nuova_capacita *= 2;
+        unsigned char *nuovo = realloc(giornale->record, nuova_capacita);
+        if(nuovo == NULL) return 0;
+        giornale->record = nuovo;
+        giornale->capacita = nuova_capacita;
+    }
+    memcpy(giornale->record + giornale->lunghezza, dati, n);
+    giornale->lunghezza += n;
+    return 1;
+}
+
+/*
+ * Funzione: accoda_stringa
+ * ------------------------
+ * Aggiunge al record una stringa nello stesso formato dei file dell'archivio:
+ * lunghezza (terminatore compreso) seguita dai caratteri.
+ */
+static Byte accoda_stringa(struct giornale *giornale, const char *s){
+    if(s == NULL) return 0;
+    unsigned int len = (unsigned int)strlen(s) + 1;
+    return accoda_dati(giornale, &len, sizeof(len)) && accoda_dati(giornale, s, len);
+}
+
+/*
+ * Funzione: inizia_record
+ * -----------------------
+ * Prepara un nuovo record del tipo indicato, lasciando spazio per la lunghezza.
+ */
+static Byte inizia_record(struct giornale *giornale, Byte tipo){
+    unsigned int lunghezza = 0;
+    giornale->lunghezza = 0;
+    return accoda_dati(giornale, &lunghezza, sizeof(lunghezza)) && accoda_dati(giornale, &tipo, sizeof(tipo));
+}
+
+/*
+ * Funzione: scrivi_record
+ * -----------------------
+ * Completa il record in composizione e lo scrive in coda al file.
+ *
+ * Implementazione:
+ *    Inserisce la lunghezza del contenuto, aggiunge il codice di controllo e
+ *    scrive il record con una sola fwrite seguita da fflush, così che un arresto
+ *    del programma non perda i record già registrati.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 altrimenti (il giornale non è più integro)
+ */
+static Byte scrivi_record(struct giornale *giornale){
+    if(giornale->fp == NULL){
+        giornale->integro = 0;
+        return 0;
+    }
+
+    unsigned int lunghezza = (unsigned int)(giornale->lunghezza - DIMENSIONE_INTESTAZIONE);
+    memcpy(giornale->record, &lunghezza, sizeof(lunghezza));
+
+    uint32_t controllo = controllo_fnv1a(giornale->record + sizeof(lunghezza),
+                                         giornale->lunghezza - sizeof(lunghezza));
+    if(!accoda_dati(giornale, &controllo, sizeof(controllo)) ||
+       fwrite(giornale->record, 1, giornale->lunghezza, giornale->fp) != giornale->lunghezza ||
+       fflush(giornale->fp) != 0){
+        giornale->integro = 0;
+        return 0;
+    }
+
+    giornale->num_record++;
+    return 1;
+}
+
+/*
+ * Funzione: leggi_dati
+ * --------------------
+ * Consuma `n` byte dal contenuto del record.
+ *
+ * Ritorna:
+ *    1 in caso di successo, 0 se il contenuto è terminato
+ */
+static Byte leggi_dati(struct lettore *lettore, void *dati, size_t n){
+    if(lettore->resto < n) return 0;
+    memcpy(dati, lettore->dati, n);
+    lettore->dati += n;
+    lettore->resto -= n;
+    return 1;
+}
+
+/*
+ * Funzione: leggi_stringa
+ * -----------------------
+ * Consuma una stringa scritta da `accoda_stringa`.
+ *
+ * Ritorna:
+ *    la stringa, che punta dentro il contenuto del record, oppure NULL se non è valida
+ */
+static char *leggi_stringa(struct lettore *lettore){
+    unsigned int len;
+    if(!leggi_dati(lettore, &len, sizeof(len))) return NULL;
+    if(len == 0 || lettore->resto < len || lettore->dati[len - 1] != '\0') return NULL;
+
+    char *s = (char *)lettore->dati;
+    lettore->dati += len;
+    lettore->resto -= len;
+    return s;
+}
+
+/*
+ * Funzione: cerca_prenotazione_esatta
+ * -----------------------------------
+ * Visitatore che segnala una prenotazione con gli stessi estremi di quella cercata.
+ */
+static void cerca_prenotazione_esatta(const Prenotazione p, void *cercata){
+    Intervallo i = ottieni_intervallo_prenotazione(p);
+    Intervallo c = ottieni_intervallo_prenotazione(*(Prenotazione *)cercata);
+    if(inizio_intervallo(i) == inizio_intervallo(c) && fine_intervallo(i) == fine_intervallo(c))
+        *(Prenotazione *)cercata = NULL;
+}
+
+/*
+ * Funzione: veicolo_ha_prenotazione
+ * ---------------------------------
+ * Indica se il veicolo ha una prenotazione con gli stessi estremi di `p`.
+ */
+static Byte veicolo_ha_prenotazione(Veicolo v, Prenotazione p){
+    Intervallo i = ottieni_intervallo_prenotazione(p);
+    Prenotazione cercata = p;
+    visita_prenotazioni_in_intervallo(ottieni_prenotazioni(v), inizio_intervallo(i), fine_intervallo(i),
+                                      cerca_prenotazione_esatta, &cercata);
+    return cercata == NULL;
+}
+
+/*
+ * Funzione: ignora_prenotazione
+ * -----------------------------
+ * Visitatore vuoto: visitare uno storico ancora nell'archivio basta a costruirlo.
+ */
+static void ignora_prenotazione(const Prenotazione p, void *contesto){
+    (void)p;
+    (void)contesto;
+}
+
+/*
+ * Funzione: storico_ha_prenotazione
+ * ---------------------------------
+ * Indica se lo storico dell'utente contiene la prenotazione `p`, letta da un record
+ * con identificativo `id` (0 se il record non lo ha).
+ *
+ * Implementazione:
+ *    Con l'identificativo basta controllare se la prenotazione viva con quell'identificativo
+ *    è collegata a uno storico: lo storico, se è ancora nell'archivio, viene costruito una
+ *    sola volta e le sue prenotazioni condividono quella del giornale. Senza identificativo,
+ *    o se `p` ne ha ricevuto un altro, cerca nella copia dello storico una prenotazione
+ *    dello stesso veicolo con gli stessi estremi.
+ */
+static Byte storico_ha_prenotazione(Utente u, Prenotazione p, uint64_t id){
+    if(id != 0 && id == ottieni_id_prenotazione(p)){
+        SorgenteStorico *sorgente;
+        unsigned int prima, num;
+        if(ottieni_storico_differito(u, &sorgente, &prima, &num)) visita_storico_utente(u, ignora_prenotazione, NULL);
+        return appartiene_a_storico(cerca_prenotazione_per_id(id));
+    }
+
+    Intervallo i = ottieni_intervallo_prenotazione(p);
+    ListaPre storico = ottieni_storico_utente(u);
+    Byte trovata = 0;
+
+    for(ListaPre curr = storico; curr != NULL && !trovata; curr = ottieni_prossimo(curr)){
+        Prenotazione s = (Prenotazione)ottieni_item(curr);
+        Intervallo j = ottieni_intervallo_prenotazione(s);
+        trovata = inizio_intervallo(i) == inizio_intervallo(j) && fine_intervallo(i) == fine_intervallo(j) &&
+                  strcmp(ottieni_veicolo_prenotazione(s), ottieni_veicolo_prenotazione(p)) == 0;
+    }
+
+    distruggi_lista_prenotazione(storico);
+    return trovata;
+}
+
+/*
+ * Funzione: applica_utente
+ * ------------------------
+ * Riapplica un record RECORD_UTENTE: aggiunge l'utente se la sua email non è già registrata.
+ */
+static Byte applica_utente(struct lettore *lettore, TabellaUtenti tabella_utenti){
+    uint8_t password[DIMENSIONE_PASSWORD];
+    Byte permesso;
+    char *nome = leggi_stringa(lettore);
+    char *cognome = leggi_stringa(lettore);
+    char *email = leggi_stringa(lettore);
+    if(email == NULL || nome == NULL || cognome == NULL) return 0;
+    if(!leggi_dati(lettore, password, DIMENSIONE_PASSWORD) || !leggi_dati(lettore, &permesso, sizeof(permesso))) return 0;
+
+    if(cerca_utente_in_tabella(tabella_utenti, email) != NULL) return 1;
+
+    Utente u = crea_utente(email, password, nome, cognome, permesso);
+    if(u == NULL) return 0;
+    if(!aggiungi_utente_in_tabella(tabella_utenti, u)) distruggi_utente(u);
+    return 1;
+}
+
+/*
+ * Funzione: applica_veicolo
+ * -------------------------
+ * Riapplica un record RECORD_VEICOLO: aggiunge il veicolo se la sua targa non è già presente.
+ */
+static Byte applica_veicolo(struct lettore *lettore, TabellaVeicoli tabella_veicoli){
+    double tariffa;
+    char *tipo = leggi_stringa(lettore);
+    char *targa = leggi_stringa(lettore);
+    char *modello = leggi_stringa(lettore);
+    char *posizione = leggi_stringa(lettore);
+    if(tipo == NULL || targa == NULL || modello == NULL || posizione == NULL) return 0;
+    if(!leggi_dati(lettore, &tariffa, sizeof(tariffa))) return 0;
+
+    if(cerca_veicolo_in_tabella(tabella_veicoli, targa) != NULL) return 1;
+
+    Prenotazioni prenotazioni = crea_prenotazioni();
+    if(prenotazioni == NULL) return 0;
+    Veicolo v = crea_veicolo(tipo, targa, modello, posizione, tariffa, prenotazioni);
+    if(v == NULL){
+        distruggi_prenotazioni(prenotazioni);
+        return 0;
+    }
+    if(!aggiungi_veicolo_in_tabella(tabella_veicoli, v)) distruggi_veicolo(v);
+    return 1;
+}
+
+/*
+ * Funzione: applica_rimozione_veicolo
+ * -----------------------------------
+ * Riapplica un record RECORD_RIMOZIONE_VEICOLO: rimuove il veicolo se presente.
+ */
+static Byte applica_rimozione_veicolo(struct lettore *lettore, TabellaVeicoli tabella_veicoli){
+    char *targa = leggi_stringa(lettore);
+    if(targa == NULL) return 0;
+
+    rimuovi_veicolo_in_tabella(tabella_veicoli, targa);
+    return 1;
+}
+
+/*
+ * Funzione: leggi_prenotazione
+ * ----------------------------
+ * Ricostruisce la prenotazione contenuta in un record RECORD_PRENOTAZIONE o RECORD_CANCELLAZIONE.
+ * L'identificativo in coda manca nei record scritti prima della sua introduzione: in quel
+ * caso la prenotazione ne riceve uno nuovo. Se la prenotazione con quell'identificativo è
+ * ancora viva viene restituito un suo riferimento. In `id` scrive l'identificativo del
+ * record, 0 se manca.
+ *
+ * Ritorna:
+ *    una prenotazione (il cui riferimento va rilasciato dal chiamante) oppure NULL
+ */
+static Prenotazione leggi_prenotazione(struct lettore *lettore, uint64_t *id){
+    double costo;
+    time_t inizio, fine;
+    char *cliente = leggi_stringa(lettore);
+    char *targa = leggi_stringa(lettore);
+    if(cliente == NULL || targa == NULL) return NULL;
+    if(!leggi_dati(lettore, &costo, sizeof(costo)) || !leggi_dati(lettore, &inizio, sizeof(inizio)) ||
+       !leggi_dati(lettore, &fine, sizeof(fine))) return NULL;
+    *id = 0;
+    if(lettore->resto >= sizeof(*id)) leggi_dati(lettore, id, sizeof(*id));
+
+    Intervallo i = crea_intervallo(inizio, fine);
+    if(i == NULL) return NULL;
+    Prenotazione p = crea_prenotazione_con_id(*id, cliente, targa, i, costo);
+    distruggi_intervallo(i);
+    return p;
+}
+
+/*
+ * Funzione: applica_prenotazione
+ * ------------------------------
+ * Riapplica un record RECORD_PRENOTAZIONE: aggiunge la prenotazione al veicolo e
+ * allo storico del cliente, dove non è già presente.
+ */
+static Byte applica_prenotazione(struct lettore *lettore, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli){
+    uint64_t id;
+    Prenotazione p = leggi_prenotazione(lettore, &id);
+    if(p == NULL) return 0;
+
+    Utente u = cerca_utente_in_tabella(tabella_utenti, ottieni_cliente_prenotazione(p));
+    if(u != NULL && !storico_ha_prenotazione(u, p, id)) aggiungi_a_storico_utente(u, p);
+
+    // Il veicolo diventa proprietario della prenotazione solo se la aggiunge
+    Veicolo v = cerca_veicolo_in_tabella(tabella_veicoli, ottieni_veicolo_prenotazione(p));
+    if(v == NULL || aggiungi_prenotazione_veicolo(v, p) != OK) distruggi_prenotazione(p);
+    return 1;
+}
+
+/*
+ * Funzione: applica_cancellazione
+ * -------------------------------
+ * Riapplica un record RECORD_CANCELLAZIONE: toglie la prenotazione dal veicolo e
+ * dallo storico del cliente, dove è ancora presente.
+ */
+static Byte applica_cancellazione(struct lettore *lettore, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli){
+    uint64_t id;
+    Prenotazione p = leggi_prenotazione(lettore, &id);
+    if(p == NULL) return 0;
+
+    // cancella_prenotazione confronta solo l'inizio: si controlla prima l'intervallo esatto
+    Veicolo v = cerca_veicolo_in_tabella(tabella_veicoli, ottieni_veicolo_prenotazione(p));
+    if(v != NULL && veicolo_ha_prenotazione(v, p))
+        rimuovi_prenotazione_veicolo(v, ottieni_intervallo_prenotazione(p));
+
+    Utente u = cerca_utente_in_tabella(tabella_utenti, ottieni_cliente_prenotazione(p));
+    if(u != NULL && storico_ha_prenotazione(u, p, id)) rimuovi_da_storico_utente(u, p);
+
+    distruggi_prenotazione(p);
+    return 1;
+}
+
+/*
+ * Funzione: apri_giornale
+ * -----------------------
+ * Apre (o crea) il giornale memorizzato nel file indicato.
+ *
+ * Implementazione:
+ *    Apre il file in modalità "a+b": le letture possono partire dall'inizio,
+ *    le scritture finiscono sempre in coda.
+ *
+ * Parametri:
+ *    nome_file: percorso del file del giornale
+ *
+ * Pre-condizioni:
+ *    nome_file: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce il giornale aperto, con i nuovi record scritti in coda al file
+ *
+ * Ritorna:
+ *    un oggetto Giornale oppure NULL in caso di errore
+ *
+ * Side-effect:
+ *    alloca memoria e apre il file, creandolo se non esiste
+ */
+Giornale apri_giornale(const char *nome_file){
+    if(nome_file == NULL) return NULL;
+
+    struct giornale *giornale = calloc(1, sizeof(struct giornale));
+    if(giornale == NULL) return NULL;
+
+    giornale->nome_file = malloc(strlen(nome_file) + 1);
+    if(giornale->nome_file == NULL){
+        free(giornale);
+        return NULL;
+    }
+    strcpy(giornale->nome_file, nome_file);
+
+    giornale->fp = fopen(nome_file, "a+b");
+    if(giornale->fp == NULL){
+        free(giornale->nome_file);
+        free(giornale);
+        return NULL;
+    }
+
+    giornale->integro = 1;
+    return giornale;
+}
+
+/*
+ * Funzione: chiudi_giornale
+ * -------------------------
+ * Chiude il giornale e libera la memoria associata.
+ *
+ * Parametri:
+ *    giornale: il giornale da chiudere
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    chiude il file; i record già registrati restano sul disco
+ */
+void chiudi_giornale(Giornale giornale){
+    if(giornale == NULL) return;
+
+    if(giornale->fp != NULL) fclose(giornale->fp);
+    free(giornale->record);
+    free(giornale->nome_file);
+    free(giornale);
+}
+
+/*
+ * Funzione: riapplica_giornale
+ * ----------------------------
+ * Riapplica alle tabelle, nell'ordine in cui sono stati scritti, i record del giornale.
+ *
+ * Implementazione:
+ *    Legge i record dall'inizio del file, ne verifica lunghezza e codice di
+ *    controllo e li applica uno alla volta. Ogni applicazione controlla se il suo
+ *    effetto è già presente (utente o veicolo già in tabella, prenotazione già
+ *    nell'albero o nello storico), così una compattazione interrotta tra la
+ *    scrittura dell'istantanea e lo svuotamento del giornale non duplica niente.
+ *
+ * Parametri:
+ *    giornale: il giornale da leggere
+ *    tabella_utenti: la tabella degli utenti caricata dall'istantanea
+ *    tabella_veicoli: la tabella dei veicoli caricata dall'istantanea
+ *
+ * Pre-condizioni:
+ *    giornale, tabella_utenti, tabella_veicoli: non devono essere NULL
+ *
+ * Post-condizioni:
+ *    ogni record viene applicato solo se il suo effetto non è già presente nelle
+ *    tabelle, quindi riapplicare un giornale già contenuto nell'istantanea non
+ *    cambia niente. La lettura si ferma al primo record troncato o corrotto.
+ *
+ * Ritorna:
+ *    il numero di record letti, oppure -1 se il giornale termina con un record
+ *    troncato o corrotto (i record precedenti sono stati applicati)
+ *
+ * Side-effect:
+ *    modifica le tabelle
+ */
+int riapplica_giornale(Giornale giornale, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli){
+    if(giornale == NULL || giornale->fp == NULL || tabella_utenti == NULL || tabella_veicoli == NULL) return -1;
+
+    unsigned char *contenuto = malloc(DIMENSIONE_MASSIMA_RECORD);
+    if(contenuto == NULL) return -1;
+
+    rewind(giornale->fp);
+
+    int letti = 0;
+    unsigned int lunghezza;
+    size_t n;
+    while((n = fread(&lunghezza, 1, sizeof(lunghezza), giornale->fp)) == sizeof(lunghezza)){
+        Byte tipo;
+        uint32_t controllo;
+        if(lunghezza > DIMENSIONE_MASSIMA_RECORD - sizeof(tipo) ||
+           fread(&tipo, sizeof(tipo), 1, giornale->fp) != 1) goto corrotto;
+
+        // Il codice di controllo copre tipo e contenuto
+        contenuto[0] = (unsigned char)tipo;
+        if(fread(contenuto + 1, 1, lunghezza, giornale->fp) != lunghezza ||
+           fread(&controllo, sizeof(controllo), 1, giornale->fp) != 1 ||
+           controllo != controllo_fnv1a(contenuto, lunghezza + 1)) goto corrotto;
+
+        struct lettore lettore = { contenuto + 1, lunghezza };
+        Byte applicato;
+        switch(tipo){
+            case RECORD_UTENTE: applicato = applica_utente(&lettore, tabella_utenti); break;
+            case RECORD_VEICOLO: applicato = applica_veicolo(&lettore, tabella_veicoli); break;
+            case RECORD_RIMOZIONE_VEICOLO: applicato = applica_rimozione_veicolo(&lettore, tabella_veicoli); break;
+            case RECORD_PRENOTAZIONE: applicato = applica_prenotazione(&lettore, tabella_utenti, tabella_veicoli); break;
+            case RECORD_CANCELLAZIONE: applicato = applica_cancellazione(&lettore, tabella_utenti, tabella_veicoli); break;
+            default: applicato = 0; break;
+        }
+        if(!applicato) goto corrotto;
+        letti++;
+    }
+    // Un frammento della lunghezza in coda è un record troncato
+    if(n != 0) goto corrotto;
+
+    free(contenuto);
+    fseek(giornale->fp, 0, SEEK_END);
+    giornale->num_record += (unsigned int)letti;
+    return letti;
+
+corrotto:
+    // I record scritti dopo una coda corrotta non verrebbero mai riletti
+    giornale->integro = 0;
+    giornale->num_record += (unsigned int)letti;
+    free(contenuto);
+    fseek(giornale->fp, 0, SEEK_END);
+    return -1;
+}
+
+/*
+ * Funzione: svuota_giornale
+ * -------------------------
+ * Elimina tutti i record del giornale, da chiamare dopo aver salvato un'istantanea completa.
+ *
+ * Implementazione:
+ *    Riapre il file in modalità "wb", che lo tronca, e poi di nuovo in "a+b".
+ *
+ * Parametri:
+ *    giornale: il giornale da svuotare
+ *
+ * Pre-condizioni:
+ *    giornale: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il file è stato svuotato, 0 in caso di errore
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    tronca il file del giornale
+ */
+Byte svuota_giornale(Giornale giornale){
+    if(giornale == NULL) return 0;
+
+    giornale->fp = freopen(giornale->nome_file, "wb", giornale->fp);
+    if(giornale->fp != NULL) giornale->fp = freopen(giornale->nome_file, "a+b", giornale->fp);
+    if(giornale->fp == NULL){
+        // Senza file non si può più registrare niente: serve un'istantanea completa
+        giornale->integro = 0;
+        return 0;
+    }
+
+    giornale->num_record = 0;
+    giornale->integro = 1;
+    giornale->confine_segnato = 0;
+    return 1;
+}
+
+/*
+ * Funzione: segna_confine_giornale
+ * --------------------------------
+ * Ricorda fin dove arriva il giornale, prima di salvare un'istantanea in un altro processo.
+ *
+ * Implementazione:
+ *    Svuota il buffer del file, si porta in fondo e ne memorizza la lunghezza e il numero di record:
+ *    i record successivi, scritti mentre l'istantanea viene salvata, restano oltre il confine.
+ *
+ * Parametri:
+ *    giornale: il giornale da segnare
+ *
+ * Pre-condizioni:
+ *    giornale: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il confine è stato segnato, 0 se il file non è disponibile
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    scrive sul file i dati rimasti nel buffer
+ */
+Byte segna_confine_giornale(Giornale giornale){
+    // In modalità "a+b" la posizione è certa solo dopo uno spostamento esplicito
+    if(giornale == NULL || giornale->fp == NULL || fflush(giornale->fp) != 0 ||
+       fseek(giornale->fp, 0, SEEK_END) != 0) return 0;
+
+    long fine = ftell(giornale->fp);
+    if(fine < 0) return 0;
+
+    giornale->confine = fine;
+    giornale->record_al_confine = giornale->num_record;
+    giornale->confine_segnato = 1;
+    return 1;
+}
+
+/*
+ * Funzione: scarta_fino_al_confine
+ * --------------------------------
+ * Elimina i record scritti prima del confine, da chiamare quando l'istantanea che li
+ * contiene è stata salvata.
+ *
+ * Implementazione:
+ *    Copia i record successivi al confine in un file con estensione ESTENSIONE_TEMPORANEA,
+ *    lo porta su disco e lo rinomina al posto del giornale, poi riapre quest'ultimo in "a+b".
+ *    Se la copia o la rinomina falliscono il giornale resta com'era: contiene ancora
+ *    tutte le modifiche, e riapplicare quelle già nell'istantanea non le altera.
+ *
+ * Parametri:
+ *    giornale: il giornale da accorciare
+ *
+ * Pre-condizioni:
+ *    giornale: non deve essere NULL, con un confine segnato da `segna_confine_giornale`
+ *
+ * Post-condizioni:
+ *    restituisce 1 se i record precedenti al confine sono stati eliminati, 0 altrimenti;
+ *    in entrambi i casi il confine viene dimenticato
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    riscrive il file del giornale
+ */
+Byte scarta_fino_al_confine(Giornale giornale){
+    if(giornale == NULL || !giornale->confine_segnato) return 0;
+    giornale->confine_segnato = 0;
+    if(giornale->fp == NULL || fflush(giornale->fp) != 0) return 0;
+
+    char *temporaneo = malloc(strlen(giornale->nome_file) + sizeof(ESTENSIONE_TEMPORANEA));
+    if(temporaneo == NULL) return 0;
+    strcpy(temporaneo, giornale->nome_file);
+    strcat(temporaneo, ESTENSIONE_TEMPORANEA);
+
+    FILE *copia = fopen(temporaneo, "wb");
+    Byte esito = copia != NULL && fseek(giornale->fp, giornale->confine, SEEK_SET) == 0;
+    if(esito){
+        unsigned char blocco[4096];
+        size_t n;
+        while((n = fread(blocco, 1, sizeof(blocco), giornale->fp)) > 0)
+            if(fwrite(blocco, 1, n, copia) != n) esito = 0;
+        if(ferror(giornale->fp) || fflush(copia) != 0) esito = 0;
+#ifndef _WIN32
+        if(esito && fsync(fileno(copia)) != 0) esito = 0;
+#endif
+    }
+    if(copia != NULL && fclose(copia) != 0) esito = 0;
+    fseek(giornale->fp, 0, SEEK_END);
+
+    if(!esito || rename(temporaneo, giornale->nome_file) != 0){
+        remove(temporaneo);
+        free(temporaneo);
+        return 0;
+    }
+    free(temporaneo);
+
+    giornale->fp = freopen(giornale->nome_file, "a+b", giornale->fp);
+    if(giornale->fp == NULL){
+        giornale->integro = 0;
+        return 0;
+    }
+    giornale->num_record -= giornale->record_al_confine;
+    return 1;
+}
+
+/*
+ * Funzione: dimensione_giornale
+ * -----------------------------
+ * Restituisce il numero di record contenuti nel giornale: quelli riapplicati
+ * all'avvio più quelli registrati in seguito, azzerato dallo svuotamento.
+ *
+ * Parametri:
+ *    giornale: il giornale da interrogare
+ *
+ * Ritorna:
+ *    il numero di record, 0 se `giornale` è NULL
+ */
+unsigned int dimensione_giornale(Giornale giornale){
+    if(giornale == NULL) return 0;
+
+    return giornale->num_record;
+}
+
+/*
+ * Funzione: giornale_integro
+ * --------------------------
+ * Indica se tutte le scritture sul giornale sono andate a buon fine.
+ *
+ * Parametri:
+ *    giornale: il giornale da interrogare
+ *
+ * Post-condizioni:
+ *    restituisce 0 se `giornale` è NULL, se una scrittura è fallita o se la
+ *    riapplicazione ha trovato una coda corrotta: in quel caso il giornale non
+ *    descrive più tutte le modifiche e serve un'istantanea completa
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ */
+Byte giornale_integro(Giornale giornale){
+    if(giornale == NULL) return 0;
+
+    return giornale->integro;
+}
+
+/*
+ * Funzione: registra_utente_in_giornale
+ * -------------------------------------
+ * Registra l'aggiunta di un nuovo utente.
+ *
+ * Implementazione:
+ *    Scrive nome, cognome, email, password e permesso nello stesso formato di
+ *    `archivio/utenti.bin`. Lo storico di un nuovo utente è vuoto.
+ *
+ * Parametri:
+ *    giornale: il giornale su cui scrivere
+ *    utente: l'utente aggiunto alla tabella
+ *
+ * Pre-condizioni:
+ *    utente: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il record è stato scritto, 0 altrimenti (anche se `giornale` è NULL)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    scrive un record in coda al file e lo svuota verso il sistema operativo
+ */
+Byte registra_utente_in_giornale(Giornale giornale, Utente utente){
+    if(giornale == NULL || utente == NULL) return 0;
+
+    Byte permesso = ottieni_permesso(utente);
+    if(!inizia_record(giornale, RECORD_UTENTE) ||
+       !accoda_stringa(giornale, ottieni_nome(utente)) ||
+       !accoda_stringa(giornale, ottieni_cognome(utente)) ||
+       !accoda_stringa(giornale, ottieni_email(utente)) ||
+       !accoda_dati(giornale, ottieni_password(utente), DIMENSIONE_PASSWORD) ||
+       !accoda_dati(giornale, &permesso, sizeof(permesso))){
+        giornale->integro = 0;
+        return 0;
+    }
+
+    return scrivi_record(giornale);
+}
+
+/*
+ * Funzione: registra_veicolo_in_giornale
+ * --------------------------------------
+ * Registra l'aggiunta di un nuovo veicolo, senza prenotazioni.
+ *
+ * Implementazione:
+ *    Scrive tipo, targa, modello, posizione e tariffa nello stesso formato di
+ *    `archivio/veicoli.bin`.
+ *
+ * Parametri:
+ *    giornale: il giornale su cui scrivere
+ *    veicolo: il veicolo aggiunto alla tabella
+ *
+ * Pre-condizioni:
+ *    veicolo: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il record è stato scritto, 0 altrimenti (anche se `giornale` è NULL)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    scrive un record in coda al file e lo svuota verso il sistema operativo
+ */
+Byte registra_veicolo_in_giornale(Giornale giornale, Veicolo veicolo){
+    if(giornale == NULL || veicolo == NULL) return 0;
+
+    double tariffa = ottieni_tariffa(veicolo);
+    if(!inizia_record(giornale, RECORD_VEICOLO) ||
+       !accoda_stringa(giornale, ottieni_tipo_veicolo(veicolo)) ||
+       !accoda_stringa(giornale, ottieni_targa(veicolo)) ||
+       !accoda_stringa(giornale, ottieni_modello(veicolo)) ||
+       !accoda_stringa(giornale, ottieni_posizione(veicolo)) ||
+       !accoda_dati(giornale, &tariffa, sizeof(tariffa))){
+        giornale->integro = 0;
+        return 0;
+    }
+
+    return scrivi_record(giornale);
+}
+
+/*
+ * Funzione: registra_rimozione_veicolo_in_giornale
+ * ------------------------------------------------
+ * Registra la rimozione di un veicolo.
+ *
+ * Implementazione:
+ *    Scrive la sola targa.
+ *
+ * Parametri:
+ *    giornale: il giornale su cui scrivere
+ *    targa: la targa del veicolo rimosso
+ *
+ * Pre-condizioni:
+ *    targa: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il record è stato scritto, 0 altrimenti (anche se `giornale` è NULL)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    scrive un record in coda al file e lo svuota verso il sistema operativo
+ */
+Byte registra_rimozione_veicolo_in_giornale(Giornale giornale, const char *targa){
+    if(giornale == NULL || targa == NULL) return 0;
+
+    if(!inizia_record(giornale, RECORD_RIMOZIONE_VEICOLO) || !accoda_stringa(giornale, targa)){
+        giornale->integro = 0;
+        return 0;
+    }
+
+    return scrivi_record(giornale);
+}
+
+/*
+ * Funzione: registra_modifica_prenotazione
+ * ----------------------------------------
+ * Scrive un record RECORD_PRENOTAZIONE o RECORD_CANCELLAZIONE con cliente, targa,
+ * costo ed estremi della prenotazione, nello stesso formato dei file dell'archivio,
+ * seguiti dal suo identificativo.
+ */
+static Byte registra_modifica_prenotazione(struct giornale *giornale, Byte tipo, Prenotazione prenotazione){
+    Intervallo i = ottieni_intervallo_prenotazione(prenotazione);
+    if(i == NULL) return 0;
+
+    double costo = ottieni_costo_prenotazione(prenotazione);
+    time_t inizio = inizio_intervallo(i);
+    time_t fine = fine_intervallo(i);
+    uint64_t id = ottieni_id_prenotazione(prenotazione);
+    if(!inizia_record(giornale, tipo) ||
+       !accoda_stringa(giornale, ottieni_cliente_prenotazione(prenotazione)) ||
+       !accoda_stringa(giornale, ottieni_veicolo_prenotazione(prenotazione)) ||
+       !accoda_dati(giornale, &costo, sizeof(costo)) ||
+       !accoda_dati(giornale, &inizio, sizeof(inizio)) ||
+       !accoda_dati(giornale, &fine, sizeof(fine)) ||
+       !accoda_dati(giornale, &id, sizeof(id))){
+        giornale->integro = 0;
+        return 0;
+    }
+
+    return scrivi_record(giornale);
+}
+
+/*
+ * Funzione: registra_prenotazione_in_giornale
+ * -------------------------------------------
+ * Registra una nuova prenotazione, aggiunta al veicolo e allo storico del cliente.
+ *
+ * Implementazione:
+ *    Scrive cliente, targa, costo, estremi e identificativo della prenotazione.
+ *
+ * Parametri:
+ *    giornale: il giornale su cui scrivere
+ *    prenotazione: la prenotazione aggiunta
+ *
+ * Pre-condizioni:
+ *    prenotazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il record è stato scritto, 0 altrimenti (anche se `giornale` è NULL)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    scrive un record in coda al file e lo svuota verso il sistema operativo
+ */
+Byte registra_prenotazione_in_giornale(Giornale giornale, Prenotazione prenotazione){
+    if(giornale == NULL || prenotazione == NULL) return 0;
+
+    return registra_modifica_prenotazione(giornale, RECORD_PRENOTAZIONE, prenotazione);
+}
+
+/*
+ * Funzione: registra_cancellazione_in_giornale
+ * --------------------------------------------
+ * Registra la cancellazione di una prenotazione dal veicolo e dallo storico del cliente.
+ *
+ * Implementazione:
+ *    Scrive cliente, targa, costo, estremi e identificativo della prenotazione.
+ *
+ * Parametri:
+ *    giornale: il giornale su cui scrivere
+ *    prenotazione: la prenotazione cancellata
+ *
+ * Pre-condizioni:
+ *    prenotazione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il record è stato scritto, 0 altrimenti (anche se `giornale` è NULL)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    scrive un record in coda al file e lo svuota verso il sistema operativo
+ */
+Byte registra_cancellazione_in_giornale(Giornale giornale, Prenotazione prenotazione){
+    if(giornale == NULL || prenotazione == NULL) return 0;
+
+    return registra_modifica_prenotazione(giornale, RECORD_CANCELLAZIONE, prenotazione);
+}
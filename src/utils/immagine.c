@@ -0,0 +1,200 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "utils/immagine.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+struct immagine {
+    unsigned char *dati;
+    size_t dimensione;
+    int mappata;          // 1 se `dati` va rilasciato con munmap, 0 se con free
+};
+
+#ifndef _WIN32
+/*
+ * Funzione: mappa_file
+ * --------------------
+ * Mappa in sola lettura il file indicato nell'immagine.
+ *
+ * Implementazione:
+ *    Il descrittore viene chiuso subito dopo `mmap`: la mappatura resta valida.
+ *    Il file viene letto in ordine, quindi si chiede al sistema di leggere in anticipo.
+ *
+ * Ritorna:
+ *    1 se il file è stato mappato (o è vuoto), 0 altrimenti
+ */
+static int mappa_file(struct immagine *immagine, const char *nome_file){
+    int fd = open(nome_file, O_RDONLY);
+    if(fd < 0) return 0;
+
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size < 0){
+        close(fd);
+        return 0;
+    }
+
+    immagine->dimensione = (size_t)info.st_size;
+    if(immagine->dimensione == 0){
+        // mmap non accetta lunghezza 0
+        close(fd);
+        return 1;
+    }
+
+    void *dati = mmap(NULL, immagine->dimensione, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(dati == MAP_FAILED) return 0;
+
+    posix_madvise(dati, immagine->dimensione, POSIX_MADV_SEQUENTIAL);
+    immagine->dati = dati;
+    immagine->mappata = 1;
+    return 1;
+}
+#else
+/*
+ * Funzione: leggi_file
+ * --------------------
+ * Legge l'intero file indicato nell'immagine con una sola fread.
+ *
+ * Ritorna:
+ *    1 se il file è stato letto, 0 altrimenti
+ */
+static int leggi_file(struct immagine *immagine, const char *nome_file){
+    FILE *fp = fopen(nome_file, "rb");
+    if(fp == NULL) return 0;
+
+    long dimensione;
+    if(fseek(fp, 0, SEEK_END) != 0 || (dimensione = ftell(fp)) < 0 || fseek(fp, 0, SEEK_SET) != 0){
+        fclose(fp);
+        return 0;
+    }
+
+    immagine->dimensione = (size_t)dimensione;
+    if(immagine->dimensione > 0){
+        immagine->dati = malloc(immagine->dimensione);
+        if(immagine->dati == NULL || fread(immagine->dati, 1, immagine->dimensione, fp) != immagine->dimensione){
+            free(immagine->dati);
+            immagine->dati = NULL;
+            fclose(fp);
+            return 0;
+        }
+    }
+
+    fclose(fp);
+    return 1;
+}
+#endif
+
+/*
+ * Funzione: apri_immagine
+ * -----------------------
+ * Rende accessibile in memoria l'intero contenuto del file indicato.
+ *
+ * Implementazione:
+ *    Su POSIX mappa il file con `mmap`, altrimenti lo legge con una sola `fread`.
+ *
+ * Parametri:
+ *    nome_file: percorso del file da aprire
+ *
+ * Pre-condizioni:
+ *    nome_file: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce l'immagine del file; un file vuoto dà un'immagine di dimensione 0
+ *
+ * Ritorna:
+ *    un oggetto Immagine oppure NULL se il file non esiste o non può essere letto
+ *
+ * Side-effect:
+ *    alloca memoria e mappa (o legge) il file
+ */
+Immagine apri_immagine(const char *nome_file){
+    if(nome_file == NULL) return NULL;
+
+    struct immagine *immagine = calloc(1, sizeof(struct immagine));
+    if(immagine == NULL) return NULL;
+
+#ifndef _WIN32
+    int aperta = mappa_file(immagine, nome_file);
+#else
+    int aperta = leggi_file(immagine, nome_file);
+#endif
+    if(!aperta){
+        free(immagine);
+        return NULL;
+    }
+
+    return immagine;
+}
+
+/*
+ * Funzione: dati_immagine
+ * -----------------------
+ * Restituisce il primo byte dell'immagine.
+ *
+ * Parametri:
+ *    immagine: l'immagine da interrogare
+ *
+ * Post-condizioni:
+ *    il blocco resta valido fino a `chiudi_immagine` e non deve essere modificato
+ *
+ * Ritorna:
+ *    un puntatore ai dati, NULL se `immagine` è NULL o vuota
+ */
+const unsigned char *dati_immagine(const Immagine immagine){
+    if(immagine == NULL) return NULL;
+    return immagine->dati;
+}
+
+/*
+ * Funzione: dimensione_immagine
+ * -----------------------------
+ * Restituisce il numero di byte dell'immagine.
+ *
+ * Parametri:
+ *    immagine: l'immagine da interrogare
+ *
+ * Ritorna:
+ *    la dimensione in byte, 0 se `immagine` è NULL
+ */
+size_t dimensione_immagine(const Immagine immagine){
+    if(immagine == NULL) return 0;
+    return immagine->dimensione;
+}
+
+/*
+ * Funzione: chiudi_immagine
+ * -------------------------
+ * Rilascia l'immagine; i puntatori ottenuti da `dati_immagine` non sono più validi.
+ *
+ * Implementazione:
+ *    Usa munmap per un file mappato, free per un file letto in memoria.
+ *
+ * Parametri:
+ *    immagine: l'immagine da chiudere
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    smappa il file o libera la memoria in cui era stato letto
+ */
+void chiudi_immagine(Immagine immagine){
+    if(immagine == NULL) return;
+
+#ifndef _WIN32
+    if(immagine->mappata) munmap(immagine->dati, immagine->dimensione);
+    else free(immagine->dati);
+#else
+    free(immagine->dati);
+#endif
+    free(immagine);
+}
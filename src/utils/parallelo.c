@@ -0,0 +1,166 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "utils/parallelo.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#define MAX_THREAD 64
+
+static unsigned int numero_thread = 0;  // 0: uno per processore
+
+// Stato condiviso dai thread di una `esegui_a_blocchi`
+struct lavoro {
+    FunzioneBlocco funzione;
+    void *contesto;
+    unsigned int num_elementi;
+    unsigned int dimensione_blocco;
+    unsigned int prossimo;      // Primo elemento non ancora assegnato, protetto da `mutex`
+    pthread_mutex_t mutex;
+};
+
+/*
+ * Funzione: numero_processori
+ * ---------------------------
+ * Restituisce il numero di processori disponibili, 1 se non è noto.
+ */
+static unsigned int numero_processori(void){
+#if !defined(_WIN32) && defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if(n > 0) return n > MAX_THREAD ? MAX_THREAD : (unsigned int)n;
+#endif
+    return 1;
+}
+
+/*
+ * Funzione: esegui_lavoro
+ * -----------------------
+ * Corpo di ogni thread: prende un blocco alla volta finché ne restano.
+ *
+ * Implementazione:
+ *    I blocchi vengono assegnati a richiesta, così un thread più lento non
+ *    rallenta gli altri; il mutex protegge solo l'avanzamento di `prossimo`.
+ */
+static void *esegui_lavoro(void *argomento){
+    struct lavoro *lavoro = argomento;
+
+    for(;;){
+        pthread_mutex_lock(&lavoro->mutex);
+        unsigned int inizio = lavoro->prossimo;
+        unsigned int restanti = lavoro->num_elementi - inizio;
+        unsigned int quanti = restanti < lavoro->dimensione_blocco ? restanti : lavoro->dimensione_blocco;
+        lavoro->prossimo += quanti;
+        pthread_mutex_unlock(&lavoro->mutex);
+
+        if(quanti == 0) return NULL;
+        lavoro->funzione(lavoro->contesto, inizio, inizio + quanti);
+    }
+}
+
+/*
+ * Funzione: imposta_numero_thread
+ * -------------------------------
+ * Imposta il numero massimo di thread usati da `esegui_a_blocchi`.
+ *
+ * Implementazione:
+ *    Il valore viene limitato a MAX_THREAD.
+ *
+ * Parametri:
+ *    num_thread: numero di thread, 0 per usarne uno per processore
+ *
+ * Pre-condizioni:
+ *    nessuna `esegui_a_blocchi` deve essere in corso
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    modifica l'impostazione globale del modulo
+ */
+void imposta_numero_thread(unsigned int num_thread){
+    numero_thread = num_thread > MAX_THREAD ? MAX_THREAD : num_thread;
+}
+
+/*
+ * Funzione: ottieni_numero_thread
+ * -------------------------------
+ * Restituisce il numero massimo di thread usati da `esegui_a_blocchi`.
+ *
+ * Ritorna:
+ *    il numero di thread impostato, o il numero di processori se non è stato
+ *    impostato (almeno 1)
+ */
+unsigned int ottieni_numero_thread(void){
+    return numero_thread > 0 ? numero_thread : numero_processori();
+}
+
+/*
+ * Funzione: esegui_a_blocchi
+ * --------------------------
+ * Divide [0, num_elementi) in blocchi di `dimensione_blocco` elementi ed esegue
+ * `funzione` su ogni blocco, usando fino a `ottieni_numero_thread()` thread.
+ *
+ * Implementazione:
+ *    Crea al massimo un thread per blocco, meno uno: il thread chiamante lavora
+ *    come gli altri. Con un solo thread o un solo blocco non crea thread.
+ *
+ * Parametri:
+ *    num_elementi: numero di elementi da elaborare
+ *    dimensione_blocco: numero di elementi di ogni blocco (l'ultimo può essere più corto)
+ *    funzione: il lavoro da eseguire su ogni blocco
+ *    contesto: puntatore passato invariato a `funzione`
+ *
+ * Pre-condizioni:
+ *    dimensione_blocco: deve essere maggiore di 0
+ *    funzione: non deve essere NULL
+ *
+ * Post-condizioni:
+ *    restituisce 1 quando tutti i blocchi sono stati eseguiti, 0 se i parametri
+ *    non sono validi. Se un thread non può essere creato, i suoi blocchi vengono
+ *    eseguiti dagli altri.
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ *
+ * Side-effect:
+ *    crea e attende i thread di lavoro; il thread chiamante esegue anch'esso dei blocchi
+ */
+Byte esegui_a_blocchi(unsigned int num_elementi, unsigned int dimensione_blocco, FunzioneBlocco funzione, void *contesto){
+    if(dimensione_blocco == 0 || funzione == NULL) return 0;
+
+    unsigned int num_blocchi = num_elementi / dimensione_blocco + (num_elementi % dimensione_blocco != 0);
+    unsigned int num_thread = ottieni_numero_thread();
+    if(num_thread > num_blocchi) num_thread = num_blocchi;
+
+    if(num_thread <= 1){
+        for(unsigned int inizio = 0; inizio < num_elementi; inizio += dimensione_blocco){
+            unsigned int fine = num_elementi - inizio < dimensione_blocco ? num_elementi : inizio + dimensione_blocco;
+            funzione(contesto, inizio, fine);
+        }
+        return 1;
+    }
+
+    struct lavoro lavoro;
+    lavoro.funzione = funzione;
+    lavoro.contesto = contesto;
+    lavoro.num_elementi = num_elementi;
+    lavoro.dimensione_blocco = dimensione_blocco;
+    lavoro.prossimo = 0;
+    pthread_mutex_init(&lavoro.mutex, NULL);
+
+    pthread_t thread[MAX_THREAD];
+    unsigned int avviati = 0;
+    while(avviati < num_thread - 1 && pthread_create(&thread[avviati], NULL, esegui_lavoro, &lavoro) == 0)
+        avviati++;
+
+    esegui_lavoro(&lavoro);
+    for(unsigned int i = 0; i < avviati; i++) pthread_join(thread[i], NULL);
+
+    pthread_mutex_destroy(&lavoro.mutex);
+    return 1;
+}
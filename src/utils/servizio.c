@@ -0,0 +1,432 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "utils/servizio.h"
+#include "utils/gestore_prenotazioni.h"
+#include "utils/giornale.h"
+#include "utils/tariffe.h"
+#include "utils/utils.h"
+#include "modelli/intervallo.h"
+#include "modelli/prenotazione.h"
+#include "modelli/utente.h"
+#include "modelli/veicolo.h"
+#include "strutture_dati/prenotazioni.h"
+#include "strutture_dati/tabella_utenti.h"
+#include "strutture_dati/tabella_veicoli.h"
+
+/*
+ * Funzione: e_cliente
+ * -------------------
+ * Restituisce 1 se `utente` esiste ed è un cliente.
+ */
+static Byte e_cliente(Utente utente){
+    return utente != NULL && ottieni_permesso(utente) == CLIENTE;
+}
+
+/*
+ * Funzione: ignora_prenotazione
+ * -----------------------------
+ * Visitatore vuoto: visitare lo storico basta a costruirlo e a rendere le sue
+ * prenotazioni raggiungibili da `cerca_prenotazione_per_id`.
+ */
+static void ignora_prenotazione(const Prenotazione p, void *contesto){
+    (void)p;
+    (void)contesto;
+}
+
+/*
+ * Funzione: compila_preventivo
+ * ----------------------------
+ * Calcola il costo pieno di `intervallo` sul veicolo e, se `preventivo` non è NULL,
+ * vi scrive costo, sconto del cliente e costo scontato. Restituisce il costo pieno.
+ */
+static double compila_preventivo(Utente utente, Veicolo veicolo, Intervallo intervallo, Preventivo *preventivo){
+    double costo = calcola_costo(ottieni_tariffa(veicolo), intervallo);
+    if(preventivo != NULL){
+        preventivo->costo = costo;
+        preventivo->sconto = calcola_sconto_totale(utente, inizio_intervallo(intervallo),
+                                                   preventivo->motivo, sizeof(preventivo->motivo));
+        preventivo->costo_scontato = costo * (1.0 - preventivo->sconto);
+    }
+    return costo;
+}
+
+/*
+ * Funzione: prenotazione_attiva_del_cliente
+ * -----------------------------------------
+ * Restituisce la prenotazione `id` se appartiene a `utente` e non è ancora terminata,
+ * altrimenti NULL.
+ *
+ * Implementazione:
+ *    Le prenotazioni di uno storico non ancora costruito non sono nell'indice per
+ *    identificativo, o lo sono solo come prenotazioni dell'albero del veicolo: lo
+ *    storico del cliente, se è ancora nell'archivio, viene costruito visitandolo prima
+ *    della ricerca, così condivide la prenotazione che il chiamante andrà a cambiare.
+ */
+static Prenotazione prenotazione_attiva_del_cliente(Utente utente, uint64_t id){
+    SorgenteStorico *sorgente;
+    unsigned int prima, num;
+    if(ottieni_storico_differito(utente, &sorgente, &prima, &num)) visita_storico_utente(utente, ignora_prenotazione, NULL);
+
+    Prenotazione p = cerca_prenotazione_per_id(id);
+    if(p == NULL || strcmp(ottieni_cliente_prenotazione(p), ottieni_email(utente)) != 0 ||
+       fine_intervallo(ottieni_intervallo_prenotazione(p)) <= time(NULL))
+        return NULL;
+    return p;
+}
+
+/*
+ * Funzione: descrivi_esito_servizio
+ * ---------------------------------
+ *
+ * Restituisce una descrizione testuale dell'esito di un'operazione
+ *
+ * Implementazione:
+ *    - Utilizza uno switch per selezionare la stringa descrittiva
+ *
+ * Parametri:
+ *    esito: l'esito da descrivere
+ *
+ * Pre-condizioni:
+ *    nessuna
+ *
+ * Post-condizione:
+ *    restituisce la descrizione corrispondente
+ *
+ * Ritorna:
+ *    Una stringa costante
+ */
+const char *descrivi_esito_servizio(EsitoServizio esito){
+    switch(esito){
+        case SERVIZIO_OK:                       return "ok";
+        case SERVIZIO_ACCESSO_NEGATO:           return "accesso cliente richiesto";
+        case SERVIZIO_VEICOLO_NON_TROVATO:      return "veicolo non trovato";
+        case SERVIZIO_INTERVALLO_NON_VALIDO:    return "intervallo non valido";
+        case SERVIZIO_VEICOLO_OCCUPATO:         return "veicolo occupato";
+        case SERVIZIO_PRENOTAZIONE_NON_TROVATA: return "prenotazione non trovata";
+        case SERVIZIO_MEMORIA_INSUFFICIENTE:    return "memoria insufficiente";
+        default:                                return "errore sconosciuto";
+    }
+}
+
+/*
+ * Funzione: prepara_prenotazione
+ * ------------------------------
+ *
+ * Crea la prenotazione del veicolo `targa` per il cliente nell'intervallo dato e ne
+ * calcola il preventivo, senza aggiungerla al veicolo né allo storico
+ *
+ * Implementazione:
+ *    - Come nei menu, non si può prenotare un intervallo che inizia nel passato
+ *    - Il costo pieno è quello di `calcola_costo` con la tariffa del veicolo e viene
+ *      memorizzato nella prenotazione
+ *    - Lo sconto è quello di `calcola_sconto_totale`, calcolato prima che la
+ *      prenotazione entri nello storico
+ *    - I menu mostrano il preventivo e chiedono conferma prima di `conferma_prenotazione`
+ *
+ * Parametri:
+ *    tabella_veicoli: tabella dei veicoli
+ *    utente: il cliente che prenota
+ *    targa: targa del veicolo
+ *    intervallo: intervallo della prenotazione
+ *    preventivo: dove scrivere il prezzo (può essere NULL)
+ *    prenotazione: dove scrivere la prenotazione creata
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: non deve essere NULL
+ *    prenotazione: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK e la prenotazione in `*prenotazione`, altrimenti il motivo
+ *    dell'errore e NULL in `*prenotazione`; un intervallo che inizia nel passato
+ *    restituisce SERVIZIO_INTERVALLO_NON_VALIDO
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    alloca la prenotazione, che va passata a `conferma_prenotazione` o distrutta
+ */
+EsitoServizio prepara_prenotazione(TabellaVeicoli tabella_veicoli, Utente utente, const char *targa, Intervallo intervallo,
+                                   Preventivo *preventivo, Prenotazione *prenotazione){
+    *prenotazione = NULL;
+    if(!e_cliente(utente)) return SERVIZIO_ACCESSO_NEGATO;
+    if(intervallo == NULL || inizio_intervallo(intervallo) < time(NULL)) return SERVIZIO_INTERVALLO_NON_VALIDO;
+
+    Veicolo veicolo = targa != NULL ? cerca_veicolo_in_tabella(tabella_veicoli, targa) : NULL;
+    if(veicolo == NULL) return SERVIZIO_VEICOLO_NON_TROVATO;
+
+    double costo = compila_preventivo(utente, veicolo, intervallo, preventivo);
+    *prenotazione = crea_prenotazione(ottieni_email(utente), ottieni_targa(veicolo), intervallo, costo);
+    return *prenotazione != NULL ? SERVIZIO_OK : SERVIZIO_MEMORIA_INSUFFICIENTE;
+}
+
+/*
+ * Funzione: conferma_prenotazione
+ * -------------------------------
+ *
+ * Aggiunge una prenotazione creata da `prepara_prenotazione` al veicolo e allo storico
+ * del cliente e la registra nel giornale
+ *
+ * Implementazione:
+ *    L'albero del veicolo prende il riferimento del chiamante e viene provato per primo,
+ *    così una prenotazione sovrapposta non entra nello storico; lo storico ne condivide
+ *    un riferimento proprio.
+ *
+ * Parametri:
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare la prenotazione (può essere NULL)
+ *    utente: il cliente che prenota
+ *    prenotazione: la prenotazione da confermare
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: non deve essere NULL
+ *    prenotazione: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK se la prenotazione è stata aggiunta, SERVIZIO_VEICOLO_OCCUPATO
+ *    se si sovrappone a una prenotazione del veicolo
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    prende il riferimento del chiamante alla prenotazione, che viene liberata in caso di errore;
+ *    modifica l'albero del veicolo, lo storico del cliente e il giornale
+ */
+EsitoServizio conferma_prenotazione(TabellaVeicoli tabella_veicoli, Giornale giornale, Utente utente, Prenotazione prenotazione){
+    EsitoServizio esito = SERVIZIO_OK;
+    Veicolo veicolo = cerca_veicolo_in_tabella(tabella_veicoli, ottieni_veicolo_prenotazione(prenotazione));
+
+    if(!e_cliente(utente) || strcmp(ottieni_email(utente), ottieni_cliente_prenotazione(prenotazione)) != 0)
+        esito = SERVIZIO_ACCESSO_NEGATO;
+    else if(veicolo == NULL)
+        esito = SERVIZIO_VEICOLO_NON_TROVATO;
+    else if(aggiungi_prenotazione_veicolo(veicolo, prenotazione) != OK)
+        esito = SERVIZIO_VEICOLO_OCCUPATO;
+
+    if(esito != SERVIZIO_OK){
+        distruggi_prenotazione(prenotazione);
+        return esito;
+    }
+    aggiungi_a_storico_utente(utente, prenotazione);
+    registra_prenotazione_in_giornale(giornale, prenotazione);
+    return SERVIZIO_OK;
+}
+
+/*
+ * Funzione: prenota
+ * -----------------
+ *
+ * Prenota il veicolo `targa` per il cliente nell'intervallo dato, applicando gli sconti
+ * di `calcola_sconto_totale`
+ *
+ * Implementazione:
+ *    `prepara_prenotazione` seguita da `conferma_prenotazione`, senza chiedere conferma.
+ *    L'identificativo va letto prima della conferma: da lì la prenotazione appartiene
+ *    alle tabelle.
+ *
+ * Parametri:
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare la prenotazione (può essere NULL)
+ *    utente: il cliente che prenota
+ *    targa: targa del veicolo
+ *    intervallo: intervallo della prenotazione
+ *    preventivo: dove scrivere il prezzo (può essere NULL)
+ *    id: dove scrivere l'identificativo della prenotazione (può essere NULL)
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK se la prenotazione è stata aggiunta, altrimenti il motivo dell'errore
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    modifica l'albero del veicolo, lo storico del cliente e il giornale
+ */
+EsitoServizio prenota(TabellaVeicoli tabella_veicoli, Giornale giornale, Utente utente, const char *targa, Intervallo intervallo,
+                      Preventivo *preventivo, uint64_t *id){
+    Prenotazione p;
+    EsitoServizio esito = prepara_prenotazione(tabella_veicoli, utente, targa, intervallo, preventivo, &p);
+    if(esito != SERVIZIO_OK) return esito;
+
+    uint64_t id_prenotazione = ottieni_id_prenotazione(p);
+    esito = conferma_prenotazione(tabella_veicoli, giornale, utente, p);
+    if(esito == SERVIZIO_OK && id != NULL) *id = id_prenotazione;
+    return esito;
+}
+
+/*
+ * Funzione: cancella
+ * ------------------
+ *
+ * Cancella la prenotazione del cliente con l'identificativo dato
+ *
+ * Implementazione:
+ *    - La prenotazione viene cercata con `prenotazione_attiva_del_cliente`, che costruisce
+ *      lo storico del cliente se non è ancora stato caricato
+ *    - Una prenotazione può essere cancellata solo dal cliente a cui appartiene e solo
+ *      finché non è terminata, come nei menu: i noleggi conclusi restano nello storico
+ *      e contano per il premio fedeltà
+ *    - La cancellazione è quella di `cancella_prenotazione_per_id`
+ *
+ * Parametri:
+ *    tabella_utenti: tabella degli utenti
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare la cancellazione (può essere NULL)
+ *    utente: il cliente a cui appartiene la prenotazione
+ *    id: identificativo della prenotazione
+ *
+ * Pre-condizioni:
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK se la prenotazione è stata cancellata, SERVIZIO_PRENOTAZIONE_NON_TROVATA
+ *    se non esiste, appartiene a un altro cliente o è già terminata
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    può costruire lo storico del cliente; modifica l'albero del veicolo, lo storico e il giornale
+ */
+EsitoServizio cancella(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale, Utente utente, uint64_t id){
+    if(!e_cliente(utente)) return SERVIZIO_ACCESSO_NEGATO;
+
+    if(prenotazione_attiva_del_cliente(utente, id) == NULL ||
+       !cancella_prenotazione_per_id(tabella_utenti, tabella_veicoli, giornale, id))
+        return SERVIZIO_PRENOTAZIONE_NON_TROVATA;
+    return SERVIZIO_OK;
+}
+
+/*
+ * Funzione: modifica
+ * ------------------
+ *
+ * Sposta la prenotazione del cliente con l'identificativo dato in un nuovo intervallo
+ *
+ * Implementazione:
+ *    - Valgono le regole di `cancella` per la prenotazione (dello stesso cliente e non
+ *      terminata) e quelle di `prenota` per il nuovo intervallo (che non può iniziare
+ *      nel passato)
+ *    - Il costo viene ricalcolato con la tariffa del veicolo, come in `prepara_prenotazione`
+ *    - Lo spostamento è quello di `modifica_prenotazione_per_id`: se il nuovo intervallo
+ *      si sovrappone a un'altra prenotazione del veicolo, quella del cliente resta invariata
+ *
+ * Parametri:
+ *    tabella_utenti: tabella degli utenti
+ *    tabella_veicoli: tabella dei veicoli
+ *    giornale: giornale su cui registrare la modifica (può essere NULL)
+ *    utente: il cliente a cui appartiene la prenotazione
+ *    id: identificativo della prenotazione
+ *    intervallo: il nuovo intervallo
+ *    preventivo: se non è NULL, riceve il nuovo costo e lo sconto applicabile
+ *
+ * Pre-condizioni:
+ *    tabella_utenti: non deve essere NULL
+ *    tabella_veicoli: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK se la prenotazione è stata spostata, altrimenti il motivo
+ *    dell'errore: SERVIZIO_PRENOTAZIONE_NON_TROVATA come in `cancella`,
+ *    SERVIZIO_INTERVALLO_NON_VALIDO, SERVIZIO_VEICOLO_NON_TROVATO o SERVIZIO_VEICOLO_OCCUPATO
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    può costruire lo storico del cliente; modifica la prenotazione, l'albero del veicolo e il giornale
+ */
+EsitoServizio modifica(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, Giornale giornale, Utente utente, uint64_t id,
+                       Intervallo intervallo, Preventivo *preventivo){
+    if(!e_cliente(utente)) return SERVIZIO_ACCESSO_NEGATO;
+
+    Prenotazione p = prenotazione_attiva_del_cliente(utente, id);
+    if(p == NULL) return SERVIZIO_PRENOTAZIONE_NON_TROVATA;
+    if(intervallo == NULL || inizio_intervallo(intervallo) < time(NULL)) return SERVIZIO_INTERVALLO_NON_VALIDO;
+
+    Veicolo veicolo = cerca_veicolo_in_tabella(tabella_veicoli, ottieni_veicolo_prenotazione(p));
+    if(veicolo == NULL) return SERVIZIO_VEICOLO_NON_TROVATO;
+
+    double costo = compila_preventivo(utente, veicolo, intervallo, preventivo);
+    if(!modifica_prenotazione_per_id(tabella_utenti, tabella_veicoli, giornale, id, intervallo, costo)) return SERVIZIO_VEICOLO_OCCUPATO;
+    return SERVIZIO_OK;
+}
+
+/*
+ * Funzione: disponibilita
+ * -----------------------
+ *
+ * Restituisce i veicoli liberi per tutto l'intervallo dato
+ *
+ * Implementazione:
+ *    Delega a `ottieni_veicoli_disponibili`, che usa l'indice di disponibilità della tabella.
+ *
+ * Parametri:
+ *    tabella_veicoli: tabella dei veicoli
+ *    intervallo: intervallo richiesto
+ *    veicoli: dove scrivere il vettore dei veicoli disponibili
+ *    num_veicoli: dove scrivere il numero di veicoli disponibili
+ *
+ * Pre-condizioni:
+ *    tabella_veicoli: non deve essere NULL
+ *    veicoli e num_veicoli: non devono essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK e il vettore in `*veicoli` (NULL se non ci sono veicoli
+ *    disponibili), SERVIZIO_INTERVALLO_NON_VALIDO se `intervallo` è NULL
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    alloca il vettore, che va liberato con free; i veicoli restano della tabella
+ */
+EsitoServizio disponibilita(TabellaVeicoli tabella_veicoli, Intervallo intervallo, Veicolo **veicoli, unsigned int *num_veicoli){
+    *veicoli = NULL;
+    *num_veicoli = 0;
+    if(intervallo == NULL) return SERVIZIO_INTERVALLO_NON_VALIDO;
+
+    *veicoli = ottieni_veicoli_disponibili(tabella_veicoli, intervallo, num_veicoli);
+    if(*veicoli == NULL) *num_veicoli = 0;
+    return SERVIZIO_OK;
+}
+
+/*
+ * Funzione: storico
+ * -----------------
+ *
+ * Visita le prenotazioni dello storico del cliente
+ *
+ * Implementazione:
+ *    Delega a `visita_storico_utente`; chi deve conoscere prima il numero di prenotazioni
+ *    lo legge con `ottieni_numero_prenotazioni_utente`.
+ *
+ * Parametri:
+ *    utente: il cliente
+ *    visita: funzione chiamata per ogni prenotazione
+ *    contesto: argomento passato a `visita`
+ *
+ * Pre-condizioni:
+ *    visita: non deve essere NULL
+ *
+ * Post-condizione:
+ *    restituisce SERVIZIO_OK, oppure SERVIZIO_ACCESSO_NEGATO se `utente` non è un cliente
+ *
+ * Ritorna:
+ *    Un valore dell'enum EsitoServizio
+ *
+ * Side-effect:
+ *    costruisce lo storico del cliente se non è ancora stato letto dall'archivio
+ */
+EsitoServizio storico(Utente utente, VisitatorePrenotazioni visita, void *contesto){
+    if(!e_cliente(utente)) return SERVIZIO_ACCESSO_NEGATO;
+
+    visita_storico_utente(utente, visita, contesto);
+    return SERVIZIO_OK;
+}
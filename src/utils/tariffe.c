@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "utils/tariffe.h"
+#include "modelli/utente.h"
+
+/*
+ * Funzione: determina_fascia_oraria
+ * ---------------------------------
+ *
+ * Determina la fascia oraria di un timestamp
+ *
+ * Implementazione:
+ *    - Analizza l'ora e il giorno della settimana
+ *    - Classifica il timestamp in una delle fasce disponibili
+ *    - Gestisce eventuali errori nella conversione del tempo
+ *
+ * Parametri:
+ *    timestamp: valore time_t rappresentante il tempo da analizzare
+ *
+ * Pre-condizioni:
+ *    timestamp: deve essere un valore valido
+ *
+ * Post-condizione:
+ *    restituisce la fascia oraria corrispondente
+ *
+ * Ritorna:
+ *    Un valore dell'enum TipoFascia
+ */
+TipoFascia determina_fascia_oraria(time_t timestamp) {
+    struct tm *tm_info = localtime(&timestamp);
+    if(tm_info == NULL) {
+        // Gestione errore localtime
+        return FASCIA_NORMALE;
+    }
+
+    int ora = tm_info->tm_hour;
+    int giorno_settimana = tm_info->tm_wday;
+
+    // Weekend = nessuno sconto (alta domanda per tempo libero)
+    if (giorno_settimana == 0 || giorno_settimana == 6) {
+        return FASCIA_NORMALE;
+    }
+
+    if (ora >= 22 || ora < 6) {
+        return FASCIA_NOTTURNA;     // Notte: poca domanda
+    }
+
+    if (ora >= 6 && ora < 8) {
+        return FASCIA_MATTUTINA;    // Prima mattina: incentivo per partenze precoci
+    }
+
+    //orari di punta = prezzo pieno
+    return FASCIA_NORMALE;
+}
+
+/*
+ * Funzione: calcola_sconto_percentuale
+ * ------------------------------------
+ *
+ * Calcola lo sconto percentuale in base alla fascia oraria
+ *
+ * Implementazione:
+ *    - Utilizza uno switch per selezionare la percentuale di sconto
+ *    - Restituisce valori predefiniti per ogni fascia
+ *
+ * Parametri:
+ *    fascia: tipo di fascia oraria
+ *
+ * Pre-condizioni:
+ *    fascia: deve essere un valore valido dell'enum TipoFascia
+ *
+ * Post-condizione:
+ *    restituisce la percentuale di sconto corrispondente
+ *
+ * Ritorna:
+ *    Un double rappresentante la percentuale di sconto (es. 0.15 per 15%)
+ */
+double calcola_sconto_percentuale(TipoFascia fascia) {
+    switch (fascia) {
+        case FASCIA_NOTTURNA:     return 0.15;  // 15% sconto - molto meno richiesta
+        case FASCIA_MATTUTINA:    return 0.10;  // 10% sconto - incentivo mattutino
+        case FASCIA_NORMALE:
+        default:                  return 0.0;   // Nessuno sconto - orari normali/di punta
+    }
+}
+
+/*
+ * Funzione: ottieni_descrizione_fascia
+ * ------------------------------------
+ *
+ * Restituisce una descrizione testuale della fascia oraria
+ *
+ * Implementazione:
+ *    - Utilizza uno switch per selezionare la stringa descrittiva
+ *    - Restituisce stringhe costanti predefinite
+ *
+ * Parametri:
+ *    fascia: tipo di fascia oraria
+ *
+ * Pre-condizioni:
+ *    fascia: deve essere un valore valido dell'enum TipoFascia
+ *
+ * Post-condizione:
+ *    restituisce la descrizione corrispondente
+ *
+ * Ritorna:
+ *    Una stringa costante costante
+ */
+const char* ottieni_descrizione_fascia(TipoFascia fascia) {
+    switch (fascia) {
+        case FASCIA_NOTTURNA:     return "Sconto notturno";
+        case FASCIA_MATTUTINA:    return "Sconto mattutino";
+        case FASCIA_NORMALE:
+        default:                  return "Nessuno";
+    }
+}
+
+/*
+ * Funzione: calcola_sconto_totale
+ * -------------------------------
+ *
+ * Calcola lo sconto di una nuova prenotazione dell'utente e ne scrive il motivo
+ *
+ * Implementazione:
+ *    - Premio fedeltà del 20% se l'utente ha un numero di prenotazioni positivo e multiplo di 5
+ *    - Sconto della fascia oraria in cui inizia la prenotazione (`determina_fascia_oraria`)
+ *    - I motivi vengono uniti con " + " nella stringa `motivo`
+ *
+ * Parametri:
+ *    utente: l'utente che prenota
+ *    inizio: istante di inizio della prenotazione
+ *    motivo: stringa in cui scrivere il motivo dello sconto
+ *    dimensione_motivo: dimensione di `motivo`
+ *
+ * Pre-condizioni:
+ *    utente: non deve essere NULL
+ *    motivo: non deve essere NULL e dimensione_motivo deve essere maggiore di 0
+ *
+ * Post-condizione:
+ *    restituisce lo sconto totale; `motivo` è vuoto se non ci sono sconti
+ *
+ * Ritorna:
+ *    Un double rappresentante lo sconto (es. 0.35 per 35%)
+ */
+double calcola_sconto_totale(Utente utente, time_t inizio, char *motivo, size_t dimensione_motivo){
+    double sconto_totale = 0;
+    //  Inizializzazione sicura della stringa
+    memset(motivo, 0, dimensione_motivo);
+
+    /*Se il numero di prenotazioni è 0 allora nessun premio frequenza!*/
+    Byte molto_frequente = 0;
+    unsigned int num_prenotazioni = ottieni_numero_prenotazioni_utente(utente);
+    if(num_prenotazioni > 0)
+        molto_frequente = (num_prenotazioni % 5) == 0;
+
+    TipoFascia fascia_oraria = determina_fascia_oraria(inizio);
+
+    if(molto_frequente){
+        sconto_totale += 0.20; // 20% di sconto
+        strncpy(motivo, "Premio fedeltà (20%)", dimensione_motivo - 1);
+    }
+
+    if (fascia_oraria != FASCIA_NORMALE) {
+        double sconto_fascia = calcola_sconto_percentuale(fascia_oraria);
+        sconto_totale += sconto_fascia;
+
+        if (strlen(motivo) > 0) {
+            strncat(motivo, " + ", dimensione_motivo - strlen(motivo) - 1);
+        }
+        char temp[MOTIVO_SCONTO];
+        snprintf(temp, sizeof(temp), "%s (%.0f%%)",
+                 ottieni_descrizione_fascia(fascia_oraria), sconto_fascia * 100);
+        strncat(motivo, temp, dimensione_motivo - strlen(motivo) - 1);
+    }
+    return sconto_totale;
+}
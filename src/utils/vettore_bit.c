@@ -0,0 +1,209 @@
+#include "utils/vettore_bit.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/*
+ * Funzione: maschera_da
+ * ---------------------
+ * Restituisce una parola con a 1 i bit dalla posizione `b` (0..63) in poi.
+ */
+static uint64_t maschera_da(unsigned int b){
+    return ~(uint64_t)0 << b;
+}
+
+/*
+ * Funzione: maschera_fino_a
+ * -------------------------
+ * Restituisce una parola con a 1 i bit delle posizioni minori di `b` (1..64).
+ */
+static uint64_t maschera_fino_a(unsigned int b){
+    return b == BIT_PER_PAROLA ? ~(uint64_t)0 : ((uint64_t)1 << b) - 1;
+}
+
+/*
+ * Funzione: parole_non_nulle
+ * --------------------------
+ * Indica se almeno una delle `n` parole è diversa da 0.
+ *
+ * Implementazione:
+ *    Con AVX2 confronta 4 parole alla volta con `_mm256_testz_si256`; con SSE2
+ *    accumula 2 parole alla volta in OR e controlla l'accumulatore alla fine.
+ *    Le parole rimaste sono controllate una alla volta.
+ */
+static Byte parole_non_nulle(const uint64_t *parole, unsigned int n){
+    unsigned int i = 0;
+#if defined(__AVX2__)
+    for(; i + 4 <= n; i += 4){
+        __m256i v = _mm256_loadu_si256((const __m256i *)(parole + i));
+        if(!_mm256_testz_si256(v, v)) return 1;
+    }
+#elif defined(__SSE2__)
+    __m128i accumulatore = _mm_setzero_si128();
+    for(; i + 2 <= n; i += 2){
+        accumulatore = _mm_or_si128(accumulatore, _mm_loadu_si128((const __m128i *)(parole + i)));
+    }
+    if(_mm_movemask_epi8(_mm_cmpeq_epi8(accumulatore, _mm_setzero_si128())) != 0xFFFF) return 1;
+#endif
+    for(; i < n; i++){
+        if(parole[i]) return 1;
+    }
+    return 0;
+}
+
+/*
+ * Funzione: imposta_bit
+ * ---------------------
+ * Imposta a 1 i bit in [da, a).
+ *
+ * Implementazione:
+ *    Maschera la prima e l'ultima parola, riempie quelle intermedie.
+ *
+ * Parametri:
+ *    parole: il vettore di bit
+ *    da: primo bit da impostare
+ *    a: bit successivo all'ultimo da impostare
+ *
+ * Pre-condizioni:
+ *    parole: non deve essere NULL e deve contenere il bit `a - 1`
+ *
+ * Post-condizioni:
+ *    non restituisce niente; se `da >= a` il vettore non cambia
+ *
+ * Side-effect:
+ *    modifica il vettore di bit
+ */
+void imposta_bit(uint64_t *parole, unsigned int da, unsigned int a){
+    if(da >= a) return;
+
+    unsigned int prima = da / BIT_PER_PAROLA;
+    unsigned int ultima = (a - 1) / BIT_PER_PAROLA;
+    uint64_t inizio = maschera_da(da % BIT_PER_PAROLA);
+    uint64_t fine = maschera_fino_a((a - 1) % BIT_PER_PAROLA + 1);
+
+    if(prima == ultima){
+        parole[prima] |= inizio & fine;
+        return;
+    }
+    parole[prima] |= inizio;
+    for(unsigned int w = prima + 1; w < ultima; w++) parole[w] = ~(uint64_t)0;
+    parole[ultima] |= fine;
+}
+
+/*
+ * Funzione: azzera_bit
+ * --------------------
+ * Imposta a 0 i bit in [da, a).
+ *
+ * Implementazione:
+ *    Maschera la prima e l'ultima parola, azzera quelle intermedie.
+ *
+ * Parametri:
+ *    parole: il vettore di bit
+ *    da: primo bit da azzerare
+ *    a: bit successivo all'ultimo da azzerare
+ *
+ * Pre-condizioni:
+ *    parole: non deve essere NULL e deve contenere il bit `a - 1`
+ *
+ * Post-condizioni:
+ *    non restituisce niente; se `da >= a` il vettore non cambia
+ *
+ * Side-effect:
+ *    modifica il vettore di bit
+ */
+void azzera_bit(uint64_t *parole, unsigned int da, unsigned int a){
+    if(da >= a) return;
+
+    unsigned int prima = da / BIT_PER_PAROLA;
+    unsigned int ultima = (a - 1) / BIT_PER_PAROLA;
+    uint64_t inizio = maschera_da(da % BIT_PER_PAROLA);
+    uint64_t fine = maschera_fino_a((a - 1) % BIT_PER_PAROLA + 1);
+
+    if(prima == ultima){
+        parole[prima] &= ~(inizio & fine);
+        return;
+    }
+    parole[prima] &= ~inizio;
+    for(unsigned int w = prima + 1; w < ultima; w++) parole[w] = 0;
+    parole[ultima] &= ~fine;
+}
+
+/*
+ * Funzione: bit_impostati
+ * -----------------------
+ * Indica se almeno un bit in [da, a) è a 1.
+ *
+ * Implementazione:
+ *    Controlla prima e ultima parola con una maschera; le parole intermedie,
+ *    numerose solo per intervalli lunghi, con `parole_non_nulle`.
+ *
+ * Parametri:
+ *    parole: il vettore di bit
+ *    da: primo bit da controllare
+ *    a: bit successivo all'ultimo da controllare
+ *
+ * Pre-condizioni:
+ *    parole: non deve essere NULL e deve contenere il bit `a - 1`
+ *
+ * Post-condizioni:
+ *    restituisce 1 se almeno un bit è a 1, 0 altrimenti (anche se `da >= a`)
+ *
+ * Ritorna:
+ *    un valore di tipo Byte(1 oppure 0)
+ */
+Byte bit_impostati(const uint64_t *parole, unsigned int da, unsigned int a){
+    if(da >= a) return 0;
+
+    unsigned int prima = da / BIT_PER_PAROLA;
+    unsigned int ultima = (a - 1) / BIT_PER_PAROLA;
+    uint64_t inizio = maschera_da(da % BIT_PER_PAROLA);
+    uint64_t fine = maschera_fino_a((a - 1) % BIT_PER_PAROLA + 1);
+
+    if(prima == ultima) return (parole[prima] & inizio & fine) != 0;
+    if(parole[prima] & inizio) return 1;
+    if(parole[ultima] & fine) return 1;
+    return parole_non_nulle(parole + prima + 1, ultima - prima - 1);
+}
+
+/*
+ * Funzione: unisci_bit
+ * --------------------
+ * Calcola `destinazione |= sorgente` parola per parola.
+ *
+ * Implementazione:
+ *    Con AVX2 elabora 4 parole alla volta, con SSE2 2 parole alla volta;
+ *    le parole rimaste sono elaborate una alla volta.
+ *
+ * Parametri:
+ *    destinazione: il vettore da aggiornare
+ *    sorgente: il vettore da unire
+ *    n: numero di parole
+ *
+ * Pre-condizioni:
+ *    destinazione, sorgente: non devono essere NULL se `n` è maggiore di 0
+ *
+ * Post-condizioni:
+ *    non restituisce niente
+ *
+ * Side-effect:
+ *    modifica `destinazione`
+ */
+void unisci_bit(uint64_t *destinazione, const uint64_t *sorgente, unsigned int n){
+    unsigned int i = 0;
+#if defined(__AVX2__)
+    for(; i + 4 <= n; i += 4){
+        __m256i d = _mm256_loadu_si256((const __m256i *)(destinazione + i));
+        __m256i s = _mm256_loadu_si256((const __m256i *)(sorgente + i));
+        _mm256_storeu_si256((__m256i *)(destinazione + i), _mm256_or_si256(d, s));
+    }
+#elif defined(__SSE2__)
+    for(; i + 2 <= n; i += 2){
+        __m128i d = _mm_loadu_si128((const __m128i *)(destinazione + i));
+        __m128i s = _mm_loadu_si128((const __m128i *)(sorgente + i));
+        _mm_storeu_si128((__m128i *)(destinazione + i), _mm_or_si128(d, s));
+    }
+#endif
+    for(; i < n; i++) destinazione[i] |= sorgente[i];
+}
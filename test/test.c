@@ -4,22 +4,37 @@
  */
 
 #include <stdio.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 #include "modelli/intervallo.h"
 #include "modelli/prenotazione.h"
 #include "modelli/veicolo.h"
 #include "strutture_dati/lista.h"
 #include "strutture_dati/lista_prenotazione.h"
+#include "strutture_dati/occupazione.h"
+#include "strutture_dati/pool.h"
 #include "strutture_dati/prenotazioni.h"
+#include "strutture_dati/tabella_hash.h"
 #include "strutture_dati/tabella_veicoli.h"
 #include "modelli/utente.h"
 #include "strutture_dati/tabella_utenti.h"
+#include "utils/comandi.h"
+#include "utils/gestore_file.h"
+#include "utils/gestore_prenotazioni.h"
+#include "utils/giornale.h"
 #include "utils/md5.h"
+#include "utils/parallelo.h"
 #include "utils/utils.h"
 
 #define GRANDEZZA_RIGA 500
 #define MASSIMO_PERCORSO_FILE 1024
+#define POSIZIONI_POOL 256          // Elementi vivi al massimo nel test case 11
+#define CHIAVI_TABELLA 512          // Chiavi distinte al massimo in esegui_comandi_tabella
+#define LUNGHEZZA_CHIAVE_TABELLA 64
+#define PRENOTAZIONI_MODELLO 1024   // Prenotazioni al massimo nel modello dei test case 14 e 15
+#define VEICOLI_FLOTTA 128          // Veicoli al massimo nel test case 15
 
 /*
  * Funzione: txt_in_utenti
@@ -73,6 +88,25 @@ int txt_in_utenti(FILE *fp, TabellaUtenti tabella);
  */
 int txt_in_veicoli(FILE *fp, TabellaVeicoli tabella);
 
+// Identificativi raccolti da `raccogli_id_prenotazione`
+typedef struct {
+    uint64_t *id;
+    unsigned int num;
+} IdRaccolti;
+
+// Valori visitati da una delle visite di esegui_comandi_tabella
+typedef struct {
+    void *valori[CHIAVI_TABELLA];
+    unsigned int num;
+} VettoreValori;
+
+// Intervalli delle prenotazioni presenti, confrontati per scansione con la struttura Prenotazioni
+typedef struct {
+    time_t inizio[PRENOTAZIONI_MODELLO];
+    time_t fine[PRENOTAZIONI_MODELLO];
+    unsigned int num;
+} ModelloPrenotazioni;
+
 /*
  * Funzione: test_case_uno
  * ----------------------
@@ -107,6 +141,8 @@ int test_case_uno(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli);
  * Implementazione:
  *    Legge un file di input con intervalli di date e verifica quali veicoli
  *    sono disponibili in quei periodi, scrivendo i risultati su file.
+ *    Le targhe sono scritte in ordine alfabetico: l'ordine dei veicoli restituiti
+ *    dipende dal motore della tabella hash.
  *
  * Parametri:
  *    tabella_veicoli: tabella dei veicoli disponibili
@@ -151,123 +187,751 @@ int test_case_due(TabellaVeicoli tabella_veicoli);
 int test_case_tre(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli);
 
 /*
- * Funzione: compara_file
+ * Funzione: test_case_quattro
  * ----------------------
- * Confronta il contenuto di due file byte per byte.
+ * Esegue il test case 4: modifica di una prenotazione con il protocollo a righe.
  *
  * Implementazione:
- *    Legge contemporaneamente i due file e confronta i caratteri
- *    finché non trova una differenza o raggiunge la fine di uno dei file.
+ *    Legge un file di input con un comando per riga e lo esegue con `esegui_comando`,
+ *    come la modalità batch, scrivendo gli esiti su file. Le date delle prenotazioni
+ *    sono nel 2099, perché il servizio rifiuta gli intervalli che iniziano nel passato.
  *
  * Parametri:
- *    a: primo file da confrontare
- *    b: secondo file da confrontare
+ *    tabella_utenti: tabella degli utenti registrati
+ *    tabella_veicoli: tabella dei veicoli disponibili
  *
  * Pre-condizioni:
- *    - Entrambi i file devono essere aperti in lettura
+ *    - Entrambe le tabelle devono essere inizializzate
+ *    - I file TC4/input.txt e TC4/output.txt devono essere accessibili
  *
  * Post-condizioni:
- *    restituisce 0 se i file sono identici,
- *    1 se sono diversi
+ *    restituisce 1 se il test è stato eseguito correttamente,
+ *    -1 in caso di errore
+ *
+ * Side-effect:
+ *    Modifica le tabelle e crea/modifica il file TC4/output.txt con i risultati
  */
-int compara_file(FILE *a, FILE *b);
+int test_case_quattro(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli);
 
-int main(int argc, char **argv){
-    if(argc < 4){
-        printf("./test <test_suite_path> <utenti_path> <veicoli_path>\n");
-        return -1;
-    }
+/*
+ * Funzione: test_case_cinque
+ * ----------------------
+ * Esegue il test case 5: esiti dei comandi del protocollo a righe.
+ *
+ * Implementazione:
+ *    Come il test case 4, esegue con `esegui_comando` un comando per riga:
+ *    registrazione, accesso, disponibilità, prenotazione, cancellazione, uscita
+ *    e le righe non valide.
+ *
+ * Parametri:
+ *    tabella_utenti: tabella degli utenti registrati
+ *    tabella_veicoli: tabella dei veicoli disponibili
+ *
+ * Pre-condizioni:
+ *    - Entrambe le tabelle devono essere inizializzate
+ *    - I file TC5/input.txt e TC5/output.txt devono essere accessibili
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il test è stato eseguito correttamente,
+ *    -1 in caso di errore
+ *
+ * Side-effect:
+ *    Modifica le tabelle e crea/modifica il file TC5/output.txt con i risultati
+ */
+int test_case_cinque(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli);
 
-    unsigned numero_utenti = 20;
-    unsigned numero_veicoli = 10;
+/*
+ * Funzione: test_case_sei
+ * ----------------------
+ * Esegue il test case 6: riapplicazione del giornale delle modifiche.
+ *
+ * Implementazione:
+ *    Esegue i comandi di TC6/input.txt su tabelle nuove, caricate dai file di testo,
+ *    registrandoli nel giornale TC6/giornale.bin. Distrutte quelle tabelle, riapplica
+ *    il giornale su altre tabelle nuove due volte di seguito, poi riapplica una copia
+ *    del giornale priva dell'ultimo byte. Dopo ogni riapplicazione scrive le prenotazioni
+ *    dei veicoli e, per ogni identificativo assegnato nel test, se la prenotazione è
+ *    ancora viva e collegata allo storico del cliente.
+ *
+ * Parametri:
+ *    nome_file_utenti: file di testo degli utenti
+ *    nome_file_veicoli: file di testo dei veicoli
+ *
+ * Pre-condizioni:
+ *    - I file TC6/input.txt e TC6/output.txt devono essere accessibili
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il test è stato eseguito correttamente,
+ *    -1 in caso di errore
+ *
+ * Side-effect:
+ *    Crea/modifica il file TC6/output.txt con i risultati; i file del giornale
+ *    vengono rimossi alla fine
+ */
+int test_case_sei(const char *nome_file_utenti, const char *nome_file_veicoli);
 
-    char *test_suite = argv[1];
-    char *nome_file_utenti = argv[2];
-    char *nome_file_veicoli = argv[3];
+/*
+ * Funzione: test_case_sette
+ * ----------------------
+ * Esegue il test case 7: caricamento e salvataggio delle istantanee dell'archivio.
+ *
+ * Implementazione:
+ *    Ogni riga di TC7/input.txt indica una cartella con un'istantanea completa
+ *    (veicoli.bin, prenotazioni.bin, utenti.bin, storici.bin) scritta dai salvataggi
+ *    dei formati CAS1, CAS2 e CAS3. La carica e ne scrive il contenuto, poi la salva
+ *    nel formato corrente, la ricarica e la scrive di nuovo. Infine la ricarica ancora
+ *    e sposta le prenotazioni dagli alberi dei veicoli prima di costruire gli storici
+ *    (`modifica_istantanea_differita`). Le istantanee contengono prenotazioni agli
+ *    estremi di time_t e costi non rappresentabili in centesimi.
+ *
+ * Pre-condizioni:
+ *    - I file TC7/input.txt e TC7/output.txt devono essere accessibili
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il test è stato eseguito correttamente,
+ *    -1 in caso di errore
+ *
+ * Side-effect:
+ *    Crea/modifica il file TC7/output.txt con i risultati; i file salvati
+ *    vengono rimossi alla fine
+ */
+int test_case_sette(void);
 
-    FILE *file_test_suite = fopen(test_suite, "r");
-    FILE *file_utenti = fopen(nome_file_utenti, "r");
-    FILE *file_veicoli = fopen(nome_file_veicoli, "r");
+/*
+ * Funzione: test_case_otto
+ * ----------------------
+ * Esegue il test case 8: indice delle prenotazioni per identificativo.
+ *
+ * Implementazione:
+ *    Per ogni riga numero;passo di TC8/input.txt crea `numero` prenotazioni, ne
+ *    distrugge una ogni `passo` e controlla che `cerca_prenotazione_per_id` trovi
+ *    tutte e sole quelle rimaste, poi distrugge anche queste.
+ *
+ * Pre-condizioni:
+ *    - I file TC8/input.txt e TC8/output.txt devono essere accessibili
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il test è stato eseguito correttamente,
+ *    -1 in caso di errore
+ *
+ * Side-effect:
+ *    Crea/modifica il file TC8/output.txt con i risultati
+ */
+int test_case_otto(void);
 
-    if(!(file_test_suite && file_utenti && file_veicoli)){
-        printf("Errore apertura file utenti!\n");
-        fclose(file_test_suite);
-        fclose(file_utenti);
-        fclose(file_veicoli);
-        return -1;
-    }
+/*
+ * Funzione: test_case_nove
+ * ----------------------
+ * Esegue il test case 9: modifica e cancellazione di prenotazioni con lo storico
+ * del cliente ancora nell'archivio.
+ *
+ * Implementazione:
+ *    Esegue con `esegui_comando` i comandi di TC9/input.txt su tabelle caricate dai
+ *    file di testo. Una riga "ricarica" salva le tabelle in un'istantanea, le distrugge
+ *    e le ricarica da quella: gli storici e gli alberi dei veicoli restano nell'archivio
+ *    finché non vengono usati. I comandi che seguono costruiscono l'albero di un veicolo
+ *    prenotandolo con un altro cliente e poi spostano o cancellano una prenotazione il
+ *    cui storico non è ancora stato costruito.
+ *
+ * Parametri:
+ *    nome_file_utenti: file di testo degli utenti
+ *    nome_file_veicoli: file di testo dei veicoli
+ *
+ * Pre-condizioni:
+ *    - I file TC9/input.txt e TC9/output.txt devono essere accessibili
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il test è stato eseguito correttamente,
+ *    -1 in caso di errore
+ *
+ * Side-effect:
+ *    Crea/modifica il file TC9/output.txt con i risultati; i file delle istantanee
+ *    vengono rimossi alla fine
+ */
+int test_case_nove(const char *nome_file_utenti, const char *nome_file_veicoli);
 
-    TabellaUtenti tabella_utenti = crea_tabella_utenti(numero_utenti);
-    if(txt_in_utenti(file_utenti, tabella_utenti) < 0){
-        printf("Errore caricamento utenti!\n(Controlla il formato nome;cognome;email;password)");
-        distruggi_tabella_utenti(tabella_utenti);
-        fclose(file_test_suite);
-        fclose(file_utenti);
-        fclose(file_veicoli);
-        return -1;
-    }
+/*
+ * Funzione: test_case_dieci
+ * ----------------------
+ * Esegue il test case 10: mappa di occupazione a quarti d'ora ai bordi dell'orizzonte.
+ *
+ * Implementazione:
+ *    Esegue le righe di TC10/input.txt su una mappa con origine fissa e sull'albero di
+ *    prenotazioni che la accompagna. Gli istanti sono secondi relativi all'origine, o
+ *    MIN e MAX per gli estremi di time_t:
+ *    - prenota;inizio;fine e cancella;inizio;fine aggiornano albero e mappa
+ *    - esito;inizio;fine scrive la risposta della mappa e quella dell'albero
+ *    - mappa;primo;ultimo scrive lo stato dei quarti d'ora [primo, ultimo)
+ *    - sposta;adesso aggiorna l'orizzonte, azzera svuota albero e mappa
+ *
+ * Pre-condizioni:
+ *    - I file TC10/input.txt e TC10/output.txt devono essere accessibili
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il test è stato eseguito correttamente,
+ *    -1 in caso di errore
+ *
+ * Side-effect:
+ *    Crea/modifica il file TC10/output.txt con i risultati
+ */
+int test_case_dieci(void);
 
-    TabellaVeicoli tabella_veicoli = crea_tabella_veicoli(numero_veicoli);
-    if(txt_in_veicoli(file_veicoli, tabella_veicoli)){
-        printf("Errore caricamento veicoli!\n(Controlla il formato targa;modello;posizione;tariffa;tipo)");
-        distruggi_tabella_utenti(tabella_utenti);
-        distruggi_tabella_veicoli(tabella_veicoli);
-        fclose(file_utenti);
-        fclose(file_test_suite);
-        fclose(file_veicoli);
-        return -1;
-    }
+/*
+ * Funzione: leggi_istante
+ * -----------------------
+ * Converte un campo di TC10 in un istante: MIN e MAX sono gli estremi di time_t,
+ * ogni altro valore è un numero di secondi relativo a `origine`.
+ */
+time_t leggi_istante(const char *campo, time_t origine);
 
-    char linea[GRANDEZZA_RIGA];
+/*
+ * Funzione: test_case_undici
+ * ----------------------
+ * Esegue il test case 11: allocatore a blocchi (Pool).
+ *
+ * Implementazione:
+ *    Esegue le righe di TC11/input.txt su un pool e su un vettore di posizioni che
+ *    tiene gli elementi allocati, ognuno riempito con un byte diverso:
+ *    - crea;dimensione;elementi_per_blocco sostituisce il pool
+ *    - alloca;n occupa le prime n posizioni libere e conta gli elementi azzerati e
+ *      quelli che riusano un indirizzo rilasciato in precedenza
+ *    - rilascia;da;a rilascia gli elementi delle posizioni [da, a)
+ *    - verifica controlla che nessun elemento vivo sia stato sovrascritto
+ *    Dopo ogni riga scrive le statistiche del pool.
+ *
+ * Pre-condizioni:
+ *    - I file TC11/input.txt e TC11/output.txt devono essere accessibili
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il test è stato eseguito correttamente,
+ *    -1 in caso di errore
+ *
+ * Side-effect:
+ *    Crea/modifica il file TC11/output.txt con i risultati
+ */
+int test_case_undici(void);
 
-    FILE *file_result = fopen("result.txt", "w");
-    if(file_result == NULL){
-        printf("Errore apertura file result.txt!\n");
-        fclose(file_utenti);
-        fclose(file_veicoli);
-        fclose(file_test_suite);
-        fclose(file_result);
-        return -1;
-    }
+/*
+ * Funzione: test_case_dodici
+ * ----------------------
+ * Esegue il test case 12: cancellazioni all'interno delle sequenze di scansione.
+ *
+ * Implementazione:
+ *    Esegue TC12/input.txt con esegui_comandi_tabella. Le tabelle partono piccole e
+ *    quasi piene, così che con l'indirizzamento aperto le chiavi formino sequenze
+ *    contigue e ogni cancellazione sposti indietro (backward shift) le chiavi
+ *    successive; dopo ogni cancellazione vengono cercate tutte le chiavi.
+ *
+ * Pre-condizioni:
+ *    - I file TC12/input.txt e TC12/output.txt devono essere accessibili
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il test è stato eseguito correttamente,
+ *    -1 in caso di errore
+ *
+ * Side-effect:
+ *    Crea/modifica il file TC12/output.txt con i risultati
+ */
+int test_case_dodici(void);
 
-    while(fgets(linea, sizeof(linea), file_test_suite)){
-        linea[strcspn(linea, "\n")] = 0;
-        char *tc = strtok(linea, " ");
-        if(strcmp(tc, "TC1") == 0){
-            if(test_case_uno(tabella_utenti, tabella_veicoli) < 0){
-                printf("Errore TC1\n");
-                continue;
-            }
-        }
-        if(strcmp(tc, "TC2") == 0){
-            if(test_case_due(tabella_veicoli) < 0){
-                printf("Errore TC2\n");
-                continue;
-            }
-        }
-        if(strcmp(tc, "TC3") == 0){
-            if(test_case_tre(tabella_utenti, tabella_veicoli) < 0){
-                printf("Errore TC3\n");
-                continue;
-            }
-        }
+/*
+ * Funzione: esegui_comandi_tabella
+ * --------------------------------
+ * Esegue su una TabellaHash le righe di un file e ne scrive l'esito.
+ *
+ * Implementazione:
+ *    Le chiavi sono prefisso + numero e il valore di ogni chiave è una sua copia.
+ *    Ogni chiave usata viene ricordata, insieme al fatto che debba essere presente:
+ *    - tabella;grandezza sostituisce la tabella
+ *    - inserisci;prefisso;da;a / cancella;prefisso;da;a / cerca;prefisso;da;a
+ *      operano sulle chiavi con numero in [da, a)
+ *    - verifica cerca tutte le chiavi ricordate e controlla dimensione_tabella
+ *    - vettore, per_ogni, itera visitano la tabella con ottieni_vettore,
+ *      tabella_per_ogni e l'iteratore, contando i valori attesi e distinti
+ *
+ * Parametri:
+ *    nome_input: file dei comandi
+ *    nome_output: file in cui scrivere l'esito di ogni riga
+ *
+ * Post-condizioni:
+ *    restituisce 1 se i file sono accessibili e la tabella è stata creata, -1 altrimenti
+ */
+int esegui_comandi_tabella(const char *nome_input, const char *nome_output);
 
-        char nome_file_oracle[MASSIMO_PERCORSO_FILE] = {0};
-        snprintf(nome_file_oracle, MASSIMO_PERCORSO_FILE, "%s/oracle.txt", tc);
+/*
+ * Funzione: conta_valore_visitato
+ * -------------------------------
+ * Visitatore di tabella_per_ogni che aggiunge il valore visitato al VettoreValori `contesto`.
+ */
+void conta_valore_visitato(void *valore, void *contesto);
 
-        char nome_file_output[MASSIMO_PERCORSO_FILE] = {0};
-        snprintf(nome_file_output, MASSIMO_PERCORSO_FILE, "%s/output.txt", tc);
+/*
+ * Funzione: controlla_visita
+ * --------------------------
+ * Conta i valori visitati che sono copie di chiavi presenti e distinti dai precedenti.
+ */
+unsigned int controlla_visita(const VettoreValori *visitati, char chiavi[][LUNGHEZZA_CHIAVE_TABELLA],
+                              const Byte *presente, unsigned int num_chiavi);
 
+/*
+ * Funzione: test_case_tredici
+ * ----------------------
+ * Esegue il test case 13: operazioni durante il ridimensionamento incrementale.
+ *
+ * Implementazione:
+ *    Esegue TC13/input.txt con esegui_comandi_tabella. Ogni riga successiva a quella
+ *    che fa superare la percentuale di riempimento opera su una sola chiave, così che
+ *    inserimenti, cancellazioni, ricerche e visite si alternino mentre i vecchi bucket
+ *    vengono migrati pochi alla volta.
+ *
+ * Pre-condizioni:
+ *    - I file TC13/input.txt e TC13/output.txt devono essere accessibili
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il test è stato eseguito correttamente,
+ *    -1 in caso di errore
+ *
+ * Side-effect:
+ *    Crea/modifica il file TC13/output.txt con i risultati
+ */
+int test_case_tredici(void);
 
-        FILE *oracle_file = fopen(nome_file_oracle, "r");
-        FILE *output_file = fopen(nome_file_output, "r");
+/*
+ * Funzione: test_case_quattordici
+ * ----------------------
+ * Esegue il test case 14: divisione e svuotamento dei blocchi di prenotazioni.
+ *
+ * Implementazione:
+ *    Esegue le righe di TC14/input.txt su una struttura Prenotazioni e su un modello
+ *    (vettore non ordinato degli intervalli presenti). Le prenotazioni iniziano alle ore
+ *    `h` dopo un'origine lontana dall'orizzonte della mappa di occupazione, così che
+ *    ogni risposta venga dalla ricerca nella struttura:
+ *    - nuova svuota struttura e modello
+ *    - aggiungi;primo;ultimo;passo;durata / cancella;primo;ultimo;passo operano sulle
+ *      ore da `primo` (incluso) a `ultimo` (escluso) con passo anche negativo
+ *    - controlla confronta controlla_prenotazione, ottieni_intervallo_disponibile e
+ *      visita_prenotazioni_in_intervallo con il modello per intervalli di varie durate
+ *      che iniziano ad ogni quarto d'ora attorno alle prenotazioni
+ *    - ordine confronta visita_prenotazioni_in_ordine con il modello
+ *    Con 64 prenotazioni per blocco le sequenze superano la capacità di un blocco,
+ *    lo dividono e, cancellando, svuotano interi blocchi.
+ *
+ * Pre-condizioni:
+ *    - I file TC14/input.txt e TC14/output.txt devono essere accessibili
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il test è stato eseguito correttamente,
+ *    -1 in caso di errore
+ *
+ * Side-effect:
+ *    Crea/modifica il file TC14/output.txt con i risultati
+ */
+int test_case_quattordici(void);
 
-        if((oracle_file == NULL) || (output_file == NULL)){
-            printf("Errore apertura file oracle o output\n");
-            return -1;
-        }
-        int risultato = compara_file(oracle_file, output_file);
-        fprintf(file_result, "%s: %sHA SUPERATO IL TEST\n", tc, risultato ? "NON " : "");
+/*
+ * Funzione: raccogli_in_modello
+ * -----------------------------
+ * Visitatore che aggiunge l'intervallo della prenotazione al ModelloPrenotazioni `contesto`.
+ */
+void raccogli_in_modello(const Prenotazione p, void *contesto);
+
+/*
+ * Funzione: concorda_con_modello
+ * ------------------------------
+ * Interroga `prenotazioni` su [inizio, fine) e restituisce 1 se controlla_prenotazione,
+ * ottieni_intervallo_disponibile e visita_prenotazioni_in_intervallo danno le stesse
+ * risposte di una scansione del modello, 0 altrimenti.
+ */
+Byte concorda_con_modello(Prenotazioni prenotazioni, const ModelloPrenotazioni *modello, time_t inizio, time_t fine);
+
+/*
+ * Funzione: test_case_quindici
+ * ----------------------
+ * Esegue il test case 15: indice di disponibilità della flotta.
+ *
+ * Implementazione:
+ *    Esegue le righe di TC15/input.txt su una tabella veicoli e su un modello delle
+ *    prenotazioni di ogni veicolo. Gli istanti sono minuti dalla mezzanotte UTC di
+ *    oggi, così che le prenotazioni cadano nell'orizzonte dell'indice:
+ *    - veicoli;n aggiunge n veicoli alla tabella
+ *    - prenota;primo;ultimo;inizio;durata aggiunge ai veicoli [primo, ultimo) una
+ *      prenotazione [inizio, inizio + durata)
+ *    - cancella;primo;ultimo;inizio e modifica;primo;ultimo;inizio;nuovo_inizio;durata
+ *      cancellano e spostano per identificativo la prenotazione che inizia a `inizio`
+ *    - confronta confronta ottieni_veicoli_disponibili con una scansione del modello
+ *      per intervalli di varie durate lungo tutto l'orizzonte
+ *
+ * Pre-condizioni:
+ *    - I file TC15/input.txt e TC15/output.txt devono essere accessibili
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il test è stato eseguito correttamente,
+ *    -1 in caso di errore
+ *
+ * Side-effect:
+ *    Crea/modifica il file TC15/output.txt con i risultati
+ */
+int test_case_quindici(void);
+
+/*
+ * Funzione: concorda_con_flotta
+ * -----------------------------
+ * Interroga ottieni_veicoli_disponibili su [inizio, fine) e restituisce 1 se i veicoli
+ * restituiti sono tutti e soli quelli senza prenotazioni sovrapposte nel modello
+ * (`veicolo_di` indica il veicolo di ogni prenotazione del modello), 0 altrimenti.
+ */
+Byte concorda_con_flotta(TabellaVeicoli tabella_veicoli, unsigned int num_veicoli, const ModelloPrenotazioni *modello,
+                         const unsigned int *veicolo_di, time_t inizio, time_t fine);
+
+/*
+ * Funzione: test_case_sedici
+ * --------------------------
+ * Test del caricamento dell'archivio con uno e con più thread.
+ *
+ * Implementazione:
+ *    Per ogni riga utenti;veicoli;thread di TC16/input.txt genera un archivio con
+ *    `genera_archivio_caricamento`, lo carica con `carica_tabelle` prima con un solo
+ *    thread (le due tabelle una dopo l'altra nel thread chiamante) e poi con il
+ *    numero di thread indicato (le due tabelle contemporaneamente), e confronta
+ *    le tabelle ottenute scritte con `scrivi_tabelle_caricate`.
+ *
+ * Pre-condizioni:
+ *    - I file TC16/input.txt e TC16/output.txt devono essere accessibili
+ *
+ * Post-condizioni:
+ *    restituisce 1 se il test è stato eseguito correttamente,
+ *    -1 in caso di errore
+ *
+ * Side-effect:
+ *    Crea/modifica il file TC16/output.txt con i risultati; crea e rimuove
+ *    l'archivio e le tabelle scritte nella cartella TC16
+ */
+int test_case_sedici(void);
+
+/*
+ * Funzione: genera_archivio_caricamento
+ * -------------------------------------
+ * Salva nei file `nome_file` (utenti, storici, veicoli, prenotazioni) `num_utenti`
+ * utenti, un admin ogni dieci, e `num_veicoli` veicoli con quattro prenotazioni
+ * ciascuno, aggiunte anche allo storico del cliente se non è un admin;
+ * restituisce 1, o -1 in caso di errore.
+ */
+int genera_archivio_caricamento(const char *nome_file[4], unsigned int num_utenti, unsigned int num_veicoli);
+
+/*
+ * Funzione: scrivi_tabelle_caricate
+ * ---------------------------------
+ * Scrive con `scrivi_istantanea_caricata` gli utenti in ordine di email e i veicoli
+ * in ordine di targa delle due tabelle, e ne salva il numero in `num_utenti` e
+ * `num_veicoli`; restituisce 1, o -1 in caso di errore.
+ */
+int scrivi_tabelle_caricate(FILE *uscita, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli,
+                            unsigned int *num_utenti, unsigned int *num_veicoli);
+
+/*
+ * Funzione: compara_email
+ * -----------------------
+ * Confronta due utenti per email, per qsort.
+ */
+int compara_email(const void *a, const void *b);
+
+/*
+ * Funzione: esegui_file_comandi
+ * -----------------------------
+ * Esegue con `esegui_comando` i comandi del file `nome_input`, uno per riga, e ne
+ * scrive gli esiti nel file aperto `uscita`; restituisce 1, o -1 se il file non si apre.
+ */
+int esegui_file_comandi(const char *nome_input, FILE *uscita, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli,
+                        Giornale giornale);
+
+/*
+ * Funzione: ricarica_tabelle
+ * --------------------------
+ * Salva le tabelle nell'istantanea `nome_file` (utenti, storici, veicoli, prenotazioni),
+ * le distrugge e le ricarica da quella; restituisce 1, o -1 in caso di errore (le
+ * tabelle vengono comunque distrutte e restano NULL).
+ */
+int ricarica_tabelle(const char *nome_file[4], TabellaUtenti *tabella_utenti, TabellaVeicoli *tabella_veicoli);
+
+/*
+ * Funzione: carica_tabelle_txt
+ * ----------------------------
+ * Crea le tabelle di utenti e veicoli e le riempie dai file di testo; restituisce 0,
+ * o -1 in caso di errore (le tabelle create vengono distrutte).
+ */
+int carica_tabelle_txt(const char *nome_file_utenti, const char *nome_file_veicoli, TabellaUtenti *tabella_utenti,
+                       TabellaVeicoli *tabella_veicoli);
+
+/*
+ * Funzione: scrivi_stato
+ * ----------------------
+ * Scrive le prenotazioni dei veicoli, in ordine di targa, e per gli identificativi da
+ * `primo_id` all'ultimo assegnato se la prenotazione è viva e nello storico del cliente,
+ * con il numero di prenotazioni dello storico.
+ */
+void scrivi_stato(FILE *uscita, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, uint64_t primo_id);
+
+/*
+ * Funzione: scrivi_istantanea_caricata
+ * ------------------------------------
+ * Scrive i veicoli e gli utenti caricati da un'istantanea con le loro prenotazioni
+ * (inizio e fine come interi, costo con tutte le cifre); per lo storico indica se
+ * ogni prenotazione è la stessa dell'albero del veicolo o una sua copia.
+ */
+void scrivi_istantanea_caricata(FILE *uscita, Veicolo veicoli[], unsigned int num_veicoli, Utente utenti[], unsigned int num_utenti);
+
+/*
+ * Funzione: modifica_istantanea_differita
+ * ---------------------------------------
+ * Carica in tabelle l'istantanea `nome_file` (veicoli, prenotazioni, utenti, storici),
+ * costruisce gli alberi dei veicoli e accorcia ogni prenotazione con
+ * `modifica_prenotazione_per_id` mentre gli storici sono ancora nell'archivio, poi
+ * scrive alberi e storici con gli identificativi; restituisce 1, o -1 in caso di errore.
+ */
+int modifica_istantanea_differita(FILE *uscita, const char *nome_file[4]);
+
+/*
+ * Funzione: raccogli_id_prenotazione
+ * ----------------------------------
+ * Visitatore che aggiunge l'identificativo della prenotazione al vettore IdRaccolti `contesto`.
+ */
+void raccogli_id_prenotazione(const Prenotazione p, void *contesto);
+
+/*
+ * Funzione: scrivi_prenotazione_con_id
+ * ------------------------------------
+ * Visitatore che scrive sul file `contesto` una prenotazione come
+ * id;inizio;fine;cliente;targa;costo, con gli estremi come interi.
+ */
+void scrivi_prenotazione_con_id(const Prenotazione p, void *contesto);
+
+/*
+ * Funzione: scrivi_prenotazione_giornale
+ * --------------------------------------
+ * Visitatore che scrive sul file `contesto` una prenotazione come id;cliente;date;costo.
+ */
+void scrivi_prenotazione_giornale(const Prenotazione p, void *contesto);
+
+/*
+ * Funzione: scrivi_prenotazione_storico
+ * -------------------------------------
+ * Visitatore che scrive sul file `contesto` una prenotazione dello storico come
+ * inizio;fine;targa;costo, con gli estremi come interi e il costo con tutte le cifre.
+ */
+void scrivi_prenotazione_storico(const Prenotazione p, void *contesto);
+
+/*
+ * Funzione: scrivi_prenotazione_veicolo
+ * -------------------------------------
+ * Visitatore che scrive sul file `contesto` una prenotazione di un veicolo come
+ * inizio;fine;cliente;costo;condivisa, dove l'ultimo campo dice se è la stessa
+ * prenotazione dello storico del cliente o una copia.
+ */
+void scrivi_prenotazione_veicolo(const Prenotazione p, void *contesto);
+
+/*
+ * Funzione: compara_file
+ * ----------------------
+ * Confronta il contenuto di due file byte per byte.
+ *
+ * Implementazione:
+ *    Legge contemporaneamente i due file e confronta i caratteri
+ *    finché non trova una differenza o raggiunge la fine di uno dei file.
+ *
+ * Parametri:
+ *    a: primo file da confrontare
+ *    b: secondo file da confrontare
+ *
+ * Pre-condizioni:
+ *    - Entrambi i file devono essere aperti in lettura
+ *
+ * Post-condizioni:
+ *    restituisce 0 se i file sono identici,
+ *    1 se sono diversi
+ */
+int compara_file(FILE *a, FILE *b);
+
+/*
+ * Funzione: compara_targhe
+ * ------------------------
+ * Confronta due veicoli per targa, per qsort; i NULL vanno in fondo.
+ */
+int compara_targhe(const void *a, const void *b);
+
+int main(int argc, char **argv){
+    if(argc < 4){
+        printf("./test <test_suite_path> <utenti_path> <veicoli_path>\n");
+        return -1;
+    }
+
+    unsigned numero_utenti = 20;
+    unsigned numero_veicoli = 10;
+
+    char *test_suite = argv[1];
+    char *nome_file_utenti = argv[2];
+    char *nome_file_veicoli = argv[3];
+
+    FILE *file_test_suite = fopen(test_suite, "r");
+    FILE *file_utenti = fopen(nome_file_utenti, "r");
+    FILE *file_veicoli = fopen(nome_file_veicoli, "r");
+
+    if(!(file_test_suite && file_utenti && file_veicoli)){
+        printf("Errore apertura file utenti!\n");
+        fclose(file_test_suite);
+        fclose(file_utenti);
+        fclose(file_veicoli);
+        return -1;
+    }
+
+    TabellaUtenti tabella_utenti = crea_tabella_utenti(numero_utenti);
+    if(txt_in_utenti(file_utenti, tabella_utenti) < 0){
+        printf("Errore caricamento utenti!\n(Controlla il formato nome;cognome;email;password)");
+        distruggi_tabella_utenti(tabella_utenti);
+        fclose(file_test_suite);
+        fclose(file_utenti);
+        fclose(file_veicoli);
+        return -1;
+    }
+
+    TabellaVeicoli tabella_veicoli = crea_tabella_veicoli(numero_veicoli);
+    if(txt_in_veicoli(file_veicoli, tabella_veicoli)){
+        printf("Errore caricamento veicoli!\n(Controlla il formato targa;modello;posizione;tariffa;tipo)");
+        distruggi_tabella_utenti(tabella_utenti);
+        distruggi_tabella_veicoli(tabella_veicoli);
+        fclose(file_utenti);
+        fclose(file_test_suite);
+        fclose(file_veicoli);
+        return -1;
+    }
+
+    char linea[GRANDEZZA_RIGA];
+
+    FILE *file_result = fopen("result.txt", "w");
+    if(file_result == NULL){
+        printf("Errore apertura file result.txt!\n");
+        fclose(file_utenti);
+        fclose(file_veicoli);
+        fclose(file_test_suite);
+        fclose(file_result);
+        return -1;
+    }
+
+    while(fgets(linea, sizeof(linea), file_test_suite)){
+        linea[strcspn(linea, "\n")] = 0;
+        char *tc = strtok(linea, " ");
+        if(strcmp(tc, "TC1") == 0){
+            if(test_case_uno(tabella_utenti, tabella_veicoli) < 0){
+                printf("Errore TC1\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC2") == 0){
+            if(test_case_due(tabella_veicoli) < 0){
+                printf("Errore TC2\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC3") == 0){
+            if(test_case_tre(tabella_utenti, tabella_veicoli) < 0){
+                printf("Errore TC3\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC4") == 0){
+            if(test_case_quattro(tabella_utenti, tabella_veicoli) < 0){
+                printf("Errore TC4\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC5") == 0){
+            if(test_case_cinque(tabella_utenti, tabella_veicoli) < 0){
+                printf("Errore TC5\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC6") == 0){
+            if(test_case_sei(nome_file_utenti, nome_file_veicoli) < 0){
+                printf("Errore TC6\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC7") == 0){
+            if(test_case_sette() < 0){
+                printf("Errore TC7\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC8") == 0){
+            if(test_case_otto() < 0){
+                printf("Errore TC8\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC9") == 0){
+            if(test_case_nove(nome_file_utenti, nome_file_veicoli) < 0){
+                printf("Errore TC9\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC10") == 0){
+            if(test_case_dieci() < 0){
+                printf("Errore TC10\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC11") == 0){
+            if(test_case_undici() < 0){
+                printf("Errore TC11\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC12") == 0){
+            if(test_case_dodici() < 0){
+                printf("Errore TC12\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC13") == 0){
+            if(test_case_tredici() < 0){
+                printf("Errore TC13\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC14") == 0){
+            if(test_case_quattordici() < 0){
+                printf("Errore TC14\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC15") == 0){
+            if(test_case_quindici() < 0){
+                printf("Errore TC15\n");
+                continue;
+            }
+        }
+        if(strcmp(tc, "TC16") == 0){
+            if(test_case_sedici() < 0){
+                printf("Errore TC16\n");
+                continue;
+            }
+        }
+
+        char nome_file_oracle[MASSIMO_PERCORSO_FILE] = {0};
+        snprintf(nome_file_oracle, MASSIMO_PERCORSO_FILE, "%s/oracle.txt", tc);
+
+        char nome_file_output[MASSIMO_PERCORSO_FILE] = {0};
+        snprintf(nome_file_output, MASSIMO_PERCORSO_FILE, "%s/output.txt", tc);
+
+
+        FILE *oracle_file = fopen(nome_file_oracle, "r");
+        FILE *output_file = fopen(nome_file_output, "r");
+
+        if((oracle_file == NULL) || (output_file == NULL)){
+            printf("Errore apertura file oracle o output\n");
+            return -1;
+        }
+        int risultato = compara_file(oracle_file, output_file);
+        fprintf(file_result, "%s: %sHA SUPERATO IL TEST\n", tc, risultato ? "NON " : "");
         fclose(oracle_file);
         fclose(output_file);
     }
@@ -406,6 +1070,7 @@ int test_case_due(TabellaVeicoli tabella_veicoli){
             distruggi_intervallo(i);
             return -1;
         }
+        qsort(vettore_veicoli, dimensione, sizeof(Veicolo), compara_targhe);
         for(unsigned int i = 0; i < dimensione; i++){
             if(vettore_veicoli[i] != NULL){
                 fprintf(file_output, "%s'%s'", sep, ottieni_targa(vettore_veicoli[i]));
@@ -472,8 +1137,1194 @@ int test_case_tre(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli){
     return 1;
 }
 
-int compara_file(FILE *a, FILE *b) {
-    int ca, cb;
-    for(ca = getc(a), cb = getc(b); (ca != EOF && cb != EOF) && (ca == cb); ca = getc(a), cb = getc(b));
-    return ca != cb;
+int test_case_quattro(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli){
+    FILE *file_output = fopen("TC4/output.txt", "w");
+    if(file_output == NULL) return -1;
+
+    int esito = esegui_file_comandi("TC4/input.txt", file_output, tabella_utenti, tabella_veicoli, NULL);
+    fclose(file_output);
+    return esito;
+}
+
+int test_case_cinque(TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli){
+    FILE *file_output = fopen("TC5/output.txt", "w");
+    if(file_output == NULL) return -1;
+
+    int esito = esegui_file_comandi("TC5/input.txt", file_output, tabella_utenti, tabella_veicoli, NULL);
+    fclose(file_output);
+    return esito;
+}
+
+int test_case_sei(const char *nome_file_utenti, const char *nome_file_veicoli){
+    const char *nome_giornale = "TC6/giornale.bin";
+    const char *nome_troncato = "TC6/giornale_troncato.bin";
+    FILE *file_output = fopen("TC6/output.txt", "w");
+    if(file_output == NULL) return -1;
+
+    TabellaUtenti tabella_utenti;
+    TabellaVeicoli tabella_veicoli;
+    uint64_t primo_id = ottieni_ultimo_id_prenotazione() + 1;
+
+    // Comandi registrati nel giornale
+    remove(nome_giornale);
+    Giornale giornale = apri_giornale(nome_giornale);
+    if(giornale == NULL || carica_tabelle_txt(nome_file_utenti, nome_file_veicoli, &tabella_utenti, &tabella_veicoli) < 0){
+        chiudi_giornale(giornale);
+        fclose(file_output);
+        return -1;
+    }
+    int esito = esegui_file_comandi("TC6/input.txt", file_output, tabella_utenti, tabella_veicoli, giornale);
+    fprintf(file_output, "Record registrati: %u\n", dimensione_giornale(giornale));
+    scrivi_stato(file_output, tabella_utenti, tabella_veicoli, primo_id);
+    chiudi_giornale(giornale);
+    distruggi_tabella_utenti(tabella_utenti);
+    distruggi_tabella_veicoli(tabella_veicoli);
+    if(esito < 0){
+        fclose(file_output);
+        return -1;
+    }
+
+    // Copia del giornale senza l'ultimo byte, come dopo un arresto durante una scrittura
+    FILE *file_giornale = fopen(nome_giornale, "rb");
+    FILE *file_troncato = fopen(nome_troncato, "wb");
+    if(!(file_giornale && file_troncato)){
+        if(file_giornale) fclose(file_giornale);
+        if(file_troncato) fclose(file_troncato);
+        fclose(file_output);
+        return -1;
+    }
+    int c, precedente = EOF;
+    while((c = getc(file_giornale)) != EOF){
+        if(precedente != EOF) putc(precedente, file_troncato);
+        precedente = c;
+    }
+    fclose(file_giornale);
+    fclose(file_troncato);
+
+    // Riapplicazione due volte di seguito sulle stesse tabelle
+    giornale = apri_giornale(nome_giornale);
+    if(giornale == NULL || carica_tabelle_txt(nome_file_utenti, nome_file_veicoli, &tabella_utenti, &tabella_veicoli) < 0){
+        chiudi_giornale(giornale);
+        fclose(file_output);
+        return -1;
+    }
+    for(int volta = 1; volta <= 2; volta++){
+        fprintf(file_output, "Riapplicazione %d: %d record\n", volta, riapplica_giornale(giornale, tabella_utenti, tabella_veicoli));
+        scrivi_stato(file_output, tabella_utenti, tabella_veicoli, primo_id);
+    }
+    chiudi_giornale(giornale);
+    distruggi_tabella_utenti(tabella_utenti);
+    distruggi_tabella_veicoli(tabella_veicoli);
+
+    // Riapplicazione del giornale troncato: l'ultimo record viene scartato
+    giornale = apri_giornale(nome_troncato);
+    if(giornale == NULL || carica_tabelle_txt(nome_file_utenti, nome_file_veicoli, &tabella_utenti, &tabella_veicoli) < 0){
+        chiudi_giornale(giornale);
+        fclose(file_output);
+        return -1;
+    }
+    fprintf(file_output, "Riapplicazione del giornale troncato: %d\n", riapplica_giornale(giornale, tabella_utenti, tabella_veicoli));
+    fprintf(file_output, "Giornale integro: %d, record letti: %u\n", giornale_integro(giornale), dimensione_giornale(giornale));
+    scrivi_stato(file_output, tabella_utenti, tabella_veicoli, primo_id);
+    chiudi_giornale(giornale);
+    distruggi_tabella_utenti(tabella_utenti);
+    distruggi_tabella_veicoli(tabella_veicoli);
+
+    remove(nome_giornale);
+    remove(nome_troncato);
+    fclose(file_output);
+    return 1;
+}
+
+int test_case_sette(void){
+    const char *salvati[4] = { "TC7/veicoli.bin", "TC7/prenotazioni.bin", "TC7/utenti.bin", "TC7/storici.bin" };
+    FILE *file_input = fopen("TC7/input.txt", "r");
+    FILE *file_output = fopen("TC7/output.txt", "w");
+    if(!(file_input && file_output)) return -1;
+
+    char linea[GRANDEZZA_RIGA];
+    const char *nuova_linea = "";
+    while (fgets(linea, sizeof(linea), file_input)) {
+        linea[strcspn(linea, "\n")] = 0;
+
+        char nomi[4][MASSIMO_PERCORSO_FILE];
+        const char *file[4] = { "veicoli.bin", "prenotazioni.bin", "utenti.bin", "storici.bin" };
+        for(int i = 0; i < 4; i++) snprintf(nomi[i], MASSIMO_PERCORSO_FILE, "TC7/%s/%s", linea, file[i]);
+
+        fprintf(file_output, "%sIstantanea %s\n", nuova_linea, linea);
+        for(int passo = 0; passo < 2; passo++){
+            unsigned int num_veicoli, num_utenti;
+            const char *veicoli_bin = passo ? salvati[0] : nomi[0], *prenotazioni_bin = passo ? salvati[1] : nomi[1];
+            const char *utenti_bin = passo ? salvati[2] : nomi[2], *storici_bin = passo ? salvati[3] : nomi[3];
+            Veicolo *veicoli = carica_vettore_veicoli(veicoli_bin, prenotazioni_bin, &num_veicoli);
+            Utente *utenti = carica_vettore_utenti(utenti_bin, storici_bin, &num_utenti);
+            if(veicoli == NULL || utenti == NULL){
+                fclose(file_input);
+                fclose(file_output);
+                return -1;
+            }
+
+            fprintf(file_output, passo ? "Dopo il salvataggio:\n" : "Caricata:\n");
+            scrivi_istantanea_caricata(file_output, veicoli, num_veicoli, utenti, num_utenti);
+            if(!passo && !(salva_vettore_veicoli(salvati[0], salvati[1], veicoli, num_veicoli, 1) &&
+                           salva_vettore_utenti(salvati[2], salvati[3], utenti, num_utenti, 1)))
+                fprintf(file_output, "Salvataggio fallito\n");
+
+            for(unsigned int i = 0; i < num_veicoli; i++) distruggi_veicolo(veicoli[i]);
+            for(unsigned int i = 0; i < num_utenti; i++) distruggi_utente(utenti[i]);
+            free(veicoli);
+            free(utenti);
+        }
+        if(modifica_istantanea_differita(file_output, salvati) < 0){
+            fclose(file_input);
+            fclose(file_output);
+            return -1;
+        }
+        for(int i = 0; i < 4; i++) remove(salvati[i]);
+        nuova_linea = "\n";
+    }
+
+    fclose(file_input);
+    fclose(file_output);
+    return 1;
+}
+
+int test_case_otto(void){
+    FILE *file_input = fopen("TC8/input.txt", "r");
+    FILE *file_output = fopen("TC8/output.txt", "w");
+    if(!(file_input && file_output)) return -1;
+
+    char linea[GRANDEZZA_RIGA];
+    while (fgets(linea, sizeof(linea), file_input)) {
+        unsigned int numero, passo;
+        if(sscanf(linea, "%u;%u", &numero, &passo) != 2 || numero == 0 || passo == 0){
+            fclose(file_input);
+            fclose(file_output);
+            return -1;
+        }
+
+        Prenotazione *prenotazioni = malloc(numero * sizeof(Prenotazione));
+        uint64_t *id = malloc(numero * sizeof(uint64_t));
+        Intervallo i = crea_intervallo(0, 60);
+        if(prenotazioni == NULL || id == NULL || i == NULL){
+            free(prenotazioni);
+            free(id);
+            distruggi_intervallo(i);
+            fclose(file_input);
+            fclose(file_output);
+            return -1;
+        }
+        for(unsigned int k = 0; k < numero; k++){
+            prenotazioni[k] = crea_prenotazione("indice@email.com", "AB123CD", i, 0);
+            id[k] = ottieni_id_prenotazione(prenotazioni[k]);
+        }
+        distruggi_intervallo(i);
+
+        unsigned int distrutte = 0;
+        for(unsigned int k = 0; k < numero; k += passo){
+            distruggi_prenotazione(prenotazioni[k]);
+            prenotazioni[k] = NULL;
+            distrutte++;
+        }
+
+        unsigned int trovate = 0, assenti = 0;
+        for(unsigned int k = 0; k < numero; k++){
+            Prenotazione p = cerca_prenotazione_per_id(id[k]);
+            if(prenotazioni[k] != NULL && p == prenotazioni[k]) trovate++;
+            if(prenotazioni[k] == NULL && p == NULL) assenti++;
+        }
+        fprintf(file_output, "%u prenotazioni, una ogni %u distrutta: trovate %u su %u, assenti %u su %u\n",
+                numero, passo, trovate, numero - distrutte, assenti, distrutte);
+
+        for(unsigned int k = 0; k < numero; k++) distruggi_prenotazione(prenotazioni[k]);
+        assenti = 0;
+        for(unsigned int k = 0; k < numero; k++) if(cerca_prenotazione_per_id(id[k]) == NULL) assenti++;
+        fprintf(file_output, "Dopo averle distrutte tutte: assenti %u su %u\n", assenti, numero);
+        free(prenotazioni);
+        free(id);
+    }
+
+    fclose(file_input);
+    fclose(file_output);
+    return 1;
+}
+
+int test_case_nove(const char *nome_file_utenti, const char *nome_file_veicoli){
+    // Due istantanee a turno: quella da cui si ricarica è ancora mappata mentre si salva l'altra
+    const char *istantanee[2][4] = {
+        { "TC9/utenti_1.bin", "TC9/storici_1.bin", "TC9/veicoli_1.bin", "TC9/prenotazioni_1.bin" },
+        { "TC9/utenti_2.bin", "TC9/storici_2.bin", "TC9/veicoli_2.bin", "TC9/prenotazioni_2.bin" }
+    };
+    FILE *file_input = fopen("TC9/input.txt", "r");
+    FILE *file_output = fopen("TC9/output.txt", "w");
+    TabellaUtenti tabella_utenti;
+    TabellaVeicoli tabella_veicoli;
+    if(!(file_input && file_output) ||
+       carica_tabelle_txt(nome_file_utenti, nome_file_veicoli, &tabella_utenti, &tabella_veicoli) < 0){
+        if(file_input) fclose(file_input);
+        if(file_output) fclose(file_output);
+        return -1;
+    }
+
+    char linea[GRANDEZZA_RIGA];
+    Utente sessione = NULL;
+    int esito = 1, ricariche = 0;
+    while (esito > 0 && fgets(linea, sizeof(linea), file_input)) {
+        linea[strcspn(linea, "\n")] = 0;
+        if(strcmp(linea, "ricarica") == 0){
+            // La sessione apparteneva alle tabelle distrutte
+            sessione = NULL;
+            esito = ricarica_tabelle(istantanee[ricariche++ % 2], &tabella_utenti, &tabella_veicoli);
+            fprintf(file_output, esito > 0 ? "Tabelle salvate e ricaricate\n" : "Ricaricamento fallito\n");
+            continue;
+        }
+        esegui_comando(linea, &sessione, file_output, tabella_utenti, tabella_veicoli, NULL);
+    }
+
+    distruggi_tabella_utenti(tabella_utenti);
+    distruggi_tabella_veicoli(tabella_veicoli);
+    for(int i = 0; i < 2; i++)
+        for(int j = 0; j < 4; j++) remove(istantanee[i][j]);
+    fclose(file_input);
+    fclose(file_output);
+    return esito;
+}
+
+int test_case_dieci(void){
+    FILE *file_input = fopen("TC10/input.txt", "r");
+    FILE *file_output = fopen("TC10/output.txt", "w");
+    if(!(file_input && file_output)){
+        if(file_input) fclose(file_input);
+        if(file_output) fclose(file_output);
+        return -1;
+    }
+
+    // Lunedì 8 giugno 2099 alle 10:30 UTC: l'origine è la mezzanotte dello stesso giorno
+    const time_t adesso = 4084560000 + 37800;
+    const char *esiti[] = { "OCCUPATO", "OK", "INCERTO" };
+    Occupazione occupazione;
+    Prenotazioni prenotazioni = crea_prenotazioni();
+    inizializza_occupazione(&occupazione, adesso);
+    const time_t origine = occupazione.origine;
+
+    char linea[GRANDEZZA_RIGA];
+    while (prenotazioni != NULL && fgets(linea, sizeof(linea), file_input)) {
+        linea[strcspn(linea, "\n")] = 0;
+        fprintf(file_output, "%s: ", linea);
+        char *comando = strtok(linea, ";"), *campo_a = strtok(NULL, ";"), *campo_b = strtok(NULL, ";");
+        if(comando == NULL) comando = "";
+        time_t a = campo_a ? leggi_istante(campo_a, origine) : 0, b = campo_b ? leggi_istante(campo_b, origine) : 0;
+
+        if(strcmp(comando, "prenota") == 0 || strcmp(comando, "cancella") == 0){
+            Intervallo i = crea_intervallo(a, b);
+            if(i == NULL){
+                fprintf(file_output, "intervallo non valido\n");
+                continue;
+            }
+            if(comando[0] == 'p'){
+                Prenotazione p = crea_prenotazione("occupazione@email.com", "AB123CD", i, 0);
+                Byte esito = p != NULL && aggiungi_prenotazione(prenotazioni, p) == OK;
+                if(esito) segna_occupazione(&occupazione, a, b);
+                else distruggi_prenotazione(p);
+                fprintf(file_output, "%s\n", esito ? "aggiunta" : "rifiutata");
+            } else {
+                Byte esito = cancella_prenotazione(prenotazioni, i);
+                if(esito) libera_occupazione(&occupazione, prenotazioni, a, b);
+                fprintf(file_output, "%s\n", esito ? "cancellata" : "assente");
+            }
+            distruggi_intervallo(i);
+        } else if(strcmp(comando, "esito") == 0){
+            Intervallo i = crea_intervallo(a, b);
+            fprintf(file_output, "%s, albero %s\n", esiti[esito_occupazione(&occupazione, a, b)],
+                    i != NULL && controlla_prenotazione(prenotazioni, i) == OK ? "libero" : "occupato");
+            distruggi_intervallo(i);
+        } else if(strcmp(comando, "mappa") == 0){
+            // Qui i campi sono indici di quarti d'ora dall'origine corrente della mappa
+            long long primo = campo_a ? strtoll(campo_a, NULL, 10) : 0, ultimo = campo_b ? strtoll(campo_b, NULL, 10) : 0;
+            for(long long q = primo; q < ultimo; q++){
+                time_t inizio = occupazione.origine + (time_t)q * DURATA_QUARTO;
+                Byte esito = esito_occupazione(&occupazione, inizio, inizio + DURATA_QUARTO);
+                putc(esito == OK ? '.' : esito == OCCUPATO ? '#' : '?', file_output);
+            }
+            putc('\n', file_output);
+        } else if(strcmp(comando, "sposta") == 0){
+            aggiorna_orizzonte_occupazione(&occupazione, prenotazioni, a);
+            fprintf(file_output, "origine %+lld\n", (long long)(occupazione.origine - origine));
+        } else if(strcmp(comando, "azzera") == 0){
+            distruggi_prenotazioni(prenotazioni);
+            prenotazioni = crea_prenotazioni();
+            inizializza_occupazione(&occupazione, adesso);
+            fprintf(file_output, "vuota\n");
+        } else {
+            fprintf(file_output, "comando sconosciuto\n");
+        }
+    }
+
+    int esito = prenotazioni != NULL ? 1 : -1;
+    distruggi_prenotazioni(prenotazioni);
+    fclose(file_input);
+    fclose(file_output);
+    return esito;
+}
+
+time_t leggi_istante(const char *campo, time_t origine){
+    if(strcmp(campo, "MIN") == 0) return (time_t)INT64_MIN;
+    if(strcmp(campo, "MAX") == 0) return (time_t)INT64_MAX;
+    return origine + (time_t)strtoll(campo, NULL, 10);
+}
+
+int test_case_undici(void){
+    FILE *file_input = fopen("TC11/input.txt", "r");
+    FILE *file_output = fopen("TC11/output.txt", "w");
+    if(!(file_input && file_output)){
+        if(file_input) fclose(file_input);
+        if(file_output) fclose(file_output);
+        return -1;
+    }
+
+    Pool pool = NULL;
+    size_t dimensione = 0;
+    unsigned char *elementi[POSIZIONI_POOL] = { NULL };
+    void *rilasciati[POSIZIONI_POOL];
+    unsigned int num_rilasciati = 0;
+    int esito = 1;
+
+    char linea[GRANDEZZA_RIGA];
+    while (esito > 0 && fgets(linea, sizeof(linea), file_input)) {
+        linea[strcspn(linea, "\n")] = 0;
+        fprintf(file_output, "%s: ", linea);
+        char *comando = strtok(linea, ";"), *campo_a = strtok(NULL, ";"), *campo_b = strtok(NULL, ";");
+        unsigned int a = campo_a ? (unsigned int)strtoul(campo_a, NULL, 10) : 0;
+        unsigned int b = campo_b ? (unsigned int)strtoul(campo_b, NULL, 10) : 0;
+        if(comando == NULL) comando = "";
+
+        if(strcmp(comando, "crea") == 0){
+            distruggi_pool(pool);
+            pool = crea_pool(a, b);
+            dimensione = a;
+            memset(elementi, 0, sizeof(elementi));
+            num_rilasciati = 0;
+            fprintf(file_output, "%s", pool ? "creato" : "non creato");
+        } else if(strcmp(comando, "alloca") == 0){
+            unsigned int riusati = 0, azzerati = 0, posizione = 0;
+            for(unsigned int k = 0; k < a; k++){
+                while(posizione < POSIZIONI_POOL && elementi[posizione] != NULL) posizione++;
+                unsigned char *e = posizione < POSIZIONI_POOL ? alloca_da_pool(pool) : NULL;
+                if(e == NULL){
+                    esito = -1;
+                    break;
+                }
+
+                size_t j = 0;
+                while(j < dimensione && e[j] == 0) j++;
+                if(j == dimensione) azzerati++;
+                for(unsigned int r = 0; r < num_rilasciati; r++){
+                    if(rilasciati[r] == e){
+                        rilasciati[r] = rilasciati[--num_rilasciati];
+                        riusati++;
+                        break;
+                    }
+                }
+                memset(e, (int)(posizione + 1), dimensione);
+                elementi[posizione] = e;
+            }
+            fprintf(file_output, "riusati %u, azzerati %u", riusati, azzerati);
+        } else if(strcmp(comando, "rilascia") == 0){
+            for(unsigned int posizione = a; posizione < b && posizione < POSIZIONI_POOL; posizione++){
+                if(elementi[posizione] == NULL) continue;
+                rilascia_in_pool(pool, elementi[posizione]);
+                rilasciati[num_rilasciati++] = elementi[posizione];
+                elementi[posizione] = NULL;
+            }
+            fprintf(file_output, "rilasciati %u in tutto", num_rilasciati);
+        } else if(strcmp(comando, "verifica") == 0){
+            unsigned int vivi = 0, integri = 0;
+            for(unsigned int posizione = 0; posizione < POSIZIONI_POOL; posizione++){
+                if(elementi[posizione] == NULL) continue;
+                size_t j = 0;
+                while(j < dimensione && elementi[posizione][j] == (unsigned char)(posizione + 1)) j++;
+                vivi++;
+                if(j == dimensione) integri++;
+            }
+            fprintf(file_output, "integri %u su %u", integri, vivi);
+        } else {
+            fprintf(file_output, "comando sconosciuto");
+        }
+
+        StatistichePool s = ottieni_statistiche_pool(pool);
+        fprintf(file_output, " (richieste %lu, rilasci %lu, blocchi %lu, in uso %lu)\n", s.richieste, s.rilasci, s.blocchi, s.in_uso);
+    }
+
+    distruggi_pool(pool);
+    fclose(file_input);
+    fclose(file_output);
+    return esito;
+}
+
+int test_case_dodici(void){
+    return esegui_comandi_tabella("TC12/input.txt", "TC12/output.txt");
+}
+
+void conta_valore_visitato(void *valore, void *contesto){
+    VettoreValori *visitati = contesto;
+    if(visitati->num < CHIAVI_TABELLA) visitati->valori[visitati->num] = valore;
+    visitati->num++;
+}
+
+unsigned int controlla_visita(const VettoreValori *visitati, char chiavi[][LUNGHEZZA_CHIAVE_TABELLA],
+                              const Byte *presente, unsigned int num_chiavi){
+    unsigned int corretti = 0;
+    for(unsigned int i = 0; i < visitati->num && i < CHIAVI_TABELLA; i++){
+        unsigned int k = 0;
+        while(k < num_chiavi && strcmp(chiavi[k], visitati->valori[i]) != 0) k++;
+        unsigned int j = 0;
+        while(j < i && visitati->valori[j] != visitati->valori[i]) j++;
+        if(k < num_chiavi && presente[k] && j == i) corretti++;
+    }
+    return corretti;
+}
+
+int esegui_comandi_tabella(const char *nome_input, const char *nome_output){
+    FILE *file_input = fopen(nome_input, "r");
+    FILE *file_output = fopen(nome_output, "w");
+    if(!(file_input && file_output)){
+        if(file_input) fclose(file_input);
+        if(file_output) fclose(file_output);
+        return -1;
+    }
+
+    TabellaHash tabella = NULL;
+    static char chiavi[CHIAVI_TABELLA][LUNGHEZZA_CHIAVE_TABELLA];
+    static Byte presente[CHIAVI_TABELLA];
+    static VettoreValori visitati;
+    unsigned int num_chiavi = 0;
+    int esito = 1;
+
+    char linea[GRANDEZZA_RIGA];
+    while (esito > 0 && fgets(linea, sizeof(linea), file_input)) {
+        linea[strcspn(linea, "\n")] = 0;
+        fprintf(file_output, "%s: ", linea);
+        char *comando = strtok(linea, ";");
+        if(comando == NULL) comando = "";
+
+        if(strcmp(comando, "tabella") == 0){
+            char *campo = strtok(NULL, ";");
+            distruggi_tabella(tabella, free);
+            tabella = nuova_tabella_hash(campo ? (unsigned int)strtoul(campo, NULL, 10) : 0);
+            num_chiavi = 0;
+            if(tabella == NULL) esito = -1;
+            fprintf(file_output, "%s\n", tabella ? "creata" : "non creata");
+        } else if(strcmp(comando, "inserisci") == 0 || strcmp(comando, "cancella") == 0 || strcmp(comando, "cerca") == 0){
+            char *prefisso = strtok(NULL, ";"), *campo_da = strtok(NULL, ";"), *campo_a = strtok(NULL, ";");
+            if(!(prefisso && campo_da && campo_a)){
+                fprintf(file_output, "comando incompleto\n");
+                continue;
+            }
+
+            unsigned int da = (unsigned int)strtoul(campo_da, NULL, 10), a = (unsigned int)strtoul(campo_a, NULL, 10);
+            unsigned int riusciti = 0;
+            for(unsigned int n = da; n < a; n++){
+                char chiave[LUNGHEZZA_CHIAVE_TABELLA];
+                snprintf(chiave, sizeof(chiave), "%s%u", prefisso, n);
+                unsigned int k = 0;
+                while(k < num_chiavi && strcmp(chiavi[k], chiave) != 0) k++;
+                if(k == num_chiavi && num_chiavi < CHIAVI_TABELLA){
+                    strcpy(chiavi[num_chiavi], chiave);
+                    presente[num_chiavi++] = 0;
+                }
+
+                if(comando[1] == 'n'){
+                    char *valore = mia_strdup(chiave);
+                    if(valore != NULL && inserisci_in_tabella(tabella, chiave, valore)){
+                        riusciti++;
+                        if(k < CHIAVI_TABELLA) presente[k] = 1;
+                    } else {
+                        free(valore);
+                    }
+                } else if(comando[1] == 'a'){
+                    if(cancella_dalla_tabella(tabella, chiave, free)){
+                        riusciti++;
+                        if(k < CHIAVI_TABELLA) presente[k] = 0;
+                    }
+                } else {
+                    const char *valore = cerca_in_tabella(tabella, chiave);
+                    if(valore != NULL && strcmp(valore, chiave) == 0) riusciti++;
+                }
+            }
+            fprintf(file_output, "%u su %u\n", riusciti, a > da ? a - da : 0);
+        } else if(strcmp(comando, "verifica") == 0){
+            unsigned int attese = 0, trovate = 0, cancellate = 0, assenti = 0;
+            for(unsigned int k = 0; k < num_chiavi; k++){
+                const char *valore = cerca_in_tabella(tabella, chiavi[k]);
+                if(presente[k]){
+                    attese++;
+                    if(valore != NULL && strcmp(valore, chiavi[k]) == 0) trovate++;
+                } else {
+                    cancellate++;
+                    if(valore == NULL) assenti++;
+                }
+            }
+            fprintf(file_output, "trovate %u su %u, assenti %u su %u, dimensione %u\n",
+                    trovate, attese, assenti, cancellate, dimensione_tabella(tabella));
+        } else if(strcmp(comando, "vettore") == 0 || strcmp(comando, "per_ogni") == 0 || strcmp(comando, "itera") == 0){
+            visitati.num = 0;
+            if(comando[0] == 'v'){
+                unsigned int dimensione = 0;
+                void **vettore = ottieni_vettore(tabella, &dimensione);
+                for(unsigned int i = 0; vettore != NULL && i < dimensione; i++) conta_valore_visitato(vettore[i], &visitati);
+                free(vettore);
+            } else if(comando[0] == 'p'){
+                tabella_per_ogni(tabella, conta_valore_visitato, &visitati);
+            } else {
+                IteratoreTabella iteratore;
+                tabella_iter_init(&iteratore, tabella);
+                void *valore;
+                while((valore = tabella_iter_next(&iteratore)) != NULL) conta_valore_visitato(valore, &visitati);
+            }
+            fprintf(file_output, "visitati %u, corretti %u\n", visitati.num,
+                    controlla_visita(&visitati, chiavi, presente, num_chiavi));
+        } else {
+            fprintf(file_output, "comando sconosciuto\n");
+        }
+    }
+
+    distruggi_tabella(tabella, free);
+    fclose(file_input);
+    fclose(file_output);
+    return esito;
+}
+
+int test_case_tredici(void){
+    return esegui_comandi_tabella("TC13/input.txt", "TC13/output.txt");
+}
+
+int test_case_quattordici(void){
+    FILE *file_input = fopen("TC14/input.txt", "r");
+    FILE *file_output = fopen("TC14/output.txt", "w");
+    if(!(file_input && file_output)){
+        if(file_input) fclose(file_input);
+        if(file_output) fclose(file_output);
+        return -1;
+    }
+
+    const time_t origine = 4084560000;  // Lunedì 08/06/2099 00:00 UTC, oltre l'orizzonte della mappa
+    Prenotazioni prenotazioni = crea_prenotazioni();
+    static ModelloPrenotazioni modello, visitate;
+    modello.num = 0;
+
+    char linea[GRANDEZZA_RIGA];
+    while (prenotazioni != NULL && fgets(linea, sizeof(linea), file_input)) {
+        linea[strcspn(linea, "\n")] = 0;
+        fprintf(file_output, "%s: ", linea);
+        char *comando = strtok(linea, ";");
+        char *campi[4];
+        for(int k = 0; k < 4; k++) campi[k] = strtok(NULL, ";");
+        if(comando == NULL) comando = "";
+
+        if(strcmp(comando, "nuova") == 0){
+            distruggi_prenotazioni(prenotazioni);
+            prenotazioni = crea_prenotazioni();
+            modello.num = 0;
+            fprintf(file_output, "vuota\n");
+        } else if(strcmp(comando, "aggiungi") == 0 || strcmp(comando, "cancella") == 0){
+            if(!(campi[0] && campi[1] && campi[2])){
+                fprintf(file_output, "comando incompleto\n");
+                continue;
+            }
+
+            long primo = strtol(campi[0], NULL, 10), ultimo = strtol(campi[1], NULL, 10), passo = strtol(campi[2], NULL, 10);
+            time_t durata = campi[3] ? (time_t)strtol(campi[3], NULL, 10) : 1800;
+            unsigned int riuscite = 0, richieste = 0;
+            for(long h = primo; passo != 0 && (passo > 0 ? h < ultimo : h > ultimo); h += passo){
+                time_t inizio = origine + (time_t)h * 3600;
+                unsigned int k = 0;
+                while(k < modello.num && modello.inizio[k] != inizio) k++;
+                richieste++;
+
+                if(comando[0] == 'a'){
+                    Intervallo i = crea_intervallo(inizio, inizio + durata);
+                    Prenotazione p = i != NULL ? crea_prenotazione("blocchi@email.com", "AB123CD", i, 0) : NULL;
+                    distruggi_intervallo(i);
+                    if(p != NULL && modello.num < PRENOTAZIONI_MODELLO && aggiungi_prenotazione(prenotazioni, p) == OK){
+                        modello.inizio[modello.num] = inizio;
+                        modello.fine[modello.num++] = inizio + durata;
+                        riuscite++;
+                    } else {
+                        distruggi_prenotazione(p);
+                    }
+                } else {
+                    Intervallo i = crea_intervallo(inizio, k < modello.num ? modello.fine[k] : inizio + durata);
+                    if(i != NULL && cancella_prenotazione(prenotazioni, i)){
+                        riuscite++;
+                        if(k < modello.num){
+                            modello.inizio[k] = modello.inizio[--modello.num];
+                            modello.fine[k] = modello.fine[modello.num];
+                        }
+                    }
+                    distruggi_intervallo(i);
+                }
+            }
+            fprintf(file_output, "%u su %u, dimensione %u\n", riuscite, richieste, dimensione_prenotazioni(prenotazioni));
+        } else if(strcmp(comando, "controlla") == 0){
+            static const time_t durate[] = { 1, 900, 1800, 3600, 5400, 36000 };
+            time_t minimo = origine, massimo = origine;
+            for(unsigned int k = 0; k < modello.num; k++){
+                if(k == 0 || modello.inizio[k] < minimo) minimo = modello.inizio[k];
+                if(k == 0 || modello.fine[k] > massimo) massimo = modello.fine[k];
+            }
+
+            unsigned int interrogazioni = 0, concordi = 0;
+            for(time_t inizio = minimo - 7200; inizio < massimo + 7200; inizio += 900){
+                for(unsigned int d = 0; d < sizeof(durate) / sizeof(durate[0]); d++){
+                    interrogazioni++;
+                    concordi += concorda_con_modello(prenotazioni, &modello, inizio, inizio + durate[d]);
+                }
+            }
+            fprintf(file_output, "concordi %u su %u\n", concordi, interrogazioni);
+        } else if(strcmp(comando, "ordine") == 0){
+            visitate.num = 0;
+            visita_prenotazioni_in_ordine(prenotazioni, raccogli_in_modello, &visitate);
+            unsigned int in_ordine = 0;
+            for(unsigned int v = 0; v < visitate.num && v < PRENOTAZIONI_MODELLO; v++){
+                unsigned int k = 0;
+                while(k < modello.num && modello.inizio[k] != visitate.inizio[v]) k++;
+                if(k < modello.num && modello.fine[k] == visitate.fine[v] &&
+                   (v == 0 || visitate.inizio[v - 1] < visitate.inizio[v])) in_ordine++;
+            }
+            fprintf(file_output, "in ordine %u, visitate %u su %u\n", in_ordine, visitate.num, modello.num);
+        } else {
+            fprintf(file_output, "comando sconosciuto\n");
+        }
+    }
+
+    int esito = prenotazioni != NULL ? 1 : -1;
+    distruggi_prenotazioni(prenotazioni);
+    fclose(file_input);
+    fclose(file_output);
+    return esito;
+}
+
+void raccogli_in_modello(const Prenotazione p, void *contesto){
+    ModelloPrenotazioni *raccolte = contesto;
+    if(raccolte->num < PRENOTAZIONI_MODELLO){
+        Intervallo i = ottieni_intervallo_prenotazione(p);
+        raccolte->inizio[raccolte->num] = inizio_intervallo(i);
+        raccolte->fine[raccolte->num] = fine_intervallo(i);
+    }
+    raccolte->num++;
+}
+
+Byte concorda_con_modello(Prenotazioni prenotazioni, const ModelloPrenotazioni *modello, time_t inizio, time_t fine){
+    static ModelloPrenotazioni visitate;
+    unsigned int sovrapposte = 0;
+    time_t primo_inizio = fine;
+    for(unsigned int k = 0; k < modello->num; k++){
+        if(modello->inizio[k] < fine && modello->fine[k] > inizio){
+            sovrapposte++;
+            if(modello->inizio[k] < primo_inizio) primo_inizio = modello->inizio[k];
+        }
+    }
+
+    Intervallo i = crea_intervallo(inizio, fine);
+    Byte libero = controlla_prenotazione(prenotazioni, i) == OK;
+    Intervallo disponibile = ottieni_intervallo_disponibile(prenotazioni, i);
+    distruggi_intervallo(i);
+
+    // Parte libera iniziale attesa: tutto [inizio, fine), [inizio, primo_inizio) oppure niente
+    Byte disponibile_concorde = primo_inizio > inizio ?
+        disponibile != NULL && inizio_intervallo(disponibile) == inizio && fine_intervallo(disponibile) == primo_inizio :
+        disponibile == NULL;
+    distruggi_intervallo(disponibile);
+
+    visitate.num = 0;
+    visita_prenotazioni_in_intervallo(prenotazioni, inizio, fine, raccogli_in_modello, &visitate);
+    Byte visita_concorde = visitate.num == sovrapposte && (sovrapposte == 0 || visitate.inizio[0] == primo_inizio);
+
+    return libero == (sovrapposte == 0) && disponibile_concorde && visita_concorde;
+}
+
+int test_case_quindici(void){
+    FILE *file_input = fopen("TC15/input.txt", "r");
+    FILE *file_output = fopen("TC15/output.txt", "w");
+    if(!(file_input && file_output)){
+        if(file_input) fclose(file_input);
+        if(file_output) fclose(file_output);
+        return -1;
+    }
+
+    time_t adesso = time(NULL);
+    const time_t origine = adesso - adesso % 86400;
+    TabellaVeicoli tabella_veicoli = crea_tabella_veicoli(VEICOLI_FLOTTA);
+    TabellaUtenti tabella_utenti = crea_tabella_utenti(1);
+    static ModelloPrenotazioni modello;
+    static unsigned int veicolo_di[PRENOTAZIONI_MODELLO];
+    static uint64_t id_di[PRENOTAZIONI_MODELLO];
+    unsigned int num_veicoli = 0;
+    modello.num = 0;
+
+    char linea[GRANDEZZA_RIGA];
+    while (tabella_veicoli != NULL && tabella_utenti != NULL && fgets(linea, sizeof(linea), file_input)) {
+        linea[strcspn(linea, "\n")] = 0;
+        fprintf(file_output, "%s: ", linea);
+        char *comando = strtok(linea, ";");
+        long campi[5] = { 0 };
+        for(int k = 0; k < 5; k++){
+            char *campo = strtok(NULL, ";");
+            if(campo) campi[k] = strtol(campo, NULL, 10);
+        }
+        if(comando == NULL) comando = "";
+
+        if(strcmp(comando, "veicoli") == 0){
+            unsigned int aggiunti = 0;
+            for(long k = 0; k < campi[0] && num_veicoli < VEICOLI_FLOTTA; k++){
+                char targa[16];
+                snprintf(targa, sizeof(targa), "FL%03uTA", num_veicoli);
+                Veicolo v = crea_veicolo("Utilitaria", targa, "Panda", "Centro", 0.2, crea_prenotazioni());
+                if(v != NULL && aggiungi_veicolo_in_tabella(tabella_veicoli, v)){
+                    num_veicoli++;
+                    aggiunti++;
+                } else {
+                    distruggi_veicolo(v);
+                }
+            }
+            fprintf(file_output, "%u su %ld, flotta %u\n", aggiunti, campi[0], num_veicoli);
+        } else if(strcmp(comando, "prenota") == 0 || strcmp(comando, "cancella") == 0 || strcmp(comando, "modifica") == 0){
+            unsigned int riuscite = 0, richieste = 0;
+            time_t inizio = origine + (time_t)campi[2] * 60;
+            for(unsigned int k = (unsigned int)campi[0]; (long)k < campi[1] && k < num_veicoli; k++, richieste++){
+                char targa[16];
+                snprintf(targa, sizeof(targa), "FL%03uTA", k);
+                Veicolo v = cerca_veicolo_in_tabella(tabella_veicoli, targa);
+                unsigned int m = 0;
+                while(m < modello.num && !(veicolo_di[m] == k && modello.inizio[m] == inizio)) m++;
+
+                if(comando[0] == 'p'){
+                    Intervallo i = crea_intervallo(inizio, inizio + (time_t)campi[3] * 60);
+                    Prenotazione p = i != NULL ? crea_prenotazione("flotta@email.com", targa, i, 0) : NULL;
+                    distruggi_intervallo(i);
+                    if(p != NULL && modello.num < PRENOTAZIONI_MODELLO && aggiungi_prenotazione_veicolo(v, p) == OK){
+                        veicolo_di[modello.num] = k;
+                        id_di[modello.num] = ottieni_id_prenotazione(p);
+                        modello.inizio[modello.num] = inizio;
+                        modello.fine[modello.num++] = inizio + (time_t)campi[3] * 60;
+                        riuscite++;
+                    } else {
+                        distruggi_prenotazione(p);
+                    }
+                } else if(m == modello.num){
+                    continue;
+                } else if(comando[0] == 'c'){
+                    if(cancella_prenotazione_per_id(tabella_utenti, tabella_veicoli, NULL, id_di[m])){
+                        modello.num--;
+                        modello.inizio[m] = modello.inizio[modello.num];
+                        modello.fine[m] = modello.fine[modello.num];
+                        veicolo_di[m] = veicolo_di[modello.num];
+                        id_di[m] = id_di[modello.num];
+                        riuscite++;
+                    }
+                } else {
+                    time_t nuovo_inizio = origine + (time_t)campi[3] * 60, nuova_fine = nuovo_inizio + (time_t)campi[4] * 60;
+                    Intervallo nuovo = crea_intervallo(nuovo_inizio, nuova_fine);
+                    if(modifica_prenotazione_per_id(tabella_utenti, tabella_veicoli, NULL, id_di[m], nuovo, 0)){
+                        modello.inizio[m] = nuovo_inizio;
+                        modello.fine[m] = nuova_fine;
+                        riuscite++;
+                    }
+                    distruggi_intervallo(nuovo);
+                }
+            }
+            fprintf(file_output, "%u su %u, prenotazioni %u\n", riuscite, richieste, modello.num);
+        } else if(strcmp(comando, "confronta") == 0){
+            static const time_t durate[] = { 900, 3600, 3 * 3600, 86400 };
+            unsigned int interrogazioni = 0, concordi = 0;
+            for(time_t inizio = origine - 86400; inizio < origine + 32 * (time_t)86400; inizio += 1800){
+                for(unsigned int d = 0; d < sizeof(durate) / sizeof(durate[0]); d++){
+                    interrogazioni++;
+                    concordi += concorda_con_flotta(tabella_veicoli, num_veicoli, &modello, veicolo_di, inizio, inizio + durate[d]);
+                }
+            }
+            fprintf(file_output, "concordi %u su %u\n", concordi, interrogazioni);
+        } else {
+            fprintf(file_output, "comando sconosciuto\n");
+        }
+    }
+
+    int esito = tabella_veicoli != NULL && tabella_utenti != NULL ? 1 : -1;
+    distruggi_tabella_veicoli(tabella_veicoli);
+    distruggi_tabella_utenti(tabella_utenti);
+    fclose(file_input);
+    fclose(file_output);
+    return esito;
+}
+
+Byte concorda_con_flotta(TabellaVeicoli tabella_veicoli, unsigned int num_veicoli, const ModelloPrenotazioni *modello,
+                         const unsigned int *veicolo_di, time_t inizio, time_t fine){
+    Byte libero[VEICOLI_FLOTTA];
+    for(unsigned int k = 0; k < num_veicoli; k++) libero[k] = 1;
+    for(unsigned int m = 0; m < modello->num; m++){
+        if(modello->inizio[m] < fine && modello->fine[m] > inizio) libero[veicolo_di[m]] = 0;
+    }
+
+    Intervallo i = crea_intervallo(inizio, fine);
+    unsigned int dimensione = 0;
+    Veicolo *disponibili = ottieni_veicoli_disponibili(tabella_veicoli, i, &dimensione);
+    distruggi_intervallo(i);
+
+    unsigned int attesi = 0, trovati = 0;
+    for(unsigned int k = 0; k < num_veicoli; k++) attesi += libero[k];
+    for(unsigned int d = 0; disponibili != NULL && d < dimensione; d++){
+        unsigned int k = (unsigned int)strtoul(ottieni_targa(disponibili[d]) + 2, NULL, 10);
+        if(k < num_veicoli && libero[k]){
+            libero[k] = 0;
+            trovati++;
+        }
+    }
+    free(disponibili);
+
+    return trovati == attesi && (disponibili == NULL ? 0 : dimensione) == attesi;
+}
+
+int test_case_sedici(void){
+    const char *archivio[4] = { "TC16/utenti.bin", "TC16/storici.bin", "TC16/veicoli.bin", "TC16/prenotazioni.bin" };
+    const char *tabelle[2] = { "TC16/seriale.txt", "TC16/parallela.txt" };
+    FILE *file_input = fopen("TC16/input.txt", "r");
+    FILE *file_output = fopen("TC16/output.txt", "w");
+    if(!(file_input && file_output)){
+        if(file_input) fclose(file_input);
+        if(file_output) fclose(file_output);
+        return -1;
+    }
+
+    char linea[GRANDEZZA_RIGA];
+    int esito = 1;
+    while (esito > 0 && fgets(linea, sizeof(linea), file_input)) {
+        unsigned int utenti, veicoli, thread;
+        if(sscanf(linea, "%u;%u;%u", &utenti, &veicoli, &thread) != 3 || utenti == 0 || thread == 0 ||
+           genera_archivio_caricamento(archivio, utenti, veicoli) < 0){
+            esito = -1;
+            break;
+        }
+
+        // Con un thread `esegui_a_blocchi` esegue entrambi i caricamenti in quello chiamante
+        unsigned int caricati_utenti = 0, caricati_veicoli = 0;
+        for(int passo = 0; passo < 2 && esito > 0; passo++){
+            TabellaUtenti tabella_utenti;
+            TabellaVeicoli tabella_veicoli;
+            imposta_numero_thread(passo ? thread : 1);
+            FILE *uscita = fopen(tabelle[passo], "w");
+            if(uscita == NULL || !carica_tabelle(archivio, 20, &tabella_utenti, &tabella_veicoli)){
+                if(uscita) fclose(uscita);
+                esito = -1;
+                break;
+            }
+            esito = scrivi_tabelle_caricate(uscita, tabella_utenti, tabella_veicoli, &caricati_utenti, &caricati_veicoli);
+            distruggi_tabella_utenti(tabella_utenti);
+            distruggi_tabella_veicoli(tabella_veicoli);
+            fclose(uscita);
+        }
+        if(esito < 0) break;
+
+        FILE *seriale = fopen(tabelle[0], "r");
+        FILE *parallela = fopen(tabelle[1], "r");
+        if(!(seriale && parallela)){
+            if(seriale) fclose(seriale);
+            if(parallela) fclose(parallela);
+            esito = -1;
+            break;
+        }
+        fprintf(file_output, "%u utenti, %u veicoli, %u thread: caricati %u utenti e %u veicoli, tabelle %s\n",
+                utenti, veicoli, thread, caricati_utenti, caricati_veicoli,
+                compara_file(seriale, parallela) ? "diverse dal caricamento seriale" : "identiche al caricamento seriale");
+        fclose(seriale);
+        fclose(parallela);
+    }
+
+    imposta_numero_thread(0);
+    for(int i = 0; i < 4; i++) remove(archivio[i]);
+    for(int i = 0; i < 2; i++) remove(tabelle[i]);
+    fclose(file_input);
+    fclose(file_output);
+    return esito;
+}
+
+int genera_archivio_caricamento(const char *nome_file[4], unsigned int num_utenti, unsigned int num_veicoli){
+    Utente *utenti = calloc(num_utenti, sizeof(Utente));
+    Veicolo *veicoli = calloc(num_veicoli, sizeof(Veicolo));
+    uint8_t password[DIMENSIONE_PASSWORD] = {0};
+    char email[LUNGHEZZA_CHIAVE_TABELLA], targa[NUM_CARATTERI_TARGA];
+    int esito = -1;
+    if(utenti == NULL || veicoli == NULL) goto fine;
+
+    for(unsigned int i = 0; i < num_utenti; i++){
+        snprintf(email, sizeof(email), "utente%u@carsharing.it", i);
+        utenti[i] = crea_utente(email, password, "Nome", "Cognome", i % 10 ? CLIENTE : ADMIN);
+        if(utenti[i] == NULL) goto fine;
+    }
+
+    for(unsigned int i = 0; i < num_veicoli; i++){
+        snprintf(targa, sizeof(targa), "%c%c%03u%c%c", 'A' + (i / 1000) % 26, 'A' + (i / 26000) % 26, i % 1000,
+                 'A' + (i / 676000) % 26, 'A' + (i / 17576000) % 26);
+        Prenotazioni prenotazioni = crea_prenotazioni();
+        veicoli[i] = crea_veicolo("Utilitaria", targa, "Modello", "Posizione", 1.0 + i % 7, prenotazioni);
+        if(veicoli[i] == NULL){
+            distruggi_prenotazioni(prenotazioni);
+            goto fine;
+        }
+
+        for(unsigned int k = 0; k < 4; k++){
+            unsigned int cliente = (i * 4 + k) % num_utenti;
+            time_t inizio = 1767225600 + (time_t)(k * 7200 + i % 13 * 900);
+            Intervallo intervallo = crea_intervallo(inizio, inizio + 3600 + (time_t)(i % 5) * 60);
+            Prenotazione p = crea_prenotazione(ottieni_email(utenti[cliente]), targa, intervallo, 10.0 + k * 0.25);
+            distruggi_intervallo(intervallo);
+            if(p == NULL || aggiungi_prenotazione_veicolo(veicoli[i], p) != OK){
+                distruggi_prenotazione(p);
+                goto fine;
+            }
+            if(ottieni_permesso(utenti[cliente]) == CLIENTE) aggiungi_a_storico_utente(utenti[cliente], p);
+        }
+    }
+
+    if(salva_vettore_utenti(nome_file[0], nome_file[1], utenti, num_utenti, 1) &&
+       salva_vettore_veicoli(nome_file[2], nome_file[3], veicoli, num_veicoli, 1))
+        esito = 1;
+
+fine:
+    for(unsigned int i = 0; veicoli != NULL && i < num_veicoli; i++) distruggi_veicolo(veicoli[i]);
+    for(unsigned int i = 0; utenti != NULL && i < num_utenti; i++) distruggi_utente(utenti[i]);
+    free(veicoli);
+    free(utenti);
+    return esito;
+}
+
+int scrivi_tabelle_caricate(FILE *uscita, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli,
+                            unsigned int *num_utenti, unsigned int *num_veicoli){
+    Utente *utenti = (Utente *)ottieni_vettore(tabella_utenti, num_utenti);
+    Veicolo *veicoli = ottieni_vettore_veicoli(tabella_veicoli, num_veicoli);
+    int esito = (utenti || *num_utenti == 0) && (veicoli || *num_veicoli == 0) ? 1 : -1;
+    if(esito > 0){
+        if(utenti) qsort(utenti, *num_utenti, sizeof(Utente), compara_email);
+        if(veicoli) qsort(veicoli, *num_veicoli, sizeof(Veicolo), compara_targhe);
+        scrivi_istantanea_caricata(uscita, veicoli, *num_veicoli, utenti, *num_utenti);
+    }
+    free(utenti);
+    free(veicoli);
+    return esito;
+}
+
+int esegui_file_comandi(const char *nome_input, FILE *uscita, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli,
+                        Giornale giornale){
+    FILE *file_input = fopen(nome_input, "r");
+    if(file_input == NULL) return -1;
+
+    char linea[GRANDEZZA_RIGA];
+    Utente sessione = NULL;
+    while (fgets(linea, sizeof(linea), file_input)) {
+        linea[strcspn(linea, "\n")] = 0;
+        esegui_comando(linea, &sessione, uscita, tabella_utenti, tabella_veicoli, giornale);
+    }
+
+    fclose(file_input);
+    return 1;
+}
+
+int ricarica_tabelle(const char *nome_file[4], TabellaUtenti *tabella_utenti, TabellaVeicoli *tabella_veicoli){
+    unsigned int num_utenti, num_veicoli;
+    Utente *utenti = (Utente *)ottieni_vettore(*tabella_utenti, &num_utenti);
+    Veicolo *veicoli = ottieni_vettore_veicoli(*tabella_veicoli, &num_veicoli);
+    Byte salvate = utenti && veicoli && salva_vettore_utenti(nome_file[0], nome_file[1], utenti, num_utenti, 1) &&
+                   salva_vettore_veicoli(nome_file[2], nome_file[3], veicoli, num_veicoli, 1);
+    free(utenti);
+    free(veicoli);
+    distruggi_tabella_utenti(*tabella_utenti);
+    distruggi_tabella_veicoli(*tabella_veicoli);
+    *tabella_utenti = NULL;
+    *tabella_veicoli = NULL;
+    if(!salvate) return -1;
+
+    utenti = carica_vettore_utenti(nome_file[0], nome_file[1], &num_utenti);
+    veicoli = carica_vettore_veicoli(nome_file[2], nome_file[3], &num_veicoli);
+    if(utenti != NULL && veicoli != NULL){
+        *tabella_utenti = crea_tabella_utenti(num_utenti * 2);
+        *tabella_veicoli = crea_tabella_veicoli(num_veicoli * 2);
+    }
+    if(*tabella_utenti == NULL || *tabella_veicoli == NULL){
+        for(unsigned int i = 0; utenti != NULL && i < num_utenti; i++) distruggi_utente(utenti[i]);
+        for(unsigned int i = 0; veicoli != NULL && i < num_veicoli; i++) distruggi_veicolo(veicoli[i]);
+        distruggi_tabella_utenti(*tabella_utenti);
+        distruggi_tabella_veicoli(*tabella_veicoli);
+        *tabella_utenti = NULL;
+        *tabella_veicoli = NULL;
+        free(utenti);
+        free(veicoli);
+        return -1;
+    }
+
+    carica_utenti(*tabella_utenti, utenti, num_utenti);
+    carica_veicoli(*tabella_veicoli, veicoli, num_veicoli);
+    free(utenti);
+    free(veicoli);
+    return 1;
+}
+
+int carica_tabelle_txt(const char *nome_file_utenti, const char *nome_file_veicoli, TabellaUtenti *tabella_utenti,
+                       TabellaVeicoli *tabella_veicoli){
+    FILE *file_utenti = fopen(nome_file_utenti, "r");
+    FILE *file_veicoli = fopen(nome_file_veicoli, "r");
+    *tabella_utenti = crea_tabella_utenti(20);
+    *tabella_veicoli = crea_tabella_veicoli(10);
+
+    int esito = file_utenti && file_veicoli && *tabella_utenti && *tabella_veicoli &&
+                txt_in_utenti(file_utenti, *tabella_utenti) == 0 && txt_in_veicoli(file_veicoli, *tabella_veicoli) == 0 ? 0 : -1;
+    if(file_utenti) fclose(file_utenti);
+    if(file_veicoli) fclose(file_veicoli);
+    if(esito < 0){
+        distruggi_tabella_utenti(*tabella_utenti);
+        distruggi_tabella_veicoli(*tabella_veicoli);
+    }
+    return esito;
+}
+
+void scrivi_stato(FILE *uscita, TabellaUtenti tabella_utenti, TabellaVeicoli tabella_veicoli, uint64_t primo_id){
+    unsigned int dimensione;
+    Veicolo *veicoli = ottieni_vettore_veicoli(tabella_veicoli, &dimensione);
+    if(veicoli != NULL){
+        qsort(veicoli, dimensione, sizeof(Veicolo), compara_targhe);
+        for(unsigned int i = 0; i < dimensione; i++){
+            Prenotazioni prenotazioni = ottieni_prenotazioni(veicoli[i]);
+            if(dimensione_prenotazioni(prenotazioni) == 0) continue;
+            fprintf(uscita, "    %s: %u\n", ottieni_targa(veicoli[i]), dimensione_prenotazioni(prenotazioni));
+            visita_prenotazioni_in_ordine(prenotazioni, scrivi_prenotazione_giornale, uscita);
+        }
+        free(veicoli);
+    }
+
+    for(uint64_t id = primo_id; id <= ottieni_ultimo_id_prenotazione(); id++){
+        Prenotazione p = cerca_prenotazione_per_id(id);
+        if(p == NULL){
+            fprintf(uscita, "    id %llu: assente\n", (unsigned long long)id);
+            continue;
+        }
+        Utente u = cerca_utente_in_tabella(tabella_utenti, ottieni_cliente_prenotazione(p));
+        fprintf(uscita, "    id %llu: %s, %u prenotazioni di %s\n", (unsigned long long)id,
+                appartiene_a_storico(p) ? "nello storico" : "fuori dallo storico",
+                u ? ottieni_numero_prenotazioni_utente(u) : 0, ottieni_cliente_prenotazione(p));
+    }
+}
+
+void scrivi_istantanea_caricata(FILE *uscita, Veicolo veicoli[], unsigned int num_veicoli, Utente utenti[], unsigned int num_utenti){
+    // Gli storici vengono costruiti prima degli alberi dei veicoli, che ne condividono le prenotazioni
+    for(unsigned int i = 0; i < num_utenti; i++){
+        fprintf(uscita, "%s: %u\n", ottieni_email(utenti[i]), ottieni_numero_prenotazioni_utente(utenti[i]));
+        visita_storico_utente(utenti[i], scrivi_prenotazione_storico, uscita);
+    }
+    for(unsigned int i = 0; i < num_veicoli; i++){
+        Prenotazioni prenotazioni = ottieni_prenotazioni(veicoli[i]);
+        fprintf(uscita, "%s;%s;%.3f: %u\n", ottieni_targa(veicoli[i]), ottieni_modello(veicoli[i]), ottieni_tariffa(veicoli[i]),
+                dimensione_prenotazioni(prenotazioni));
+        visita_prenotazioni_in_ordine(prenotazioni, scrivi_prenotazione_veicolo, uscita);
+    }
+}
+
+int modifica_istantanea_differita(FILE *uscita, const char *nome_file[4]){
+    unsigned int num_veicoli, num_utenti;
+    Veicolo *veicoli = carica_vettore_veicoli(nome_file[0], nome_file[1], &num_veicoli);
+    Utente *utenti = carica_vettore_utenti(nome_file[2], nome_file[3], &num_utenti);
+    TabellaVeicoli tabella_veicoli = veicoli ? crea_tabella_veicoli(num_veicoli * 2) : NULL;
+    TabellaUtenti tabella_utenti = utenti ? crea_tabella_utenti(num_utenti * 2) : NULL;
+    if(tabella_veicoli == NULL || tabella_utenti == NULL){
+        for(unsigned int i = 0; veicoli != NULL && i < num_veicoli; i++) distruggi_veicolo(veicoli[i]);
+        for(unsigned int i = 0; utenti != NULL && i < num_utenti; i++) distruggi_utente(utenti[i]);
+        distruggi_tabella_veicoli(tabella_veicoli);
+        distruggi_tabella_utenti(tabella_utenti);
+        free(veicoli);
+        free(utenti);
+        return -1;
+    }
+    carica_veicoli(tabella_veicoli, veicoli, num_veicoli);
+    carica_utenti(tabella_utenti, utenti, num_utenti);
+
+    // Visitare un albero lo costruisce; gli storici restano nell'archivio fino alla modifica
+    fprintf(uscita, "Dopo la modifica delle prenotazioni dei veicoli:\n");
+    for(unsigned int i = 0; i < num_veicoli; i++){
+        Prenotazioni prenotazioni = ottieni_prenotazioni(veicoli[i]);
+        IdRaccolti raccolti = { malloc((dimensione_prenotazioni(prenotazioni) + 1) * sizeof(uint64_t)), 0 };
+        if(raccolti.id == NULL) continue;
+        visita_prenotazioni_in_ordine(prenotazioni, raccogli_id_prenotazione, &raccolti);
+
+        for(unsigned int k = 0; k < raccolti.num; k++){
+            Prenotazione p = cerca_prenotazione_per_id(raccolti.id[k]);
+            Intervallo i = ottieni_intervallo_prenotazione(p);
+            time_t inizio = inizio_intervallo(i), fine = fine_intervallo(i);
+            Intervallo nuovo = crea_intervallo(inizio, fine - (fine / 2 - inizio / 2));
+            if(nuovo == NULL || !modifica_prenotazione_per_id(tabella_utenti, tabella_veicoli, NULL, raccolti.id[k], nuovo,
+                                                              ottieni_costo_prenotazione(p)))
+                fprintf(uscita, "    modifica di %llu fallita\n", (unsigned long long)raccolti.id[k]);
+            distruggi_intervallo(nuovo);
+        }
+        free(raccolti.id);
+    }
+    for(unsigned int i = 0; i < num_veicoli; i++){
+        Prenotazioni prenotazioni = ottieni_prenotazioni(veicoli[i]);
+        fprintf(uscita, "%s: %u\n", ottieni_targa(veicoli[i]), dimensione_prenotazioni(prenotazioni));
+        visita_prenotazioni_in_ordine(prenotazioni, scrivi_prenotazione_con_id, uscita);
+    }
+    for(unsigned int i = 0; i < num_utenti; i++){
+        fprintf(uscita, "%s: %u\n", ottieni_email(utenti[i]), ottieni_numero_prenotazioni_utente(utenti[i]));
+        visita_storico_utente(utenti[i], scrivi_prenotazione_con_id, uscita);
+    }
+
+    distruggi_tabella_veicoli(tabella_veicoli);
+    distruggi_tabella_utenti(tabella_utenti);
+    free(veicoli);
+    free(utenti);
+    return 1;
+}
+
+void raccogli_id_prenotazione(const Prenotazione p, void *contesto){
+    IdRaccolti *raccolti = contesto;
+    raccolti->id[raccolti->num++] = ottieni_id_prenotazione(p);
+}
+
+void scrivi_prenotazione_con_id(const Prenotazione p, void *contesto){
+    Intervallo i = ottieni_intervallo_prenotazione(p);
+    fprintf((FILE *)contesto, "    %llu;%lld;%lld;%s;%s;%.17g\n", (unsigned long long)ottieni_id_prenotazione(p),
+            (long long)inizio_intervallo(i), (long long)fine_intervallo(i), ottieni_cliente_prenotazione(p),
+            ottieni_veicolo_prenotazione(p), ottieni_costo_prenotazione(p));
+}
+
+void scrivi_prenotazione_giornale(const Prenotazione p, void *contesto){
+    char *date = intervallo_in_stringa(ottieni_intervallo_prenotazione(p));
+    fprintf((FILE *)contesto, "        %llu;%s;%s;%.2f\n", (unsigned long long)ottieni_id_prenotazione(p),
+            ottieni_cliente_prenotazione(p), date ? date : "", ottieni_costo_prenotazione(p));
+    free(date);
+}
+
+void scrivi_prenotazione_storico(const Prenotazione p, void *contesto){
+    Intervallo i = ottieni_intervallo_prenotazione(p);
+    fprintf((FILE *)contesto, "    %lld;%lld;%s;%.17g\n", (long long)inizio_intervallo(i), (long long)fine_intervallo(i),
+            ottieni_veicolo_prenotazione(p), ottieni_costo_prenotazione(p));
+}
+
+void scrivi_prenotazione_veicolo(const Prenotazione p, void *contesto){
+    Intervallo i = ottieni_intervallo_prenotazione(p);
+    fprintf((FILE *)contesto, "    %lld;%lld;%s;%.17g;%s\n", (long long)inizio_intervallo(i), (long long)fine_intervallo(i),
+            ottieni_cliente_prenotazione(p), ottieni_costo_prenotazione(p), appartiene_a_storico(p) ? "condivisa" : "copia");
+}
+
+int compara_file(FILE *a, FILE *b) {
+    int ca, cb;
+    for(ca = getc(a), cb = getc(b); (ca != EOF && cb != EOF) && (ca == cb); ca = getc(a), cb = getc(b));
+    return ca != cb;
+}
+
+int compara_targhe(const void *a, const void *b){
+    Veicolo va = *(const Veicolo *)a;
+    Veicolo vb = *(const Veicolo *)b;
+    if(va == NULL || vb == NULL) return (va == NULL) - (vb == NULL);
+    return strcmp(ottieni_targa(va), ottieni_targa(vb));
+}
+
+int compara_email(const void *a, const void *b){
+    return strcmp(ottieni_email(*(const Utente *)a), ottieni_email(*(const Utente *)b));
 }